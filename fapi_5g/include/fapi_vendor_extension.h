@@ -39,6 +39,7 @@ extern "C" {
 #endif
 
 #define FAPI_VENDOR_EXT_P7_IND                              0x17
+#define FAPI_VENDOR_EXT_RX_DATA_RELEASE_REQUEST             0x18
 
 /* ----- WLS Operation --- */
 #define FAPI_VENDOR_MSG_HEADER_IND                          0x1A
@@ -261,6 +262,15 @@ enum {
         uint32_t nStatus;
     } fapi_vendor_ext_shutdown_res_t;
 
+    // Returns RX_DATA.indication payloads to L1 when [WLS_CFG] rx_data_zbc
+    // is set, pdu_data[] holds the pduData values of the released PDUs
+    typedef struct {
+        fapi_msg_t header;
+        uint16_t num_pdus;
+        uint8_t pad[6];
+        void *pdu_data[FAPI_MAX_NUMBER_OF_ULSCH_PDUS_PER_SLOT];
+    } fapi_vendor_ext_rx_data_release_req_t;
+
     typedef struct {
         int16_t nSNR[MAX_SNR_COUNT];
         int16_t pad;
@@ -138,6 +138,9 @@ uint8_t nr5g_fapi_crc_indication_to_fapi_translation(
     uint8_t num_crc, i;
     uint8_t symbol_no;
     uint16_t slot_no, frame_no;
+    int16_t snr[FAPI_MAX_NUMBER_OF_CRCS_PER_SLOT];
+    uint8_t ul_cqi[FAPI_MAX_NUMBER_OF_CRCS_PER_SLOT];
+    int16_t *p_snr;
 
     nr5g_fapi_pusch_info_t *p_pusch_info;
     fapi_crc_ind_info_t *p_fapi_crc_ind_info;
@@ -161,6 +164,19 @@ uint8_t nr5g_fapi_crc_indication_to_fapi_translation(
     }
 
     num_crc = p_fapi_crc_ind->numCrcs = p_phy_crc_ind->nCrc;
+    if (num_crc > FAPI_MAX_NUMBER_OF_CRCS_PER_SLOT) {
+        NR5G_FAPI_LOG(ERROR_LOG, (" [CRC.indication] Invalid number of CRCs:"
+                " %u", num_crc));
+        return FAILURE;
+    }
+
+    // SNR of all the CRCs is converted at once
+    p_snr = p_fapi_snr ? p_fapi_snr->nSNR : snr;
+    for (i = 0; i < num_crc; i++) {
+        p_snr[i] = p_phy_crc_ind->sULCRCStruct[i].nSNR;
+    }
+    nr5g_fapi_convert_snr_iapi_to_fapi_array(p_snr, ul_cqi, num_crc);
+
     for (i = 0; i < num_crc; i++) {
         p_stats->iapi_stats.iapi_crc_ind_pdus++;
 
@@ -181,12 +197,7 @@ uint8_t nr5g_fapi_crc_indication_to_fapi_translation(
         p_fapi_crc_ind_info->rnti = p_ul_crc_struct->nRNTI;
         p_fapi_crc_ind_info->harqId = p_pusch_info->harq_process_id;
         p_fapi_crc_ind_info->tbCrcStatus = !(p_ul_crc_struct->nCrcFlag);
-        p_fapi_crc_ind_info->ul_cqi = nr5g_fapi_convert_snr_iapi_to_fapi(p_ul_crc_struct->nSNR);
-        if(p_fapi_snr)
-        {
-            p_fapi_snr->nSNR[i] = p_ul_crc_struct->nSNR;
-        }
-        p_pusch_info->ul_cqi = p_fapi_crc_ind_info->ul_cqi;
+        p_pusch_info->ul_cqi = p_fapi_crc_ind_info->ul_cqi = ul_cqi[i];
 
         p_fapi_crc_ind_info->numCb = 0;
         p_pusch_info->timing_advance = p_fapi_crc_ind_info->timingAdvance = 31;
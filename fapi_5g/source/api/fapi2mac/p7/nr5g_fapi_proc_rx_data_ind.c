@@ -27,6 +27,7 @@
 #include "nr5g_fapi_fapi2mac_api.h"
 #include "nr5g_fapi_fapi2mac_p7_proc.h"
 #include "nr5g_fapi_fapi2mac_p7_pvt_proc.h"
+#include "nr5g_fapi_fapi2phy_wls.h"
 
  /** @ingroup group_source_api_p7_fapi2mac_proc
  *
@@ -106,6 +107,8 @@ uint8_t nr5g_fapi_rx_data_indication(
                 "translation failed"));
         return FAILURE;
     }
+    // L2 now references the payloads, hold them until it releases them
+    nr5g_fapi_fapi2phy_rx_data_zbc_ref(p_fapi_rx_data_ind);
 
     nr5g_fapi_fapi2mac_add_api_to_list(phy_id, p_list_elem, is_urllc);
 
@@ -28,6 +28,7 @@
 #include "nr5g_fapi_fapi2mac_p7_proc.h"
 #include "nr5g_fapi_fapi2mac_p7_pvt_proc.h"
 #include "nr5g_fapi_memory.h"
+#include "nr5g_fapi_snr_conversion.h"
 
  /** @ingroup group_source_api_p7_fapi2mac_proc
  *
@@ -166,7 +167,7 @@ uint8_t nr5g_fapi_srs_indication_to_fapi_translation(
     uint8_t num_srs_pdus, i;
     uint8_t symbol_no, num_rept_symbols, nr_of_symbols;
     uint16_t slot_no, frame_no, num_rbs, j, k;
-    int8_t wideband_snr = 0, rb_snr;
+    int8_t wideband_snr = 0;
     int16_t temp_sum_wideband_snr;
 
     nr5g_fapi_srs_info_t *p_srs_info;
@@ -219,17 +220,27 @@ uint8_t nr5g_fapi_srs_indication_to_fapi_translation(
         }
         wideband_snr = temp_sum_wideband_snr / nr_of_symbols;
 
-        p_fapi_srs_pdu->wideBandSnr = (wideband_snr + 64) * 2;
+        p_fapi_srs_pdu->wideBandSnr =
+            nr5g_fapi_convert_srs_snr_iapi_to_fapi(wideband_snr);
         num_rept_symbols = p_fapi_srs_pdu->numReportedSymbols = 1;
 
         for (j = 0; j < num_rept_symbols; j++) {
             p_fapi_symb_snr = &p_fapi_srs_pdu->symbSnr[j];
             num_rbs = p_fapi_symb_snr->numRbs =
                 p_ul_srs_est_struct->nNrOfBlocks * 4;
+            if (num_rbs > FAPI_MAX_NUMBER_RBS) {
+                NR5G_FAPI_LOG(ERROR_LOG, ("[SRS.indication] Invalid number "
+                        "of RBs:%u for nUEId:%d", num_rbs,
+                        p_ul_srs_est_struct->nUEId));
+                return FAILURE;
+            }
 
-            for (k = 0; k < num_rbs; k++) {
-                rb_snr = p_ul_srs_est_struct->nBlockSNR[k / 68][k % 68];
-                p_fapi_symb_snr->rbSNR[k] = (rb_snr + 64) * 2;
+            // one conversion per nBlockSNR row of 68 RBs
+            for (k = 0; k < num_rbs; k += 68) {
+                nr5g_fapi_convert_srs_snr_iapi_to_fapi_array(
+                    p_ul_srs_est_struct->nBlockSNR[k / 68],
+                    &p_fapi_symb_snr->rbSNR[k],
+                    (num_rbs - k < 68) ? num_rbs - k : 68);
             }
         }
         p_stats->fapi_stats.fapi_srs_ind_pdus++;
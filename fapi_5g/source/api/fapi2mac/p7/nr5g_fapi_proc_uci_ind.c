@@ -148,6 +148,7 @@ nr5g_fapi_pucch_info_t *nr5g_fapi_get_pucch_info(
  *               UL_TTI.request processing
  *  @param[in]   p_uci_pdu_data_struct Pointer to IAPI UCI PDU structure.
  *  @param[out]  p_fapi_uci_pdu_info   Pointer to FAPI UCI PDU structure.
+ *  @param[in]   ul_cqi  FAPI ul_cqi converted from the IAPI SNR.
  *  
  *  @return     Returns ::SUCCESS and ::FAILURE.
  *
@@ -160,7 +161,7 @@ void nr5g_fapi_fill_uci_format_0_1(
     nr5g_fapi_pucch_info_t * p_pucch_info,
     ULUCIPDUDataStruct * p_uci_pdu_data_struct,
     fapi_uci_pdu_info_t * p_fapi_uci_pdu_info,
-    int16_t * p_fapi_snr)
+    uint8_t ul_cqi)
 {
     uint8_t pucch_detected, num_harq, i;
 
@@ -176,12 +177,7 @@ void nr5g_fapi_fill_uci_format_0_1(
     p_uci_pucch_f0_f1->pduBitmap = 0;
     p_uci_pucch_f0_f1->pucchFormat = p_pucch_info->pucch_format;
 
-    if(p_fapi_snr)
-    {
-        *p_fapi_snr = p_uci_pdu_data_struct->nSNR;
-    }
-
-    p_uci_pucch_f0_f1->ul_cqi = nr5g_fapi_convert_snr_iapi_to_fapi(p_uci_pdu_data_struct->nSNR);
+    p_uci_pucch_f0_f1->ul_cqi = ul_cqi;
     p_uci_pucch_f0_f1->rnti = p_uci_pdu_data_struct->nRNTI;
     p_uci_pucch_f0_f1->timingAdvance = 31;
     p_uci_pucch_f0_f1->rssi = 880;
@@ -224,6 +220,7 @@ void nr5g_fapi_fill_uci_format_0_1(
  *               UL_TTI.request processing
  *  @param[in]   p_uci_pdu_data_struct Pointer to IAPI UCI PDU structure.
  *  @param[out]  p_fapi_uci_pdu_info   Pointer to FAPI UCI PDU structure.
+ *  @param[in]   ul_cqi  FAPI ul_cqi converted from the IAPI SNR.
  *  
  *  @return     Returns ::SUCCESS and ::FAILURE.
  *
@@ -236,7 +233,7 @@ void nr5g_fapi_fill_uci_format_2_3_4(
     nr5g_fapi_pucch_info_t * p_pucch_info,
     ULUCIPDUDataStruct * p_uci_pdu_data_struct,
     fapi_uci_pdu_info_t * p_fapi_uci_pdu_info,
-    int16_t * p_fapi_snr)
+    uint8_t ul_cqi)
 {
     uint8_t pucch_detected;
     uint16_t num_uci_bits;
@@ -248,15 +245,10 @@ void nr5g_fapi_fill_uci_format_2_3_4(
     p_uci_pucch_f2_f3_f4->handle = p_pucch_info->handle;
     p_uci_pucch_f2_f3_f4->pduBitmap = 0;
     p_uci_pucch_f2_f3_f4->pucchFormat = p_pucch_info->pucch_format;
-    p_uci_pucch_f2_f3_f4->ul_cqi = nr5g_fapi_convert_snr_iapi_to_fapi(p_uci_pdu_data_struct->nSNR);
+    p_uci_pucch_f2_f3_f4->ul_cqi = ul_cqi;
     p_uci_pucch_f2_f3_f4->rnti = p_uci_pdu_data_struct->nRNTI;
     p_uci_pucch_f2_f3_f4->timingAdvance = 31;
 
-    if(p_fapi_snr)
-    {
-        *p_fapi_snr = p_uci_pdu_data_struct->nSNR;
-    }
-
     pucch_detected = p_uci_pdu_data_struct->pucchDetected;
 #ifdef DEBUG_MODE
     p_uci_pucch_f2_f3_f4->timingAdvance = p_uci_pdu_data_struct->nTA;
@@ -307,6 +299,9 @@ uint8_t nr5g_fapi_uci_indication_to_fapi_translation(
     uint8_t num_uci, i;
     uint8_t symbol_no, pucch_format;
     uint16_t slot_no, frame_no;
+    int16_t snr[FAPI_MAX_NUMBER_UCI_PDUS_PER_SLOT];
+    uint8_t ul_cqi[FAPI_MAX_NUMBER_UCI_PDUS_PER_SLOT];
+    int16_t *p_snr;
 
     nr5g_fapi_pucch_info_t *p_pucch_info;
     fapi_uci_pdu_info_t *p_fapi_uci_pdu_info;
@@ -330,6 +325,19 @@ uint8_t nr5g_fapi_uci_indication_to_fapi_translation(
     }
 
     num_uci = p_fapi_uci_ind->numUcis = p_phy_uci_ind->nUCI;
+    if (num_uci > FAPI_MAX_NUMBER_UCI_PDUS_PER_SLOT) {
+        NR5G_FAPI_LOG(ERROR_LOG, (" [UCI.indication] Invalid number of UCIs:"
+                " %u", num_uci));
+        return FAILURE;
+    }
+
+    // SNR of all the UCIs is converted at once
+    p_snr = p_fapi_snr ? p_fapi_snr->nSNR : snr;
+    for (i = 0; i < num_uci; i++) {
+        p_snr[i] = p_phy_uci_ind->sULUCIPDUDataStruct[i].nSNR;
+    }
+    nr5g_fapi_convert_snr_iapi_to_fapi_array(p_snr, ul_cqi, num_uci);
+
     for (i = 0; i < num_uci; i++) {
         p_stats->iapi_stats.iapi_uci_ind_pdus++;
         p_fapi_uci_pdu_info = &p_fapi_uci_ind->uciPdu[i];
@@ -346,7 +354,6 @@ uint8_t nr5g_fapi_uci_indication_to_fapi_translation(
         }
 
         pucch_format = p_pucch_info->pucch_format;
-        int16_t* p_fapi_snr_arr = p_fapi_snr ? &p_fapi_snr->nSNR[i] : NULL;
 
         switch (pucch_format) {
             case FAPI_PUCCH_FORMAT_TYPE_0:
@@ -356,7 +363,7 @@ uint8_t nr5g_fapi_uci_indication_to_fapi_translation(
                     p_fapi_uci_pdu_info->pduSize =
                         sizeof(fapi_uci_o_pucch_f0f1_t);
                     nr5g_fapi_fill_uci_format_0_1(p_pucch_info,
-                        p_uci_pdu_data_struct, p_fapi_uci_pdu_info, p_fapi_snr_arr);
+                        p_uci_pdu_data_struct, p_fapi_uci_pdu_info, ul_cqi[i]);
                 }
                 break;
 
@@ -368,7 +375,7 @@ uint8_t nr5g_fapi_uci_indication_to_fapi_translation(
                     p_fapi_uci_pdu_info->pduSize =
                         sizeof(fapi_uci_o_pucch_f2f3f4_t);
                     nr5g_fapi_fill_uci_format_2_3_4(p_pucch_info,
-                        p_uci_pdu_data_struct, p_fapi_uci_pdu_info, p_fapi_snr_arr);
+                        p_uci_pdu_data_struct, p_fapi_uci_pdu_info, ul_cqi[i]);
                 }
                 break;
 
@@ -30,31 +30,28 @@
 #include "nr5g_fapi_fapi2phy_wls.h"
 #include "nr5g_fapi_log.h"
 
-nr5g_fapi_fapi2phy_queue_t fapi2phy_q;
-nr5g_fapi_fapi2phy_queue_t fapi2phy_q_urllc;
+static nr5g_fapi_fapi2phy_queue_t fapi2phy_q[FAPI_MAX_PHY_INSTANCES];
+static nr5g_fapi_fapi2phy_queue_t fapi2phy_q_urllc[FAPI_MAX_PHY_INSTANCES];
 
 //------------------------------------------------------------------------------
 /** @ingroup     group_source_api_fapi2phy
  *
- *  @param[in]   p_list_elem Pointer to the ListElement
+ *  @param[in]   phy_id Value of phy_id.
+ *  @param[in]   is_urllc True for urllc, false otherwise.
  *
- *  @return      void
+ *  @return      Pointer to fapi2phy api queue.
  *
- *  @description This function adds a ListElement API to a Linked list which will
- *               be sent to L1 once all APIs for a TTI are added
+ *  @description This function access proper instance of fapi2phy queue. Each
+ *               PHY instance has its own queue, so the APIs of different PHY
+ *               instances can be translated in parallel.
  *
 **/
 //------------------------------------------------------------------------------
-p_nr5g_fapi_fapi2phy_queue_t nr5g_fapi_fapi2phy_queue(
-    )
-{
-    return &fapi2phy_q;
-}
-
-p_nr5g_fapi_fapi2phy_queue_t nr5g_fapi_fapi2phy_queue_urllc(
-    )
+static inline p_nr5g_fapi_fapi2phy_queue_t nr5g_fapi_fapi2phy_queue(
+    uint8_t phy_id,
+    bool is_urllc)
 {
-    return &fapi2phy_q_urllc;
+    return is_urllc ? &fapi2phy_q_urllc[phy_id] : &fapi2phy_q[phy_id];
 }
 
 uint8_t nr5g_fapi_get_stats_location(
@@ -160,6 +157,7 @@ PMAC2PHY_QUEUE_EL nr5g_fapi_fapi2phy_create_api_list_elem(
 //------------------------------------------------------------------------------
 void nr5g_fapi_fapi2phy_add_to_api_list(
     bool is_urllc,
+    uint8_t phy_id,
     PMAC2PHY_QUEUE_EL p_list_elem)
 {
     p_nr5g_fapi_fapi2phy_queue_t queue = NULL;
@@ -168,8 +166,7 @@ void nr5g_fapi_fapi2phy_add_to_api_list(
         return;
     }
 
-    queue = is_urllc ? nr5g_fapi_fapi2phy_queue_urllc()
-                     : nr5g_fapi_fapi2phy_queue();
+    queue = nr5g_fapi_fapi2phy_queue(phy_id, is_urllc);
 
     if (queue->p_send_list_head && queue->p_send_list_tail) {
         queue->p_send_list_tail->pNext = p_list_elem;
@@ -194,20 +191,34 @@ void nr5g_fapi_fapi2phy_send_api_list(
     bool is_urllc)
 {
     uint8_t ret = FAILURE;
+    uint8_t phy_id = 0;
+    PMAC2PHY_QUEUE_EL p_commit_list_head = NULL;
+    PMAC2PHY_QUEUE_EL p_commit_list_tail = NULL;
     p_nr5g_fapi_fapi2phy_queue_t queue = NULL;
 
-    queue = is_urllc ? nr5g_fapi_fapi2phy_queue_urllc()
-                     : nr5g_fapi_fapi2phy_queue();
-    if (queue->p_send_list_head) {
+    // Join the APIs of all PHY instances into one WLS send
+    for (phy_id = 0; phy_id < FAPI_MAX_PHY_INSTANCES; phy_id++) {
+        queue = nr5g_fapi_fapi2phy_queue(phy_id, is_urllc);
+        if (queue->p_send_list_head) {
+            if (p_commit_list_head) {
+                p_commit_list_tail->pNext = queue->p_send_list_head;
+            } else {
+                p_commit_list_head = queue->p_send_list_head;
+            }
+            p_commit_list_tail = queue->p_send_list_tail;
+            queue->p_send_list_tail = queue->p_send_list_head = NULL;
+        }
+    }
+
+    if (p_commit_list_head) {
 
         NR5G_FAPI_LOG(TRACE_LOG,
             ("[NR5G_FAPI][FAPI2PHY] Sending API's to PHY"));
-        ret = nr5g_fapi_fapi2phy_wls_send(queue->p_send_list_head, is_urllc);
+        ret = nr5g_fapi_fapi2phy_wls_send(p_commit_list_head, is_urllc);
         if (FAILURE == ret) {
             NR5G_FAPI_LOG(ERROR_LOG,
                 ("[NR5G_FAPI][FAPI2PHY] Error sending API's to PHY"));
         }
-        queue->p_send_list_tail = queue->p_send_list_head = NULL;
     }
 }
 
@@ -45,6 +45,7 @@ PMAC2PHY_QUEUE_EL nr5g_fapi_fapi2phy_create_api_list_elem(
 
 void nr5g_fapi_fapi2phy_add_to_api_list(
     bool is_urllc,
+    uint8_t phy_id,
     PMAC2PHY_QUEUE_EL p_list_elem);
 
 void nr5g_fapi_fapi2phy_send_api_list(
@@ -55,12 +55,15 @@ uint8_t nr5g_fapi_shutdown_request(
 #ifdef DEBUG_MODE
 uint8_t nr5g_fapi_dl_iq_samples_request(
     bool is_urllc,
+    uint8_t phy_id,
     fapi_vendor_ext_iq_samples_req_t * p_fapi_req);
 uint8_t nr5g_fapi_ul_iq_samples_request(
     bool is_urllc,
+    uint8_t phy_id,
     fapi_vendor_ext_iq_samples_req_t * p_fapi_req);
 uint8_t nr5g_fapi_add_remove_core_message(
     bool is_urllc,
+    uint8_t phy_id,
     fapi_vendor_ext_add_remove_core_msg_t * p_fapi_req);
 #endif
 
@@ -59,4 +59,8 @@ uint16_t nr5g_fapi_calc_fft_size(
     uint8_t nSubcCommon,
     uint16_t bw);
 
+uint16_t nr5g_fapi_calc_n_rb(
+    uint8_t nSubcCommon,
+    uint16_t bw);
+
 #endif                          //_NR5G_FAPI_FAP2PHY_P5_PVT_PROC_H_
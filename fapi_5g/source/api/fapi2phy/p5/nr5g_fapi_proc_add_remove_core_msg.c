@@ -30,6 +30,7 @@
 
 /** @ingroup group_source_api_p5_fapi2phy_proc
  *
+ *  @param[in]  phy_id PHY instance the request is sent for.
  *  @param[in]  p_fapi_req Pointer to FAPI VENDOR ADD_REMOVE_CORE message structure.
  *  @return     Returns ::SUCCESS and ::FAILURE.
  *
@@ -40,6 +41,7 @@
 #ifdef DEBUG_MODE
 uint8_t nr5g_fapi_add_remove_core_message(
     bool is_urllc,
+    uint8_t phy_id,
     fapi_vendor_ext_add_remove_core_msg_t * p_fapi_req)
 {
     uint32_t i, k;
@@ -87,7 +89,7 @@ uint8_t nr5g_fapi_add_remove_core_message(
     }
     p_add_remove_bbu_cores->eOption = (BBUPOOL_CORE_OPERATION)p_fapi_req->add_remove_core_info.eOption;
 
-    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_list_elem);
+    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, phy_id, p_list_elem);
 
     NR5G_FAPI_LOG(INFO_LOG, ("[FAPI_VENDOR_EXT_ADD_REMOVE_CORE.message]"));
 
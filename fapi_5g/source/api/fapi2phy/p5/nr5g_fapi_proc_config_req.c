@@ -27,6 +27,7 @@
 #include "nr5g_fapi_fapi2phy_api.h"
 #include "nr5g_fapi_fapi2phy_p5_proc.h"
 #include "nr5g_fapi_fapi2phy_p5_pvt_proc.h"
+#include "nr5g_fapi_fapi2phy_p7_pvt_proc.h"
 #include "nr5g_fapi_memory.h"
 
  /** @ingroup group_source_api_p5_fapi2phy_proc
@@ -133,9 +134,15 @@ uint8_t nr5g_fapi_config_request(
     p_ia_config_req->nULFftSize =
         nr5g_fapi_calc_fft_size(p_ia_config_req->nSubcCommon,
         p_ia_config_req->nULBandwidth);
+    nr5g_fapi_build_cell_tables(p_phy_instance,
+        nr5g_fapi_calc_n_rb(p_ia_config_req->nSubcCommon,
+            p_ia_config_req->nDLBandwidth),
+        nr5g_fapi_calc_n_rb(p_ia_config_req->nSubcCommon,
+            p_ia_config_req->nULBandwidth));
 
     /* Add element to send list */
-    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_list_elem);
+    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_phy_instance->phy_id,
+        p_list_elem);
 
     p_stats->iapi_stats.iapi_config_req++;
     NR5G_FAPI_LOG(INFO_LOG, ("[CONFIG.request][%d]", p_phy_instance->phy_id));
@@ -301,8 +308,8 @@ uint8_t nr5g_fapi_config_req_to_phy_translation(
             /***** SSB Table *****/
             case FAPI_SSB_OFFSET_POINT_A_TAG:
                 p_ia_config_req->nSSBPrbOffset =
-                    GETVLFRM32B(tlvs[i].value, tlvs[i].tl.length) /
-                        (pow(2, p_ia_config_req->nSubcCommon));
+                    GETVLFRM32B(tlvs[i].value, tlvs[i].tl.length) >>
+                        p_ia_config_req->nSubcCommon;
                 ++i;
                 break;
 
@@ -644,3 +651,52 @@ uint16_t nr5g_fapi_calc_fft_size(
 
     return 0;
 }
+
+ /** @ingroup group_source_api_p5_fapi2phy_proc
+ *
+ *  @param[in]  sub_carrier_common  Sub carrier spacing
+ *  @param[in]  bw  Channel bandwidth in MHz
+ *
+ *  @return     Maximum transmission bandwidth in RBs, 0 if not supported
+ *
+ *  @description
+ *  This function returns N_RB of the carrier as per TS 38.101-1 Table
+ *  5.3.2-1 and TS 38.101-2 Table 5.3.2-1.
+ *
+**/
+uint16_t nr5g_fapi_calc_n_rb(
+    uint8_t sub_carrier_common,
+    uint16_t bw)
+{
+    static const struct {
+        uint16_t bw;
+        uint16_t n_rb[FAPI_SUBCARRIER_SPACING_120 + 1];
+    } n_rb_table[] = {
+        {FAPI_BANDWIDTH_5_MHZ, {25, 11, 0, 0}},
+        {FAPI_BANDWIDTH_10_MHZ, {52, 24, 11, 0}},
+        {FAPI_BANDWIDTH_15_MHZ, {79, 38, 18, 0}},
+        {FAPI_BANDWIDTH_20_MHZ, {106, 51, 24, 0}},
+        {FAPI_BANDWIDTH_25_MHZ, {133, 65, 31, 0}},
+        {FAPI_BANDWIDTH_30_MHZ, {160, 78, 38, 0}},
+        {FAPI_BANDWIDTH_40_MHZ, {216, 106, 51, 0}},
+        {FAPI_BANDWIDTH_50_MHZ, {270, 133, 65, 32}},
+        {FAPI_BANDWIDTH_60_MHZ, {0, 162, 79, 0}},
+        {FAPI_BANDWIDTH_70_MHZ, {0, 189, 93, 0}},
+        {FAPI_BANDWIDTH_80_MHZ, {0, 217, 107, 0}},
+        {FAPI_BANDWIDTH_90_MHZ, {0, 245, 121, 0}},
+        {FAPI_BANDWIDTH_100_MHZ, {0, 273, 135, 66}},
+        {FAPI_BANDWIDTH_200_MHZ, {0, 0, 264, 132}},
+        {FAPI_BANDWIDTH_400_MHZ, {0, 0, 0, 264}},
+    };
+    uint32_t idx;
+
+    if (sub_carrier_common > FAPI_SUBCARRIER_SPACING_120)
+        return 0;
+
+    for (idx = 0; idx < sizeof(n_rb_table) / sizeof(n_rb_table[0]); idx++) {
+        if (n_rb_table[idx].bw == bw)
+            return n_rb_table[idx].n_rb[sub_carrier_common];
+    }
+
+    return 0;
+}
@@ -81,7 +81,8 @@ uint8_t nr5g_fapi_shutdown_request(
         p_fapi_req->test_type;
 
     /* Add element to send list */
-    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_list_elem);
+    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_phy_instance->phy_id,
+        p_list_elem);
 
     p_stats->iapi_stats.iapi_shutdown_req++;
     NR5G_FAPI_LOG(INFO_LOG, ("[SHUTDOWN.request][%d]", p_phy_instance->phy_id));
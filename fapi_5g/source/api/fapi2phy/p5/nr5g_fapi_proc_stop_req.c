@@ -89,7 +89,8 @@ uint8_t nr5g_fapi_stop_request(
     p_stop_req->sSFN_Slot.nCarrierIdx = p_phy_instance->phy_id;
 
     /* Add element to send list */
-    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_list_elem);
+    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_phy_instance->phy_id,
+        p_list_elem);
 
     p_stats->iapi_stats.iapi_stop_req++;
     NR5G_FAPI_LOG(INFO_LOG, ("[STOP.request][%d]", p_phy_instance->phy_id));
@@ -30,7 +30,7 @@
 
  /** @ingroup group_source_api_p5_fapi2phy_proc
  *
- *  @param[in]  p_phy_instance Pointer to PHY instance.
+ *  @param[in]  phy_id PHY instance the request is sent for.
  *  @param[in]  p_fapi_req Pointer to FAPI UL_IQ_SAMPLES.request message structure.
  *  @return     Returns ::SUCCESS and ::FAILURE.
  *
@@ -44,6 +44,7 @@
 #ifdef DEBUG_MODE
 uint8_t nr5g_fapi_ul_iq_samples_request(
     bool is_urllc,
+    uint8_t phy_id,
     fapi_vendor_ext_iq_samples_req_t * p_fapi_req)
 {
     uint16_t num_ant;
@@ -131,7 +132,7 @@ uint8_t nr5g_fapi_ul_iq_samples_request(
         }
     }
 
-    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_list_elem);
+    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, phy_id, p_list_elem);
     NR5G_FAPI_LOG(INFO_LOG, ("[UL_IQ_SAMPLES.request][%d]",
             p_fapi_req->iq_samples_info.carrNum));
 
@@ -39,11 +39,22 @@ extern "C" {
 uint8_t nr5g_fapi_calc_n_rbg_size(
     uint16_t bwp_size);
 
+uint8_t nr5g_fapi_build_rbg_layout(
+    p_nr5g_fapi_rbg_layout_t p_layout,
+    uint16_t bwp_start,
+    uint16_t bwp_size);
+
 uint32_t nr5g_fapi_calc_rbg_index(
+    const nr5g_fapi_cell_tables_t * p_tables,
     const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
     uint16_t bwp_start,
     uint16_t bwp_size,
-    uint32_t(*get_rbg_index_mask)(uint32_t nth_bit));
+    bool msb_first);
+
+void nr5g_fapi_build_cell_tables(
+    p_nr5g_fapi_phy_instance_t p_phy_instance,
+    uint16_t dl_n_rb,
+    uint16_t ul_n_rb);
 
 uint16_t nr5g_fapi_get_rb_bits_for_rbg(
     const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
@@ -83,6 +94,7 @@ uint16_t nr5g_fapi_calculate_nEpreRatioOfPDSCHToSSB(
     uint8_t power_control_offset);
 
 uint32_t nr5g_fapi_calc_pdsch_rbg_index(
+    p_nr5g_fapi_phy_instance_t p_phy_instance,
     const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
     uint16_t bwp_start,
     uint16_t bwp_size);
@@ -99,6 +111,7 @@ void nr5g_fapi_fill_csi_rs_pdu(
 
 // UL_TTI.req
 uint32_t nr5g_fapi_calc_pusch_rbg_index(
+    p_nr5g_fapi_phy_instance_t p_phy_instance,
     const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
     uint16_t bwp_start,
     uint16_t bwp_size);
@@ -83,7 +83,8 @@ uint8_t nr5g_fapi_dl_tti_request(
         return FAILURE;
     }
     /* Add element to send list */
-    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_list_elem);
+    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_phy_instance->phy_id,
+        p_list_elem);
 
     p_stats->iapi_stats.iapi_dl_config_req++;
     NR5G_FAPI_LOG(DEBUG_LOG, ("[DL_TTI.request][%u][%u,%u,%u] is_urllc %u",
@@ -397,30 +398,27 @@ void nr5g_fapi_fill_dci_pdu(
     p_stats->iapi_stats.iapi_dl_tti_pdcch_pdus++;
 }
 
-static uint32_t get_rbg_index_mask_from_MSB(uint32_t nth_bit) {
-    #define DLSCH_RBG_INDEX_MSB 0x80000000u
-    return DLSCH_RBG_INDEX_MSB >> nth_bit;
-}
-
 /** @ingroup group_source_api_p7_fapi2phy_proc
  *
+ *  @param[in]  p_phy_instance Pointer to PHY instance.
  *  @param[in]  rb_bitmap Pointer to FAPI DL resource block bitmap.
  *  @param[in]  rbg_size  Size of resource block group.
  *
  *  @return     Returns IAPI nRBGIndex
  *
  *  @description
- *  Maps rbBitmap into nRBGIndex bits for pdsch.
+ *  Maps rbBitmap into nRBGIndex bits for pdsch, RBG-0 is the MSB.
  *
 **/
 uint32_t nr5g_fapi_calc_pdsch_rbg_index(
+    p_nr5g_fapi_phy_instance_t p_phy_instance,
     const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
     uint16_t bwp_start,
     uint16_t bwp_size
     )
 {
-    return nr5g_fapi_calc_rbg_index(
-        rb_bitmap, bwp_start, bwp_size, get_rbg_index_mask_from_MSB);
+    return nr5g_fapi_calc_rbg_index(&p_phy_instance->cell_tables,
+        rb_bitmap, bwp_start, bwp_size, TRUE);
 }
 
 /** @ingroup group_nr5g_test_config
@@ -487,7 +485,7 @@ void nr5g_fapi_fill_pdsch_pdu(
     if(FAPI_DL_RESOURCE_ALLOC_TYPE_0 == resource_alloc_type) {
         p_dlsch_pdu->nRBGSize = nr5g_fapi_calc_n_rbg_size(bwp_size);
         p_dlsch_pdu->nRBGIndex = nr5g_fapi_calc_pdsch_rbg_index(
-            p_pdsch_pdu->rbBitmap, bwp_start, bwp_size);
+            p_phy_instance, p_pdsch_pdu->rbBitmap, bwp_start, bwp_size);
     }
 
     p_dlsch_pdu->nRBStart = p_pdsch_pdu->rbStart;
@@ -575,12 +573,19 @@ void nr5g_fapi_fill_pdsch_pdu(
 uint16_t nr5g_fapi_calculate_nEpreRatioOfPDCCHToSSB(
     uint8_t beta_pdcch_1_0)
 {
-    if (beta_pdcch_1_0 > 0 && beta_pdcch_1_0 <= 2) {
-        return 1;
-    } else if (beta_pdcch_1_0 > 1 && beta_pdcch_1_0 < 17) {
-        return ((beta_pdcch_1_0 - 2) * 1000);
-    } else if (beta_pdcch_1_0 == 17) {
-        return ((beta_pdcch_1_0 - 3) * 1000);
+    #define PDCCH_MAPPING_SIZE 18U
+
+    static const uint16_t beta_pdcch_1_0_to_epre_ratio[PDCCH_MAPPING_SIZE] = {
+    //      0      1      2      3      4      5      6      7
+            0,     1,     1,  1000,  2000,  3000,  4000,  5000,
+    //      8      9     10     11     12     13     14     15
+         6000,  7000,  8000,  9000, 10000, 11000, 12000, 13000,
+    //     16     17
+        14000, 14000
+    };
+
+    if (PDCCH_MAPPING_SIZE > beta_pdcch_1_0) {
+        return beta_pdcch_1_0_to_epre_ratio[beta_pdcch_1_0];
     } else {
         return 0;
     }
@@ -711,7 +716,7 @@ uint16_t nr5g_fapi_calculate_nEpreRatioOfPDSCHToSSB(uint8_t power_control_offset
 uint8_t nr5g_fapi_calculate_nSSBPrbOffset(
     uint16_t ssb_offset_point_a, uint8_t sub_c_common)
 {
-    return ssb_offset_point_a/pow(2, sub_c_common);
+    return ssb_offset_point_a >> sub_c_common;
 }
 
 /** @ingroup group_nr5g_test_config
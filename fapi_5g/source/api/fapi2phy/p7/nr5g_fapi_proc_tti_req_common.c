@@ -63,36 +63,80 @@ uint16_t nr5g_fapi_get_rb_bits_for_rbg(
     return (rb_bits >> local_rbg_idx) & rb_bitmap_mask;
 }
 
-static bool nr5g_fapi_has_rbg_bits_in_rb_bitmap(
-    const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
-    const uint16_t rbg_bit,
-    const uint8_t rbg_size,
-    const uint16_t rb_bitmap_mask)
+// RBGs of a bandwidth part and the rbBitmap bits each of them covers
+typedef struct _nr5g_fapi_rbg_bounds {
+    uint8_t rbg_size;
+    uint16_t rbg_bit_begin;
+    uint16_t rbg_bit_last;
+    uint16_t rb_bitmap_mask;
+    uint16_t rb_bitmap_mask_1st_rbg;
+    uint16_t rb_bitmap_mask_last_rbg;
+} nr5g_fapi_rbg_bounds_t;
+
+static uint8_t nr5g_fapi_calc_rbg_bounds(
+    uint16_t bwp_start,
+    uint16_t bwp_size,
+    nr5g_fapi_rbg_bounds_t * p_bounds)
 {
-    const uint16_t rb_bits_for_rbg = nr5g_fapi_get_rb_bits_for_rbg(
-        rb_bitmap, rbg_bit, rbg_size, rb_bitmap_mask);
-    if (rb_bitmap_mask == rb_bits_for_rbg)
+    const uint8_t rbg_size = nr5g_fapi_calc_n_rbg_size(bwp_size);
+    const uint16_t rb_bitmap_mask = nr5g_fapi_rb_bitmap_mask(rbg_size);
+
+    p_bounds->rbg_size = rbg_size;
+    if (FAPI_EMPTY_RB_BITMAP_MASK == rb_bitmap_mask)
     {
-        return true;
+        NR5G_FAPI_LOG(ERROR_LOG, ("Wrong rbg_size=%u. rbg_index set to 0.",
+            rbg_size));
+        return FAILURE;
     }
-    else if (FAPI_EMPTY_RB_BITMAP_MASK != rb_bits_for_rbg)
+    if (bwp_start >= FAPI_MAX_RB_BIT_NUM)
     {
-        NR5G_FAPI_LOG(ERROR_LOG, ("rb_bits don not match rb_bitmap_mask."
-            " rbg_size %u rbg_bit=%u rb_bits_for_rbg=%#X rb_bitmap_mask=%#X",
-            rbg_size, rbg_bit, rb_bits_for_rbg, rb_bitmap_mask));
+        NR5G_FAPI_LOG(ERROR_LOG, ("Wrong bwp_start=%u. rbg_index set to 0.",
+            bwp_start));
+        return FAILURE;
     }
-    return false;
+
+    const uint16_t rb_bit_end = (bwp_start + bwp_size < FAPI_MAX_RB_BIT_NUM) ?
+        bwp_start + bwp_size : FAPI_MAX_RB_BIT_NUM;
+    const uint16_t start_offset = bwp_start % rbg_size;
+    const uint16_t last_rbg_size =
+        (0u == rb_bit_end % rbg_size) ? rbg_size : rb_bit_end % rbg_size;
+    const uint16_t end_offset = rbg_size - last_rbg_size;
+
+    p_bounds->rbg_bit_begin = bwp_start / rbg_size;
+    p_bounds->rbg_bit_last = (rb_bit_end + rbg_size - 1u) / rbg_size - 1u;
+    p_bounds->rb_bitmap_mask = rb_bitmap_mask;
+    p_bounds->rb_bitmap_mask_1st_rbg =
+        rb_bitmap_mask & (rb_bitmap_mask << start_offset);
+    p_bounds->rb_bitmap_mask_last_rbg = rb_bitmap_mask >> end_offset;
+    if (p_bounds->rbg_bit_begin == p_bounds->rbg_bit_last)
+    {
+        const uint16_t mask = p_bounds->rb_bitmap_mask_1st_rbg &
+            p_bounds->rb_bitmap_mask_last_rbg;
+        p_bounds->rb_bitmap_mask_1st_rbg = mask;
+        p_bounds->rb_bitmap_mask_last_rbg = mask;
+    }
+
+    return SUCCESS;
+}
+
+static inline uint16_t nr5g_fapi_rbg_mask(
+    const nr5g_fapi_rbg_bounds_t * p_bounds,
+    uint16_t rbg_bit)
+{
+    if (rbg_bit == p_bounds->rbg_bit_begin)
+        return p_bounds->rb_bitmap_mask_1st_rbg;
+    if (rbg_bit == p_bounds->rbg_bit_last)
+        return p_bounds->rb_bitmap_mask_last_rbg;
+    return p_bounds->rb_bitmap_mask;
 }
 
 /** @ingroup group_source_api_p7_fapi2phy_proc
  *
- *  @param[in]  rb_bitmap Pointer to FAPI DL resource block bitmap.
+ *  @param[out] p_layout  RBG layout of the bandwidth part.
  *  @param[in]  bwp_start Value of bandwidth partition start.
- *  @param[in]  bwp_size Value of bandwidth partition size.
- *  @param[in]  rbg_size Value of resource block group size.
- *  @param[in]  get_rbg_index_mask Function placing bit in rbgIndex (bit order).
+ *  @param[in]  bwp_size  Value of bandwidth partition size.
  *
- *  @return     Returns IAPI nRBGIndex
+ *  @return     Returns ::SUCCESS and ::FAILURE.
  *
  *  @description
  *  See TS 138 214 5.1.2.2.1/6.1.2.2.1 for more info.
@@ -105,73 +149,190 @@ static bool nr5g_fapi_has_rbg_bits_in_rb_bitmap(
  *  FAPI  RB-0...RB-272:
  *  FAPI  rbBitmap[i]  = RB-(7+i*8)...........RB-(0+i*8) (MSB to LSB)
  *
+ *  Stores for every RBG of the bandwidth part the rbBitmap bits it covers
+ *  and its nRBGIndex bit in both bit orders. The first and the last RBG
+ *  only cover the RBs inside the bandwidth part.
+ *
 **/
-uint32_t nr5g_fapi_calc_rbg_index(
-    const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
+uint8_t nr5g_fapi_build_rbg_layout(
+    p_nr5g_fapi_rbg_layout_t p_layout,
     uint16_t bwp_start,
-    uint16_t bwp_size,
-    uint32_t(*get_rbg_index_mask)(uint32_t nth_bit))
+    uint16_t bwp_size)
 {
-    const uint8_t rbg_size = nr5g_fapi_calc_n_rbg_size(bwp_size);
-    const uint16_t rb_bitmap_mask = nr5g_fapi_rb_bitmap_mask(rbg_size);
-    if (FAPI_EMPTY_RB_BITMAP_MASK == rb_bitmap_mask)
-    {
-        NR5G_FAPI_LOG(ERROR_LOG, ("Wrong rbg_size=%u. rbg_index set to 0.",
-            rbg_size));
-        return FAPI_EMPTY_RBG_INDEX;
-    }
-    if (bwp_start >= FAPI_MAX_RB_BIT_NUM)
-    {
-        NR5G_FAPI_LOG(ERROR_LOG, ("Wrong bwp_start=%u. rbg_index set to 0.",
-            bwp_start));
-        return FAPI_EMPTY_RBG_INDEX;
-    }
+    nr5g_fapi_rbg_bounds_t bounds;
+    nr5g_fapi_rbg_entry_t *p_entry;
+    uint16_t rbg_bit, nth_rb_bit;
+    uint8_t ret;
 
-    const uint16_t rbg_bit_begin = bwp_start / rbg_size;
-    const uint16_t rb_bit_end = fmin(FAPI_MAX_RB_BIT_NUM, bwp_start + bwp_size);
-    const uint16_t rbg_bit_last = ceil((double)rb_bit_end / rbg_size) - 1u;
+    p_layout->bwp_start = bwp_start;
+    p_layout->bwp_size = bwp_size;
+    p_layout->num_rbg = 0;
+    ret = nr5g_fapi_calc_rbg_bounds(bwp_start, bwp_size, &bounds);
+    p_layout->rbg_size = bounds.rbg_size;
+    if (FAILURE == ret)
+        return FAILURE;
 
-    const uint16_t start_offset = bwp_start % rbg_size;
-    uint16_t rb_bitmap_mask_1st_rbg =
-        rb_bitmap_mask & (rb_bitmap_mask << start_offset);
-    const uint16_t last_rbg_size =
-        (0u == rb_bit_end % rbg_size) ? rbg_size : rb_bit_end % rbg_size;
-    const uint16_t end_offset = rbg_size - last_rbg_size;
-    uint16_t rb_bitmap_mask_last_rbg = rb_bitmap_mask >> end_offset;
-    if (rbg_bit_begin == rbg_bit_last)
+    for (rbg_bit = bounds.rbg_bit_begin; rbg_bit <= bounds.rbg_bit_last &&
+        p_layout->num_rbg < NR5G_FAPI_MAX_RBG_PER_BWP; rbg_bit++)
     {
-        const uint16_t mask = rb_bitmap_mask_1st_rbg & rb_bitmap_mask_last_rbg;
-        rb_bitmap_mask_1st_rbg = mask;
-        rb_bitmap_mask_last_rbg = mask;
+        // 16 bit windows never straddle an RBG as rbg_size divides 16
+        nth_rb_bit = rbg_bit * bounds.rbg_size;
+        p_entry = &p_layout->rbg[p_layout->num_rbg++];
+        p_entry->byte = (nth_rb_bit / 16u) * sizeof(uint16_t);
+        p_entry->shift = nth_rb_bit % 16u;
+        p_entry->mask = nr5g_fapi_rbg_mask(&bounds, rbg_bit);
+        if (p_entry->byte + 1u >= FAPI_RB_BITMAP_SIZE)
+            p_entry->mask = FAPI_EMPTY_RB_BITMAP_MASK;
+        p_entry->msb_bit = (rbg_bit < 32u) ? (0x80000000u >> rbg_bit) : 0u;
+        p_entry->lsb_bit = (rbg_bit < 32u) ? (0x1u << rbg_bit) : 0u;
     }
 
+    return SUCCESS;
+}
+
+/** @ingroup group_source_api_p7_fapi2phy_proc
+ *
+ *  @param[in]  p_layout  RBG layout of the bandwidth part.
+ *  @param[in]  rb_bitmap Pointer to FAPI resource block bitmap.
+ *  @param[in]  msb_first nRBGIndex bit order, TRUE for PDSCH.
+ *
+ *  @return     Returns IAPI nRBGIndex
+ *
+ *  @description
+ *  An RBG is allocated when all its RBs inside the bandwidth part are set.
+ *
+**/
+static uint32_t nr5g_fapi_rbg_layout_to_index(
+    const nr5g_fapi_rbg_layout_t * p_layout,
+    const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
+    bool msb_first)
+{
+    const nr5g_fapi_rbg_entry_t *p_entry;
     uint32_t result = 0u;
-    // fill 1st rbg
-    if (nr5g_fapi_has_rbg_bits_in_rb_bitmap(
-        rb_bitmap, rbg_bit_begin, rbg_size, rb_bitmap_mask_1st_rbg))
+    uint16_t rb_bits;
+    uint8_t idx;
+
+    for (idx = 0; idx < p_layout->num_rbg; idx++)
     {
-        result |= get_rbg_index_mask(rbg_bit_begin);
+        p_entry = &p_layout->rbg[idx];
+        if (FAPI_EMPTY_RB_BITMAP_MASK == p_entry->mask)
+            continue;
+        rb_bits = ((rb_bitmap[p_entry->byte] |
+                (rb_bitmap[p_entry->byte + 1u] << CHAR_BIT)) >>
+            p_entry->shift) & p_entry->mask;
+        if (p_entry->mask == rb_bits)
+        {
+            result |= msb_first ? p_entry->msb_bit : p_entry->lsb_bit;
+        }
+        else if (FAPI_EMPTY_RB_BITMAP_MASK != rb_bits)
+        {
+            NR5G_FAPI_LOG(ERROR_LOG, ("rb_bits don not match rb_bitmap_mask."
+                " rbg_size %u rbg_bit=%u rb_bits_for_rbg=%#X rb_bitmap_mask=%#X",
+                p_layout->rbg_size,
+                p_layout->bwp_start / p_layout->rbg_size + idx, rb_bits,
+                p_entry->mask));
+        }
     }
-    // fill last rbg
-    if (nr5g_fapi_has_rbg_bits_in_rb_bitmap(
-        rb_bitmap, rbg_bit_last, rbg_size, rb_bitmap_mask_last_rbg))
+
+    return result;
+}
+
+/** @ingroup group_source_api_p7_fapi2phy_proc
+ *
+ *  @param[in]  p_tables  Cell tables of the PHY instance.
+ *  @param[in]  rb_bitmap Pointer to FAPI resource block bitmap.
+ *  @param[in]  bwp_start Value of bandwidth partition start.
+ *  @param[in]  bwp_size  Value of bandwidth partition size.
+ *  @param[in]  msb_first nRBGIndex bit order, TRUE for PDSCH.
+ *
+ *  @return     Returns IAPI nRBGIndex
+ *
+ *  @description
+ *  Maps rbBitmap into nRBGIndex bits using the RBG layout built at
+ *  CONFIG.request when the bandwidth part is the carrier, other bandwidth
+ *  parts are mapped RBG by RBG.
+ *
+**/
+uint32_t nr5g_fapi_calc_rbg_index(
+    const nr5g_fapi_cell_tables_t * p_tables,
+    const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
+    uint16_t bwp_start,
+    uint16_t bwp_size,
+    bool msb_first)
+{
+    nr5g_fapi_rbg_bounds_t bounds;
+    uint32_t result = 0u;
+    uint16_t rbg_bit, rb_bits, mask;
+    uint8_t idx;
+
+    for (idx = 0; idx < p_tables->num_rbg_layouts; idx++)
     {
-        result |= get_rbg_index_mask(rbg_bit_last);
+        if ((p_tables->rbg_layout[idx].bwp_start == bwp_start) &&
+            (p_tables->rbg_layout[idx].bwp_size == bwp_size))
+            return nr5g_fapi_rbg_layout_to_index(&p_tables->rbg_layout[idx],
+                rb_bitmap, msb_first);
     }
-    // fill rest of rbgs
-    uint8_t rbg_bit;
-    for (rbg_bit = rbg_bit_begin + 1u; rbg_bit < rbg_bit_last; rbg_bit++)
+
+    // Other bandwidth parts go RBG by RBG, filling a whole layout for a
+    // single PDU costs more than it saves
+    if (FAILURE == nr5g_fapi_calc_rbg_bounds(bwp_start, bwp_size, &bounds))
+        return FAPI_EMPTY_RBG_INDEX;
+
+    for (rbg_bit = bounds.rbg_bit_begin; rbg_bit <= bounds.rbg_bit_last &&
+        rbg_bit < 32u; rbg_bit++)
     {
-        if (nr5g_fapi_has_rbg_bits_in_rb_bitmap(
-            rb_bitmap, rbg_bit, rbg_size, rb_bitmap_mask))
+        mask = nr5g_fapi_rbg_mask(&bounds, rbg_bit);
+        rb_bits = nr5g_fapi_get_rb_bits_for_rbg(rb_bitmap, rbg_bit,
+            bounds.rbg_size, mask);
+        if (mask == rb_bits)
+        {
+            result |= msb_first ? (0x80000000u >> rbg_bit) : (0x1u << rbg_bit);
+        }
+        else if (FAPI_EMPTY_RB_BITMAP_MASK != rb_bits)
         {
-            result |= get_rbg_index_mask(rbg_bit);
+            NR5G_FAPI_LOG(ERROR_LOG, ("rb_bits don not match rb_bitmap_mask."
+                " rbg_size %u rbg_bit=%u rb_bits_for_rbg=%#X rb_bitmap_mask=%#X",
+                bounds.rbg_size, rbg_bit, rb_bits, mask));
         }
     }
 
     return result;
 }
 
+/** @ingroup group_source_api_p7_fapi2phy_proc
+ *
+ *  @param[in]  p_phy_instance Pointer to PHY instance.
+ *  @param[in]  dl_n_rb  Number of DL RBs of the carrier.
+ *  @param[in]  ul_n_rb  Number of UL RBs of the carrier.
+ *
+ *  @return     void
+ *
+ *  @description
+ *  Builds the cell static tables used by DL_TTI/UL_TTI.request translation.
+ *  Called at CONFIG.request, when no TTI.request is being translated for
+ *  the PHY instance.
+ *
+**/
+void nr5g_fapi_build_cell_tables(
+    p_nr5g_fapi_phy_instance_t p_phy_instance,
+    uint16_t dl_n_rb,
+    uint16_t ul_n_rb)
+{
+    p_nr5g_fapi_cell_tables_t p_tables = &p_phy_instance->cell_tables;
+    const uint16_t n_rb[NR5G_FAPI_MAX_RBG_LAYOUTS] = { dl_n_rb, ul_n_rb };
+    uint8_t idx;
+
+    p_tables->num_rbg_layouts = 0;
+    for (idx = 0; idx < NR5G_FAPI_MAX_RBG_LAYOUTS; idx++)
+    {
+        if (!n_rb[idx] || ((idx == 1) && (ul_n_rb == dl_n_rb)))
+            continue;
+        if (SUCCESS == nr5g_fapi_build_rbg_layout(
+                &p_tables->rbg_layout[p_tables->num_rbg_layouts], 0, n_rb[idx]))
+            p_tables->num_rbg_layouts++;
+    }
+}
+
  /** @ingroup group_source_api_p7_fapi2phy_proc
  *
  *  @param[in]  bwp_size  Variable holding the Bandwidth part size.
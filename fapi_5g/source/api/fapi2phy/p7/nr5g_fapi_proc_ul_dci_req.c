@@ -88,7 +88,8 @@ uint8_t nr5g_fapi_ul_dci_request(
                 p_ia_ul_dci_req->sSFN_Slot.nSlot));
         return FAILURE;
     }
-    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_list_elem);
+    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_phy_instance->phy_id,
+        p_list_elem);
 
     p_stats->iapi_stats.iapi_ul_dci_req++;
 
@@ -93,7 +93,8 @@ uint8_t nr5g_fapi_ul_tti_request(
         return FAILURE;
     }
 
-    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_list_elem);
+    nr5g_fapi_fapi2phy_add_to_api_list(is_urllc, p_phy_instance->phy_id,
+        p_list_elem);
 
     p_stats->iapi_stats.iapi_ul_config_req++;
     NR5G_FAPI_LOG(DEBUG_LOG, ("[UL_TTI.request][%u][%u,%u,%u] is_urllc %u",
@@ -104,30 +105,27 @@ uint8_t nr5g_fapi_ul_tti_request(
     return SUCCESS;
 }
 
-static uint32_t get_rbg_index_mask_from_LSB(uint32_t nth_bit) {
-    #define ULSCH_RBG_INDEX_LSB 0x1u
-    return ULSCH_RBG_INDEX_LSB << nth_bit;
-}
-
  /** @ingroup group_source_api_p7_fapi2phy_proc
  *
+ *  @param[in]  p_phy_instance Pointer to PHY instance.
  *  @param[in]  rb_bitmap Pointer to FAPI DL resource block bitmap.
  *  @param[in]  rbg_size  Size of resource block group.
  *  
  *  @return     Returns IAPI nRBGIndex
  *
  *  @description
- *  Maps rbBitmap into nRBGIndex bits for pusch.
+ *  Maps rbBitmap into nRBGIndex bits for pusch, RBG-0 is the LSB.
  *
 **/
 uint32_t nr5g_fapi_calc_pusch_rbg_index(
+    p_nr5g_fapi_phy_instance_t p_phy_instance,
     const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
     uint16_t bwp_start,
     uint16_t bwp_size
     )
 {
-    return nr5g_fapi_calc_rbg_index(
-        rb_bitmap, bwp_start, bwp_size, get_rbg_index_mask_from_LSB);
+    return nr5g_fapi_calc_rbg_index(&p_phy_instance->cell_tables,
+        rb_bitmap, bwp_start, bwp_size, FALSE);
 }
 
  /** @ingroup group_source_api_p7_fapi2phy_proc
@@ -201,12 +199,12 @@ void nr5g_fapi_pusch_ptrs_to_phy_ulsch_translation(
 
     if (p_pusch_ptrs->ptrsTimeDensity <= 2) {
         p_ul_data_chan->nPTRSTimeDensity =
-            pow(2, p_pusch_ptrs->ptrsTimeDensity);
+            1u << p_pusch_ptrs->ptrsTimeDensity;
     }
     if (p_pusch_ptrs->ptrsFreqDensity == 0 ||
         p_pusch_ptrs->ptrsFreqDensity == 1) {
         p_ul_data_chan->nPTRSFreqDensity =
-            pow(2, (p_pusch_ptrs->ptrsFreqDensity + 1));
+            1u << (p_pusch_ptrs->ptrsFreqDensity + 1);
     }
     if (p_pusch_ptrs->numPtrsPorts > 0) {
         num_ptrs_ports = p_ul_data_chan->nNrOfPTRSPorts = 1;
@@ -318,7 +316,7 @@ void nr5g_fapi_pusch_to_phy_ulsch_translation(
             ceil((bwp_size + (bwp_start % n_rbg_size)) / n_rbg_size);
     }
         p_ul_data_chan->nRBGIndex = nr5g_fapi_calc_pusch_rbg_index(
-            p_pusch_pdu->rbBitmap, bwp_start, bwp_size);
+            p_phy_instance, p_pusch_pdu->rbBitmap, bwp_start, bwp_size);
     }
     p_ul_data_chan->nRBStart = p_pusch_pdu->rbStart;
     p_ul_data_chan->nRBSize = p_pusch_pdu->rbSize;
@@ -451,9 +449,9 @@ void nr5g_fapi_srs_to_phy_srs_translation(
 
     p_ul_srs_chan->nSubcSpacing = p_srs_pdu->subCarrierSpacing;
     p_ul_srs_chan->nCpType = p_srs_pdu->cyclicPrefix;
-    p_ul_srs_chan->nNrOfSrsPorts = pow(2, p_srs_pdu->numAntPorts);
-    p_ul_srs_chan->nNrOfSymbols = pow(2, p_srs_pdu->numSymbols);
-    p_ul_srs_chan->nRepetition = pow(2, p_srs_pdu->numRepetitions);
+    p_ul_srs_chan->nNrOfSrsPorts = 1u << p_srs_pdu->numAntPorts;
+    p_ul_srs_chan->nNrOfSymbols = 1u << p_srs_pdu->numSymbols;
+    p_ul_srs_chan->nRepetition = 1u << p_srs_pdu->numRepetitions;
     if (p_ul_srs_chan->nCpType) {   //Extended Cyclic Prefix
         p_ul_srs_chan->nStartPos = 11 - p_srs_pdu->timeStartPosition;
     } else {
@@ -0,0 +1,273 @@
+/******************************************************************************
+*
+*   Copyright (c) 2021 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @file This file defines the PHY2MAC indication conversion benchmark. It
+ * times the ul_cqi conversion of 256 UEs (CRC/UCI.indication) and the
+ * full band per RB SNR conversion of 256 UEs (SRS.indication), one value
+ * per call against one array per call, after checking both give the values
+ * of the double floor/ceil conversion they replaced for every input.
+ *
+ **/
+#include <getopt.h>
+#include <immintrin.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "nr5g_fapi_snr_conversion.h"
+#include "nr5g_mac_phy_api.h"
+
+#define NR5G_FAPI_BENCH_NUM_UE          (256)
+#define NR5G_FAPI_BENCH_NUM_RBS         (272)   // 68 SRS blocks of 4 RBs
+#define NR5G_FAPI_BENCH_RBS_PER_ROW     (68)    // nBlockSNR row
+#define NR5G_FAPI_BENCH_NUM_ROWS \
+    (NR5G_FAPI_BENCH_NUM_RBS / NR5G_FAPI_BENCH_RBS_PER_ROW)
+
+typedef struct _nr5g_fapi_bench_t {
+    int16_t snr[NR5G_FAPI_BENCH_NUM_UE];
+    uint8_t ul_cqi[NR5G_FAPI_BENCH_NUM_UE];
+    int8_t rb_snr[NR5G_FAPI_BENCH_NUM_UE][NR5G_FAPI_BENCH_NUM_ROWS]
+        [NR5G_FAPI_BENCH_RBS_PER_ROW];
+    uint8_t fapi_rb_snr[NR5G_FAPI_BENCH_NUM_UE][NR5G_FAPI_BENCH_NUM_RBS];
+} nr5g_fapi_bench_t;
+
+static nr5g_fapi_bench_t nr5g_fapi_bench;
+
+static void nr5g_fapi_bench_usage(
+    const char *prgname)
+{
+    printf("Usage: %s [-n <iterations>]\n"
+        "  -n  number of times each conversion is timed (default 100000)\n",
+        prgname);
+}
+
+//------------------------------------------------------------------------------
+// Conversions before the array converters, kept as the reference. The old
+// ul_cqi code cast the floored double straight to uint8_t, which is
+// undefined for negative values in C; it goes through int32_t here, which
+// is the conversion x86 compilers emitted for it.
+//------------------------------------------------------------------------------
+static uint8_t nr5g_fapi_bench_snr_ref(
+    const int16_t snr)
+{
+    double temp = (double)snr / SINR_STEP_SIZE;
+    if (temp < 0) {
+        return 2 * ((uint8_t) (int32_t) floor(temp) & 0x003F);
+    }
+    return (2 * ((uint8_t) (int32_t) ceil(temp) & 0x003F)) + 128;
+}
+
+static uint8_t nr5g_fapi_bench_srs_snr_ref(
+    const int8_t snr)
+{
+    return (snr + 64) * 2;
+}
+
+// Inputs where the reported value wraps or changes sign: the int16_t and
+// int8_t limits, 0 and the 6 bit ul_cqi wrap at +-64 dB
+static const int32_t nr5g_fapi_bench_snr_edges[] = {
+    INT16_MIN, INT16_MIN + 1, -64 * SINR_STEP_SIZE - 1, -64 * SINR_STEP_SIZE,
+    -64 * SINR_STEP_SIZE + 1, -63 * SINR_STEP_SIZE, -SINR_STEP_SIZE - 1,
+    -SINR_STEP_SIZE, -1, 0, 1, SINR_STEP_SIZE, SINR_STEP_SIZE + 1,
+    63 * SINR_STEP_SIZE, 63 * SINR_STEP_SIZE + 1, 64 * SINR_STEP_SIZE - 1,
+    64 * SINR_STEP_SIZE, 64 * SINR_STEP_SIZE + 1, INT16_MAX - 1, INT16_MAX
+};
+
+static const int32_t nr5g_fapi_bench_srs_snr_edges[] = {
+    INT8_MIN, INT8_MIN + 1, -65, -64, -63, -1, 0, 1, 63, 64, INT8_MAX - 1,
+    INT8_MAX
+};
+
+static uint32_t nr5g_fapi_bench_check(
+    )
+{
+    int16_t snr[256];
+    uint8_t ul_cqi[256];
+    int8_t rb_snr[256];
+    uint8_t fapi_rb_snr[256];
+    uint32_t num_errors = 0, num_checks = 0, idx;
+    int32_t base;
+    uint8_t ref;
+
+    // Every input through the vector body of the array converter
+    for (base = INT16_MIN; base <= INT16_MAX; base += 256) {
+        for (idx = 0; idx < 256; idx++)
+            snr[idx] = (int16_t) (base + idx);
+        nr5g_fapi_convert_snr_iapi_to_fapi_array(snr, ul_cqi, 256);
+        for (idx = 0; idx < 256; idx++, num_checks++) {
+            ref = nr5g_fapi_bench_snr_ref(snr[idx]);
+            if (ul_cqi[idx] != ref ||
+                nr5g_fapi_convert_snr_iapi_to_fapi(snr[idx]) != ref)
+                num_errors++;
+        }
+    }
+
+    // Edges one at a time, through the remainder loop
+    for (idx = 0; idx < sizeof(nr5g_fapi_bench_snr_edges) /
+        sizeof(nr5g_fapi_bench_snr_edges[0]); idx++) {
+        if (nr5g_fapi_bench_snr_edges[idx] < INT16_MIN ||
+            nr5g_fapi_bench_snr_edges[idx] > INT16_MAX)
+            continue;
+        num_checks++;
+        snr[0] = (int16_t) nr5g_fapi_bench_snr_edges[idx];
+        nr5g_fapi_convert_snr_iapi_to_fapi_array(snr, ul_cqi, 1);
+        if (ul_cqi[0] != nr5g_fapi_bench_snr_ref(snr[0])) {
+            printf("Error: nSNR %d gives ul_cqi %u, expected %u\n", snr[0],
+                ul_cqi[0], nr5g_fapi_bench_snr_ref(snr[0]));
+            num_errors++;
+        }
+    }
+
+    for (idx = 0; idx < 256; idx++)
+        rb_snr[idx] = (int8_t) idx;
+    nr5g_fapi_convert_srs_snr_iapi_to_fapi_array(rb_snr, fapi_rb_snr, 256);
+    for (idx = 0; idx < 256; idx++, num_checks++) {
+        ref = nr5g_fapi_bench_srs_snr_ref(rb_snr[idx]);
+        if (fapi_rb_snr[idx] != ref ||
+            nr5g_fapi_convert_srs_snr_iapi_to_fapi(rb_snr[idx]) != ref)
+            num_errors++;
+    }
+
+    for (idx = 0; idx < sizeof(nr5g_fapi_bench_srs_snr_edges) /
+        sizeof(nr5g_fapi_bench_srs_snr_edges[0]); idx++, num_checks++) {
+        rb_snr[0] = (int8_t) nr5g_fapi_bench_srs_snr_edges[idx];
+        nr5g_fapi_convert_srs_snr_iapi_to_fapi_array(rb_snr, fapi_rb_snr, 1);
+        if (fapi_rb_snr[0] != nr5g_fapi_bench_srs_snr_ref(rb_snr[0])) {
+            printf("Error: SRS SNR %d gives %u, expected %u\n", rb_snr[0],
+                fapi_rb_snr[0], nr5g_fapi_bench_srs_snr_ref(rb_snr[0]));
+            num_errors++;
+        }
+    }
+    printf("%u values checked against the double conversion, %u differ\n\n",
+        num_checks, num_errors);
+
+    return num_errors;
+}
+
+static void nr5g_fapi_bench_print(
+    const char *name,
+    uint64_t ticks,
+    uint32_t num_iter,
+    uint64_t tsc_hz)
+{
+    double ns = (double)ticks * 1000000000.0 / tsc_hz / num_iter;
+
+    printf("%-28s %12.1f %12.2f\n", name, ns, ns / NR5G_FAPI_BENCH_NUM_UE);
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    nr5g_fapi_bench_t *p_bench = &nr5g_fapi_bench;
+    uint32_t num_iter = 100000, iter, ue, rb, num_errors;
+    uint64_t start_tick, tsc_hz, ticks;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                num_iter = (uint32_t) atoi(optarg);
+                break;
+            default:
+                nr5g_fapi_bench_usage(argv[0]);
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if (!num_iter) {
+        nr5g_fapi_bench_usage(argv[0]);
+        return 1;
+    }
+
+    num_errors = nr5g_fapi_bench_check();
+    if (num_errors) {
+        printf("Error: %u values differ from the double conversion\n",
+            num_errors);
+        return 1;
+    }
+
+    srand(1);
+    for (ue = 0; ue < NR5G_FAPI_BENCH_NUM_UE; ue++) {
+        p_bench->snr[ue] = (int16_t) rand();
+        for (rb = 0; rb < NR5G_FAPI_BENCH_NUM_RBS; rb++)
+            p_bench->rb_snr[ue][rb / NR5G_FAPI_BENCH_RBS_PER_ROW]
+                [rb % NR5G_FAPI_BENCH_RBS_PER_ROW] = (int8_t) rand();
+    }
+
+    start_tick = __rdtsc();
+    usleep(100000);
+    tsc_hz = (__rdtsc() - start_tick) * 10;
+
+    printf("%u UEs, %u RBs per SRS, %u iterations\n\n",
+        NR5G_FAPI_BENCH_NUM_UE, NR5G_FAPI_BENCH_NUM_RBS, num_iter);
+    printf("%-28s %12s %12s\n", "conversion", "ns/iter", "ns/UE");
+
+    start_tick = __rdtsc();
+    for (iter = 0; iter < num_iter; iter++) {
+        for (ue = 0; ue < NR5G_FAPI_BENCH_NUM_UE; ue++)
+            p_bench->ul_cqi[ue] =
+                nr5g_fapi_convert_snr_iapi_to_fapi(p_bench->snr[ue]);
+        __asm__ volatile ("" : : "r" (p_bench->ul_cqi) : "memory");
+    }
+    ticks = __rdtsc() - start_tick;
+    nr5g_fapi_bench_print("ul_cqi scalar", ticks, num_iter, tsc_hz);
+
+    start_tick = __rdtsc();
+    for (iter = 0; iter < num_iter; iter++) {
+        nr5g_fapi_convert_snr_iapi_to_fapi_array(p_bench->snr,
+            p_bench->ul_cqi, NR5G_FAPI_BENCH_NUM_UE);
+        __asm__ volatile ("" : : "r" (p_bench->ul_cqi) : "memory");
+    }
+    ticks = __rdtsc() - start_tick;
+    nr5g_fapi_bench_print("ul_cqi array", ticks, num_iter, tsc_hz);
+
+    start_tick = __rdtsc();
+    for (iter = 0; iter < num_iter; iter++) {
+        for (ue = 0; ue < NR5G_FAPI_BENCH_NUM_UE; ue++) {
+            for (rb = 0; rb < NR5G_FAPI_BENCH_NUM_RBS; rb++)
+                p_bench->fapi_rb_snr[ue][rb] =
+                    nr5g_fapi_convert_srs_snr_iapi_to_fapi(
+                    p_bench->rb_snr[ue][rb / NR5G_FAPI_BENCH_RBS_PER_ROW]
+                    [rb % NR5G_FAPI_BENCH_RBS_PER_ROW]);
+            __asm__ volatile ("" : : "r" (p_bench->fapi_rb_snr[ue]) :
+                "memory");
+        }
+    }
+    ticks = __rdtsc() - start_tick;
+    nr5g_fapi_bench_print("SRS rbSNR scalar", ticks, num_iter, tsc_hz);
+
+    start_tick = __rdtsc();
+    for (iter = 0; iter < num_iter; iter++) {
+        for (ue = 0; ue < NR5G_FAPI_BENCH_NUM_UE; ue++) {
+            for (rb = 0; rb < NR5G_FAPI_BENCH_NUM_RBS;
+                rb += NR5G_FAPI_BENCH_RBS_PER_ROW)
+                nr5g_fapi_convert_srs_snr_iapi_to_fapi_array(
+                    p_bench->rb_snr[ue][rb / NR5G_FAPI_BENCH_RBS_PER_ROW],
+                    &p_bench->fapi_rb_snr[ue][rb],
+                    NR5G_FAPI_BENCH_RBS_PER_ROW);
+            __asm__ volatile ("" : : "r" (p_bench->fapi_rb_snr[ue]) :
+                "memory");
+        }
+    }
+    ticks = __rdtsc() - start_tick;
+    nr5g_fapi_bench_print("SRS rbSNR array", ticks, num_iter, tsc_hz);
+
+    return 0;
+}
@@ -0,0 +1,349 @@
+/******************************************************************************
+*
+*   Copyright (c) 2021 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @file This file defines the resource allocation type 0 benchmark. It
+ * first checks that nr5g_fapi_calc_rbg_index, with and without the RBG
+ * layout of the cell tables, gives the nRBGIndex of the per RBG
+ * computation it replaced for every bwp_start and bwp_size, both bit
+ * orders and a set of rbBitmaps. Then it times the three of them on
+ * the same PDSCH/PUSCH allocations.
+ *
+ **/
+#include <getopt.h>
+#include <limits.h>
+#include <immintrin.h>
+#include "nr5g_fapi_std.h"
+#include "nr5g_fapi_framework.h"
+#include "nr5g_fapi_fapi2phy_p7_pvt_proc.h"
+
+#define NR5G_FAPI_RBG_BENCH_MAX_RB      (275)   // largest BWP of the checks
+#define NR5G_FAPI_RBG_BENCH_NUM_BITMAPS (64)    // allocations per carrier
+#define NR5G_FAPI_RBG_BENCH_NUM_CHECKS  (10)    // bitmaps per BWP checked
+
+// Carriers timed, N_RB of TS 38.101-1 Table 5.3.2-1
+static const uint16_t nr5g_fapi_rbg_bench_n_rb[] = { 25, 51, 106, 133, 273 };
+
+typedef struct _nr5g_fapi_rbg_bench_t {
+    uint8_t rb_bitmap[NR5G_FAPI_RBG_BENCH_NUM_BITMAPS][FAPI_RB_BITMAP_SIZE];
+    uint32_t rbg_index[NR5G_FAPI_RBG_BENCH_NUM_BITMAPS];
+    nr5g_fapi_cell_tables_t tables;
+    nr5g_fapi_cell_tables_t no_tables;
+    uint32_t rand;
+} nr5g_fapi_rbg_bench_t;
+
+static nr5g_fapi_rbg_bench_t nr5g_fapi_rbg_bench;
+
+//------------------------------------------------------------------------------
+// nRBGIndex computation before the cell tables, kept as the reference. The
+// only change is that RBGs past bit 31 of nRBGIndex are not set, the old
+// code shifted by 32 or more for them.
+//------------------------------------------------------------------------------
+static uint32_t nr5g_fapi_rbg_bench_mask_from_msb(
+    uint32_t nth_bit)
+{
+    return (nth_bit < 32u) ? (0x80000000u >> nth_bit) : 0u;
+}
+
+static uint32_t nr5g_fapi_rbg_bench_mask_from_lsb(
+    uint32_t nth_bit)
+{
+    return (nth_bit < 32u) ? (0x1u << nth_bit) : 0u;
+}
+
+static uint16_t nr5g_fapi_rbg_bench_rb_bitmap_mask(
+    uint8_t rbg_size)
+{
+    switch (rbg_size) {
+        case 2:
+            return 0x3u;
+        case 4:
+            return 0xFu;
+        case 8:
+            return 0xFFu;
+        case 16:
+            return 0xFFFFu;
+        default:
+            return 0u;
+    }
+}
+
+static bool nr5g_fapi_rbg_bench_has_rbg_bits(
+    const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
+    const uint16_t rbg_bit,
+    const uint8_t rbg_size,
+    const uint16_t rb_bitmap_mask)
+{
+    return rb_bitmap_mask == nr5g_fapi_get_rb_bits_for_rbg(rb_bitmap,
+        rbg_bit, rbg_size, rb_bitmap_mask);
+}
+
+static uint32_t nr5g_fapi_rbg_bench_calc_rbg_index_ref(
+    const uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
+    uint16_t bwp_start,
+    uint16_t bwp_size,
+    uint32_t(*get_rbg_index_mask)(uint32_t nth_bit))
+{
+    const uint8_t rbg_size = nr5g_fapi_calc_n_rbg_size(bwp_size);
+    const uint16_t rb_bitmap_mask =
+        nr5g_fapi_rbg_bench_rb_bitmap_mask(rbg_size);
+    if (0u == rb_bitmap_mask)
+        return 0u;
+    if (bwp_start >= 273u)
+        return 0u;
+
+    const uint16_t rbg_bit_begin = bwp_start / rbg_size;
+    const uint16_t rb_bit_end = fmin(273u, bwp_start + bwp_size);
+    const uint16_t rbg_bit_last = ceil((double)rb_bit_end / rbg_size) - 1u;
+
+    const uint16_t start_offset = bwp_start % rbg_size;
+    uint16_t rb_bitmap_mask_1st_rbg =
+        rb_bitmap_mask & (rb_bitmap_mask << start_offset);
+    const uint16_t last_rbg_size =
+        (0u == rb_bit_end % rbg_size) ? rbg_size : rb_bit_end % rbg_size;
+    const uint16_t end_offset = rbg_size - last_rbg_size;
+    uint16_t rb_bitmap_mask_last_rbg = rb_bitmap_mask >> end_offset;
+    if (rbg_bit_begin == rbg_bit_last) {
+        const uint16_t mask = rb_bitmap_mask_1st_rbg & rb_bitmap_mask_last_rbg;
+        rb_bitmap_mask_1st_rbg = mask;
+        rb_bitmap_mask_last_rbg = mask;
+    }
+
+    uint32_t result = 0u;
+    if (nr5g_fapi_rbg_bench_has_rbg_bits(rb_bitmap, rbg_bit_begin, rbg_size,
+            rb_bitmap_mask_1st_rbg))
+        result |= get_rbg_index_mask(rbg_bit_begin);
+    if (nr5g_fapi_rbg_bench_has_rbg_bits(rb_bitmap, rbg_bit_last, rbg_size,
+            rb_bitmap_mask_last_rbg))
+        result |= get_rbg_index_mask(rbg_bit_last);
+    uint8_t rbg_bit;
+    for (rbg_bit = rbg_bit_begin + 1u; rbg_bit < rbg_bit_last; rbg_bit++) {
+        if (nr5g_fapi_rbg_bench_has_rbg_bits(rb_bitmap, rbg_bit, rbg_size,
+                rb_bitmap_mask))
+            result |= get_rbg_index_mask(rbg_bit);
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+static void nr5g_fapi_rbg_bench_usage(
+    const char *prgname)
+{
+    printf("Usage: %s [-n <iterations>]\n"
+        "  -n  number of times each carrier is timed (default 20000)\n",
+        prgname);
+}
+
+static inline uint32_t nr5g_fapi_rbg_bench_rand(
+    nr5g_fapi_rbg_bench_t * p_bench)
+{
+    p_bench->rand = p_bench->rand * 1103515245U + 12345U;
+    return p_bench->rand >> 8;
+}
+
+// Bitmap of kind 0: empty, 1: full, 2: random RBs, 3 and up: random whole
+// RBGs of rbg_size, which is what a scheduler sends
+static void nr5g_fapi_rbg_bench_fill_bitmap(
+    nr5g_fapi_rbg_bench_t * p_bench,
+    uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE],
+    uint32_t kind,
+    uint16_t bwp_start,
+    uint16_t bwp_size)
+{
+    const uint8_t rbg_size = nr5g_fapi_calc_n_rbg_size(bwp_size);
+    uint32_t rb, rbg_bits = 0;
+
+    memset(rb_bitmap, (kind == 1) ? 0xFF : 0, FAPI_RB_BITMAP_SIZE);
+    if (kind == 2) {
+        for (rb = 0; rb < FAPI_RB_BITMAP_SIZE; rb++)
+            rb_bitmap[rb] = (uint8_t) nr5g_fapi_rbg_bench_rand(p_bench);
+    } else if (kind >= 3 && rbg_size) {
+        for (rb = bwp_start; rb < (uint32_t) (bwp_start + bwp_size) &&
+            rb < FAPI_RB_BITMAP_SIZE * CHAR_BIT; rb++) {
+            if (rb == bwp_start || 0 == rb % rbg_size)
+                rbg_bits = nr5g_fapi_rbg_bench_rand(p_bench) & 1;
+            if (rbg_bits)
+                rb_bitmap[rb / CHAR_BIT] |= 1u << (rb % CHAR_BIT);
+        }
+    }
+}
+
+static uint32_t nr5g_fapi_rbg_bench_check(
+    nr5g_fapi_rbg_bench_t * p_bench)
+{
+    uint8_t rb_bitmap[FAPI_RB_BITMAP_SIZE];
+    uint32_t num_errors = 0, num_checks = 0, kind, ref, idx;
+    uint16_t bwp_start, bwp_size;
+    bool msb_first;
+    int stdout_fd;
+
+    // Partial RBGs of the random bitmaps are logged as errors by the
+    // translation, keep them out of the report
+    fflush(stdout);
+    stdout_fd = dup(STDOUT_FILENO);
+    if (!freopen("/dev/null", "w", stdout))
+        return 1;
+
+    for (bwp_start = 0; bwp_start <= NR5G_FAPI_RBG_BENCH_MAX_RB;
+        bwp_start++) {
+        for (bwp_size = 1; bwp_size <= NR5G_FAPI_RBG_BENCH_MAX_RB;
+            bwp_size++) {
+            // the cell table path is taken when the BWP is a carrier
+            p_bench->tables.num_rbg_layouts = 0;
+            if (SUCCESS == nr5g_fapi_build_rbg_layout(
+                    &p_bench->tables.rbg_layout[0], bwp_start, bwp_size))
+                p_bench->tables.num_rbg_layouts = 1;
+
+            for (kind = 0; kind < NR5G_FAPI_RBG_BENCH_NUM_CHECKS; kind++) {
+                nr5g_fapi_rbg_bench_fill_bitmap(p_bench, rb_bitmap, kind,
+                    bwp_start, bwp_size);
+                for (idx = 0; idx < 2; idx++) {
+                    msb_first = (idx == 0);
+                    ref = nr5g_fapi_rbg_bench_calc_rbg_index_ref(rb_bitmap,
+                        bwp_start, bwp_size, msb_first ?
+                        nr5g_fapi_rbg_bench_mask_from_msb :
+                        nr5g_fapi_rbg_bench_mask_from_lsb);
+                    if (ref != nr5g_fapi_calc_rbg_index(&p_bench->tables,
+                            rb_bitmap, bwp_start, bwp_size, msb_first) ||
+                        ref != nr5g_fapi_calc_rbg_index(&p_bench->no_tables,
+                            rb_bitmap, bwp_start, bwp_size, msb_first)) {
+                        if (num_errors++ < 10)
+                            fprintf(stderr, "Error: bwp_start %u "
+                                "bwp_size %u bitmap %u %s: nRBGIndex "
+                                "differs, expected %#x\n",
+                                bwp_start, bwp_size, kind,
+                                msb_first ? "PDSCH" : "PUSCH", ref);
+                    }
+                    num_checks++;
+                }
+            }
+        }
+    }
+    fflush(stdout);
+    dup2(stdout_fd, STDOUT_FILENO);
+    close(stdout_fd);
+    printf("%u nRBGIndex checked, %u differ\n\n", num_checks, num_errors);
+
+    return num_errors;
+}
+
+static void nr5g_fapi_rbg_bench_print(
+    const char *name,
+    uint16_t n_rb,
+    uint64_t ticks,
+    uint32_t num_iter,
+    uint64_t tsc_hz)
+{
+    double ns = (double)ticks * 1000000000.0 / tsc_hz / num_iter /
+        NR5G_FAPI_RBG_BENCH_NUM_BITMAPS;
+
+    printf("%-20s %8u %12.1f\n", name, n_rb, ns);
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    nr5g_fapi_rbg_bench_t *p_bench = &nr5g_fapi_rbg_bench;
+    uint32_t num_iter = 20000, iter, idx, carrier;
+    uint64_t start_tick, tsc_hz, ticks;
+    uint16_t n_rb;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                num_iter = (uint32_t) atoi(optarg);
+                break;
+            default:
+                nr5g_fapi_rbg_bench_usage(argv[0]);
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if (!num_iter) {
+        nr5g_fapi_rbg_bench_usage(argv[0]);
+        return 1;
+    }
+
+    p_bench->rand = 1;
+    if (nr5g_fapi_rbg_bench_check(p_bench)) {
+        printf("Error: cell table RBG mapping differs from the reference\n");
+        return 1;
+    }
+
+    start_tick = __rdtsc();
+    usleep(100000);
+    tsc_hz = (__rdtsc() - start_tick) * 10;
+
+    printf("%u allocations per carrier, %u iterations\n\n",
+        NR5G_FAPI_RBG_BENCH_NUM_BITMAPS, num_iter);
+    printf("%-20s %8s %12s\n", "nRBGIndex", "N_RB", "ns/PDU");
+
+    for (carrier = 0; carrier < sizeof(nr5g_fapi_rbg_bench_n_rb) /
+        sizeof(nr5g_fapi_rbg_bench_n_rb[0]); carrier++) {
+        n_rb = nr5g_fapi_rbg_bench_n_rb[carrier];
+        for (idx = 0; idx < NR5G_FAPI_RBG_BENCH_NUM_BITMAPS; idx++)
+            nr5g_fapi_rbg_bench_fill_bitmap(p_bench, p_bench->rb_bitmap[idx],
+                3, 0, n_rb);
+        p_bench->tables.num_rbg_layouts = 0;
+        nr5g_fapi_build_rbg_layout(&p_bench->tables.rbg_layout[0], 0, n_rb);
+        p_bench->tables.num_rbg_layouts = 1;
+
+        start_tick = __rdtsc();
+        for (iter = 0; iter < num_iter; iter++) {
+            for (idx = 0; idx < NR5G_FAPI_RBG_BENCH_NUM_BITMAPS; idx++)
+                p_bench->rbg_index[idx] =
+                    nr5g_fapi_rbg_bench_calc_rbg_index_ref(
+                    p_bench->rb_bitmap[idx], 0, n_rb, (idx & 1) ?
+                    nr5g_fapi_rbg_bench_mask_from_lsb :
+                    nr5g_fapi_rbg_bench_mask_from_msb);
+            __asm__ volatile ("" : : "r" (p_bench->rbg_index) : "memory");
+        }
+        ticks = __rdtsc() - start_tick;
+        nr5g_fapi_rbg_bench_print("per RBG (old)", n_rb, ticks, num_iter,
+            tsc_hz);
+
+        start_tick = __rdtsc();
+        for (iter = 0; iter < num_iter; iter++) {
+            for (idx = 0; idx < NR5G_FAPI_RBG_BENCH_NUM_BITMAPS; idx++)
+                p_bench->rbg_index[idx] =
+                    nr5g_fapi_calc_rbg_index(&p_bench->tables,
+                    p_bench->rb_bitmap[idx], 0, n_rb, !(idx & 1));
+            __asm__ volatile ("" : : "r" (p_bench->rbg_index) : "memory");
+        }
+        ticks = __rdtsc() - start_tick;
+        nr5g_fapi_rbg_bench_print("cell table", n_rb, ticks, num_iter,
+            tsc_hz);
+
+        start_tick = __rdtsc();
+        for (iter = 0; iter < num_iter; iter++) {
+            for (idx = 0; idx < NR5G_FAPI_RBG_BENCH_NUM_BITMAPS; idx++)
+                p_bench->rbg_index[idx] =
+                    nr5g_fapi_calc_rbg_index(&p_bench->no_tables,
+                    p_bench->rb_bitmap[idx], 0, n_rb, !(idx & 1));
+            __asm__ volatile ("" : : "r" (p_bench->rbg_index) : "memory");
+        }
+        ticks = __rdtsc() - start_tick;
+        nr5g_fapi_rbg_bench_print("no cell table", n_rb, ticks, num_iter,
+            tsc_hz);
+    }
+
+    return 0;
+}
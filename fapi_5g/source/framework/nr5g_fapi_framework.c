@@ -21,10 +21,21 @@
 #include "nr5g_fapi_fapi2phy_wls.h"
 #include "nr5g_fapi_fapi2phy_api.h"
 #include "rte_memzone.h"
+#include <immintrin.h>
 #include "nr5g_fapi_memory.h"
+#include "nr5g_fapi_recorder.h"
 
 static nr5g_fapi_phy_ctx_t nr5g_fapi_phy_ctx;
 
+// L2 owns the MAC2PHY blocks and frees them TO_FREE_SIZE sends after it
+// sent them, so a queued URLLC MAC2PHY list has to be processed before L2
+// sends that many more blocks. One block is kept as a margin for the ones
+// L2 sent but FAPI has not received yet.
+#define NR5G_FAPI_URLLC_MAC2PHY_MAX_AGE     ( TO_FREE_SIZE - 1 )
+#if (NR5G_FAPI_URLLC_MAC2PHY_MAX_AGE < 1)
+#error "TO_FREE_SIZE too small for the URLLC MAC2PHY mailbox"
+#endif
+
 inline p_nr5g_fapi_phy_ctx_t nr5g_fapi_get_nr5g_fapi_phy_ctx(
     )
 {
@@ -76,6 +87,7 @@ uint8_t nr5g_fapi_dpdk_init(
 uint8_t nr5g_fapi_dpdk_wait(
     p_nr5g_fapi_cfg_t p_cfg)
 {
+    uint8_t i;
 #if 0
     uint32_t worker_core;
     /* wait per-lcore */
@@ -87,9 +99,14 @@ uint8_t nr5g_fapi_dpdk_wait(
 #else
     pthread_join(p_cfg->mac2phy_thread_params.thread_info.thread_id, NULL);
     pthread_join(p_cfg->phy2mac_thread_params.thread_info.thread_id, NULL);
+    for (i = 0; i < p_cfg->num_mac2phy_workers; i++) {
+        pthread_join(p_cfg->mac2phy_worker_thread_params[i].thread_info.
+            thread_id, NULL);
+    }
     pthread_join(p_cfg->urllc_phy2mac_thread_params.thread_info.thread_id, NULL);
     pthread_join(p_cfg->urllc_mac2phy_thread_params.thread_info.thread_id, NULL);
 #endif
+    nr5g_fapi_recorder_close();
     return SUCCESS;
 }
 
@@ -157,22 +174,23 @@ uint8_t nr5g_fapi_prepare_thread(
     return SUCCESS;
 }
 
-uint8_t nr5g_fapi_initialise_sempahore(
-    nr5g_fapi_urllc_thread_params_t* urllc_thread_params)
+uint8_t nr5g_fapi_urllc_queue_init(
+    nr5g_fapi_urllc_thread_params_t* urllc_thread_params,
+    uint32_t wait_mode,
+    uint32_t spin_count,
+    uint32_t max_age)
 {
-    memset(&urllc_thread_params->urllc_sem_process, 0, sizeof(sem_t));
-    memset(&urllc_thread_params->urllc_sem_done, 0, sizeof(sem_t));
-     
-    pthread_mutex_init(&urllc_thread_params->lock, NULL);
-    urllc_thread_params->p_urllc_list_elem = NULL;
-    if (0 != sem_init(&urllc_thread_params->urllc_sem_process, 0, 0)) {
-        printf("Error: Unable to init urllc_sem_process semaphore\n");
-        return FAILURE;
-    }
-    if (0 != sem_init(&urllc_thread_params->urllc_sem_done, 0, 1)) {
-        printf("Error: Unable to init urllc_sem_done semaphore\n");
+    NR5G_FAPI_MEMSET(urllc_thread_params,
+        sizeof(nr5g_fapi_urllc_thread_params_t), 0,
+        sizeof(nr5g_fapi_urllc_thread_params_t));
+    if (wait_mode > NR5G_FAPI_URLLC_WAIT_ADAPTIVE) {
+        printf("Error: Invalid URLLC wait mode %u\n", wait_mode);
         return FAILURE;
     }
+    urllc_thread_params->wait_mode = wait_mode;
+    urllc_thread_params->spin_count = spin_count;
+    urllc_thread_params->max_age = max_age;
+    urllc_thread_params->stats.min_latency = UINT64_MAX;
 
     return SUCCESS;
 }
@@ -189,34 +207,154 @@ void nr5g_fapi_init_thread(uint8_t worker_core_id)
     usleep(1000);  
 }
 
-void nr5g_fapi_urllc_thread_callback(
+// Producer side of the URLLC mailbox, never blocks. A full queue means the
+// URLLC worker is more than NR5G_FAPI_URLLC_QUEUE_SIZE lists behind, the
+// list is not queued and counted. On FAILURE the list is still owned by the
+// caller, which has to free it.
+uint8_t nr5g_fapi_urllc_thread_callback(
     void *p_list_elem,
     nr5g_fapi_urllc_thread_params_t* urllc_params)
 {
+    uint32_t head, tail;
+    nr5g_fapi_urllc_queue_entry_t *p_entry;
+
     if (nr5g_fapi_get_nr5g_fapi_phy_ctx()->is_urllc_enabled){
-        sem_wait(&urllc_params->urllc_sem_done);
-        pthread_mutex_lock(&urllc_params->lock);
-        urllc_params->p_urllc_list_elem = p_list_elem;
-        pthread_mutex_unlock(&urllc_params->lock);
-        sem_post(&urllc_params->urllc_sem_process);
+        head = urllc_params->head;
+        tail = __atomic_load_n(&urllc_params->tail, __ATOMIC_ACQUIRE);
+        if ((head - tail) >= NR5G_FAPI_URLLC_QUEUE_SIZE) {
+            urllc_params->num_queue_full++;
+            NR5G_FAPI_LOG(ERROR_LOG, ("[URLLC] Queue full, list dropped "
+                    "(%lu)", urllc_params->num_queue_full));
+            return FAILURE;
+        }
+        p_entry = &urllc_params->entry[head & NR5G_FAPI_URLLC_QUEUE_MASK];
+        p_entry->p_list_elem = p_list_elem;
+        p_entry->enq_tick = __rdtsc();
+        p_entry->generation = urllc_params->generation;
+        __atomic_store_n(&urllc_params->head, head + 1, __ATOMIC_RELEASE);
+        return SUCCESS;
     }
     else {
         NR5G_FAPI_LOG(ERROR_LOG, ("[URLLC] Threads are not running"));
+        return FAILURE;
+    }
+}
+
+// Consumer side of the URLLC mailbox. Returns the oldest queued list, or
+// NULL once process_exit is set. Waits by polling the head index, in
+// adaptive mode the worker sleeps between polls after spin_count misses.
+// A list queued max_age or more generations ago may already be freed by
+// its owner, it is counted and skipped without being read.
+void *nr5g_fapi_urllc_queue_wait(
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx,
+    nr5g_fapi_urllc_thread_params_t* urllc_params)
+{
+    uint32_t head, tail = urllc_params->tail, depth, num_spin = 0, age;
+    uint64_t latency;
+    void *p_list_elem;
+    nr5g_fapi_urllc_queue_entry_t *p_entry;
+    nr5g_fapi_urllc_queue_stats_t *p_stats = &urllc_params->stats;
+
+    for (;;) {
+        while ((head = __atomic_load_n(&urllc_params->head,
+                    __ATOMIC_ACQUIRE)) == tail) {
+            if (p_phy_ctx->process_exit)
+                return NULL;
+            if (urllc_params->wait_mode == NR5G_FAPI_URLLC_WAIT_ADAPTIVE &&
+                ++num_spin >= urllc_params->spin_count) {
+                usleep(1);
+            } else {
+                _mm_pause();
+            }
+        }
+
+        p_entry = &urllc_params->entry[tail & NR5G_FAPI_URLLC_QUEUE_MASK];
+        p_list_elem = p_entry->p_list_elem;
+        latency = __rdtsc() - p_entry->enq_tick;
+        age = __atomic_load_n(&urllc_params->generation, __ATOMIC_ACQUIRE) -
+            p_entry->generation;
+        __atomic_store_n(&urllc_params->tail, tail + 1, __ATOMIC_RELEASE);
+
+        if (!urllc_params->max_age || age < urllc_params->max_age)
+            break;
+        p_stats->num_stale++;
+        NR5G_FAPI_LOG(ERROR_LOG, ("[URLLC] List %u blocks old, skipped "
+                "(%lu)", age, p_stats->num_stale));
+        tail++;
     }
+
+    depth = head - tail;
+    p_stats->num_handoffs++;
+    p_stats->total_latency += latency;
+    if (latency < p_stats->min_latency)
+        p_stats->min_latency = latency;
+    if (latency > p_stats->max_latency)
+        p_stats->max_latency = latency;
+    if (depth > p_stats->max_depth)
+        p_stats->max_depth = depth;
+
+    return p_list_elem;
+}
+
+static void nr5g_fapi_urllc_print_queue_stats(
+    const char *name,
+    nr5g_fapi_urllc_thread_params_t* urllc_params)
+{
+    nr5g_fapi_urllc_queue_stats_t *p_stats = &urllc_params->stats;
+
+    if (!p_stats->num_handoffs) {
+        printf("        %s handoffs[%5d] queue full[%5lu] stale[%5lu]\n",
+            name, 0, urllc_params->num_queue_full, p_stats->num_stale);
+        return;
+    }
+    printf("        %s handoffs[%5lu] queue full[%5lu] stale[%5lu] max depth"
+        "[%2u] latency Kcycle (min, max, avg) %9.2f %9.2f %9.2f\n", name,
+        p_stats->num_handoffs, urllc_params->num_queue_full,
+        p_stats->num_stale, p_stats->max_depth, p_stats->min_latency / 1000.,
+        p_stats->max_latency / 1000.,
+        p_stats->total_latency / p_stats->num_handoffs / 1000.);
+}
+
+void nr5g_fapi_urllc_print_stats(
+    )
+{
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx = nr5g_fapi_get_nr5g_fapi_phy_ctx();
+
+    if (!p_phy_ctx->is_urllc_enabled)
+        return;
+
+    nr5g_fapi_urllc_print_queue_stats("URLLC MAC2PHY",
+        &p_phy_ctx->urllc_mac2phy_params);
+    nr5g_fapi_urllc_print_queue_stats("URLLC PHY2MAC",
+        &p_phy_ctx->urllc_phy2mac_params);
 }
 
 uint8_t nr5g_fapi_framework_init(
     p_nr5g_fapi_cfg_t p_cfg)
 {
     p_nr5g_fapi_phy_ctx_t p_phy_ctx = nr5g_fapi_get_nr5g_fapi_phy_ctx();
+    uint8_t i;
 
     nr5g_fapi_set_log_level(p_cfg->logger.level);
+    if (p_cfg->logger.async &&
+        (FAILURE == nr5g_fapi_log_async_start(p_cfg->logger.core_id))) {
+        return FAILURE;
+    }
     // Set up WLS
     if (FAILURE == nr5g_fapi_wls_init(p_cfg)) {
         NR5G_FAPI_LOG(ERROR_LOG, ("[FAPI_INT] WLS init Failed"));
         return FAILURE;
     }
     NR5G_FAPI_LOG(INFO_LOG, ("[FAPI_INT] WLS init Successful"));
+    nr5g_fapi_fapi2phy_rx_data_zbc_init(p_cfg->wls.rx_data_zbc,
+        p_cfg->wls.rx_data_zbc_timeout);
+
+    if (p_cfg->recorder.file_name[0] &&
+        (FAILURE == nr5g_fapi_recorder_open(p_cfg->recorder.file_name,
+                p_cfg->recorder.max_size_mb))) {
+        NR5G_FAPI_LOG(ERROR_LOG, ("[FAPI_INT] Recorder open Failed"));
+        return FAILURE;
+    }
 
     p_phy_ctx->phy2mac_worker_core_id = p_cfg->phy2mac_thread_params.thread_worker.core_id;
     p_phy_ctx->mac2phy_worker_core_id = p_cfg->mac2phy_thread_params.thread_worker.core_id;
@@ -231,6 +369,17 @@ uint8_t nr5g_fapi_framework_init(
     }
 
 
+    p_phy_ctx->mac2phy_pool.num_workers = p_cfg->num_mac2phy_workers;
+    for (i = 0; i < p_cfg->num_mac2phy_workers; i++) {
+        p_phy_ctx->mac2phy_pool.worker[i].core_id =
+            p_cfg->mac2phy_worker_thread_params[i].thread_worker.core_id;
+        if (nr5g_fapi_prepare_thread(&p_cfg->mac2phy_worker_thread_params[i],
+                                     "nr5g_fapi_mac2phy_worker",
+                                     nr5g_fapi_mac2phy_worker_thread_func) == FAILURE) {
+            return FAILURE;
+        }
+    }
+
     if (nr5g_fapi_prepare_thread(&p_cfg->mac2phy_thread_params,
                                  "nr5g_fapi_mac2phy_thread",
                                  nr5g_fapi_mac2phy_thread_func) == FAILURE) {
@@ -239,11 +388,16 @@ uint8_t nr5g_fapi_framework_init(
 
     if (p_cfg->is_urllc_enabled)
     {
-        if (nr5g_fapi_initialise_sempahore(&p_phy_ctx->urllc_phy2mac_params) == FAILURE) {
+        // PHY2MAC lists are freed by FAPI once the URLLC worker is done
+        if (nr5g_fapi_urllc_queue_init(&p_phy_ctx->urllc_phy2mac_params,
+                p_cfg->urllc_wait_mode, p_cfg->urllc_spin_count, 0) ==
+            FAILURE) {
             return FAILURE;
     }
 
-        if (nr5g_fapi_initialise_sempahore(&p_phy_ctx->urllc_mac2phy_params) == FAILURE) {
+        if (nr5g_fapi_urllc_queue_init(&p_phy_ctx->urllc_mac2phy_params,
+                p_cfg->urllc_wait_mode, p_cfg->urllc_spin_count,
+                NR5G_FAPI_URLLC_MAC2PHY_MAX_AGE) == FAILURE) {
         return FAILURE;
     }
 
@@ -271,10 +425,82 @@ void nr5g_fapi_clean(
     p_phy_instance->phy_config.phy_cell_id = 0;
     p_phy_instance->phy_config.sub_c_common = 0;
     p_phy_instance->phy_config.use_vendor_EpreXSSB = 0;
+    p_phy_instance->cell_tables.num_rbg_layouts = 0;
     p_phy_instance->shutdown_test_type = 0; 
     p_phy_instance->phy_id = 0;
     p_phy_instance->state = FAPI_STATE_IDLE ;
     
     memset(p_phy_instance->ul_slot_info, 0, sizeof(nr5g_fapi_ul_slot_info_t));
     wls_fapi_free_send_free_list_urllc();
-}
\ No newline at end of file
+}
+void nr5g_fapi_mac2phy_demux_init(
+    p_nr5g_fapi_mac2phy_demux_t p_demux)
+{
+    NR5G_FAPI_MEMSET(p_demux, sizeof(nr5g_fapi_mac2phy_demux_t), 0,
+        sizeof(nr5g_fapi_mac2phy_demux_t));
+    p_demux->curr_phy_id = NR5G_FAPI_DEMUX_NO_PHY;
+}
+
+// Add one received element to the per PHY lists. A message header only
+// selects the PHY instance of the APIs that follow it and is not forwarded.
+// A PHY instance that shows up twice in one block gets one merged list.
+// A header without APIs is skipped on its own, the APIs of an invalid PHY
+// instance are dropped up to the next header.
+void nr5g_fapi_mac2phy_demux_add(
+    p_nr5g_fapi_mac2phy_demux_t p_demux,
+    p_fapi_api_queue_elem_t p_elem)
+{
+    p_fapi_msg_header_t p_fapi_msg_header = NULL;
+    uint8_t phy_id;
+
+    if (FAPI_VENDOR_MSG_HEADER_IND == p_elem->msg_type) {
+        p_fapi_msg_header = (p_fapi_msg_header_t) (p_elem + 1);
+        phy_id = p_fapi_msg_header->handle;
+
+        if (phy_id >= FAPI_MAX_PHY_INSTANCES) {
+            NR5G_FAPI_LOG(ERROR_LOG, ("[MAC2PHY]: Invalid Phy Id: %d\n",
+                    phy_id));
+            p_demux->curr_phy_id = NR5G_FAPI_DEMUX_NO_PHY;
+            return;
+        }
+        if (0 == p_fapi_msg_header->num_msg) {
+            NR5G_FAPI_LOG(TRACE_LOG, ("\n[MAC2PHY] No APIs for PHY_ID: %d."
+                    " Skip...\n", phy_id));
+            return;
+        }
+        NR5G_FAPI_LOG(TRACE_LOG, ("\n[MAC2PHY] PHY_ID: %d NUM APIs: %d\n",
+                phy_id, p_fapi_msg_header->num_msg));
+
+        if (!(p_demux->phy_mask & (1U << phy_id))) {
+            p_demux->phy_mask |= (1U << phy_id);
+            p_demux->phy_order[p_demux->num_phy++] = phy_id;
+        }
+        p_demux->curr_phy_id = phy_id;
+        return;
+    }
+
+    if (NR5G_FAPI_DEMUX_NO_PHY == p_demux->curr_phy_id) {
+        p_demux->num_dropped++;
+        return;
+    }
+    nr5g_fapi_api_list_append(&p_demux->phy_api_list[p_demux->curr_phy_id],
+        p_elem);
+}
+
+// Split an already linked list of received elements in one pass
+uint32_t nr5g_fapi_mac2phy_demux_list(
+    p_nr5g_fapi_mac2phy_demux_t p_demux,
+    p_fapi_api_queue_elem_t p_msg_list)
+{
+    p_fapi_api_queue_elem_t p_next_elm = NULL;
+    uint32_t num_elms = 0;
+
+    while (p_msg_list) {
+        p_next_elm = p_msg_list->p_next;
+        nr5g_fapi_mac2phy_demux_add(p_demux, p_msg_list);
+        p_msg_list = p_next_elm;
+        num_elms++;
+    }
+
+    return num_elms;
+}
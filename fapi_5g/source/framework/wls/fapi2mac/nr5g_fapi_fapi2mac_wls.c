@@ -27,6 +27,7 @@
 #include "nr5g_fapi_fapi2mac_wls.h"
 #include "nr5g_fapi_log.h"
 #include "nr5g_fapi_framework.h"
+#include "nr5g_fapi_recorder.h"
 
 static p_fapi_api_queue_elem_t p_fapi2mac_buffers;
 
@@ -399,35 +400,42 @@ uint8_t nr5g_fapi_fapi2mac_wls_send(
 //------------------------------------------------------------------------------
 /** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
  *
- *  @param[out]   data Location where First API from L1 is stored
+ *  @param[out]   p_demux Per PHY instance lists of the received APIs
  *
- *  @return  Size of Message sent from L1
+ *  @return  Number of non URLLC elements received
  *
  *  @description
- *  This function queries the APIs sent from L1 to L2 and gets the first pointer
- *  to the linked list
+ *  This function queries the APIs sent from L2 to L1. Non URLLC APIs are
+ *  split per PHY instance into p_demux as they are received, URLLC APIs are
+ *  appended to a tail tracked list handed over to the URLLC thread.
  *
 **/
 //------------------------------------------------------------------------------
-p_fapi_api_queue_elem_t nr5g_fapi_fapi2mac_wls_recv(
-    )
+uint32_t nr5g_fapi_fapi2mac_wls_recv(
+    p_nr5g_fapi_mac2phy_demux_t p_demux)
 {
     uint16_t msg_type = 0;
     uint16_t flags = 0;
     uint32_t msg_size = 0;
     uint32_t num_elms = 0;
+    uint32_t num_recv = 0;
     uint64_t *p_msg = NULL;
-    p_fapi_api_queue_elem_t p_qelm_list = NULL, p_urllc_qelm_list = NULL;
+    nr5g_fapi_api_list_t urllc_list = { NULL, NULL, 0 };
     p_fapi_api_queue_elem_t p_qelm = NULL;
-    p_fapi_api_queue_elem_t p_tail_qelm = NULL, p_urllc_tail_qelm = NULL;
     WLS_HANDLE h_wls = nr5g_fapi_fapi2mac_wls_instance();
     uint64_t start_tick = 0;
 
     num_elms = nr5g_fapi_fapi2mac_wls_wait();
     if (!num_elms)
-        return p_qelm_list;
+        return num_recv;
 
     start_tick = __rdtsc();
+    // URLLC lists still queued age by one L2 block
+    nr5g_fapi_urllc_queue_tick(
+        &nr5g_fapi_get_nr5g_fapi_phy_ctx()->urllc_mac2phy_params);
+    nr5g_fapi_mac2phy_demux_init(p_demux);
+    if (nr5g_fapi_recorder_active_g)
+        nr5g_fapi_recorder_block_begin(NR5G_FAPI_REC_MAC2PHY);
     do {
         p_msg = nr5g_fapi_fapi2mac_wls_get(&msg_size, &msg_type, &flags);
         if (p_msg) {
@@ -437,40 +445,27 @@ p_fapi_api_queue_elem_t nr5g_fapi_fapi2mac_wls_recv(
                 printf("Error: Invalid Ptr\n");
                 continue;
             }
-            p_qelm->p_next = NULL;
-            
-            if (flags & WLS_TF_URLLC)
-            {
-                if (p_urllc_qelm_list) {
-                    p_urllc_tail_qelm = p_urllc_qelm_list;
-                    while (NULL != p_urllc_tail_qelm->p_next) {
-                        p_urllc_tail_qelm = p_urllc_tail_qelm->p_next;
-                    }
-                    p_urllc_tail_qelm->p_next = p_qelm;
-                } else {
-                    p_urllc_qelm_list = p_qelm;
-                }
-            } else {
-            if (p_qelm_list) {
-                p_tail_qelm = p_qelm_list;
-                while (NULL != p_tail_qelm->p_next) {
-                    p_tail_qelm = p_tail_qelm->p_next;
-                }
-                p_tail_qelm->p_next = p_qelm;
+            if (nr5g_fapi_recorder_active_g)
+                nr5g_fapi_recorder_mac2phy_elem(p_qelm, flags);
+
+            if (flags & WLS_TF_URLLC) {
+                nr5g_fapi_api_list_append(&urllc_list, p_qelm);
             } else {
-                p_qelm_list = p_qelm;
+                nr5g_fapi_mac2phy_demux_add(p_demux, p_qelm);
+                num_recv++;
             }
         }
-        }
         num_elms--;
     } while (num_elms && is_msg_present(flags));
+    if (nr5g_fapi_recorder_active_g)
+        nr5g_fapi_recorder_block_end(NR5G_FAPI_REC_MAC2PHY);
 
-    if (p_urllc_qelm_list) {
-        nr5g_fapi_urllc_thread_callback((void *) p_urllc_qelm_list,
+    if (urllc_list.p_head) {
+        nr5g_fapi_urllc_thread_callback((void *) urllc_list.p_head,
                &nr5g_fapi_get_nr5g_fapi_phy_ctx()->urllc_mac2phy_params);
     }
 
     tick_total_wls_get_per_tti_dl += __rdtsc() - start_tick;
 
-    return p_qelm_list;
+    return num_recv;
 }
@@ -27,6 +27,7 @@
 
 #include "fapi_interface.h"
 #include "fapi_vendor_extension.h"
+#include "nr5g_fapi_framework.h"
 
 uint8_t nr5g_fapi_fapi2mac_is_valid_wls_ptr(
     void *data);
@@ -35,8 +36,8 @@ uint8_t nr5g_fapi_fapi2mac_wls_send(
     p_fapi_api_queue_elem_t p_list_elem,
     bool is_urllc);
 
-p_fapi_api_queue_elem_t nr5g_fapi_fapi2mac_wls_recv(
-    );
+uint32_t nr5g_fapi_fapi2mac_wls_recv(
+    p_nr5g_fapi_mac2phy_demux_t p_demux);
 
 uint32_t nr5g_fapi_fapi2mac_wls_wait(
     );
@@ -29,6 +29,7 @@
 #include "nr5g_fapi_fapi2phy_wls.h"
 #include "nr5g_fapi_log.h"
 #include "nr5g_fapi_framework.h"
+#include "nr5g_fapi_recorder.h"
 
 static uint32_t g_to_free_send_list_cnt[TO_FREE_SIZE] = { 0 };
 static uint64_t g_to_free_send_list[TO_FREE_SIZE][TOTAL_FREE_BLOCKS] = { {0L} };
@@ -37,21 +38,83 @@ static uint64_t g_to_free_recv_list[TO_FREE_SIZE][TOTAL_FREE_BLOCKS] = { {0L} };
 
 static uint32_t g_to_free_send_list_cnt_urllc[TO_FREE_SIZE_URLLC] = { 0 };
 static uint64_t g_to_free_send_list_urllc[TO_FREE_SIZE_URLLC][TOTAL_FREE_BLOCKS] = { {0L} };
+static uint32_t g_to_free_recv_list_cnt_urllc[TO_FREE_SIZE_URLLC] = { 0 };
+static uint64_t g_to_free_recv_list_urllc[TO_FREE_SIZE_URLLC][TOTAL_FREE_BLOCKS] = { {0L} };
 
 static uint32_t g_free_recv_idx = 0;
 static uint32_t g_free_send_idx = 0;
 static uint32_t g_free_send_idx_urllc = 0;
+static uint32_t g_free_recv_idx_urllc = 0;
+
+// RX_DATA.indication payloads handed to L2 without a timed free
+#define NR5G_FAPI_RX_DATA_ZBC_MAX_BUFS      ( TO_FREE_SIZE * TOTAL_FREE_BLOCKS )
+#define NR5G_FAPI_RX_DATA_ZBC_HASH_BITS     ( 15 )  // > 2 buckets per buffer
+#define NR5G_FAPI_RX_DATA_ZBC_HASH_SIZE     ( 1u << NR5G_FAPI_RX_DATA_ZBC_HASH_BITS )
+#define NR5G_FAPI_RX_DATA_ZBC_NIL           ( UINT32_MAX )
+
+typedef struct _nr5g_fapi_rx_data_zbc_buf {
+    uint64_t pdu_data;          // pPayload as reported to L2 in pduData
+    void *p_block;              // block returned to the L1 pool
+    uint32_t ref_cnt;           // RX_DATA.indication PDUs not yet released
+    uint32_t expiry;            // recv_cnt at which the block is reclaimed
+    uint32_t hash_next;         // next buffer of the bucket or of the free list
+    uint32_t prev;              // neighbours in the expiry queue
+    uint32_t next;
+    bool is_urllc;              // held when the URLLC list was received
+} nr5g_fapi_rx_data_zbc_buf_t;
+
+// Buffers in expiry order, the expiry of a queue is recv_cnt plus a constant
+typedef struct _nr5g_fapi_rx_data_zbc_queue {
+    uint32_t head;
+    uint32_t tail;
+} nr5g_fapi_rx_data_zbc_queue_t;
+
+typedef struct _nr5g_fapi_rx_data_zbc {
+    bool enabled;
+    uint32_t timeout;
+    uint32_t recv_cnt;          // lists received from L1
+    uint32_t num_bufs;
+    uint32_t free_head;
+    nr5g_fapi_rx_data_zbc_queue_t held;         // not referenced yet
+    nr5g_fapi_rx_data_zbc_queue_t held_urllc;   // URLLC, not referenced yet
+    nr5g_fapi_rx_data_zbc_queue_t delivered;    // referenced by L2
+    pthread_mutex_t lock;       // held from the PHY2MAC and URLLC threads,
+                                // released from the MAC2PHY thread
+    nr5g_fapi_rx_data_zbc_stats_t stats;
+    uint32_t hash[NR5G_FAPI_RX_DATA_ZBC_HASH_SIZE];
+    nr5g_fapi_rx_data_zbc_buf_t bufs[NR5G_FAPI_RX_DATA_ZBC_MAX_BUFS];
+} nr5g_fapi_rx_data_zbc_t;
+
+static nr5g_fapi_rx_data_zbc_t g_rx_data_zbc = {
+    .lock = PTHREAD_MUTEX_INITIALIZER
+};
 
 uint64_t *nr5g_fapi_fapi2phy_wls_get(
     uint32_t * const msg_size,
     uint16_t * const msg_type,
     uint16_t * const flags);
 
-uint8_t nr5g_fapi_fapi2phy_wls_put(
-    uint64_t p_msg,
-    uint32_t msg_size,
-    uint16_t msg_type,
-    uint16_t flags);
+// One WLS_Put of a list sent to L1
+typedef struct _nr5g_fapi_fapi2phy_put {
+    uint64_t pa;
+    uint32_t msg_size;
+    uint16_t msg_type;
+    uint16_t flags;
+} nr5g_fapi_fapi2phy_put_t;
+
+#define NR5G_FAPI_FAPI2PHY_MAX_PUTS         ( TOTAL_FREE_BLOCKS )
+// TSC ticks a sender waits for its turn before reporting the stall
+#define NR5G_FAPI_FAPI2PHY_PUT_STALL_TICKS  ( 10000000ULL )
+
+typedef struct _nr5g_fapi_fapi2phy_put_list {
+    uint32_t num_puts;
+    nr5g_fapi_fapi2phy_put_t puts[NR5G_FAPI_FAPI2PHY_MAX_PUTS];
+} nr5g_fapi_fapi2phy_put_list_t;
+
+// One put list per sender, indexed by is_urllc: the MAC2PHY thread sends
+// the regular lists and the URLLC MAC2PHY thread the URLLC ones. Too large
+// for the stack of the real time threads.
+static nr5g_fapi_fapi2phy_put_list_t g_put_list[2];
 
 //------------------------------------------------------------------------------
 /** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
@@ -133,30 +196,108 @@ inline uint64_t *nr5g_fapi_fapi2phy_wls_get(
 //----------------------------------------------------------------------------------
 /** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
  *
- *  @param[in]   p_msg Pointer to API block that needs to be sent to L1
+ *  @param[out]  p_list List of blocks to be sent to L1
+ *  @param[in]   pa Physical address of the block
  *  @param[in]   msg_size Size of Message
- *  @param[in]   msg_id Message Id
+ *  @param[in]   msg_type Message Id
  *  @param[in]   flags Special flags needed for WLS
  *
  *  @return  0 if SUCCESS
  *
  *  @description
  *  This function adds a block of API from L2 to L1 which will be sent later
+ *  by nr5g_fapi_fapi2phy_wls_publish
  *
 **/
 //----------------------------------------------------------------------------------
-inline uint8_t nr5g_fapi_fapi2phy_wls_put(
-    uint64_t p_msg,
+static inline uint8_t nr5g_fapi_fapi2phy_put_list_add(
+    nr5g_fapi_fapi2phy_put_list_t * p_list,
+    uint64_t pa,
     uint32_t msg_size,
     uint16_t msg_type,
     uint16_t flags)
 {
-    int ret = SUCCESS;
+    nr5g_fapi_fapi2phy_put_t *p_put;
+
+    if (p_list->num_puts >= NR5G_FAPI_FAPI2PHY_MAX_PUTS) {
+        NR5G_FAPI_LOG(ERROR_LOG, ("[FAPI2PHY WLS] More than %u blocks in "
+                "list", NR5G_FAPI_FAPI2PHY_MAX_PUTS));
+        return FAILURE;
+    }
+    p_put = &p_list->puts[p_list->num_puts++];
+    p_put->pa = pa;
+    p_put->msg_size = msg_size;
+    p_put->msg_type = msg_type;
+    p_put->flags = flags;
+
+    return SUCCESS;
+}
+
+//----------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param[in]   p_list List of blocks to be sent to L1
+ *
+ *  @return  0 if SUCCESS
+ *
+ *  @description
+ *  This function puts a prepared list into the WLS queue to L1. The blocks of
+ *  one list have to be put back to back, so each sender takes a ticket with a
+ *  fetch-add, waits for the senders ahead of it to commit and commits once its
+ *  whole list is put. Only the puts themselves are ordered, the list is built
+ *  and the free lists are updated outside of the ordered section. A sender
+ *  waiting for its turn gives up once process_exit is set, and reports a
+ *  sender ahead of it that does not commit within
+ *  NR5G_FAPI_FAPI2PHY_PUT_STALL_TICKS.
+ *
+**/
+//----------------------------------------------------------------------------------
+static uint8_t nr5g_fapi_fapi2phy_wls_publish(
+    const nr5g_fapi_fapi2phy_put_list_t * p_list)
+{
+    p_nr5g_fapi_wls_context_t p_wls_ctx = nr5g_fapi_wls_context();
     WLS_HANDLE h_phy_wls = nr5g_fapi_fapi2phy_wls_instance();
-    uint64_t pa = nr5g_fapi_wls_va_to_pa(h_phy_wls, (void *)p_msg);
-    NR5G_FAPI_LOG(TRACE_LOG, ("[FAPI2PHY WLS][PUT] %ld size: %d "
-            "type: %x flags: %x", pa, msg_size, msg_type, flags));
-    ret = WLS_Put(h_phy_wls, pa, msg_size, msg_type, flags);
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx = nr5g_fapi_get_nr5g_fapi_phy_ctx();
+    const nr5g_fapi_fapi2phy_put_t *p_put;
+    uint64_t start_tick = 0;
+    uint8_t ret = SUCCESS;
+    uint32_t ticket, idx;
+
+    ticket = __atomic_fetch_add(&p_wls_ctx->fapi2phy_put_reserve, 1,
+        __ATOMIC_RELAXED);
+    while (__atomic_load_n(&p_wls_ctx->fapi2phy_put_commit,
+            __ATOMIC_ACQUIRE) != ticket) {
+        // the senders ahead stop committing on exit, so give up as well
+        if (p_phy_ctx->process_exit)
+            return FAILURE;
+        if (!start_tick) {
+            start_tick = __rdtsc();
+        } else if (start_tick != UINT64_MAX &&
+            __rdtsc() - start_tick > NR5G_FAPI_FAPI2PHY_PUT_STALL_TICKS) {
+            NR5G_FAPI_LOG(ERROR_LOG, ("[FAPI2PHY WLS] Send ticket %u stalled "
+                    "behind ticket %u", ticket,
+                    __atomic_load_n(&p_wls_ctx->fapi2phy_put_commit,
+                        __ATOMIC_RELAXED)));
+            start_tick = UINT64_MAX;
+        }
+        _mm_pause();
+    }
+
+    for (idx = 0; idx < p_list->num_puts; idx++) {
+        p_put = &p_list->puts[idx];
+        NR5G_FAPI_LOG(TRACE_LOG, ("[FAPI2PHY WLS][PUT] %ld size: %d "
+                "type: %x flags: %x", p_put->pa, p_put->msg_size,
+                p_put->msg_type, p_put->flags));
+        if (WLS_Put(h_phy_wls, p_put->pa, p_put->msg_size, p_put->msg_type,
+                p_put->flags) != SUCCESS) {
+            printf("Error WLS_Put block 0x%016lx\n", p_put->pa);
+            ret = FAILURE;
+            break;
+        }
+    }
+
+    __atomic_store_n(&p_wls_ctx->fapi2phy_put_commit, ticket + 1,
+        __ATOMIC_RELEASE);
 
     return ret;
 }
@@ -201,21 +342,472 @@ static inline uint8_t is_msg_present(
     return (!((flags & WLS_TF_FIN) || (flags == 0)));
 }
 
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param[in]   enabled TRUE to hold RX_DATA.indication payloads for L2
+ *  @param[in]   timeout Number of UL slots a delivered payload is held for
+ *
+ *  @return  void
+ *
+ *  @description
+ *  This function selects how ULSCH payloads received from L1 are returned to
+ *  the L1 pool. By default they are freed TO_FREE_SIZE slots after they are
+ *  received. When enabled, payloads referenced by an RX_DATA.indication are
+ *  held until L2 returns them with FAPI_VENDOR_EXT_RX_DATA_RELEASE_REQUEST,
+ *  so L2 can keep using pduData in place instead of copying it.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_fapi2phy_rx_data_zbc_init(
+    bool enabled,
+    uint32_t timeout)
+{
+    nr5g_fapi_rx_data_zbc_t *p_zbc = &g_rx_data_zbc;
+    uint32_t idx;
+
+    for (idx = 0; idx < NR5G_FAPI_RX_DATA_ZBC_HASH_SIZE; idx++)
+        p_zbc->hash[idx] = NR5G_FAPI_RX_DATA_ZBC_NIL;
+    for (idx = 0; idx < NR5G_FAPI_RX_DATA_ZBC_MAX_BUFS; idx++)
+        p_zbc->bufs[idx].hash_next = idx + 1;
+    p_zbc->bufs[NR5G_FAPI_RX_DATA_ZBC_MAX_BUFS - 1].hash_next =
+        NR5G_FAPI_RX_DATA_ZBC_NIL;
+    p_zbc->free_head = 0;
+    p_zbc->num_bufs = 0;
+    p_zbc->held.head = p_zbc->held.tail = NR5G_FAPI_RX_DATA_ZBC_NIL;
+    p_zbc->held_urllc.head = p_zbc->held_urllc.tail =
+        NR5G_FAPI_RX_DATA_ZBC_NIL;
+    p_zbc->delivered.head = p_zbc->delivered.tail = NR5G_FAPI_RX_DATA_ZBC_NIL;
+
+    p_zbc->enabled = enabled;
+    p_zbc->timeout = (timeout > TO_FREE_SIZE) ? timeout : TO_FREE_SIZE;
+    if (enabled) {
+        NR5G_FAPI_LOG(INFO_LOG, ("[FAPI2PHY WLS] RX_DATA.indication payloads "
+                "held for L2 release, timeout %u slots", p_zbc->timeout));
+    }
+}
+
+static inline uint32_t nr5g_fapi_rx_data_zbc_hash(
+    uint64_t pdu_data)
+{
+    return (uint32_t) ((pdu_data * 0x9E3779B97F4A7C15ULL) >>
+        (64 - NR5G_FAPI_RX_DATA_ZBC_HASH_BITS));
+}
+
+static inline uint32_t nr5g_fapi_rx_data_zbc_find(
+    nr5g_fapi_rx_data_zbc_t * p_zbc,
+    uint64_t pdu_data)
+{
+    uint32_t idx = p_zbc->hash[nr5g_fapi_rx_data_zbc_hash(pdu_data)];
+
+    while (idx != NR5G_FAPI_RX_DATA_ZBC_NIL &&
+        p_zbc->bufs[idx].pdu_data != pdu_data)
+        idx = p_zbc->bufs[idx].hash_next;
+
+    return idx;
+}
+
+static inline void nr5g_fapi_rx_data_zbc_enqueue(
+    nr5g_fapi_rx_data_zbc_t * p_zbc,
+    nr5g_fapi_rx_data_zbc_queue_t * p_queue,
+    uint32_t idx)
+{
+    p_zbc->bufs[idx].prev = p_queue->tail;
+    p_zbc->bufs[idx].next = NR5G_FAPI_RX_DATA_ZBC_NIL;
+    if (p_queue->tail != NR5G_FAPI_RX_DATA_ZBC_NIL)
+        p_zbc->bufs[p_queue->tail].next = idx;
+    else
+        p_queue->head = idx;
+    p_queue->tail = idx;
+}
+
+static inline void nr5g_fapi_rx_data_zbc_dequeue(
+    nr5g_fapi_rx_data_zbc_t * p_zbc,
+    nr5g_fapi_rx_data_zbc_queue_t * p_queue,
+    uint32_t idx)
+{
+    const nr5g_fapi_rx_data_zbc_buf_t *p_buf = &p_zbc->bufs[idx];
+
+    if (p_buf->prev != NR5G_FAPI_RX_DATA_ZBC_NIL)
+        p_zbc->bufs[p_buf->prev].next = p_buf->next;
+    else
+        p_queue->head = p_buf->next;
+    if (p_buf->next != NR5G_FAPI_RX_DATA_ZBC_NIL)
+        p_zbc->bufs[p_buf->next].prev = p_buf->prev;
+    else
+        p_queue->tail = p_buf->prev;
+}
+
+static inline nr5g_fapi_rx_data_zbc_queue_t *nr5g_fapi_rx_data_zbc_queue(
+    nr5g_fapi_rx_data_zbc_t * p_zbc,
+    uint32_t idx)
+{
+    if (p_zbc->bufs[idx].ref_cnt)
+        return &p_zbc->delivered;
+    return p_zbc->bufs[idx].is_urllc ? &p_zbc->held_urllc : &p_zbc->held;
+}
+
+static inline void nr5g_fapi_rx_data_zbc_free(
+    nr5g_fapi_rx_data_zbc_t * p_zbc,
+    uint32_t idx)
+{
+    nr5g_fapi_rx_data_zbc_buf_t *p_buf = &p_zbc->bufs[idx];
+    uint32_t *p_link =
+        &p_zbc->hash[nr5g_fapi_rx_data_zbc_hash(p_buf->pdu_data)];
+
+    while (*p_link != idx)
+        p_link = &p_zbc->bufs[*p_link].hash_next;
+    *p_link = p_buf->hash_next;
+    nr5g_fapi_rx_data_zbc_dequeue(p_zbc,
+        nr5g_fapi_rx_data_zbc_queue(p_zbc, idx), idx);
+
+    wls_fapi_free_buffer(p_buf->p_block, MIN_UL_BUF_LOCATIONS);
+    p_buf->hash_next = p_zbc->free_head;
+    p_zbc->free_head = idx;
+    p_zbc->num_bufs--;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param[in]   pdu_data ULSCH pPayload as received from L1
+ *  @param[in]   p_block Virtual address of the payload block
+ *  @param[in]   is_urllc TRUE for a payload of a URLLC list
+ *
+ *  @return  TRUE if the block is held, FALSE if it goes on the free list
+ *
+ *  @description
+ *  This function takes a ULSCH payload off the timed free list. Until an
+ *  RX_DATA.indication references it, it is reclaimed as late as it would
+ *  have been freed from the free list. URLLC payloads wait for the URLLC
+ *  thread, they are kept TO_FREE_SIZE_URLLC receives.
+ *
+**/
+//------------------------------------------------------------------------------
+static bool nr5g_fapi_rx_data_zbc_hold(
+    uint64_t pdu_data,
+    void *p_block,
+    bool is_urllc)
+{
+    nr5g_fapi_rx_data_zbc_t *p_zbc = &g_rx_data_zbc;
+    nr5g_fapi_rx_data_zbc_buf_t *p_buf;
+    uint32_t idx, bucket;
+    bool is_held = FALSE;
+
+    if (!p_zbc->enabled)
+        return FALSE;
+
+    pthread_mutex_lock(&p_zbc->lock);
+    idx = p_zbc->free_head;
+    if (idx != NR5G_FAPI_RX_DATA_ZBC_NIL) {
+        p_buf = &p_zbc->bufs[idx];
+        p_zbc->free_head = p_buf->hash_next;
+        p_zbc->num_bufs++;
+        bucket = nr5g_fapi_rx_data_zbc_hash(pdu_data);
+        p_buf->pdu_data = pdu_data;
+        p_buf->p_block = p_block;
+        p_buf->ref_cnt = 0;
+        p_buf->is_urllc = is_urllc;
+        p_buf->expiry = p_zbc->recv_cnt +
+            (is_urllc ? TO_FREE_SIZE_URLLC : TO_FREE_SIZE);
+        p_buf->hash_next = p_zbc->hash[bucket];
+        p_zbc->hash[bucket] = idx;
+        nr5g_fapi_rx_data_zbc_enqueue(p_zbc,
+            nr5g_fapi_rx_data_zbc_queue(p_zbc, idx), idx);
+        p_zbc->stats.held++;
+        is_held = TRUE;
+    } else {
+        p_zbc->stats.table_full++;
+    }
+    pthread_mutex_unlock(&p_zbc->lock);
+
+    return is_held;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param   void
+ *
+ *  @return  void
+ *
+ *  @description
+ *  This function is called once per receive from L1 and returns the held
+ *  payloads whose expiry has passed to the L1 pool. Both queues are in
+ *  expiry order, so only the expired heads are visited.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_rx_data_zbc_age(
+    )
+{
+    nr5g_fapi_rx_data_zbc_t *p_zbc = &g_rx_data_zbc;
+    uint32_t idx;
+
+    if (!p_zbc->enabled)
+        return;
+
+    pthread_mutex_lock(&p_zbc->lock);
+    p_zbc->recv_cnt++;
+    while ((idx = p_zbc->held.head) != NR5G_FAPI_RX_DATA_ZBC_NIL &&
+        (int32_t) (p_zbc->recv_cnt - p_zbc->bufs[idx].expiry) >= 0) {
+        p_zbc->stats.not_delivered++;
+        nr5g_fapi_rx_data_zbc_free(p_zbc, idx);
+    }
+    while ((idx = p_zbc->held_urllc.head) != NR5G_FAPI_RX_DATA_ZBC_NIL &&
+        (int32_t) (p_zbc->recv_cnt - p_zbc->bufs[idx].expiry) >= 0) {
+        p_zbc->stats.not_delivered++;
+        nr5g_fapi_rx_data_zbc_free(p_zbc, idx);
+    }
+    while ((idx = p_zbc->delivered.head) != NR5G_FAPI_RX_DATA_ZBC_NIL &&
+        (int32_t) (p_zbc->recv_cnt - p_zbc->bufs[idx].expiry) >= 0) {
+        p_zbc->stats.timed_out++;
+        nr5g_fapi_rx_data_zbc_free(p_zbc, idx);
+    }
+    pthread_mutex_unlock(&p_zbc->lock);
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param[in]   p_qelm_list URLLC list received from L1
+ *
+ *  @return  void
+ *
+ *  @description
+ *  This function holds the ULSCH payloads of a URLLC list before the list is
+ *  queued to the URLLC thread, so they are held from receive on like the
+ *  regular ones and the URLLC thread can reference them. A payload that
+ *  cannot be held is freed with the regular receives.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_rx_data_zbc_hold_list(
+    PMAC2PHY_QUEUE_EL p_qelm_list)
+{
+    WLS_HANDLE h_wls = nr5g_fapi_fapi2phy_wls_instance();
+    PRXULSCHIndicationStruct p_phy_rx_ulsch_ind;
+    PULSCHPDUDataStruct p_ulsch_pdu;
+    uint64_t *p_free_list = g_to_free_recv_list[g_free_recv_idx];
+    uint32_t *p_free_cnt = &g_to_free_recv_list_cnt[g_free_recv_idx];
+    uint8_t *ptr;
+    uint8_t i;
+
+    if (!g_rx_data_zbc.enabled)
+        return;
+
+    for (; p_qelm_list; p_qelm_list = p_qelm_list->pNext) {
+        p_phy_rx_ulsch_ind = (PRXULSCHIndicationStruct) (p_qelm_list + 1);
+        if (p_phy_rx_ulsch_ind->sMsgHdr.nMessageType !=
+            MSG_TYPE_PHY_RX_ULSCH_IND)
+            continue;
+        for (i = 0u; i < p_phy_rx_ulsch_ind->nUlsch; i++) {
+            p_ulsch_pdu = &p_phy_rx_ulsch_ind->sULSCHPDUDataStruct[i];
+            if (!p_ulsch_pdu->nPduLen)
+                continue;
+            ptr = (uint8_t *) nr5g_fapi_wls_pa_to_va(h_wls,
+                (uint64_t) p_ulsch_pdu->pPayload);
+            if (!ptr || nr5g_fapi_rx_data_zbc_hold(
+                    (uint64_t) p_ulsch_pdu->pPayload, ptr, TRUE))
+                continue;
+            if (*p_free_cnt + 1 >= TOTAL_FREE_BLOCKS) {
+                NR5G_FAPI_LOG(ERROR_LOG, ("%s: Reached max capacity of free "
+                        "list %u", __func__, g_free_recv_idx));
+                return;
+            }
+            p_free_list[(*p_free_cnt)++] = (uint64_t) ptr;
+            p_free_list[*p_free_cnt] = 0L;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param[in]   p_fapi_rx_data_ind RX_DATA.indication about to be sent to L2
+ *
+ *  @return  void
+ *
+ *  @description
+ *  This function takes one reference per PDU of the indication on the held
+ *  payload it points to, and extends its expiry to the release timeout.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_fapi2phy_rx_data_zbc_ref(
+    const fapi_rx_data_indication_t * p_fapi_rx_data_ind)
+{
+    nr5g_fapi_rx_data_zbc_t *p_zbc = &g_rx_data_zbc;
+    const fapi_pdu_ind_info_t *p_pdu;
+    uint32_t buf_idx;
+    uint16_t i;
+
+    if (!p_zbc->enabled)
+        return;
+
+    pthread_mutex_lock(&p_zbc->lock);
+    for (i = 0; i < p_fapi_rx_data_ind->numPdus; i++) {
+        p_pdu = &p_fapi_rx_data_ind->pdus[i];
+        if (!p_pdu->pduData)
+            continue;
+        buf_idx = nr5g_fapi_rx_data_zbc_find(p_zbc,
+            (uint64_t) p_pdu->pduData);
+        if (buf_idx != NR5G_FAPI_RX_DATA_ZBC_NIL) {
+            // requeue at the tail of the delivered queue with the new expiry
+            nr5g_fapi_rx_data_zbc_dequeue(p_zbc,
+                nr5g_fapi_rx_data_zbc_queue(p_zbc, buf_idx), buf_idx);
+            p_zbc->bufs[buf_idx].ref_cnt++;
+            p_zbc->bufs[buf_idx].expiry = p_zbc->recv_cnt + p_zbc->timeout;
+            nr5g_fapi_rx_data_zbc_enqueue(p_zbc, &p_zbc->delivered, buf_idx);
+        }
+    }
+    pthread_mutex_unlock(&p_zbc->lock);
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param[in]   p_release_req Payloads L2 is done with
+ *
+ *  @return  void
+ *
+ *  @description
+ *  This function drops one reference per pduData listed by L2 and returns the
+ *  payloads that are no longer referenced to the L1 pool.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_fapi2phy_rx_data_zbc_release(
+    const fapi_vendor_ext_rx_data_release_req_t * p_release_req)
+{
+    nr5g_fapi_rx_data_zbc_t *p_zbc = &g_rx_data_zbc;
+    uint16_t num_pdus = p_release_req->num_pdus;
+    uint32_t buf_idx;
+    uint16_t i;
+
+    if (num_pdus > FAPI_MAX_NUMBER_OF_ULSCH_PDUS_PER_SLOT) {
+        NR5G_FAPI_LOG(ERROR_LOG, ("[FAPI2PHY WLS] RX_DATA release of %u PDUs,"
+                " max %u", num_pdus, FAPI_MAX_NUMBER_OF_ULSCH_PDUS_PER_SLOT));
+        num_pdus = FAPI_MAX_NUMBER_OF_ULSCH_PDUS_PER_SLOT;
+    }
+
+    pthread_mutex_lock(&p_zbc->lock);
+    for (i = 0; i < num_pdus; i++) {
+        buf_idx = nr5g_fapi_rx_data_zbc_find(p_zbc,
+            (uint64_t) p_release_req->pdu_data[i]);
+        if ((buf_idx == NR5G_FAPI_RX_DATA_ZBC_NIL) ||
+            !p_zbc->bufs[buf_idx].ref_cnt) {
+            // already reclaimed, or never delivered
+            p_zbc->stats.unknown++;
+            continue;
+        }
+        if (p_zbc->bufs[buf_idx].ref_cnt == 1) {
+            p_zbc->stats.released++;
+            nr5g_fapi_rx_data_zbc_free(p_zbc, buf_idx);
+        } else {
+            p_zbc->bufs[buf_idx].ref_cnt--;
+        }
+    }
+    pthread_mutex_unlock(&p_zbc->lock);
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param   void
+ *
+ *  @return  void
+ *
+ *  @description
+ *  This function prints the RX_DATA.indication payload release counters.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_fapi2phy_rx_data_zbc_print_stats(
+    )
+{
+    nr5g_fapi_rx_data_zbc_t *p_zbc = &g_rx_data_zbc;
+
+    if (!p_zbc->enabled)
+        return;
+
+    printf("RX_DATA zbc: held %lu released %lu not delivered %lu "
+        "timed out %lu table full %lu unknown %lu outstanding %u\n",
+        p_zbc->stats.held, p_zbc->stats.released, p_zbc->stats.not_delivered,
+        p_zbc->stats.timed_out, p_zbc->stats.table_full,
+        p_zbc->stats.unknown, p_zbc->num_bufs);
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param[out]  p_stats RX_DATA.indication payload release counters
+ *
+ *  @return  Number of payloads held
+ *
+ *  @description
+ *  This function copies the RX_DATA.indication payload release counters.
+ *
+**/
+//------------------------------------------------------------------------------
+uint32_t nr5g_fapi_fapi2phy_rx_data_zbc_get_stats(
+    nr5g_fapi_rx_data_zbc_stats_t * p_stats)
+{
+    nr5g_fapi_rx_data_zbc_t *p_zbc = &g_rx_data_zbc;
+    uint32_t num_bufs;
+
+    pthread_mutex_lock(&p_zbc->lock);
+    *p_stats = p_zbc->stats;
+    num_bufs = p_zbc->num_bufs;
+    pthread_mutex_unlock(&p_zbc->lock);
+
+    return num_bufs;
+}
+
 void nr5g_fapi_transfer_to_free_recv_list (
     PMAC2PHY_QUEUE_EL p_qelm_list
     /*uint32_t* free_recv_idx*/)
 {
-    wls_fapi_add_recv_apis_to_free(p_qelm_list, g_free_recv_idx);
+    wls_fapi_add_recv_apis_to_free(p_qelm_list, g_free_recv_idx, false,
+        true);
     (g_free_recv_idx)++;
     if ((g_free_recv_idx) >= TO_FREE_SIZE) {
         (g_free_recv_idx) = 0;
     }
     // Free few TTIs Later
-    wls_fapi_free_recv_free_list(g_free_recv_idx);
+    wls_fapi_free_recv_free_list(g_free_recv_idx, false);
 
     wls_fapi_add_blocks_to_ul();
 }
 
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param[in]   p_qelm_list URLLC list received from L1
+ *
+ *  @return  void
+ *
+ *  @description
+ *  Called by the URLLC PHY2MAC thread once it has processed the list, the
+ *  blocks are freed TO_FREE_SIZE_URLLC lists later. The URLLC lists have
+ *  their own free array, so the list stays valid while it waits in the
+ *  URLLC mailbox however many regular receives happen meanwhile. The UL
+ *  blocks are given back to L1 by the next regular receive.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_transfer_to_free_recv_list_urllc(
+    PMAC2PHY_QUEUE_EL p_qelm_list)
+{
+    wls_fapi_add_recv_apis_to_free(p_qelm_list, g_free_recv_idx_urllc, true,
+        false);
+    g_free_recv_idx_urllc++;
+    if (g_free_recv_idx_urllc >= TO_FREE_SIZE_URLLC) {
+        g_free_recv_idx_urllc = 0;
+    }
+    wls_fapi_free_recv_free_list(g_free_recv_idx_urllc, true);
+}
+
 //----------------------------------------------------------------------------------
 /** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
  *
@@ -247,6 +839,8 @@ PMAC2PHY_QUEUE_EL nr5g_fapi_fapi2phy_wls_recv(
         return p_qelm_list;
 
     start_tick = __rdtsc();
+    if (nr5g_fapi_recorder_active_g)
+        nr5g_fapi_recorder_block_begin(NR5G_FAPI_REC_PHY2MAC);
 
     do {
         p_msg = nr5g_fapi_fapi2phy_wls_get(&msg_size, &msg_type, &flags);
@@ -259,6 +853,8 @@ PMAC2PHY_QUEUE_EL nr5g_fapi_fapi2phy_wls_recv(
                 continue;
             }
             p_qelm->pNext = NULL;
+            if (nr5g_fapi_recorder_active_g)
+                nr5g_fapi_recorder_phy2mac_elem(p_qelm, flags);
 
             if (flags & WLS_TF_URLLC)
             {
@@ -282,11 +878,23 @@ PMAC2PHY_QUEUE_EL nr5g_fapi_fapi2phy_wls_recv(
         }
         num_elms--;
     } while (num_elms && is_msg_present(flags));
+    if (nr5g_fapi_recorder_active_g)
+        nr5g_fapi_recorder_block_end(NR5G_FAPI_REC_PHY2MAC);
+
+    // One UL slot passed for the held RX_DATA.indication payloads
+    nr5g_fapi_rx_data_zbc_age();
 
+    // The URLLC thread frees the list once processed. A list it never gets
+    // is freed with the regular ones. Its payloads are held here, before the
+    // URLLC thread can deliver them to L2.
     if (p_urllc_qelm_list) {
-        nr5g_fapi_transfer_to_free_recv_list (p_urllc_qelm_list);
-        nr5g_fapi_urllc_thread_callback((void *) p_urllc_qelm_list, 
-                    &nr5g_fapi_get_nr5g_fapi_phy_ctx()->urllc_phy2mac_params);
+        nr5g_fapi_rx_data_zbc_hold_list(p_urllc_qelm_list);
+        if (nr5g_fapi_urllc_thread_callback((void *) p_urllc_qelm_list,
+                &nr5g_fapi_get_nr5g_fapi_phy_ctx()->urllc_phy2mac_params) !=
+            SUCCESS) {
+            wls_fapi_add_recv_apis_to_free(p_urllc_qelm_list,
+                g_free_recv_idx, false, false);
+        }
     }
 
     if (p_qelm_list) {
@@ -341,7 +949,7 @@ int nr5g_fapi_fapi2phy_is_sdu_zbc_block(
  *
  *  @param[in]   p_msg_header Pointer to the TxSduReq Message block
  *  @param[in]   flags Special flags needed for WLS
- *  @param[in]   n_zbc_blocks Number of ZBC blocks in list
+ *  @param[out]  p_list List of blocks to be sent to L1
  *
  *  @return  0 if SUCCESS
  *
@@ -351,9 +959,10 @@ int nr5g_fapi_fapi2phy_is_sdu_zbc_block(
  *
 **/
 //------------------------------------------------------------------------------
-uint32_t nr5g_fapi_fapi2phy_send_zbc_blocks(
+static uint32_t nr5g_fapi_fapi2phy_add_zbc_blocks(
     void *p_msg,
-    uint16_t flags)
+    uint16_t flags,
+    nr5g_fapi_fapi2phy_put_list_t * p_list)
 {
     PL1L2MessageHdr p_msg_header = (PL1L2MessageHdr) p_msg;
     PTXRequestStruct p_dl_sdu_req = (PTXRequestStruct) p_msg_header;
@@ -388,8 +997,8 @@ uint32_t nr5g_fapi_fapi2phy_send_zbc_blocks(
                     flags = WLS_SG_NEXT | flags_urllc;
                 }
 
-                WLS_HANDLE h_phy_wls = nr5g_fapi_fapi2phy_wls_instance();
-                if (WLS_Put(h_phy_wls, (uint64_t) p_payload, pdu_len, msg_type,
+                if (nr5g_fapi_fapi2phy_put_list_add(p_list,
+                        (uint64_t) p_payload, pdu_len, msg_type,
                         flags) != SUCCESS) {
                     printf("Error ZBC block 0x%016lx\n", (uint64_t) p_payload);
                     return FAILURE;
@@ -402,6 +1011,72 @@ uint32_t nr5g_fapi_fapi2phy_send_zbc_blocks(
     return SUCCESS;
 }
 
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
+ *
+ *  @param[in]      A data Pointer to the Linked list header
+ *  @param[in]      is_urllc TRUE for the URLLC list
+ *  @param[out]     p_list List of blocks to be sent to L1
+ *
+ *  @return         0 if SUCCESS
+ *
+ *  @description    This function lays out a list of APIs and their ZBC
+ *                  blocks with the WLS scatter gather flags, without
+ *                  touching the WLS queue
+ *
+**/
+//------------------------------------------------------------------------------
+static uint8_t nr5g_fapi_fapi2phy_build_put_list(
+    PMAC2PHY_QUEUE_EL p_curr_msg,
+    bool is_urllc,
+    nr5g_fapi_fapi2phy_put_list_t * p_list)
+{
+    WLS_HANDLE h_phy_wls = nr5g_fapi_fapi2phy_wls_instance();
+    PL1L2MessageHdr p_msg_header;
+    uint16_t flags = 0;
+    uint16_t flags_urllc = (is_urllc ? WLS_TF_URLLC : 0);
+    int n_zbc_blocks = 0, is_zbc = 0;
+
+    p_list->num_puts = 0;
+    if (!p_curr_msg->pNext) {   // one block
+        if (nr5g_fapi_fapi2phy_is_sdu_zbc_block(p_curr_msg, &n_zbc_blocks)) {
+            printf("Error ZBC block cannot be only one in the list\n");
+            return FAILURE;
+        }
+        return nr5g_fapi_fapi2phy_put_list_add(p_list,
+            nr5g_fapi_wls_va_to_pa(h_phy_wls, p_curr_msg),
+            p_curr_msg->nMessageLen + sizeof(MAC2PHY_QUEUE_EL),
+            p_curr_msg->nMessageType, flags);
+    }
+
+    flags = WLS_SG_FIRST | flags_urllc;
+    while (p_curr_msg) {
+        // only batch mode
+        p_msg_header = (PL1L2MessageHdr) (p_curr_msg + 1);
+        is_zbc = nr5g_fapi_fapi2phy_is_sdu_zbc_block(p_msg_header,
+            &n_zbc_blocks);
+        if (!p_curr_msg->pNext) {
+            // LAST, unless the ZBC blocks of the API follow it
+            flags = (is_zbc ? WLS_SG_NEXT : WLS_SG_LAST) | flags_urllc;
+        }
+        if (nr5g_fapi_fapi2phy_put_list_add(p_list,
+                nr5g_fapi_wls_va_to_pa(h_phy_wls, p_curr_msg),
+                p_curr_msg->nMessageLen + sizeof(MAC2PHY_QUEUE_EL),
+                p_msg_header->nMessageType, flags) != SUCCESS) {
+            return FAILURE;
+        }
+        if (is_zbc && (nr5g_fapi_fapi2phy_add_zbc_blocks(p_msg_header,
+                    p_curr_msg->pNext ? flags : (WLS_SG_LAST | flags_urllc),
+                    p_list) != SUCCESS)) {
+            return FAILURE;
+        }
+        p_curr_msg = p_curr_msg->pNext;
+        flags = WLS_SG_NEXT | flags_urllc;
+    }
+
+    return SUCCESS;
+}
+
 //------------------------------------------------------------------------------
 /** @ingroup nr5g_fapi_source_framework_wls_fapi2phy_group
  *
@@ -418,116 +1093,23 @@ uint8_t nr5g_fapi_fapi2phy_wls_send(
     void *data,
     bool is_urllc)
 {
-    p_nr5g_fapi_wls_context_t p_wls_ctx = nr5g_fapi_wls_context();
+    nr5g_fapi_fapi2phy_put_list_t *p_put_list = &g_put_list[is_urllc ? 1 : 0];
     PMAC2PHY_QUEUE_EL p_curr_msg = NULL;
-    PL1L2MessageHdr p_msg_header;
-    uint16_t flags = 0;
-    uint16_t flags_urllc = (is_urllc ? WLS_TF_URLLC : 0);
-    uint8_t ret = SUCCESS;
-    int n_zbc_blocks = 0, is_zbc = 0, count = 0;
 
     p_curr_msg = (PMAC2PHY_QUEUE_EL) data;
     is_urllc ? wls_fapi_add_send_apis_to_free_urllc(p_curr_msg, g_free_send_idx_urllc)
              : wls_fapi_add_send_apis_to_free(p_curr_msg, g_free_send_idx);
 
-    if (pthread_mutex_lock((pthread_mutex_t *) & p_wls_ctx->fapi2phy_lock_send)) {
-        NR5G_FAPI_LOG(ERROR_LOG, ("unable to lock send pthread mutex"));
+    if (nr5g_fapi_fapi2phy_build_put_list(p_curr_msg, is_urllc, p_put_list) !=
+        SUCCESS) {
         return FAILURE;
     }
 
-    if (p_curr_msg->pNext) {
-        flags = WLS_SG_FIRST | flags_urllc;
-        while (p_curr_msg) {
-            // only batch mode
-            count++;
-            p_msg_header = (PL1L2MessageHdr) (p_curr_msg + 1);
-            if (p_curr_msg->pNext) {    // FIRST/NEXT list element
-                if (SUCCESS != nr5g_fapi_fapi2phy_wls_put((uint64_t) p_curr_msg,
-                        p_curr_msg->nMessageLen + sizeof(MAC2PHY_QUEUE_EL),
-                        p_msg_header->nMessageType, flags)) {
-                    if (pthread_mutex_unlock((pthread_mutex_t *) &
-                            p_wls_ctx->fapi2phy_lock_send)) {
-                        NR5G_FAPI_LOG(ERROR_LOG,
-                            ("unable to unlock send pthread mutex"));
-                    }
-                    return FAILURE;
-                }
-
-                if (nr5g_fapi_fapi2phy_is_sdu_zbc_block(p_msg_header, &n_zbc_blocks)) { // ZBC blocks
-                    if (nr5g_fapi_fapi2phy_send_zbc_blocks(p_msg_header,
-                            flags) != SUCCESS) {
-                        if (pthread_mutex_unlock((pthread_mutex_t *) &
-                                p_wls_ctx->fapi2phy_lock_send)) {
-                            NR5G_FAPI_LOG(ERROR_LOG,
-                                ("unable to unlock send pthread mutex"));
-                        }
-                        return FAILURE;
-                    }
-                }
-                p_curr_msg = p_curr_msg->pNext;
-            } else {            /* p_curr_msg->Next */
-                // LAST
-                flags = WLS_SG_LAST | flags_urllc;
-                is_zbc = 0;
-                if (nr5g_fapi_fapi2phy_is_sdu_zbc_block(p_msg_header,
-                        &n_zbc_blocks)) {
-                    flags = WLS_SG_NEXT | flags_urllc;
-                    is_zbc = 1;
-                }
-                if (nr5g_fapi_fapi2phy_wls_put((uint64_t) p_curr_msg,
-                        p_curr_msg->nMessageLen + sizeof(MAC2PHY_QUEUE_EL),
-                        p_msg_header->nMessageType, flags) != SUCCESS) {
-                    printf("Error\n");
-                    if (pthread_mutex_unlock((pthread_mutex_t *) &
-                            p_wls_ctx->fapi2phy_lock_send)) {
-                        NR5G_FAPI_LOG(ERROR_LOG,
-                            ("unable to unlock send pthread mutex"));
-                    }
-                    return FAILURE;
-                }
-
-                if (is_zbc) {   // ZBC blocks
-                    if (nr5g_fapi_fapi2phy_send_zbc_blocks(p_msg_header,
-                            WLS_SG_LAST | flags_urllc) != SUCCESS) {
-                        printf("Error\n");
-                        if (pthread_mutex_unlock((pthread_mutex_t *) &
-                                p_wls_ctx->fapi2phy_lock_send)) {
-                            NR5G_FAPI_LOG(ERROR_LOG,
-                                ("unable to unlock send pthread mutex"));
-                        }
-                        return FAILURE;
-                    }
-                }
-                p_curr_msg = NULL;
-            }                   /* p_curr_msg->Next */
-            flags = WLS_SG_NEXT | flags_urllc;
-        }
-    } else {                    // one block
-        count++;
-        if (nr5g_fapi_fapi2phy_is_sdu_zbc_block(p_curr_msg, &n_zbc_blocks)) {
-            printf("Error ZBC block cannot be only one in the list\n");
-            if (pthread_mutex_unlock((pthread_mutex_t *) &
-                    p_wls_ctx->fapi2phy_lock_send)) {
-                NR5G_FAPI_LOG(ERROR_LOG,
-                    ("unable to unlock send pthread mutex"));
-            }
-            return FAILURE;
-        }
-
-        if (SUCCESS != nr5g_fapi_fapi2phy_wls_put((uint64_t) p_curr_msg,
-                p_curr_msg->nMessageLen + sizeof(MAC2PHY_QUEUE_EL),
-                p_curr_msg->nMessageType, flags)) {
-            printf("Error\n");
-            if (pthread_mutex_unlock((pthread_mutex_t *) &
-                    p_wls_ctx->fapi2phy_lock_send)) {
-                NR5G_FAPI_LOG(ERROR_LOG,
-                    ("unable to unlock send pthread mutex"));
-            }
-            return FAILURE;
-        }
+    if (nr5g_fapi_fapi2phy_wls_publish(p_put_list) != SUCCESS) {
+        return FAILURE;
     }
 
-    if (count > 1) {
+    if (p_curr_msg->pNext) {
         if(is_urllc) {
             g_free_send_idx_urllc++;
             if (g_free_send_idx_urllc >= TO_FREE_SIZE_URLLC)
@@ -543,12 +1125,7 @@ uint8_t nr5g_fapi_fapi2phy_wls_send(
                  : wls_fapi_free_send_free_list();
     }
 
-    if (pthread_mutex_unlock((pthread_mutex_t *) &
-            p_wls_ctx->fapi2phy_lock_send)) {
-        NR5G_FAPI_LOG(ERROR_LOG, ("unable to unlock send pthread mutex"));
-        return FAILURE;
-    }
-    return ret;
+    return SUCCESS;
 }
 
 //------------------------------------------------------------------------------
@@ -611,6 +1188,9 @@ uint8_t get_stats_location(
  *
  *  @param[in]      pListElem Pointer to List element header
  *  @param[in]      idx Subframe Number
+ *  @param[in]      is_urllc TRUE for the URLLC free array
+ *  @param[in]      hold_payloads TRUE to hold the ULSCH payloads for L2
+ *                  here, FALSE when they were held at receive
  *
  *  @return         Number of blocks freed
  *
@@ -621,13 +1201,17 @@ uint8_t get_stats_location(
 //------------------------------------------------------------------------------
 void wls_fapi_add_recv_apis_to_free(
     PMAC2PHY_QUEUE_EL pListElem,
-    uint32_t idx)
+    uint32_t idx,
+    bool is_urllc,
+    bool hold_payloads)
 {
     PMAC2PHY_QUEUE_EL pNextMsg = NULL;
     L1L2MessageHdr *p_msg_header = NULL;
     PRXULSCHIndicationStruct p_phy_rx_ulsch_ind = NULL;
     PULSCHPDUDataStruct p_ulsch_pdu = NULL;
     uint8_t *ptr = NULL;
+    uint64_t *p_free_list;
+    uint32_t *p_free_cnt;
     uint32_t count;
     uint8_t i;
 
@@ -635,7 +1219,16 @@ void wls_fapi_add_recv_apis_to_free(
     p_nr5g_fapi_wls_context_t p_wls_ctx = nr5g_fapi_wls_context();
     h_wls = p_wls_ctx->h_wls[NR5G_FAPI2PHY_WLS_INST];
 
-    count = g_to_free_recv_list_cnt[idx];
+    if (idx >= (is_urllc ? TO_FREE_SIZE_URLLC : TO_FREE_SIZE)) {
+        NR5G_FAPI_LOG(ERROR_LOG, ("%s: list index: %d\n", __func__, idx));
+        return;
+    }
+    p_free_list = is_urllc ? g_to_free_recv_list_urllc[idx] :
+        g_to_free_recv_list[idx];
+    p_free_cnt = is_urllc ? &g_to_free_recv_list_cnt_urllc[idx] :
+        &g_to_free_recv_list_cnt[idx];
+
+    count = *p_free_cnt;
     pNextMsg = pListElem;
     while (pNextMsg) {
         if (count >= TOTAL_FREE_BLOCKS) {
@@ -645,7 +1238,7 @@ void wls_fapi_add_recv_apis_to_free(
             return;
         }
 
-        g_to_free_recv_list[idx][count++] = (uint64_t) pNextMsg;
+        p_free_list[count++] = (uint64_t) pNextMsg;
         p_msg_header = (PL1L2MessageHdr) (pNextMsg + 1);
         if (p_msg_header->nMessageType == MSG_TYPE_PHY_RX_ULSCH_IND) {
             p_phy_rx_ulsch_ind = (PRXULSCHIndicationStruct) p_msg_header;
@@ -655,8 +1248,12 @@ void wls_fapi_add_recv_apis_to_free(
                     ptr = (uint8_t *) nr5g_fapi_wls_pa_to_va(h_wls,
                         (uint64_t) p_ulsch_pdu->pPayload);
 
-                if (ptr) {
-                    g_to_free_recv_list[idx][count++] = (uint64_t) ptr;
+                // payloads not held here went through
+                // nr5g_fapi_rx_data_zbc_hold_list at receive
+                if (ptr && (hold_payloads ? !nr5g_fapi_rx_data_zbc_hold(
+                            (uint64_t) p_ulsch_pdu->pPayload, ptr, FALSE) :
+                        !g_rx_data_zbc.enabled)) {
+                    p_free_list[count++] = (uint64_t) ptr;
                 }
                 } else {
                     NR5G_FAPI_LOG(DEBUG_LOG, ("%s: Payload for"
@@ -669,8 +1266,8 @@ void wls_fapi_add_recv_apis_to_free(
         pNextMsg = pNextMsg->pNext;
     }
 
-    g_to_free_recv_list[idx][count] = 0L;
-    g_to_free_recv_list_cnt[idx] = count;
+    p_free_list[count] = 0L;
+    *p_free_cnt = count;
 
     NR5G_FAPI_LOG(DEBUG_LOG, ("To Free %d\n", count));
 }
@@ -679,6 +1276,7 @@ void wls_fapi_add_recv_apis_to_free(
 /** @ingroup nr5g_fapi_source_framework_wls_lib_group 
  *
  *  @param[in]      idx subframe Number
+ *  @param[in]      is_urllc TRUE for the URLLC free array
  *
  *  @return         Number of blocks freed
  *
@@ -687,28 +1285,35 @@ void wls_fapi_add_recv_apis_to_free(
 **/
 //------------------------------------------------------------------------------
 void wls_fapi_free_recv_free_list(
-    uint32_t idx)
+    uint32_t idx,
+    bool is_urllc)
 {
     PMAC2PHY_QUEUE_EL pNextMsg = NULL;
+    uint64_t *p_free_list;
     int count = 0;
 
-    if (idx >= TO_FREE_SIZE) {
+    if (idx >= (is_urllc ? TO_FREE_SIZE_URLLC : TO_FREE_SIZE)) {
         NR5G_FAPI_LOG(ERROR_LOG, ("%s: list index: %d\n", __func__, idx));
         return;
     }
+    p_free_list = is_urllc ? g_to_free_recv_list_urllc[idx] :
+        g_to_free_recv_list[idx];
 
-    pNextMsg = (PMAC2PHY_QUEUE_EL) g_to_free_recv_list[idx][count];
+    pNextMsg = (PMAC2PHY_QUEUE_EL) p_free_list[count];
     while (pNextMsg) {
         wls_fapi_free_buffer(pNextMsg, MIN_UL_BUF_LOCATIONS);
-        g_to_free_recv_list[idx][count++] = 0L;
-        if (g_to_free_recv_list[idx][count])
-            pNextMsg = (PMAC2PHY_QUEUE_EL) g_to_free_recv_list[idx][count];
+        p_free_list[count++] = 0L;
+        if (p_free_list[count])
+            pNextMsg = (PMAC2PHY_QUEUE_EL) p_free_list[count];
         else
             pNextMsg = 0L;
     }
 
     NR5G_FAPI_LOG(DEBUG_LOG, ("Free %d\n", count));
-    g_to_free_recv_list_cnt[idx] = 0;
+    if (is_urllc)
+        g_to_free_recv_list_cnt_urllc[idx] = 0;
+    else
+        g_to_free_recv_list_cnt[idx] = 0;
 
     return;
 }
@@ -26,6 +26,16 @@
 #define _NR5G_FAPI2PHY_WLS_H_
 
 #include "common_mac_phy_api.h"
+#include "fapi_vendor_extension.h"
+
+typedef struct _nr5g_fapi_rx_data_zbc_stats {
+    uint64_t held;              // payloads taken off the timed free list
+    uint64_t released;          // payloads returned by L2
+    uint64_t not_delivered;     // payloads no RX_DATA.indication referenced
+    uint64_t timed_out;         // payloads L2 did not release in time
+    uint64_t table_full;        // payloads left on the timed free list
+    uint64_t unknown;           // releases of payloads not held
+} nr5g_fapi_rx_data_zbc_stats_t;
 
 uint8_t nr5g_fapi_fapi2phy_is_valid_wls_ptr(
     void *data);
@@ -46,8 +56,26 @@ void wls_fapi_add_send_apis_to_free_urllc(
 void wls_fapi_free_send_free_list_urllc();
 void wls_fapi_add_recv_apis_to_free(
     PMAC2PHY_QUEUE_EL pListElem,
-    uint32_t idx);
+    uint32_t idx,
+    bool is_urllc,
+    bool hold_payloads);
 void wls_fapi_free_recv_free_list(
-    uint32_t idx);
+    uint32_t idx,
+    bool is_urllc);
+void nr5g_fapi_transfer_to_free_recv_list(
+    PMAC2PHY_QUEUE_EL p_qelm_list);
+void nr5g_fapi_transfer_to_free_recv_list_urllc(
+    PMAC2PHY_QUEUE_EL p_qelm_list);
+void nr5g_fapi_fapi2phy_rx_data_zbc_init(
+    bool enabled,
+    uint32_t timeout);
+void nr5g_fapi_fapi2phy_rx_data_zbc_ref(
+    const fapi_rx_data_indication_t * p_fapi_rx_data_ind);
+void nr5g_fapi_fapi2phy_rx_data_zbc_release(
+    const fapi_vendor_ext_rx_data_release_req_t * p_release_req);
+void nr5g_fapi_fapi2phy_rx_data_zbc_print_stats(
+    );
+uint32_t nr5g_fapi_fapi2phy_rx_data_zbc_get_stats(
+    nr5g_fapi_rx_data_zbc_stats_t * p_stats);
 
 #endif /*_NR5G_FAPI2PHY_WLS_H_*/
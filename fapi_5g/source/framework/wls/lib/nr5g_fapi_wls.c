@@ -300,8 +300,8 @@ uint8_t nr5g_fapi_wls_init(
         return FAILURE;
     }
 
-    pthread_mutex_init((pthread_mutex_t *)
-        & p_wls_ctx->fapi2phy_lock_send, NULL);
+    p_wls_ctx->fapi2phy_put_reserve = 0;
+    p_wls_ctx->fapi2phy_put_commit = 0;
     pthread_mutex_init((pthread_mutex_t *)
         & p_wls_ctx->fapi2phy_lock_alloc, NULL);
     pthread_mutex_init((pthread_mutex_t *)
@@ -83,7 +83,8 @@ typedef struct _nr5g_fapi_wls_context {
     uint32_t nTotalDlBufFreeCnt[MAX_DL_BUF_LOCATIONS];
     uint32_t nPartitionMemSize;
     void *pPartitionMemBase;
-    volatile pthread_mutex_t fapi2phy_lock_send;
+    volatile uint32_t fapi2phy_put_reserve; // next FAPI2PHY send ticket
+    volatile uint32_t fapi2phy_put_commit;  // ticket allowed to put
     volatile pthread_mutex_t fapi2phy_lock_alloc;
     volatile pthread_mutex_t fapi2mac_lock_send;
     volatile pthread_mutex_t fapi2mac_lock_alloc;
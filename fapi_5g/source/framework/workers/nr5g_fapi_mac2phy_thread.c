@@ -18,10 +18,13 @@
 #include "nr5g_fapi_std.h"
 #include "nr5g_fapi_mac2phy_thread.h"
 #include "nr5g_fapi_fapi2mac_wls.h"
+#include "nr5g_fapi_fapi2phy_wls.h"
 #include "nr5g_fapi_fapi2phy_api.h"
 #include "nr5g_fapi_fapi2phy_p5_proc.h"
 #include "nr5g_fapi_fapi2phy_p7_proc.h"
 #include "nr5g_fapi_log.h"
+#include "nr5g_fapi_stats.h"
+#include <immintrin.h>
 
 //------------------------------------------------------------------------------
 /** @ingroup nr5g_fapi_source_framework_workers_mac2phy_group
@@ -38,7 +41,7 @@
 void *nr5g_fapi_mac2phy_thread_func(
     void *config)
 {
-    p_fapi_api_queue_elem_t p_msg_list = NULL;
+    nr5g_fapi_mac2phy_demux_t demux;
     p_nr5g_fapi_phy_ctx_t p_phy_ctx = (p_nr5g_fapi_phy_ctx_t) config;
     uint64_t start_tick;
 
@@ -47,11 +50,11 @@ void *nr5g_fapi_mac2phy_thread_func(
             p_phy_ctx->mac2phy_worker_core_id));
 
     nr5g_fapi_init_thread(p_phy_ctx->mac2phy_worker_core_id);
+    nr5g_fapi_mac2phy_demux_init(&demux);
 
     while (!p_phy_ctx->process_exit) {
-        p_msg_list = nr5g_fapi_fapi2mac_wls_recv();
-        if (p_msg_list)
-            nr5g_fapi_mac2phy_api_recv_handler(false, config, p_msg_list);
+        if (nr5g_fapi_fapi2mac_wls_recv(&demux))
+            nr5g_fapi_mac2phy_api_demux_handler(false, config, &demux);
 
         start_tick = __rdtsc();
         NR5G_FAPI_LOG(TRACE_LOG, ("[MAC2PHY] Send to PHY.."));
@@ -77,92 +80,264 @@ void nr5g_fapi_mac2phy_api_recv_handler(
     bool is_urllc,
     void *config,
     p_fapi_api_queue_elem_t p_msg_list)
+{
+    nr5g_fapi_mac2phy_demux_t demux;
+
+    NR5G_FAPI_LOG(TRACE_LOG, ("[MAC2PHY] %s:", __func__));
+    nr5g_fapi_mac2phy_demux_init(&demux);
+    nr5g_fapi_mac2phy_demux_list(&demux, p_msg_list);
+    nr5g_fapi_mac2phy_api_demux_handler(is_urllc, config, &demux);
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_workers_mac2phy_group
+ *
+ *  @param[in]   is_urllc  URLLC or regular message block
+ *  @param[in]   p_phy_ctx PHY context
+ *  @param[in]   p_demux   Received APIs split per PHY instance
+ *  @param[in]   phy_id    PHY instance to process
+ *
+ *  @return none
+ *
+ *  @description
+ *  Processes the API list of one PHY instance of the block.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_mac2phy_phy_api_handler(
+    bool is_urllc,
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx,
+    p_nr5g_fapi_mac2phy_demux_t p_demux,
+    uint8_t phy_id)
 {
     p_fapi_api_queue_elem_t p_per_carr_api_list = NULL;
-    p_fapi_api_queue_elem_t p_prev_elm = NULL;
     fapi_msg_t *p_fapi_msg = NULL;
-    p_fapi_msg_header_t p_fapi_msg_header = NULL;
-
-    p_nr5g_fapi_phy_ctx_t p_phy_ctx = NULL;
     p_nr5g_fapi_phy_instance_t p_phy_instance = NULL;
-    uint8_t num_apis = 0;
-    uint8_t phy_id = 0;
-    uint64_t start_tick = __rdtsc();
 
-    NR5G_FAPI_LOG(TRACE_LOG, ("[MAC2PHY] %s:", __func__));
-    p_phy_ctx = (p_nr5g_fapi_phy_ctx_t) config;
-    while (p_msg_list) {
-        p_per_carr_api_list = p_msg_list;
-        p_fapi_msg_header = (fapi_msg_header_t *) (p_per_carr_api_list + 1);
-        num_apis = p_fapi_msg_header->num_msg;
-        phy_id = p_fapi_msg_header->handle;
-
-        if (num_apis > 0 && p_msg_list->p_next) {   // likely
-            p_per_carr_api_list = p_per_carr_api_list->p_next;
-            p_msg_list = p_per_carr_api_list;
-            NR5G_FAPI_LOG(TRACE_LOG, ("\n[MAC2PHY] PHY_ID: %d NUM APIs: %d\n",
-                    phy_id, num_apis));
-        } else {                // unlikely
-            // skip to next carrier list. since current fapi message hearder
-            // has no apis
-            if (p_msg_list->p_next) {
-                NR5G_FAPI_LOG(TRACE_LOG, ("\n[MAC2PHY] No APIs for PHY_ID: %d."
-                        " Skip...\n", phy_id));
-                p_msg_list = p_msg_list->p_next;
-                continue;
-            } else {
-                NR5G_FAPI_LOG(ERROR_LOG, ("\n[MAC2PHY] PHY_ID: %d NUM APIs: %d\n",
-                        phy_id, num_apis));
+    p_per_carr_api_list = p_demux->phy_api_list[phy_id].p_head;
+    if (NULL == p_per_carr_api_list) {
+        NR5G_FAPI_LOG(ERROR_LOG, ("\n[MAC2PHY] PHY_ID: %d NUM APIs: 0\n",
+                phy_id));
+        return;
+    }
+
+    p_fapi_msg = (fapi_msg_t *) (p_per_carr_api_list + 1);
+    p_phy_instance = &p_phy_ctx->phy_instance[phy_id];
+#ifdef DEBUG_MODE
+    if ((p_fapi_msg->msg_id != FAPI_VENDOR_EXT_UL_IQ_SAMPLES) &&
+        (p_fapi_msg->msg_id != FAPI_VENDOR_EXT_ADD_REMOVE_CORE)) {
+#endif
+        if (FAPI_STATE_IDLE == p_phy_instance->state) {
+            if (p_fapi_msg->msg_id != FAPI_CONFIG_REQUEST) {
+                NR5G_FAPI_LOG(ERROR_LOG,
+                    ("CONFIG.request is not received "
+                        "for %d PHY Instance\n", phy_id));
                 return;
             }
+            p_phy_instance->phy_id = phy_id;
         }
+#ifdef DEBUG_MODE
+    }
+#endif
 
-        // walk through the list and disconnet per carrier apis
-        if (p_msg_list->p_next) {
-            p_prev_elm = p_msg_list;
-            while (p_msg_list) {
-                if (FAPI_VENDOR_MSG_HEADER_IND == p_msg_list->msg_type) {
-                    p_prev_elm->p_next = NULL;
-                    break;
-                }
-                p_prev_elm = p_msg_list;
-                p_msg_list = p_msg_list->p_next;
-            }
-        } else {
-            p_msg_list = NULL;
+    nr5g_fapi_mac2phy_api_processing_handler(is_urllc, p_phy_instance,
+        p_per_carr_api_list);
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_workers_mac2phy_group
+ *
+ *  @param[in]   p_phy_ctx PHY context
+ *  @param[in]   p_demux   Received APIs split per PHY instance
+ *
+ *  @return none
+ *
+ *  @description
+ *  Takes PHY instances of the block from the translation pool until all of
+ *  them are taken. Run by the MAC2PHY thread and every pool worker.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_mac2phy_pool_translate(
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx,
+    p_nr5g_fapi_mac2phy_demux_t p_demux)
+{
+    uint32_t idx;
+
+    while ((idx = __atomic_fetch_add(&p_phy_ctx->mac2phy_pool.next_phy, 1,
+                __ATOMIC_RELAXED)) < p_demux->num_phy) {
+        nr5g_fapi_mac2phy_phy_api_handler(false, p_phy_ctx, p_demux,
+            p_demux->phy_order[idx]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_workers_mac2phy_group
+ *
+ *  @param[in]   p_phy_ctx PHY context
+ *  @param[in]   p_demux   Received APIs split per PHY instance
+ *
+ *  @return none
+ *
+ *  @description
+ *  Fans the PHY instances of the block out to the translation pool, helps
+ *  translating them and returns once every worker is done with the block.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_mac2phy_pool_run(
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx,
+    p_nr5g_fapi_mac2phy_demux_t p_demux)
+{
+    p_nr5g_fapi_mac2phy_pool_t p_pool = &p_phy_ctx->mac2phy_pool;
+    uint32_t job_seq = ++p_pool->job_seq;
+    uint8_t idx;
+
+    p_pool->p_demux = p_demux;
+    __atomic_store_n(&p_pool->next_phy, 0, __ATOMIC_RELAXED);
+    for (idx = 0; idx < p_pool->num_workers; idx++) {
+        __atomic_store_n(&p_pool->worker[idx].job_seq, job_seq,
+            __ATOMIC_RELEASE);
+    }
+
+    nr5g_fapi_mac2phy_pool_translate(p_phy_ctx, p_demux);
+
+    for (idx = 0; idx < p_pool->num_workers; idx++) {
+        while (__atomic_load_n(&p_pool->worker[idx].done_seq,
+                __ATOMIC_ACQUIRE) != job_seq) {
+            if (p_phy_ctx->process_exit)
+                return;
+            _mm_pause();
         }
+    }
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_workers_mac2phy_group
+ *
+ *  @param[in]   config    PHY context
+ *
+ *  @return none
+ *
+ *  @description
+ *  MAC2PHY translation pool worker. Polls for a new block published by the
+ *  MAC2PHY thread and translates PHY instances of it.
+ *
+**/
+//------------------------------------------------------------------------------
+void *nr5g_fapi_mac2phy_worker_thread_func(
+    void *config)
+{
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx = (p_nr5g_fapi_phy_ctx_t) config;
+    p_nr5g_fapi_mac2phy_pool_t p_pool = &p_phy_ctx->mac2phy_pool;
+    p_nr5g_fapi_mac2phy_worker_t p_worker;
+    uint32_t job_seq;
+    uint8_t worker_id;
+
+    worker_id = __atomic_fetch_add(&p_pool->num_started, 1, __ATOMIC_RELAXED);
+    p_worker = &p_pool->worker[worker_id];
 
-        if (phy_id > FAPI_MAX_PHY_INSTANCES) {
-            NR5G_FAPI_LOG(ERROR_LOG, ("[MAC2PHY]: Invalid Phy Id: %d\n",
-                    phy_id));
+    NR5G_FAPI_LOG(INFO_LOG, ("[MAC2PHY] Worker %d %s launched LWP:%ld on "
+            "Core: %d\n", worker_id, __func__, pthread_self(),
+            p_worker->core_id));
+
+    nr5g_fapi_init_thread(p_worker->core_id);
+
+    while (!p_phy_ctx->process_exit) {
+        job_seq = __atomic_load_n(&p_worker->job_seq, __ATOMIC_ACQUIRE);
+        if (job_seq == p_worker->done_seq) {
+            _mm_pause();
             continue;
         }
+        nr5g_fapi_mac2phy_pool_translate(p_phy_ctx, p_pool->p_demux);
+        __atomic_store_n(&p_worker->done_seq, job_seq, __ATOMIC_RELEASE);
+    }
+    pthread_exit(NULL);
+}
 
-        if (p_per_carr_api_list) {
-            p_fapi_msg = (fapi_msg_t *) (p_per_carr_api_list + 1);
-#ifdef DEBUG_MODE
-            if ((p_fapi_msg->msg_id != FAPI_VENDOR_EXT_UL_IQ_SAMPLES) &&
-                (p_fapi_msg->msg_id != FAPI_VENDOR_EXT_ADD_REMOVE_CORE)) {
-#endif
-                p_phy_instance = &p_phy_ctx->phy_instance[phy_id];
-                if (FAPI_STATE_IDLE == p_phy_instance->state) {
-                    if (p_fapi_msg->msg_id != FAPI_CONFIG_REQUEST) {
-                        NR5G_FAPI_LOG(ERROR_LOG,
-                            ("CONFIG.request is not received "
-                                "for %d PHY Instance\n", phy_id));
-                        continue;
-                    }
-                    p_phy_instance->phy_id = phy_id;
-                }
-#ifdef DEBUG_MODE
-            }
-#endif
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_workers_mac2phy_group
+ *
+ *  @param[in]   p_phy_ctx PHY context
+ *  @param[in]   p_demux   Received APIs split per PHY instance
+ *
+ *  @return none
+ *
+ *  @description
+ *  Runs the statistics actions the PHY instances of the block asked for.
+ *  The statistics are shared by all PHY instances, so they are only reset,
+ *  printed and started here, once no pool worker translates anymore.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_mac2phy_stats_events(
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx,
+    p_nr5g_fapi_mac2phy_demux_t p_demux)
+{
+    p_nr5g_fapi_phy_instance_t p_phy_instance;
+    uint8_t idx, stats_event = 0;
+
+    for (idx = 0; idx < p_demux->num_phy; idx++) {
+        p_phy_instance = &p_phy_ctx->phy_instance[p_demux->phy_order[idx]];
+        stats_event |= p_phy_instance->stats_event;
+        p_phy_instance->stats_event = 0;
+    }
 
-            nr5g_fapi_mac2phy_api_processing_handler(is_urllc, p_phy_instance,
-                p_per_carr_api_list);
-            p_per_carr_api_list = NULL;
+    if (stats_event & NR5G_FAPI_STATS_EVENT_INIT)
+        nr5g_fapi_statistic_info_init();
+    if (stats_event & NR5G_FAPI_STATS_EVENT_PRINT) {
+        nr5g_fapi_statistic_info_print();
+        nr5g_fapi_fapi2phy_rx_data_zbc_print_stats();
+        if (g_statistic_start_flag == 1)
+            g_statistic_start_flag = 0;
+    }
+    if ((stats_event & NR5G_FAPI_STATS_EVENT_START) &&
+        g_statistic_start_flag == 0)
+        g_statistic_start_flag = 1;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_framework_workers_mac2phy_group
+ *
+ *  @param[in]   is_urllc  URLLC or regular message block
+ *  @param[in]   config    PHY context
+ *  @param[in]   p_demux   Received APIs split per PHY instance
+ *
+ *  @return none
+ *
+ *  @description
+ *  Processes the API list of every PHY instance of the block. Regular blocks
+ *  with more than one PHY instance are translated by the MAC2PHY pool when
+ *  it is configured, otherwise the PHY instances are processed in the order
+ *  they were received.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_mac2phy_api_demux_handler(
+    bool is_urllc,
+    void *config,
+    p_nr5g_fapi_mac2phy_demux_t p_demux)
+{
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx = NULL;
+    uint8_t idx;
+    uint64_t start_tick = __rdtsc();
+
+    p_phy_ctx = (p_nr5g_fapi_phy_ctx_t) config;
+    if (p_demux->num_dropped) {
+        NR5G_FAPI_LOG(ERROR_LOG, ("[MAC2PHY] %d APIs without message header",
+                p_demux->num_dropped));
+    }
+
+    if (!is_urllc && p_phy_ctx->mac2phy_pool.num_workers &&
+        p_demux->num_phy > 1) {
+        nr5g_fapi_mac2phy_pool_run(p_phy_ctx, p_demux);
+    } else {
+        for (idx = 0; idx < p_demux->num_phy; idx++) {
+            nr5g_fapi_mac2phy_phy_api_handler(is_urllc, p_phy_ctx, p_demux,
+                p_demux->phy_order[idx]);
         }
     }
+    nr5g_fapi_mac2phy_stats_events(p_phy_ctx, p_demux);
     tick_total_parse_per_tti_dl += __rdtsc() - start_tick;
 }
 
@@ -192,6 +367,8 @@ void nr5g_fapi_mac2phy_api_processing_handler(
     p_fapi_api_queue_elem_t p_tx_data_pdu_list_tail = NULL;
     fapi_msg_t *p_fapi_msg = NULL;
     fapi_vendor_msg_t *p_vendor_msg = NULL;
+    nr5g_fapi_latency_msg_t lat_msg;
+    uint64_t msg_tick;
 
     // Get vendor body if present
     p_prev_elm = p_vendor_elm = p_msg_list;
@@ -227,6 +404,10 @@ void nr5g_fapi_mac2phy_api_processing_handler(
             } else {
                 p_tx_data_pdu_list_tail = p_tx_data_pdu_list = p_curr_elm;
             }
+        } else if (msg_type == FAPI_VENDOR_EXT_RX_DATA_RELEASE_REQUEST) {
+            // released even if the API ordering check drops the list
+            nr5g_fapi_fapi2phy_rx_data_zbc_release(
+                (fapi_vendor_ext_rx_data_release_req_t *) (p_curr_elm + 1));
         } else {
         }
         p_curr_elm = p_curr_elm->p_next;
@@ -244,20 +425,25 @@ void nr5g_fapi_mac2phy_api_processing_handler(
     // Walk through the API list
     while (p_msg_list) {
         p_fapi_msg = (fapi_msg_t *) (p_msg_list + 1);
+        lat_msg = NR5G_FAPI_LAT_MSG_MAX;
+        msg_tick = __rdtsc();
         switch (p_fapi_msg->msg_id) {
                 /*  P5 Vendor Message Processing */
 #ifdef DEBUG_MODE
             case FAPI_VENDOR_EXT_ADD_REMOVE_CORE:
                 nr5g_fapi_add_remove_core_message(is_urllc,
+                    p_phy_instance->phy_id,
                     (fapi_vendor_ext_add_remove_core_msg_t *) p_fapi_msg);
                 break;
             case FAPI_VENDOR_EXT_UL_IQ_SAMPLES:
                 nr5g_fapi_ul_iq_samples_request(is_urllc,
+                    p_phy_instance->phy_id,
                     (fapi_vendor_ext_iq_samples_req_t *) p_fapi_msg);
                 break;
 
             case FAPI_VENDOR_EXT_DL_IQ_SAMPLES:
                 nr5g_fapi_dl_iq_samples_request(is_urllc,
+                    p_phy_instance->phy_id,
                     (fapi_vendor_ext_iq_samples_req_t *) p_fapi_msg);
                 break;
 
@@ -266,9 +452,7 @@ void nr5g_fapi_mac2phy_api_processing_handler(
                 {
                     nr5g_fapi_shutdown_request(is_urllc, p_phy_instance,
                         (fapi_vendor_ext_shutdown_req_t *) p_fapi_msg);
-                    nr5g_fapi_statistic_info_print();
-                    if (g_statistic_start_flag == 1)
-                        g_statistic_start_flag = 0;
+                    p_phy_instance->stats_event |= NR5G_FAPI_STATS_EVENT_PRINT;
                 }
                 break;
 
@@ -286,7 +470,8 @@ void nr5g_fapi_mac2phy_api_processing_handler(
                     nr5g_fapi_config_request(is_urllc, p_phy_instance,
                         (fapi_config_req_t *)
                         p_fapi_msg, p_vendor_msg);
-                    nr5g_fapi_statistic_info_init();
+                    p_phy_instance->stats_event |= NR5G_FAPI_STATS_EVENT_INIT;
+                    lat_msg = NR5G_FAPI_LAT_CONFIG_REQ;
                 }
 
                 break;
@@ -294,15 +479,15 @@ void nr5g_fapi_mac2phy_api_processing_handler(
             case FAPI_START_REQUEST:
                 nr5g_fapi_start_request(is_urllc, p_phy_instance, (fapi_start_req_t *)
                     p_fapi_msg, p_vendor_msg);
+                lat_msg = NR5G_FAPI_LAT_START_REQ;
                 break;
 
             case FAPI_STOP_REQUEST:
                 {
                     nr5g_fapi_stop_request(is_urllc, p_phy_instance, (fapi_stop_req_t *)
                         p_fapi_msg, p_vendor_msg);
-                    nr5g_fapi_statistic_info_print();
-                    if (g_statistic_start_flag == 1)
-                        g_statistic_start_flag = 0;
+                    lat_msg = NR5G_FAPI_LAT_STOP_REQ;
+                    p_phy_instance->stats_event |= NR5G_FAPI_STATS_EVENT_PRINT;
                 }
 
                 break;
@@ -312,25 +497,32 @@ void nr5g_fapi_mac2phy_api_processing_handler(
                     nr5g_fapi_dl_tti_request(is_urllc, p_phy_instance,
                         (fapi_dl_tti_req_t *)
                         p_fapi_msg, p_vendor_msg);
-                    if (g_statistic_start_flag == 0)
-                        g_statistic_start_flag = 1;
+                    lat_msg = NR5G_FAPI_LAT_DL_TTI_REQ;
+                    p_phy_instance->stats_event |= NR5G_FAPI_STATS_EVENT_START;
                 }
                 break;
 
             case FAPI_UL_TTI_REQUEST:
                 nr5g_fapi_ul_tti_request(is_urllc, p_phy_instance, (fapi_ul_tti_req_t *)
                     p_fapi_msg, p_vendor_msg);
+                lat_msg = NR5G_FAPI_LAT_UL_TTI_REQ;
                 break;
 
             case FAPI_UL_DCI_REQUEST:
                 nr5g_fapi_ul_dci_request(is_urllc, p_phy_instance, (fapi_ul_dci_req_t *)
                     p_fapi_msg, p_vendor_msg);
+                lat_msg = NR5G_FAPI_LAT_UL_DCI_REQ;
+                break;
+
+            case FAPI_VENDOR_EXT_RX_DATA_RELEASE_REQUEST:
+                // released before the API ordering check
                 break;
 
             case FAPI_TX_DATA_REQUEST:
                 nr5g_fapi_tx_data_request(is_urllc, p_phy_instance, (fapi_tx_data_req_t *)
                     p_fapi_msg, p_vendor_msg);
                 p_msg_list->p_tx_data_elm_list = NULL;
+                lat_msg = NR5G_FAPI_LAT_TX_DATA_REQ;
                 break;
 
             default:
@@ -338,6 +530,10 @@ void nr5g_fapi_mac2phy_api_processing_handler(
                     p_fapi_msg->msg_id));
                 break;
         }
+        if (lat_msg != NR5G_FAPI_LAT_MSG_MAX) {
+            nr5g_fapi_latency_record_phy(p_phy_instance, is_urllc, lat_msg,
+                __rdtsc() - msg_tick);
+        }
         p_msg_list = p_msg_list->p_next;
     }
 }
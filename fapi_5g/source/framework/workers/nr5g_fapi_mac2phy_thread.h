@@ -27,6 +27,11 @@ void nr5g_fapi_mac2phy_api_recv_handler(
     void *config,
     p_fapi_api_queue_elem_t p_msg_list);
 
+void nr5g_fapi_mac2phy_api_demux_handler(
+    bool is_urllc,
+    void *config,
+    p_nr5g_fapi_mac2phy_demux_t p_demux);
+
 void nr5g_fapi_mac2phy_api_processing_handler(
     bool is_urllc,
     p_nr5g_fapi_phy_instance_t p_phy_instance,
@@ -22,6 +22,7 @@
 #include "nr5g_fapi_fapi2mac_p5_proc.h"
 #include "nr5g_fapi_fapi2mac_p7_proc.h"
 #include "nr5g_fapi_log.h"
+#include "nr5g_fapi_stats.h"
 //------------------------------------------------------------------------------
 /** @ingroup nr5g_fapi_source_framework_workers_phy2mac_group
  *
@@ -79,6 +80,10 @@ void nr5g_fapi_phy2mac_api_recv_handler(
     PL1L2MessageHdr p_msg_header = NULL;
     uint64_t start_tick = __rdtsc();
     fapi_api_stored_vendor_queue_elems vendor_extension_elems;
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx = (p_nr5g_fapi_phy_ctx_t) config;
+    nr5g_fapi_latency_msg_t lat_msg;
+    uint64_t msg_tick;
+    uint8_t phy_id = 0;
     NR5G_FAPI_LOG(TRACE_LOG, ("[PHY2MAC] %s:", __func__));
 
     memset(&vendor_extension_elems, 0, sizeof(vendor_extension_elems));
@@ -87,6 +92,8 @@ void nr5g_fapi_phy2mac_api_recv_handler(
     p_curr_msg = (PMAC2PHY_QUEUE_EL) p_msg_list;
     while (p_curr_msg) {
         p_msg_header = (PL1L2MessageHdr) (p_curr_msg + 1);
+        lat_msg = NR5G_FAPI_LAT_MSG_MAX;
+        msg_tick = __rdtsc();
         switch (p_msg_header->nMessageType) {
                 /*  P5 Vendor Message Processing */
 #ifdef DEBUG_MODE
@@ -140,6 +147,9 @@ void nr5g_fapi_phy2mac_api_recv_handler(
                         (p_nr5g_fapi_phy_ctx_t) config,
                         &vendor_extension_elems,
                         (PRXULSCHIndicationStruct) p_msg_header);
+                    lat_msg = NR5G_FAPI_LAT_RX_DATA_IND;
+                    phy_id = ((PRXULSCHIndicationStruct)
+                        p_msg_header)->sSFN_Slot.nCarrierIdx;
                 }
                 break;
 
@@ -148,6 +158,9 @@ void nr5g_fapi_phy2mac_api_recv_handler(
                     nr5g_fapi_rx_data_uci_indication(is_urllc,
                         (p_nr5g_fapi_phy_ctx_t) config,
                         (PRXULSCHUCIIndicationStruct) p_msg_header);
+                    lat_msg = NR5G_FAPI_LAT_RX_DATA_UCI_IND;
+                    phy_id = ((PRXULSCHUCIIndicationStruct)
+                        p_msg_header)->sSFN_Slot.nCarrierIdx;
                 }
                 break;
 
@@ -157,6 +170,9 @@ void nr5g_fapi_phy2mac_api_recv_handler(
                         (p_nr5g_fapi_phy_ctx_t) config,
                         &vendor_extension_elems,
                         (PCRCIndicationStruct) p_msg_header);
+                    lat_msg = NR5G_FAPI_LAT_CRC_IND;
+                    phy_id = ((PCRCIndicationStruct)
+                        p_msg_header)->sSFN_Slot.nCarrierIdx;
                 }
                 break;
 
@@ -166,6 +182,9 @@ void nr5g_fapi_phy2mac_api_recv_handler(
                         (p_nr5g_fapi_phy_ctx_t) config,
                         &vendor_extension_elems,
                         (PRXUCIIndicationStruct) p_msg_header);
+                    lat_msg = NR5G_FAPI_LAT_UCI_IND;
+                    phy_id = ((PRXUCIIndicationStruct)
+                        p_msg_header)->sSFN_Slot.nCarrierIdx;
                 }
                 break;
 
@@ -174,6 +193,9 @@ void nr5g_fapi_phy2mac_api_recv_handler(
                     nr5g_fapi_rach_indication(is_urllc,
                         (p_nr5g_fapi_phy_ctx_t) config,
                         (PRXRACHIndicationStruct) p_msg_header);
+                    lat_msg = NR5G_FAPI_LAT_RACH_IND;
+                    phy_id = ((PRXRACHIndicationStruct)
+                        p_msg_header)->sSFN_Slot.nCarrierIdx;
                 }
                 break;
 
@@ -183,6 +205,9 @@ void nr5g_fapi_phy2mac_api_recv_handler(
                         (p_nr5g_fapi_phy_ctx_t) config,
                         &vendor_extension_elems,
                         (PRXSRSIndicationStruct) p_msg_header);
+                    lat_msg = NR5G_FAPI_LAT_SRS_IND;
+                    phy_id = ((PRXSRSIndicationStruct)
+                        p_msg_header)->sSFN_Slot.nCarrierIdx;
                 }
                 break;
 
@@ -192,6 +217,9 @@ void nr5g_fapi_phy2mac_api_recv_handler(
                         (p_nr5g_fapi_phy_ctx_t) config,
                         &vendor_extension_elems,
                         (PSlotIndicationStruct) p_msg_header);
+                    lat_msg = NR5G_FAPI_LAT_SLOT_IND;
+                    phy_id = ((PSlotIndicationStruct)
+                        p_msg_header)->sSFN_Slot.nCarrierIdx;
                     nr5g_fapi_statistic_info_set_all();
                 }
                 break;
@@ -206,6 +234,11 @@ void nr5g_fapi_phy2mac_api_recv_handler(
                     p_msg_header->nMessageType));
                 break;
         }
+        if ((lat_msg != NR5G_FAPI_LAT_MSG_MAX) &&
+            (phy_id < FAPI_MAX_PHY_INSTANCES)) {
+            nr5g_fapi_latency_record_phy(&p_phy_ctx->phy_instance[phy_id],
+                is_urllc, lat_msg, __rdtsc() - msg_tick);
+        }
         p_curr_msg = p_curr_msg->pNext;
     }
     nr5g_fapi_proc_vendor_p7_msgs_move_to_api_list(is_urllc, &vendor_extension_elems);
@@ -27,6 +27,7 @@ void *nr5g_fapi_urllc_mac2phy_thread_func(
 {
     p_nr5g_fapi_phy_ctx_t p_phy_ctx = (p_nr5g_fapi_phy_ctx_t) config;
     uint64_t start_tick;
+    void *p_list_elem;
 
     NR5G_FAPI_LOG(INFO_LOG, ("[URLLC_MAC2PHY] Thread %s launched LWP:%ld on "
             "Core: %d\n", __func__, pthread_self(),
@@ -35,22 +36,17 @@ void *nr5g_fapi_urllc_mac2phy_thread_func(
     nr5g_fapi_init_thread(p_phy_ctx->urllc_mac2phy_worker_core_id);
 
     while (!p_phy_ctx->process_exit) {
-        sem_wait(&p_phy_ctx->urllc_mac2phy_params.urllc_sem_process);
-        pthread_mutex_lock(&p_phy_ctx->urllc_mac2phy_params.lock);
-        if (p_phy_ctx->urllc_mac2phy_params.p_urllc_list_elem)
+        p_list_elem = nr5g_fapi_urllc_queue_wait(p_phy_ctx,
+            &p_phy_ctx->urllc_mac2phy_params);
+        if (p_list_elem)
         {
             nr5g_fapi_mac2phy_api_recv_handler(true, config, 
-                    (p_fapi_api_queue_elem_t) p_phy_ctx->urllc_mac2phy_params.
-                    p_urllc_list_elem);
+                    (p_fapi_api_queue_elem_t) p_list_elem);
             start_tick = __rdtsc();
             NR5G_FAPI_LOG(TRACE_LOG, ("[MAC2PHY] Send to PHY urllc.."));
             nr5g_fapi_fapi2phy_send_api_list(true);
             tick_total_wls_send_per_tti_dl += __rdtsc() - start_tick;
-
-            p_phy_ctx->urllc_mac2phy_params.p_urllc_list_elem = NULL;
         }
-        pthread_mutex_unlock(&p_phy_ctx->urllc_mac2phy_params.lock);
-        sem_post(&p_phy_ctx->urllc_mac2phy_params.urllc_sem_done);
     }
  
     pthread_exit(NULL);
@@ -21,11 +21,13 @@
 #include "nr5g_fapi_mac2phy_thread.h"
 #include "nr5g_fapi_fapi2mac_api.h"
 #include "nr5g_fapi_fapi2phy_api.h"
+#include "nr5g_fapi_fapi2phy_wls.h"
 
 void *nr5g_fapi_urllc_phy2mac_thread_func(
     void *config)
 {
     p_nr5g_fapi_phy_ctx_t p_phy_ctx = (p_nr5g_fapi_phy_ctx_t) config;
+    void *p_list_elem;
 
     NR5G_FAPI_LOG(INFO_LOG, ("[URLLC_PHY2MAC] Thread %s launched LWP:%ld on "
             "Core: %d\n", __func__, pthread_self(),
@@ -34,19 +36,17 @@ void *nr5g_fapi_urllc_phy2mac_thread_func(
     nr5g_fapi_init_thread(p_phy_ctx->urllc_phy2mac_worker_core_id);
 
     while (!p_phy_ctx->process_exit) {
-        sem_wait(&p_phy_ctx->urllc_phy2mac_params.urllc_sem_process);
-        pthread_mutex_lock(&p_phy_ctx->urllc_phy2mac_params.lock);
-        if (p_phy_ctx->urllc_phy2mac_params.p_urllc_list_elem)
+        p_list_elem = nr5g_fapi_urllc_queue_wait(p_phy_ctx,
+            &p_phy_ctx->urllc_phy2mac_params);
+        if (p_list_elem)
         {
             nr5g_fapi_phy2mac_api_recv_handler(true, config, 
-                (PMAC2PHY_QUEUE_EL) p_phy_ctx->urllc_phy2mac_params.
-                p_urllc_list_elem);
+                (PMAC2PHY_QUEUE_EL) p_list_elem);
             nr5g_fapi_fapi2mac_send_api_list(true);
-
-            p_phy_ctx->urllc_phy2mac_params.p_urllc_list_elem = NULL;
+            // The list is owned by this thread until now
+            nr5g_fapi_transfer_to_free_recv_list_urllc(
+                (PMAC2PHY_QUEUE_EL) p_list_elem);
         }
-        pthread_mutex_unlock(&p_phy_ctx->urllc_phy2mac_params.lock);
-        sem_post(&p_phy_ctx->urllc_phy2mac_params.urllc_sem_done);
     }
  
     pthread_exit(NULL);
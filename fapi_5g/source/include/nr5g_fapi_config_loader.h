@@ -28,9 +28,11 @@
 #include "nr5g_fapi_common_types.h"
 #include "nr5g_fapi_dpdk.h"
 #include "nr5g_fapi_log.h"
+#include "nr5g_fapi_recorder.h"
 
 #define NR5G_FAPI_DEVICE_NAME_LEN   512
 #define NR5G_FAPI_MEMORY_ZONE_NAME_LEN  512
+#define NR5G_FAPI_MAX_MAC2PHY_WORKERS   8
 
 enum {
     DPDK_IOVA_PA_MODE = 0,
@@ -52,6 +54,8 @@ typedef struct _nr5g_fapi_config_worker_cfg {
 typedef struct _nr5g_fapi_config_wls_cfg {
     char device_name[NR5G_FAPI_DEVICE_NAME_LEN];
     uint64_t shmem_size;
+    bool rx_data_zbc;           // L2 releases RX_DATA.indication payloads
+    uint32_t rx_data_zbc_timeout;   // UL slots before unreleased payloads are reclaimed
 } nr5g_fapi_config_wls_cfg_t;
 
 typedef struct nr5g_fapi_config_dpdk_cfg_t {
@@ -61,6 +65,8 @@ typedef struct nr5g_fapi_config_dpdk_cfg_t {
 
 typedef struct _nr5g_fapi_config_log_cfg {
     nr5g_fapi_log_types_t level;
+    bool async;                 // format and write logs on a logger thread
+    uint8_t core_id;            // core of the logger thread
 } nr5g_fapi_config_log_cfg_t;
 
 typedef struct _nr5g_fapi_thread_params_t {
@@ -74,10 +80,16 @@ typedef struct _nr5g_fapi_cfg {
     nr5g_fapi_thread_params_t phy2mac_thread_params;
     nr5g_fapi_thread_params_t urllc_mac2phy_thread_params;
     nr5g_fapi_thread_params_t urllc_phy2mac_thread_params;
+    uint8_t num_mac2phy_workers;    // 0: translate all PHYs on MAC2PHY thread
+    nr5g_fapi_thread_params_t
+        mac2phy_worker_thread_params[NR5G_FAPI_MAX_MAC2PHY_WORKERS];
     bool is_urllc_enabled;
+    uint32_t urllc_wait_mode;   // nr5g_fapi_urllc_wait_mode_t
+    uint32_t urllc_spin_count;  // polls before sleeping in adaptive mode
     nr5g_fapi_config_wls_cfg_t wls;
     nr5g_fapi_config_log_cfg_t logger;
     nr5g_fapi_config_dpdk_cft_t dpdk;
+    nr5g_fapi_config_recorder_cfg_t recorder;
 } nr5g_fapi_cfg_t,
 *p_nr5g_fapi_cfg_t;
 
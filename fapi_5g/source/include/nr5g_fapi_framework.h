@@ -26,6 +26,7 @@
 
 #include <fcntl.h>
 #include "fapi_interface.h"
+#include "fapi_vendor_extension.h"
 #include "nr5g_fapi_log.h"
 #include "nr5g_fapi_internal.h"
 #include "nr5g_fapi_std.h"
@@ -42,6 +43,36 @@ typedef struct _nr5g_fapi_phy_config {
 } nr5g_fapi_phy_config_t,
 *pnr5g_fapi_phy_config_t;
 
+#define NR5G_FAPI_MAX_RBG_PER_BWP       19  // 18 RBGs and a partial one
+#define NR5G_FAPI_MAX_RBG_LAYOUTS       2   // DL and UL carrier bandwidth
+
+// Resource block bitmap window of one RBG and its nRBGIndex bits
+typedef struct _nr5g_fapi_rbg_entry {
+    uint8_t byte;               // first byte of the 16 bit rbBitmap window
+    uint8_t shift;
+    uint16_t mask;              // RBs of the RBG inside the BWP
+    uint32_t msb_bit;           // PDSCH nRBGIndex bit
+    uint32_t lsb_bit;           // PUSCH nRBGIndex bit
+} nr5g_fapi_rbg_entry_t;
+
+// rbBitmap to nRBGIndex mapping of a bandwidth part
+typedef struct _nr5g_fapi_rbg_layout {
+    uint16_t bwp_start;
+    uint16_t bwp_size;
+    uint8_t rbg_size;
+    uint8_t num_rbg;
+    nr5g_fapi_rbg_entry_t rbg[NR5G_FAPI_MAX_RBG_PER_BWP];
+} nr5g_fapi_rbg_layout_t,
+*p_nr5g_fapi_rbg_layout_t;
+
+// Cell static translation tables, built at CONFIG.request and only read by
+// the DL_TTI/UL_TTI translation afterwards
+typedef struct _nr5g_fapi_cell_tables {
+    uint8_t num_rbg_layouts;
+    nr5g_fapi_rbg_layout_t rbg_layout[NR5G_FAPI_MAX_RBG_LAYOUTS];
+} nr5g_fapi_cell_tables_t,
+*p_nr5g_fapi_cell_tables_t;
+
 typedef struct _nr5g_fapi_rach_info {
     uint16_t phy_cell_id;
 } nr5g_fapi_rach_info_t;
@@ -168,31 +199,171 @@ typedef struct _nr5g_iapi_stats_info_t {
     uint64_t iapi_rach_preambles;
 } nr5g_iapi_stats_info_t;
 
+// Message types with a latency histogram
+typedef enum _nr5g_fapi_latency_msg_t {
+    NR5G_FAPI_LAT_CONFIG_REQ = 0,
+    NR5G_FAPI_LAT_START_REQ,
+    NR5G_FAPI_LAT_STOP_REQ,
+    NR5G_FAPI_LAT_DL_TTI_REQ,
+    NR5G_FAPI_LAT_UL_TTI_REQ,
+    NR5G_FAPI_LAT_UL_DCI_REQ,
+    NR5G_FAPI_LAT_TX_DATA_REQ,
+    NR5G_FAPI_LAT_SLOT_IND,
+    NR5G_FAPI_LAT_CRC_IND,
+    NR5G_FAPI_LAT_RX_DATA_IND,
+    NR5G_FAPI_LAT_RX_DATA_UCI_IND,
+    NR5G_FAPI_LAT_UCI_IND,
+    NR5G_FAPI_LAT_SRS_IND,
+    NR5G_FAPI_LAT_RACH_IND,
+    NR5G_FAPI_LAT_MSG_MAX
+} nr5g_fapi_latency_msg_t;
+
+// Log-scale buckets: 8 linear sub-buckets per power of two, ~12.5% error
+#define NR5G_FAPI_LAT_SUB_BUCKET_BITS               3
+#define NR5G_FAPI_LAT_NUM_BUCKETS                   256
+
+// Processing time histogram of one message type, in TSC cycles
+typedef struct _nr5g_fapi_latency_hist_t {
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    uint32_t bucket[NR5G_FAPI_LAT_NUM_BUCKETS];
+} nr5g_fapi_latency_hist_t;
+
 typedef struct _nr5g_fapi_stats_t {
     nr5g_fapi_stats_info_t fapi_stats;
     nr5g_iapi_stats_info_t iapi_stats;
+    // Indexed by is_urllc, every histogram has a single writer thread
+    nr5g_fapi_latency_hist_t latency[FAPI_MAX_SLOT_INFO_URLLC]
+        [NR5G_FAPI_LAT_MSG_MAX];
 } nr5g_fapi_stats_t;
 
+// Statistics actions asked for while translating a PHY instance. The
+// MAC2PHY thread runs them once the whole block is translated.
+#define NR5G_FAPI_STATS_EVENT_INIT                  (1U << 0)   // CONFIG.request
+#define NR5G_FAPI_STATS_EVENT_PRINT                 (1U << 1)   // STOP.request, shutdown
+#define NR5G_FAPI_STATS_EVENT_START                 (1U << 2)   // DL_TTI.request
+
 // FAPI phy instance structure
 typedef struct _nr5g_fapi_phy_instance {
     uint8_t phy_id;
     uint8_t shutdown_retries;
     uint32_t shutdown_test_type;
+    uint8_t stats_event;        // NR5G_FAPI_STATS_EVENT_* of the block
     fapi_states_t state;        // FAPI state
     nr5g_fapi_phy_config_t phy_config;  // place holder to store,
     // parameters from config request
+    nr5g_fapi_cell_tables_t cell_tables;
     nr5g_fapi_stats_t stats;
     nr5g_fapi_ul_slot_info_t ul_slot_info[FAPI_MAX_SLOT_INFO_URLLC][MAX_UL_SLOT_INFO_COUNT][MAX_UL_SYMBOL_INFO_COUNT];
 } nr5g_fapi_phy_instance_t,
 *p_nr5g_fapi_phy_instance_t;
 
+#define NR5G_FAPI_URLLC_QUEUE_SIZE                  16  // power of 2
+#define NR5G_FAPI_URLLC_QUEUE_MASK                  (NR5G_FAPI_URLLC_QUEUE_SIZE - 1)
+#define NR5G_FAPI_CACHE_LINE_SIZE                   64
+
+// URLLC worker wait policy when its queue is empty, adaptive by default
+typedef enum _nr5g_fapi_urllc_wait_mode {
+    NR5G_FAPI_URLLC_WAIT_POLL = 0,  // busy poll the queue
+    NR5G_FAPI_URLLC_WAIT_ADAPTIVE,  // poll spin_count times, then sleep
+} nr5g_fapi_urllc_wait_mode_t;
+
+typedef struct _nr5g_fapi_urllc_queue_entry {
+    void *p_list_elem;
+    uint64_t enq_tick;          // tsc when the producer queued the list
+    uint32_t generation;        // producer generation when queued
+} nr5g_fapi_urllc_queue_entry_t;
+
+// Handoff statistics, updated by the URLLC worker only
+typedef struct _nr5g_fapi_urllc_queue_stats {
+    uint64_t num_handoffs;
+    uint64_t min_latency;       // enqueue to dequeue, in tsc ticks
+    uint64_t max_latency;
+    uint64_t total_latency;
+    uint32_t max_depth;
+    uint64_t num_stale;         // lists older than max_age, not processed
+} nr5g_fapi_urllc_queue_stats_t;
+
+// Single producer single consumer mailbox between the MAC2PHY/PHY2MAC
+// thread and its URLLC worker. The producer only writes head and the
+// consumer only writes tail, so neither side ever blocks the other.
+// generation counts the blocks the producer received from its peer. When
+// the peer frees its blocks on its own schedule, max_age is the number of
+// blocks a queued list stays valid and older lists are skipped unread.
 typedef struct _nr5g_fapi_urllc_thread_params_t {
-    void *p_urllc_list_elem;
-    pthread_mutex_t lock;
-    sem_t urllc_sem_process;
-    sem_t urllc_sem_done;
+    volatile uint32_t head __attribute__ ((aligned(NR5G_FAPI_CACHE_LINE_SIZE)));
+    volatile uint32_t generation;
+    uint64_t num_queue_full;    // lists not queued, queue was full
+    volatile uint32_t tail __attribute__ ((aligned(NR5G_FAPI_CACHE_LINE_SIZE)));
+    uint32_t wait_mode;
+    uint32_t spin_count;
+    uint32_t max_age;           // 0 when the consumer frees the lists
+    nr5g_fapi_urllc_queue_stats_t stats;
+    nr5g_fapi_urllc_queue_entry_t entry[NR5G_FAPI_URLLC_QUEUE_SIZE]
+        __attribute__ ((aligned(NR5G_FAPI_CACHE_LINE_SIZE)));
 } nr5g_fapi_urllc_thread_params_t;
 
+// API list with tail pointer, so appending is O(1)
+typedef struct _nr5g_fapi_api_list {
+    p_fapi_api_queue_elem_t p_head;
+    p_fapi_api_queue_elem_t p_tail;
+    uint32_t num_apis;
+} nr5g_fapi_api_list_t,
+*p_nr5g_fapi_api_list_t;
+
+#define NR5G_FAPI_DEMUX_NO_PHY                      0xFF
+
+// MAC to PHY APIs of one message block split per PHY instance. Filled one
+// element at a time while the block is received, the vendor message header
+// (FAPI_VENDOR_MSG_HEADER_IND) selects the PHY instance of the APIs after it.
+typedef struct _nr5g_fapi_mac2phy_demux {
+    nr5g_fapi_api_list_t phy_api_list[FAPI_MAX_PHY_INSTANCES];
+    uint8_t phy_order[FAPI_MAX_PHY_INSTANCES];  // phy ids in arrival order
+    uint32_t phy_mask;          // bit per phy id present in phy_order
+    uint8_t num_phy;
+    uint8_t curr_phy_id;        // phy id of the last message header
+    uint32_t num_dropped;       // APIs without a valid message header
+} nr5g_fapi_mac2phy_demux_t,
+*p_nr5g_fapi_mac2phy_demux_t;
+
+static inline void nr5g_fapi_api_list_append(
+    p_nr5g_fapi_api_list_t p_list,
+    p_fapi_api_queue_elem_t p_elem)
+{
+    p_elem->p_next = NULL;
+    if (p_list->p_head) {
+        p_list->p_tail->p_next = p_elem;
+    } else {
+        p_list->p_head = p_elem;
+    }
+    p_list->p_tail = p_elem;
+    p_list->num_apis++;
+}
+
+// One translation worker of the MAC2PHY pool
+typedef struct _nr5g_fapi_mac2phy_worker {
+    volatile uint32_t job_seq __attribute__ ((aligned(NR5G_FAPI_CACHE_LINE_SIZE)));
+    volatile uint32_t done_seq; // job_seq of the last block translated
+    uint8_t core_id;
+} nr5g_fapi_mac2phy_worker_t,
+*p_nr5g_fapi_mac2phy_worker_t;
+
+// Pool translating the PHY instances of one MAC2PHY block in parallel. The
+// MAC2PHY thread publishes the block with a new job_seq, then it and the
+// workers take PHY instances from next_phy until none is left. The MAC2PHY
+// thread waits for all workers before the single WLS send of the block.
+typedef struct _nr5g_fapi_mac2phy_pool {
+    uint8_t num_workers;
+    uint8_t num_started;
+    uint32_t job_seq;
+    p_nr5g_fapi_mac2phy_demux_t p_demux;
+    volatile uint32_t next_phy __attribute__ ((aligned(NR5G_FAPI_CACHE_LINE_SIZE)));
+    nr5g_fapi_mac2phy_worker_t worker[NR5G_FAPI_MAX_MAC2PHY_WORKERS];
+} nr5g_fapi_mac2phy_pool_t,
+*p_nr5g_fapi_mac2phy_pool_t;
+
 // Phy Context
 typedef struct _nr5g_fapi_phy_context {
     uint8_t num_phy_instance;
@@ -203,6 +374,7 @@ typedef struct _nr5g_fapi_phy_context {
     nr5g_fapi_urllc_thread_params_t urllc_mac2phy_params;
     nr5g_fapi_urllc_thread_params_t urllc_phy2mac_params;
     bool is_urllc_enabled;
+    nr5g_fapi_mac2phy_pool_t mac2phy_pool;
     volatile uint64_t process_exit;
     nr5g_fapi_phy_instance_t phy_instance[FAPI_MAX_PHY_INSTANCES];
 } nr5g_fapi_phy_ctx_t,
@@ -225,6 +397,8 @@ void *nr5g_fapi_phy2mac_thread_func(
     void *config);
 void *nr5g_fapi_mac2phy_thread_func(
     void *config);
+void *nr5g_fapi_mac2phy_worker_thread_func(
+    void *config);
 void *nr5g_fapi_urllc_mac2phy_thread_func(
     void *config);
 void *nr5g_fapi_urllc_phy2mac_thread_func(
@@ -241,9 +415,34 @@ void nr5g_fapi_set_ul_slot_info(
     uint8_t symbol_no,
     nr5g_fapi_ul_slot_info_t * p_ul_slot_info);
 void nr5g_fapi_init_thread(uint8_t worker_core_id);
-void nr5g_fapi_urllc_thread_callback(
+uint8_t nr5g_fapi_urllc_queue_init(
+    nr5g_fapi_urllc_thread_params_t* urllc_thread_params,
+    uint32_t wait_mode,
+    uint32_t spin_count,
+    uint32_t max_age);
+uint8_t nr5g_fapi_urllc_thread_callback(
     void *p_list_elem,
     nr5g_fapi_urllc_thread_params_t* urllc_params);
+// Producer side, one more block received from the peer
+static inline void nr5g_fapi_urllc_queue_tick(
+    nr5g_fapi_urllc_thread_params_t* urllc_params)
+{
+    __atomic_store_n(&urllc_params->generation,
+        urllc_params->generation + 1, __ATOMIC_RELEASE);
+}
+void *nr5g_fapi_urllc_queue_wait(
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx,
+    nr5g_fapi_urllc_thread_params_t* urllc_params);
+void nr5g_fapi_urllc_print_stats(
+    );
 void nr5g_fapi_clean(
     p_nr5g_fapi_phy_instance_t p_phy_instance);
+void nr5g_fapi_mac2phy_demux_init(
+    p_nr5g_fapi_mac2phy_demux_t p_demux);
+void nr5g_fapi_mac2phy_demux_add(
+    p_nr5g_fapi_mac2phy_demux_t p_demux,
+    p_fapi_api_queue_elem_t p_elem);
+uint32_t nr5g_fapi_mac2phy_demux_list(
+    p_nr5g_fapi_mac2phy_demux_t p_demux,
+    p_fapi_api_queue_elem_t p_msg_list);
 #endif                          // _NR5G_FAPI_FRAMEWORK_H_
@@ -25,8 +25,11 @@
 #define NR5G_FAPI_LOG_H_
 
 #include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 #define NR5G_FAPI_STATS_FNAME "FapiStats.txt"
+#define NR5G_FAPI_LATENCY_FNAME "FapiLatency.json"
 
 
 #ifdef __cplusplus
@@ -52,20 +55,49 @@ void nr5g_fapi_set_log_level(
 nr5g_fapi_log_types_t nr5g_fapi_get_log_level(
     );
 
+// Levels above NR5G_FAPI_LOG_COMPILE_LEVEL are compiled out, ERROR_LOG is
+// always kept. Set with FAPI_LOG_LEVEL=<level> when building.
+#ifndef NR5G_FAPI_LOG_COMPILE_LEVEL
+#define NR5G_FAPI_LOG_COMPILE_LEVEL TRACE_LOG
+#endif
+
+// Async logging: the logging thread only copies the format string pointer
+// and the arguments into its own ring, the logger thread formats them.
+#define NR5G_FAPI_LOG_MAX_ARGS      12
+#define NR5G_FAPI_LOG_STR_SIZE      64  // bytes for all %s arguments of a record
+#define NR5G_FAPI_LOG_RING_SIZE     512 // records per thread, power of 2
+#define NR5G_FAPI_LOG_MAX_THREADS   32
+
+extern volatile bool nr5g_fapi_log_async_g;
+
+void nr5g_fapi_log_push(
+    nr5g_fapi_log_types_t type,
+    const char *p_fmt,
+    ...) __attribute__ ((format(printf, 2, 3)));
+
+uint8_t nr5g_fapi_log_async_start(
+    uint8_t core_id);
+
+void nr5g_fapi_log_flush(
+    );
+
+#define NR5G_FAPI_LOG_ARGS(...) __VA_ARGS__
+
 // NR5G_FAPI__LOG utility Macro for logging.
 #define NR5G_FAPI_LOG(TYPE, MSG) do { \
-    if(TYPE == ERROR_LOG) { \
-        printf("[%s]", get_logger_type_str(TYPE)); \
-        printf MSG ;\
-        printf("\n");\
-    }   \
-    else \
-    { \
-        if((nr5g_fapi_log_level_g > NONE_LOG) && (TYPE <= nr5g_fapi_log_level_g)) { \
-            printf("[%s]", get_logger_type_str(TYPE)); \
-            printf MSG ;\
-            printf("\n");\
-        }   \
+    if ((TYPE == ERROR_LOG) || (TYPE <= NR5G_FAPI_LOG_COMPILE_LEVEL)) { \
+        if ((TYPE == ERROR_LOG) || ((nr5g_fapi_log_level_g > NONE_LOG) && \
+                (TYPE <= nr5g_fapi_log_level_g))) { \
+            if (nr5g_fapi_log_async_g) { \
+                nr5g_fapi_log_push(TYPE, NR5G_FAPI_LOG_ARGS MSG); \
+            } \
+            else \
+            { \
+                printf("[%s]", get_logger_type_str(TYPE)); \
+                printf MSG ;\
+                printf("\n");\
+            } \
+        } \
     } \
 } while(0)
 
@@ -0,0 +1,104 @@
+/******************************************************************************
+*
+*   Copyright (c) 2021 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @file This file consist of the FAPI message recorder and its file format.
+ *
+ * A recording is a file header followed by blocks. A block is the list of
+ * APIs returned by one WLS receive in one direction, each API is stored as an
+ * element header, the message body and the payloads referenced by pointers
+ * in the body. All records are padded to 8 bytes.
+ *
+ **/
+
+#ifndef NR5G_FAPI_RECORDER_H_
+#define NR5G_FAPI_RECORDER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NR5G_FAPI_REC_MAGIC             "NR5GFREC"
+#define NR5G_FAPI_REC_VERSION           1
+#define NR5G_FAPI_REC_BLOCK_MAGIC       0x4B4C4246  // "FBLK"
+#define NR5G_FAPI_REC_FILE_NAME_LEN     512
+#define NR5G_FAPI_REC_MAX_BLOCK_SIZE    (16 * 1024 * 1024)
+#define NR5G_FAPI_REC_ALIGN(x)          (((x) + 7) & ~7U)
+
+typedef enum _nr5g_fapi_rec_dir_t {
+    NR5G_FAPI_REC_MAC2PHY = 0,  // FAPI APIs received from L2
+    NR5G_FAPI_REC_PHY2MAC,      // IAPI APIs received from L1
+    NR5G_FAPI_REC_NUM_DIR
+} nr5g_fapi_rec_dir_t;
+
+typedef struct _nr5g_fapi_rec_file_hdr_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t hdr_len;
+    uint64_t tsc_hz;
+} nr5g_fapi_rec_file_hdr_t;
+
+typedef struct _nr5g_fapi_rec_block_hdr_t {
+    uint32_t magic;
+    uint8_t dir;                // nr5g_fapi_rec_dir_t
+    uint8_t rsv;
+    uint16_t num_elems;
+    uint32_t len;               // bytes of elements following the header
+    uint32_t seq;               // block number in its direction
+    uint64_t tsc;               // receive time
+} nr5g_fapi_rec_block_hdr_t;
+
+// Queue element fields common to fapi_api_queue_elem_t and MAC2PHY_QUEUE_EL
+typedef struct _nr5g_fapi_rec_elem_hdr_t {
+    uint16_t msg_type;
+    uint16_t flags;             // WLS flags the element was received with
+    uint16_t num_message_in_block;
+    uint16_t num_payloads;
+    uint32_t msg_len;           // message body bytes following the header
+    uint32_t align_offset;
+} nr5g_fapi_rec_elem_hdr_t;
+
+// Payload referenced by a pointer at ptr_offset of the message body
+typedef struct _nr5g_fapi_rec_payload_hdr_t {
+    uint32_t ptr_offset;
+    uint32_t len;
+} nr5g_fapi_rec_payload_hdr_t;
+
+typedef struct _nr5g_fapi_config_recorder_cfg {
+    char file_name[NR5G_FAPI_REC_FILE_NAME_LEN];    // empty: disabled
+    uint32_t max_size_mb;
+} nr5g_fapi_config_recorder_cfg_t;
+
+extern volatile bool nr5g_fapi_recorder_active_g;
+
+uint8_t nr5g_fapi_recorder_open(
+    const char *file_name,
+    uint32_t max_size_mb);
+void nr5g_fapi_recorder_close(
+    );
+void nr5g_fapi_recorder_block_begin(
+    nr5g_fapi_rec_dir_t dir);
+void nr5g_fapi_recorder_mac2phy_elem(
+    void *p_qelm,
+    uint16_t flags);
+void nr5g_fapi_recorder_phy2mac_elem(
+    void *p_qelm,
+    uint16_t flags);
+void nr5g_fapi_recorder_block_end(
+    nr5g_fapi_rec_dir_t dir);
+
+#endif                          // NR5G_FAPI_RECORDER_H_
@@ -19,6 +19,10 @@
 /**
  * @file This file consist of SNR converter from IntelAPI to FAPI.
  *
+ * The array converters keep the loop body free of branches and libm calls
+ * so the compiler vectorizes them, indications convert the values of all
+ * their PDUs with one call.
+ *
  **/
 
 #ifndef NR5G_FAPI_SNR_CONVERSION_H_
@@ -32,6 +36,24 @@ extern "C" {
 
 uint8_t nr5g_fapi_convert_snr_iapi_to_fapi(const int16_t snr);
 
+// PUSCH/PUCCH nSNR to ul_cqi
+void nr5g_fapi_convert_snr_iapi_to_fapi_array(
+    const int16_t *__restrict p_snr,
+    uint8_t *__restrict p_ul_cqi,
+    uint32_t num);
+
+// SRS wideband/per block SNR in dB to wideBandSnr/rbSNR
+void nr5g_fapi_convert_srs_snr_iapi_to_fapi_array(
+    const int8_t *__restrict p_snr,
+    uint8_t *__restrict p_fapi_snr,
+    uint32_t num);
+
+static inline uint8_t nr5g_fapi_convert_srs_snr_iapi_to_fapi(
+    const int8_t snr)
+{
+    return (snr + 64) * 2;
+}
+
 #ifdef __cplusplus
 }
 #endif
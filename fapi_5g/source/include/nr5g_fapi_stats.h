@@ -32,10 +32,56 @@
 
 void nr5g_fapi_print_phy_instance_stats(
     p_nr5g_fapi_phy_instance_t p_phy_instance);
-inline int nr5g_fapi_check_for_file_link(
-    char *fname);
-inline int nr5g_fapi_change_file_permission(
-    int fd,
-    mode_t mode);
+void nr5g_fapi_print_latency_stats(
+    );
+uint8_t nr5g_fapi_dump_latency_stats(
+    const char *fname);
+uint64_t nr5g_fapi_latency_percentile(
+    nr5g_fapi_latency_hist_t * p_hist,
+    double percentile);
+
+// Bucket of a latency: exact below 8 cycles, then the exponent and the
+// top NR5G_FAPI_LAT_SUB_BUCKET_BITS bits of the mantissa
+static inline uint32_t nr5g_fapi_latency_bucket(
+    uint64_t ticks)
+{
+    uint32_t exp, bucket;
+
+    if (ticks < (1 << NR5G_FAPI_LAT_SUB_BUCKET_BITS))
+        return (uint32_t) ticks;
+
+    exp = 63 - __builtin_clzll(ticks);
+    bucket = ((exp - NR5G_FAPI_LAT_SUB_BUCKET_BITS + 1) <<
+        NR5G_FAPI_LAT_SUB_BUCKET_BITS) |
+        ((ticks >> (exp - NR5G_FAPI_LAT_SUB_BUCKET_BITS)) &
+        ((1 << NR5G_FAPI_LAT_SUB_BUCKET_BITS) - 1));
+
+    return (bucket < NR5G_FAPI_LAT_NUM_BUCKETS) ? bucket :
+        (NR5G_FAPI_LAT_NUM_BUCKETS - 1);
+}
+
+// Called only by the thread owning the (phy, is_urllc) pair, no locking
+static inline void nr5g_fapi_latency_record(
+    nr5g_fapi_latency_hist_t * p_hist,
+    uint64_t ticks)
+{
+    if (!p_hist->count || ticks < p_hist->min)
+        p_hist->min = ticks;
+    if (ticks > p_hist->max)
+        p_hist->max = ticks;
+    p_hist->count++;
+    p_hist->total += ticks;
+    p_hist->bucket[nr5g_fapi_latency_bucket(ticks)]++;
+}
+
+static inline void nr5g_fapi_latency_record_phy(
+    p_nr5g_fapi_phy_instance_t p_phy_instance,
+    bool is_urllc,
+    nr5g_fapi_latency_msg_t msg,
+    uint64_t ticks)
+{
+    nr5g_fapi_latency_record(&p_phy_instance->stats.latency[is_urllc][msg],
+        ticks);
+}
 
 #endif                          // NR5G_FAPI_STATS_H_
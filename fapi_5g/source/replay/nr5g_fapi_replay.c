@@ -0,0 +1,512 @@
+/******************************************************************************
+*
+*   Copyright (c) 2021 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @file This file defines the FAPI replay benchmark. A recording made with
+ * [RECORDER] file set is pushed through the MAC2PHY and PHY2MAC handlers on
+ * the calling thread against the in process WLS, the translation throughput
+ * and the per TTI latency of both directions are reported.
+ *
+ * Blocks carrying PARAM/CONFIG/START (or their responses) are replayed once
+ * before the timed passes, STOP/SHUTDOWN blocks once after them.
+ *
+ **/
+#include <getopt.h>
+#include <immintrin.h>
+#include "nr5g_fapi_std.h"
+#include "nr5g_fapi_common_types.h"
+#include "nr5g_fapi_config_loader.h"
+#include "nr5g_fapi_framework.h"
+#include "nr5g_fapi_wls.h"
+#include "nr5g_fapi_memory.h"
+#include "nr5g_fapi_stats.h"
+#include "nr5g_fapi_recorder.h"
+#include "nr5g_fapi_mac2phy_thread.h"
+#include "nr5g_fapi_phy2mac_thread.h"
+#include "nr5g_fapi_fapi2phy_api.h"
+#include "nr5g_fapi_fapi2mac_api.h"
+#include "nr5g_mac_phy_api.h"
+#include "nr5g_fapi_replay.h"
+
+#define NR5G_FAPI_REPLAY_ELEM_ALIGN     (64)
+#define NR5G_FAPI_REPLAY_WORK_SIZE      (2 * NR5G_FAPI_REC_MAX_BLOCK_SIZE)
+
+typedef enum _nr5g_fapi_replay_phase_t {
+    NR5G_FAPI_REPLAY_SETUP = 0,
+    NR5G_FAPI_REPLAY_RUN,
+    NR5G_FAPI_REPLAY_TEARDOWN
+} nr5g_fapi_replay_phase_t;
+
+typedef struct _nr5g_fapi_replay_block_t {
+    const nr5g_fapi_rec_block_hdr_t *p_hdr;
+    nr5g_fapi_replay_phase_t phase;
+} nr5g_fapi_replay_block_t;
+
+typedef struct _nr5g_fapi_replay_dir_stats_t {
+    uint64_t num_blocks;
+    uint64_t num_msgs;
+    uint64_t ticks;
+    nr5g_fapi_latency_hist_t tti;
+} nr5g_fapi_replay_dir_stats_t;
+
+typedef struct _nr5g_fapi_replay_t {
+    uint8_t *p_file;
+    uint64_t file_size;
+    nr5g_fapi_replay_block_t *p_blocks;
+    uint32_t num_blocks;
+    uint8_t *p_work;
+    void *p_list[2];            // regular and URLLC lists of the block
+    uint32_t num_msgs;
+    nr5g_fapi_replay_dir_stats_t stats[NR5G_FAPI_REC_NUM_DIR];
+} nr5g_fapi_replay_t;
+
+static nr5g_fapi_replay_t nr5g_fapi_replay;
+
+static void nr5g_fapi_replay_usage(
+    const char *prgname)
+{
+    printf("Usage: %s -f <recording> [-n <passes>]\n"
+        "  -f  FAPI recording made with [RECORDER] file set\n"
+        "  -n  number of times the recorded TTIs are replayed (default 1)\n",
+        prgname);
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_replay_group
+ *
+ *  @param[in]   p_elem  Recorded element header
+ *  @param[in]   dir     Direction of the block
+ *
+ *  @return  Phase the element belongs to
+ *
+ *  @description
+ *  P5 APIs bringing the PHY up or down are only replayed once.
+ *
+**/
+//------------------------------------------------------------------------------
+static nr5g_fapi_replay_phase_t nr5g_fapi_replay_elem_phase(
+    const nr5g_fapi_rec_elem_hdr_t * p_elem,
+    uint8_t dir)
+{
+    if (NR5G_FAPI_REC_MAC2PHY == dir) {
+        switch (p_elem->msg_type) {
+            case FAPI_PARAM_REQUEST:
+            case FAPI_CONFIG_REQUEST:
+            case FAPI_START_REQUEST:
+                return NR5G_FAPI_REPLAY_SETUP;
+            case FAPI_STOP_REQUEST:
+            case FAPI_VENDOR_EXT_SHUTDOWN_REQUEST:
+                return NR5G_FAPI_REPLAY_TEARDOWN;
+            default:
+                return NR5G_FAPI_REPLAY_RUN;
+        }
+    }
+
+    switch (p_elem->msg_type) {
+        case MSG_TYPE_PHY_CONFIG_RESP:
+        case MSG_TYPE_PHY_START_RESP:
+            return NR5G_FAPI_REPLAY_SETUP;
+        case MSG_TYPE_PHY_STOP_RESP:
+        case MSG_TYPE_PHY_SHUTDOWN_RESP:
+            return NR5G_FAPI_REPLAY_TEARDOWN;
+        default:
+            return NR5G_FAPI_REPLAY_RUN;
+    }
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_replay_group
+ *
+ *  @param[in]   p_elem  Recorded element header
+ *
+ *  @return  Location of the next element header
+ *
+ *  @description
+ *  Skips the message body and the payloads of a recorded element.
+ *
+**/
+//------------------------------------------------------------------------------
+static const nr5g_fapi_rec_elem_hdr_t *nr5g_fapi_replay_next_elem(
+    const nr5g_fapi_rec_elem_hdr_t * p_elem)
+{
+    const uint8_t *p_cur = (const uint8_t *)(p_elem + 1) +
+        NR5G_FAPI_REC_ALIGN(p_elem->msg_len);
+    const nr5g_fapi_rec_payload_hdr_t *p_payload;
+    uint16_t idx;
+
+    for (idx = 0; idx < p_elem->num_payloads; idx++) {
+        p_payload = (const nr5g_fapi_rec_payload_hdr_t *)p_cur;
+        p_cur += sizeof(*p_payload) + NR5G_FAPI_REC_ALIGN(p_payload->len);
+    }
+
+    return (const nr5g_fapi_rec_elem_hdr_t *)p_cur;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_replay_group
+ *
+ *  @param[in]   file_name  Recording
+ *
+ *  @return  SUCCESS or FAILURE
+ *
+ *  @description
+ *  Reads the recording and indexes its blocks.
+ *
+**/
+//------------------------------------------------------------------------------
+static uint8_t nr5g_fapi_replay_load(
+    const char *file_name)
+{
+    nr5g_fapi_replay_t *p_replay = &nr5g_fapi_replay;
+    const nr5g_fapi_rec_file_hdr_t *p_file_hdr;
+    const nr5g_fapi_rec_block_hdr_t *p_hdr;
+    const nr5g_fapi_rec_elem_hdr_t *p_elem;
+    nr5g_fapi_replay_phase_t phase, elem_phase;
+    uint64_t offset;
+    uint32_t max_blocks;
+    uint16_t idx;
+    FILE *fp;
+
+    fp = fopen(file_name, "rb");
+    if (NULL == fp) {
+        printf("Error: unable to open %s\n", file_name);
+        return FAILURE;
+    }
+    fseek(fp, 0, SEEK_END);
+    p_replay->file_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    p_replay->p_file = malloc(p_replay->file_size);
+    if ((NULL == p_replay->p_file) ||
+        (fread(p_replay->p_file, 1, p_replay->file_size, fp) !=
+            p_replay->file_size)) {
+        printf("Error: unable to read %s\n", file_name);
+        fclose(fp);
+        return FAILURE;
+    }
+    fclose(fp);
+
+    p_file_hdr = (const nr5g_fapi_rec_file_hdr_t *)p_replay->p_file;
+    if ((p_replay->file_size < sizeof(*p_file_hdr)) ||
+        memcmp(p_file_hdr->magic, NR5G_FAPI_REC_MAGIC,
+            sizeof(p_file_hdr->magic)) ||
+        (p_file_hdr->version != NR5G_FAPI_REC_VERSION)) {
+        printf("Error: %s is not a FAPI recording\n", file_name);
+        return FAILURE;
+    }
+
+    max_blocks = p_replay->file_size / sizeof(nr5g_fapi_rec_block_hdr_t);
+    p_replay->p_blocks = malloc(max_blocks * sizeof(nr5g_fapi_replay_block_t));
+    if (NULL == p_replay->p_blocks) {
+        printf("Error: not enough memory in the system\n");
+        return FAILURE;
+    }
+
+    offset = p_file_hdr->hdr_len;
+    while (offset + sizeof(*p_hdr) <= p_replay->file_size) {
+        p_hdr = (const nr5g_fapi_rec_block_hdr_t *)(p_replay->p_file + offset);
+        if ((p_hdr->magic != NR5G_FAPI_REC_BLOCK_MAGIC) ||
+            (p_hdr->dir >= NR5G_FAPI_REC_NUM_DIR) ||
+            (offset + sizeof(*p_hdr) + p_hdr->len > p_replay->file_size)) {
+            printf("Warning: recording truncated at offset %lu\n", offset);
+            break;
+        }
+
+        phase = NR5G_FAPI_REPLAY_RUN;
+        p_elem = (const nr5g_fapi_rec_elem_hdr_t *)(p_hdr + 1);
+        for (idx = 0; idx < p_hdr->num_elems; idx++) {
+            elem_phase = nr5g_fapi_replay_elem_phase(p_elem, p_hdr->dir);
+            if (elem_phase != NR5G_FAPI_REPLAY_RUN)
+                phase = elem_phase;
+            p_elem = nr5g_fapi_replay_next_elem(p_elem);
+        }
+        p_replay->p_blocks[p_replay->num_blocks].p_hdr = p_hdr;
+        p_replay->p_blocks[p_replay->num_blocks].phase = phase;
+        p_replay->num_blocks++;
+        offset += sizeof(*p_hdr) + p_hdr->len;
+    }
+
+    return SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_replay_group
+ *
+ *  @param[in]   p_body   Message body in the work buffer
+ *  @param[in]   p_elem   Recorded element header
+ *
+ *  @return  none
+ *
+ *  @description
+ *  Points the payload pointers of the message body to the recorded payloads.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_replay_link_payloads(
+    uint8_t * p_body,
+    const nr5g_fapi_rec_elem_hdr_t * p_elem)
+{
+    const uint8_t *p_cur = (const uint8_t *)(p_elem + 1) +
+        NR5G_FAPI_REC_ALIGN(p_elem->msg_len);
+    const nr5g_fapi_rec_payload_hdr_t *p_payload;
+    const uint8_t *p_data;
+    uint16_t idx;
+
+    for (idx = 0; idx < p_elem->num_payloads; idx++) {
+        p_payload = (const nr5g_fapi_rec_payload_hdr_t *)p_cur;
+        p_data = (const uint8_t *)(p_payload + 1);
+        if (p_payload->ptr_offset + sizeof(void *) <= p_elem->msg_len)
+            memcpy(p_body + p_payload->ptr_offset, &p_data, sizeof(void *));
+        p_cur = p_data + NR5G_FAPI_REC_ALIGN(p_payload->len);
+    }
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_replay_group
+ *
+ *  @param[in]   p_hdr  Recorded block
+ *
+ *  @return  none
+ *
+ *  @description
+ *  Rebuilds the queue elements of a block in the work buffer the way the WLS
+ *  receive path hands them to the handlers. The handlers may modify the
+ *  messages, so this is done again every time the block is replayed.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_replay_build_block(
+    const nr5g_fapi_rec_block_hdr_t * p_hdr)
+{
+    nr5g_fapi_replay_t *p_replay = &nr5g_fapi_replay;
+    const nr5g_fapi_rec_elem_hdr_t *p_elem;
+    void *p_tail[2] = { NULL, NULL };
+    p_fapi_api_queue_elem_t p_fapi_elm;
+    PMAC2PHY_QUEUE_EL p_phy_elm;
+    uint8_t *p_cur = p_replay->p_work;
+    uint8_t *p_body;
+    uint32_t elm_size;
+    uint16_t idx;
+    uint8_t is_urllc;
+
+    p_replay->p_list[0] = p_replay->p_list[1] = NULL;
+    p_replay->num_msgs = 0;
+    p_elem = (const nr5g_fapi_rec_elem_hdr_t *)(p_hdr + 1);
+    for (idx = 0; idx < p_hdr->num_elems; idx++) {
+        is_urllc = (p_elem->flags & WLS_TF_URLLC) ? 1 : 0;
+        if (NR5G_FAPI_REC_MAC2PHY == p_hdr->dir) {
+            p_fapi_elm = (p_fapi_api_queue_elem_t) p_cur;
+            NR5G_FAPI_MEMSET(p_fapi_elm, sizeof(*p_fapi_elm), 0,
+                sizeof(*p_fapi_elm));
+            p_fapi_elm->msg_type = (uint8_t) p_elem->msg_type;
+            p_fapi_elm->num_message_in_block =
+                (uint8_t) p_elem->num_message_in_block;
+            p_fapi_elm->msg_len = p_elem->msg_len;
+            p_fapi_elm->align_offset = p_elem->align_offset;
+            p_body = (uint8_t *) (p_fapi_elm + 1);
+            if (p_tail[is_urllc])
+                ((p_fapi_api_queue_elem_t) p_tail[is_urllc])->p_next =
+                    p_fapi_elm;
+            elm_size = sizeof(*p_fapi_elm);
+        } else {
+            p_phy_elm = (PMAC2PHY_QUEUE_EL) p_cur;
+            NR5G_FAPI_MEMSET(p_phy_elm, sizeof(*p_phy_elm), 0,
+                sizeof(*p_phy_elm));
+            p_phy_elm->nMessageType = p_elem->msg_type;
+            p_phy_elm->nMessageLen = p_elem->msg_len;
+            p_phy_elm->nNumMessageInBlock = p_elem->num_message_in_block;
+            p_phy_elm->nAlignOffset = p_elem->align_offset;
+            p_body = (uint8_t *) (p_phy_elm + 1);
+            if (p_tail[is_urllc])
+                ((PMAC2PHY_QUEUE_EL) p_tail[is_urllc])->pNext = p_phy_elm;
+            elm_size = sizeof(*p_phy_elm);
+        }
+        memcpy(p_body, p_elem + 1, p_elem->msg_len);
+        nr5g_fapi_replay_link_payloads(p_body, p_elem);
+
+        if (NULL == p_replay->p_list[is_urllc])
+            p_replay->p_list[is_urllc] = p_cur;
+        p_tail[is_urllc] = p_cur;
+        p_replay->num_msgs++;
+
+        elm_size += p_elem->msg_len;
+        p_cur += (elm_size + NR5G_FAPI_REPLAY_ELEM_ALIGN - 1) &
+            ~(NR5G_FAPI_REPLAY_ELEM_ALIGN - 1);
+        p_elem = nr5g_fapi_replay_next_elem(p_elem);
+    }
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup nr5g_fapi_source_replay_group
+ *
+ *  @param[in]   p_block  Block to replay
+ *  @param[in]   timed    Add the block to the statistics
+ *
+ *  @return  none
+ *
+ *  @description
+ *  Hands a block to the handlers of its direction and sends the translated
+ *  APIs, like the MAC2PHY and PHY2MAC threads do with a WLS receive.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_replay_block(
+    const nr5g_fapi_replay_block_t * p_block,
+    bool timed)
+{
+    nr5g_fapi_replay_t *p_replay = &nr5g_fapi_replay;
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx = nr5g_fapi_get_nr5g_fapi_phy_ctx();
+    nr5g_fapi_replay_dir_stats_t *p_stats;
+    uint8_t dir = p_block->p_hdr->dir;
+    uint64_t start_tick, ticks;
+    uint8_t is_urllc;
+
+    nr5g_fapi_replay_build_block(p_block->p_hdr);
+
+    start_tick = __rdtsc();
+    for (is_urllc = 0; is_urllc < 2; is_urllc++) {
+        if (NULL == p_replay->p_list[is_urllc])
+            continue;
+        if (NR5G_FAPI_REC_MAC2PHY == dir) {
+            nr5g_fapi_mac2phy_api_recv_handler(is_urllc, p_phy_ctx,
+                (p_fapi_api_queue_elem_t) p_replay->p_list[is_urllc]);
+            nr5g_fapi_fapi2phy_send_api_list(is_urllc);
+        } else {
+            nr5g_fapi_phy2mac_api_recv_handler(is_urllc, p_phy_ctx,
+                (PMAC2PHY_QUEUE_EL) p_replay->p_list[is_urllc]);
+            nr5g_fapi_fapi2mac_send_api_list(is_urllc);
+        }
+    }
+    ticks = __rdtsc() - start_tick;
+
+    if (!timed)
+        return;
+    p_stats = &p_replay->stats[dir];
+    p_stats->num_blocks++;
+    p_stats->num_msgs += p_replay->num_msgs;
+    p_stats->ticks += ticks;
+    nr5g_fapi_latency_record(&p_stats->tti, ticks);
+}
+
+static void nr5g_fapi_replay_print_stats(
+    uint64_t tsc_hz)
+{
+    static const char *dir_name[NR5G_FAPI_REC_NUM_DIR] =
+        { "MAC2PHY", "PHY2MAC" };
+    p_nr5g_fapi_replay_wls_stats_t p_wls_stats = nr5g_fapi_replay_wls_stats();
+    nr5g_fapi_replay_dir_stats_t *p_stats;
+    double us = 1000000.0 / tsc_hz;
+    uint8_t dir;
+
+    printf("\n%-8s %10s %12s %12s %10s %10s %10s %10s\n", "dir", "ttis",
+        "msgs", "msgs/s", "p50 us", "p99 us", "p99.9 us", "max us");
+    for (dir = 0; dir < NR5G_FAPI_REC_NUM_DIR; dir++) {
+        p_stats = &nr5g_fapi_replay.stats[dir];
+        if (!p_stats->num_blocks)
+            continue;
+        printf("%-8s %10lu %12lu %12.0f %10.2f %10.2f %10.2f %10.2f\n",
+            dir_name[dir], p_stats->num_blocks, p_stats->num_msgs,
+            (double)p_stats->num_msgs * tsc_hz / p_stats->ticks,
+            nr5g_fapi_latency_percentile(&p_stats->tti, 0.5) * us,
+            nr5g_fapi_latency_percentile(&p_stats->tti, 0.99) * us,
+            nr5g_fapi_latency_percentile(&p_stats->tti, 0.999) * us,
+            p_stats->tti.max * us);
+    }
+    printf("\nSent to L1 %lu msgs %lu bytes, to L2 %lu msgs %lu bytes",
+        p_wls_stats->num_phy_msgs, p_wls_stats->num_phy_bytes,
+        p_wls_stats->num_mac_msgs, p_wls_stats->num_mac_bytes);
+    if (p_wls_stats->num_mac_alloc_fail)
+        printf(", %lu L2 block allocations failed",
+            p_wls_stats->num_mac_alloc_fail);
+    printf("\n");
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    nr5g_fapi_replay_t *p_replay = &nr5g_fapi_replay;
+    const char *file_name = NULL;
+    p_nr5g_fapi_cfg_t cfg;
+    uint32_t num_passes = 1, pass, idx;
+    uint64_t start_tick, tsc_hz;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:n:h")) != -1) {
+        switch (opt) {
+            case 'f':
+                file_name = optarg;
+                break;
+            case 'n':
+                num_passes = (uint32_t) atoi(optarg);
+                break;
+            default:
+                nr5g_fapi_replay_usage(argv[0]);
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if ((NULL == file_name) || !num_passes) {
+        nr5g_fapi_replay_usage(argv[0]);
+        return 1;
+    }
+
+    if (FAILURE == nr5g_fapi_replay_load(file_name))
+        return 1;
+    p_replay->p_work = aligned_alloc(NR5G_FAPI_REPLAY_ELEM_ALIGN,
+        NR5G_FAPI_REPLAY_WORK_SIZE);
+    cfg = (p_nr5g_fapi_cfg_t) calloc(1, sizeof(nr5g_fapi_cfg_t));
+    if ((NULL == p_replay->p_work) || (NULL == cfg)) {
+        printf("Error: not enough memory in the system\n");
+        return 1;
+    }
+
+    nr5g_fapi_set_log_level(NONE_LOG);
+    rte_strlcpy(cfg->wls.device_name, "replay", NR5G_FAPI_DEVICE_NAME_LEN);
+    if (FAILURE == nr5g_fapi_wls_init(cfg)) {
+        printf("Error: WLS init failed\n");
+        return 1;
+    }
+    nr5g_fapi_fapi2mac_init_api_list();
+
+    start_tick = __rdtsc();
+    usleep(100000);
+    tsc_hz = (__rdtsc() - start_tick) * 10;
+
+    printf("Replaying %u blocks of %s %u times\n", p_replay->num_blocks,
+        file_name, num_passes);
+    for (pass = 0; pass < num_passes; pass++) {
+        for (idx = 0; idx < p_replay->num_blocks; idx++) {
+            if (p_replay->p_blocks[idx].phase == NR5G_FAPI_REPLAY_RUN)
+                nr5g_fapi_replay_block(&p_replay->p_blocks[idx], true);
+            else if (!pass &&
+                p_replay->p_blocks[idx].phase == NR5G_FAPI_REPLAY_SETUP)
+                nr5g_fapi_replay_block(&p_replay->p_blocks[idx], false);
+        }
+    }
+    for (idx = 0; idx < p_replay->num_blocks; idx++) {
+        if (p_replay->p_blocks[idx].phase == NR5G_FAPI_REPLAY_TEARDOWN)
+            nr5g_fapi_replay_block(&p_replay->p_blocks[idx], false);
+    }
+
+    nr5g_fapi_replay_print_stats(tsc_hz);
+
+    free(cfg);
+    free(p_replay->p_work);
+    free(p_replay->p_blocks);
+    free(p_replay->p_file);
+    return 0;
+}
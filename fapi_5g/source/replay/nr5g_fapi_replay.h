@@ -0,0 +1,56 @@
+/******************************************************************************
+*
+*   Copyright (c) 2021 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @file This file consist of the in process WLS used by the FAPI replay
+ * benchmark in place of the WLS library.
+ *
+ **/
+
+#ifndef NR5G_FAPI_REPLAY_H_
+#define NR5G_FAPI_REPLAY_H_
+
+#include <stdint.h>
+
+// FAPI partition, the mem array starts at the next 1GB boundary of it
+#define NR5G_FAPI_REPLAY_MAC_MEM_SIZE   (0x60000000ULL)
+// Blocks handed out to FAPI for the APIs sent to L2
+#define NR5G_FAPI_REPLAY_PHY_MEM_SIZE   (0x10000000ULL)
+// Blocks L1 accepts for its UL APIs, they are never returned
+#define NR5G_FAPI_REPLAY_MAX_UL_BLOCKS  (64)
+// APIs put on behalf of L1 and not yet received by FAPI
+#define NR5G_FAPI_REPLAY_MAX_PHY_MSGS   (64)
+
+typedef struct _nr5g_fapi_replay_wls_stats_t {
+    uint64_t num_phy_msgs;      // WLS_Put to L1
+    uint64_t num_phy_bytes;
+    uint64_t num_mac_msgs;      // WLS_Put1 to L2
+    uint64_t num_mac_bytes;
+    uint64_t num_mac_alloc_fail;    // WLS_DequeueBlock with no free block
+} nr5g_fapi_replay_wls_stats_t,
+*p_nr5g_fapi_replay_wls_stats_t;
+
+p_nr5g_fapi_replay_wls_stats_t nr5g_fapi_replay_wls_stats(
+    );
+int nr5g_fapi_replay_wls_phy_put(
+    void *p_msg,
+    uint32_t msg_size,
+    uint16_t msg_type,
+    uint16_t flags);
+
+#endif                          // NR5G_FAPI_REPLAY_H_
@@ -0,0 +1,277 @@
+/******************************************************************************
+*
+*   Copyright (c) 2021 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @file This file defines the WLS functions used by FAPI on top of a private
+ * anonymous mapping, so the replay benchmark runs without L1, L2 and the WLS
+ * driver. Addresses are not translated, L1 consumes every API it is sent and
+ * L2 returns every block as soon as it is sent. L1 sends only what a test
+ * puts with nr5g_fapi_replay_wls_phy_put.
+ *
+ **/
+#include <sys/mman.h>
+#include "nr5g_fapi_std.h"
+#include "nr5g_fapi_common_types.h"
+#include "nr5g_fapi_wls.h"
+#include "nr5g_fapi_replay.h"
+
+#define NR5G_FAPI_REPLAY_NUM_MAC_BLOCKS \
+    (NR5G_FAPI_REPLAY_PHY_MEM_SIZE / MSG_MAXSIZE)
+
+typedef struct _nr5g_fapi_replay_wls_msg_t {
+    uint64_t p_msg;
+    uint32_t msg_size;
+    uint16_t msg_type;
+    uint16_t flags;
+} nr5g_fapi_replay_wls_msg_t;
+
+typedef struct _nr5g_fapi_replay_wls_t {
+    uint8_t *p_mem;
+    uint64_t mem_size;
+    uint32_t h_wls[NUM_WLS_INSTANCES];  // only the addresses are used
+    uint64_t mac_blocks[NR5G_FAPI_REPLAY_NUM_MAC_BLOCKS];
+    uint32_t num_mac_blocks;
+    uint32_t num_ul_blocks;
+    // L1 to FAPI queue, single threaded
+    nr5g_fapi_replay_wls_msg_t phy_msgs[NR5G_FAPI_REPLAY_MAX_PHY_MSGS];
+    uint32_t phy_msgs_head;
+    uint32_t phy_msgs_tail;
+    nr5g_fapi_replay_wls_stats_t stats;
+} nr5g_fapi_replay_wls_t;
+
+static nr5g_fapi_replay_wls_t nr5g_fapi_replay_wls;
+
+p_nr5g_fapi_replay_wls_stats_t nr5g_fapi_replay_wls_stats(
+    )
+{
+    return &nr5g_fapi_replay_wls.stats;
+}
+
+// Queues an API as if L1 had sent it, returns 0 or -1 when the queue is full
+int nr5g_fapi_replay_wls_phy_put(
+    void *p_msg,
+    uint32_t msg_size,
+    uint16_t msg_type,
+    uint16_t flags)
+{
+    nr5g_fapi_replay_wls_t *p_wls = &nr5g_fapi_replay_wls;
+    nr5g_fapi_replay_wls_msg_t *p_phy_msg;
+
+    if ((p_wls->phy_msgs_head - p_wls->phy_msgs_tail) >=
+        NR5G_FAPI_REPLAY_MAX_PHY_MSGS)
+        return -1;
+    p_phy_msg = &p_wls->phy_msgs[p_wls->phy_msgs_head++ %
+        NR5G_FAPI_REPLAY_MAX_PHY_MSGS];
+    p_phy_msg->p_msg = (uint64_t) p_msg;
+    p_phy_msg->msg_size = msg_size;
+    p_phy_msg->msg_type = msg_type;
+    p_phy_msg->flags = flags;
+    return 0;
+}
+
+void *WLS_Open_Dual(
+    const char *ifacename,
+    unsigned int mode,
+    uint64_t * nWlsMacMemorySize,
+    uint64_t * nWlsPhyMemorySize,
+    void **handle1)
+{
+    nr5g_fapi_replay_wls_t *p_wls = &nr5g_fapi_replay_wls;
+    uint8_t *p_block;
+    uint32_t idx;
+
+    UNUSED(ifacename);
+    UNUSED(mode);
+
+    p_wls->mem_size = NR5G_FAPI_REPLAY_MAC_MEM_SIZE +
+        NR5G_FAPI_REPLAY_PHY_MEM_SIZE;
+    p_wls->p_mem = mmap(NULL, p_wls->mem_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (MAP_FAILED == p_wls->p_mem) {
+        p_wls->p_mem = NULL;
+        *handle1 = NULL;
+        return NULL;
+    }
+
+    // L2 blocks follow the FAPI partition
+    p_block = p_wls->p_mem + NR5G_FAPI_REPLAY_MAC_MEM_SIZE;
+    for (idx = 0; idx < NR5G_FAPI_REPLAY_NUM_MAC_BLOCKS; idx++) {
+        p_wls->mac_blocks[idx] = (uint64_t) (p_block + idx * MSG_MAXSIZE);
+    }
+    p_wls->num_mac_blocks = NR5G_FAPI_REPLAY_NUM_MAC_BLOCKS;
+
+    *nWlsMacMemorySize = NR5G_FAPI_REPLAY_MAC_MEM_SIZE;
+    *nWlsPhyMemorySize = NR5G_FAPI_REPLAY_PHY_MEM_SIZE;
+    *handle1 = &p_wls->h_wls[NR5G_FAPI2PHY_WLS_INST];
+
+    return &p_wls->h_wls[NR5G_FAPI2MAC_WLS_INST];
+}
+
+void *WLS_Alloc(
+    void *h,
+    uint64_t size)
+{
+    UNUSED(h);
+
+    return (size <= nr5g_fapi_replay_wls.mem_size) ?
+        nr5g_fapi_replay_wls.p_mem : NULL;
+}
+
+int WLS_Ready(
+    void *h)
+{
+    UNUSED(h);
+    return 0;
+}
+
+int WLS_Ready1(
+    void *h)
+{
+    UNUSED(h);
+    return 0;
+}
+
+int WLS_Wait(
+    void *h)
+{
+    UNUSED(h);
+    return (int)(nr5g_fapi_replay_wls.phy_msgs_head -
+        nr5g_fapi_replay_wls.phy_msgs_tail);
+}
+
+int WLS_Wait1(
+    void *h)
+{
+    UNUSED(h);
+    return 0;
+}
+
+unsigned long long WLS_Get(
+    void *h,
+    unsigned int *MsgSize,
+    unsigned short *MsgTypeID,
+    unsigned short *Flags)
+{
+    nr5g_fapi_replay_wls_t *p_wls = &nr5g_fapi_replay_wls;
+    nr5g_fapi_replay_wls_msg_t *p_phy_msg;
+
+    UNUSED(h);
+    if (p_wls->phy_msgs_head == p_wls->phy_msgs_tail) {
+        *MsgSize = 0, *MsgTypeID = 0, *Flags = 0;
+        return 0;
+    }
+    p_phy_msg = &p_wls->phy_msgs[p_wls->phy_msgs_tail++ %
+        NR5G_FAPI_REPLAY_MAX_PHY_MSGS];
+    *MsgSize = p_phy_msg->msg_size;
+    *MsgTypeID = p_phy_msg->msg_type;
+    *Flags = p_phy_msg->flags;
+    return p_phy_msg->p_msg;
+}
+
+unsigned long long WLS_Get1(
+    void *h,
+    unsigned int *MsgSize,
+    unsigned short *MsgTypeID,
+    unsigned short *Flags)
+{
+    UNUSED(h);
+    *MsgSize = 0, *MsgTypeID = 0, *Flags = 0;
+    return 0;
+}
+
+int WLS_Put(
+    void *h,
+    unsigned long long pMsg,
+    unsigned int MsgSize,
+    unsigned short MsgTypeID,
+    unsigned short Flags)
+{
+    UNUSED(h);
+    UNUSED(pMsg);
+    UNUSED(MsgTypeID);
+    UNUSED(Flags);
+
+    nr5g_fapi_replay_wls.stats.num_phy_msgs++;
+    nr5g_fapi_replay_wls.stats.num_phy_bytes += MsgSize;
+    return 0;
+}
+
+int WLS_Put1(
+    void *h,
+    unsigned long long pMsg,
+    unsigned int MsgSize,
+    unsigned short MsgTypeID,
+    unsigned short Flags)
+{
+    nr5g_fapi_replay_wls_t *p_wls = &nr5g_fapi_replay_wls;
+
+    UNUSED(h);
+    UNUSED(MsgTypeID);
+    UNUSED(Flags);
+
+    p_wls->stats.num_mac_msgs++;
+    p_wls->stats.num_mac_bytes += MsgSize;
+    if (p_wls->num_mac_blocks < NR5G_FAPI_REPLAY_NUM_MAC_BLOCKS)
+        p_wls->mac_blocks[p_wls->num_mac_blocks++] = pMsg;
+    return 0;
+}
+
+int WLS_EnqueueBlock(
+    void *h,
+    unsigned long long pMsg)
+{
+    nr5g_fapi_replay_wls_t *p_wls = &nr5g_fapi_replay_wls;
+
+    UNUSED(h);
+    UNUSED(pMsg);
+
+    if (p_wls->num_ul_blocks >= NR5G_FAPI_REPLAY_MAX_UL_BLOCKS)
+        return 0;
+    p_wls->num_ul_blocks++;
+    return 1;
+}
+
+unsigned long long WLS_DequeueBlock(
+    void *h)
+{
+    nr5g_fapi_replay_wls_t *p_wls = &nr5g_fapi_replay_wls;
+
+    UNUSED(h);
+
+    if (!p_wls->num_mac_blocks) {
+        p_wls->stats.num_mac_alloc_fail++;
+        return 0;
+    }
+    return p_wls->mac_blocks[--p_wls->num_mac_blocks];
+}
+
+unsigned long long WLS_VA2PA(
+    void *h,
+    void *pMsg)
+{
+    UNUSED(h);
+    return (unsigned long long)pMsg;
+}
+
+void *WLS_PA2VA(
+    void *h,
+    unsigned long long pMsg)
+{
+    UNUSED(h);
+    return (void *)pMsg;
+}
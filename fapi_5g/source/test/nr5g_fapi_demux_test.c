@@ -0,0 +1,338 @@
+/******************************************************************************
+*
+*   Copyright (c) 2021 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @file This file defines the MAC2PHY demux test. Every TTI is a block of
+ * more than 500 APIs spread over all PHY instances, with message headers of
+ * the same PHY repeated, headers without APIs, headers of an invalid PHY and
+ * APIs without a header. A header without APIs is skipped on its own, the
+ * APIs of an invalid PHY are dropped up to the next header. The block goes through nr5g_fapi_mac2phy_demux_add
+ * one element at a time (WLS receive) and through
+ * nr5g_fapi_mac2phy_demux_list (URLLC), each PHY list must hold all the
+ * APIs of that PHY in arrival order and nothing else.
+ *
+ **/
+#include <getopt.h>
+#include <immintrin.h>
+#include "nr5g_fapi_std.h"
+#include "nr5g_fapi_framework.h"
+
+#define NR5G_FAPI_DEMUX_TEST_MIN_APIS   (520)   // APIs per TTI at least
+#define NR5G_FAPI_DEMUX_TEST_MAX_ELEMS  (2048)  // APIs and headers per TTI
+#define NR5G_FAPI_DEMUX_TEST_MAX_BURST  (48)    // APIs after one header
+
+// API payload, where the API must end up
+typedef struct _nr5g_fapi_demux_test_api_t {
+    uint32_t seq;               // position in the block
+    uint8_t phy_id;             // NR5G_FAPI_DEMUX_NO_PHY when dropped
+} nr5g_fapi_demux_test_api_t;
+
+typedef struct _nr5g_fapi_demux_test_elem_t {
+    fapi_api_queue_elem_t elem;
+    union {
+        fapi_msg_header_t msg_header;
+        nr5g_fapi_demux_test_api_t api;
+    } u;
+} __attribute__ ((aligned(64))) nr5g_fapi_demux_test_elem_t;
+
+typedef struct _nr5g_fapi_demux_test_t {
+    nr5g_fapi_demux_test_elem_t elems[NR5G_FAPI_DEMUX_TEST_MAX_ELEMS];
+    uint32_t num_elems;
+    // expected result of the block
+    uint32_t phy_seq[FAPI_MAX_PHY_INSTANCES][NR5G_FAPI_DEMUX_TEST_MAX_ELEMS];
+    uint32_t phy_num_apis[FAPI_MAX_PHY_INSTANCES];
+    uint8_t phy_order[FAPI_MAX_PHY_INSTANCES];
+    uint8_t num_phy;
+    uint32_t num_apis;
+    uint32_t num_dropped;
+    uint8_t curr_phy_id;        // PHY of the last valid message header
+    uint32_t rand;
+    nr5g_fapi_mac2phy_demux_t demux;
+} nr5g_fapi_demux_test_t;
+
+static nr5g_fapi_demux_test_t nr5g_fapi_demux_test;
+
+static void nr5g_fapi_demux_test_usage(
+    const char *prgname)
+{
+    printf("Usage: %s [-n <TTIs>] [-p <PHY instances>]\n"
+        "  -n  number of TTIs (default 1000)\n"
+        "  -p  number of PHY instances used, 1 to %u (default %u)\n",
+        prgname, FAPI_MAX_PHY_INSTANCES, FAPI_MAX_PHY_INSTANCES);
+}
+
+static inline uint32_t nr5g_fapi_demux_test_rand(
+    nr5g_fapi_demux_test_t * p_test,
+    uint32_t range)
+{
+    p_test->rand = p_test->rand * 1103515245U + 12345U;
+    return (p_test->rand >> 8) % range;
+}
+
+static p_fapi_api_queue_elem_t nr5g_fapi_demux_test_new_elem(
+    nr5g_fapi_demux_test_t * p_test,
+    uint8_t msg_type)
+{
+    nr5g_fapi_demux_test_elem_t *p_elem = &p_test->elems[p_test->num_elems++];
+
+    memset(p_elem, 0, sizeof(*p_elem));
+    p_elem->elem.msg_type = msg_type;
+    p_elem->elem.msg_len = sizeof(p_elem->u);
+    // p_next is left stale on purpose, the demux must terminate its lists
+    p_elem->elem.p_next = &p_elem->elem;
+    return &p_elem->elem;
+}
+
+static void nr5g_fapi_demux_test_add_header(
+    nr5g_fapi_demux_test_t * p_test,
+    uint8_t phy_id,
+    uint8_t num_msg)
+{
+    nr5g_fapi_demux_test_elem_t *p_elem = (nr5g_fapi_demux_test_elem_t *)
+        nr5g_fapi_demux_test_new_elem(p_test, FAPI_VENDOR_MSG_HEADER_IND);
+    uint32_t idx;
+
+    p_elem->u.msg_header.handle = phy_id;
+    p_elem->u.msg_header.num_msg = num_msg;
+
+    if (phy_id >= FAPI_MAX_PHY_INSTANCES) {
+        p_test->curr_phy_id = NR5G_FAPI_DEMUX_NO_PHY;
+        return;
+    }
+    if (0 == num_msg)
+        return;
+    p_test->curr_phy_id = phy_id;
+    for (idx = 0; idx < p_test->num_phy; idx++) {
+        if (p_test->phy_order[idx] == phy_id)
+            return;
+    }
+    p_test->phy_order[p_test->num_phy++] = phy_id;
+}
+
+static void nr5g_fapi_demux_test_add_apis(
+    nr5g_fapi_demux_test_t * p_test,
+    uint8_t phy_id,
+    uint32_t num_apis)
+{
+    nr5g_fapi_demux_test_elem_t *p_elem;
+    uint32_t idx;
+
+    for (idx = 0; idx < num_apis; idx++) {
+        p_elem = (nr5g_fapi_demux_test_elem_t *)
+            nr5g_fapi_demux_test_new_elem(p_test,
+            FAPI_DL_TTI_REQUEST + (idx % 5));
+        p_elem->u.api.seq = p_test->num_elems - 1;
+        p_elem->u.api.phy_id = phy_id;
+        if (NR5G_FAPI_DEMUX_NO_PHY == phy_id) {
+            p_test->num_dropped++;
+        } else {
+            p_test->phy_seq[phy_id][p_test->phy_num_apis[phy_id]++] =
+                p_elem->u.api.seq;
+            p_test->num_apis++;
+        }
+    }
+}
+
+// One TTI: bursts of APIs behind message headers, mostly valid
+static void nr5g_fapi_demux_test_build(
+    nr5g_fapi_demux_test_t * p_test,
+    uint32_t num_phy)
+{
+    uint32_t num_apis, kind;
+    uint8_t phy_id;
+
+    p_test->num_elems = 0;
+    p_test->num_phy = 0;
+    p_test->num_apis = 0;
+    p_test->num_dropped = 0;
+    p_test->curr_phy_id = NR5G_FAPI_DEMUX_NO_PHY;
+    memset(p_test->phy_num_apis, 0, sizeof(p_test->phy_num_apis));
+
+    // APIs before any header
+    if (0 == nr5g_fapi_demux_test_rand(p_test, 4))
+        nr5g_fapi_demux_test_add_apis(p_test, NR5G_FAPI_DEMUX_NO_PHY,
+            1 + nr5g_fapi_demux_test_rand(p_test, 3));
+
+    while (p_test->num_apis < NR5G_FAPI_DEMUX_TEST_MIN_APIS) {
+        kind = nr5g_fapi_demux_test_rand(p_test, 32);
+        num_apis = 1 + nr5g_fapi_demux_test_rand(p_test,
+            NR5G_FAPI_DEMUX_TEST_MAX_BURST);
+        phy_id = (uint8_t) nr5g_fapi_demux_test_rand(p_test, num_phy);
+
+        if (0 == kind) {
+            // invalid PHY, its APIs are dropped
+            nr5g_fapi_demux_test_add_header(p_test,
+                FAPI_MAX_PHY_INSTANCES + nr5g_fapi_demux_test_rand(p_test,
+                    NR5G_FAPI_DEMUX_NO_PHY - FAPI_MAX_PHY_INSTANCES),
+                (uint8_t) num_apis);
+            nr5g_fapi_demux_test_add_apis(p_test, NR5G_FAPI_DEMUX_NO_PHY,
+                num_apis);
+        } else if (1 == kind) {
+            // no APIs for the PHY, only the header is skipped and what
+            // follows stays with the PHY of the previous header
+            nr5g_fapi_demux_test_add_header(p_test, phy_id, 0);
+            if (nr5g_fapi_demux_test_rand(p_test, 2))
+                nr5g_fapi_demux_test_add_apis(p_test, p_test->curr_phy_id,
+                    1 + nr5g_fapi_demux_test_rand(p_test, 3));
+        } else {
+            nr5g_fapi_demux_test_add_header(p_test, phy_id,
+                (uint8_t) num_apis);
+            nr5g_fapi_demux_test_add_apis(p_test, phy_id, num_apis);
+        }
+    }
+}
+
+static uint32_t nr5g_fapi_demux_test_check(
+    nr5g_fapi_demux_test_t * p_test,
+    const char *path,
+    uint32_t tti)
+{
+    p_nr5g_fapi_mac2phy_demux_t p_demux = &p_test->demux;
+    p_nr5g_fapi_api_list_t p_list;
+    p_fapi_api_queue_elem_t p_elem, p_last;
+    nr5g_fapi_demux_test_api_t *p_api;
+    uint32_t num_errors = 0, phy_id, idx, num_apis = 0;
+
+    if (p_demux->num_phy != p_test->num_phy ||
+        memcmp(p_demux->phy_order, p_test->phy_order, p_test->num_phy)) {
+        printf("%s TTI %u: %u PHYs, expected %u or other order\n", path, tti,
+            p_demux->num_phy, p_test->num_phy);
+        num_errors++;
+    }
+    if (p_demux->num_dropped != p_test->num_dropped) {
+        printf("%s TTI %u: %u APIs dropped, expected %u\n", path, tti,
+            p_demux->num_dropped, p_test->num_dropped);
+        num_errors++;
+    }
+
+    for (phy_id = 0; phy_id < FAPI_MAX_PHY_INSTANCES; phy_id++) {
+        p_list = &p_demux->phy_api_list[phy_id];
+        if (p_list->num_apis != p_test->phy_num_apis[phy_id]) {
+            printf("%s TTI %u PHY %u: %u APIs, expected %u\n", path, tti,
+                phy_id, p_list->num_apis, p_test->phy_num_apis[phy_id]);
+            num_errors++;
+            continue;
+        }
+
+        p_last = NULL;
+        idx = 0;
+        for (p_elem = p_list->p_head; p_elem && idx < p_list->num_apis;
+            p_elem = p_elem->p_next, idx++) {
+            p_api = (nr5g_fapi_demux_test_api_t *) (p_elem + 1);
+            if (FAPI_VENDOR_MSG_HEADER_IND == p_elem->msg_type ||
+                p_api->phy_id != phy_id ||
+                p_api->seq != p_test->phy_seq[phy_id][idx]) {
+                printf("%s TTI %u PHY %u: API %u is #%u of PHY %u, "
+                    "expected #%u\n", path, tti, phy_id, idx, p_api->seq,
+                    p_api->phy_id, p_test->phy_seq[phy_id][idx]);
+                num_errors++;
+                break;
+            }
+            p_last = p_elem;
+        }
+        if (idx == p_list->num_apis &&
+            (p_elem != NULL || p_list->p_tail != p_last)) {
+            printf("%s TTI %u PHY %u: list not terminated at its tail\n",
+                path, tti, phy_id);
+            num_errors++;
+        }
+        num_apis += p_list->num_apis;
+    }
+
+    if (num_apis != p_test->num_apis) {
+        printf("%s TTI %u: %u of %u APIs delivered\n", path, tti, num_apis,
+            p_test->num_apis);
+        num_errors++;
+    }
+
+    return num_errors;
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    nr5g_fapi_demux_test_t *p_test = &nr5g_fapi_demux_test;
+    uint32_t num_tti = 1000, num_phy = FAPI_MAX_PHY_INSTANCES;
+    uint32_t tti, idx, num_errors = 0;
+    uint64_t num_elems = 0, ticks_add = 0, ticks_list = 0, start_tick;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:p:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                num_tti = (uint32_t) atoi(optarg);
+                break;
+            case 'p':
+                num_phy = (uint32_t) atoi(optarg);
+                break;
+            default:
+                nr5g_fapi_demux_test_usage(argv[0]);
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if (!num_tti || !num_phy || num_phy > FAPI_MAX_PHY_INSTANCES) {
+        nr5g_fapi_demux_test_usage(argv[0]);
+        return 1;
+    }
+
+    p_test->rand = 1;
+    for (tti = 0; tti < num_tti; tti++) {
+        nr5g_fapi_demux_test_build(p_test, num_phy);
+        num_elems += p_test->num_elems;
+
+        // WLS receive: one element at a time
+        nr5g_fapi_mac2phy_demux_init(&p_test->demux);
+        start_tick = __rdtsc();
+        for (idx = 0; idx < p_test->num_elems; idx++)
+            nr5g_fapi_mac2phy_demux_add(&p_test->demux,
+                &p_test->elems[idx].elem);
+        ticks_add += __rdtsc() - start_tick;
+        num_errors += nr5g_fapi_demux_test_check(p_test, "add", tti);
+
+        // URLLC: the block already linked
+        for (idx = 0; idx + 1 < p_test->num_elems; idx++)
+            p_test->elems[idx].elem.p_next = &p_test->elems[idx + 1].elem;
+        p_test->elems[idx].elem.p_next = NULL;
+        nr5g_fapi_mac2phy_demux_init(&p_test->demux);
+        start_tick = __rdtsc();
+        if (nr5g_fapi_mac2phy_demux_list(&p_test->demux,
+                &p_test->elems[0].elem) != p_test->num_elems) {
+            printf("list TTI %u: not all elements walked\n", tti);
+            num_errors++;
+        }
+        ticks_list += __rdtsc() - start_tick;
+        num_errors += nr5g_fapi_demux_test_check(p_test, "list", tti);
+
+        if (num_errors)
+            break;
+    }
+
+    printf("%u TTIs, %u PHYs, %.1f elements per TTI, %.1f / %.1f cycles "
+        "per element (add / list)\n", tti, num_phy,
+        (double)num_elems / (tti ? tti : 1),
+        (double)ticks_add / (num_elems ? num_elems : 1),
+        (double)ticks_list / (num_elems ? num_elems : 1));
+    if (num_errors) {
+        printf("FAIL: %u errors\n", num_errors);
+        return 1;
+    }
+    printf("PASS\n");
+
+    return 0;
+}
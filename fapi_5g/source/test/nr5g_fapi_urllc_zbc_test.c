@@ -0,0 +1,403 @@
+/******************************************************************************
+*
+*   Copyright (c) 2021 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @file This file defines the URLLC RX_DATA zero copy test. L1 sends URLLC
+ * RX_ULSCH.indication lists through the in process WLS of the replay, they
+ * go through nr5g_fapi_fapi2phy_wls_recv, the URLLC mailbox and the URLLC
+ * PHY2MAC processing of nr5g_fapi_urllc_phy2mac_thread_func, with regular
+ * receives while a list waits in the mailbox. The payloads must be held from
+ * receive on, keep their content until L2 releases them and go back to the
+ * pool once. A list the mailbox cannot take is freed with the regular
+ * receives, its payloads expire as not delivered.
+ *
+ **/
+#include <getopt.h>
+#include "nr5g_fapi_std.h"
+#include "nr5g_fapi_common_types.h"
+#include "nr5g_fapi_config_loader.h"
+#include "nr5g_fapi_framework.h"
+#include "nr5g_fapi_wls.h"
+#include "nr5g_fapi_log.h"
+#include "nr5g_fapi_phy2mac_thread.h"
+#include "nr5g_fapi_fapi2mac_api.h"
+#include "nr5g_fapi_fapi2phy_wls.h"
+#include "nr5g_mac_phy_api.h"
+#include "nr5g_fapi_replay.h"
+
+#define NR5G_FAPI_URLLC_ZBC_TEST_PDUS       (4) // ULSCH PDUs per URLLC list
+#define NR5G_FAPI_URLLC_ZBC_TEST_PDU_LEN    (512)
+#define NR5G_FAPI_URLLC_ZBC_TEST_MAX_DELAY  (3 * TO_FREE_SIZE)  // receives
+#define NR5G_FAPI_URLLC_ZBC_TEST_TIMEOUT    (4 * TO_FREE_SIZE_URLLC)
+// Lists sent before the URLLC thread runs, the last one does not fit
+#define NR5G_FAPI_URLLC_ZBC_TEST_MAX_LISTS  (NR5G_FAPI_URLLC_QUEUE_SIZE + 1)
+
+typedef struct _nr5g_fapi_urllc_zbc_test_list_t {
+    PMAC2PHY_QUEUE_EL p_qelm;
+    uint8_t *p_payload[NR5G_FAPI_URLLC_ZBC_TEST_PDUS];
+    uint8_t pattern;
+} nr5g_fapi_urllc_zbc_test_list_t;
+
+typedef struct _nr5g_fapi_urllc_zbc_test_t {
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx;
+    nr5g_fapi_urllc_zbc_test_list_t lists[NR5G_FAPI_URLLC_ZBC_TEST_MAX_LISTS];
+    // expected counters
+    uint64_t num_held;
+    uint64_t num_released;
+    uint64_t num_not_delivered;
+    uint16_t sfn;
+    uint8_t slot;
+    uint32_t rand;
+    uint32_t num_errors;
+} nr5g_fapi_urllc_zbc_test_t;
+
+static nr5g_fapi_urllc_zbc_test_t nr5g_fapi_urllc_zbc_test;
+
+#define NR5G_FAPI_URLLC_ZBC_TEST_CHECK(p_test, cond, ...) \
+    do { \
+        if (!(cond)) { \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+            (p_test)->num_errors++; \
+        } \
+    } while (0)
+
+static void nr5g_fapi_urllc_zbc_test_usage(
+    const char *prgname)
+{
+    printf("Usage: %s [-n <rounds>]\n"
+        "  -n  number of URLLC lists sent one at a time (default 200)\n",
+        prgname);
+}
+
+static inline uint32_t nr5g_fapi_urllc_zbc_test_rand(
+    nr5g_fapi_urllc_zbc_test_t * p_test,
+    uint32_t range)
+{
+    p_test->rand = p_test->rand * 1103515245U + 12345U;
+    return (p_test->rand >> 8) % range;
+}
+
+static PMAC2PHY_QUEUE_EL nr5g_fapi_urllc_zbc_test_alloc(
+    uint32_t msg_size)
+{
+    PMAC2PHY_QUEUE_EL p_qelm = (PMAC2PHY_QUEUE_EL)
+        wls_fapi_alloc_buffer(0, MIN_UL_BUF_LOCATIONS);
+
+    // overwrites a payload given back to the pool too early
+    memset(p_qelm, 0, sizeof(MAC2PHY_QUEUE_EL) + msg_size);
+    p_qelm->nMessageLen = msg_size;
+    return p_qelm;
+}
+
+// One WLS block from L1 holding a single API
+static void nr5g_fapi_urllc_zbc_test_recv(
+    PMAC2PHY_QUEUE_EL p_qelm,
+    uint16_t msg_type,
+    bool is_urllc)
+{
+    WLS_HANDLE h_wls = nr5g_fapi_wls_context()->h_wls[NR5G_FAPI2PHY_WLS_INST];
+
+    nr5g_fapi_replay_wls_phy_put((void *)nr5g_fapi_wls_va_to_pa(h_wls,
+            p_qelm), p_qelm->nMessageLen, msg_type,
+        WLS_TF_FIN | (is_urllc ? WLS_TF_URLLC : 0));
+    // a regular list is freed by the receive whether processed or not
+    nr5g_fapi_fapi2phy_wls_recv();
+}
+
+// Same as one loop of nr5g_fapi_urllc_phy2mac_thread_func
+static PMAC2PHY_QUEUE_EL nr5g_fapi_urllc_zbc_test_urllc_thread(
+    nr5g_fapi_urllc_zbc_test_t * p_test)
+{
+    PMAC2PHY_QUEUE_EL p_qelm = (PMAC2PHY_QUEUE_EL)
+        nr5g_fapi_urllc_queue_wait(p_test->p_phy_ctx,
+        &p_test->p_phy_ctx->urllc_phy2mac_params);
+
+    nr5g_fapi_phy2mac_api_recv_handler(true, p_test->p_phy_ctx, p_qelm);
+    nr5g_fapi_fapi2mac_send_api_list(true);
+    nr5g_fapi_transfer_to_free_recv_list_urllc(p_qelm);
+    return p_qelm;
+}
+
+// A block without payload, the PHY2MAC processing ignores it
+static void nr5g_fapi_urllc_zbc_test_filler(
+    nr5g_fapi_urllc_zbc_test_t * p_test,
+    bool is_urllc)
+{
+    PMAC2PHY_QUEUE_EL p_qelm =
+        nr5g_fapi_urllc_zbc_test_alloc(sizeof(L1L2MessageHdr));
+
+    ((PL1L2MessageHdr) (p_qelm + 1))->nMessageType = MSG_TYPE_PHY_ERR_IND;
+    nr5g_fapi_urllc_zbc_test_recv(p_qelm, MSG_TYPE_PHY_ERR_IND, is_urllc);
+    if (is_urllc)
+        nr5g_fapi_urllc_zbc_test_urllc_thread(p_test);
+}
+
+// Sends an RX_ULSCH.indication for the PUSCHs of the next URLLC slot
+static void nr5g_fapi_urllc_zbc_test_send(
+    nr5g_fapi_urllc_zbc_test_t * p_test,
+    nr5g_fapi_urllc_zbc_test_list_t * p_list)
+{
+    WLS_HANDLE h_wls = nr5g_fapi_wls_context()->h_wls[NR5G_FAPI2PHY_WLS_INST];
+    nr5g_fapi_ul_slot_info_t *p_ul_slot_info =
+        &p_test->p_phy_ctx->phy_instance[0].ul_slot_info[1][p_test->slot][0];
+    PRXULSCHIndicationStruct p_ind;
+    PULSCHPDUDataStruct p_pdu;
+    uint32_t idx;
+
+    nr5g_fapi_set_ul_slot_info(p_test->sfn, p_test->slot, 0, p_ul_slot_info);
+    p_ul_slot_info->num_ulsch = NR5G_FAPI_URLLC_ZBC_TEST_PDUS;
+
+    p_list->p_qelm =
+        nr5g_fapi_urllc_zbc_test_alloc(sizeof(RXULSCHIndicationStruct));
+    p_list->pattern = (uint8_t) nr5g_fapi_urllc_zbc_test_rand(p_test, 256);
+    p_ind = (PRXULSCHIndicationStruct) (p_list->p_qelm + 1);
+    p_ind->sMsgHdr.nMessageType = MSG_TYPE_PHY_RX_ULSCH_IND;
+    p_ind->sMsgHdr.nMessageLen = sizeof(RXULSCHIndicationStruct);
+    p_ind->sSFN_Slot.nSFN = p_test->sfn;
+    p_ind->sSFN_Slot.nSlot = p_test->slot;
+    p_ind->nUlsch = NR5G_FAPI_URLLC_ZBC_TEST_PDUS;
+    for (idx = 0; idx < NR5G_FAPI_URLLC_ZBC_TEST_PDUS; idx++) {
+        p_list->p_payload[idx] = (uint8_t *)
+            wls_fapi_alloc_buffer(0, MIN_UL_BUF_LOCATIONS);
+        memset(p_list->p_payload[idx], p_list->pattern + idx,
+            NR5G_FAPI_URLLC_ZBC_TEST_PDU_LEN);
+        p_ul_slot_info->pusch_info[idx].handle = idx + 1;
+        p_pdu = &p_ind->sULSCHPDUDataStruct[idx];
+        p_pdu->nUEId = idx + 1;
+        p_pdu->nRNTI = 0x4601 + idx;
+        p_pdu->nPduLen = NR5G_FAPI_URLLC_ZBC_TEST_PDU_LEN;
+        p_pdu->pPayload = (uint8_t *) nr5g_fapi_wls_va_to_pa(h_wls,
+            p_list->p_payload[idx]);
+    }
+
+    if (++p_test->slot == MAX_UL_SLOT_INFO_COUNT) {
+        p_test->slot = 0;
+        p_test->sfn = (p_test->sfn + 1) % 1024;
+    }
+
+    nr5g_fapi_urllc_zbc_test_recv(p_list->p_qelm, MSG_TYPE_PHY_RX_ULSCH_IND,
+        true);
+    p_test->num_held += NR5G_FAPI_URLLC_ZBC_TEST_PDUS;
+}
+
+static void nr5g_fapi_urllc_zbc_test_check_payloads(
+    nr5g_fapi_urllc_zbc_test_t * p_test,
+    nr5g_fapi_urllc_zbc_test_list_t * p_list,
+    const char *when)
+{
+    uint32_t idx, byte;
+
+    for (idx = 0; idx < NR5G_FAPI_URLLC_ZBC_TEST_PDUS; idx++) {
+        for (byte = 0; byte < NR5G_FAPI_URLLC_ZBC_TEST_PDU_LEN; byte++) {
+            if (p_list->p_payload[idx][byte] != (uint8_t) (p_list->pattern +
+                    idx))
+                break;
+        }
+        NR5G_FAPI_URLLC_ZBC_TEST_CHECK(p_test,
+            byte == NR5G_FAPI_URLLC_ZBC_TEST_PDU_LEN,
+            "%s: payload %u overwritten at byte %u", when, idx, byte);
+    }
+}
+
+// L2 is done with the PDUs, pduData is the payload address L1 sent
+static void nr5g_fapi_urllc_zbc_test_release(
+    nr5g_fapi_urllc_zbc_test_t * p_test,
+    nr5g_fapi_urllc_zbc_test_list_t * p_list)
+{
+    WLS_HANDLE h_wls = nr5g_fapi_wls_context()->h_wls[NR5G_FAPI2PHY_WLS_INST];
+    fapi_vendor_ext_rx_data_release_req_t release_req;
+    uint32_t idx;
+
+    memset(&release_req, 0, sizeof(release_req));
+    release_req.num_pdus = NR5G_FAPI_URLLC_ZBC_TEST_PDUS;
+    for (idx = 0; idx < NR5G_FAPI_URLLC_ZBC_TEST_PDUS; idx++)
+        release_req.pdu_data[idx] = (void *)nr5g_fapi_wls_va_to_pa(h_wls,
+            p_list->p_payload[idx]);
+    nr5g_fapi_fapi2phy_rx_data_zbc_release(&release_req);
+    p_test->num_released += NR5G_FAPI_URLLC_ZBC_TEST_PDUS;
+}
+
+static void nr5g_fapi_urllc_zbc_test_check_stats(
+    nr5g_fapi_urllc_zbc_test_t * p_test,
+    uint32_t num_outstanding,
+    const char *when)
+{
+    nr5g_fapi_rx_data_zbc_stats_t stats;
+    uint32_t num_bufs = nr5g_fapi_fapi2phy_rx_data_zbc_get_stats(&stats);
+
+    NR5G_FAPI_URLLC_ZBC_TEST_CHECK(p_test,
+        stats.held == p_test->num_held &&
+        stats.released == p_test->num_released &&
+        stats.not_delivered == p_test->num_not_delivered &&
+        num_bufs == num_outstanding && !stats.timed_out &&
+        !stats.table_full && !stats.unknown,
+        "%s: held %lu/%lu released %lu/%lu not delivered %lu/%lu "
+        "outstanding %u/%u timed out %lu table full %lu unknown %lu", when,
+        stats.held, p_test->num_held, stats.released, p_test->num_released,
+        stats.not_delivered, p_test->num_not_delivered, num_bufs,
+        num_outstanding, stats.timed_out, stats.table_full, stats.unknown);
+}
+
+// One list at a time, delayed in the mailbox by regular receives
+static void nr5g_fapi_urllc_zbc_test_round(
+    nr5g_fapi_urllc_zbc_test_t * p_test)
+{
+    nr5g_fapi_urllc_zbc_test_list_t *p_list = &p_test->lists[0];
+    uint32_t idx, num_delay;
+
+    nr5g_fapi_urllc_zbc_test_send(p_test, p_list);
+    nr5g_fapi_urllc_zbc_test_check_stats(p_test,
+        NR5G_FAPI_URLLC_ZBC_TEST_PDUS, "received");
+
+    num_delay = nr5g_fapi_urllc_zbc_test_rand(p_test,
+        NR5G_FAPI_URLLC_ZBC_TEST_MAX_DELAY + 1);
+    for (idx = 0; idx < num_delay; idx++)
+        nr5g_fapi_urllc_zbc_test_filler(p_test, false);
+    nr5g_fapi_urllc_zbc_test_check_payloads(p_test, p_list, "queued");
+
+    NR5G_FAPI_URLLC_ZBC_TEST_CHECK(p_test,
+        nr5g_fapi_urllc_zbc_test_urllc_thread(p_test) == p_list->p_qelm,
+        "URLLC thread got another list");
+
+    // the list itself is freed meanwhile
+    for (idx = 0; idx < TO_FREE_SIZE_URLLC; idx++)
+        nr5g_fapi_urllc_zbc_test_filler(p_test, true);
+    nr5g_fapi_urllc_zbc_test_check_payloads(p_test, p_list, "delivered");
+    nr5g_fapi_urllc_zbc_test_check_stats(p_test,
+        NR5G_FAPI_URLLC_ZBC_TEST_PDUS, "delivered");
+
+    nr5g_fapi_urllc_zbc_test_release(p_test, p_list);
+    nr5g_fapi_urllc_zbc_test_check_stats(p_test, 0, "released");
+}
+
+// More lists than the mailbox holds before the URLLC thread runs
+static void nr5g_fapi_urllc_zbc_test_queue_full(
+    nr5g_fapi_urllc_zbc_test_t * p_test)
+{
+    nr5g_fapi_urllc_thread_params_t *p_params =
+        &p_test->p_phy_ctx->urllc_phy2mac_params;
+    uint64_t num_queue_full = p_params->num_queue_full;
+    uint32_t idx;
+
+    for (idx = 0; idx < NR5G_FAPI_URLLC_ZBC_TEST_MAX_LISTS; idx++)
+        nr5g_fapi_urllc_zbc_test_send(p_test, &p_test->lists[idx]);
+    NR5G_FAPI_URLLC_ZBC_TEST_CHECK(p_test,
+        p_params->num_queue_full == num_queue_full + 1,
+        "queue full: %lu lists dropped, expected 1",
+        p_params->num_queue_full - num_queue_full);
+    nr5g_fapi_urllc_zbc_test_check_stats(p_test,
+        NR5G_FAPI_URLLC_ZBC_TEST_MAX_LISTS * NR5G_FAPI_URLLC_ZBC_TEST_PDUS,
+        "queue full");
+
+    for (idx = 0; idx < NR5G_FAPI_URLLC_QUEUE_SIZE; idx++) {
+        nr5g_fapi_urllc_zbc_test_check_payloads(p_test, &p_test->lists[idx],
+            "queue full");
+        NR5G_FAPI_URLLC_ZBC_TEST_CHECK(p_test,
+            nr5g_fapi_urllc_zbc_test_urllc_thread(p_test) ==
+            p_test->lists[idx].p_qelm, "queue full: list %u out of order",
+            idx);
+    }
+
+    // the payloads of the dropped list expire
+    for (idx = 0; idx < TO_FREE_SIZE_URLLC; idx++)
+        nr5g_fapi_urllc_zbc_test_filler(p_test, true);
+    p_test->num_not_delivered += NR5G_FAPI_URLLC_ZBC_TEST_PDUS;
+    nr5g_fapi_urllc_zbc_test_check_stats(p_test,
+        NR5G_FAPI_URLLC_QUEUE_SIZE * NR5G_FAPI_URLLC_ZBC_TEST_PDUS,
+        "dropped list expired");
+
+    for (idx = 0; idx < NR5G_FAPI_URLLC_QUEUE_SIZE; idx++) {
+        nr5g_fapi_urllc_zbc_test_check_payloads(p_test, &p_test->lists[idx],
+            "queue full delivered");
+        nr5g_fapi_urllc_zbc_test_release(p_test, &p_test->lists[idx]);
+    }
+    nr5g_fapi_urllc_zbc_test_check_stats(p_test, 0, "queue full released");
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    nr5g_fapi_urllc_zbc_test_t *p_test = &nr5g_fapi_urllc_zbc_test;
+    p_nr5g_fapi_wls_context_t p_wls_ctx;
+    p_nr5g_fapi_cfg_t cfg;
+    uint32_t num_rounds = 200, round, idx, num_blocks;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                num_rounds = (uint32_t) atoi(optarg);
+                break;
+            default:
+                nr5g_fapi_urllc_zbc_test_usage(argv[0]);
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    cfg = (p_nr5g_fapi_cfg_t) calloc(1, sizeof(nr5g_fapi_cfg_t));
+    if (NULL == cfg) {
+        printf("Error: not enough memory in the system\n");
+        return 1;
+    }
+    nr5g_fapi_set_log_level(NONE_LOG);
+    snprintf(cfg->wls.device_name, NR5G_FAPI_DEVICE_NAME_LEN, "replay");
+    if (FAILURE == nr5g_fapi_wls_init(cfg)) {
+        printf("Error: WLS init failed\n");
+        return 1;
+    }
+    nr5g_fapi_fapi2mac_init_api_list();
+    p_wls_ctx = nr5g_fapi_wls_context();
+    // UL blocks given to L1 at init are never returned
+    num_blocks = p_wls_ctx->nAllocBlocks;
+
+    p_test->p_phy_ctx = nr5g_fapi_get_nr5g_fapi_phy_ctx();
+    p_test->p_phy_ctx->is_urllc_enabled = 1;
+    nr5g_fapi_urllc_queue_init(&p_test->p_phy_ctx->urllc_phy2mac_params,
+        NR5G_FAPI_URLLC_WAIT_POLL, 0, 0);
+    nr5g_fapi_fapi2phy_rx_data_zbc_init(TRUE,
+        NR5G_FAPI_URLLC_ZBC_TEST_TIMEOUT);
+    p_test->rand = 1;
+
+    for (round = 0; round < num_rounds && !p_test->num_errors; round++)
+        nr5g_fapi_urllc_zbc_test_round(p_test);
+    if (!p_test->num_errors)
+        nr5g_fapi_urllc_zbc_test_queue_full(p_test);
+
+    for (idx = 0; idx < TO_FREE_SIZE; idx++)
+        wls_fapi_free_recv_free_list(idx, false);
+    for (idx = 0; idx < TO_FREE_SIZE_URLLC; idx++)
+        wls_fapi_free_recv_free_list(idx, true);
+    NR5G_FAPI_URLLC_ZBC_TEST_CHECK(p_test,
+        p_wls_ctx->nAllocBlocks == num_blocks,
+        "%u blocks not returned to the pool",
+        p_wls_ctx->nAllocBlocks - num_blocks);
+
+    printf("%u rounds, %lu payloads held, %lu released, %lu not delivered\n",
+        round, p_test->num_held, p_test->num_released,
+        p_test->num_not_delivered);
+    free(cfg);
+    if (p_test->num_errors) {
+        printf("FAIL: %u errors\n", p_test->num_errors);
+        return 1;
+    }
+    printf("PASS\n");
+
+    return 0;
+}
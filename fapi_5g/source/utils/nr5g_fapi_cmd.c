@@ -26,6 +26,7 @@
 #include "nr5g_fapi_std.h"
 #include "nr5g_fapi_framework.h"
 #include "nr5g_fapi_wls.h"
+#include "nr5g_fapi_stats.h"
 
 #define NUM_CMDS 5
 #define CMD_SIZE 32
@@ -161,6 +162,10 @@ static void nr5g_fapi_cmd_wls_stats(
     )
 {
     nr5g_fapi_wls_print_stats();
+    nr5g_fapi_urllc_print_stats();
+    nr5g_fapi_print_latency_stats();
+    if (SUCCESS == nr5g_fapi_dump_latency_stats(NR5G_FAPI_LATENCY_FNAME))
+        printf("Latency histograms written to %s\n", NR5G_FAPI_LATENCY_FNAME);
 }
 
 //-------------------------------------------------------------------------------------------
@@ -84,6 +84,8 @@ p_nr5g_fapi_cfg_t nr5g_fapi_config_loader(
     size_t dev_name_len, mem_zone_name_len;
     unsigned int num_cpus = 0;
     char check_core_count[255], *max_core;
+    char worker_name[64];
+    uint8_t i;
     FILE *fp = NULL;
 
     if (cfg_fname == NULL) {
@@ -128,11 +130,39 @@ p_nr5g_fapi_cfg_t nr5g_fapi_config_loader(
             printf("URLLC disabled\n");
     }
 
+    cfg->urllc_wait_mode = 1;  // adaptive, busy poll is opt-in
+    entry = rte_cfgfile_get_entry(cfg_file, "URLLC", "wait_mode");
+    if (entry)
+        cfg->urllc_wait_mode = (uint32_t)atoi(entry);
+
+    cfg->urllc_spin_count = 1000;
+    entry = rte_cfgfile_get_entry(cfg_file, "URLLC", "spin_count");
+    if (entry)
+        cfg->urllc_spin_count = (uint32_t)atoi(entry);
+
     nr5g_fapi_get_worker_info(cfg_file, num_cpus, &cfg->mac2phy_thread_params, "MAC2PHY_WORKER");
     nr5g_fapi_get_worker_info(cfg_file, num_cpus, &cfg->phy2mac_thread_params, "PHY2MAC_WORKER");
     nr5g_fapi_get_worker_info(cfg_file, num_cpus, &cfg->urllc_mac2phy_thread_params, "MAC2PHY_URLLC_WORKER");
     nr5g_fapi_get_worker_info(cfg_file, num_cpus, &cfg->urllc_phy2mac_thread_params, "PHY2MAC_URLLC_WORKER");
 
+    entry = rte_cfgfile_get_entry(cfg_file, "MAC2PHY_WORKER",
+        "num_translation_workers");
+    if (entry) {
+        cfg->num_mac2phy_workers = (uint8_t) atoi(entry);
+        if (cfg->num_mac2phy_workers > NR5G_FAPI_MAX_MAC2PHY_WORKERS) {
+            printf("Number of MAC2PHY translation workers valid range is 0 to"
+                " %d: configured: %d\n", NR5G_FAPI_MAX_MAC2PHY_WORKERS,
+                cfg->num_mac2phy_workers);
+            exit(-1);
+        }
+    }
+    for (i = 0; i < cfg->num_mac2phy_workers; i++) {
+        snprintf(worker_name, sizeof(worker_name),
+            "MAC2PHY_TRANSLATION_WORKER_%d", i);
+        nr5g_fapi_get_worker_info(cfg_file, num_cpus,
+            &cfg->mac2phy_worker_thread_params[i], worker_name);
+    }
+
     entry = rte_cfgfile_get_entry(cfg_file, "WLS_CFG", "device_name");
     if (entry) {
         dev_name_len = (strlen(entry) > (NR5G_FAPI_DEVICE_NAME_LEN)) ?
@@ -149,6 +179,20 @@ p_nr5g_fapi_cfg_t nr5g_fapi_config_loader(
         }
     }
 
+    entry = rte_cfgfile_get_entry(cfg_file, "WLS_CFG", "rx_data_zbc");
+    if (entry)
+        cfg->wls.rx_data_zbc = (bool)atoi(entry);
+
+    cfg->wls.rx_data_zbc_timeout = 80;
+    entry = rte_cfgfile_get_entry(cfg_file, "WLS_CFG", "rx_data_zbc_timeout");
+    if (entry) {
+        cfg->wls.rx_data_zbc_timeout = (uint32_t) atoi(entry);
+        if (!cfg->wls.rx_data_zbc_timeout) {
+            printf("rx_data_zbc_timeout cannot be 0\n");
+            exit(-1);
+        }
+    }
+
     entry = rte_cfgfile_get_entry(cfg_file, "LOGGER", "level");
     if (entry) {
         if (!strcmp(entry, "info"))
@@ -163,6 +207,22 @@ p_nr5g_fapi_cfg_t nr5g_fapi_config_loader(
             cfg->logger.level = NONE_LOG;
     }
 
+    cfg->logger.async = false;
+    entry = rte_cfgfile_get_entry(cfg_file, "LOGGER", "async");
+    if (entry)
+        cfg->logger.async = (bool)atoi(entry);
+
+    cfg->logger.core_id = 0;
+    entry = rte_cfgfile_get_entry(cfg_file, "LOGGER", "core_id");
+    if (entry) {
+        cfg->logger.core_id = (uint8_t) atoi(entry);
+        if (cfg->logger.core_id >= (uint8_t) num_cpus) {
+            printf("Logger core Id is not in the range 0 to %d: configured: "
+                "%d\n", num_cpus, cfg->logger.core_id);
+            exit(-1);
+        }
+    }
+
     entry = rte_cfgfile_get_entry(cfg_file, "DPDK", "dpdk_iova_mode");
     if (entry) {
         cfg->dpdk.iova_mode = (uint8_t) atoi(entry);
@@ -179,6 +239,15 @@ p_nr5g_fapi_cfg_t nr5g_fapi_config_loader(
         rte_strlcpy(cfg->dpdk.memory_zone, entry, mem_zone_name_len + 1);
     }
 
+    cfg->recorder.max_size_mb = 1024;
+    entry = rte_cfgfile_get_entry(cfg_file, "RECORDER", "file");
+    if (entry)
+        rte_strlcpy(cfg->recorder.file_name, entry, NR5G_FAPI_REC_FILE_NAME_LEN);
+
+    entry = rte_cfgfile_get_entry(cfg_file, "RECORDER", "max_size_mb");
+    if (entry)
+        cfg->recorder.max_size_mb = (uint32_t) atoi(entry);
+
     return cfg;
 }
 
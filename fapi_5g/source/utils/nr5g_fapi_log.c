@@ -21,8 +21,10 @@
  *
  **/
 #include "nr5g_fapi_std.h"
+#include "nr5g_fapi_common_types.h"
 #include "nr5g_fapi_log.h"
 #include "nr5g_fapi_memory.h"
+#include <stdarg.h>
 
 nr5g_fapi_log_types_t nr5g_fapi_log_level_g;
 nr5g_fapi_performance_statistic_t fapi_statis_info_wls_get_dl;
@@ -106,6 +108,450 @@ nr5g_fapi_log_types_t nr5g_fapi_get_log_level(
 {
     return nr5g_fapi_log_level_g;
 }
+// Argument classes of a printf conversion specification
+typedef enum _nr5g_fapi_log_arg_class {
+    NR5G_FAPI_LOG_ARG_NONE = 0, // %%
+    NR5G_FAPI_LOG_ARG_INT,
+    NR5G_FAPI_LOG_ARG_LONG,
+    NR5G_FAPI_LOG_ARG_LLONG,
+    NR5G_FAPI_LOG_ARG_PTR,
+    NR5G_FAPI_LOG_ARG_DOUBLE,
+    NR5G_FAPI_LOG_ARG_STR,
+    NR5G_FAPI_LOG_ARG_INVALID,
+} nr5g_fapi_log_arg_class_t;
+
+typedef struct _nr5g_fapi_log_record {
+    const char *p_fmt;
+    uint64_t args[NR5G_FAPI_LOG_MAX_ARGS];
+    uint8_t type;
+    uint8_t num_args;
+    uint8_t str_len;
+    char str[NR5G_FAPI_LOG_STR_SIZE];
+} nr5g_fapi_log_record_t;
+
+// Single producer single consumer ring of one logging thread. A thread
+// owns the ring from its first log message until it exits, then the ring is
+// taken by the next new logging thread.
+typedef struct _nr5g_fapi_log_ring {
+    volatile uint32_t head __attribute__ ((aligned(64)));
+    uint32_t num_dropped;       // records lost on a full ring
+    uint8_t in_use;             // owned by a thread
+    volatile uint32_t tail __attribute__ ((aligned(64)));
+    uint32_t num_dropped_seen;
+    nr5g_fapi_log_record_t record[NR5G_FAPI_LOG_RING_SIZE];
+} nr5g_fapi_log_ring_t;
+
+volatile bool nr5g_fapi_log_async_g = false;
+static nr5g_fapi_log_ring_t nr5g_fapi_log_ring[NR5G_FAPI_LOG_MAX_THREADS];
+static uint32_t nr5g_fapi_log_num_rings;   // rings ever used, flushed
+static __thread nr5g_fapi_log_ring_t *p_nr5g_fapi_log_thread_ring;
+static pthread_key_t nr5g_fapi_log_ring_key;
+static pthread_mutex_t nr5g_fapi_log_flush_lock = PTHREAD_MUTEX_INITIALIZER;
+
+//------------------------------------------------------------------------------
+/** @ingroup        group_lte_source_phy_api
+ *
+ *  @param[in]      p_spec     First character after '%'
+ *  @param[out]     p_class    Argument class of the specification
+ *  @param[out]     p_num_star Number of '*' width and precision arguments
+ *
+ *  @return         Pointer to the conversion character
+ *
+ *  @description    Parses one printf conversion specification.
+ *
+ **/
+//------------------------------------------------------------------------------
+static const char *nr5g_fapi_log_parse_spec(
+    const char *p_spec,
+    nr5g_fapi_log_arg_class_t * p_class,
+    uint8_t * p_num_star)
+{
+    uint8_t num_long = 0;
+
+    *p_num_star = 0;
+    while (*p_spec && strchr("-+ #0", *p_spec))
+        p_spec++;
+    while (*p_spec && (strchr("0123456789.", *p_spec) || *p_spec == '*')) {
+        if (*p_spec == '*')
+            (*p_num_star)++;
+        p_spec++;
+    }
+    while (*p_spec && strchr("hlzjt", *p_spec)) {
+        if (*p_spec != 'h')
+            num_long++;
+        p_spec++;
+    }
+
+    switch (*p_spec) {
+        case '%':
+            *p_class = NR5G_FAPI_LOG_ARG_NONE;
+            break;
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'c':
+            *p_class = (num_long == 0) ? NR5G_FAPI_LOG_ARG_INT :
+                (num_long == 1) ? NR5G_FAPI_LOG_ARG_LONG :
+                NR5G_FAPI_LOG_ARG_LLONG;
+            break;
+        case 'p':
+            *p_class = NR5G_FAPI_LOG_ARG_PTR;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+            *p_class = NR5G_FAPI_LOG_ARG_DOUBLE;
+            break;
+        case 's':
+            *p_class = NR5G_FAPI_LOG_ARG_STR;
+            break;
+        default:
+            *p_class = NR5G_FAPI_LOG_ARG_INVALID;
+            break;
+    }
+
+    return p_spec;
+}
+
+// Called at thread exit, records still queued are printed by the next flush
+static void nr5g_fapi_log_put_thread_ring(
+    void *p_ring)
+{
+    __atomic_store_n(&((nr5g_fapi_log_ring_t *) p_ring)->in_use, 0,
+        __ATOMIC_RELEASE);
+}
+
+static nr5g_fapi_log_ring_t *nr5g_fapi_log_get_thread_ring(
+    )
+{
+    uint32_t idx, num_rings;
+    uint8_t in_use;
+
+    if (p_nr5g_fapi_log_thread_ring)
+        return p_nr5g_fapi_log_thread_ring;
+
+    for (idx = 0; idx < NR5G_FAPI_LOG_MAX_THREADS; idx++) {
+        in_use = 0;
+        if (__atomic_compare_exchange_n(&nr5g_fapi_log_ring[idx].in_use,
+                &in_use, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            break;
+    }
+    if (idx >= NR5G_FAPI_LOG_MAX_THREADS)
+        return NULL;
+
+    num_rings = __atomic_load_n(&nr5g_fapi_log_num_rings, __ATOMIC_RELAXED);
+    while (num_rings <= idx &&
+        !__atomic_compare_exchange_n(&nr5g_fapi_log_num_rings, &num_rings,
+            idx + 1, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    pthread_setspecific(nr5g_fapi_log_ring_key, &nr5g_fapi_log_ring[idx]);
+    p_nr5g_fapi_log_thread_ring = &nr5g_fapi_log_ring[idx];
+
+    return p_nr5g_fapi_log_thread_ring;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup        group_lte_source_phy_api
+ *
+ *  @param[in]      type  Log level
+ *  @param[in]      p_fmt printf format string, must be a string literal
+ *
+ *  @return         void
+ *
+ *  @description    Queues a log message to the ring of the calling thread.
+ *                  Only the format pointer and the raw arguments are copied,
+ *                  %s arguments are copied up to NR5G_FAPI_LOG_STR_SIZE bytes
+ *                  in total. The message is dropped when the ring is full.
+ *
+ **/
+//------------------------------------------------------------------------------
+void nr5g_fapi_log_push(
+    nr5g_fapi_log_types_t type,
+    const char *p_fmt,
+    ...)
+{
+    nr5g_fapi_log_ring_t *p_ring = nr5g_fapi_log_get_thread_ring();
+    nr5g_fapi_log_record_t *p_rec;
+    nr5g_fapi_log_arg_class_t arg_class;
+    const char *p_str;
+    uint32_t head;
+    uint8_t num_star, len;
+    double val;
+    va_list ap;
+
+    if (!p_ring) {
+        // more logging threads than rings, print synchronously
+        va_start(ap, p_fmt);
+        printf("[%s]", get_logger_type_str(type));
+        vprintf(p_fmt, ap);
+        printf("\n");
+        va_end(ap);
+        return;
+    }
+
+    head = p_ring->head;
+    if ((head - __atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE)) >=
+        NR5G_FAPI_LOG_RING_SIZE) {
+        p_ring->num_dropped++;
+        return;
+    }
+    p_rec = &p_ring->record[head & (NR5G_FAPI_LOG_RING_SIZE - 1)];
+    p_rec->p_fmt = p_fmt;
+    p_rec->type = (uint8_t) type;
+    p_rec->num_args = 0;
+    p_rec->str_len = 0;
+
+    va_start(ap, p_fmt);
+    for (; *p_fmt; p_fmt++) {
+        if (*p_fmt != '%')
+            continue;
+        p_fmt = nr5g_fapi_log_parse_spec(p_fmt + 1, &arg_class, &num_star);
+        if (arg_class == NR5G_FAPI_LOG_ARG_INVALID ||
+            (p_rec->num_args + num_star + 1) > NR5G_FAPI_LOG_MAX_ARGS)
+            break;
+        if (arg_class == NR5G_FAPI_LOG_ARG_NONE)
+            continue;
+        while (num_star--)
+            p_rec->args[p_rec->num_args++] = (uint64_t) va_arg(ap, int);
+        switch (arg_class) {
+            case NR5G_FAPI_LOG_ARG_INT:
+                p_rec->args[p_rec->num_args++] = (uint64_t) va_arg(ap, int);
+                break;
+            case NR5G_FAPI_LOG_ARG_LONG:
+                p_rec->args[p_rec->num_args++] = (uint64_t) va_arg(ap, long);
+                break;
+            case NR5G_FAPI_LOG_ARG_LLONG:
+                p_rec->args[p_rec->num_args++] =
+                    (uint64_t) va_arg(ap, long long);
+                break;
+            case NR5G_FAPI_LOG_ARG_PTR:
+                p_rec->args[p_rec->num_args++] =
+                    (uint64_t) va_arg(ap, void *);
+                break;
+            case NR5G_FAPI_LOG_ARG_DOUBLE:
+                val = va_arg(ap, double);
+                memcpy(&p_rec->args[p_rec->num_args++], &val, sizeof(val));
+                break;
+            case NR5G_FAPI_LOG_ARG_STR:
+                p_str = va_arg(ap, const char *);
+                if (!p_str)
+                    p_str = "(null)";
+                len = (uint8_t) strnlen(p_str,
+                    NR5G_FAPI_LOG_STR_SIZE - 1 - p_rec->str_len);
+                memcpy(&p_rec->str[p_rec->str_len], p_str, len);
+                p_rec->args[p_rec->num_args++] = p_rec->str_len;
+                p_rec->str_len += len;
+                p_rec->str[p_rec->str_len++] = '\0';
+                if (p_rec->str_len >= NR5G_FAPI_LOG_STR_SIZE)
+                    p_rec->str_len = NR5G_FAPI_LOG_STR_SIZE - 1;
+                break;
+            default:
+                break;
+        }
+    }
+    va_end(ap);
+
+    __atomic_store_n(&p_ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup        group_lte_source_phy_api
+ *
+ *  @param[in]      p_rec Log record
+ *
+ *  @return         void
+ *
+ *  @description    Formats one log record to stdout, one conversion
+ *                  specification at a time.
+ *
+ **/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_log_print_record(
+    const nr5g_fapi_log_record_t * p_rec)
+{
+    const char *p_fmt = p_rec->p_fmt, *p_spec;
+    nr5g_fapi_log_arg_class_t arg_class;
+    char spec[32];
+    uint8_t num_star, arg = 0, len;
+    int star[2] = { 0, 0 };
+    double val;
+
+    printf("[%s]", get_logger_type_str((nr5g_fapi_log_types_t) p_rec->type));
+    while (*p_fmt) {
+        if (*p_fmt != '%') {
+            putchar(*p_fmt++);
+            continue;
+        }
+        p_spec = p_fmt;
+        p_fmt = nr5g_fapi_log_parse_spec(p_fmt + 1, &arg_class, &num_star);
+        if (arg_class == NR5G_FAPI_LOG_ARG_NONE) {
+            putchar('%');
+            p_fmt++;
+            continue;
+        }
+        if (arg_class == NR5G_FAPI_LOG_ARG_INVALID ||
+            (arg + num_star + 1) > p_rec->num_args) {
+            printf("...");
+            break;
+        }
+        len = (uint8_t) (p_fmt - p_spec + 1);
+        if (len >= sizeof(spec)) {
+            printf("...");
+            break;
+        }
+        memcpy(spec, p_spec, len);
+        spec[len] = '\0';
+        p_fmt++;
+        if (num_star > 2)
+            num_star = 2;
+        star[0] = num_star > 0 ? (int)p_rec->args[arg] : 0;
+        star[1] = num_star > 1 ? (int)p_rec->args[arg + 1] : 0;
+        arg += num_star;
+
+#define NR5G_FAPI_LOG_PRINT_ARG(VAL) do { \
+    if (num_star == 2) \
+        printf(spec, star[0], star[1], VAL); \
+    else if (num_star == 1) \
+        printf(spec, star[0], VAL); \
+    else \
+        printf(spec, VAL); \
+} while(0)
+
+        switch (arg_class) {
+            case NR5G_FAPI_LOG_ARG_INT:
+                NR5G_FAPI_LOG_PRINT_ARG((int)p_rec->args[arg]);
+                break;
+            case NR5G_FAPI_LOG_ARG_LONG:
+                NR5G_FAPI_LOG_PRINT_ARG((long)p_rec->args[arg]);
+                break;
+            case NR5G_FAPI_LOG_ARG_LLONG:
+                NR5G_FAPI_LOG_PRINT_ARG((long long)p_rec->args[arg]);
+                break;
+            case NR5G_FAPI_LOG_ARG_PTR:
+                NR5G_FAPI_LOG_PRINT_ARG((void *)p_rec->args[arg]);
+                break;
+            case NR5G_FAPI_LOG_ARG_DOUBLE:
+                memcpy(&val, &p_rec->args[arg], sizeof(val));
+                NR5G_FAPI_LOG_PRINT_ARG(val);
+                break;
+            case NR5G_FAPI_LOG_ARG_STR:
+                NR5G_FAPI_LOG_PRINT_ARG(&p_rec->str[p_rec->args[arg]]);
+                break;
+            default:
+                break;
+        }
+#undef NR5G_FAPI_LOG_PRINT_ARG
+        arg++;
+    }
+    printf("\n");
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup        group_lte_source_phy_api
+ *
+ *  @param          void
+ *
+ *  @return         void
+ *
+ *  @description    Formats and writes all queued log records of all threads.
+ *
+ **/
+//------------------------------------------------------------------------------
+void nr5g_fapi_log_flush(
+    )
+{
+    nr5g_fapi_log_ring_t *p_ring;
+    uint32_t idx, num_rings, tail, head, num_dropped;
+
+    pthread_mutex_lock(&nr5g_fapi_log_flush_lock);
+    num_rings = __atomic_load_n(&nr5g_fapi_log_num_rings, __ATOMIC_ACQUIRE);
+    if (num_rings > NR5G_FAPI_LOG_MAX_THREADS)
+        num_rings = NR5G_FAPI_LOG_MAX_THREADS;
+    for (idx = 0; idx < num_rings; idx++) {
+        p_ring = &nr5g_fapi_log_ring[idx];
+        tail = p_ring->tail;
+        head = __atomic_load_n(&p_ring->head, __ATOMIC_ACQUIRE);
+        for (; tail != head; tail++) {
+            nr5g_fapi_log_print_record(&p_ring->record[tail &
+                    (NR5G_FAPI_LOG_RING_SIZE - 1)]);
+        }
+        __atomic_store_n(&p_ring->tail, tail, __ATOMIC_RELEASE);
+
+        num_dropped = p_ring->num_dropped;
+        if (num_dropped != p_ring->num_dropped_seen) {
+            printf("[%s][LOGGER] %u log messages dropped\n",
+                get_logger_type_str(ERROR_LOG),
+                num_dropped - p_ring->num_dropped_seen);
+            p_ring->num_dropped_seen = num_dropped;
+        }
+    }
+    fflush(stdout);
+    pthread_mutex_unlock(&nr5g_fapi_log_flush_lock);
+}
+
+static void *nr5g_fapi_log_thread_func(
+    void *config)
+{
+    UNUSED(config);
+
+    while (1) {
+        nr5g_fapi_log_flush();
+        usleep(1000);
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup        group_lte_source_phy_api
+ *
+ *  @param[in]      core_id Core the logger thread is pinned to
+ *
+ *  @return         SUCCESS or FAILURE
+ *
+ *  @description    Starts the logger thread and switches NR5G_FAPI_LOG to the
+ *                  per thread rings. Queued messages are flushed at exit.
+ *
+ **/
+//------------------------------------------------------------------------------
+uint8_t nr5g_fapi_log_async_start(
+    uint8_t core_id)
+{
+    pthread_t thread_id;
+    pthread_attr_t attr;
+    cpu_set_t cpuset;
+    int ret;
+
+    if (0 != pthread_key_create(&nr5g_fapi_log_ring_key,
+            nr5g_fapi_log_put_thread_ring)) {
+        printf("Error: Unable to create logger thread key\n");
+        return FAILURE;
+    }
+
+    CPU_ZERO(&cpuset);
+    CPU_SET(core_id, &cpuset);
+    pthread_attr_init(&attr);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuset);
+    ret = pthread_create(&thread_id, &attr, nr5g_fapi_log_thread_func, NULL);
+    pthread_attr_destroy(&attr);
+    if (0 != ret) {
+        printf("Error: Unable to create logger thread\n");
+        return FAILURE;
+    }
+    pthread_setname_np(thread_id, "nr5g_fapi_logger");
+    pthread_detach(thread_id);
+    atexit(nr5g_fapi_log_flush);
+    nr5g_fapi_log_async_g = true;
+
+    return SUCCESS;
+}
+
 #ifdef STATISTIC_MODE
 uint16_t nr5g_fapi_statistic_info_set(
     nr5g_fapi_performance_statistic_t * fapi_statis_info,
@@ -0,0 +1,442 @@
+/******************************************************************************
+*
+*   Copyright (c) 2021 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @file This file defines the FAPI message recorder. The MAC2PHY and PHY2MAC
+ * receive paths stage every block they receive in a per direction buffer,
+ * complete blocks are written to the recording file under a lock.
+ *
+ **/
+#include "nr5g_fapi_std.h"
+#include "nr5g_fapi_framework.h"
+#include "nr5g_fapi_wls.h"
+#include "nr5g_fapi_memory.h"
+#include "nr5g_fapi_recorder.h"
+#include "nr5g_mac_phy_api.h"
+#include <immintrin.h>
+
+typedef struct _nr5g_fapi_rec_stage_t {
+    uint8_t *p_buf;
+    uint32_t len;
+    uint32_t seq;
+    uint16_t num_elems;
+    bool overflow;
+    uint64_t tsc;
+} nr5g_fapi_rec_stage_t;
+
+typedef struct _nr5g_fapi_recorder_t {
+    FILE *fp;
+    pthread_mutex_t lock;
+    uint64_t written;
+    uint64_t max_size;
+    uint64_t num_dropped;
+    nr5g_fapi_rec_stage_t stage[NR5G_FAPI_REC_NUM_DIR];
+} nr5g_fapi_recorder_t;
+
+volatile bool nr5g_fapi_recorder_active_g = false;
+static nr5g_fapi_recorder_t nr5g_fapi_recorder;
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   file_name   Recording file
+ *  @param[in]   max_size_mb Recording stops once the file reaches this size
+ *
+ *  @return  SUCCESS or FAILURE
+ *
+ *  @description
+ *  Creates the recording file and starts recording the received APIs.
+ *
+**/
+//------------------------------------------------------------------------------
+uint8_t nr5g_fapi_recorder_open(
+    const char *file_name,
+    uint32_t max_size_mb)
+{
+    nr5g_fapi_recorder_t *p_rec = &nr5g_fapi_recorder;
+    nr5g_fapi_rec_file_hdr_t hdr;
+    uint64_t start_tick;
+    uint8_t dir;
+
+    p_rec->fp = fopen(file_name, "wb");
+    if (NULL == p_rec->fp) {
+        NR5G_FAPI_LOG(ERROR_LOG, ("[RECORDER] Unable to create %s",
+                file_name));
+        return FAILURE;
+    }
+    for (dir = 0; dir < NR5G_FAPI_REC_NUM_DIR; dir++) {
+        p_rec->stage[dir].p_buf = malloc(NR5G_FAPI_REC_MAX_BLOCK_SIZE);
+        if (NULL == p_rec->stage[dir].p_buf) {
+            NR5G_FAPI_LOG(ERROR_LOG, ("[RECORDER] Out of memory"));
+            nr5g_fapi_recorder_close();
+            return FAILURE;
+        }
+    }
+    pthread_mutex_init(&p_rec->lock, NULL);
+
+    // replay reports latencies in us, store the TSC rate with the recording
+    start_tick = __rdtsc();
+    usleep(100000);
+    NR5G_FAPI_MEMSET(&hdr, sizeof(hdr), 0, sizeof(hdr));
+    memcpy(hdr.magic, NR5G_FAPI_REC_MAGIC, sizeof(hdr.magic));
+    hdr.version = NR5G_FAPI_REC_VERSION;
+    hdr.hdr_len = sizeof(hdr);
+    hdr.tsc_hz = (__rdtsc() - start_tick) * 10;
+    fwrite(&hdr, sizeof(hdr), 1, p_rec->fp);
+
+    p_rec->written = sizeof(hdr);
+    p_rec->max_size = (uint64_t) max_size_mb << 20;
+    nr5g_fapi_recorder_active_g = true;
+    NR5G_FAPI_LOG(INFO_LOG, ("[RECORDER] Recording to %s", file_name));
+
+    return SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param   void
+ *
+ *  @return  none
+ *
+ *  @description
+ *  Stops recording and closes the recording file.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_recorder_close(
+    )
+{
+    nr5g_fapi_recorder_t *p_rec = &nr5g_fapi_recorder;
+    uint8_t dir;
+
+    if (NULL == p_rec->fp)
+        return;
+
+    nr5g_fapi_recorder_active_g = false;
+    pthread_mutex_lock(&p_rec->lock);
+    fclose(p_rec->fp);
+    p_rec->fp = NULL;
+    pthread_mutex_unlock(&p_rec->lock);
+    if (p_rec->num_dropped) {
+        NR5G_FAPI_LOG(ERROR_LOG, ("[RECORDER] %lu blocks not recorded",
+                p_rec->num_dropped));
+    }
+    for (dir = 0; dir < NR5G_FAPI_REC_NUM_DIR; dir++) {
+        free(p_rec->stage[dir].p_buf);
+        p_rec->stage[dir].p_buf = NULL;
+    }
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   dir  Receive direction
+ *
+ *  @return  none
+ *
+ *  @description
+ *  Starts staging a new block. Called by the receiving thread of the
+ *  direction only.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_recorder_block_begin(
+    nr5g_fapi_rec_dir_t dir)
+{
+    nr5g_fapi_rec_stage_t *p_stage = &nr5g_fapi_recorder.stage[dir];
+
+    p_stage->len = sizeof(nr5g_fapi_rec_block_hdr_t);
+    p_stage->num_elems = 0;
+    p_stage->overflow = false;
+    p_stage->tsc = __rdtsc();
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   p_stage  Staged block
+ *  @param[in]   p_data   Data to append
+ *  @param[in]   len      Number of bytes
+ *
+ *  @return  Location of the data in the staged block, NULL if it is full
+ *
+ *  @description
+ *  Appends data padded to 8 bytes to the staged block.
+ *
+**/
+//------------------------------------------------------------------------------
+static uint8_t *nr5g_fapi_recorder_append(
+    nr5g_fapi_rec_stage_t * p_stage,
+    const void *p_data,
+    uint32_t len)
+{
+    uint8_t *p_dst;
+    uint32_t padded = NR5G_FAPI_REC_ALIGN(len);
+
+    if (p_stage->overflow ||
+        (p_stage->len + padded > NR5G_FAPI_REC_MAX_BLOCK_SIZE)) {
+        p_stage->overflow = true;
+        return NULL;
+    }
+    p_dst = p_stage->p_buf + p_stage->len;
+    memcpy(p_dst, p_data, len);
+    memset(p_dst + len, 0, padded - len);
+    p_stage->len += padded;
+
+    return p_dst;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   p_ptr  Pointer to the payload
+ *  @param[in]   len    Payload length
+ *
+ *  @return  TRUE if the payload is in WLS memory
+ *
+ *  @description
+ *  Payload pointers are only followed when they point into the WLS region.
+ *
+**/
+//------------------------------------------------------------------------------
+static bool nr5g_fapi_recorder_is_wls_mem(
+    const void *p_ptr,
+    uint32_t len)
+{
+    p_nr5g_fapi_wls_context_t p_wls_ctx = nr5g_fapi_wls_context();
+    uint64_t start = (uint64_t) p_wls_ctx->shmem;
+    uint64_t addr = (uint64_t) p_ptr;
+
+    return (addr >= start) &&
+        (addr + len <= start + p_wls_ctx->shmem_size);
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   p_stage     Staged block
+ *  @param[in]   p_rec_hdr   Element header in the staged block
+ *  @param[in]   p_body      Message body in WLS memory
+ *  @param[in]   p_ptr       Payload pointer field in the message body
+ *  @param[in]   p_data      Payload virtual address
+ *  @param[in]   len         Payload length
+ *
+ *  @return  none
+ *
+ *  @description
+ *  Appends the payload referenced by a pointer of the message body.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_recorder_add_payload(
+    nr5g_fapi_rec_stage_t * p_stage,
+    nr5g_fapi_rec_elem_hdr_t * p_rec_hdr,
+    const uint8_t * p_body,
+    void *const *p_ptr,
+    const void *p_data,
+    uint32_t len)
+{
+    nr5g_fapi_rec_payload_hdr_t payload_hdr;
+
+    if ((NULL == p_rec_hdr) || (NULL == p_data) ||
+        !nr5g_fapi_recorder_is_wls_mem(p_data, len))
+        return;
+
+    payload_hdr.ptr_offset = (uint32_t) ((const uint8_t *)p_ptr - p_body);
+    payload_hdr.len = len;
+    if (nr5g_fapi_recorder_append(p_stage, &payload_hdr, sizeof(payload_hdr))
+        && nr5g_fapi_recorder_append(p_stage, p_data, len))
+        p_rec_hdr->num_payloads++;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   p_stage  Staged block
+ *  @param[in]   p_hdr    Element header
+ *  @param[in]   p_body   Message body
+ *
+ *  @return  Element header in the staged block, NULL if it is full
+ *
+ *  @description
+ *  Appends the element header and the message body to the staged block.
+ *
+**/
+//------------------------------------------------------------------------------
+static nr5g_fapi_rec_elem_hdr_t *nr5g_fapi_recorder_add_elem(
+    nr5g_fapi_rec_stage_t * p_stage,
+    nr5g_fapi_rec_elem_hdr_t * p_hdr,
+    const void *p_body)
+{
+    nr5g_fapi_rec_elem_hdr_t *p_rec_hdr;
+
+    p_rec_hdr = (nr5g_fapi_rec_elem_hdr_t *)
+        nr5g_fapi_recorder_append(p_stage, p_hdr, sizeof(*p_hdr));
+    if (NULL == p_rec_hdr ||
+        NULL == nr5g_fapi_recorder_append(p_stage, p_body, p_hdr->msg_len))
+        return NULL;
+    p_stage->num_elems++;
+
+    return p_rec_hdr;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   p_qelm  FAPI API queue element received from L2
+ *  @param[in]   flags   WLS flags
+ *
+ *  @return  none
+ *
+ *  @description
+ *  Stages a FAPI API. TX_DATA.request payloads are stored with the message.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_recorder_mac2phy_elem(
+    void *p_qelm,
+    uint16_t flags)
+{
+    nr5g_fapi_rec_stage_t *p_stage =
+        &nr5g_fapi_recorder.stage[NR5G_FAPI_REC_MAC2PHY];
+    p_fapi_api_queue_elem_t p_elm = (p_fapi_api_queue_elem_t) p_qelm;
+    nr5g_fapi_rec_elem_hdr_t hdr, *p_rec_hdr;
+    fapi_tx_data_req_t *p_tx_data_req;
+    fapi_tx_pdu_desc_t *p_pdu;
+    uint8_t *p_body = (uint8_t *) (p_elm + 1);
+    uint32_t length;
+    uint16_t idx;
+
+    hdr.msg_type = p_elm->msg_type;
+    hdr.flags = flags;
+    hdr.num_message_in_block = p_elm->num_message_in_block;
+    hdr.num_payloads = 0;
+    hdr.msg_len = p_elm->msg_len;
+    hdr.align_offset = p_elm->align_offset;
+    p_rec_hdr = nr5g_fapi_recorder_add_elem(p_stage, &hdr, p_body);
+
+    if (p_elm->msg_type != FAPI_TX_DATA_REQUEST)
+        return;
+
+    p_tx_data_req = (fapi_tx_data_req_t *) p_body;
+    for (idx = 0; (idx < p_tx_data_req->num_pdus) &&
+        (idx < FAPI_MAX_NUMBER_DL_PDUS_PER_TTI); idx++) {
+        p_pdu = &p_tx_data_req->pdu_desc[idx];
+        if (!p_pdu->num_tlvs || ((p_pdu->tlvs[0].tl.tag & 0xFF) !=
+                FAPI_TX_DATA_PTR_TO_PAYLOAD_64))
+            continue;
+        length = ((uint32_t) (p_pdu->tlvs[0].tl.tag >> 8) << 16) |
+            p_pdu->tlvs[0].tl.length;
+        nr5g_fapi_recorder_add_payload(p_stage, p_rec_hdr, p_body,
+            (void *const *)&p_pdu->tlvs[0].value,
+            (const void *)p_pdu->tlvs[0].value, length);
+    }
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   p_qelm  IAPI queue element received from L1
+ *  @param[in]   flags   WLS flags
+ *
+ *  @return  none
+ *
+ *  @description
+ *  Stages an IAPI message. RX_ULSCH.indication payloads are stored with the
+ *  message.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_recorder_phy2mac_elem(
+    void *p_qelm,
+    uint16_t flags)
+{
+    nr5g_fapi_rec_stage_t *p_stage =
+        &nr5g_fapi_recorder.stage[NR5G_FAPI_REC_PHY2MAC];
+    PMAC2PHY_QUEUE_EL p_elm = (PMAC2PHY_QUEUE_EL) p_qelm;
+    nr5g_fapi_rec_elem_hdr_t hdr, *p_rec_hdr;
+    PRXULSCHIndicationStruct p_rx_ulsch_ind;
+    ULSCHPDUDataStruct *p_pdu;
+    WLS_HANDLE h_wls = nr5g_fapi_wls_context()->h_wls[NR5G_FAPI2PHY_WLS_INST];
+    uint8_t *p_body = (uint8_t *) (p_elm + 1);
+    uint16_t idx;
+
+    hdr.msg_type = (uint16_t) p_elm->nMessageType;
+    hdr.flags = flags;
+    hdr.num_message_in_block = (uint16_t) p_elm->nNumMessageInBlock;
+    hdr.num_payloads = 0;
+    hdr.msg_len = p_elm->nMessageLen;
+    hdr.align_offset = p_elm->nAlignOffset;
+    p_rec_hdr = nr5g_fapi_recorder_add_elem(p_stage, &hdr, p_body);
+
+    if (p_elm->nMessageType != MSG_TYPE_PHY_RX_ULSCH_IND)
+        return;
+
+    p_rx_ulsch_ind = (PRXULSCHIndicationStruct) p_body;
+    for (idx = 0; idx < p_rx_ulsch_ind->nUlsch; idx++) {
+        p_pdu = &p_rx_ulsch_ind->sULSCHPDUDataStruct[idx];
+        nr5g_fapi_recorder_add_payload(p_stage, p_rec_hdr, p_body,
+            (void *const *)&p_pdu->pPayload, p_pdu->pPayload ?
+            nr5g_fapi_wls_pa_to_va(h_wls, (uint64_t) p_pdu->pPayload) : NULL,
+            p_pdu->nPduLen & 0xFFFF);
+    }
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   dir  Receive direction
+ *
+ *  @return  none
+ *
+ *  @description
+ *  Writes the staged block to the recording. Blocks which do not fit the
+ *  staging buffer or the configured file size are counted and dropped.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_recorder_block_end(
+    nr5g_fapi_rec_dir_t dir)
+{
+    nr5g_fapi_recorder_t *p_rec = &nr5g_fapi_recorder;
+    nr5g_fapi_rec_stage_t *p_stage = &p_rec->stage[dir];
+    nr5g_fapi_rec_block_hdr_t *p_hdr =
+        (nr5g_fapi_rec_block_hdr_t *) p_stage->p_buf;
+
+    if (!p_stage->num_elems)
+        return;
+
+    p_hdr->magic = NR5G_FAPI_REC_BLOCK_MAGIC;
+    p_hdr->dir = dir;
+    p_hdr->rsv = 0;
+    p_hdr->num_elems = p_stage->num_elems;
+    p_hdr->len = p_stage->len - sizeof(*p_hdr);
+    p_hdr->seq = p_stage->seq++;
+    p_hdr->tsc = p_stage->tsc;
+
+    pthread_mutex_lock(&p_rec->lock);
+    if (p_rec->fp && !p_stage->overflow &&
+        (p_rec->written + p_stage->len <= p_rec->max_size)) {
+        fwrite(p_stage->p_buf, p_stage->len, 1, p_rec->fp);
+        p_rec->written += p_stage->len;
+    } else {
+        p_rec->num_dropped++;
+    }
+    pthread_mutex_unlock(&p_rec->lock);
+}
@@ -27,12 +27,43 @@
 
 #include "nr5g_mac_phy_api.h"
 
+// SNR in dB, rounded away from zero, to 0.5dB steps from -64dB (ul_cqi).
+// A float holds snr / SINR_STEP_SIZE exactly enough for int16_t snr, so
+// floorf/ceilf give the same integer as the double math did.
+static inline uint8_t nr5g_fapi_snr_to_ul_cqi(
+    const int16_t snr)
+{
+    const float temp = (float)snr / (float)SINR_STEP_SIZE;
+    const int32_t snr_db = (int32_t)(temp < 0.0f ? floorf(temp) : ceilf(temp));
+
+    return (uint8_t)(2 * (snr_db & 0x3F) + (temp < 0.0f ? 0 : 128));
+}
+
 uint8_t nr5g_fapi_convert_snr_iapi_to_fapi(const int16_t snr)
 {
-    double temp = (double)snr / SINR_STEP_SIZE;
-    if (temp < 0)
-    {
-        return 2 * ((uint8_t)floor(temp) & 0x003F);
+    return nr5g_fapi_snr_to_ul_cqi(snr);
+}
+
+void nr5g_fapi_convert_snr_iapi_to_fapi_array(
+    const int16_t *__restrict p_snr,
+    uint8_t *__restrict p_ul_cqi,
+    uint32_t num)
+{
+    uint32_t i;
+
+    for (i = 0; i < num; i++) {
+        p_ul_cqi[i] = nr5g_fapi_snr_to_ul_cqi(p_snr[i]);
+    }
+}
+
+void nr5g_fapi_convert_srs_snr_iapi_to_fapi_array(
+    const int8_t *__restrict p_snr,
+    uint8_t *__restrict p_fapi_snr,
+    uint32_t num)
+{
+    uint32_t i;
+
+    for (i = 0; i < num; i++) {
+        p_fapi_snr[i] = nr5g_fapi_convert_srs_snr_iapi_to_fapi(p_snr[i]);
     }
-    return (2 * ((uint8_t)ceil(temp) & 0x003F)) + 128;
 }
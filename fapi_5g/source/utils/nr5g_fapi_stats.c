@@ -26,6 +26,222 @@
 
 #define NR5G_FAPI_STATS_FNAME_LEN   64
 
+static const char *nr5g_fapi_latency_msg_name[NR5G_FAPI_LAT_MSG_MAX] = {
+    "CONFIG.req", "START.req", "STOP.req", "DL_TTI.req", "UL_TTI.req",
+    "UL_DCI.req", "TX_DATA.req", "SLOT.ind", "CRC.ind", "RX_DATA.ind",
+    "RX_DATA_UCI.ind", "UCI.ind", "SRS.ind", "RACH.ind"
+};
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   bucket  Histogram bucket index
+ *
+ *  @return Highest latency in cycles falling into the bucket
+ *
+ *  @description
+ *  Inverse of nr5g_fapi_latency_bucket.
+ *
+**/
+//------------------------------------------------------------------------------
+static uint64_t nr5g_fapi_latency_bucket_limit(
+    uint32_t bucket)
+{
+    uint32_t shift;
+
+    if (bucket < (1 << NR5G_FAPI_LAT_SUB_BUCKET_BITS))
+        return bucket;
+
+    shift = (bucket >> NR5G_FAPI_LAT_SUB_BUCKET_BITS) - 1;
+    return ((((uint64_t) bucket & ((1 << NR5G_FAPI_LAT_SUB_BUCKET_BITS) - 1))
+            + (1 << NR5G_FAPI_LAT_SUB_BUCKET_BITS) + 1) << shift) - 1;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   p_hist      Latency histogram
+ *  @param[in]   percentile  Percentile in the range (0, 1]
+ *
+ *  @return Latency in cycles at the percentile, 0 if the histogram is empty
+ *
+ *  @description
+ *  Returns the upper limit of the bucket holding the percentile, clamped to
+ *  the observed min and max.
+ *
+**/
+//------------------------------------------------------------------------------
+uint64_t nr5g_fapi_latency_percentile(
+    nr5g_fapi_latency_hist_t * p_hist,
+    double percentile)
+{
+    uint64_t target, cumulative = 0, value;
+    uint32_t bucket;
+
+    if (!p_hist->count)
+        return 0;
+
+    target = (uint64_t) (percentile * p_hist->count + 0.999999);
+    if (!target)
+        target = 1;
+    for (bucket = 0; bucket < NR5G_FAPI_LAT_NUM_BUCKETS; bucket++) {
+        cumulative += p_hist->bucket[bucket];
+        if (cumulative >= target)
+            break;
+    }
+    value = nr5g_fapi_latency_bucket_limit(bucket);
+    if (value > p_hist->max)
+        value = p_hist->max;
+    if (value < p_hist->min)
+        value = p_hist->min;
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   fp              Output stream
+ *  @param[in]   p_phy_instance  PHY instance
+ *
+ *  @return none
+ *
+ *  @description
+ *  Prints count, min, avg, p50, p99, p99.9 and max of every non empty latency
+ *  histogram of the PHY instance in Kcycles.
+ *
+**/
+//------------------------------------------------------------------------------
+static void nr5g_fapi_fprint_phy_latency_stats(
+    FILE * fp,
+    p_nr5g_fapi_phy_instance_t p_phy_instance)
+{
+    nr5g_fapi_latency_hist_t *p_hist;
+    uint8_t is_urllc, msg;
+    bool header = false;
+
+    for (is_urllc = 0; is_urllc < FAPI_MAX_SLOT_INFO_URLLC; is_urllc++) {
+        for (msg = 0; msg < NR5G_FAPI_LAT_MSG_MAX; msg++) {
+            p_hist = &p_phy_instance->stats.latency[is_urllc][msg];
+            if (!p_hist->count)
+                continue;
+            if (!header) {
+                fprintf(fp, "5GNR FAPI latency Kcycle PhyId: %u\n",
+                    p_phy_instance->phy_id);
+                fprintf(fp, "%*s %5s %10s %9s %9s %9s %9s %9s %9s\n", 16,
+                    "Msg", "URLLC", "Count", "Min", "Avg", "p50", "p99",
+                    "p99.9", "Max");
+                header = true;
+            }
+            fprintf(fp, "%*s %5u %10lu %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+                16, nr5g_fapi_latency_msg_name[msg], is_urllc, p_hist->count,
+                p_hist->min / 1000., p_hist->total / p_hist->count / 1000.,
+                nr5g_fapi_latency_percentile(p_hist, 0.5) / 1000.,
+                nr5g_fapi_latency_percentile(p_hist, 0.99) / 1000.,
+                nr5g_fapi_latency_percentile(p_hist, 0.999) / 1000.,
+                p_hist->max / 1000.);
+        }
+    }
+    if (header)
+        fprintf(fp, "\n");
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param   void
+ *
+ *  @return none
+ *
+ *  @description
+ *  Prints the latency histograms summary of all PHY instances on the console.
+ *
+**/
+//------------------------------------------------------------------------------
+void nr5g_fapi_print_latency_stats(
+    )
+{
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx = nr5g_fapi_get_nr5g_fapi_phy_ctx();
+    uint8_t phy_id;
+
+    for (phy_id = 0; phy_id < FAPI_MAX_PHY_INSTANCES; phy_id++) {
+        nr5g_fapi_fprint_phy_latency_stats(stdout,
+            &p_phy_ctx->phy_instance[phy_id]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/** @ingroup group_source_utils
+ *
+ *  @param[in]   fname  Output file name
+ *
+ *  @return SUCCESS or FAILURE
+ *
+ *  @description
+ *  Writes every non empty latency histogram of all PHY instances as JSON.
+ *  Latencies are in TSC cycles, buckets are listed as [upper limit, count]
+ *  pairs for the non empty buckets only.
+ *
+**/
+//------------------------------------------------------------------------------
+uint8_t nr5g_fapi_dump_latency_stats(
+    const char *fname)
+{
+    p_nr5g_fapi_phy_ctx_t p_phy_ctx = nr5g_fapi_get_nr5g_fapi_phy_ctx();
+    nr5g_fapi_latency_hist_t *p_hist;
+    uint8_t phy_id, is_urllc, msg;
+    uint32_t bucket;
+    bool first_hist = true, first_bucket;
+    FILE *fp;
+
+    fp = fopen(fname, "w");
+    if (NULL == fp) {
+        NR5G_FAPI_LOG(ERROR_LOG, ("Failed to open the file %s\n", fname));
+        return FAILURE;
+    }
+
+    fprintf(fp, "{\n  \"unit\": \"tsc_cycles\",\n  \"histograms\": [");
+    for (phy_id = 0; phy_id < FAPI_MAX_PHY_INSTANCES; phy_id++) {
+        for (is_urllc = 0; is_urllc < FAPI_MAX_SLOT_INFO_URLLC; is_urllc++) {
+            for (msg = 0; msg < NR5G_FAPI_LAT_MSG_MAX; msg++) {
+                p_hist =
+                    &p_phy_ctx->phy_instance[phy_id].stats.latency[is_urllc]
+                    [msg];
+                if (!p_hist->count)
+                    continue;
+                fprintf(fp, "%s\n    {\"phy_id\": %u, \"urllc\": %u, "
+                    "\"msg\": \"%s\", \"count\": %lu, \"min\": %lu, "
+                    "\"avg\": %lu, \"p50\": %lu, \"p99\": %lu, "
+                    "\"p999\": %lu, \"max\": %lu, \"buckets\": [",
+                    first_hist ? "" : ",", phy_id, is_urllc,
+                    nr5g_fapi_latency_msg_name[msg], p_hist->count,
+                    p_hist->min, p_hist->total / p_hist->count,
+                    nr5g_fapi_latency_percentile(p_hist, 0.5),
+                    nr5g_fapi_latency_percentile(p_hist, 0.99),
+                    nr5g_fapi_latency_percentile(p_hist, 0.999), p_hist->max);
+                first_hist = false;
+                first_bucket = true;
+                for (bucket = 0; bucket < NR5G_FAPI_LAT_NUM_BUCKETS; bucket++) {
+                    if (!p_hist->bucket[bucket])
+                        continue;
+                    fprintf(fp, "%s[%lu, %u]", first_bucket ? "" : ", ",
+                        nr5g_fapi_latency_bucket_limit(bucket),
+                        p_hist->bucket[bucket]);
+                    first_bucket = false;
+                }
+                fprintf(fp, "]}");
+            }
+        }
+    }
+    fprintf(fp, "\n  ]\n}\n");
+
+    if (EOF == fclose(fp)) {
+        NR5G_FAPI_LOG(ERROR_LOG, ("Unable to close the file\n"));
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
 void nr5g_fapi_print_phy_instance_stats(
     p_nr5g_fapi_phy_instance_t p_phy_instance)
 {
@@ -205,6 +421,7 @@ void nr5g_fapi_print_phy_instance_stats(
     fprintf(fp, "%*s: %lu\t\t\t\n", 14, "RachPreambles",
         p_stats->iapi_stats.iapi_rach_preambles);
     fprintf(fp, "\n");
+    nr5g_fapi_fprint_phy_latency_stats(fp, p_phy_instance);
     if (EOF == fclose(fp)) {
         NR5G_FAPI_LOG(ERROR_LOG, ("Unable to close the file\n"));
     }
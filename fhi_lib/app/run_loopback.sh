@@ -0,0 +1,55 @@
+#! /bin/bash
+
+#******************************************************************************
+#
+#   Copyright (c) 2020 Intel.
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+#******************************************************************************/
+
+# O-DU and O-RU sample apps on one host without a NIC.
+#   ./run_loopback.sh [memif|afpkt]
+# memif  - DPDK memif over a unix socket
+# afpkt  - DPDK af_packet over the veth pair xran_du0 - xran_ru0
+# Run from the app directory after building ./build/sample-app and
+# ./build-oru/sample-app-ru.
+
+MODE=${1:-memif}
+USECASE=./usecase/loopback/mu1_100mhz
+
+case $MODE in
+    memif)
+        rm -f /tmp/xran_memif0.sock
+        ;;
+    afpkt)
+        if ! ip link show xran_du0 > /dev/null 2>&1; then
+            ip link add xran_du0 type veth peer name xran_ru0
+        fi
+        ip link set dev xran_du0 address 00:11:22:33:00:00 mtu 1500 up
+        ip link set dev xran_ru0 address 00:11:22:33:00:01 mtu 1500 up
+        ;;
+    *)
+        echo "usage: $0 [memif|afpkt]"
+        exit 1
+        ;;
+esac
+
+ulimit -c unlimited
+
+# the O-DU is the memif server, start it first
+./build/sample-app --usecasefile $USECASE/usecase_du_$MODE.cfg &
+DU_PID=$!
+sleep 2
+./build-oru/sample-app-ru --usecasefile $USECASE/usecase_ru_$MODE.cfg
+wait $DU_PID
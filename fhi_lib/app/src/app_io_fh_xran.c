@@ -78,6 +78,7 @@ struct bbu_xran_io_if *app_io_xran_if_alloc(void)
     {
         rte_panic("_mm_malloc: Can't allocate %lu bytes\n", sizeof(struct bbu_xran_io_if));
     }
+    memset(ptr, 0, sizeof(struct bbu_xran_io_if));
     p_app_io_xran_if = (struct bbu_xran_io_if *)ptr;
     return p_app_io_xran_if;
 }
@@ -89,6 +90,8 @@ struct bbu_xran_io_if *app_io_xran_if_get(void)
 
 void app_io_xran_if_free(void)
 {
+    int32_t o_xu_id, dir, cc_id, ant_id;
+
     if(xran_mm_destroy(app_io_xran_handle[0]) != XRAN_STATUS_SUCCESS)
     {
         printf("Failed at xran_mm_destroy!\n");
@@ -98,6 +101,11 @@ void app_io_xran_if_free(void)
     {
         rte_panic("_mm_free: Can't free p_app_io_xran_if\n");
     }
+    for (o_xu_id = 0; o_xu_id < XRAN_PORTS_NUM; o_xu_id++)
+        for (dir = 0; dir < XRAN_DIR_MAX; dir++)
+            for (cc_id = 0; cc_id < XRAN_MAX_SECTOR_NR; cc_id++)
+                for (ant_id = 0; ant_id < XRAN_MAX_ANTENNA_NR; ant_id++)
+                    xran_cp_bfw_cache_free(p_app_io_xran_if->ioCtrl[o_xu_id].pBfwCache[dir][cc_id][ant_id]);
     _mm_free(p_app_io_xran_if);
     return;
 }
@@ -143,6 +151,26 @@ int32_t app_io_xran_sfidx_get(uint8_t mu)
     return nSfIdx;
 }
 
+/* snapshot the per symbol packet counters of a received UL slot and reset them for the next use of the buffer */
+static void
+app_io_xran_rx_slot_handoff(struct xran_io_shared_ctrl *psIoCtrl, uint32_t xran_max_antenna_nr, int32_t ntti, int32_t nCellIdx, uint8_t mu)
+{
+    struct xran_prb_map *pRbMap = NULL;
+    uint32_t ant_id, sym_id;
+
+    for(ant_id = 0; ant_id < xran_max_antenna_nr; ant_id++) {
+        pRbMap = (struct xran_prb_map *) psIoCtrl->io_buff_perMu[mu].sFrontHaulRxPrbMapBbuIoBufCtrl[ntti][nCellIdx][ant_id].sBufferList.pBuffers->pData;
+        if(unlikely(pRbMap == NULL)){
+            printf("(%d:%d:%d)pRbMap == NULL\n", nCellIdx, ntti, ant_id);
+            exit(-1);
+        }
+        for(sym_id = 0; sym_id < XRAN_NUM_OF_SYMBOL_PER_SLOT; sym_id++) {
+            psIoCtrl->io_buff_perMu[mu].nRxPktBufCtrl[ntti][nCellIdx][ant_id][sym_id] = pRbMap->sFrontHaulRxPacketCtrl[sym_id].nRxPkt;
+            pRbMap->sFrontHaulRxPacketCtrl[sym_id].nRxPkt = 0;
+        }
+    }
+}
+
 void app_io_xran_fh_rx_callback(void *pCallbackTag, xran_status_t status, uint8_t mu)
 {
     uint64_t t1 = MLogTick();
@@ -160,7 +188,6 @@ void app_io_xran_fh_rx_callback(void *pCallbackTag, xran_status_t status, uint8_
     struct xran_fh_config  *pXranConf = &app_io_xran_fh_config[o_xu_id];
     uint32_t xran_max_antenna_nr = RTE_MAX(pXranConf->neAxc, pXranConf->neAxcUl);
     //int32_t nSectorNum = pXranConf->nCC;
-    uint32_t ant_id, sym_id;
 
     mlog_start = MLogTick();
 
@@ -204,21 +231,9 @@ void app_io_xran_fh_rx_callback(void *pCallbackTag, xran_status_t status, uint8_
 
     for(nCellIdx = pTag->cellId; nCellIdx < (pTag->cellId + pXranConf->nCC); ++nCellIdx)
     {
-        struct xran_prb_map *pRbMap = NULL;
-        if(sym == XRAN_FULL_CB_SYM)  //full slot callback only
-        {
-            for(ant_id = 0; ant_id < xran_max_antenna_nr; ant_id++) {
-                pRbMap = (struct xran_prb_map *) psIoCtrl->io_buff_perMu[mu].sFrontHaulRxPrbMapBbuIoBufCtrl[ntti][nCellIdx][ant_id].sBufferList.pBuffers->pData;
-                if(unlikely(pRbMap == NULL)){
-                    printf("(%d:%d:%d)pRbMap == NULL\n", nCellIdx, ntti, ant_id);
-                    exit(-1);
-                }
-                for(sym_id = 0; sym_id < XRAN_NUM_OF_SYMBOL_PER_SLOT; sym_id++) {
-                    psIoCtrl->io_buff_perMu[mu].nRxPktBufCtrl[ntti][nCellIdx][ant_id][sym_id] = pRbMap->sFrontHaulRxPacketCtrl[sym_id].nRxPkt;
-                    pRbMap->sFrontHaulRxPacketCtrl[sym_id].nRxPkt = 0;
-                }
-            }
-        }
+        /* with early UL completion the slot is handed off from app_io_xran_ul_done_call_back() */
+        if(sym == XRAN_FULL_CB_SYM && psIoCtrl->ulDoneCbMode == 0)  //full slot callback only
+            app_io_xran_rx_slot_handoff(psIoCtrl, xran_max_antenna_nr, ntti, nCellIdx, mu);
 
         rte_pause();
     } /*for nCellIDx*/
@@ -434,6 +449,35 @@ app_io_xran_ul_full_slot_call_back(void * param, uint8_t mu)
     return 0;
 }
 
+void
+app_io_xran_ul_done_call_back(void * param, uint16_t ccId, uint32_t tti, uint8_t symb, uint8_t mu)
+{
+    uint64_t t1 = MLogTick();
+    uint32_t mlogVar[5];
+    uint32_t mlogVarCnt = 0;
+
+    mlogVar[mlogVarCnt++] = 0xBEEFBEEF;
+    mlogVar[mlogVarCnt++] = ccId;
+    mlogVar[mlogVarCnt++] = tti;
+    mlogVar[mlogVarCnt++] = symb;
+    mlogVar[mlogVarCnt++] = mu;
+    MLogAddVariables(mlogVarCnt, mlogVar, MLogTick());
+
+    /* each UL slot of a CC is reported exactly once, either complete or at the deadline */
+    if(symb == XRAN_UL_DONE_SLOT_SYM || symb == XRAN_UL_DONE_TIMEOUT_SYM)
+    {
+        int32_t o_xu_id = (int32_t)(intptr_t)param;
+        struct xran_io_shared_ctrl *psIoCtrl = app_io_xran_if_ctrl_get(o_xu_id);
+        struct xran_fh_config  *pXranConf = &app_io_xran_fh_config[o_xu_id];
+        int32_t ntti = (tti + XRAN_N_FE_BUF_LEN - 1) % XRAN_N_FE_BUF_LEN;
+
+        if(likely(psIoCtrl != NULL))
+            app_io_xran_rx_slot_handoff(psIoCtrl, RTE_MAX(pXranConf->neAxc, pXranConf->neAxcUl), ntti, ccId, mu);
+    }
+
+    MLogTask(PID_GNB_PROC_TIMING, t1, MLogTick());
+}
+
 int32_t
 app_io_xran_ul_custom_sym_call_back(void * param, struct xran_sense_of_time* time)
 {
@@ -1348,13 +1392,15 @@ app_io_xran_ext_type1_populate(struct xran_prb_elm* p_pRbMapElm, char *p_bfw_buf
 }
 
 int32_t
-app_io_xran_ext_type11_populate(struct xran_prb_elm* p_pRbMapElm, char *p_tx_dl_bfw_buffer, uint32_t mtu)
+app_io_xran_ext_type11_populate(struct xran_prb_elm* p_pRbMapElm, char *p_tx_dl_bfw_buffer, uint32_t mtu,
+                                struct xran_cp_bfw_cache *pBfwCache, uint16_t eAxC)
 {
     xran_status_t status = XRAN_STATUS_SUCCESS;
 
     int32_t i;
     uint8_t *extbuf;
     int32_t n_max_set_bfw;
+    uint8_t beamIdOnly = 0;
 
     p_pRbMapElm->bf_weight.maxExtBufSize = mtu;    /* MAX_RX_LEN; */  /* Maximum space of external buffer */
     if (p_pRbMapElm->bf_weight.p_ext_start)
@@ -1389,7 +1435,22 @@ app_io_xran_ext_type11_populate(struct xran_prb_elm* p_pRbMapElm, char *p_tx_dl_
         p_pRbMapElm->bf_weight.bfw[i].beamId = 0x7000+i;
     }
 #endif
-    n_max_set_bfw = xran_cp_prepare_ext11_bfws(p_pRbMapElm->bf_weight.numSetBFWs,
+    if(pBfwCache) {
+        n_max_set_bfw = xran_cp_prepare_ext11_bfws_cached(pBfwCache, eAxC,
+                                p_pRbMapElm->bf_weight.numSetBFWs,
+                                p_pRbMapElm->bf_weight.nAntElmTRx,
+                                p_pRbMapElm->bf_weight.bfwIqWidth,
+                                p_pRbMapElm->bf_weight.bfwCompMeth,
+                                extbuf,
+                                p_pRbMapElm->bf_weight.maxExtBufSize,
+                                p_pRbMapElm->bf_weight.bfw,
+                                &beamIdOnly);
+        /* disableBFWs follows the cache only when it may send beamIds only,
+         * the configuration is checked to have it 0 then */
+        if(pBfwCache->beamIdOnly)
+            p_pRbMapElm->bf_weight.disableBFWs = beamIdOnly;
+    } else
+        n_max_set_bfw = xran_cp_prepare_ext11_bfws(p_pRbMapElm->bf_weight.numSetBFWs,
                                 p_pRbMapElm->bf_weight.nAntElmTRx,
                                 p_pRbMapElm->bf_weight.bfwIqWidth,
                                 p_pRbMapElm->bf_weight.bfwCompMeth,
@@ -1441,7 +1502,8 @@ app_io_xran_iq_content_init_dl_cp(uint8_t  appMode, struct xran_fh_config  *pXra
                         if(p_pRbMapElm->bf_weight.extType == 1) {
                             app_io_xran_ext_type1_populate(p_pRbMapElm, dl_bfw_pos, app_io_xran_fh_init.mtu, &numSetBFW_total);
                         } else {
-                            app_io_xran_ext_type11_populate(p_pRbMapElm, dl_bfw_pos, app_io_xran_fh_init.mtu);
+                            app_io_xran_ext_type11_populate(p_pRbMapElm, dl_bfw_pos, app_io_xran_fh_init.mtu,
+                                                            psIoCtrl->pBfwCache[XRAN_DIR_DL][cc_id][ant_id], flowId);
                         }
                     }
                     numSetBFW_total += p_pRbMapElm->bf_weight.numSetBFWs;
@@ -1493,7 +1555,8 @@ app_io_xran_iq_content_init_ul_cp(uint8_t  appMode, struct xran_fh_config  *pXra
                     if(p_pRbMapElm->bf_weight.extType == 1) {
                         app_io_xran_ext_type1_populate(p_pRbMapElm, ul_bfw_pos, app_io_xran_fh_init.mtu, &numSetBFW_total);
                     } else {
-                        app_io_xran_ext_type11_populate(p_pRbMapElm, ul_bfw_pos, app_io_xran_fh_init.mtu);
+                        app_io_xran_ext_type11_populate(p_pRbMapElm, ul_bfw_pos, app_io_xran_fh_init.mtu,
+                                                        psIoCtrl->pBfwCache[XRAN_DIR_UL][cc_id][ant_id], flowId);
                     }
                 } /* if(p_pRbMapElm->BeamFormingType == XRAN_BEAM_WEIGHT && p_pRbMapElm->bf_weight_update) */
                 numSetBFW_total += p_pRbMapElm->bf_weight.numSetBFWs;
@@ -1506,6 +1569,30 @@ app_io_xran_iq_content_init_ul_cp(uint8_t  appMode, struct xran_fh_config  *pXra
     return 0;
 }
 
+/* Union of the RE masks of the consecutive prbMap elements that share one U-plane packet
+ * (same PRBs and symbols, different reMask). Modulation compression only encodes the REs
+ * enabled in reMask, so the packet built for the first element has to cover all of them. */
+static int16_t
+app_io_xran_shared_re_mask(struct xran_prb_map *pRbMap, int32_t idxElm)
+{
+    struct xran_prb_elm *p_first = &pRbMap->prbMap[idxElm];
+    int16_t reMask = p_first->reMask;
+    int32_t i;
+
+    if (reMask == 0)
+        return 0xfff;
+
+    for (i = idxElm + 1; i < pRbMap->nPrbElm; i++) {
+        struct xran_prb_elm *p_next = &pRbMap->prbMap[i];
+        if (p_next->reMask == 0 || p_next->UP_nRBStart != p_first->UP_nRBStart || p_next->UP_nRBSize != p_first->UP_nRBSize
+                || p_next->nStartSymb != p_first->nStartSymb || p_next->numSymb != p_first->numSymb)
+            break;
+        reMask |= p_next->reMask;
+    }
+
+    return reMask;
+}
+
 int32_t
 app_io_xran_iq_content_init_up_tx(uint8_t  appMode, struct xran_fh_config  *pXranConf,
                                   struct bbu_xran_io_if *psBbuIo, struct xran_io_shared_ctrl *psIoCtrl, struct o_xu_buffers * p_iq,
@@ -1612,7 +1699,7 @@ app_io_xran_iq_content_init_up_tx(uint8_t  appMode, struct xran_fh_config  *pXra
                         bfp_com_req.compMethod = p_prbMapElm->compMethod;
                         bfp_com_req.iqWidth    = p_prbMapElm->iqWidth;
                         bfp_com_req.ScaleFactor= p_prbMapElm->ScaleFactor;
-                        bfp_com_req.reMask     = p_prbMapElm->reMask;
+                        bfp_com_req.reMask     = app_io_xran_shared_re_mask(pRbMap, idxElm);
 
                         bfp_com_rsp.data_out   = (int8_t*)dst;
                         bfp_com_rsp.len        = 0;
@@ -1824,7 +1911,7 @@ app_io_xran_iq_content_init_multi_section_up_tx(uint8_t  appMode, struct xran_fh
                         bfp_com_req.compMethod = p_prbMapElm->compMethod;
                         bfp_com_req.iqWidth    = p_prbMapElm->iqWidth;
                         bfp_com_req.ScaleFactor= p_prbMapElm->ScaleFactor;
-                        bfp_com_req.reMask     = p_prbMapElm->reMask;
+                        bfp_com_req.reMask     = app_io_xran_shared_re_mask(pRbMap, idxElm);
 
                         bfp_com_rsp.data_out   = (int8_t*)dst;
                         bfp_com_rsp.len        = 0;
@@ -2132,6 +2219,124 @@ app_io_xran_iq_content_init_up_csirs(uint8_t  appMode, struct xran_fh_config  *p
     return 0;
 }
 
+/* An extension 11 section of the map configured to send beamIds only */
+static int32_t
+app_io_xran_prb_map_bfw_disabled(const struct xran_prb_map *pRbMap)
+{
+    uint32_t idxElm;
+
+    if(pRbMap == NULL)
+        return 0;
+    for(idxElm = 0; idxElm < pRbMap->nPrbElm; idxElm++)
+        if(pRbMap->prbMap[idxElm].BeamFormingType == XRAN_BEAM_WEIGHT
+            && pRbMap->prbMap[idxElm].bf_weight.extType != 1
+            && pRbMap->prbMap[idxElm].bf_weight.disableBFWs)
+            return 1;
+    return 0;
+}
+
+/* beamIds only are sent when the O-RU is known to keep the BFWs per beamId, and then the cache
+ * owns disableBFWs of the extension 11 sections */
+static uint8_t
+app_io_xran_bfw_beam_id_only(RuntimeConfig *p_o_xu_cfg)
+{
+    int32_t dir, tti, cc_id, ant_id, mu_idx;
+    uint8_t mu;
+
+    if(p_o_xu_cfg->bfwCacheMode < 2)
+        return 0;
+    if(!p_o_xu_cfg->ruKeepsBfws) {
+        printf("bfwCacheMode %d: O-RU not configured to keep BFWs (ruKeepsBfws), BFWs are always sent\n",
+            p_o_xu_cfg->bfwCacheMode);
+        return 0;
+    }
+
+    for(mu_idx = 0; mu_idx < p_o_xu_cfg->numMu; mu_idx++) {
+        mu = p_o_xu_cfg->mu_number[mu_idx];
+        if(app_io_xran_prb_map_bfw_disabled(p_o_xu_cfg->p_PrbMapDl[mu])
+            || app_io_xran_prb_map_bfw_disabled(p_o_xu_cfg->p_PrbMapUl[mu]))
+            goto cfg_disabled;
+    }
+    if(p_o_xu_cfg->RunSlotPrbMapEnabled)
+        for(dir = 0; dir < XRAN_DIR_MAX; dir++)
+            for(tti = 0; tti < XRAN_N_FE_BUF_LEN; tti++)
+                for(cc_id = 0; cc_id < XRAN_MAX_SECTOR_NR; cc_id++)
+                    for(ant_id = 0; ant_id < XRAN_MAX_ANTENNA_NR; ant_id++)
+                        if(app_io_xran_prb_map_bfw_disabled(p_o_xu_cfg->p_RunSlotPrbMap[dir][tti][cc_id][ant_id]))
+                            goto cfg_disabled;
+    return 1;
+
+cfg_disabled:
+    printf("bfwCacheMode %d: disableBFWs set in the PRB map, beamIds only are not sent by the cache\n",
+        p_o_xu_cfg->bfwCacheMode);
+    return 0;
+}
+
+/* Caches of compressed BFWs for extension 11, one per eAxC and direction. Without memory
+ * for all of them the BFWs are compressed every time. */
+static void
+app_io_xran_bfw_cache_init(struct xran_io_shared_ctrl *psIoCtrl, int32_t nCC, int32_t nAnt, uint32_t nAntElmTRx,
+                           uint8_t mode, uint8_t beamIdOnly)
+{
+    int32_t dir, cc_id, ant_id;
+
+    psIoCtrl->bfwCacheMode = mode;
+    for(dir = 0; dir < XRAN_DIR_MAX; dir++) {
+        for(cc_id = 0; cc_id < nCC && cc_id < XRAN_MAX_SECTOR_NR; cc_id++) {
+            for(ant_id = 0; ant_id < nAnt && ant_id < XRAN_MAX_ANTENNA_NR; ant_id++) {
+                if(psIoCtrl->pBfwCache[dir][cc_id][ant_id])
+                    continue;
+                psIoCtrl->pBfwCache[dir][cc_id][ant_id] = xran_cp_bfw_cache_create(XRAN_CP_BFW_CACHE_DEF_ENTRIES,
+                                                                RTE_MIN(nAntElmTRx, UINT8_MAX), beamIdOnly);
+                if(psIoCtrl->pBfwCache[dir][cc_id][ant_id] == NULL) {
+                    printf("xran_cp_bfw_cache_create failed [%d][%d][%d], BFW cache disabled\n", dir, cc_id, ant_id);
+                    goto cache_failed;
+                }
+            }
+        }
+    }
+    return;
+
+cache_failed:
+    for(dir = 0; dir < XRAN_DIR_MAX; dir++)
+        for(cc_id = 0; cc_id < XRAN_MAX_SECTOR_NR; cc_id++)
+            for(ant_id = 0; ant_id < XRAN_MAX_ANTENNA_NR; ant_id++) {
+                xran_cp_bfw_cache_free(psIoCtrl->pBfwCache[dir][cc_id][ant_id]);
+                psIoCtrl->pBfwCache[dir][cc_id][ant_id] = NULL;
+            }
+    psIoCtrl->bfwCacheMode = 0;
+}
+
+void
+app_io_xran_bfw_cache_stats_print(uint32_t o_xu_id)
+{
+    struct xran_io_shared_ctrl *psIoCtrl = app_io_xran_if_ctrl_get(o_xu_id);
+    struct xran_cp_bfw_cache_stats stats, total;
+    int32_t dir, cc_id, ant_id;
+
+    if(psIoCtrl == NULL || psIoCtrl->bfwCacheMode == 0)
+        return;
+
+    memset(&total, 0, sizeof(total));
+    for(dir = 0; dir < XRAN_DIR_MAX; dir++)
+        for(cc_id = 0; cc_id < XRAN_MAX_SECTOR_NR; cc_id++)
+            for(ant_id = 0; ant_id < XRAN_MAX_ANTENNA_NR; ant_id++)
+                if(xran_cp_bfw_cache_get_stats(psIoCtrl->pBfwCache[dir][cc_id][ant_id], &stats) == XRAN_STATUS_SUCCESS) {
+                    total.lookups       += stats.lookups;
+                    total.hits          += stats.hits;
+                    total.misses        += stats.misses;
+                    total.updates       += stats.updates;
+                    total.evictions     += stats.evictions;
+                    total.beamIdOnly    += stats.beamIdOnly;
+                    total.bypass        += stats.bypass;
+                }
+
+    printf("[o-du%d][bfw cache] lookups %ld hits %ld (%5.2f%%) misses %ld updates %ld evictions %ld beamId only %ld bypass %ld\n",
+        o_xu_id, total.lookups, total.hits,
+        total.lookups ? (double)total.hits * 100.0 / (double)total.lookups : 0.0,
+        total.misses, total.updates, total.evictions, total.beamIdOnly, total.bypass);
+}
+
 int32_t
 app_io_xran_iq_content_init(uint32_t o_xu_id, RuntimeConfig *p_o_xu_cfg)
 {
@@ -2174,6 +2379,11 @@ app_io_xran_iq_content_init(uint32_t o_xu_id, RuntimeConfig *p_o_xu_cfg)
     {
         printf("p_o_xu_cfg->mtu = %d\n",p_o_xu_cfg->mtu);
     }
+    if (p_o_xu_cfg->bfwCacheMode && p_o_xu_cfg->xranCat == XRAN_CATEGORY_B && p_o_xu_cfg->appMode == APP_O_DU)
+    {
+        app_io_xran_bfw_cache_init(psIoCtrl, nSectorNum, xran_max_antenna_nr, p_o_xu_cfg->antElmTRx, p_o_xu_cfg->bfwCacheMode,
+                                   app_io_xran_bfw_beam_id_only(p_o_xu_cfg));
+    }
     /* Init Memory */
     for(mu_idx = 0; mu_idx < p_o_xu_cfg->numMu; mu_idx++) {
         uint8_t mu = p_o_xu_cfg->mu_number[mu_idx];
@@ -3249,6 +3459,7 @@ app_io_xran_fh_config_init(UsecaseConfig* p_use_cfg,  RuntimeConfig* p_o_xu_cfg,
         p_xran_fh_cfg->ru_conf.xran_max_frame = p_o_xu_cfg->maxFrameId;
     p_xran_fh_cfg->enableCP          = p_o_xu_cfg->enableCP;
     p_xran_fh_cfg->dropPacketsUp     = p_o_xu_cfg->DropPacketsUp;
+    p_xran_fh_cfg->rxSeqIdWindow     = p_o_xu_cfg->RxSeqIdWindow;
     p_xran_fh_cfg->srsEnable         = p_o_xu_cfg->enableSrs;
     p_xran_fh_cfg->csirsEnable       = p_o_xu_cfg->csirsEnable;
     p_xran_fh_cfg->srsEnableCp       = 1;
@@ -3301,6 +3512,14 @@ app_io_xran_fh_init_init(UsecaseConfig* p_use_cfg,  RuntimeConfig* p_o_xu_cfg, s
         p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].measId          = p_use_cfg->owdmMeasId;
         p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].owdm_enable     = p_use_cfg->owdmEnable;
         p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].owdm_PlLength   = p_use_cfg->owdmPlLength;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].owdm_pctl       = p_use_cfg->owdmPctl;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].owdm_ewmaShift  = p_use_cfg->owdmEwmaShift;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].owdm_guardNs    = p_use_cfg->owdmGuardNs;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].owdm_budgetNs   = p_use_cfg->owdmBudgetNs;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].owdm_maxShrinkUs = p_use_cfg->owdmMaxShrinkUs;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].owdm_maxGrowUs  = p_use_cfg->owdmMaxGrowUs;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].owdm_stepUs     = p_use_cfg->owdmStepUs;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_DU].owdm_periodMs   = p_use_cfg->owdmPeriodMs;
         p_xran_fh_init->dlCpProcBurst = p_use_cfg->dlCpProcBurst;
 
     } else {
@@ -3322,6 +3541,15 @@ app_io_xran_fh_init_init(UsecaseConfig* p_use_cfg,  RuntimeConfig* p_o_xu_cfg, s
         p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].measId          = p_use_cfg->owdmMeasId;
         p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].owdm_enable     = p_use_cfg->owdmEnable;
         p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].owdm_PlLength   = p_use_cfg->owdmPlLength;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].owdm_pctl       = p_use_cfg->owdmPctl;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].owdm_ewmaShift  = p_use_cfg->owdmEwmaShift;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].owdm_guardNs    = p_use_cfg->owdmGuardNs;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].owdm_budgetNs   = p_use_cfg->owdmBudgetNs;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].owdm_maxShrinkUs = p_use_cfg->owdmMaxShrinkUs;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].owdm_maxGrowUs  = p_use_cfg->owdmMaxGrowUs;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].owdm_stepUs     = p_use_cfg->owdmStepUs;
+        p_xran_fh_init->io_cfg.eowd_cmn[APP_O_RU].owdm_periodMs   = p_use_cfg->owdmPeriodMs;
+        p_xran_fh_init->ruLoadGen = p_use_cfg->ruLoadGen;
     }
 
     if(p_use_cfg->bbu_offload) {
@@ -3417,6 +3645,7 @@ app_io_xran_fh_init_init(UsecaseConfig* p_use_cfg,  RuntimeConfig* p_o_xu_cfg, s
             printf("%s:%d: app_io_xran_eAxCid_conf_set failed", __func__, __LINE__);
             return -1;
         }
+        p_xran_fh_init->rxPktPerSym[o_xu_id] = p_o_xu_cfg->RxPktPerSym;
 
         p_o_xu_cfg++;
     }
@@ -140,10 +140,15 @@ struct io_shared_buff_perMu {
     struct xran_flat_buffer sFHCsirsTxPrbMapBuffers[XRAN_N_FE_BUF_LEN][XRAN_MAX_SECTOR_NR][XRAN_MAX_CSIRS_PORTS];
 };
 
+struct xran_cp_bfw_cache;
+
 struct xran_io_shared_ctrl {
     enum xran_input_byte_order byteOrder; /* Order of bytes in int16_t in buffer. Big or little endian */
     enum xran_input_i_q_order  iqOrder; /* order of IQs in the buffer */
     struct io_shared_buff_perMu io_buff_perMu[XRAN_MAX_NUM_MU];
+    uint8_t bfwCacheMode; /* 0 - compress BFWs every time, 1 - reuse compressed BFWs, 2 - also send beamId only when O-RU has the BFWs (needs ruKeepsBfws) */
+    struct xran_cp_bfw_cache *pBfwCache[XRAN_DIR_MAX][XRAN_MAX_SECTOR_NR][XRAN_MAX_ANTENNA_NR]; /* per eAxC, BFWs of one eAxC are prepared by one core */
+    uint8_t ulDoneCbMode; /* early UL completion callbacks enabled, the RX slot hand-off moves from the full slot callback to the UL done callback */
     // struct xran_flat_buffer sFHCpRxPrbMapBuffers[XRAN_N_FE_BUF_LEN][XRAN_MAX_SECTOR_NR][XRAN_MAX_ANTENNA_NR];
 };
 
@@ -188,6 +193,7 @@ int32_t app_io_xran_eAxCid_conf_set(struct xran_eaxcid_config *p_eAxC_cfg, Runti
 int32_t app_io_xran_fh_config_init(UsecaseConfig* p_use_cfg,  RuntimeConfig* p_o_xu_cfg, struct xran_fh_init* p_xran_fh_init, struct xran_fh_config*  p_xran_fh_cfg);
 int32_t app_io_xran_fh_init_init(UsecaseConfig* p_use_cfg,  RuntimeConfig* p_o_xu_cfg, struct xran_fh_init* p_xran_fh_init);
 int32_t app_io_xran_buffers_max_sz_set (RuntimeConfig* p_o_xu_cfg);
+void app_io_xran_bfw_cache_stats_print(uint32_t o_xu_id);
 
 int32_t app_io_xran_dl_post_func(uint16_t nCellIdx, uint32_t nSfIdx, uint32_t nSymMask, uint32_t nAntStart, uint32_t nAntNum, uint8_t mu);
 
@@ -195,6 +201,7 @@ int32_t app_io_xran_dl_tti_call_back(void * param, uint8_t mu);
 int32_t app_io_xran_ul_half_slot_call_back(void * param, uint8_t mu);
 int32_t app_io_xran_ul_full_slot_call_back(void * param, uint8_t mu);
 int32_t app_io_xran_ul_custom_sym_call_back(void * param, struct xran_sense_of_time* time);
+void app_io_xran_ul_done_call_back(void * param, uint16_t ccId, uint32_t tti, uint8_t symb, uint8_t mu);
 
 int32_t app_io_xran_map_cellid_to_port(struct bbu_xran_io_if * p_xran_io, uint32_t cell_id, uint32_t *ret_cc_id);
 
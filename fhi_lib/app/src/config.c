@@ -74,6 +74,14 @@
 #define KEY_OWDM_MEAS_ID    "oXuOwdmMeasId"
 #define KEY_OWDM_EN         "oXuOwdmEnabled"
 #define KEY_OWDM_PL_LENGTH  "oXuOwdmPlLength"
+#define KEY_OWDM_PCTL       "oXuOwdmPctl"
+#define KEY_OWDM_EWMA_SHIFT "oXuOwdmEwmaShift"
+#define KEY_OWDM_GUARD      "oXuOwdmGuardNs"
+#define KEY_OWDM_BUDGET     "oXuOwdmBudgetNs"
+#define KEY_OWDM_MAX_SHRINK "oXuOwdmMaxShrinkUs"
+#define KEY_OWDM_MAX_GROW   "oXuOwdmMaxGrowUs"
+#define KEY_OWDM_STEP       "oXuOwdmStepUs"
+#define KEY_OWDM_PERIOD     "oXuOwdmPeriodMs"
 
 /* Config for IEEE 802.1Q CFM LBM/LBR */
 #define KEY_LBM_ENABLE              "lbmEnable"
@@ -101,6 +109,16 @@
 #define KEY_O_XU_REM_MAC    "oXuRem"
 #define KEY_DL_CP_BURST     "dlCpProcBurst"
 #define KEY_XRAN_MLOG_DIS   "xranMlogDisable"
+/* O-RU load generator, the keys share a prefix and are matched whole */
+#define KEY_RU_LOADGEN          "ruLoadGen"
+#define KEY_RU_LOADGEN_SHARDS   "ruLoadGenShards"
+#define KEY_RU_LOADGEN_EARLY_SYM "ruLoadGenEarlySym"
+#define KEY_RU_LOADGEN_LATE_SYM "ruLoadGenLateSym"
+#define KEY_RU_LOADGEN_LOSS     "ruLoadGenLossPpm"
+#define KEY_RU_LOADGEN_EARLY    "ruLoadGenEarlyPpm"
+#define KEY_RU_LOADGEN_LATE     "ruLoadGenLatePpm"
+#define KEY_RU_LOADGEN_REORDER  "ruLoadGenReorderPpm"
+#define KEY_RU_LOADGEN_SEED     "ruLoadGenSeed"
 
 #define KEY_FILE_ULSRS      "antSrsC"
 
@@ -141,6 +159,9 @@
 #define KEY_NUM_REP           "nRep"
 
 #define KEY_DROP_PACKETS_UP  "dropPacketsUp"
+#define KEY_RX_SEQID_WINDOW  "rxSeqIdWindow"
+#define KEY_UL_DONE_CB_MODE  "ulDoneCbMode"
+#define KEY_RX_PKT_PER_SYM   "rxPktPerSym"
 #define KEY_SRS_ENABLE     "srsEnable"
 #define KEY_CSIRS_ENABLE   "csirsEnable"
 #define KEY_CSI_PORTS      "nCSIports"
@@ -195,6 +216,8 @@
 #define KEY_DEBUG_STOP_CNT "debugStopCount"
 #define KEY_BBDEV_MODE     "bbdevMode"
 #define KEY_DYNA_SEC_ENA   "DynamicSectionEna"
+#define KEY_BFW_CACHE_MODE "bfwCacheMode"
+#define KEY_RU_KEEPS_BFWS  "ruKeepsBfws"
 #define EXT_TYPE           "extType"
 #define KEY_ALPHA          "Gps_Alpha"
 #define KEY_BETA           "Gps_Beta"
@@ -543,6 +566,15 @@ static int fillConfigStruct(RuntimeConfig *config, const char *key, const char *
     } else if (strcmp(key, KEY_DROP_PACKETS_UP) == 0) {
         config->DropPacketsUp = atoi(value);
         printf("dropPacketsUp enable: %d\n",config->DropPacketsUp);
+    } else if (strcmp(key, KEY_RX_SEQID_WINDOW) == 0) {
+        config->RxSeqIdWindow = atoi(value);
+        printf("rxSeqIdWindow: %d\n",config->RxSeqIdWindow);
+    } else if (strcmp(key, KEY_UL_DONE_CB_MODE) == 0) {
+        config->UlDoneCbMode = atoi(value);
+        printf("ulDoneCbMode: %d\n",config->UlDoneCbMode);
+    } else if (strcmp(key, KEY_RX_PKT_PER_SYM) == 0) {
+        config->RxPktPerSym = atoi(value);
+        printf("rxPktPerSym: %d\n",config->RxPktPerSym);
     } else if (strcmp(key, KEY_SRS_ENABLE) == 0) {
         config->enableSrs = atoi(value);
         printf("Srs enable: %d\n",config->enableSrs);
@@ -666,6 +698,12 @@ static int fillConfigStruct(RuntimeConfig *config, const char *key, const char *
     } else if (strcmp(key, KEY_DYNA_SEC_ENA) == 0) {
         config->DynamicSectionEna = atoi(value);
         printf("DynamicSectionEna: %d\n",config->DynamicSectionEna);
+    } else if (strcmp(key, KEY_BFW_CACHE_MODE) == 0) {
+        config->bfwCacheMode = atoi(value);
+        printf("bfwCacheMode: %d\n",config->bfwCacheMode);
+    } else if (strcmp(key, KEY_RU_KEEPS_BFWS) == 0) {
+        config->ruKeepsBfws = atoi(value);
+        printf("ruKeepsBfws: %d\n",config->ruKeepsBfws);
     } else if (strcmp(key, EXT_TYPE) == 0) {
         config->extType = atoi(value);
         printf("ExtType: %d\n",config->extType);
@@ -987,6 +1025,30 @@ fillUsecaseStruct(UsecaseConfig *config, const char *key, const char *value)
     } else if (strncmp(key, KEY_OWDM_MEAS_ST, strlen(KEY_OWDM_MEAS_ST)) == 0) {
         config->owdmMeasState =  atoi(value);
         printf("owdmMeasState %d\n", config->owdmMeasState);
+    } else if (strncmp(key, KEY_OWDM_PCTL, strlen(KEY_OWDM_PCTL)) == 0) {
+        config->owdmPctl = atoi(value);
+        printf("owdmPctl %d\n", config->owdmPctl);
+    } else if (strncmp(key, KEY_OWDM_EWMA_SHIFT, strlen(KEY_OWDM_EWMA_SHIFT)) == 0) {
+        config->owdmEwmaShift = atoi(value);
+        printf("owdmEwmaShift %d\n", config->owdmEwmaShift);
+    } else if (strncmp(key, KEY_OWDM_GUARD, strlen(KEY_OWDM_GUARD)) == 0) {
+        config->owdmGuardNs = atoi(value);
+        printf("owdmGuardNs %u\n", config->owdmGuardNs);
+    } else if (strncmp(key, KEY_OWDM_BUDGET, strlen(KEY_OWDM_BUDGET)) == 0) {
+        config->owdmBudgetNs = atoi(value);
+        printf("owdmBudgetNs %u\n", config->owdmBudgetNs);
+    } else if (strncmp(key, KEY_OWDM_MAX_SHRINK, strlen(KEY_OWDM_MAX_SHRINK)) == 0) {
+        config->owdmMaxShrinkUs = atoi(value);
+        printf("owdmMaxShrinkUs %d\n", config->owdmMaxShrinkUs);
+    } else if (strncmp(key, KEY_OWDM_MAX_GROW, strlen(KEY_OWDM_MAX_GROW)) == 0) {
+        config->owdmMaxGrowUs = atoi(value);
+        printf("owdmMaxGrowUs %d\n", config->owdmMaxGrowUs);
+    } else if (strncmp(key, KEY_OWDM_STEP, strlen(KEY_OWDM_STEP)) == 0) {
+        config->owdmStepUs = atoi(value);
+        printf("owdmStepUs %d\n", config->owdmStepUs);
+    } else if (strncmp(key, KEY_OWDM_PERIOD, strlen(KEY_OWDM_PERIOD)) == 0) {
+        config->owdmPeriodMs = atoi(value);
+        printf("owdmPeriodMs %u\n", config->owdmPeriodMs);
     } else if (strncmp(key, KEY_O_XU_PCIE_BUS, strlen(KEY_O_XU_PCIE_BUS)) == 0) {
         unsigned int o_xu_id = 0;
         unsigned int vf_num = 0;
@@ -1033,6 +1095,33 @@ fillUsecaseStruct(UsecaseConfig *config, const char *key, const char *value)
     } else if (strncmp(key, KEY_XRAN_MLOG_DIS, strlen(KEY_XRAN_MLOG_DIS)) == 0) {
         config->mlogxrandisable = atoi(value);
         printf("xranMlogDisable %d\n", config->mlogxrandisable);
+    } else if (strcmp(key, KEY_RU_LOADGEN) == 0) {
+        config->ruLoadGen.enable = atoi(value);
+        printf("%s %hhu\n", KEY_RU_LOADGEN, config->ruLoadGen.enable);
+    } else if (strcmp(key, KEY_RU_LOADGEN_SHARDS) == 0) {
+        config->ruLoadGen.numShards = atoi(value);
+        printf("%s %hhu\n", KEY_RU_LOADGEN_SHARDS, config->ruLoadGen.numShards);
+    } else if (strcmp(key, KEY_RU_LOADGEN_EARLY_SYM) == 0) {
+        config->ruLoadGen.earlySym = atoi(value);
+        printf("%s %hhu\n", KEY_RU_LOADGEN_EARLY_SYM, config->ruLoadGen.earlySym);
+    } else if (strcmp(key, KEY_RU_LOADGEN_LATE_SYM) == 0) {
+        config->ruLoadGen.lateSym = atoi(value);
+        printf("%s %hhu\n", KEY_RU_LOADGEN_LATE_SYM, config->ruLoadGen.lateSym);
+    } else if (strcmp(key, KEY_RU_LOADGEN_LOSS) == 0) {
+        config->ruLoadGen.lossPpm = strtoul(value, NULL, 0);
+        printf("%s %u\n", KEY_RU_LOADGEN_LOSS, config->ruLoadGen.lossPpm);
+    } else if (strcmp(key, KEY_RU_LOADGEN_EARLY) == 0) {
+        config->ruLoadGen.earlyPpm = strtoul(value, NULL, 0);
+        printf("%s %u\n", KEY_RU_LOADGEN_EARLY, config->ruLoadGen.earlyPpm);
+    } else if (strcmp(key, KEY_RU_LOADGEN_LATE) == 0) {
+        config->ruLoadGen.latePpm = strtoul(value, NULL, 0);
+        printf("%s %u\n", KEY_RU_LOADGEN_LATE, config->ruLoadGen.latePpm);
+    } else if (strcmp(key, KEY_RU_LOADGEN_REORDER) == 0) {
+        config->ruLoadGen.reorderPpm = strtoul(value, NULL, 0);
+        printf("%s %u\n", KEY_RU_LOADGEN_REORDER, config->ruLoadGen.reorderPpm);
+    } else if (strcmp(key, KEY_RU_LOADGEN_SEED) == 0) {
+        config->ruLoadGen.seed = strtoul(value, NULL, 0);
+        printf("%s %u\n", KEY_RU_LOADGEN_SEED, config->ruLoadGen.seed);
     } else if (strncmp(key, KEY_LBM_ENABLE, strlen(KEY_LBM_ENABLE)) == 0) {
         config->lbmEnable = atoi(value);
         printf("%s %hhu\n",KEY_LBM_ENABLE, config->lbmEnable);
@@ -93,6 +93,9 @@ typedef struct _RuntimeConfig
 
     uint16_t totalBfWeights; /**< The total number of beamforming weights on RU */
     uint32_t DropPacketsUp; /**< enable droping the up channel packets if they miss timing window */
+    uint32_t RxSeqIdWindow; /**< depth of the U-plane RX seqId reorder window, 0: default */
+    uint8_t  UlDoneCbMode;  /**< early UL completion callbacks: 0 off, 1 per slot, 2 per symbol and slot */
+    uint16_t RxPktPerSym;   /**< max U-plane packets received per symbol and eAxC, 0: default */
     uint8_t  enableSrs;     /**< enable SRS (valid for Cat B only) */
     uint16_t srsSymMask;    /* deprecated */
     uint16_t srsSlot;       /**< SRS slot within TDD period (special slot), for O-RU emulation */
@@ -112,6 +115,8 @@ typedef struct _RuntimeConfig
     int32_t debugStopCount;
     int32_t bbdevMode;
     int32_t DynamicSectionEna;
+    uint8_t bfwCacheMode; /**< 0 - off, 1 - reuse compressed BFWs for ext 11, 2 - also send beamId only (disableBFWs) for BFWs known by O-RU */
+    uint8_t ruKeepsBfws;  /**< 1 - O-RU keeps the BFWs received per beamId and applies them on disableBFWs, required by bfwCacheMode 2. Default 0 */
     int32_t GPS_Alpha;
     int32_t GPS_Beta;
 
@@ -205,6 +210,14 @@ typedef struct _UsecaseConfig
     uint16_t owdmMeasId;     /**< One Way Delay Measurement Id, Seed for the measurementId to be used */
     uint16_t owdmEnable;     /**< One Way Delay Measurement master enable when set performs measurements on all vfs */
     uint16_t owdmPlLength;   /**< One Way Delay Measurement Payload length   44<= PiLength <= 1400 bytes */
+    uint16_t owdmPctl;       /**< One Way Delay Measurement percentile reported by filter type 2 */
+    uint16_t owdmEwmaShift;  /**< One Way Delay Measurement EWMA weight 1/2^owdmEwmaShift */
+    uint32_t owdmGuardNs;    /**< One Way Delay Measurement margin added to the delay when tuning the timing windows */
+    uint32_t owdmBudgetNs;   /**< One Way Delay Measurement transport delay the timing windows were set for, 0: no tuning */
+    uint16_t owdmMaxShrinkUs;/**< One Way Delay Measurement largest tightening of the timing windows in us */
+    uint16_t owdmMaxGrowUs;  /**< One Way Delay Measurement largest widening of the timing windows in us */
+    uint16_t owdmStepUs;     /**< One Way Delay Measurement largest tightening of the timing windows per measurement in us */
+    uint32_t owdmPeriodMs;   /**< One Way Delay Measurement interval between measurements in ms, 0 for start-up only */
 
     int num_vfs;  /**< Total numbers of VFs accrose all O-RU|O-DU */
     int num_rxq;  /**< Total numbers of HW RX queues for each VF O-RU|O-DU */
@@ -224,6 +237,7 @@ typedef struct _UsecaseConfig
                                      will be spread across all allowed symbols and multiple cores to reduce burstiness */
     int32_t  bbu_offload;     /**< enable packet handling on BBU cores */
     int32_t  mlogxrandisable;  /**< set to 1 to disable mlog 0 - default mlog enabled */
+    struct xran_ru_loadgen_cfg ruLoadGen; /**< O-RU load generator */
     
     /* Config for IEEE 802.1Q Connectivity and fault management - LBM/LBR */
     bool lbmEnable;
@@ -1964,6 +1964,17 @@ int main(int argc, char *argv[])
 
         app_io_xran_iq_content_init(o_xu_id, p_startupConfiguration[o_xu_id]);
 
+        if(p_startupConfiguration[o_xu_id]->appMode == APP_O_DU && p_startupConfiguration[o_xu_id]->UlDoneCbMode)
+        {
+            if((xret = xran_reg_ul_done_cb(app_io_xran_handle[o_xu_id], app_io_xran_ul_done_call_back, (void *)(intptr_t)o_xu_id,
+                                    (enum xran_ul_done_cb_mode)p_startupConfiguration[o_xu_id]->UlDoneCbMode, XRAN_DEFAULT_MU)) != XRAN_STATUS_SUCCESS)
+            {
+                printf("xran_reg_ul_done_cb failed %d\n", xret);
+                exit(-1);
+            }
+            app_io_xran_if_ctrl_get(o_xu_id)->ulDoneCbMode = p_startupConfiguration[o_xu_id]->UlDoneCbMode;
+        }
+
 #ifdef FWK_ENABLED
         if(p_usecaseConfiguration->bbu_offload)
         {
@@ -2129,7 +2140,7 @@ int main(int argc, char *argv[])
                     printf("\n");
 #endif
                 }
-                printf("[%s%d][rx %7ld pps %7ld kbps %7ld][tx %7ld pps %7ld kbps %7ld] [on_time %ld early %ld late %ld corrupt %ld pkt_dupl %ld Invalid_Ext1_packets %ld Total %ld]\n",
+                printf("[%s%d][rx %7ld pps %7ld kbps %7ld][tx %7ld pps %7ld kbps %7ld] [on_time %ld early %ld late %ld corrupt %ld pkt_dupl %ld lost %ld reorder %ld seq_late %ld Invalid_Ext1_packets %ld Total %ld]\n",
                     ((p_usecaseConfiguration->appMode == APP_O_DU) ? "o-du" : "o-ru"),
                     o_xu_id,
                     x_counters[o_xu_id].rx_counter,
@@ -2143,10 +2154,14 @@ int main(int argc, char *argv[])
                     x_counters[o_xu_id].Rx_late,
                     x_counters[o_xu_id].Rx_corrupt,
                     x_counters[o_xu_id].Rx_pkt_dupl,
+                    x_counters[o_xu_id].Rx_pkt_lost,
+                    x_counters[o_xu_id].Rx_pkt_reorder,
+                    x_counters[o_xu_id].Rx_pkt_late,
                     x_counters[o_xu_id].rx_invalid_ext1_packets,
                     x_counters[o_xu_id].Total_msgs_rcvd);
 
                 xran_print_error_stats(&x_counters[o_xu_id]);
+                app_io_xran_bfw_cache_stats_print(o_xu_id);
 
                 if (x_counters[o_xu_id].rx_counter > old_rx_counter[o_xu_id])
                     old_rx_counter[o_xu_id] = x_counters[o_xu_id].rx_counter;
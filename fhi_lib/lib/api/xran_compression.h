@@ -56,6 +56,19 @@ struct xranlib_compress_response {
     int32_t len; /*!< Length of output data. */
 };
 
+/*!
+    \struct xranlib_compress_bfw_batch_request
+    \brief Request structure for compression of all the sets of BFWs of a section in one call.
+*/
+struct xranlib_compress_bfw_batch_request {
+    int16_t **data_in;  /*!< Pointers to the sets of BFWs to compress, one per beam. */
+    uint16_t *beamId;   /*!< beamId of each set, 15 bits. */
+    int16_t numBeams;   /*!< Number of sets of BFWs */
+    int16_t numDataElements; /*!< number of elements in one set, i.e AntElm*2 (any antenna count) */
+    int16_t compMethod; /*!< Compression method, only BFP is supported */
+    int16_t iqWidth;    /*!< Bit size, 1 to 16 */
+};
+
 /*!
     \struct xranlib_decompress_request
     \brief Request structure containing pointer to data and its length.
@@ -125,6 +138,14 @@ xranlib_compress_avx512_bfw(const struct xranlib_compress_request *request,
 int32_t
 xranlib_compress_avxsnc_bfw(const struct xranlib_compress_request *request,
     struct xranlib_compress_response *response);
+/*!
+    \brief Compress all sets of BFWs of a section extension 11 in one pass.
+    Output is [bfwCompParam][beamId][BFWs] per set, back to back, without padding.
+    response->len is set to the number of bytes written.
+*/
+int32_t
+xranlib_compress_bfw_batch(const struct xranlib_compress_bfw_batch_request *request,
+    struct xranlib_compress_response *response);
 //! @}
 
 //! @{
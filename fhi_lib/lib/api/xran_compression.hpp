@@ -102,6 +102,10 @@ namespace BlockFloatCompander
   void BFPCompressUserPlaneAvx512(const ExpandedData& dataIn, CompressedData* dataOut);
   void BFPExpandUserPlaneAvx512(const CompressedData& dataIn, ExpandedData* dataOut);
 
+  /// User-Plane compression and expansion functions for any number of RB and iqWidth 1 to 16
+  void BFPCompressUserPlaneAvx512Wide(const ExpandedData& dataIn, CompressedData* dataOut);
+  void BFPExpandUserPlaneAvx512Wide(const CompressedData& dataIn, ExpandedData* dataOut);
+
   /// Control-Plane specific compression and expansion functions for 8 antennas
   void BFPCompressCtrlPlane8Avx512(const ExpandedData& dataIn, CompressedData* dataOut);
   void BFPExpandCtrlPlane8Avx512(const CompressedData& dataIn, ExpandedData* dataOut);
@@ -118,6 +122,12 @@ namespace BlockFloatCompander
   void BFPCompressCtrlPlane64Avx512(const ExpandedData& dataIn, CompressedData* dataOut);
   void BFPExpandCtrlPlane64Avx512(const CompressedData& dataIn, ExpandedData* dataOut);
 
+  /// Control-Plane compression of a batch of BFW sets for any number of antennas and iqWidth 1 to 16.
+  /// Each set is written as [exponent][beamId][BFWs] (section extension 11 layout).
+  /// Returns the number of bytes written, or -1 for unsupported iqWidth.
+  int BFPCompressCtrlPlaneBatchAvx512(const int16_t* const* dataIn, const uint16_t* beamId,
+                                      int numBeams, int numDataElements, int iqWidth, uint8_t* dataOut);
+
 
   /// User-Plane specific compression and expansion functions
   void BFPCompressUserPlaneAvxSnc(const ExpandedData& dataIn, CompressedData* dataOut);
@@ -387,6 +387,52 @@ struct xran_sectionext11_recv_info {
     struct xran_ext11_prbbundle_info bundInfo[XRAN_MAX_SET_BFWS];
 };
 
+/** Default number of entries of the cache of compressed BFWs */
+#define XRAN_CP_BFW_CACHE_DEF_ENTRIES   (256)
+/** Number of entries probed for a (eAxC, beamId) before the home entry is evicted */
+#define XRAN_CP_BFW_CACHE_MAX_PROBE     (4)
+
+/**
+ * Statistics of the cache of compressed BFWs for section extension 11 */
+struct xran_cp_bfw_cache_stats {
+    uint64_t    lookups;        /* Number of sets of BFWs looked up */
+    uint64_t    hits;           /* Sets reused without compression */
+    uint64_t    misses;         /* Sets compressed and stored */
+    uint64_t    updates;        /* Misses where the beamId was cached with other weights */
+    uint64_t    evictions;      /* Misses which replaced the entry of another beamId */
+    uint64_t    beamIdOnly;     /* Extensions prepared with disableBFWs=1 */
+    uint64_t    bypass;         /* Calls which could not use the cache */
+};
+
+/**
+ * One set of BFWs in the cache, already in [bfwCompParam][beamId][BFWs] format */
+struct xran_cp_bfw_cache_entry {
+    uint64_t    wHash;          /* Hash of the uncompressed BFWs */
+    uint16_t    eAxC;
+    uint16_t    beamId;         /* 15bits */
+    uint8_t     numBFW;
+    uint8_t     iqWidth;
+    uint8_t     compMeth;
+    uint8_t     valid;
+    uint16_t    setLen;         /* Size of the set in bytes */
+    uint8_t     *pSet;          /* Compressed set of BFWs */
+    uint8_t     *pBFWs;         /* Uncompressed BFWs, compared when the hash matches */
+};
+
+/**
+ * Cache of compressed BFWs keyed by (eAxC, beamId, hash of the weights).
+ * The cache is not thread safe, use one instance per thread preparing extension 11. */
+struct xran_cp_bfw_cache {
+    uint32_t    nEntries;       /* Number of entries, power of 2 */
+    uint32_t    maxSetLen;      /* Space for one set of BFWs in the pool */
+    uint32_t    maxBfwLen;      /* Space for the uncompressed BFWs of a set in the pool */
+    uint8_t     maxNumBFW;      /* Maximum number of BFWs in a set */
+    uint8_t     beamIdOnly;     /* Send beamIds only (disableBFWs=1) if all BFWs are known by O-RU */
+    struct xran_cp_bfw_cache_entry *pEntries;
+    uint8_t     *pSetPool;
+    struct xran_cp_bfw_cache_stats stats;
+};
+
 struct xran_sectionext_info {
     uint16_t    type;
     uint16_t    len;
@@ -511,8 +557,12 @@ struct xran_cp_rbmap_list {
     uint8_t     pad0;
 };
 
+/** section database of one numerology, the entries follow it in the arena of the port */
 typedef struct tagSECTION_DB_TYPE {
-    struct xran_sectioninfo_db* p_sectiondb_elm[XRAN_MAX_SECTIONDB_CTX][XRAN_DIR_MAX][XRAN_COMPONENT_CARRIERS_MAX][XRAN_MAX_ANTENNA_NR * 2 + XRAN_MAX_ANT_ARRAY_ELM_NR];
+    struct xran_sectioninfo_db *pElm;   /**< entries indexed [ctx][dir][eAxC][cc] */
+    void        *pArena;                /**< allocation released with this database, NULL if shared */
+    uint16_t    nCc;                    /**< CCs with entries */
+    uint16_t    nAnt;                   /**< eAxCs with entries */
 } SECTION_DB_TYPE, * PSECTION_DB_TYPE;
 
 uint16_t xran_get_cplength(int32_t cpLength);
@@ -573,6 +623,27 @@ int32_t xran_cp_prepare_ext11_bfws(uint8_t numSetBFW, uint8_t numBFW,
 int32_t xran_cp_estimate_max_set_bfws(uint8_t numBFWs, uint8_t iqWidth,
                         uint8_t compMeth, uint16_t mtu);
 
+struct xran_cp_bfw_cache *xran_cp_bfw_cache_create(uint32_t nEntries, uint8_t maxNumBFW, uint8_t beamIdOnly);
+void xran_cp_bfw_cache_free(struct xran_cp_bfw_cache *pCache);
+void xran_cp_bfw_cache_flush(struct xran_cp_bfw_cache *pCache);
+int32_t xran_cp_bfw_cache_get_stats(struct xran_cp_bfw_cache *pCache, struct xran_cp_bfw_cache_stats *pStats);
+void xran_cp_bfw_cache_reset_stats(struct xran_cp_bfw_cache *pCache);
+#ifdef XRAN_CP_BF_WEIGHT_STRUCT_OPT
+int32_t xran_cp_prepare_ext11_bfws_cached(struct xran_cp_bfw_cache *pCache, uint16_t eAxC,
+                        uint8_t numSetBFW, uint8_t numBFW,
+                        uint8_t iqWidth, uint8_t compMeth,
+                        uint8_t *dst, int16_t dst_maxlen,
+                        struct xran_ext11_bfw_set_info bfwInfo[],
+                        uint8_t *pDisableBFWs);
+#else
+int32_t xran_cp_prepare_ext11_bfws_cached(struct xran_cp_bfw_cache *pCache, uint16_t eAxC,
+                        uint8_t numSetBFW, uint8_t numBFW,
+                        uint8_t iqWidth, uint8_t compMeth,
+                        uint8_t *dst, int16_t dst_maxlen,
+                        struct xran_ext11_bfw_info bfwInfo[],
+                        uint8_t *pDisableBFWs);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
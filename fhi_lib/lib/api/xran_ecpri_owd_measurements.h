@@ -72,7 +72,9 @@ enum xran_owdm_tx_state
 
 int xran_get_delay_measurements_results (void* Handle,  uint16_t port_id, uint8_t id, uint64_t* pdelay_avg);
 
-void xran_adjust_timing_parameters(void* Handle);
+int32_t xran_adjust_timing_parameters(void* Handle);
+
+void xran_restart_delay_measurement(void* Handle);
 
 void xran_initialize_and_verify_owd_pl_length(void* Handle);
 
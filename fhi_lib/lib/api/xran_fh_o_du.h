@@ -159,7 +159,7 @@ extern "C" {
 #define XRAN_SSB_MAX_NUM_PRB         (XRAN_SSB_MAX_NUM_SC /  XRAN_NUM_OF_SC_PER_RB)
 
 #define XRAN_MAX_FRAGMENT            (2)   /**< Max number of fragmentations in single symbol */
-#define XRAN_MAX_RX_PKT_PER_SYM      (32)   /**< Max number of packets received in single symbol */
+#define XRAN_MAX_RX_PKT_PER_SYM      (32)   /**< Default number of packets received in single symbol, see xran_fh_init.rxPktPerSym */
 #define XRAN_MAX_SET_BFWS            (64)  /**< Assumed 64Ant, BFP 9bit with 9K jumbo frame */
 
 #define XRAN_MAX_PKT_BURST (448+4) /**< 4x14x8 symbols per ms */
@@ -200,6 +200,8 @@ extern "C" {
 #define XRAN_THREE_FOURTHS_CB_SYM   3   /**< 2/4 of the Slot  (offset +7) */
 #define XRAN_FULL_CB_SYM            7   /**< Full Slot  (offset +7) */
 #define XRAN_ONE_FOURTHS_CB_SYM    12   /**< 1/4 of the Slot (offset +7) */
+#define XRAN_UL_DONE_SLOT_SYM    0xFF   /**< all expected PRBs of the Slot received (early UL completion) */
+#define XRAN_UL_DONE_TIMEOUT_SYM 0xFE   /**< full Slot deadline reached before all expected PRBs were received */
 
 #ifdef _XRAN_DEBUG
     #define xran_log_dbg(fmt, ...)          \
@@ -304,6 +306,15 @@ enum cb_per_sym_type_id
     XRAN_CB_SYM_MAX                   /**< max number of types of callbacks */
 };
 
+/** Early UL completion callbacks, driven by the PRBs received against the UL C-plane PRB map */
+enum xran_ul_done_cb_mode
+{
+    XRAN_UL_DONE_CB_OFF          = 0, /**< UL is reported by the deadline callbacks only */
+    XRAN_UL_DONE_CB_SLOT         = 1, /**< callback once all expected PRBs of the slot are received */
+    XRAN_UL_DONE_CB_SYM          = 2, /**< callback per symbol as its expected PRBs are received, then per slot */
+    XRAN_UL_DONE_CB_MAX
+};
+
 /**  Beamforming type, enumerated as "frequency", "time" or "hybrid"
      section 10.4.2	Weight-based dynamic beamforming */
 enum xran_weight_based_beamforming_type {
@@ -343,6 +354,9 @@ typedef int32_t (*xran_fh_tti_callback_fn)(void*, uint8_t mu);
 /** Callback function type packet arrival from transport layer (ETH or IP) */
 typedef void (*xran_transport_callback_fn)(void*, xran_status_t, uint8_t mu);
 
+/** Callback function type for early UL completion of a symbol, or of the slot for XRAN_UL_DONE_SLOT_SYM */
+typedef void (*xran_ul_done_callback_fn)(void*, uint16_t ccId, uint32_t tti, uint8_t symb, uint8_t mu);
+
 /** Callback function type OAM cb */
 typedef int32_t (*xran_callback_oam_notify_fn)(void*, uint8_t vfId, uint8_t lbmStatus);
 
@@ -459,6 +473,19 @@ struct xran_memstat
     uint32_t vf_small[16][XRAN_MEMSTAT_END];
 };
 
+/** packet capture directions and timestamp source, see xran_pcap_start() */
+#define XRAN_PCAP_RX        (1 << 0)    /**< capture received packets */
+#define XRAN_PCAP_TX        (1 << 1)    /**< capture sent packets */
+#define XRAN_PCAP_TS_HW     (1 << 2)    /**< use NIC RX timestamps where the mbuf has one (io_cfg.rx_timestamp), converted to the wall clock */
+
+/** result of a capture replay */
+struct xran_pcap_replay_stats
+{
+    uint64_t pkts;          /**< packets handed to the RX path */
+    uint64_t bytes;         /**< bytes handed to the RX path */
+    uint64_t skipped;       /**< sent packets and packets of VFs not configured */
+    uint64_t elapsedNs;     /**< time spent in the RX path, pacing excluded */
+};
 
 /** callback return information */
 struct xran_cb_tag {
@@ -468,11 +495,20 @@ struct xran_cb_tag {
     uint32_t slotiId;
 };
 
+/** One-way delay reported out of the samples of a measurement, outliers rejected */
+enum xran_owd_filter
+{
+    XRAN_OWD_FILTER_AVG = 0,    /**< mean */
+    XRAN_OWD_FILTER_MIN,        /**< smallest delay */
+    XRAN_OWD_FILTER_PCTL,       /**< owdm_pctl percentile */
+    XRAN_OWD_FILTER_EWMA        /**< EWMA carried over measurements */
+};
+
 /** Common Data for ecpri one-way delay measurements  */
 struct xran_ecpri_del_meas_cmn {
     uint16_t initiator_en;      // Initiator 1, Recipient 0
     uint16_t numberOfSamples;   // Total number of samples to be collected and averaged
-    uint32_t filterType;        // Average for number of samples collected 0
+    uint32_t filterType;        // Delay reported, enum xran_owd_filter
     uint64_t responseTo;        //  Response Timeout in ns
     uint16_t measVf;            //  Vf using the owd transmitter
     uint16_t measState;         //  The state of the owd Transmitter: OWDMTX_DIS,OWDMTX_INIT,OWDMTX_IDLE,OWDMTX_ACTIVE,OWDTX_DONE
@@ -480,6 +516,14 @@ struct xran_ecpri_del_meas_cmn {
     uint16_t measMethod;        //  Measurement Method i.e. REQUEST, REM_REQ, REQ_WFUP or REM_REQ_WFUP
     uint16_t owdm_enable;       //  1: Enabled  0:Disabled
     uint16_t owdm_PlLength;     //  Payload Length   44 <= PlLength <= 1400
+    uint16_t owdm_pctl;         //  Percentile for XRAN_OWD_FILTER_PCTL 1..100, 0 for 90
+    uint16_t owdm_ewmaShift;    //  Weight of a sample in the EWMA is 1/2^ewmaShift, 0 for 1/8
+    uint32_t owdm_guardNs;      //  Margin added to the delay before tuning the timing windows
+    uint32_t owdm_budgetNs;     //  Transport delay the configured timing windows were dimensioned for, 0 disables window tuning
+    uint16_t owdm_maxShrinkUs;  //  Largest tightening of the timing windows in us
+    uint16_t owdm_maxGrowUs;    //  Largest widening of the timing windows in us
+    uint16_t owdm_stepUs;       //  Largest tightening per measurement in us, 0 for no limit. Widening is not limited
+    uint32_t owdm_periodMs;     //  Interval between measurements once running in ms, 0 measures at start-up only
 };
 
 /** Port specific data for ecpri one-way delay measurements */
@@ -497,8 +541,15 @@ struct xran_ecpri_del_meas_port {
     uint16_t txDone;                        // For originator clear after each change of state and set once the transmission is done
     uint64_t rspTimerIdx;                   // Timer Index for TimeOut Timer. On timeout abort current measurement and go back to idle state
     uint64_t delaySamples[MX_NUM_SAMPLES];  // Storage for collected delay samples i.e. td
-    uint64_t delayAvg;                      // Contains the average based on the numberOfSamples for the delay, gets computed once we have
+    uint64_t delayAvg;                      // Contains the delay selected by filterType based on the numberOfSamples, gets computed once we have
                                             // completed the collection for all the numberOfSamples prescribed
+    uint64_t delayMin;                      // Smallest delay of the samples kept
+    uint64_t delayPctl;                     // owdm_pctl percentile of the samples kept
+    uint64_t delayEwma;                     // EWMA of the samples kept, carried over measurements
+    uint16_t numOutliers;                   // Samples rejected as outliers by the last measurement
+    int16_t  windowAdjUs;                   // Timing windows tightened (> 0) or widened (< 0) by the controller, in us
+    uint32_t numRuns;                       // Measurements completed, each one is a step of the controller
+    uint64_t doneTsc;                       // TSC when the last measurement completed
 };
 
 /** DPDK IO configuration for XRAN layer */
@@ -506,7 +557,7 @@ struct xran_io_cfg {
     uint8_t id;                   /**< should be (0) for O-DU or (1) O-RU (debug) */
     uint8_t num_vfs;              /**< number of VFs for C-plane and U-plane (should be even) */
     uint16_t num_rxq;             /**< number of RX queues per VF */
-    char *dpdk_dev[XRAN_VF_MAX];  /**< VFs devices  */
+    char *dpdk_dev[XRAN_VF_MAX];  /**< VFs devices, PCI address or DPDK virtual device arguments (net_memif0,role=server,...) */
     char *bbdev_dev[1];           /**< BBDev dev name */
     int32_t bbdev_mode;           /**< DPDK for BBDev */
     char *bbdev_devx[XRAN_MAX_AUX_BBDEV_NUM];           /**< BBDev other dev name */
@@ -531,6 +582,7 @@ struct xran_io_cfg {
     struct xran_ecpri_del_meas_cmn eowd_cmn[2];/**<ecpri owd measurements common settings for O-DU and O-RU */
     struct xran_ecpri_del_meas_port eowd_port[2][XRAN_VF_MAX];  /**< ecpri owd measurements per port variables for O-DU and O-RU */
     int32_t  bbu_offload;         /**< enable packet handling on BBU cores */
+    int32_t  rx_timestamp;        /**< enable NIC RX timestamps, used by the packet capture (XRAN_PCAP_TS_HW) */
 };
 
 /** XRAN spec section 3.1.3.1.6 ecpriRtcid / ecpriPcid define */
@@ -685,6 +737,23 @@ typedef struct xran_lbm_common_info_s {
 
 } xran_lbm_common_info;
 
+/**
+* O-RU load generator. The UL U-plane of every O-RU port is built from the received C-plane
+* sections by dedicated worker cores, each owning a shard of the eAxCs, out of pre-built
+* payloads. Impairments are drawn per packet, the rates are in packets per million.
+*/
+struct xran_ru_loadgen_cfg {
+    uint8_t  enable;        /**< 1: O-RU UL U-plane is sent by the load generator, requires C-plane */
+    uint8_t  numShards;     /**< number of eAxC shards, one worker core each, 0: all worker cores left */
+    uint8_t  earlySym;      /**< symbols an early packet is ahead of its symbol */
+    uint8_t  lateSym;       /**< symbols a late packet is behind its symbol */
+    uint32_t lossPpm;       /**< packets not sent, their seqId is skipped */
+    uint32_t earlyPpm;      /**< packets stamped earlySym symbols later than their symbol */
+    uint32_t latePpm;       /**< packets stamped lateSym symbols earlier than their symbol */
+    uint32_t reorderPpm;    /**< packets sent after the next packet of the same eAxC */
+    uint32_t seed;          /**< seed of the impairment pattern, 0 for a fixed default */
+};
+
 /**
 * XRAN Front haul interface initialization settings
 */
@@ -726,6 +795,9 @@ struct xran_fh_init {
     uint16_t xran_max_frame;    /**< max frame number supported */
 
     struct xran_ru_init ruCfg[XRAN_PORTS_NUM];
+    uint16_t rxPktPerSym[XRAN_PORTS_NUM];   /**< max number of U-plane packets received per symbol and eAxC,
+                                                 0 for XRAN_MAX_RX_PKT_PER_SYM */
+    struct xran_ru_loadgen_cfg ruLoadGen;   /**< O-RU load generator, O-RU mode only */
 
     int32_t  debugStop;         /**< Enable auto stop */
     int32_t  debugStopCount;    /**< Enable auto stop after number of Tx packets */
@@ -780,14 +852,16 @@ struct xran_cp_bf_precoding{
     int16_t weight[4];
 };
 
+/** Packets received in single symbol. The arrays hold nRxPktMax entries of the per port
+ *  storage allocated at xran_open and are set by xran on the first packet of the symbol. */
 struct xran_rx_packet_ctl {
-    uint16_t nRBStart[XRAN_MAX_RX_PKT_PER_SYM];    /**< start RB of RB allocation */
-    uint16_t nRBSize[XRAN_MAX_RX_PKT_PER_SYM];     /**< number of RBs used */
-    uint16_t nSectid[XRAN_MAX_RX_PKT_PER_SYM];     /**< number of RBs used */
-    uint8_t *pData[XRAN_MAX_RX_PKT_PER_SYM];      /**< pointer to data buffer */
-    void    *pCtrl[XRAN_MAX_RX_PKT_PER_SYM];      /**< pointer to mbuf */
+    uint16_t *nRBStart;     /**< start RB of RB allocation */
+    uint16_t *nRBSize;      /**< number of RBs used */
+    uint16_t *nSectid;      /**< section id */
+    uint8_t **pData;        /**< pointer to data buffer */
+    void    **pCtrl;        /**< pointer to mbuf */
     int32_t nRxPkt;    /**< number of Rx packets received */
-    int32_t reserved;    /**< reserved */
+    int32_t nRxPktMax; /**< capacity of the arrays, packets over it are counted in rx_err_pkt_per_sym */
 };
 
 /** section descriptor for given number of PRBs used on U-plane packet creation */
@@ -1002,6 +1076,7 @@ struct xran_fh_config {
 
     uint8_t enableCP;       /**<  enable C-plane */
     uint8_t dropPacketsUp;   /**<  enable droping the up channel packets if they miss timing window */
+    uint8_t rxSeqIdWindow;   /**<  depth of the U-plane RX eCPRI seqId reorder window, 0: default (32), max 56 */
     uint8_t srsEnable;      /**<  enable SRS (Cat B specific) */
     uint8_t srsEnableCp;    /**<  enable SRS Cp(Cat B specific) */
     uint8_t SrsDelaySym;   /**<  enable SRS Cp(Cat B specific) */
@@ -1132,6 +1207,9 @@ struct xran_common_counters{
     uint64_t Rx_corrupt;      /**< Corrupt/Incorrect header packet */
     uint64_t Rx_pkt_dupl;     /**< Duplicated packet */
     uint64_t Total_msgs_rcvd; /**< Total messages received (on all links) */
+    uint64_t Rx_pkt_lost;     /**< U-plane seqId never received within the RX reorder window */
+    uint64_t Rx_pkt_reorder;  /**< U-plane packet received out of order within the RX reorder window */
+    uint64_t Rx_pkt_late;     /**< U-plane packet received after its seqId left the RX reorder window */
 
     /* debug statistis */
     uint64_t rx_counter;
@@ -1171,6 +1249,7 @@ struct xran_common_counters{
     uint32_t rx_err_prach;   /** < (Internal counter) Number of PRACH packets dropped due to errors in UP data section header */
     uint32_t rx_err_cp;      /** < (Internal counter) Number of packets dropped due to errors in CP section header */
     uint32_t rx_err_ecpri;   /** < (Internal counter) Number of packets dropped due to error in eCPRI header */
+    uint32_t rx_err_pkt_per_sym; /** < (Internal counter) Number of U-plane packets dropped over the packets per symbol of the port */
 };
 
 
@@ -1910,6 +1989,35 @@ int32_t xran_get_cc_isactive(void *pHandle, uint32_t cc_id);
 int32_t xran_reg_sym_cb(void *pHandle, xran_callback_sym_fn symCb, void * symCbParam, struct xran_sense_of_time* symCbTime,
         uint8_t symb, enum cb_per_sym_type_id cb_sym_t_id, uint8_t mu);
 
+/**
+ * @ingroup xran
+ *
+ *   Function registers early UL completion callback to XRAN layer. The PRBs of the RX PRB map are counted per
+ *   symbol when the UL C-plane of a slot is sent and the callback is called from the RX thread the moment the
+ *   U-plane PRBs received reach the expected count, long before the UL deadline in the no-loss case. Every UL
+ *   slot of an active CC is reported exactly once: with XRAN_UL_DONE_SLOT_SYM by the RX thread when it is
+ *   complete, otherwise with XRAN_UL_DONE_TIMEOUT_SYM by the full slot deadline, just before pCallback of
+ *   xran_5g_fronthault_config, which is still called for every slot. Per slot hand-off to L1 belongs in this
+ *   callback, it is expected to be short.
+ *
+ * @param pHandle
+ *   Pointer to XRAN layer handle for given port
+ * @param Cb
+ *   pointer to callback function, called with symb XRAN_UL_DONE_SLOT_SYM or XRAN_UL_DONE_TIMEOUT_SYM for the slot
+ * @param cbParam
+ *   pointer to Callback Function parameters
+ * @param mode
+ *   per slot or per symbol callbacks (see enum xran_ul_done_cb_mode), XRAN_UL_DONE_CB_OFF disables them
+ * @param mu
+ *   Numerology for which to call this callback
+ *
+ * @return
+ *    0 - in case of success
+ *   -1 - in case of failure
+ */
+int32_t xran_reg_ul_done_cb(void *pHandle, xran_ul_done_callback_fn Cb, void *cbParam,
+        enum xran_ul_done_cb_mode mode, uint8_t mu);
+
 
 /**
  * @ingroup xran
@@ -2179,6 +2287,57 @@ void xran_config_dpdk_process_id_tag(int32_t Tag);
 
 int xran_get_memstat(struct xran_memstat *stat);
 
+/**
+ * @ingroup xran
+ *
+ *   Function starts capturing fronthaul packets to a PCAP-NG file. IO cores copy the packets of each
+ *   VF and direction into a ring next to the burst call, a writer thread drains the rings into the file.
+ *   Worker threads sending U-plane symbols directly have a TX ring each, up to XRAN_PCAP_TX_WORKERS.
+ *   Packets which do not fit in a ring are left out of the capture and counted. With XRAN_PCAP_TS_HW
+ *   the NIC clock of each VF is sampled against the TSC for 10 ms to convert RX timestamps.
+ *
+ * @param pFileName
+ *    PCAP-NG file to write, one interface per VF
+ * @param snapLen
+ *    bytes captured per packet, 0 for the whole packet
+ * @param bufSize
+ *    bytes of ring per VF and direction and per TX worker, rounded up to a power of 2, 0 for the default
+ * @param flags
+ *    XRAN_PCAP_RX, XRAN_PCAP_TX and XRAN_PCAP_TS_HW
+ * @return
+ *    0 - on success
+ */
+int32_t xran_pcap_start(const char *pFileName, uint32_t snapLen, uint32_t bufSize, uint32_t flags);
+
+/**
+ * @ingroup xran
+ *
+ *   Function stops the packet capture, writes what is left in the rings and closes the file
+ *
+ * @return
+ *    0 - on success
+ */
+int32_t xran_pcap_stop(void);
+
+/**
+ * @ingroup xran
+ *
+ *   Function replays a PCAP-NG or pcap capture into the RX path (xran_handle_rx_pkts()) on the calling
+ *   thread. Received packets go to the VF of their interface, sent packets are skipped. It must not run
+ *   while IO cores receive on the same ports. U-plane packets are checked against the current O-RAN time,
+ *   so reception window counters are only meaningful when timing is replayed as well.
+ *
+ * @param pFileName
+ *    capture to replay
+ * @param speed
+ *    0 - as fast as possible, 1 - original timing, N - N times faster
+ * @param pStats
+ *    replay statistics, may be NULL
+ * @return
+ *    0 - on success
+ */
+int32_t xran_pcap_replay(const char *pFileName, uint32_t speed, struct xran_pcap_replay_stats *pStats);
+
 #ifdef POLL_EBBU_OFFLOAD
 /* All functions/variables defined below are to support the polling event processing feature of eBBUPOOL framework*/
 
@@ -64,6 +64,7 @@
 
 #include "xran_ethernet.h"
 #include "xran_ethdi.h"
+#include "xran_pcap.h"
 #include "xran_fh_o_du.h"
 #include "xran_mlog_lnx.h"
 #include "xran_printf.h"
@@ -157,7 +158,7 @@ int xran_handle_ether(uint16_t ethertype, struct rte_mbuf* pkt_q[], uint16_t xpo
 
     struct xran_device_ctx* p_dev_ctx = xran_dev_get_ctx_by_id(xport_id);
     if (likely(p_dev_ctx != NULL)){
-        p_dev_ctx->fh_counters.rx_err_drop += num;
+        xran_fh_counters(p_dev_ctx)->rx_err_drop += num;
     }
     print_dbg("Packet with unrecognized ethertype '%.4X' dropped", ethertype);
 
@@ -177,6 +178,32 @@ int xran_ethdi_filter_packet(struct rte_mbuf *pkt_q[], uint16_t vf_id, uint16_t
     return MBUF_FREE;
 }
 
+/* Virtual devices take DPDK device arguments (net_memif0,role=server,...)
+ * instead of a PCI address and are probed by name */
+int32_t xran_ethdi_is_vdev(const char *devargs)
+{
+    if (devargs == NULL)
+        return 0;
+
+    return (strncmp(devargs, XRAN_VDEV_PREFIX, strlen(XRAN_VDEV_PREFIX)) == 0
+            || strncmp(devargs, XRAN_VDEV_PREFIX_LEGACY, strlen(XRAN_VDEV_PREFIX_LEGACY)) == 0);
+}
+
+/* port of a virtual device, its name is the device arguments up to the first comma */
+static int32_t xran_ethdi_vdev_port(const char *devargs, uint16_t *port_id)
+{
+    char name[RTE_ETH_NAME_MAX_LEN];
+    size_t len = strcspn(devargs, ",");
+
+    if (len == 0 || len >= sizeof(name))
+        return -1;
+
+    memcpy(name, devargs, len);
+    name[len] = '\0';
+
+    return rte_eth_dev_get_port_by_name(name, port_id);
+}
+
 /* Check the link status of all ports in up to 9s, and print them finally */
 static void check_port_link_status(uint8_t portid)
 {
@@ -546,9 +573,21 @@ int32_t xran_ethdi_init_dpdk_ports(struct xran_io_cfg *io_cfg,
                     errx(1, "Network port doesn't exist\n");
             }
 
-            RTE_ETH_FOREACH_MATCHING_DEV(port_id, io_cfg->dpdk_dev[i], &iterator){
-                    port[i] = port_id;
-                    xran_init_port(port[i], io_cfg, mtu);
+            if (xran_ethdi_is_vdev(io_cfg->dpdk_dev[i])) {
+                /* no flow steering on virtual devices, all eAxCs share one queue */
+                if (io_cfg->num_rxq > 1)
+                    errx(1, "Virtual device %s supports a single RX queue only\n", io_cfg->dpdk_dev[i]);
+                if (xran_ethdi_vdev_port(io_cfg->dpdk_dev[i], &port_id) != 0)
+                    errx(1, "Virtual device %s has no port\n", io_cfg->dpdk_dev[i]);
+
+                printf("vf %d virtual device %s port %d\n", i, io_cfg->dpdk_dev[i], port_id);
+                port[i] = port_id;
+                xran_init_port(port[i], io_cfg, mtu);
+            } else {
+                RTE_ETH_FOREACH_MATCHING_DEV(port_id, io_cfg->dpdk_dev[i], &iterator){
+                        port[i] = port_id;
+                        xran_init_port(port[i], io_cfg, mtu);
+                }
             }
 
             if(!(i & 1) || io_cfg->one_vf_cu_plane){
@@ -1009,8 +1048,8 @@ xran_status_t xran_create_and_send_lbr_pkt(uint32_t lbm_transId, uint16_t port_i
         return XRAN_STATUS_FAIL;
     }
 
-    ++xran_dev_ctx->fh_counters.tx_counter;
-    xran_dev_ctx->fh_counters.tx_bytes_counter += rte_pktmbuf_pkt_len(pkt);
+    ++xran_fh_counters(xran_dev_ctx)->tx_counter;
+    xran_fh_counters(xran_dev_ctx)->tx_bytes_counter += rte_pktmbuf_pkt_len(pkt);
 
     return XRAN_STATUS_SUCCESS;
 }
@@ -1273,14 +1312,14 @@ xran_status_t xran_create_and_send_lbm_packet(uint8_t port_id, struct xran_ethdi
         return XRAN_STATUS_FAIL;
     }
 
-    ++xran_dev_ctx->fh_counters.tx_counter;
-    xran_dev_ctx->fh_counters.tx_bytes_counter += rte_pktmbuf_pkt_len(pkt);
+    ++xran_fh_counters(xran_dev_ctx)->tx_counter;
+    xran_fh_counters(xran_dev_ctx)->tx_bytes_counter += rte_pktmbuf_pkt_len(pkt);
 
 
     return XRAN_STATUS_SUCCESS;
 }
 
-static inline uint16_t xran_tx_from_ring(int port, struct rte_ring *r)
+static inline uint16_t xran_tx_from_ring(int port, uint16_t vf, struct rte_ring *r)
 {
     struct rte_mbuf *mbufs[BURST_SIZE];
     uint16_t dequeued, sent = 0;
@@ -1292,6 +1331,10 @@ static inline uint16_t xran_tx_from_ring(int port, struct rte_ring *r)
     if (!dequeued)
         return 0;   /* Nothing to send. */
 
+    /* the PMD may free the mbufs once sent */
+    if (unlikely(xran_pcap_flags & XRAN_PCAP_TX))
+        xran_pcap_tap(vf, XRAN_PCAP_DIR_TX, mbufs, dequeued);
+
     while (1) {     /* When tx queue is full it is trying again till succeed */
         sent += rte_eth_tx_burst(port, 0, &mbufs[sent], dequeued - sent);
         if (sent == dequeued){
@@ -1338,6 +1381,8 @@ int32_t process_dpdk_io(void* args)
             if (rxed != 0){
                 unsigned enq_n = 0;
                 long t1 = MLogXRANTick();
+                if (unlikely(xran_pcap_flags & XRAN_PCAP_RX))
+                    xran_pcap_tap(port_id, XRAN_PCAP_DIR_RX, mbufs, rxed);
                 ctx->rx_vf_queue_cnt[port[port_id]][qi] += rxed;
                 enq_n =  rte_ring_enqueue_burst(ctx->rx_ring[port_id][qi], (void*)mbufs, rxed, NULL);
                 if(rxed - enq_n)
@@ -1348,7 +1393,7 @@ int32_t process_dpdk_io(void* args)
 
         /* TX */
 
-        xran_tx_from_ring(port[port_id], ctx->tx_ring[port_id]);
+        xran_tx_from_ring(port[port_id], port_id, ctx->tx_ring[port_id]);
         /* One way Delay Measurements */
         if ((cfg->eowd_cmn[cfg->id].owdm_enable != 0) && (cfg->eowd_cmn[cfg->id].measVf == port_id))
         {
@@ -1404,6 +1449,8 @@ int32_t process_dpdk_io_port_id(int32_t port_start, int32_t port_num)
             if (rxed != 0){
                 unsigned enq_n = 0;
                 rxed_total += rxed;
+                if (unlikely(xran_pcap_flags & XRAN_PCAP_RX))
+                    xran_pcap_tap(port_id, XRAN_PCAP_DIR_RX, mbufs, rxed);
                 ctx->rx_vf_queue_cnt[port[port_id]][qi] += rxed;
                 enq_n =  rte_ring_enqueue_burst(ctx->rx_ring[port_id][qi], (void*)mbufs, rxed, NULL);
                 if(rxed - enq_n)
@@ -1412,7 +1459,7 @@ int32_t process_dpdk_io_port_id(int32_t port_start, int32_t port_num)
         }
 
         // /* TX */
-        xran_tx_from_ring(port[port_id], ctx->tx_ring[port_id]);
+        xran_tx_from_ring(port[port_id], port_id, ctx->tx_ring[port_id]);
 
         if (XRAN_STOPPED == xran_if_current_state)
             return -1;
@@ -1446,7 +1493,7 @@ int32_t process_dpdk_io_tx(void* args)
         if(port[port_id] == 0xFF)
             return 0;
         /* TX */
-        xran_tx_from_ring(port[port_id], ctx->tx_ring[port_id]);
+        xran_tx_from_ring(port[port_id], port_id, ctx->tx_ring[port_id]);
 
         if (XRAN_STOPPED == xran_if_current_state)
             return -1;
@@ -1482,6 +1529,8 @@ int32_t process_dpdk_io_rx(void* args)
             if (rxed != 0){
                 unsigned enq_n = 0;
                 long t1 = MLogXRANTick();
+                if (unlikely(xran_pcap_flags & XRAN_PCAP_RX))
+                    xran_pcap_tap(port_id, XRAN_PCAP_DIR_RX, mbufs, rxed);
                 ctx->rx_vf_queue_cnt[port[port_id]][qi] += rxed;
                 enq_n =  rte_ring_enqueue_burst(ctx->rx_ring[port_id][qi], (void*)mbufs, rxed, NULL);
                 if(rxed - enq_n)
@@ -62,6 +62,9 @@ extern "C" {
 #define TX_TIMER_INTERVAL ((rte_get_timer_hz() / 1000000000L)*interval_us*1000) /* nanosec */
 #define TX_RX_LOOP_TIME (rte_get_timer_hz() / 1)
 
+#define XRAN_VDEV_PREFIX        "net_"  /**< DPDK virtual network device, e.g. net_memif0,role=server */
+#define XRAN_VDEV_PREFIX_LEGACY "eth_"  /**< older name of some virtual devices, e.g. eth_af_packet0 */
+
 #define NSEC_PER_MILLI_SEC (1000000L)
 #define TIMESPEC_TO_NSEC(ts) ((ts.tv_sec*NSEC_PER_SEC) + ts.tv_nsec)
 
@@ -152,6 +155,8 @@ int32_t xran_ethdi_init_dpdk_ports(struct xran_io_cfg *io_cfg, int *lcore_id,
                                 struct rte_ether_addr *p_o_du_addr,
                                 struct rte_ether_addr *p_ru_addr, uint32_t mtu);
 
+int32_t xran_ethdi_is_vdev(const char *devargs);
+
 struct rte_mbuf *xran_ethdi_mbuf_alloc(void);
 struct rte_mbuf *xran_ethdi_mbuf_indir_alloc(void);
 int32_t xran_ethdi_mbuf_send(struct rte_mbuf *mb, uint16_t ethertype, uint16_t vf_id);
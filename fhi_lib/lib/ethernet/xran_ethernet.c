@@ -208,6 +208,27 @@ void xran_init_port(int p_id, struct xran_io_cfg *io_cfg, uint32_t mtu)
             RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE;
     }
 
+    /* virtual devices (memif, af_packet, ring) copy or pass chained mbufs
+     * without advertising it, and cap the frame size below jumbo */
+    if (!(dev_info.tx_offload_capa & RTE_ETH_TX_OFFLOAD_MULTI_SEGS)){
+        printf("port %d: no DEV_TX_OFFLOAD_MULTI_SEGS\n", p_id);
+        port_conf.txmode.offloads &= ~RTE_ETH_TX_OFFLOAD_MULTI_SEGS;
+    }
+#if (RTE_VER_YEAR >= 21)
+    if (dev_info.max_mtu && port_conf.rxmode.mtu > dev_info.max_mtu){
+        printf("port %d: MTU %u limited to %u\n", p_id, port_conf.rxmode.mtu, dev_info.max_mtu);
+        port_conf.rxmode.mtu = dev_info.max_mtu;
+    }
+
+    /* NIC RX timestamps, picked up by the packet capture */
+    if (io_cfg->rx_timestamp){
+        if (dev_info.rx_offload_capa & RTE_ETH_RX_OFFLOAD_TIMESTAMP)
+            port_conf.rxmode.offloads |= RTE_ETH_RX_OFFLOAD_TIMESTAMP;
+        else
+            printf("port %d: no RX timestamp offload\n", p_id);
+    }
+#endif
+
     rte_eth_macaddr_get(p_id, &addr);
 
     printf("Port %u MAC: %02"PRIx8" %02"PRIx8" %02"PRIx8
@@ -0,0 +1,632 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief Fronthaul packet capture to PCAP-NG and replay into the RX path
+ * @file xran_pcap.c
+ * @ingroup group_lte_source_auxlib
+ * @author Intel Corporation
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <immintrin.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_pause.h>
+#include <rte_memcpy.h>
+#include <rte_mbuf.h>
+#include <rte_ethdev.h>
+#if (RTE_VER_YEAR >= 21)
+#include <rte_mbuf_dyn.h>
+#endif
+
+#include "xran_fh_o_du.h"
+#include "xran_ethernet.h"
+#include "xran_ethdi.h"
+#include "xran_printf.h"
+#include "xran_pcap.h"
+
+#define XRAN_PCAP_RING_SIZE         (8 * 1024 * 1024)   /**< default ring per VF and direction */
+#define XRAN_PCAP_WRITER_BATCH      (1024)              /**< records written between two looks at the stop flag */
+#define XRAN_PCAP_WRITER_SLEEP_US   (100)
+#define XRAN_PCAP_REPLAY_BURST      (16)                /**< MBUFS_CNT, largest batch xran_handle_rx_pkts() takes */
+#define XRAN_PCAP_NUM_DIR           (2)
+#define XRAN_PCAP_CLOCK_CAL_US      (10000)             /**< NIC clock against TSC sampling interval */
+
+struct xran_pcap_ctx
+{
+    struct xran_pcap_ring ring[XRAN_VF_MAX][XRAN_PCAP_NUM_DIR];
+    struct xran_pcap_ring wring[XRAN_PCAP_TX_WORKERS];  /**< TX of the worker threads, see xran_pcap_tap_worker() */
+    uint64_t drops[XRAN_VF_MAX][XRAN_PCAP_NUM_DIR];     /**< written by the producer of the ring */
+    uint64_t wdrops[XRAN_PCAP_TX_WORKERS];
+    uint64_t unbound;                                   /**< TX of workers past XRAN_PCAP_TX_WORKERS, not captured */
+    uint32_t numWorkers;                                /**< worker rings handed out */
+    uint64_t written[XRAN_VF_MAX][XRAN_PCAP_NUM_DIR];   /**< written by the writer thread */
+    uint64_t writeErr;
+    uint32_t numVf;
+    uint32_t snapLen;
+    FILE     *pFile;
+    uint8_t  *pBlock;               /**< one EPB of snapLen bytes */
+    pthread_t writer;
+    volatile int32_t stop;
+    uint64_t tscBase;
+    uint64_t nsBase;
+    double   nsPerTsc;
+    int32_t  tsOff;                 /**< mbuf dynamic field of the NIC RX timestamp */
+    uint64_t tsFlag;                /**< mbuf flag telling the field is valid, 0 without NIC timestamps */
+    uint8_t  hwTs[XRAN_VF_MAX];     /**< NIC clock of the VF calibrated */
+    struct xran_pcap_nic_clock nicClk[XRAN_VF_MAX];
+};
+
+volatile uint32_t xran_pcap_flags = 0;
+
+static struct xran_pcap_ctx gPcap;
+
+/* IO cores inside xran_pcap_tap(), out of gPcap: a start must not clear it under a core still leaving */
+static volatile int32_t gPcapBusy = 0;
+
+/* worker ring of the calling thread, valid for the capture it was handed out in */
+static uint32_t gPcapEpoch = 0;
+static __thread int32_t xran_pcap_worker_id = -1;
+static __thread uint32_t xran_pcap_worker_epoch = 0;
+
+static inline uint64_t xran_pcap_clock_ns(clockid_t clk)
+{
+    struct timespec ts;
+
+    clock_gettime(clk, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* copy a burst into a ring, returns the number of packets captured */
+static uint16_t xran_pcap_copy(struct xran_pcap_ring *pRing, uint64_t *pDrops, uint16_t vf, uint8_t dir,
+                struct rte_mbuf *pkts[], uint16_t num)
+{
+    struct xran_pcap_rec *pRec;
+    const void *pData;
+    uint64_t ts;
+    uint32_t capLen, origLen;
+    uint16_t i;
+
+    ts = gPcap.nsBase + (uint64_t)((double)(rte_rdtsc() - gPcap.tscBase) * gPcap.nsPerTsc);
+
+    for(i = 0; i < num; i++)
+    {
+        origLen = rte_pktmbuf_pkt_len(pkts[i]);
+        capLen  = RTE_MIN(origLen, gPcap.snapLen);
+        pRec    = xran_pcap_ring_reserve(pRing, capLen);
+        if(unlikely(pRec == NULL))
+        {
+            *pDrops += num - i;
+            break;
+        }
+
+        pRec->vf      = vf;
+        pRec->dir     = dir;
+        pRec->origLen = origLen;
+        pRec->ts      = ts;
+#if (RTE_VER_YEAR >= 21)
+        if(gPcap.tsFlag && gPcap.hwTs[vf] && (pkts[i]->ol_flags & gPcap.tsFlag))
+            pRec->ts = xran_pcap_nic_clock_ns(&gPcap.nicClk[vf], *RTE_MBUF_DYNFIELD(pkts[i], gPcap.tsOff, rte_mbuf_timestamp_t *));
+#endif
+        /* chained mbufs are gathered into the record */
+        pData = rte_pktmbuf_read(pkts[i], 0, capLen, pRec + 1);
+        if(pData != (const void *)(pRec + 1))
+            memcpy(pRec + 1, pData, capLen);
+
+        xran_pcap_ring_commit(pRing);
+    }
+
+    return i;
+}
+
+/**
+ * @brief Copy a burst of packets into the capture ring of a VF and direction
+ *
+ * Called by the IO core owning the VF, right after the RX burst or before the
+ * TX burst, only when xran_pcap_flags has the direction set. Each ring has a
+ * single producer: a VF is polled by one IO core.
+ *
+ * @param vf VF of the packets
+ * @param dir XRAN_PCAP_DIR_RX or XRAN_PCAP_DIR_TX
+ * @param pkts packets
+ * @param num number of packets
+ * @return number of packets captured
+ */
+int32_t xran_pcap_tap(uint16_t vf, uint8_t dir, struct rte_mbuf *pkts[], uint16_t num)
+{
+    uint16_t i = 0;
+
+    __atomic_fetch_add(&gPcapBusy, 1, __ATOMIC_SEQ_CST);
+    if(likely((__atomic_load_n(&xran_pcap_flags, __ATOMIC_SEQ_CST) & (1 << (dir - 1))) && vf < gPcap.numVf))
+        i = xran_pcap_copy(&gPcap.ring[vf][dir - 1], &gPcap.drops[vf][dir - 1], vf, dir, pkts, num);
+    __atomic_fetch_sub(&gPcapBusy, 1, __ATOMIC_SEQ_CST);
+
+    return i;
+}
+
+/**
+ * @brief Copy a burst of sent packets into the capture ring of the calling worker
+ *
+ * For the TX bursts of worker threads (xran_tx_sym_from_ring()), several of
+ * which may send on the same VF. Each thread gets a ring of its own on its
+ * first burst of a capture, the bursts of threads past XRAN_PCAP_TX_WORKERS
+ * are left out of the capture and counted.
+ *
+ * @param vf VF of the packets
+ * @param pkts packets
+ * @param num number of packets
+ * @return number of packets captured
+ */
+int32_t xran_pcap_tap_worker(uint16_t vf, struct rte_mbuf *pkts[], uint16_t num)
+{
+    uint16_t i = 0;
+    int32_t id;
+
+    __atomic_fetch_add(&gPcapBusy, 1, __ATOMIC_SEQ_CST);
+    if(unlikely(!(__atomic_load_n(&xran_pcap_flags, __ATOMIC_SEQ_CST) & XRAN_PCAP_TX) || vf >= gPcap.numVf))
+        goto out;
+
+    if(unlikely(xran_pcap_worker_epoch != gPcapEpoch))
+    {
+        xran_pcap_worker_epoch = gPcapEpoch;
+        xran_pcap_worker_id    = (int32_t)__atomic_fetch_add(&gPcap.numWorkers, 1, __ATOMIC_RELAXED);
+    }
+
+    id = xran_pcap_worker_id;
+    if(unlikely(id >= XRAN_PCAP_TX_WORKERS))
+    {
+        __atomic_fetch_add(&gPcap.unbound, num, __ATOMIC_RELAXED);
+        goto out;
+    }
+
+    i = xran_pcap_copy(&gPcap.wring[id], &gPcap.wdrops[id], vf, XRAN_PCAP_DIR_TX, pkts, num);
+
+out:
+    __atomic_fetch_sub(&gPcapBusy, 1, __ATOMIC_SEQ_CST);
+
+    return i;
+}
+
+/* write the oldest records of all rings, returns the number written */
+static uint32_t xran_pcap_drain(void)
+{
+    const struct xran_pcap_rec *pRec, *pOldest;
+    struct xran_pcap_ring *pRing, *pOldestRing;
+    uint32_t cnt, idx, len;
+
+    for(cnt = 0; cnt < XRAN_PCAP_WRITER_BATCH; cnt++)
+    {
+        pOldest     = NULL;
+        pOldestRing = NULL;
+
+        /* the rings of the VFs, then the ones of the workers */
+        for(idx = 0; idx < XRAN_VF_MAX * XRAN_PCAP_NUM_DIR + XRAN_PCAP_TX_WORKERS; idx++)
+        {
+            if(idx < XRAN_VF_MAX * XRAN_PCAP_NUM_DIR)
+                pRing = &gPcap.ring[idx / XRAN_PCAP_NUM_DIR][idx % XRAN_PCAP_NUM_DIR];
+            else
+                pRing = &gPcap.wring[idx - XRAN_VF_MAX * XRAN_PCAP_NUM_DIR];
+            if(pRing->pBuf == NULL || (pRec = xran_pcap_ring_peek(pRing)) == NULL)
+                continue;
+            if(pOldest == NULL || pRec->ts < pOldest->ts)
+            {
+                pOldest     = pRec;
+                pOldestRing = pRing;
+            }
+        }
+
+        if(pOldest == NULL)
+            break;
+
+        len = xran_pcapng_epb(gPcap.pBlock, pOldest->vf, pOldest->ts, (const uint8_t *)(pOldest + 1),
+                    pOldest->capLen, pOldest->origLen, pOldest->dir);
+        if(fwrite(gPcap.pBlock, len, 1, gPcap.pFile) != 1)
+            gPcap.writeErr++;
+        else
+            gPcap.written[pOldest->vf][pOldest->dir - 1]++;
+
+        xran_pcap_ring_release(pOldestRing, pOldest);
+    }
+
+    return cnt;
+}
+
+static void *xran_pcap_writer(void *arg)
+{
+    int32_t stop;
+
+    while(1)
+    {
+        /* read before draining, what was captured before the stop is written */
+        stop = __atomic_load_n(&gPcap.stop, __ATOMIC_ACQUIRE);
+        if(xran_pcap_drain() == 0)
+        {
+            if(stop)
+                break;
+            usleep(XRAN_PCAP_WRITER_SLEEP_US);
+        }
+    }
+
+    return NULL;
+}
+
+static void xran_pcap_free(void)
+{
+    uint32_t vf, dir, id;
+
+    for(vf = 0; vf < XRAN_VF_MAX; vf++)
+        for(dir = 0; dir < XRAN_PCAP_NUM_DIR; dir++)
+        {
+            if(gPcap.ring[vf][dir].pBuf)
+                _mm_free(gPcap.ring[vf][dir].pBuf);
+            gPcap.ring[vf][dir].pBuf = NULL;
+        }
+
+    for(id = 0; id < XRAN_PCAP_TX_WORKERS; id++)
+    {
+        if(gPcap.wring[id].pBuf)
+            _mm_free(gPcap.wring[id].pBuf);
+        gPcap.wring[id].pBuf = NULL;
+    }
+
+    if(gPcap.pBlock)
+        free(gPcap.pBlock);
+    gPcap.pBlock = NULL;
+
+    if(gPcap.pFile)
+        fclose(gPcap.pFile);
+    gPcap.pFile = NULL;
+}
+
+/**
+ * @brief Put the NIC clock of every VF on the wall clock of the capture
+ *
+ * RX timestamps are in NIC clock ticks, of a device specific rate. The clock
+ * of each port is sampled against the TSC twice, XRAN_PCAP_CLOCK_CAL_US
+ * apart, which gives its rate and its value at a known wall clock time.
+ * VFs whose NIC clock cannot be read keep the TSC timestamps.
+ *
+ * @param ctx ethdi context
+ * @return number of VFs with NIC timestamps
+ */
+static uint32_t xran_pcap_nic_clock_init(struct xran_ethdi_ctx *ctx)
+{
+    uint32_t num = 0;
+#if (RTE_VER_YEAR >= 21)
+    uint64_t clk0[XRAN_VF_MAX], tsc0[XRAN_VF_MAX];
+    uint64_t clk1, tsc1, end;
+    uint32_t vf;
+
+    for(vf = 0; vf < gPcap.numVf; vf++)
+    {
+        if(rte_eth_read_clock((uint16_t)ctx->io_cfg.port[vf], &clk0[vf]) == 0)
+        {
+            tsc0[vf]        = rte_rdtsc();
+            gPcap.hwTs[vf]  = 1;
+        }
+    }
+
+    end = rte_rdtsc() + rte_get_tsc_hz() / 1000000 * XRAN_PCAP_CLOCK_CAL_US;
+    while(rte_rdtsc() < end)
+        rte_pause();
+
+    for(vf = 0; vf < gPcap.numVf; vf++)
+    {
+        if(!gPcap.hwTs[vf])
+            continue;
+
+        if(rte_eth_read_clock((uint16_t)ctx->io_cfg.port[vf], &clk1) != 0)
+        {
+            gPcap.hwTs[vf] = 0;
+            continue;
+        }
+        tsc1 = rte_rdtsc();
+
+        gPcap.hwTs[vf] = (uint8_t)(xran_pcap_nic_clock_set(&gPcap.nicClk[vf], clk0[vf], clk1,
+                            (double)(tsc1 - tsc0[vf]) * gPcap.nsPerTsc,
+                            gPcap.nsBase + (uint64_t)((double)(tsc1 - gPcap.tscBase) * gPcap.nsPerTsc)) == 0);
+        num += gPcap.hwTs[vf];
+    }
+#endif
+    return num;
+}
+
+int32_t xran_pcap_start(const char *pFileName, uint32_t snapLen, uint32_t bufSize, uint32_t flags)
+{
+    struct xran_ethdi_ctx *ctx = xran_ethdi_get_ctx();
+    uint8_t hdr[XRAN_PCAPNG_SHB_LEN + 64];
+    char ifName[XRAN_PCAP_IF_NAME_LEN];
+    uint32_t vf, dir, len;
+
+    if(pFileName == NULL || !(flags & (XRAN_PCAP_RX | XRAN_PCAP_TX)))
+        return XRAN_STATUS_INVALID_PARAM;
+
+    if(gPcap.pFile)
+    {
+        print_err("packet capture already running");
+        return XRAN_STATUS_FAIL;
+    }
+
+    memset(&gPcap, 0, sizeof(gPcap));
+    gPcap.numVf   = RTE_MIN((uint32_t)ctx->io_cfg.num_vfs, (uint32_t)XRAN_VF_MAX);
+    gPcap.snapLen = (snapLen == 0 || snapLen > MAX_RX_LEN) ? MAX_RX_LEN : snapLen;
+
+    /* room for two full records at least */
+    bufSize = rte_align32pow2(RTE_MAX(bufSize ? bufSize : XRAN_PCAP_RING_SIZE,
+                    2 * (uint32_t)(sizeof(struct xran_pcap_rec) + gPcap.snapLen)));
+
+    for(vf = 0; vf < gPcap.numVf; vf++)
+        for(dir = 0; dir < XRAN_PCAP_NUM_DIR; dir++)
+        {
+            if(!(flags & (1 << dir)))
+                continue;
+
+            gPcap.ring[vf][dir].pBuf = (uint8_t *)_mm_malloc(bufSize, 64);
+            if(gPcap.ring[vf][dir].pBuf == NULL)
+            {
+                print_err("no memory for the capture ring of vf %u", vf);
+                xran_pcap_free();
+                return XRAN_STATUS_RESOURCE;
+            }
+            gPcap.ring[vf][dir].size = bufSize;
+        }
+
+    if(flags & XRAN_PCAP_TX)
+    {
+        for(vf = 0; vf < XRAN_PCAP_TX_WORKERS; vf++)
+        {
+            gPcap.wring[vf].pBuf = (uint8_t *)_mm_malloc(bufSize, 64);
+            if(gPcap.wring[vf].pBuf == NULL)
+            {
+                print_err("no memory for the capture ring of worker %u", vf);
+                xran_pcap_free();
+                return XRAN_STATUS_RESOURCE;
+            }
+            gPcap.wring[vf].size = bufSize;
+        }
+    }
+
+    gPcap.pBlock = (uint8_t *)malloc(XRAN_PCAPNG_EPB_LEN + xran_pcap_align(gPcap.snapLen, 4));
+    gPcap.pFile  = fopen(pFileName, "wb");
+    if(gPcap.pBlock == NULL || gPcap.pFile == NULL)
+    {
+        print_err("cannot open %s: %s", pFileName, strerror(errno));
+        xran_pcap_free();
+        return XRAN_STATUS_FAIL;
+    }
+
+    /* one interface per VF, the interface ID of a packet is its VF */
+    len = xran_pcapng_shb(hdr);
+    fwrite(hdr, len, 1, gPcap.pFile);
+    for(vf = 0; vf < gPcap.numVf; vf++)
+    {
+        snprintf(ifName, sizeof(ifName), "vf%u", vf);
+        len = xran_pcapng_idb(hdr, gPcap.snapLen, ifName);
+        fwrite(hdr, len, 1, gPcap.pFile);
+    }
+
+    /* TSC timestamps, on the wall clock of the start */
+    gPcap.tscBase  = rte_rdtsc();
+    gPcap.nsBase   = xran_pcap_clock_ns(CLOCK_REALTIME);
+    gPcap.nsPerTsc = 1e9 / (double)rte_get_tsc_hz();
+
+    if(flags & XRAN_PCAP_TS_HW)
+    {
+#if (RTE_VER_YEAR >= 21)
+        int32_t bit;
+
+        gPcap.tsOff = rte_mbuf_dynfield_lookup(RTE_MBUF_DYNFIELD_TIMESTAMP_NAME, NULL);
+        bit         = rte_mbuf_dynflag_lookup(RTE_MBUF_DYNFLAG_RX_TIMESTAMP_NAME, NULL);
+        if(gPcap.tsOff >= 0 && bit >= 0)
+            gPcap.tsFlag = 1ULL << bit;
+#endif
+        if(gPcap.tsFlag == 0 || xran_pcap_nic_clock_init(ctx) == 0)
+        {
+            gPcap.tsFlag = 0;
+            printf("xran_pcap: no NIC RX timestamps, using TSC\n");
+        }
+    }
+
+    /* threads bound to a worker ring of an earlier capture take a new one */
+    __atomic_fetch_add(&gPcapEpoch, 1, __ATOMIC_SEQ_CST);
+
+    if(pthread_create(&gPcap.writer, NULL, xran_pcap_writer, NULL) != 0)
+    {
+        print_err("cannot start the capture writer");
+        xran_pcap_free();
+        return XRAN_STATUS_FAIL;
+    }
+
+    printf("xran_pcap: capturing %s%s of %u VFs to %s, snaplen %u, ring %u bytes\n",
+        (flags & XRAN_PCAP_RX) ? "RX " : "", (flags & XRAN_PCAP_TX) ? "TX " : "",
+        gPcap.numVf, pFileName, gPcap.snapLen, bufSize);
+
+    __atomic_store_n(&xran_pcap_flags, flags & (XRAN_PCAP_RX | XRAN_PCAP_TX), __ATOMIC_SEQ_CST);
+
+    return XRAN_STATUS_SUCCESS;
+}
+
+int32_t xran_pcap_stop(void)
+{
+    uint32_t vf;
+
+    if(gPcap.pFile == NULL)
+    {
+        print_err("no packet capture running");
+        return XRAN_STATUS_FAIL;
+    }
+
+    /* no IO core is left in xran_pcap_tap() once busy reads 0 */
+    __atomic_store_n(&xran_pcap_flags, 0, __ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&gPcapBusy, __ATOMIC_SEQ_CST))
+        rte_pause();
+
+    __atomic_store_n(&gPcap.stop, 1, __ATOMIC_RELEASE);
+    pthread_join(gPcap.writer, NULL);
+
+    for(vf = 0; vf < gPcap.numVf; vf++)
+        printf("xran_pcap: vf%u RX %"PRIu64" dropped %"PRIu64" TX %"PRIu64" dropped %"PRIu64"\n", vf,
+            gPcap.written[vf][0], gPcap.drops[vf][0], gPcap.written[vf][1], gPcap.drops[vf][1]);
+    for(vf = 0; vf < XRAN_PCAP_TX_WORKERS && vf < gPcap.numWorkers; vf++)
+        if(gPcap.wdrops[vf])
+            printf("xran_pcap: worker%u TX dropped %"PRIu64"\n", vf, gPcap.wdrops[vf]);
+    if(gPcap.unbound)
+        print_err("%"PRIu64" packets of more than %d TX workers were not captured", gPcap.unbound, XRAN_PCAP_TX_WORKERS);
+    if(gPcap.writeErr)
+        print_err("%"PRIu64" packets could not be written", gPcap.writeErr);
+
+    xran_pcap_free();
+
+    return XRAN_STATUS_SUCCESS;
+}
+
+/* hand a batch of packets of one VF to the RX path, as process_ring() does */
+static void xran_pcap_replay_flush(struct rte_mbuf *mbufs[], uint16_t vf, uint16_t *pNum,
+                struct xran_pcap_replay_stats *pStats)
+{
+    uint64_t t;
+
+    if(*pNum == 0)
+        return;
+
+    t = xran_pcap_clock_ns(CLOCK_MONOTONIC);
+    xran_ethdi_filter_packet(mbufs, vf, 0, *pNum);
+    pStats->elapsedNs += xran_pcap_clock_ns(CLOCK_MONOTONIC) - t;
+    *pNum = 0;
+}
+
+int32_t xran_pcap_replay(const char *pFileName, uint32_t speed, struct xran_pcap_replay_stats *pStats)
+{
+    struct xran_ethdi_ctx *ctx = xran_ethdi_get_ctx();
+    struct xran_pcap_replay_stats stats;
+    struct xran_pcap_reader reader;
+    struct xran_pcap_pkt pkt;
+    struct rte_mbuf *mbufs[XRAN_PCAP_REPLAY_BURST];
+    struct rte_mbuf *mb;
+    struct stat st;
+    void *pMap;
+    uint64_t firstTs = 0, startNs = 0, due, now;
+    uint16_t num = 0, batchVf = 0;
+    int32_t fd, ret;
+
+    if(pFileName == NULL)
+        return XRAN_STATUS_INVALID_PARAM;
+
+    fd = open(pFileName, O_RDONLY);
+    if(fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        print_err("cannot open %s", pFileName);
+        if(fd >= 0)
+            close(fd);
+        return XRAN_STATUS_FAIL;
+    }
+    pMap = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(pMap == MAP_FAILED)
+    {
+        print_err("cannot map %s", pFileName);
+        return XRAN_STATUS_FAIL;
+    }
+
+    if(xran_pcap_reader_init(&reader, (const uint8_t *)pMap, st.st_size) != 0)
+    {
+        print_err("%s is not an Ethernet pcap or PCAP-NG file in host byte order", pFileName);
+        munmap(pMap, st.st_size);
+        return XRAN_STATUS_INVALID_PARAM;
+    }
+
+    memset(&stats, 0, sizeof(stats));
+
+    while((ret = xran_pcap_reader_next(&reader, &pkt)) == 1)
+    {
+        if(pkt.dir == XRAN_PCAP_DIR_TX || pkt.ifId >= ctx->io_cfg.num_vfs || pkt.ifId >= XRAN_VF_MAX
+            || ctx->vf2xran_port[pkt.ifId] == 0xFFFF)
+        {
+            stats.skipped++;
+            continue;
+        }
+
+        if(num && (pkt.ifId != batchVf || num == XRAN_PCAP_REPLAY_BURST))
+            xran_pcap_replay_flush(mbufs, batchVf, &num, &stats);
+
+        if(speed)
+        {
+            if(stats.pkts == 0)
+            {
+                firstTs = pkt.ts;
+                startNs = xran_pcap_clock_ns(CLOCK_MONOTONIC);
+            }
+
+            due = startNs + (pkt.ts > firstTs ? (pkt.ts - firstTs) / speed : 0);
+            if((now = xran_pcap_clock_ns(CLOCK_MONOTONIC)) < due)
+            {
+                /* what is queued was due already */
+                xran_pcap_replay_flush(mbufs, batchVf, &num, &stats);
+                while((now = xran_pcap_clock_ns(CLOCK_MONOTONIC)) < due)
+                {
+                    if(due - now > 2 * 1000 * XRAN_PCAP_WRITER_SLEEP_US)
+                        usleep(XRAN_PCAP_WRITER_SLEEP_US);
+                    else
+                        rte_pause();
+                }
+            }
+        }
+
+        mb = xran_ethdi_mbuf_alloc();
+        if(mb == NULL || pkt.capLen > rte_pktmbuf_tailroom(mb))
+        {
+            if(mb)
+                rte_pktmbuf_free(mb);
+            stats.skipped++;
+            continue;
+        }
+        rte_memcpy(rte_pktmbuf_append(mb, (uint16_t)pkt.capLen), pkt.pData, pkt.capLen);
+
+        batchVf       = (uint16_t)pkt.ifId;
+        mbufs[num++]  = mb;
+        stats.pkts++;
+        stats.bytes  += pkt.capLen;
+    }
+
+    xran_pcap_replay_flush(mbufs, batchVf, &num, &stats);
+    munmap(pMap, st.st_size);
+
+    if(ret < 0)
+        print_err("%s is truncated or corrupted after %"PRIu64" packets", pFileName, stats.pkts);
+
+    printf("xran_pcap: replayed %"PRIu64" packets %"PRIu64" bytes, skipped %"PRIu64", %.1f ns per packet in RX\n",
+        stats.pkts, stats.bytes, stats.skipped, stats.pkts ? (double)stats.elapsedNs / stats.pkts : 0.0);
+
+    if(pStats)
+        *pStats = stats;
+
+    return (ret < 0) ? XRAN_STATUS_FAIL : XRAN_STATUS_SUCCESS;
+}
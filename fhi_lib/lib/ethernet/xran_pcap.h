@@ -0,0 +1,548 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief Fronthaul packet capture and replay
+ * @file xran_pcap.h
+ * @ingroup group_lte_source_auxlib
+ * @author Intel Corporation
+ *
+ * The IO cores copy every packet they receive or send into a byte ring of
+ * their VF and direction, next to the burst call. A writer thread drains the
+ * rings into a PCAP-NG file, one interface per VF, so the IO cores never
+ * touch the file. A ring that is full drops the packet from the capture,
+ * never from the fronthaul.
+ *
+ * Ring records are 8 byte aligned and never wrap: a record that does not
+ * fit in the end of the ring is preceded by a padding record taking the
+ * rest of it.
+ *
+ * Replay reads a PCAP-NG or classic pcap file and hands the received
+ * packets to the RX path of their VF, as the IO core would.
+ **/
+
+#ifndef _XRAN_PCAP_H_
+#define _XRAN_PCAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#define XRAN_PCAPNG_SHB             (0x0A0D0D0A)    /**< section header block */
+#define XRAN_PCAPNG_IDB             (0x00000001)    /**< interface description block */
+#define XRAN_PCAPNG_EPB             (0x00000006)    /**< enhanced packet block */
+#define XRAN_PCAPNG_BOM             (0x1A2B3C4D)    /**< byte order magic */
+#define XRAN_PCAPNG_OPT_END         (0)
+#define XRAN_PCAPNG_OPT_IF_NAME     (2)
+#define XRAN_PCAPNG_OPT_IF_TSRESOL  (9)
+#define XRAN_PCAPNG_OPT_EPB_FLAGS   (2)
+#define XRAN_PCAPNG_SHB_LEN         (28)
+#define XRAN_PCAPNG_EPB_LEN         (44)            /**< EPB with the flags option, without the data */
+
+#define XRAN_PCAP_MAGIC_US          (0xA1B2C3D4)    /**< classic pcap, microseconds */
+#define XRAN_PCAP_MAGIC_NS          (0xA1B23C4D)    /**< classic pcap, nanoseconds */
+#define XRAN_PCAP_HDR_LEN           (24)
+#define XRAN_PCAP_REC_HDR_LEN       (16)
+#define XRAN_PCAP_LINKTYPE_ETH      (1)
+
+#define XRAN_PCAP_MAX_IF            (64)            /**< interfaces of a capture being replayed */
+#define XRAN_PCAP_TX_WORKERS        (8)             /**< worker threads sending U-plane symbols with their own ring */
+#define XRAN_PCAP_IF_NAME_LEN       (16)
+
+/** packet direction, same values as the PCAP-NG epb_flags */
+#define XRAN_PCAP_DIR_NONE          (0)
+#define XRAN_PCAP_DIR_RX            (1)
+#define XRAN_PCAP_DIR_TX            (2)
+
+/** capture ring of a VF and direction, or of a worker thread, one producer and one consumer */
+struct xran_pcap_ring
+{
+    uint8_t  *pBuf;
+    uint32_t size;                  /**< power of two */
+    uint32_t pend;                  /**< reserved but not committed, producer only */
+    volatile uint64_t prod __attribute__((aligned(64)));
+    volatile uint64_t cons __attribute__((aligned(64)));
+};
+
+/** ring record, followed by capLen bytes of packet */
+struct xran_pcap_rec
+{
+    uint32_t len;                   /**< record length, header included, 8 byte aligned */
+    uint16_t vf;
+    uint8_t  dir;                   /**< XRAN_PCAP_DIR_*, DIR_NONE for padding */
+    uint8_t  rsvd;
+    uint32_t capLen;
+    uint32_t origLen;
+    uint64_t ts;                    /**< nanoseconds since the epoch */
+};
+
+/** NIC clock of a VF, its RX timestamps on the wall clock */
+struct xran_pcap_nic_clock
+{
+    uint64_t nicRef;                /**< NIC clock at nsRef */
+    uint64_t nsRef;                 /**< nanoseconds since the epoch */
+    double   nsPerTick;
+};
+
+/** packet read from a capture */
+struct xran_pcap_pkt
+{
+    const uint8_t *pData;
+    uint32_t capLen;
+    uint32_t origLen;
+    uint64_t ts;                    /**< nanoseconds */
+    uint32_t ifId;                  /**< PCAP-NG interface, 0 for classic pcap */
+    uint8_t  dir;                   /**< XRAN_PCAP_DIR_*, DIR_NONE when not recorded */
+};
+
+/** capture being read, the whole file in memory */
+struct xran_pcap_reader
+{
+    const uint8_t *pBuf;
+    uint64_t len;
+    uint64_t off;
+    uint32_t isNg;
+    uint32_t tsMul;                 /**< classic pcap, ns per timestamp unit */
+    uint32_t numIf;
+    uint8_t  ifTsResol[XRAN_PCAP_MAX_IF];
+};
+
+static inline uint32_t xran_pcap_align(uint32_t len, uint32_t align)
+{
+    return (len + align - 1) & ~(align - 1);
+}
+
+static inline void xran_pcap_put16(uint8_t *p, uint16_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline void xran_pcap_put32(uint8_t *p, uint32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline uint16_t xran_pcap_get16(const uint8_t *p)
+{
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t xran_pcap_get32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Reserve a record in a capture ring
+ *
+ * @param pRing capture ring
+ * @param capLen bytes of packet to store
+ * @return record to fill, NULL if the ring is full
+ */
+static inline struct xran_pcap_rec *xran_pcap_ring_reserve(struct xran_pcap_ring *pRing, uint32_t capLen)
+{
+    const uint64_t prod = pRing->prod;
+    const uint64_t cons = __atomic_load_n(&pRing->cons, __ATOMIC_ACQUIRE);
+    const uint32_t off  = (uint32_t)(prod & (pRing->size - 1));
+    const uint32_t tail = pRing->size - off;
+    const uint32_t len  = xran_pcap_align(sizeof(struct xran_pcap_rec) + capLen, 8);
+    const uint32_t need = (len > tail) ? tail + len : len;
+    struct xran_pcap_rec *pRec;
+
+    if(len > pRing->size || pRing->size - (uint64_t)(prod - cons) < need)
+        return NULL;
+
+    if(len > tail)
+    {
+        pRec = (struct xran_pcap_rec *)(pRing->pBuf + off);
+        pRec->len = tail;
+        pRec->dir = XRAN_PCAP_DIR_NONE;
+        pRec = (struct xran_pcap_rec *)pRing->pBuf;
+    }
+    else
+    {
+        pRec = (struct xran_pcap_rec *)(pRing->pBuf + off);
+    }
+
+    pRec->len    = len;
+    pRec->capLen = capLen;
+    pRing->pend  = need;
+
+    return pRec;
+}
+
+/** publish the record reserved last */
+static inline void xran_pcap_ring_commit(struct xran_pcap_ring *pRing)
+{
+    __atomic_store_n(&pRing->prod, pRing->prod + pRing->pend, __ATOMIC_RELEASE);
+    pRing->pend = 0;
+}
+
+/**
+ * @brief Oldest record of a capture ring
+ *
+ * @param pRing capture ring
+ * @return record, NULL if the ring is empty
+ */
+static inline const struct xran_pcap_rec *xran_pcap_ring_peek(struct xran_pcap_ring *pRing)
+{
+    const uint64_t prod = __atomic_load_n(&pRing->prod, __ATOMIC_ACQUIRE);
+    uint64_t cons = pRing->cons;
+    const struct xran_pcap_rec *pRec;
+
+    while(cons != prod)
+    {
+        pRec = (const struct xran_pcap_rec *)(pRing->pBuf + (cons & (pRing->size - 1)));
+        if(pRec->dir != XRAN_PCAP_DIR_NONE)
+            return pRec;
+
+        cons += pRec->len;
+        __atomic_store_n(&pRing->cons, cons, __ATOMIC_RELEASE);
+    }
+
+    return NULL;
+}
+
+/** free the record returned by xran_pcap_ring_peek() */
+static inline void xran_pcap_ring_release(struct xran_pcap_ring *pRing, const struct xran_pcap_rec *pRec)
+{
+    __atomic_store_n(&pRing->cons, pRing->cons + pRec->len, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Calibrate a NIC clock from two samples
+ *
+ * @param pClk clock to set
+ * @param clk0 first NIC clock sample
+ * @param clk1 second NIC clock sample
+ * @param elapsedNs nanoseconds between the samples
+ * @param nsAtClk1 wall clock of the second sample, nanoseconds since the epoch
+ * @return 0 on success, -1 if the NIC clock did not advance
+ */
+static inline int32_t xran_pcap_nic_clock_set(struct xran_pcap_nic_clock *pClk, uint64_t clk0, uint64_t clk1,
+                double elapsedNs, uint64_t nsAtClk1)
+{
+    if(clk1 <= clk0 || elapsedNs <= 0)
+        return -1;
+
+    pClk->nicRef    = clk1;
+    pClk->nsRef     = nsAtClk1;
+    pClk->nsPerTick = elapsedNs / (double)(clk1 - clk0);
+
+    return 0;
+}
+
+/** NIC timestamp on the wall clock, nanoseconds since the epoch */
+static inline uint64_t xran_pcap_nic_clock_ns(const struct xran_pcap_nic_clock *pClk, uint64_t nicTs)
+{
+    return pClk->nsRef + (int64_t)((double)(int64_t)(nicTs - pClk->nicRef) * pClk->nsPerTick);
+}
+
+/**
+ * @brief PCAP-NG section header block
+ *
+ * @param pOut at least XRAN_PCAPNG_SHB_LEN bytes
+ * @return block length
+ */
+static inline uint32_t xran_pcapng_shb(uint8_t *pOut)
+{
+    const uint64_t sectionLen = UINT64_MAX;     /* not specified */
+
+    xran_pcap_put32(pOut + 0,  XRAN_PCAPNG_SHB);
+    xran_pcap_put32(pOut + 4,  XRAN_PCAPNG_SHB_LEN);
+    xran_pcap_put32(pOut + 8,  XRAN_PCAPNG_BOM);
+    xran_pcap_put16(pOut + 12, 1);
+    xran_pcap_put16(pOut + 14, 0);
+    memcpy(pOut + 16, &sectionLen, sizeof(sectionLen));
+    xran_pcap_put32(pOut + 24, XRAN_PCAPNG_SHB_LEN);
+
+    return XRAN_PCAPNG_SHB_LEN;
+}
+
+/**
+ * @brief PCAP-NG interface description block, Ethernet with nanosecond timestamps
+ *
+ * @param pOut at least 40 bytes plus the name
+ * @param snapLen capture length of the interface
+ * @param pName interface name, up to XRAN_PCAP_IF_NAME_LEN characters
+ * @return block length
+ */
+static inline uint32_t xran_pcapng_idb(uint8_t *pOut, uint32_t snapLen, const char *pName)
+{
+    const uint32_t nameLen = (uint32_t)strnlen(pName, XRAN_PCAP_IF_NAME_LEN);
+    const uint32_t namePad = xran_pcap_align(nameLen, 4);
+    const uint32_t len     = 16 + 4 + namePad + 8 + 4 + 4;
+    uint8_t *p = pOut;
+
+    xran_pcap_put32(p, XRAN_PCAPNG_IDB);            p += 4;
+    xran_pcap_put32(p, len);                        p += 4;
+    xran_pcap_put16(p, XRAN_PCAP_LINKTYPE_ETH);     p += 2;
+    xran_pcap_put16(p, 0);                          p += 2;
+    xran_pcap_put32(p, snapLen);                    p += 4;
+
+    xran_pcap_put16(p, XRAN_PCAPNG_OPT_IF_NAME);    p += 2;
+    xran_pcap_put16(p, (uint16_t)nameLen);          p += 2;
+    memset(p, 0, namePad);
+    memcpy(p, pName, nameLen);                      p += namePad;
+
+    xran_pcap_put16(p, XRAN_PCAPNG_OPT_IF_TSRESOL); p += 2;
+    xran_pcap_put16(p, 1);                          p += 2;
+    memset(p, 0, 4);
+    p[0] = 9;                                       p += 4;    /* 10^-9 s, padded */
+
+    xran_pcap_put32(p, XRAN_PCAPNG_OPT_END);        p += 4;
+    xran_pcap_put32(p, len);
+
+    return len;
+}
+
+/**
+ * @brief PCAP-NG enhanced packet block
+ *
+ * @param pOut at least XRAN_PCAPNG_EPB_LEN bytes plus the data padded to 4
+ * @param ifId interface of the packet
+ * @param ts timestamp in nanoseconds
+ * @param pData packet
+ * @param capLen bytes of packet captured
+ * @param origLen length of the packet on the wire
+ * @param dir XRAN_PCAP_DIR_RX or XRAN_PCAP_DIR_TX
+ * @return block length
+ */
+static inline uint32_t xran_pcapng_epb(uint8_t *pOut, uint32_t ifId, uint64_t ts,
+                const uint8_t *pData, uint32_t capLen, uint32_t origLen, uint8_t dir)
+{
+    const uint32_t dataPad = xran_pcap_align(capLen, 4);
+    const uint32_t len     = XRAN_PCAPNG_EPB_LEN + dataPad;
+    uint8_t *p = pOut;
+
+    xran_pcap_put32(p, XRAN_PCAPNG_EPB);            p += 4;
+    xran_pcap_put32(p, len);                        p += 4;
+    xran_pcap_put32(p, ifId);                       p += 4;
+    xran_pcap_put32(p, (uint32_t)(ts >> 32));       p += 4;
+    xran_pcap_put32(p, (uint32_t)ts);               p += 4;
+    xran_pcap_put32(p, capLen);                     p += 4;
+    xran_pcap_put32(p, origLen);                    p += 4;
+    memcpy(p, pData, capLen);
+    memset(p + capLen, 0, dataPad - capLen);        p += dataPad;
+
+    xran_pcap_put16(p, XRAN_PCAPNG_OPT_EPB_FLAGS);  p += 2;
+    xran_pcap_put16(p, 4);                          p += 2;
+    xran_pcap_put32(p, dir);                        p += 4;
+    xran_pcap_put32(p, XRAN_PCAPNG_OPT_END);        p += 4;
+    xran_pcap_put32(p, len);
+
+    return len;
+}
+
+/**
+ * @brief Start reading a capture held in memory
+ *
+ * Only captures written in the byte order of the host are read.
+ *
+ * @param pReader reader
+ * @param pBuf content of the file
+ * @param len file length
+ * @return 0 on success, -1 if the file is not a capture this reader handles
+ */
+static inline int32_t xran_pcap_reader_init(struct xran_pcap_reader *pReader, const uint8_t *pBuf, uint64_t len)
+{
+    uint32_t magic;
+
+    memset(pReader, 0, sizeof(*pReader));
+    pReader->pBuf = pBuf;
+    pReader->len  = len;
+
+    if(len < XRAN_PCAP_HDR_LEN)
+        return -1;
+
+    magic = xran_pcap_get32(pBuf);
+    if(magic == XRAN_PCAPNG_SHB)
+    {
+        if(xran_pcap_get32(pBuf + 8) != XRAN_PCAPNG_BOM)
+            return -1;
+        pReader->isNg = 1;
+        return 0;
+    }
+
+    if(magic == XRAN_PCAP_MAGIC_US || magic == XRAN_PCAP_MAGIC_NS)
+    {
+        if(xran_pcap_get32(pBuf + 20) != XRAN_PCAP_LINKTYPE_ETH)
+            return -1;
+        pReader->tsMul = (magic == XRAN_PCAP_MAGIC_US) ? 1000 : 1;
+        pReader->off   = XRAN_PCAP_HDR_LEN;
+        return 0;
+    }
+
+    return -1;
+}
+
+/** if_tsresol to nanoseconds, base 10 or base 2 */
+static inline uint64_t xran_pcap_ts_to_ns(uint64_t ts, uint8_t resol)
+{
+    static const uint64_t pow10[] = { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+                                      1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL };
+    const uint8_t exp = resol & 0x7F;
+
+    if(resol & 0x80)
+        return (uint64_t)(((unsigned __int128)ts * 1000000000ULL) >> exp);
+    if(exp <= 9)
+        return ts * pow10[9 - exp];
+    if(exp <= 18)
+        return ts / pow10[exp - 9];
+
+    return 0;
+}
+
+/**
+ * @brief Next packet of a capture
+ *
+ * Blocks other than packets are skipped. A new section header forgets the
+ * interfaces of the previous section.
+ *
+ * @param pReader reader
+ * @param pPkt packet, valid as long as the file is
+ * @return 1 for a packet, 0 at the end of the file, -1 on a truncated or corrupted file
+ */
+static inline int32_t xran_pcap_reader_next(struct xran_pcap_reader *pReader, struct xran_pcap_pkt *pPkt)
+{
+    const uint8_t *p;
+    uint64_t left;
+    uint32_t type, len;
+
+    if(!pReader->isNg)
+    {
+        left = pReader->len - pReader->off;
+        if(left == 0)
+            return 0;
+        if(left < XRAN_PCAP_REC_HDR_LEN)
+            return -1;
+
+        p = pReader->pBuf + pReader->off;
+        memset(pPkt, 0, sizeof(*pPkt));
+        pPkt->ts      = (uint64_t)xran_pcap_get32(p) * 1000000000ULL + (uint64_t)xran_pcap_get32(p + 4) * pReader->tsMul;
+        pPkt->capLen  = xran_pcap_get32(p + 8);
+        pPkt->origLen = xran_pcap_get32(p + 12);
+        if(pPkt->capLen > left - XRAN_PCAP_REC_HDR_LEN)
+            return -1;
+        pPkt->pData   = p + XRAN_PCAP_REC_HDR_LEN;
+        pReader->off += XRAN_PCAP_REC_HDR_LEN + pPkt->capLen;
+        return 1;
+    }
+
+    while((left = pReader->len - pReader->off) != 0)
+    {
+        if(left < 12)
+            return -1;
+
+        p    = pReader->pBuf + pReader->off;
+        type = xran_pcap_get32(p);
+        len  = xran_pcap_get32(p + 4);
+        if(len < 12 || (len & 3) || len > left || xran_pcap_get32(p + len - 4) != len)
+            return -1;
+        pReader->off += len;
+
+        if(type == XRAN_PCAPNG_SHB)
+        {
+            if(xran_pcap_get32(p + 8) != XRAN_PCAPNG_BOM)
+                return -1;
+            pReader->numIf = 0;
+        }
+        else if(type == XRAN_PCAPNG_IDB)
+        {
+            const uint8_t *pOpt = p + 16;
+            uint8_t resol = 6;      /* microseconds unless told otherwise */
+
+            if(len < 20)
+                return -1;
+            if(xran_pcap_get16(p + 8) != XRAN_PCAP_LINKTYPE_ETH)
+                return -1;
+
+            while(pOpt + 4 <= p + len - 4)
+            {
+                const uint16_t code   = xran_pcap_get16(pOpt);
+                const uint16_t optLen = xran_pcap_get16(pOpt + 2);
+
+                if(code == XRAN_PCAPNG_OPT_END || pOpt + 4 + optLen > p + len - 4)
+                    break;
+                if(code == XRAN_PCAPNG_OPT_IF_TSRESOL && optLen >= 1)
+                    resol = pOpt[4];
+                pOpt += 4 + xran_pcap_align(optLen, 4);
+            }
+
+            if(pReader->numIf < XRAN_PCAP_MAX_IF)
+                pReader->ifTsResol[pReader->numIf] = resol;
+            pReader->numIf++;
+        }
+        else if(type == XRAN_PCAPNG_EPB)
+        {
+            const uint8_t *pOpt;
+            uint64_t ts;
+
+            if(len < 32)
+                return -1;
+
+            memset(pPkt, 0, sizeof(*pPkt));
+            pPkt->ifId    = xran_pcap_get32(p + 8);
+            ts            = ((uint64_t)xran_pcap_get32(p + 12) << 32) | xran_pcap_get32(p + 16);
+            pPkt->capLen  = xran_pcap_get32(p + 20);
+            pPkt->origLen = xran_pcap_get32(p + 24);
+            pPkt->pData   = p + 28;
+            if(pPkt->ifId >= pReader->numIf || pPkt->ifId >= XRAN_PCAP_MAX_IF
+                || xran_pcap_align(pPkt->capLen, 4) > len - 32)
+                return -1;
+            pPkt->ts = xran_pcap_ts_to_ns(ts, pReader->ifTsResol[pPkt->ifId]);
+
+            pOpt = p + 28 + xran_pcap_align(pPkt->capLen, 4);
+            while(pOpt + 4 <= p + len - 4)
+            {
+                const uint16_t code   = xran_pcap_get16(pOpt);
+                const uint16_t optLen = xran_pcap_get16(pOpt + 2);
+
+                if(code == XRAN_PCAPNG_OPT_END || pOpt + 4 + optLen > p + len - 4)
+                    break;
+                if(code == XRAN_PCAPNG_OPT_EPB_FLAGS && optLen == 4)
+                    pPkt->dir = (uint8_t)(xran_pcap_get32(pOpt + 4) & 0x3);
+                pOpt += 4 + xran_pcap_align(optLen, 4);
+            }
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+struct rte_mbuf;
+
+int32_t xran_pcap_tap(uint16_t vf, uint8_t dir, struct rte_mbuf *pkts[], uint16_t num);
+int32_t xran_pcap_tap_worker(uint16_t vf, struct rte_mbuf *pkts[], uint16_t num);
+
+/** capture directions enabled, read by the IO cores once per burst */
+extern volatile uint32_t xran_pcap_flags;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _XRAN_PCAP_H_ */
@@ -897,4 +897,107 @@ namespace BlockFloatCompander
     return _mm256_and_epi64(compDataCombined, k_expMask);
   }
 
+
+  /// Byte index used to reverse the first numBytes bytes of each 128b lane.
+  /// Bytes beyond numBytes are zeroed (shuffle index MSB set).
+  constexpr char
+  laneByteReverseIdx(const int byteIdx, const int numBytes)
+  {
+    return (char)((byteIdx < numBytes) ? (numBytes - 1 - byteIdx) : 0x80);
+  }
+
+
+  /// Shuffle mask which reverses the first numBytes bytes of each 128b lane
+  template<int numBytes>
+  inline __m512i
+  laneByteReverseMask()
+  {
+    return _mm512_broadcast_i32x4(_mm_setr_epi8(laneByteReverseIdx(0, numBytes), laneByteReverseIdx(1, numBytes),
+                                                laneByteReverseIdx(2, numBytes), laneByteReverseIdx(3, numBytes),
+                                                laneByteReverseIdx(4, numBytes), laneByteReverseIdx(5, numBytes),
+                                                laneByteReverseIdx(6, numBytes), laneByteReverseIdx(7, numBytes),
+                                                laneByteReverseIdx(8, numBytes), laneByteReverseIdx(9, numBytes),
+                                                laneByteReverseIdx(10, numBytes), laneByteReverseIdx(11, numBytes),
+                                                laneByteReverseIdx(12, numBytes), laneByteReverseIdx(13, numBytes),
+                                                laneByteReverseIdx(14, numBytes), laneByteReverseIdx(15, numBytes)));
+  }
+
+
+  /// Pack compressed data of any width (1 to 16 bits) in network byte order.
+  /// Each 128b lane holds 8 samples, which pack into exactly iqWidth bytes, so
+  /// the samples are merged pairwise (16b -> 32b -> 64b -> 128b) with the first
+  /// sample in the most significant bits, and each lane is then byte reversed.
+  /// The packed bytes for lane n are in the lowest iqWidth bytes of that lane,
+  /// matching the layout produced by the fixed width packing functions.
+  template<int iqWidth>
+  inline __m512i
+  networkBytePackNb(const __m512i compData)
+  {
+    /// Remove sign extension bits
+    const auto dataMasked = _mm512_and_si512(compData, _mm512_set1_epi16((int16_t)((1 << iqWidth) - 1)));
+
+    /// Merge pairs of samples: (s0 << iqWidth) | s1 in each 32b element
+    const auto k_lowWordMask = _mm512_set1_epi32(0x0000FFFF);
+    const auto pack32 = _mm512_or_si512(_mm512_slli_epi32(_mm512_and_si512(dataMasked, k_lowWordMask), iqWidth),
+                                        _mm512_srli_epi32(dataMasked, 16));
+
+    /// Merge pairs of 32b elements: (d0 << 2*iqWidth) | d1 in each 64b element
+    const auto k_lowDwordMask = _mm512_set1_epi64(0x00000000FFFFFFFF);
+    const auto pack64 = _mm512_or_si512(_mm512_slli_epi64(_mm512_and_si512(pack32, k_lowDwordMask), 2 * iqWidth),
+                                        _mm512_srli_epi64(pack32, 32));
+
+    /// Merge pairs of 64b elements into 128b: (q0 << 4*iqWidth) | q1
+    /// Lower 64b = (q0 << 4*iqWidth) | q1, upper 64b = q0 >> (64 - 4*iqWidth)
+    const auto pack64Swap = _mm512_shuffle_epi32(pack64, (_MM_PERM_ENUM)0x4E);
+    const auto packLo = _mm512_or_si512(_mm512_slli_epi64(pack64, 4 * iqWidth), pack64Swap);
+    const auto packHi = _mm512_srli_epi64(pack64Swap, 64 - (4 * iqWidth));
+    constexpr __mmask8 k_hiQwordMask = 0xAA;
+    const auto pack128 = _mm512_mask_blend_epi64(k_hiQwordMask, packLo, packHi);
+
+    /// Reverse bytes to get network byte order
+    return _mm512_shuffle_epi8(pack128, laneByteReverseMask<iqWidth>());
+  }
+
+
+  /// Unpack compressed data of any width (1 to 16 bits) in network byte order.
+  /// Inverse of networkBytePackNb. Each lane is loaded with a masked load of
+  /// iqWidth bytes so that no data beyond the end of the RB is read.
+  /// Output samples are left aligned (sign bit at bit 15), as for the fixed
+  /// width unpacking functions.
+  template<int iqWidth>
+  inline __m512i
+  networkByteUnpackNb(const uint8_t* inData)
+  {
+    /// Load iqWidth bytes (8 samples) into each lane
+    constexpr __mmask16 k_laneLoadMask = (__mmask16)((1 << iqWidth) - 1);
+    auto inLaneAlign = _mm512_castsi128_si512(_mm_maskz_loadu_epi8(k_laneLoadMask, inData));
+    inLaneAlign = _mm512_inserti32x4(inLaneAlign, _mm_maskz_loadu_epi8(k_laneLoadMask, inData + iqWidth), 1);
+    inLaneAlign = _mm512_inserti32x4(inLaneAlign, _mm_maskz_loadu_epi8(k_laneLoadMask, inData + (2 * iqWidth)), 2);
+
+    /// Reverse bytes so that each lane holds one 8*iqWidth bit value
+    const auto unpack128 = _mm512_shuffle_epi8(inLaneAlign, laneByteReverseMask<iqWidth>());
+
+    /// Split 128b into two 64b elements: q0 = value >> 4*iqWidth, q1 = value & mask
+    const auto unpack128Swap = _mm512_shuffle_epi32(unpack128, (_MM_PERM_ENUM)0x4E);
+    const auto k_mask64 = _mm512_set1_epi64((4 * iqWidth == 64) ? -1LL : (long long)((1ULL << (4 * iqWidth)) - 1));
+    const auto unpackLo = _mm512_or_si512(_mm512_srli_epi64(unpack128, 4 * iqWidth),
+                                          _mm512_slli_epi64(unpack128Swap, 64 - (4 * iqWidth)));
+    const auto unpackHi = _mm512_and_si512(unpack128Swap, k_mask64);
+    constexpr __mmask8 k_hiQwordMask = 0xAA;
+    const auto unpack64 = _mm512_mask_blend_epi64(k_hiQwordMask, unpackLo, unpackHi);
+
+    /// Split 64b into two 32b elements
+    const auto k_mask32 = _mm512_set1_epi64((2 * iqWidth == 32) ? 0xFFFFFFFFLL : (long long)((1ULL << (2 * iqWidth)) - 1));
+    const auto unpack32 = _mm512_or_si512(_mm512_srli_epi64(unpack64, 2 * iqWidth),
+                                          _mm512_slli_epi64(_mm512_and_si512(unpack64, k_mask32), 32));
+
+    /// Split 32b into two 16b elements
+    const auto k_mask16 = _mm512_set1_epi32((1 << iqWidth) - 1);
+    const auto unpack16 = _mm512_or_si512(_mm512_srli_epi32(unpack32, iqWidth),
+                                          _mm512_slli_epi32(_mm512_and_si512(unpack32, k_mask16), 16));
+
+    /// Logical shift left to set sign bit
+    return _mm512_slli_epi16(unpack16, 16 - iqWidth);
+  }
+
 }
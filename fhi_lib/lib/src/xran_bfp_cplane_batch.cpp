@@ -0,0 +1,201 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief xRAN BFP compression for C-plane beamforming weights, batch of beams
+ *        with any number of antennas
+ *
+ * @file xran_bfp_cplane_batch.cpp
+ * @ingroup group_source_xran
+ * @author Intel Corporation
+ **/
+
+#include "xran_compression.hpp"
+#include "xran_bfp_utils.hpp"
+#include "xran_bfp_byte_packing_utils.hpp"
+#include <algorithm>
+#include <immintrin.h>
+
+
+namespace BFP_CPlane_Batch
+{
+  /// Namespace constants
+  const int k_numSampsPerReg = 32;  /// 16 IQ pairs per register
+  const int k_beamIdSize = 2;       /// beamId field between bfwCompParam and the weights
+
+
+  /// Zeroing load mask for one 32 x 16b register
+  inline __mmask32
+  regLoadMask(const int numValsRemaining)
+  {
+    if (numValsRemaining >= k_numSampsPerReg)
+      return 0xFFFFFFFF;
+    return (__mmask32)((1u << numValsRemaining) - 1);
+  }
+
+
+  /// Byte permute joining the iqWidth packed bytes of each 128b lane into
+  /// 4 * iqWidth contiguous bytes at the start of the register
+  template<int iqWidth>
+  inline __m512i
+  laneJoinPermute()
+  {
+    CACHE_ALIGNED int8_t idx[64];
+    for (int j = 0; j < 64; ++j)
+      idx[j] = (j < 4 * iqWidth) ? (int8_t)((j / iqWidth) * 16 + (j % iqWidth)) : 0;
+    return _mm512_load_si512((const void*)idx);
+  }
+
+
+  /// Exponent of one set of BFWs. abs(-32768) saturates to 32767 as in the
+  /// reference implementation. The leading bit of the OR of all abs values
+  /// is the leading bit of the max abs value.
+  inline uint8_t
+  computeExponent(const int16_t* dataIn, const int numDataElements, const int iqWidth)
+  {
+    const auto k_maxPos = _mm512_set1_epi16(0x7FFF);
+    auto orAbs = _mm512_setzero_si512();
+    for (int n = 0; n < numDataElements; n += k_numSampsPerReg)
+    {
+      const auto rawData = _mm512_maskz_loadu_epi16(regLoadMask(numDataElements - n), dataIn + n);
+      orAbs = _mm512_or_si512(orAbs, _mm512_min_epu16(_mm512_abs_epi16(rawData), k_maxPos));
+    }
+    const uint32_t orAbs32 = (uint32_t)_mm512_reduce_or_epi32(orAbs);
+    const uint32_t orAbs16 = (orAbs32 | (orAbs32 >> 16)) & 0xFFFF;
+    return (uint8_t)std::max(0, (33 - iqWidth) - (int)_lzcnt_u32(orAbs16));
+  }
+
+
+  /// Compress one set of BFWs into [exponent][beamId][packed weights]
+  template<int iqWidth>
+  inline void
+  compressOneBeam(const int16_t* dataIn, const uint16_t beamId, uint8_t* dataOut,
+                  const int numDataElements, const __m512i joinPermute)
+  {
+    const uint8_t thisExp = computeExponent(dataIn, numDataElements, iqWidth);
+    dataOut[0] = thisExp;
+    dataOut[1] = (uint8_t)((beamId >> 8) & 0x7F);
+    dataOut[2] = (uint8_t)(beamId & 0xFF);
+
+    uint8_t* bfwOut = dataOut + 1 + k_beamIdSize;
+    constexpr __mmask64 k_regStoreMask = (4 * iqWidth == 64) ? ~(__mmask64)0 : (((__mmask64)1 << (4 * iqWidth)) - 1);
+    int n = 0;
+    for (; n + k_numSampsPerReg <= numDataElements; n += k_numSampsPerReg)
+    {
+      /// Apply the exponent shift and pack 8 samples per lane into iqWidth bytes
+      const auto compData = _mm512_srai_epi16(_mm512_loadu_si512((const void*)(dataIn + n)), thisExp);
+      const auto compDataBytePacked = BlockFloatCompander::networkBytePackNb<iqWidth>(compData);
+      /// Join the lanes and write 4 * iqWidth bytes
+      _mm512_mask_storeu_epi8(bfwOut, k_regStoreMask, _mm512_permutexvar_epi8(joinPermute, compDataBytePacked));
+      bfwOut += 4 * iqWidth;
+    }
+    if (n < numDataElements)
+    {
+      /// Last partial register, zero padded up to the end of the last byte
+      const int numSamps = numDataElements - n;
+      const int numBytes = (numSamps * iqWidth + 7) >> 3;
+      const auto compData = _mm512_srai_epi16(_mm512_maskz_loadu_epi16(regLoadMask(numSamps), dataIn + n), thisExp);
+      const auto compDataBytePacked = BlockFloatCompander::networkBytePackNb<iqWidth>(compData);
+      _mm512_mask_storeu_epi8(bfwOut, ((__mmask64)1 << numBytes) - 1,
+                              _mm512_permutexvar_epi8(joinPermute, compDataBytePacked));
+    }
+  }
+
+
+  /// Compress all sets of BFWs of the batch back to back
+  template<int iqWidth>
+  void
+  compressBatch(const int16_t* const* dataIn, const uint16_t* beamId, const int numBeams,
+                const int numDataElements, uint8_t* dataOut)
+  {
+    const auto joinPermute = laneJoinPermute<iqWidth>();
+    const int totNumBytesPerBeam = 1 + k_beamIdSize + ((numDataElements * iqWidth + 7) >> 3);
+    for (int b = 0; b < numBeams; ++b)
+    {
+      /// Bring the next set of weights in while this one is compressed
+      if (b + 1 < numBeams)
+        _mm_prefetch((const char*)dataIn[b + 1], _MM_HINT_T0);
+      compressOneBeam<iqWidth>(dataIn[b], beamId[b], dataOut + b * totNumBytesPerBeam,
+                               numDataElements, joinPermute);
+    }
+  }
+}
+
+
+/// Compress a batch of BFW sets for any number of antennas and iqWidth 1 to 16.
+/// Each set is written as [exponent][beamId][BFWs], as expected by section extension 11.
+int
+BlockFloatCompander::BFPCompressCtrlPlaneBatchAvx512(const int16_t* const* dataIn, const uint16_t* beamId,
+                                                     int numBeams, int numDataElements, int iqWidth,
+                                                     uint8_t* dataOut)
+{
+  switch (iqWidth)
+  {
+  case 1:
+    BFP_CPlane_Batch::compressBatch<1>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 2:
+    BFP_CPlane_Batch::compressBatch<2>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 3:
+    BFP_CPlane_Batch::compressBatch<3>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 4:
+    BFP_CPlane_Batch::compressBatch<4>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 5:
+    BFP_CPlane_Batch::compressBatch<5>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 6:
+    BFP_CPlane_Batch::compressBatch<6>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 7:
+    BFP_CPlane_Batch::compressBatch<7>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 8:
+    BFP_CPlane_Batch::compressBatch<8>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 9:
+    BFP_CPlane_Batch::compressBatch<9>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 10:
+    BFP_CPlane_Batch::compressBatch<10>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 11:
+    BFP_CPlane_Batch::compressBatch<11>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 12:
+    BFP_CPlane_Batch::compressBatch<12>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 13:
+    BFP_CPlane_Batch::compressBatch<13>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 14:
+    BFP_CPlane_Batch::compressBatch<14>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 15:
+    BFP_CPlane_Batch::compressBatch<15>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  case 16:
+    BFP_CPlane_Batch::compressBatch<16>(dataIn, beamId, numBeams, numDataElements, dataOut);
+    break;
+  default:
+    return -1;
+  }
+  return numBeams * (1 + BFP_CPlane_Batch::k_beamIdSize + ((numDataElements * iqWidth + 7) >> 3));
+}
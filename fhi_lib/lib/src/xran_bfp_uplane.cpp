@@ -30,6 +30,7 @@
 #include <complex>
 #include <algorithm>
 #include <immintrin.h>
+#include <cstring>
 
 
 namespace BFP_UPlane
@@ -353,6 +354,174 @@ namespace BFP_UPlane
       break;
     }
   }
+
+
+  /// Zeroing load mask for one 32 x 16b register, given the number of valid
+  /// values remaining from the start of that register.
+  inline __mmask32
+  tailLoadMask(const int numValsRemaining)
+  {
+    if (numValsRemaining >= 32)
+      return 0xFFFFFFFF;
+    if (numValsRemaining <= 0)
+      return 0;
+    return (__mmask32)((1u << numValsRemaining) - 1);
+  }
+
+
+  /// Compute exponent values for any number of RB from 1 to 16.
+  /// Registers are loaded with zeroing tail masks so that no data beyond the
+  /// last RB is read, and zeroed values do not change the max abs result.
+  /// The exponent for RB n is packed in 32b element n of the result, as for
+  /// computeExponent_16RB.
+  __m512i
+  computeExponent_NRB(const int16_t* dataIn, const int numRB, const __m512i totShiftBits)
+  {
+    __m512i maxAbs = __m512i();
+    const int numVals = numRB * k_numREReal;
+    const int numGroups = (numRB + 3) >> 2;
+    /// Max Abs loop operates on 4RB at a time
+    for (int n = 0; n < numGroups; ++n)
+    {
+      const int regIdx = 3 * n;
+      const auto rawDataA = _mm512_maskz_loadu_epi16(tailLoadMask(numVals - (regIdx + 0) * 32), dataIn + (regIdx + 0) * 32);
+      const auto rawDataB = _mm512_maskz_loadu_epi16(tailLoadMask(numVals - (regIdx + 1) * 32), dataIn + (regIdx + 1) * 32);
+      const auto rawDataC = _mm512_maskz_loadu_epi16(tailLoadMask(numVals - (regIdx + 2) * 32), dataIn + (regIdx + 2) * 32);
+      /// Re-order and vertical max abs
+      auto maxAbsVert = BlockFloatCompander::maxAbsVertical4RB(rawDataA, rawDataB, rawDataC);
+      /// Horizontal max abs
+      auto maxAbsHorz = BlockFloatCompander::horizontalMax4x16(maxAbsVert);
+      /// Pack these 4 values into maxAbs
+      maxAbs = BlockFloatCompander::slidePermute(maxAbsHorz, maxAbs, n);
+    }
+    /// Calculate exponent
+    const auto maxAbs32 = BlockFloatCompander::maskUpperWord(maxAbs);
+    return BlockFloatCompander::expLzCnt(maxAbs32, totShiftBits);
+  }
+
+
+  /// Apply compression to 1 RB using a masked load, so the last RB of a
+  /// buffer never reads beyond the end of the input
+  template<BlockFloatCompander::PackFunction networkBytePack>
+  inline void
+  applyCompressionWideN_1RB(const int16_t* dataIn, uint8_t* dataOut, const uint8_t thisExp,
+                            const int iqWidth, const uint16_t rbWriteMask)
+  {
+    constexpr __mmask32 k_rbLoadMask = 0x00FFFFFF; // 1RB (24 values)
+    /// Apply the exponent shift
+    const auto compData = _mm512_srai_epi16(_mm512_maskz_loadu_epi16(k_rbLoadMask, dataIn), thisExp);
+    /// Pack compressed data network byte order
+    const auto compDataBytePacked = networkBytePack(compData);
+    /// Store exponent first
+    dataOut[0] = thisExp;
+    /// Now have 1 RB worth of bytes separated into 3 chunks (1 per lane)
+    /// Use three offset stores to join
+    _mm_mask_storeu_epi8(dataOut + 1, rbWriteMask, _mm512_extracti64x2_epi64(compDataBytePacked, 0));
+    _mm_mask_storeu_epi8(dataOut + 1 + iqWidth, rbWriteMask, _mm512_extracti64x2_epi64(compDataBytePacked, 1));
+    _mm_mask_storeu_epi8(dataOut + 1 + (2 * iqWidth), rbWriteMask, _mm512_extracti64x2_epi64(compDataBytePacked, 2));
+  }
+
+
+  /// Apply 8 bit compression to 1 RB using a masked load
+  inline void
+  applyCompressionWide8_1RB(const int16_t* dataIn, uint8_t* dataOut, const uint8_t thisExp)
+  {
+    constexpr __mmask32 k_rbMask = 0x00FFFFFF; // 1RB (24 values)
+    /// Apply the exponent shift
+    const auto compData = _mm512_srai_epi16(_mm512_maskz_loadu_epi16(k_rbMask, dataIn), thisExp);
+    /// Store exponent first
+    dataOut[0] = thisExp;
+    _mm256_mask_storeu_epi8(dataOut + 1, k_rbMask, _mm512_cvtepi16_epi8(compData));
+  }
+
+
+  /// Compress any number of RB in one pass for iqWidth != 8.
+  /// Exponents are computed 16 RB at a time, with tail masks for the final
+  /// group, so there is no 16/4/1 RB dispatch.
+  template<BlockFloatCompander::PackFunction networkBytePack>
+  void
+  compressWideN(const BlockFloatCompander::ExpandedData& dataIn, BlockFloatCompander::CompressedData* dataOut,
+                const __m512i totShiftBits, const int totNumBytesPerRB, const uint16_t rbWriteMask)
+  {
+    for (int rbBase = 0; rbBase < dataIn.numBlocks; rbBase += BlockFloatCompander::k_maxNumBlocks)
+    {
+      const int numRB = std::min(BlockFloatCompander::k_maxNumBlocks, dataIn.numBlocks - rbBase);
+      const int16_t* rbIn = dataIn.dataExpanded + rbBase * k_numREReal;
+      uint8_t* rbOut = dataOut->dataCompressed + rbBase * totNumBytesPerRB;
+      const auto exponents = computeExponent_NRB(rbIn, numRB, totShiftBits);
+      for (int n = 0; n < numRB; ++n)
+      {
+        applyCompressionWideN_1RB<networkBytePack>(rbIn + n * k_numREReal, rbOut + n * totNumBytesPerRB,
+                                                   ((uint8_t*)&exponents)[n * 4], dataIn.iqWidth, rbWriteMask);
+      }
+    }
+  }
+
+
+  /// Compress any number of RB in one pass for 8 bit iqWidth
+  void
+  compressWide8(const BlockFloatCompander::ExpandedData& dataIn, BlockFloatCompander::CompressedData* dataOut,
+                const __m512i totShiftBits)
+  {
+    for (int rbBase = 0; rbBase < dataIn.numBlocks; rbBase += BlockFloatCompander::k_maxNumBlocks)
+    {
+      const int numRB = std::min(BlockFloatCompander::k_maxNumBlocks, dataIn.numBlocks - rbBase);
+      const int16_t* rbIn = dataIn.dataExpanded + rbBase * k_numREReal;
+      uint8_t* rbOut = dataOut->dataCompressed + rbBase * (k_numREReal + 1);
+      const auto exponents = computeExponent_NRB(rbIn, numRB, totShiftBits);
+      for (int n = 0; n < numRB; ++n)
+      {
+        applyCompressionWide8_1RB(rbIn + n * k_numREReal, rbOut + n * (k_numREReal + 1), ((uint8_t*)&exponents)[n * 4]);
+      }
+    }
+  }
+
+
+  /// Expand any number of RB in one pass for iqWidth != 8.
+  /// The fixed width unpacking functions load a full 64B register, so the last
+  /// RB(s) of the buffer are copied to a local buffer first to avoid reading
+  /// beyond the end of the compressed input.
+  template<BlockFloatCompander::UnpackFunction networkByteUnpack>
+  void
+  expandWideN(const BlockFloatCompander::CompressedData& dataIn, BlockFloatCompander::ExpandedData* dataOut,
+              const int totNumBytesPerRB, const int maxExpShift)
+  {
+    static constexpr uint32_t k_WriteMask = 0x00FFFFFF;
+    const int totNumBytes = dataIn.numBlocks * totNumBytesPerRB;
+    const int numSafeRB = (totNumBytes > (int)sizeof(__m512i)) ? ((totNumBytes - (int)sizeof(__m512i) - 1) / totNumBytesPerRB + 1) : 0;
+    CACHE_ALIGNED uint8_t tailData[2 * sizeof(__m512i)];
+
+    for (int n = 0; n < dataIn.numBlocks; ++n)
+    {
+      const uint8_t* rbIn = dataIn.dataCompressed + n * totNumBytesPerRB;
+      if (n >= numSafeRB)
+      {
+        memcpy(tailData, rbIn, totNumBytesPerRB);
+        rbIn = tailData;
+      }
+      /// Unpack network order packed data
+      const auto dataUnpacked = networkByteUnpack(rbIn + 1);
+      /// Apply exponent scaling (by appropriate arithmetic shift right)
+      const auto dataExpanded = _mm512_srai_epi16(dataUnpacked, maxExpShift - rbIn[0]);
+      /// Write expanded data to output
+      _mm512_mask_storeu_epi16(dataOut->dataExpanded + n * k_numREReal, k_WriteMask, dataExpanded);
+    }
+  }
+
+
+  /// Expand any number of RB in one pass for 8 bit iqWidth
+  void
+  expandWide8(const BlockFloatCompander::CompressedData& dataIn, BlockFloatCompander::ExpandedData* dataOut)
+  {
+    constexpr __mmask32 k_rbMask = 0x00FFFFFF; // 1RB (24 values)
+    for (int n = 0; n < dataIn.numBlocks; ++n)
+    {
+      const uint8_t* rbIn = dataIn.dataCompressed + n * (k_numREReal + 1);
+      const auto compData16 = _mm512_cvtepi8_epi16(_mm256_maskz_loadu_epi8(k_rbMask, rbIn + 1));
+      const auto expData = _mm512_slli_epi16(compData16, rbIn[0]);
+      _mm512_mask_storeu_epi16(dataOut->dataExpanded + n * k_numREReal, k_rbMask, expData);
+    }
+  }
 }
 
 
@@ -431,4 +600,167 @@ BlockFloatCompander::BFPExpandUserPlaneAvx512(const CompressedData& dataIn, Expa
     BFP_UPlane::expandByAllocN<BlockFloatCompander::networkByteUnpack12b>(dataIn, dataOut, k_totNumBytesPerRB12, k_maxExpShift12);
     break;
   }
-}
\ No newline at end of file
+}
+
+
+
+/// Main kernel function for compression of any number of RB.
+/// Supports every iqWidth from 1 to 16. Widths with a dedicated byte packing
+/// function use it, all others use the generic networkBytePackNb.
+void
+BlockFloatCompander::BFPCompressUserPlaneAvx512Wide(const ExpandedData& dataIn, CompressedData* dataOut)
+{
+  /// Compensation for extra zeros in 32b leading zero count when computing exponent
+  const auto totShiftBits = _mm512_set1_epi32(33 - dataIn.iqWidth);
+
+  /// Total number of compressed bytes per RB
+  const int totNumBytesPerRB = (3 * dataIn.iqWidth) + 1;
+
+  /// Compressed data write mask
+  const uint16_t rbWriteMask = (uint16_t)((1 << dataIn.iqWidth) - 1);
+
+  switch (dataIn.iqWidth)
+  {
+  case 1:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<1>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 2:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<2>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 3:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<3>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 4:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<4>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 5:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<5>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 6:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<6>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 7:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<7>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 8:
+    BFP_UPlane::compressWide8(dataIn, dataOut, totShiftBits);
+    break;
+
+  case 9:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePack9b>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 10:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePack10b>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 11:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<11>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 12:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePack12b>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 13:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<13>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 14:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<14>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 15:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<15>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+
+  case 16:
+    BFP_UPlane::compressWideN<BlockFloatCompander::networkBytePackNb<16>>(dataIn, dataOut, totShiftBits, totNumBytesPerRB, rbWriteMask);
+    break;
+  }
+}
+
+
+
+/// Main kernel function for expansion of any number of RB.
+/// Supports every iqWidth from 1 to 16.
+void
+BlockFloatCompander::BFPExpandUserPlaneAvx512Wide(const CompressedData& dataIn, ExpandedData* dataOut)
+{
+  const int totNumBytesPerRB = (3 * dataIn.iqWidth) + 1;
+  const int maxExpShift = 16 - dataIn.iqWidth;
+
+  switch (dataIn.iqWidth)
+  {
+  case 1:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<1>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 2:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<2>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 3:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<3>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 4:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<4>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 5:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<5>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 6:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<6>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 7:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<7>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 8:
+    BFP_UPlane::expandWide8(dataIn, dataOut);
+    break;
+
+  case 9:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpack9b>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 10:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpack10b>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 11:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<11>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 12:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpack12b>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 13:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<13>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 14:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<14>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 15:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<15>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+
+  case 16:
+    BFP_UPlane::expandWideN<BlockFloatCompander::networkByteUnpackNb<16>>(dataIn, dataOut, totNumBytesPerRB, maxExpShift);
+    break;
+  }
+}
@@ -551,6 +551,54 @@ int32_t xran_timing_destroy_cbs(void *args)
     return XRAN_STATUS_SUCCESS;
 }
 
+/* remove the callbacks of xran_timing_create_cbs(), keep the ones of xran_reg_sym_cb() */
+static void xran_remove_timing_cb_list(struct sym_cb_elem_list* list_head)
+{
+    struct cb_elem_entry *cb_elm, *cb_elm_next;
+
+    for(cb_elm = LIST_FIRST(list_head); cb_elm != NULL; cb_elm = cb_elm_next)
+    {
+        cb_elm_next = LIST_NEXT(cb_elm, pointers);
+        if(cb_elm->pSymCallback == xran_timer_arm_user_cb)
+            continue;
+
+        LIST_REMOVE(cb_elm, pointers);
+        xran_destroy_cb(cb_elm);
+    }
+}
+
+/**
+ * @brief Re-create the timing callbacks of a port from its current windows
+ *
+ * Called by the timing thread at the start of a slot, between two symbol
+ * callbacks, when the one-way delay controller moved the windows. The
+ * C-plane callbacks target a slot rather than a symbol, so the slot they
+ * trigger in is sent once. Callbacks of xran_reg_sym_cb() keep the offsets
+ * they were registered with.
+ *
+ * @param args device context
+ * @return XRAN_STATUS_SUCCESS, XRAN_STATUS_FAIL if a callback cannot be created
+ */
+int32_t xran_timing_update_cbs(void *args)
+{
+    struct xran_device_ctx * p_dev_ctx = (struct xran_device_ctx *)args;
+    uint8_t mu;
+
+    /* the windows moved are the ones of the O-DU */
+    if(xran_get_syscfg_appmode() != O_DU)
+        return XRAN_STATUS_SUCCESS;
+
+    for(int32_t i = 0; i < p_dev_ctx->fh_cfg.numMUs; i++)
+    {
+        mu = p_dev_ctx->fh_cfg.mu_number[i];
+        for(int32_t j = 0; j < XRAN_NUM_OF_SYMBOL_PER_SLOT; j++)
+            xran_remove_timing_cb_list(&p_dev_ctx->perMu[mu].sym_cb_list_head[j]);
+        memset(p_dev_ctx->perMu[mu].deadline_slot_advance, 0, sizeof(p_dev_ctx->perMu[mu].deadline_slot_advance));
+    }
+
+    return xran_timing_create_cbs(args);
+}
+
 static int32_t
 xran_reg_sym_cb_ota(struct xran_device_ctx * p_dev_ctx, xran_callback_sym_fn symCb, void * symCbParam, struct xran_sense_of_time* symCbTime,  uint8_t symb,
     struct cb_user_per_sym_ctx **p_sym_cb_ctx, uint8_t mu)
@@ -838,6 +886,41 @@ int32_t xran_reg_sym_cb(void *pHandle, xran_callback_sym_fn symCb, void * symCbP
     return ret;
 }
 
+int32_t xran_reg_ul_done_cb(void *pHandle, xran_ul_done_callback_fn Cb, void *cbParam,
+        enum xran_ul_done_cb_mode mode, uint8_t mu)
+{
+    struct xran_device_ctx * p_dev_ctx = NULL;
+    xran_device_per_mu_fields *pMu;
+
+    if(xran_get_if_state() == XRAN_RUNNING) {
+        print_err("Cannot register callback while running!!");
+        return (-1);
+    }
+
+    if(pHandle) {
+        p_dev_ctx = (struct xran_device_ctx *)pHandle;
+    } else {
+        print_err("pHandle==NULL");
+        return XRAN_STATUS_INVALID_PARAM;
+    }
+    if(mu == XRAN_DEFAULT_MU)
+        mu = p_dev_ctx->fh_cfg.mu_number[0];
+
+    if(mu >= XRAN_MAX_NUM_MU || mode >= XRAN_UL_DONE_CB_MAX || (mode != XRAN_UL_DONE_CB_OFF && Cb == NULL)) {
+        print_err("Invalid early UL completion callback: mu %u mode %d Cb %p", mu, mode, Cb);
+        return XRAN_STATUS_INVALID_PARAM;
+    }
+
+    pMu = &p_dev_ctx->perMu[mu];
+    pMu->ulDoneCbMode  = XRAN_UL_DONE_CB_OFF;
+    memset(pMu->ulDone, 0, sizeof(pMu->ulDone));
+    pMu->ulDoneCb      = Cb;
+    pMu->ulDoneCbParam = cbParam;
+    pMu->ulDoneCbMode  = (uint8_t)mode;
+
+    return XRAN_STATUS_SUCCESS;
+}
+
 int32_t xran_reg_physide_oam_cb(void *pHandle, xran_callback_oam_notify_fn Cb)
 {
     struct xran_system_config *p_syscfg = xran_get_systemcfg();
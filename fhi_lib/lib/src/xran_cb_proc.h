@@ -36,6 +36,7 @@ extern "C" {
 int32_t xran_timing_create_cbs(void *args);
 #ifndef POLL_EBBU_OFFLOAD
 int32_t xran_timing_destroy_cbs(void *args);
+int32_t xran_timing_update_cbs(void *args);
 #else
 /* This is duplicated 5GNR task definition from L1 application and it must be aligned with L1 application side */
 typedef enum
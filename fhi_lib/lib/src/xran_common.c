@@ -192,8 +192,8 @@ int32_t xran_validate_sectionId(void *arg, uint16_t mu)
     {
         if(likely(p_dev_ctx->fh_cfg.numMUs == 1))
         {
-            ++p_dev_ctx->fh_counters.rx_err_up;
-            ++p_dev_ctx->fh_counters.rx_err_drop;
+            ++xran_fh_counters(p_dev_ctx)->rx_err_up;
+            ++xran_fh_counters(p_dev_ctx)->rx_err_drop;
             print_dbg("Invalid SectionID - numerology mapping for mu = %d",mu);
             return XRAN_STATUS_FAIL;
         }
@@ -207,8 +207,8 @@ int32_t xran_validate_sectionId(void *arg, uint16_t mu)
             }
             if(muIdx == p_dev_ctx->fh_cfg.numMUs)
             {
-                ++p_dev_ctx->fh_counters.rx_err_up;
-                ++p_dev_ctx->fh_counters.rx_err_drop;
+                ++xran_fh_counters(p_dev_ctx)->rx_err_up;
+                ++xran_fh_counters(p_dev_ctx)->rx_err_drop;
                 print_dbg("Invalid SectionID - numerology mapping for mu = %d",mu);
                 return XRAN_STATUS_FAIL;
             }
@@ -262,7 +262,7 @@ uint32_t pktFrameId, uint32_t pktSfId, uint32_t pktSlotId)
                    tti, otaTti,otaSymId, xran_lib_ota_sym_idx_mu[mu]);
             print_dbg("otaSymIdx=%d, symIdxDeadlineMax=%d, ttiPkt=%u, symPkt=%u, otaTti=%u",
                 otaSymIdx, symIdxDeadlineMax, tti, symId, otaTti);
-            ++p_dev_ctx->fh_counters.Rx_late;
+            ++xran_fh_counters(p_dev_ctx)->Rx_late;
             return -1;
         }
         else if(otaSymIdx < symIdxDeadlineMin){
@@ -272,7 +272,7 @@ uint32_t pktFrameId, uint32_t pktSfId, uint32_t pktSlotId)
                    tti, otaTti,otaSymId, xran_lib_ota_sym_idx_mu[mu]);
             print_dbg("otaSymIdx=%d, symIdxDeadlineMin=%d, ttiPkt=%u, symPkt=%u, otaTti=%u",
                 otaSymIdx, symIdxDeadlineMin, tti, symId, otaTti);
-            ++p_dev_ctx->fh_counters.Rx_early;
+            ++xran_fh_counters(p_dev_ctx)->Rx_early;
             return -1;
         }
     }
@@ -290,17 +290,17 @@ uint32_t pktFrameId, uint32_t pktSfId, uint32_t pktSlotId)
         {
             print_dbg("Rx RU: pktTti=%d, otaTti=%d, symIdxDeadlineMax=%d, otaSymIdx=%d, pktSym=%d, otaSym=%d \n", 
                 tti, otaTti, symIdxDeadlineMax, otaSymIdx, symId, xran_lib_ota_sym_idx_mu[mu] % XRAN_NUM_OF_SYMBOL_PER_SLOT);
-            ++p_dev_ctx->fh_counters.Rx_late;
+            ++xran_fh_counters(p_dev_ctx)->Rx_late;
             return -1;
         }
         else if(otaSymIdx > symIdxDeadlineMin){
             print_dbg("Rx RU: pktTti=%d, otaTti=%d, otaSymIdx=%d, symIdxDeadlineMin=%d, pktSym=%d, otaSym=%d \n", 
                 tti, otaTti, otaSymIdx, symIdxDeadlineMin, symId, xran_lib_ota_sym_idx_mu[mu] % XRAN_NUM_OF_SYMBOL_PER_SLOT);
-            ++p_dev_ctx->fh_counters.Rx_early;
+            ++xran_fh_counters(p_dev_ctx)->Rx_early;
             return -1;
         }
     }
-    ++p_dev_ctx->fh_counters.Rx_on_time;
+    ++xran_fh_counters(p_dev_ctx)->Rx_on_time;
     return 0;
 }
 
@@ -319,8 +319,8 @@ int32_t xran_validate_numprbs(uint8_t mu, uint16_t start_prbu, uint16_t num_prbs
 
     if(unlikely( (start_prbu >= max_prbs) || (start_prbu + num_prbs > max_prbs) ))
     {
-        ++p_dev_ctx->fh_counters.rx_err_up;
-        ++p_dev_ctx->fh_counters.rx_err_drop;
+        ++xran_fh_counters(p_dev_ctx)->rx_err_up;
+        ++xran_fh_counters(p_dev_ctx)->rx_err_drop;
         return XRAN_STATUS_FAIL;
     }
 
@@ -334,9 +334,9 @@ int32_t xran_validate_numprbs_prach(uint8_t mu, uint16_t start_prbu, uint16_t nu
     numPrbc =  p_dev_ctx->perMu[mu].PrachCPConfig.numPrbc;
     if(unlikely(start_prbu + num_prbs > numPrbc))
     {
-        ++p_dev_ctx->fh_counters.rx_err_up;
-        ++p_dev_ctx->fh_counters.rx_err_drop;
-        ++p_dev_ctx->fh_counters.rx_err_prach;
+        ++xran_fh_counters(p_dev_ctx)->rx_err_up;
+        ++xran_fh_counters(p_dev_ctx)->rx_err_drop;
+        ++xran_fh_counters(p_dev_ctx)->rx_err_prach;
         return XRAN_STATUS_FAIL;
     }
 
@@ -350,8 +350,8 @@ int32_t xran_validate_numprbs_prach_lte(uint8_t mu, uint16_t start_prbu, uint16_
     numPrbc =  p_dev_ctx->perMu[mu].PrachCPConfig.numPrbc;
     if(unlikely(num_prbs != numPrbc))
     {
-        ++p_dev_ctx->fh_counters.rx_err_up;
-        ++p_dev_ctx->fh_counters.rx_err_drop;
+        ++xran_fh_counters(p_dev_ctx)->rx_err_up;
+        ++xran_fh_counters(p_dev_ctx)->rx_err_drop;
         return XRAN_STATUS_FAIL;
     }
 
@@ -376,7 +376,7 @@ int process_mbuf_batch(struct rte_mbuf* pkt_q[], void* handle, int16_t num, stru
 
     uint16_t interval_us_local = 0;
 
-    struct xran_common_counters* pCnt = &p_dev_ctx->fh_counters;
+    struct xran_common_counters* pCnt = xran_fh_counters(p_dev_ctx);
 
     uint8_t CC_ID[MBUFS_CNT] = { 0 };
     uint8_t Ant_ID[MBUFS_CNT] = { 0 };
@@ -397,7 +397,6 @@ int process_mbuf_batch(struct rte_mbuf* pkt_q[], void* handle, int16_t num, stru
     uint8_t mu[MBUFS_CNT] = {0};   /*TODOMIXED: logic to derive mu and identify NBIOT based on eAxCID*/
     uint8_t compMeth_ini = 0;
     uint8_t iqWidth_ini = 0;
-    static uint32_t firstprint = 0;
 
     uint32_t pkt_size[MBUFS_CNT];
 
@@ -621,7 +620,7 @@ int process_mbuf_batch(struct rte_mbuf* pkt_q[], void* handle, int16_t num, stru
             /* Not checking timing constraints for SRS as NDM SRS spreads the transmission of packets. Marking them as on_time */
             if (xran_get_syscfg_appmode() == O_DU && p_dev_ctx->fh_cfg.srsEnable && Ant_ID[i] >= p_dev_ctx->srs_cfg.srsEaxcOffset
                 && (Ant_ID[i]< (p_dev_ctx->srs_cfg.srsEaxcOffset + xran_get_num_ant_elm(p_dev_ctx)))){
-                    ++p_dev_ctx->fh_counters.Rx_on_time;
+                    ++xran_fh_counters(p_dev_ctx)->Rx_on_time;
             }
             else if (unlikely(-1 == xran_rx_timing_window_check(p_dev_ctx, tti, symb_id[i], mu[i], frame_id[i], subframe_id[i], slot_id[i]))
                 && p_dev_ctx->fh_cfg.dropPacketsUp)
@@ -848,9 +847,13 @@ int process_mbuf_batch(struct rte_mbuf* pkt_q[], void* handle, int16_t num, stru
         ret_data[i] = MBUF_FREE;
         if (likely(pRbMap) && likely(p_dev_ctx->fh_cfg.ru_conf.byteOrder == XRAN_NE_BE_BYTE_ORDER))
         {
-            struct xran_rx_packet_ctl *pFrontHaulRxPacketCtrl = &pRbMap->sFrontHaulRxPacketCtrl[symb_id[i]];
+            struct xran_rx_packet_ctl *pFrontHaulRxPacketCtrl = xran_rx_pkt_ctl(&p_dev_ctx->rx_pkt_arena, pRbMap,
+                                            XRAN_RX_PKT_PUSCH, mu[i], tti % XRAN_N_FE_BUF_LEN, CC_ID[i], Ant_ID[i], symb_id[i]);
 
             do {
+                if (unlikely(pFrontHaulRxPacketCtrl == NULL))
+                    break;
+
                 nSectionContinue = 0;
                 nSectionLen = (((iqWidth[i] == 0) ? 16 : iqWidth[i])*3 + ((compMeth[i] != XRAN_COMPMETHOD_NONE) ? 1 : 0))*num_prbu[i];
                 if (num_bytes[i] < nSectionLen)
@@ -874,25 +877,19 @@ int process_mbuf_batch(struct rte_mbuf* pkt_q[], void* handle, int16_t num, stru
                     break;
                 }
 
-                int32_t npkts = pFrontHaulRxPacketCtrl->nRxPkt;
-                if (unlikely(npkts >= XRAN_MAX_RX_PKT_PER_SYM))
+                if (unlikely(xran_rx_pkt_store(pFrontHaulRxPacketCtrl, start_prbu[i], num_prbu[i], sect_id[i], iq_samp_buf[i],
+                                               (0 == nSectionIdx) ? pkt_q[i] : NULL, (void **)&mb,
+                                               xran_fh_counters(p_dev_ctx)) != XRAN_STATUS_SUCCESS))
                 {
-                    if (firstprint == 0) print_err("batch:(%d : %d : %d : %d)Received %d type-1 packets on symbol %u\n", frame_id[i], subframe_id[i], subframe_id[i], Ant_ID[i], npkts, symb_id[i]);
-                    firstprint = 1;
+                    print_dbg("batch:(%d : %d : %d : %d)Received %d type-1 packets on symbol %u\n", frame_id[i], subframe_id[i], slot_id[i], Ant_ID[i], pFrontHaulRxPacketCtrl->nRxPkt, symb_id[i]);
                     break;
                 }
                 else
-                {                
-                    mb = pFrontHaulRxPacketCtrl->pCtrl[npkts];
+                {
                     if(mb){
                         rte_pktmbuf_free(mb);
                     }
-                    pFrontHaulRxPacketCtrl->nRBStart[npkts] = start_prbu[i];
-                    pFrontHaulRxPacketCtrl->nRBSize[npkts] = num_prbu[i];
-                    pFrontHaulRxPacketCtrl->nSectid[npkts] = sect_id[i];
-                    pFrontHaulRxPacketCtrl->pData[npkts] = iq_samp_buf[i];
-                    pFrontHaulRxPacketCtrl->pCtrl[npkts] = (0 == nSectionIdx) ? pkt_q[i] : NULL;
-                    pFrontHaulRxPacketCtrl->nRxPkt = npkts + 1;
+                    xran_ul_done_on_rx(p_dev_ctx, mu[i], tti, CC_ID[i], symb_id[i], num_prbu[i]);
 
                     if (0 == nSectionIdx) ret_data[i] = MBUF_KEEP;
  
@@ -945,7 +942,7 @@ int32_t process_mbuf(struct rte_mbuf *pkt, void* handle, struct xran_eaxc_info *
     void *iq_samp_buf;
     union ecpri_seq_id seq;
     int num_bytes = 0;
-    struct xran_common_counters *pCnt = &p_dev_ctx->fh_counters;
+    struct xran_common_counters *pCnt = xran_fh_counters(p_dev_ctx);
     struct xran_system_config *sysCfg = xran_get_systemcfg();
     uint16_t interval_us_local = 0;
     uint8_t mu=0;
@@ -1026,7 +1023,7 @@ int32_t process_mbuf(struct rte_mbuf *pkt, void* handle, struct xran_eaxc_info *
     /* Not checking timing constraints for SRS as NDM SRS spreads the transmission of packets. Marking them as on_time */
     if (xran_get_syscfg_appmode() == O_DU && p_dev_ctx->fh_cfg.srsEnable && Ant_ID >= p_dev_ctx->srs_cfg.srsEaxcOffset
         && (Ant_ID < p_dev_ctx->srs_cfg.srsEaxcOffset + xran_get_num_ant_elm(p_dev_ctx))){
-            ++p_dev_ctx->fh_counters.Rx_on_time;
+            ++xran_fh_counters(p_dev_ctx)->Rx_on_time;
     }
     else if (unlikely(-1 == xran_rx_timing_window_check(p_dev_ctx, tti, symb_id, mu, frame_id, subframe_id, slot_id))
             && p_dev_ctx->fh_cfg.dropPacketsUp)
@@ -1072,9 +1069,9 @@ int32_t process_mbuf(struct rte_mbuf *pkt, void* handle, struct xran_eaxc_info *
                     ret = mb_free;
                 else
                 {
-                    ++p_dev_ctx->fh_counters.rx_err_csirs;
-                    ++p_dev_ctx->fh_counters.rx_err_up;
-                    ++p_dev_ctx->fh_counters.rx_err_drop;
+                    ++xran_fh_counters(p_dev_ctx)->rx_err_csirs;
+                    ++xran_fh_counters(p_dev_ctx)->rx_err_up;
+                    ++xran_fh_counters(p_dev_ctx)->rx_err_drop;
                     print_dbg("res != symbol_total_bytes[p_dev_ctx->xran_port_id][CC_ID][Ant_ID][seq.bits.seq_id]\n");
                 }
                 ++pCnt->rx_csirs_packets;
@@ -1113,9 +1110,9 @@ int32_t process_mbuf(struct rte_mbuf *pkt, void* handle, struct xran_eaxc_info *
                 if(likely(res == symbol_total_bytes[p_dev_ctx->xran_port_id][CC_ID][Ant_ID][seq.bits.seq_id]))
                     ret = mb_free;
                 else{
-                    ++p_dev_ctx->fh_counters.rx_err_srs;
-                    ++p_dev_ctx->fh_counters.rx_err_up;
-                    ++p_dev_ctx->fh_counters.rx_err_drop;
+                    ++xran_fh_counters(p_dev_ctx)->rx_err_srs;
+                    ++xran_fh_counters(p_dev_ctx)->rx_err_up;
+                    ++xran_fh_counters(p_dev_ctx)->rx_err_drop;
                     print_dbg("res != symbol_total_bytes[p_dev_ctx->xran_port_id][CC_ID][Ant_ID][seq.bits.seq_id]\n");
                 }
                 ++pCnt->rx_srs_packets;
@@ -1177,9 +1174,9 @@ int32_t process_mbuf(struct rte_mbuf *pkt, void* handle, struct xran_eaxc_info *
                         ret = mb_free;
                     else
                     {
-                        ++p_dev_ctx->fh_counters.rx_err_prach;
-                        ++p_dev_ctx->fh_counters.rx_err_up;
-                        ++p_dev_ctx->fh_counters.rx_err_drop;
+                        ++xran_fh_counters(p_dev_ctx)->rx_err_prach;
+                        ++xran_fh_counters(p_dev_ctx)->rx_err_up;
+                        ++xran_fh_counters(p_dev_ctx)->rx_err_drop;
                         print_err("res (%d) != num_bytes (%d)\n",res, num_bytes);
                     }
                     ++pCnt->rx_prach_packets[Ant_ID];
@@ -1218,9 +1215,9 @@ int32_t process_mbuf(struct rte_mbuf *pkt, void* handle, struct xran_eaxc_info *
                             nSectionLen = (((iqWidth == 0) ? 16 : iqWidth)*3 + ((compMeth != XRAN_COMPMETHOD_NONE) ? 1 : 0))*num_prbu;
                             if(nSectionLen > num_bytes)
                             {
-                                ++p_dev_ctx->fh_counters.rx_err_pusch;
-                                ++p_dev_ctx->fh_counters.rx_err_up;
-                                ++p_dev_ctx->fh_counters.rx_err_drop;
+                                ++xran_fh_counters(p_dev_ctx)->rx_err_pusch;
+                                ++xran_fh_counters(p_dev_ctx)->rx_err_up;
+                                ++xran_fh_counters(p_dev_ctx)->rx_err_drop;
                                 print_dbg("revByteNum > symbol_total_bytes[p_dev_ctx->xran_port_id][CC_ID][Ant_ID][seq.bits.seq_id]\n");
                                 break;
                             }
@@ -1646,7 +1643,7 @@ int send_symbol_mult_section_ex(void *handle,
     int32_t sent=0;
     uint32_t loop = 0;
     struct xran_device_ctx *p_dev_ctx = (struct xran_device_ctx *)handle;
-    struct xran_common_counters *pCnt = &p_dev_ctx->fh_counters;
+    struct xran_common_counters *pCnt = xran_fh_counters(p_dev_ctx);
     enum xran_comp_hdr_type staticEn= XRAN_COMP_HDR_TYPE_DYNAMIC;
     struct xran_ethdi_ctx* eth_ctx = xran_ethdi_get_ctx();
     struct rte_ring *ring = (struct rte_ring *)pRing;
@@ -1774,7 +1771,7 @@ int send_symbol_ex(void *handle,
     int hdr_len, parm_size;
     int32_t sent=0;
     struct xran_device_ctx *p_dev_ctx = (struct xran_device_ctx *)handle;
-    struct xran_common_counters *pCnt = &p_dev_ctx->fh_counters;
+    struct xran_common_counters *pCnt = xran_fh_counters(p_dev_ctx);
     enum xran_comp_hdr_type staticEn= XRAN_COMP_HDR_TYPE_DYNAMIC;
     struct xran_ethdi_ctx* eth_ctx = xran_ethdi_get_ctx();
     struct rte_ring *ring = (struct rte_ring *)pRing;
@@ -1890,7 +1887,7 @@ int send_cpmsg(void *pHandle, struct rte_mbuf *mbuf,struct xran_cp_gen_params *p
     int ret = 0; //, nsection;
     uint8_t dir = params->dir;
     struct xran_device_ctx *p_dev_ctx =(struct xran_device_ctx *) pHandle;
-    struct xran_common_counters *pCnt = &p_dev_ctx->fh_counters;
+    struct xran_common_counters *pCnt = xran_fh_counters(p_dev_ctx);
 
     /* add in the ethernet header */
     struct rte_ether_hdr *const h = (void *)rte_pktmbuf_prepend(mbuf, sizeof(*h));
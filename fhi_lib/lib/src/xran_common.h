@@ -44,6 +44,7 @@ extern "C" {
 #include "xran_fh_o_du.h"
 #include "xran_pkt_up.h"
 #include "xran_cp_api.h"
+#include "xran_sectiondb.h"
 #include "xran_dev.h"
 #include "xran_pkt.h"
 
@@ -64,9 +65,6 @@ extern uint64_t interval_us;
 #define PRACH_PLAYBACK_BUFFER_BYTES (840*4L)
 #define PRACH_SRS_BUFFER_BYTES (144*14*4L)
 
-/**<  this is the configuration of M-plane */
-#define XRAN_MAX_NUM_SECTIONS       (32) //(N_SYM_PER_SLOT* (XRAN_MAX_ANTENNA_NR*2) + XRAN_MAX_ANT_ARRAY_ELM_NR)
-
 #define XRAN_MAX_MBUF_LEN (13168 + XRAN_MAX_SECTIONS_PER_SYM* (RTE_PKTMBUF_HEADROOM + sizeof(struct rte_ether_hdr) + sizeof(struct xran_ecpri_hdr) + sizeof(struct radio_app_common_hdr) + sizeof(struct data_section_hdr)))
 #define NSEC_PER_SEC 1000000000L
 #define XRAN_RING_SIZE  512 /*4*14*8 pow of 2 */
@@ -127,11 +125,6 @@ struct xran_worker_info_s {
     int32_t State;
 };
 
-struct xran_sectioninfo_db {
-    uint32_t    cur_index;  /**< Current index to store for this eAXC */
-    struct xran_section_info list[XRAN_MAX_NUM_SECTIONS]; /**< The array of section information */
-};
-
 int32_t xran_generic_worker_thread(void *args);
 int32_t xran_validate_sectionId(void *arg, uint16_t mu);
 int process_mbuf(struct rte_mbuf *pkt, void* handle, struct xran_eaxc_info *p_cid);
@@ -258,6 +251,9 @@ uint8_t xran_get_seqid(void *pHandle, uint8_t dir, uint8_t cc_id, uint8_t ant_id
 int32_t ring_processing_func(void* arg);
 int32_t ring_processing_func2(void* arg);
 int xran_init_prach(struct xran_fh_config* pConf, struct xran_device_ctx * p_xran_dev_ctx, enum xran_ran_tech xran_tech, uint8_t mu);
+int32_t xran_dev_is_prach_slot(struct xran_device_ctx *pDevCtx, uint32_t sfId, uint32_t slotId, uint8_t mu);
+int32_t xran_init_occasions(struct xran_device_ctx * pDevCtx);
+void xran_free_occasions(struct xran_device_ctx * pDevCtx);
 #ifndef POLL_EBBU_OFFLOAD
 void xran_updateSfnSecStart(void);
 #endif
@@ -198,6 +198,30 @@ xranlib_compress_bfw(const struct xranlib_compress_request *request,
     }
 }
 
+int32_t
+xranlib_compress_bfw_batch(const struct xranlib_compress_bfw_batch_request *request,
+                        struct xranlib_compress_response *response)
+{
+    int len;
+
+    if (request->compMethod != XRAN_COMPMETHOD_BLKFLOAT) {
+        printf("Unsupported compMethod %d\n", request->compMethod);
+        return XRAN_STATUS_FAIL;
+    }
+
+    /* one kernel for both ISAs, it only needs AVX512BW */
+    len = BlockFloatCompander::BFPCompressCtrlPlaneBatchAvx512((const int16_t* const*)request->data_in,
+                    request->beamId, request->numBeams, request->numDataElements, request->iqWidth,
+                    (uint8_t*)response->data_out);
+    if (len < 0) {
+        printf("Unsupported iqWidth %d\n", request->iqWidth);
+        return XRAN_STATUS_FAIL;
+    }
+
+    response->len = len;
+    return XRAN_STATUS_SUCCESS;
+}
+
 int32_t
 xranlib_decompress_bfw(const struct xranlib_decompress_request *request,
     struct xranlib_decompress_response *response)
@@ -216,51 +240,22 @@ xranlib_compress_avx512(const struct xranlib_compress_request *request,
     BlockFloatCompander::ExpandedData expandedDataInput;
     BlockFloatCompander::CompressedData compressedDataOut;
     xran_bfp_compress_fn com_fn = NULL;
-    uint16_t totalRBs = request->numRBs;
-    uint16_t remRBs   = totalRBs;
-    int16_t len = 0;
-    int16_t block_idx_bytes = 0;
 
-    switch (request->iqWidth) {
-        case 8:
-        case 9:
-        case 10:
-        case 12:
-            com_fn = BlockFloatCompander::BFPCompressUserPlaneAvx512;
-            break;
-        default:
-            com_fn = BlockFloatCompander::BFPCompressRef;
-            break;
-    }
+    /* wide kernel handles any number of RBs in one call using tail masks */
+    if (request->iqWidth >= 1 && request->iqWidth <= 16)
+        com_fn = BlockFloatCompander::BFPCompressUserPlaneAvx512Wide;
+    else
+        com_fn = BlockFloatCompander::BFPCompressRef;
 
-    expandedDataInput.iqWidth = request->iqWidth;
-    expandedDataInput.numDataElements =  24;
+    expandedDataInput.iqWidth         = request->iqWidth;
+    expandedDataInput.numDataElements = 24;
+    expandedDataInput.numBlocks       = request->numRBs;
+    expandedDataInput.dataExpanded    = request->data_in;
+    compressedDataOut.dataCompressed  = (uint8_t*)response->data_out;
 
-    while (remRBs){
-        expandedDataInput.dataExpanded   = &request->data_in[block_idx_bytes];
-        compressedDataOut.dataCompressed = (uint8_t*)&response->data_out[len];
-        if(remRBs >= 16){
-            expandedDataInput.numBlocks = 16;
-            com_fn(expandedDataInput, &compressedDataOut);
-            len  += ((3 * expandedDataInput.iqWidth) + 1) * std::min((int16_t)BlockFloatCompander::k_maxNumBlocks,(int16_t)16);
-            block_idx_bytes += 16*expandedDataInput.numDataElements;
-            remRBs -= 16;
-        }else if(remRBs >= 4){
-            expandedDataInput.numBlocks = 4;
-            com_fn(expandedDataInput, &compressedDataOut);
-            len  += ((3 * expandedDataInput.iqWidth) + 1) * std::min((int16_t)BlockFloatCompander::k_maxNumBlocks,(int16_t)4);
-            block_idx_bytes +=4*expandedDataInput.numDataElements;
-            remRBs -=4;
-        }else if (remRBs >= 1){
-            expandedDataInput.numBlocks = 1;
-            com_fn(expandedDataInput, &compressedDataOut);
-            len  += ((3 * expandedDataInput.iqWidth) + 1) * std::min((int16_t)BlockFloatCompander::k_maxNumBlocks,(int16_t)1);
-            block_idx_bytes +=1*expandedDataInput.numDataElements;
-            remRBs = remRBs - 1;
-        }
-    }
+    com_fn(expandedDataInput, &compressedDataOut);
 
-    response->len =  ((3 * expandedDataInput.iqWidth) + 1) * totalRBs;
+    response->len =  ((3 * expandedDataInput.iqWidth) + 1) * request->numRBs;
 
     return XRAN_STATUS_SUCCESS;
 }
@@ -271,53 +266,23 @@ xranlib_decompress_avx512(const struct xranlib_decompress_request *request,
 {
     BlockFloatCompander::CompressedData compressedDataInput;
     BlockFloatCompander::ExpandedData expandedDataOut;
-
     xran_bfp_decompress_fn decom_fn = NULL;
-    uint16_t totalRBs = request->numRBs;
-    uint16_t remRBs   = totalRBs;
-    int16_t len = 0;
-    int16_t block_idx_bytes = 0;
 
-    switch (request->iqWidth) {
-    case 8:
-    case 9:
-    case 10:
-    case 12:
-        decom_fn = BlockFloatCompander::BFPExpandUserPlaneAvx512;
-        break;
-    default:
+    /* wide kernel handles any number of RBs in one call using tail masks */
+    if (request->iqWidth >= 1 && request->iqWidth <= 16)
+        decom_fn = BlockFloatCompander::BFPExpandUserPlaneAvx512Wide;
+    else
         decom_fn = BlockFloatCompander::BFPExpandRef;
-        break;
-    }
 
-    compressedDataInput.iqWidth         =  request->iqWidth;
-    compressedDataInput.numDataElements =  24;
+    compressedDataInput.iqWidth         = request->iqWidth;
+    compressedDataInput.numDataElements = 24;
+    compressedDataInput.numBlocks       = request->numRBs;
+    compressedDataInput.dataCompressed  = (uint8_t*)request->data_in;
+    expandedDataOut.dataExpanded        = response->data_out;
 
-    while(remRBs) {
-        compressedDataInput.dataCompressed = (uint8_t*)&request->data_in[block_idx_bytes];
-        expandedDataOut.dataExpanded       = &response->data_out[len];
-        if(remRBs >= 16){
-            compressedDataInput.numBlocks = 16;
-            decom_fn(compressedDataInput, &expandedDataOut);
-            len  += 16*compressedDataInput.numDataElements;
-            block_idx_bytes  += ((3 * compressedDataInput.iqWidth) + 1) * std::min((int16_t)BlockFloatCompander::k_maxNumBlocks,(int16_t)16);
-            remRBs -= 16;
-        }else if(remRBs >= 4){
-            compressedDataInput.numBlocks = 4;
-            decom_fn(compressedDataInput, &expandedDataOut);
-            len  += 4*compressedDataInput.numDataElements;
-            block_idx_bytes  += ((3 * compressedDataInput.iqWidth) + 1) * std::min((int16_t)BlockFloatCompander::k_maxNumBlocks,(int16_t)4);
-            remRBs -=4;
-        }else if (remRBs >= 1){
-            compressedDataInput.numBlocks = 1;
-            decom_fn(compressedDataInput, &expandedDataOut);
-            len  += 1*compressedDataInput.numDataElements;
-            block_idx_bytes  += ((3 * compressedDataInput.iqWidth) + 1) * std::min((int16_t)BlockFloatCompander::k_maxNumBlocks,(int16_t)1);
-            remRBs = remRBs - 1;
-        }
-    }
+    decom_fn(compressedDataInput, &expandedDataOut);
 
-    response->len = totalRBs * compressedDataInput.numDataElements * sizeof(int16_t);
+    response->len = request->numRBs * compressedDataInput.numDataElements * sizeof(int16_t);
 
     return 0;
 }
@@ -65,36 +65,12 @@ static float nPrach_SubCarrierSpacing[XRAN_MAX_NUM_PRACH_MU] =
    1.25     // PrachMu = 4
 };
 
-xran_status_t xran_alloc_sectioninfo_db(int mu, int32_t nCC, int32_t nAnt, PSECTION_DB_TYPE p_sec_db){
-
-    int32_t ctx, dir, cc, ant;
-    struct xran_sectioninfo_db* p_sec_db_elm = NULL;
-
-    for (ctx = 0; ctx < XRAN_MAX_SECTIONDB_CTX; ctx++) {
-        for (dir = 0; dir < XRAN_DIR_MAX; dir++){
-            for (cc = 0; cc < nCC && cc < XRAN_COMPONENT_CARRIERS_MAX; cc++){
-                for (ant = 0; ant < nAnt && ant < (XRAN_MAX_ANTENNA_NR*2 + XRAN_MAX_ANT_ARRAY_ELM_NR); ant++) {
-                     p_sec_db_elm = (struct xran_sectioninfo_db*)xran_zmalloc(NULL,sizeof(struct xran_sectioninfo_db), 0);
-
-                     if(unlikely(p_sec_db_elm == NULL)){
-                        print_err("Failed to allocate memory CP section DB: ctx %d dir %d cc %d ant %d",ctx, dir, cc, ant);
-                        return XRAN_STATUS_RESOURCE;
-                     }
-                     else{
-                        p_sec_db_elm->cur_index = 0;
-                        p_sec_db->p_sectiondb_elm[ctx][dir][cc][ant] = p_sec_db_elm;
-                     }
-                } // ant
-            } // cc
-        } // dir
-    } //ctx
-
-    return XRAN_STATUS_SUCCESS;
-}
 /**
  * @brief Initialize section database.
  *   Allocate required memory space to store section information.
- *   Each eAxC allocates dedicated storage and the entry size is the maximum number of sections.
+ *   The databases of all numerologies of the port share a single allocation,
+ *   each eAxC has a dedicated entry at a computed offset and the entry size is
+ *   the maximum number of sections.
  *   Total entry size : number of CC * number of antenna * max number of sections * 2(direction)
  *
  * @ingroup xran_cp_pkt
@@ -110,8 +86,12 @@ xran_cp_init_sectiondb(void *pHandle)
 {
     struct xran_device_ctx* p_dev = NULL;
     uint8_t xran_port_id = 0;
-    PSECTION_DB_TYPE p_sec_db =  NULL;
-    xran_status_t ret;
+    uint32_t nAnt;
+    uint64_t size = 0;
+    uint8_t *pArena, *pMem;
+    uint8_t mu;
+    int i;
+
     if(pHandle) {
         p_dev = (struct xran_device_ctx* )pHandle;
         xran_port_id = p_dev->xran_port_id;
@@ -120,24 +100,32 @@ xran_cp_init_sectiondb(void *pHandle)
         return (XRAN_STATUS_FAIL);
     }
 
-    for(int i=0; i<p_dev->fh_cfg.numMUs;i++)
+    nAnt = p_dev->fh_cfg.neAxc*4 + p_dev->fh_cfg.nAntElmTRx;
+
+    for(i=0; i<p_dev->fh_cfg.numMUs;i++)
     {
-        if (p_sectiondb[xran_port_id][p_dev->fh_cfg.mu_number[i]] == NULL){
-            p_sec_db = xran_zmalloc(NULL,sizeof(SECTION_DB_TYPE), 0);
-            if(p_sec_db){
-                p_sectiondb[xran_port_id][p_dev->fh_cfg.mu_number[i]] = p_sec_db;
-                print_dbg("xran_port_id %d %p\n",xran_port_id,  p_sectiondb[xran_port_id][p_dev->fh_cfg.mu_number[i]]);
+        if (p_sectiondb[xran_port_id][p_dev->fh_cfg.mu_number[i]] == NULL)
+            size += xran_sectiondb_size(p_dev->fh_cfg.nCC, nAnt);
+    }
+    if(size == 0)
+        return (XRAN_STATUS_SUCCESS);
 
-                ret = xran_alloc_sectioninfo_db(i, p_dev->fh_cfg.nCC, p_dev->fh_cfg.neAxc*4 + p_dev->fh_cfg.nAntElmTRx, p_sec_db);
+    pArena = xran_zmalloc(NULL, size, XRAN_SECTIONDB_ALIGN);
+    if(pArena == NULL) {
+        print_err("Memory Allocation Failed [port %d sz %ld]\n", xran_port_id, size);
+        return (XRAN_STATUS_RESOURCE);
+    }
 
-                if(ret != XRAN_STATUS_SUCCESS){
-                    print_err("Memory Allocation Failed [port %d sz %ld]\n", xran_port_id, sizeof(struct xran_sectioninfo_db));
-                    return XRAN_STATUS_FAIL;
-                }
-            } else {
-                print_err("Memory Allocation Failed [port %d sz %ld]\n", xran_port_id, sizeof(SECTION_DB_TYPE));
-                return (XRAN_STATUS_RESOURCE);
-            }
+    pMem = pArena;
+    for(i=0; i<p_dev->fh_cfg.numMUs;i++)
+    {
+        mu = p_dev->fh_cfg.mu_number[i];
+        if (p_sectiondb[xran_port_id][mu] == NULL){
+            /* the first numerology releases the arena */
+            p_sectiondb[xran_port_id][mu] = xran_sectiondb_layout(pMem, p_dev->fh_cfg.nCC, nAnt,
+                                                                 (pMem == pArena) ? pArena : NULL);
+            pMem += xran_sectiondb_size(p_dev->fh_cfg.nCC, nAnt);
+            print_dbg("xran_port_id %d %p\n",xran_port_id,  p_sectiondb[xran_port_id][mu]);
         }
     }
 
@@ -151,8 +139,9 @@ xran_cp_init_vMu_sectiondb(void *pHandle, uint8_t vMu, int32_t nAnt)
 {
     struct xran_device_ctx* p_dev = NULL;
     uint8_t xran_port_id = 0;
-    PSECTION_DB_TYPE p_sec_db =  NULL;
-    xran_status_t ret;
+    uint64_t size;
+    void *pArena;
+
     if(pHandle) {
         p_dev = (struct xran_device_ctx* )pHandle;
         xran_port_id = p_dev->xran_port_id;
@@ -162,19 +151,13 @@ xran_cp_init_vMu_sectiondb(void *pHandle, uint8_t vMu, int32_t nAnt)
     }
 
     if (p_sectiondb[xran_port_id][vMu] == NULL){
-        p_sec_db = xran_zmalloc(NULL,sizeof(SECTION_DB_TYPE), 0);
-        if(p_sec_db){
-            p_sectiondb[xran_port_id][vMu] = p_sec_db;
+        size = xran_sectiondb_size(p_dev->fh_cfg.nCC, nAnt);
+        pArena = xran_zmalloc(NULL, size, XRAN_SECTIONDB_ALIGN);
+        if(pArena){
+            p_sectiondb[xran_port_id][vMu] = xran_sectiondb_layout(pArena, p_dev->fh_cfg.nCC, nAnt, pArena);
             print_dbg("xran_port_id %d %p\n",xran_port_id,  p_sectiondb[xran_port_id][vMu]);
-
-            ret = xran_alloc_sectioninfo_db(vMu, p_dev->fh_cfg.nCC, nAnt, p_sec_db);
-
-            if(ret != XRAN_STATUS_SUCCESS){
-                print_err("Memory Allocation Failed [port %d sz %ld]\n", xran_port_id, sizeof(struct xran_sectioninfo_db));
-                return XRAN_STATUS_FAIL;
-            }
         } else {
-            print_err("Memory Allocation Failed [port %d sz %ld]\n", xran_port_id, sizeof(SECTION_DB_TYPE));
+            print_err("Memory Allocation Failed [port %d sz %ld]\n", xran_port_id, size);
             return (XRAN_STATUS_RESOURCE);
         }
     }
@@ -200,10 +183,10 @@ xran_cp_init_vMu_sectiondb(void *pHandle, uint8_t vMu, int32_t nAnt)
 int32_t
 xran_cp_free_sectiondb(void *pHandle)
 {
-    int32_t ctx, dir, cc, ant;
     struct xran_device_ctx* p_dev = NULL;
     uint8_t xran_port_id = 0;
-    PSECTION_DB_TYPE p_sec_db =  NULL;
+    void *pArena[XRAN_MAX_NUM_MU];
+    int i, num = 0;
 
     if(pHandle) {
         p_dev = (struct xran_device_ctx* )pHandle;
@@ -213,44 +196,19 @@ xran_cp_free_sectiondb(void *pHandle)
         return (XRAN_STATUS_FAIL);
     }
 
-    for(int i=0;i<p_dev->fh_cfg.numMUs;i++)
+    /* the descriptors live in the arenas, collect them first.
+     * This includes the DB for SSB if it uses a virtual numerology */
+    for(i=0;i<XRAN_MAX_NUM_MU;i++)
     {
-        p_sec_db = p_sectiondb[xran_port_id][p_dev->fh_cfg.mu_number[i]];
-        if(p_sec_db){
-            for (ctx = 0; ctx < XRAN_MAX_SECTIONDB_CTX; ctx++) {
-                for (dir = 0; dir < XRAN_DIR_MAX; dir++) {
-                    for (cc = 0; cc < XRAN_COMPONENT_CARRIERS_MAX; cc++) {
-                        for (ant = 0; ant < (XRAN_MAX_ANTENNA_NR*2 + XRAN_MAX_ANT_ARRAY_ELM_NR); ant++) {
-                            if(p_sec_db->p_sectiondb_elm[ctx][dir][cc][ant])
-                                xran_free(p_sec_db->p_sectiondb_elm[ctx][dir][cc][ant]);
-                        }
-                    }
-                }
-            }
+        if(p_sectiondb[xran_port_id][i]){
+            if(p_sectiondb[xran_port_id][i]->pArena)
+                pArena[num++] = p_sectiondb[xran_port_id][i]->pArena;
+            p_sectiondb[xran_port_id][i] = NULL;
         }
-        xran_free(p_sec_db);
-        p_sectiondb[xran_port_id][p_dev->fh_cfg.mu_number[i]] = NULL;
-    }
-
-    // Free DB for SSB
-    if(p_dev->vMuInfo.ssbInfo.ssbMu == 4 && p_dev->fh_cfg.numMUs == 1 && p_dev->fh_cfg.mu_number[0] == 3){
-        p_sec_db = p_sectiondb[xran_port_id][p_dev->vMuInfo.ssbInfo.ssbMu];
-        if(p_sec_db){
-            for (ctx = 0; ctx < XRAN_MAX_SECTIONDB_CTX; ctx++) {
-                for (dir = 0; dir < XRAN_DIR_MAX; dir++) {
-                    for (cc = 0; cc < XRAN_COMPONENT_CARRIERS_MAX; cc++) {
-                        for (ant = 0; ant < (XRAN_MAX_ANTENNA_NR*2 + XRAN_MAX_ANT_ARRAY_ELM_NR); ant++) {
-                            if(p_sec_db->p_sectiondb_elm[ctx][dir][cc][ant])
-                                xran_free(p_sec_db->p_sectiondb_elm[ctx][dir][cc][ant]);
-                        }
-                    }
-                }
-            }
-        }
-        xran_free(p_sec_db);
-        p_sectiondb[xran_port_id][p_dev->vMuInfo.ssbInfo.ssbMu] = NULL;
     }
 
+    for(i=0;i<num;i++)
+        xran_free(pArena[i]);
 
     return (XRAN_STATUS_SUCCESS);
 }
@@ -259,7 +217,6 @@ static inline struct xran_sectioninfo_db *
 xran_get_section_db(void *pHandle,
         uint8_t dir, uint8_t cc_id, uint8_t ruport_id, uint8_t ctx_id, uint8_t mu)
 {
-    struct xran_sectioninfo_db *ptr;
     struct xran_device_ctx* p_dev = NULL;
     uint8_t xran_port_id = 0;
     PSECTION_DB_TYPE p_sec_db =  NULL;
@@ -298,14 +255,12 @@ xran_get_section_db(void *pHandle,
         return (NULL);
         }
 
-    if(unlikely(ruport_id >= XRAN_MAX_ANTENNA_NR*2 + XRAN_MAX_ANT_ARRAY_ELM_NR)) {
+    if(unlikely(ruport_id >= XRAN_SECTIONDB_MAX_ANT)) {
         print_err("Invalid eAxC id - %d", ruport_id);
         return (NULL);
         }
 
-    ptr = p_sec_db->p_sectiondb_elm[ctx_id][dir][cc_id][ruport_id];
-
-    return(ptr);
+    return(xran_sectiondb_elm(p_sec_db, ctx_id, dir, cc_id, ruport_id));
 }
 
 static inline struct xran_section_info *
@@ -1202,6 +1157,7 @@ xran_cp_get_hdroffset_section1(uint32_t exthdr_size)
  * @return
  *  XRAN_STATUS_SUCCESS on success
  *  XRAN_STATUS_RESOURCE, if destination memory is not enough to store all BFWs
+ *  XRAN_STATUS_INVALID_PARAM, if numSetBFW exceeds XRAN_MAX_SET_BFWS
  */
 #ifdef XRAN_CP_BF_WEIGHT_STRUCT_OPT
 int32_t xran_cp_prepare_ext11_bfws(uint8_t numSetBFW, uint8_t numBFW,
@@ -1222,14 +1178,24 @@ int32_t xran_cp_prepare_ext11_bfws(uint8_t numSetBFW, uint8_t numBFW,
     uint32_t  hdr_offset;
     uint8_t   *ptr;
 
-    struct xranlib_compress_request  bfpComp_req;
+    struct xranlib_compress_bfw_batch_request bfpComp_req;
     struct xranlib_compress_response bfpComp_rsp;
+#ifndef XRAN_CP_BF_WEIGHT_STRUCT_OPT
+    int16_t   *bfw_ptrs[XRAN_MAX_SET_BFWS];
+    uint16_t  bfw_beamIds[XRAN_MAX_SET_BFWS];
+#endif
 
     if(dst == NULL) {
         print_err("Invalid destination pointer!");
         return (XRAN_STATUS_INVALID_PARAM);
     }
 
+    /* bfwInfo and the arrays of the batch compression hold XRAN_MAX_SET_BFWS sets */
+    if(numSetBFW > XRAN_MAX_SET_BFWS) {
+        print_err("Invalid number of sets of BFWs - %d (max %d)", numSetBFW, XRAN_MAX_SET_BFWS);
+        return (XRAN_STATUS_INVALID_PARAM);
+    }
+
     /* Calculate the size of BFWs I/Q in bytes */
     iq_bitsize = numBFW * iqWidth * 2;
     iq_size = iq_bitsize>>3;
@@ -1270,45 +1236,405 @@ int32_t xran_cp_prepare_ext11_bfws(uint8_t numSetBFW, uint8_t numBFW,
 
         /* currently only supports BFP compression */
         case XRAN_BFWCOMPMETHOD_BLKFLOAT:
-            memset(&bfpComp_req, 0, sizeof(struct xranlib_compress_request));
+            memset(&bfpComp_req, 0, sizeof(struct xranlib_compress_bfw_batch_request));
             memset(&bfpComp_rsp, 0, sizeof(struct xranlib_compress_response));
 
+            /* all sets are compressed in one pass, the output is already in
+             * [bfwCompParam][beamId][BFWs] order of extension 11 */
+#ifdef XRAN_CP_BF_WEIGHT_STRUCT_OPT
+            bfpComp_req.data_in         = (int16_t **)bfwInfo->pBFWs;
+            bfpComp_req.beamId          = bfwInfo->beamId;
+#else
             for(i = 0; i < numSetBFW; i++) {
-                bfpComp_req.numRBs          = 1;
-                bfpComp_req.numDataElements = numBFW*2;
-                bfpComp_req.len             = numBFW*2*2;
-                bfpComp_req.compMethod      = compMeth;
-                bfpComp_req.iqWidth         = iqWidth;
+                bfw_ptrs[i]     = (int16_t *)bfwInfo[i].pBFWs;
+                bfw_beamIds[i]  = bfwInfo[i].beamId;
+            }
+            bfpComp_req.data_in         = bfw_ptrs;
+            bfpComp_req.beamId          = bfw_beamIds;
+#endif
+            bfpComp_req.numBeams        = numSetBFW;
+            bfpComp_req.numDataElements = numBFW*2;
+            bfpComp_req.compMethod      = compMeth;
+            bfpComp_req.iqWidth         = iqWidth;
+            bfpComp_rsp.data_out        = (int8_t *)ptr;
+
+            if(xranlib_compress_bfw_batch(&bfpComp_req, &bfpComp_rsp) == 0) {
+                print_dbg("comp_len %d iq_size %d\n", bfpComp_rsp.len, iq_size);
+            } else {
+                print_err("compression failed\n");
+                return (XRAN_STATUS_FAIL);
+                }
+            ptr += numSetBFW * (iq_size + 3);
+            break;
+
+        default:
+            print_err("Compression method %d is not supported!", compMeth);
+            return (XRAN_STATUS_INVALID_PARAM);
+    }
+
+    /* Update the length of extension with padding */
+    parm_size = (total_len + sizeof(union xran_cp_radioapp_section_ext11))
+                    % XRAN_SECTIONEXT_ALIGN;
+    if(parm_size) {
+        /* Add padding */
+        parm_size = XRAN_SECTIONEXT_ALIGN - parm_size;
+        memcpy(ptr, zeropad, parm_size);
+        total_len += parm_size;
+        }
+
+    return (total_len);
+}
+
+/**
+ * @brief Create the cache of compressed BFWs for Section Extension 11
+ *
+ * @ingroup xran_cp_pkt
+ *
+ * @param nEntries      the number of entries, rounded up to power of 2
+ * @param maxNumBFW     the maximum number of BFWs in a set (antenna elements)
+ * @param beamIdOnly    if set, extension 11 is prepared with disableBFWs=1
+ *                      when all sets of BFWs have already been sent to O-RU
+ *
+ * @return
+ *  pointer to the cache on success
+ *  NULL, if failed to allocate the memory
+ */
+struct xran_cp_bfw_cache *
+xran_cp_bfw_cache_create(uint32_t nEntries, uint8_t maxNumBFW, uint8_t beamIdOnly)
+{
+    struct xran_cp_bfw_cache *pCache;
+    uint32_t i;
+
+    if(nEntries == 0 || maxNumBFW == 0) {
+        print_err("Invalid BFW cache size - %u entries, %u BFWs", nEntries, maxNumBFW);
+        return (NULL);
+        }
+
+    pCache = (struct xran_cp_bfw_cache *)xran_zmalloc(NULL, sizeof(struct xran_cp_bfw_cache), RTE_CACHE_LINE_SIZE);
+    if(pCache == NULL) {
+        print_err("Failed to allocate BFW cache");
+        return (NULL);
+        }
+
+    pCache->nEntries    = rte_align32pow2(nEntries);
+    /* bfwCompParam + beamId + BFWs up to 16 bits */
+    pCache->maxSetLen   = RTE_ALIGN_CEIL(1 + 2 + maxNumBFW * 2 * sizeof(int16_t), RTE_CACHE_LINE_SIZE);
+    pCache->maxBfwLen   = RTE_ALIGN_CEIL(maxNumBFW * 2 * sizeof(int16_t), RTE_CACHE_LINE_SIZE);
+    pCache->maxNumBFW   = maxNumBFW;
+    pCache->beamIdOnly  = beamIdOnly;
+
+    pCache->pEntries = (struct xran_cp_bfw_cache_entry *)xran_zmalloc(NULL,
+                            pCache->nEntries * sizeof(struct xran_cp_bfw_cache_entry), RTE_CACHE_LINE_SIZE);
+    pCache->pSetPool = (uint8_t *)xran_zmalloc(NULL, pCache->nEntries * (pCache->maxSetLen + pCache->maxBfwLen),
+                            RTE_CACHE_LINE_SIZE);
+    if(pCache->pEntries == NULL || pCache->pSetPool == NULL) {
+        print_err("Failed to allocate BFW cache with %u entries", pCache->nEntries);
+        xran_cp_bfw_cache_free(pCache);
+        return (NULL);
+        }
+
+    for(i = 0; i < pCache->nEntries; i++) {
+        pCache->pEntries[i].pSet    = pCache->pSetPool + i * (pCache->maxSetLen + pCache->maxBfwLen);
+        pCache->pEntries[i].pBFWs   = pCache->pEntries[i].pSet + pCache->maxSetLen;
+        }
+
+    return (pCache);
+}
+
+void
+xran_cp_bfw_cache_free(struct xran_cp_bfw_cache *pCache)
+{
+    if(pCache == NULL)
+        return;
+
+    if(pCache->pSetPool)
+        xran_free(pCache->pSetPool);
+    if(pCache->pEntries)
+        xran_free(pCache->pEntries);
+    xran_free(pCache);
+}
+
+/**
+ * @brief Invalidate all entries of the BFW cache
+ *  Needs to be called when O-RU has lost the BFWs it received (e.g. restart),
+ *  so the next extension 11 carries the weights again.
+ *
+ * @ingroup xran_cp_pkt
+ */
+void
+xran_cp_bfw_cache_flush(struct xran_cp_bfw_cache *pCache)
+{
+    uint32_t i;
+
+    if(pCache == NULL)
+        return;
+
+    for(i = 0; i < pCache->nEntries; i++)
+        pCache->pEntries[i].valid = 0;
+}
+
+int32_t
+xran_cp_bfw_cache_get_stats(struct xran_cp_bfw_cache *pCache, struct xran_cp_bfw_cache_stats *pStats)
+{
+    if(pCache == NULL || pStats == NULL)
+        return (XRAN_STATUS_INVALID_PARAM);
+
+    *pStats = pCache->stats;
+    return (XRAN_STATUS_SUCCESS);
+}
+
+void
+xran_cp_bfw_cache_reset_stats(struct xran_cp_bfw_cache *pCache)
+{
+    if(pCache)
+        memset(&pCache->stats, 0, sizeof(struct xran_cp_bfw_cache_stats));
+}
+
+/* 64bit hash of the uncompressed BFWs, four independent CRC32 streams */
+static inline uint64_t
+xran_cp_bfw_hash(const uint8_t *pBFWs, uint8_t numBFW)
+{
+    const uint64_t *p64 = (const uint64_t *)pBFWs;
+    int32_t n64 = (numBFW * 2 * sizeof(int16_t)) >> 3;
+    uint64_t c0 = 0x9e3779b9, c1 = 0x85ebca6b, c2 = 0xc2b2ae35, c3 = 0x27d4eb2f;
+    uint32_t h0, h1;
+    int32_t i;
+
+    for(i = 0; i + 4 <= n64; i += 4) {
+        c0 = _mm_crc32_u64(c0, p64[i]);
+        c1 = _mm_crc32_u64(c1, p64[i + 1]);
+        c2 = _mm_crc32_u64(c2, p64[i + 2]);
+        c3 = _mm_crc32_u64(c3, p64[i + 3]);
+        }
+    for(; i < n64; i++)
+        c0 = _mm_crc32_u64(c0, p64[i]);
+    if(numBFW & 1)  /* one I/Q pair left */
+        c1 = _mm_crc32_u32((uint32_t)c1, *(const uint32_t *)(pBFWs + (n64 << 3)));
+
+    h0 = (uint32_t)c0 ^ (((uint32_t)c2 << 16) | ((uint32_t)c2 >> 16));
+    h1 = (uint32_t)c1 ^ (((uint32_t)c3 << 16) | ((uint32_t)c3 >> 16));
+    return (((uint64_t)h1 << 32) | h0);
+}
+
+/* The entry holds these BFWs, the weights are compared so a hash collision is a miss */
+static inline int32_t
+xran_cp_bfw_cache_match(const struct xran_cp_bfw_cache_entry *pEntry, uint64_t wHash, const uint8_t *pBFWs,
+                        uint8_t numBFW, uint8_t iqWidth, uint8_t compMeth)
+{
+    return (pEntry->wHash == wHash && pEntry->numBFW == numBFW
+            && pEntry->iqWidth == iqWidth && pEntry->compMeth == compMeth
+            && memcmp(pEntry->pBFWs, pBFWs, numBFW * 2 * sizeof(int16_t)) == 0);
+}
+
+/* Find the entry of (eAxC, beamId), or the entry to be replaced for it */
+static inline struct xran_cp_bfw_cache_entry *
+xran_cp_bfw_cache_lookup(struct xran_cp_bfw_cache *pCache, uint16_t eAxC, uint16_t beamId, int32_t *pFound)
+{
+    struct xran_cp_bfw_cache_entry *pEntry, *pFree = NULL;
+    uint32_t home, i;
+
+    home = _mm_crc32_u32(0, ((uint32_t)eAxC << 16) | beamId) & (pCache->nEntries - 1);
+    for(i = 0; i < XRAN_CP_BFW_CACHE_MAX_PROBE; i++) {
+        pEntry = &pCache->pEntries[(home + i) & (pCache->nEntries - 1)];
+        if(pEntry->valid) {
+            if(pEntry->eAxC == eAxC && pEntry->beamId == beamId) {
+                *pFound = 1;
+                return (pEntry);
+                }
+            }
+        else if(pFree == NULL)
+            pFree = pEntry;
+        }
+
+    *pFound = 0;
+    return ((pFree != NULL) ? pFree : &pCache->pEntries[home]);
+}
+
+/**
+ * @brief Prepare Beam Forming Weights(BFWs) for Section Extension 11
+ *   using the cache of compressed BFWs.
+ *   A set of BFWs is compressed only if the cache has no entry for
+ *   (eAxC, beamId) with the same weights, otherwise the cached set is copied.
+ *   If the cache was created with beamIdOnly and all sets are found,
+ *   only beamIds are written and disableBFWs is set, the O-RU applies
+ *   the weights it received previously for each beamId.
+ *
+ * @ingroup xran_cp_pkt
+ *
+ * @param pCache        the cache of compressed BFWs, xran_cp_prepare_ext11_bfws() is used if NULL
+ * @param eAxC          the eAxC the BFWs are sent to
+ * @param numSetBFW     the number of set of BFWs
+ * @param numBFW        the number of BFWs in a set
+ * @param iqWidth       the bitwidth of BFW
+ * @param compMeth      Compression method for BFW
+ * @param dst           the pointer of destination buffer (external buffer)
+ * @param dst_maxlen    the maximum length of destination buffer
+ *                      need to exclude headroom from MTU
+ * @param bfwInfo       Extension 11 PRB bundle information array.
+ * @param pDisableBFWs  returns the value of disableBFWs for the extension
+ *
+ * @return
+ *  the length of BFWs in the extension on success
+ *  XRAN_STATUS_RESOURCE, if destination memory is not enough to store all BFWs
+ */
 #ifdef XRAN_CP_BF_WEIGHT_STRUCT_OPT
-                bfpComp_req.data_in         = (int16_t *)(bfwInfo->pBFWs[i]);
+#define BFW_SET_BEAMID(i)   (bfwInfo->beamId[i])
+#define BFW_SET_PTR(i)      (bfwInfo->pBFWs[i])
+int32_t xran_cp_prepare_ext11_bfws_cached(struct xran_cp_bfw_cache *pCache, uint16_t eAxC,
+                        uint8_t numSetBFW, uint8_t numBFW,
+                        uint8_t iqWidth, uint8_t compMeth,
+                        uint8_t *dst, int16_t dst_maxlen,
+                        struct xran_ext11_bfw_set_info bfwInfo[],
+                        uint8_t *pDisableBFWs)
 #else
-                bfpComp_req.data_in         = (int16_t *)bfwInfo[i].pBFWs;
+#define BFW_SET_BEAMID(i)   (bfwInfo[i].beamId)
+#define BFW_SET_PTR(i)      (bfwInfo[i].pBFWs)
+int32_t xran_cp_prepare_ext11_bfws_cached(struct xran_cp_bfw_cache *pCache, uint16_t eAxC,
+                        uint8_t numSetBFW, uint8_t numBFW,
+                        uint8_t iqWidth, uint8_t compMeth,
+                        uint8_t *dst, int16_t dst_maxlen,
+                        struct xran_ext11_bfw_info bfwInfo[],
+                        uint8_t *pDisableBFWs)
 #endif
-                bfpComp_rsp.data_out        = (int8_t*)(ptr + 2);   /* exponent will be stored at first byte */
+{
+    int32_t   i, found;
+    int32_t   iq_bitsize, iq_size;
+    int32_t   parm_size, set_len;
+    int32_t   total_len;
+    uint16_t  beamId;
+    uint8_t   *ptr;
+    uint64_t  wHash[XRAN_MAX_SET_BFWS];
+    struct xran_cp_bfw_cache_entry *pEntry;
+
+    struct xranlib_compress_bfw_batch_request bfpComp_req;
+    struct xranlib_compress_response bfpComp_rsp;
+    int16_t   *bfw_ptr;
+
+    if(pDisableBFWs)
+        *pDisableBFWs = 0;
+
+    /* Uncompressed BFWs are only worth caching to send beamIds only */
+    if(pCache == NULL || numBFW > pCache->maxNumBFW || numSetBFW > XRAN_MAX_SET_BFWS
+        || (compMeth != XRAN_BFWCOMPMETHOD_BLKFLOAT
+            && !(compMeth == XRAN_BFWCOMPMETHOD_NONE && pCache->beamIdOnly))) {
+        if(pCache)
+            pCache->stats.bypass++;
+        return (xran_cp_prepare_ext11_bfws(numSetBFW, numBFW, iqWidth, compMeth, dst, dst_maxlen, bfwInfo));
+        }
+
+    if(dst == NULL) {
+        print_err("Invalid destination pointer!");
+        return (XRAN_STATUS_INVALID_PARAM);
+        }
+
+    /* Calculate the size of BFWs I/Q in bytes */
+    iq_bitsize = numBFW * iqWidth * 2;
+    iq_size = iq_bitsize>>3;
+    if(iq_bitsize%8)
+        iq_size++;
+
+    /* Check maximum size */
+    parm_size = ((compMeth == XRAN_BFWCOMPMETHOD_NONE)?0:1) + 2; /* bfwCompParam + beamID(2) */
+    set_len = parm_size + iq_size;
+    total_len = numSetBFW * set_len;
 
-                if(xranlib_compress_bfw(&bfpComp_req, &bfpComp_rsp) == 0) {
-                    print_dbg("comp_len %d iq_size %d\n", bfpComp_rsp.len, iq_size);
-                } else {
+    if(total_len >= dst_maxlen) {
+        print_err("Exceed maximum length to fit the set of BFWs - (%d/%d)",
+                    total_len, dst_maxlen);
+        return (XRAN_STATUS_RESOURCE);
+        }
+
+    ptr = dst + xran_cp_get_hdroffset_section1(sizeof(union xran_cp_radioapp_section_ext11));
+
+    for(i = 0; i < numSetBFW; i++)
+        wHash[i] = xran_cp_bfw_hash(BFW_SET_PTR(i), numBFW);
+
+    /* O-RU has all the weights already, beamIds are enough */
+    if(pCache->beamIdOnly && pDisableBFWs) {
+        for(i = 0; i < numSetBFW; i++) {
+            pEntry = xran_cp_bfw_cache_lookup(pCache, eAxC, BFW_SET_BEAMID(i) & 0x7fff, &found);
+            if(!found || !xran_cp_bfw_cache_match(pEntry, wHash[i], BFW_SET_PTR(i), numBFW, iqWidth, compMeth))
+                break;
+            }
+
+        if(i == numSetBFW) {
+            /* bfwCompHdr is not present with disableBFWs=1 */
+            ptr--;
+            for(i = 0; i < numSetBFW; i++) {
+                *((uint16_t *)ptr) = rte_cpu_to_be_16((BFW_SET_BEAMID(i) & 0x7fff));
+                ptr += 2;
+                }
+            pCache->stats.lookups   += numSetBFW;
+            pCache->stats.hits      += numSetBFW;
+            pCache->stats.beamIdOnly++;
+            *pDisableBFWs = 1;
+            total_len = numSetBFW * 2;
+
+            parm_size = (total_len + sizeof(union xran_cp_radioapp_section_ext11) - 1)
+                            % XRAN_SECTIONEXT_ALIGN;
+            if(parm_size) {
+                parm_size = XRAN_SECTIONEXT_ALIGN - parm_size;
+                memcpy(ptr, zeropad, parm_size);
+                total_len += parm_size;
+                }
+            return (total_len);
+            }
+        }
+
+    for(i = 0; i < numSetBFW; i++) {
+        beamId = BFW_SET_BEAMID(i) & 0x7fff;
+        pEntry = xran_cp_bfw_cache_lookup(pCache, eAxC, beamId, &found);
+        pCache->stats.lookups++;
+
+        if(found && xran_cp_bfw_cache_match(pEntry, wHash[i], BFW_SET_PTR(i), numBFW, iqWidth, compMeth)) {
+            pCache->stats.hits++;
+            }
+        else {
+            pCache->stats.misses++;
+            if(found)
+                pCache->stats.updates++;
+            else if(pEntry->valid)
+                pCache->stats.evictions++;
+
+            pEntry->valid   = 0;
+            if(compMeth == XRAN_BFWCOMPMETHOD_BLKFLOAT) {
+                memset(&bfpComp_req, 0, sizeof(struct xranlib_compress_bfw_batch_request));
+                memset(&bfpComp_rsp, 0, sizeof(struct xranlib_compress_response));
+
+                bfw_ptr = (int16_t *)BFW_SET_PTR(i);
+                bfpComp_req.data_in         = &bfw_ptr;
+                bfpComp_req.beamId          = &beamId;
+                bfpComp_req.numBeams        = 1;
+                bfpComp_req.numDataElements = numBFW*2;
+                bfpComp_req.compMethod      = compMeth;
+                bfpComp_req.iqWidth         = iqWidth;
+                bfpComp_rsp.data_out        = (int8_t *)pEntry->pSet;
+
+                if(xranlib_compress_bfw_batch(&bfpComp_req, &bfpComp_rsp) != 0) {
                     print_err("compression failed\n");
                     return (XRAN_STATUS_FAIL);
                     }
-                /* move exponent, it is stored at first byte of output */
-                *ptr = *(ptr + 2);
+                }
+            else {
+                *((uint16_t *)pEntry->pSet) = rte_cpu_to_be_16(beamId);
+                memcpy((pEntry->pSet + 2), BFW_SET_PTR(i), iq_size);
+                }
 
-                /* beamId */
-#ifdef XRAN_CP_BF_WEIGHT_STRUCT_OPT
-                *((uint16_t *)(ptr+1)) = rte_cpu_to_be_16(((bfwInfo->beamId[i]) & 0x7fff));
-#else
-                *((uint16_t *)(ptr+1)) = rte_cpu_to_be_16((bfwInfo[i].beamId & 0x7fff));
-#endif
-                ptr += iq_size + 3;
+            memcpy(pEntry->pBFWs, BFW_SET_PTR(i), numBFW * 2 * sizeof(int16_t));
+            pEntry->wHash   = wHash[i];
+            pEntry->eAxC    = eAxC;
+            pEntry->beamId  = beamId;
+            pEntry->numBFW  = numBFW;
+            pEntry->iqWidth = iqWidth;
+            pEntry->compMeth= compMeth;
+            pEntry->setLen  = set_len;
+            pEntry->valid   = 1;
             }
-            break;
 
-        default:
-            print_err("Compression method %d is not supported!", compMeth);
-            return (XRAN_STATUS_INVALID_PARAM);
-    }
+        /* Copy right away, a following set may replace this entry */
+        memcpy(ptr, pEntry->pSet, set_len);
+        ptr += set_len;
+        }
 
     /* Update the length of extension with padding */
     parm_size = (total_len + sizeof(union xran_cp_radioapp_section_ext11))
@@ -1322,6 +1648,8 @@ int32_t xran_cp_prepare_ext11_bfws(uint8_t numSetBFW, uint8_t numBFW,
 
     return (total_len);
 }
+#undef BFW_SET_BEAMID
+#undef BFW_SET_PTR
 
 
 static void free_ext_buf(void *addr __rte_unused, void *opaque __rte_unused)
@@ -1382,8 +1710,10 @@ xran_prepare_sectionext_11(struct rte_mbuf *mbuf,
         }
 #endif
 
-    /* BFWs are already present in the external buffer, just update the length */
-    total_len = sizeof(union xran_cp_radioapp_section_ext11) + params->totalBfwIQLen;
+    /* BFWs are already present in the external buffer, just update the length.
+     * bfwCompHdr is not present if disableBFWs is set */
+    total_len = sizeof(union xran_cp_radioapp_section_ext11) - (params->disableBFWs ? 1 : 0)
+                    + params->totalBfwIQLen;
 
     ext11 = (union xran_cp_radioapp_section_ext11 *)rte_pktmbuf_append(mbuf, total_len);
     if(ext11 == NULL) {
@@ -1407,9 +1737,12 @@ xran_prepare_sectionext_11(struct rte_mbuf *mbuf,
                                   | ((total_len / XRAN_SECTIONEXT_ALIGN) << xran_cp_radioapp_sec_ext11_bitfield_ExtLen)
                                   | (params->disableBFWs << xran_cp_radioapp_sec_ext11_bitfield_DisBFWs)
                                   | (params->RAD << xran_cp_radioapp_sec_ext11_bitfield_RAD);
-    ext11->data_field.data_field2 = ((XRAN_CONVERT_BFWIQWIDTH(params->bfwIqWidth)) << xran_cp_radioapp_sec_ext11_bitfield_BFWIQWidth)
-                                  | (params->bfwCompMeth << xran_cp_radioapp_sec_ext11_bitfield_BFWCompMeth)
-                                  | params->numBundPrb;
+    if(params->disableBFWs)
+        ext11->all_bits.numBundPrb = params->numBundPrb;
+    else
+        ext11->data_field.data_field2 = ((XRAN_CONVERT_BFWIQWIDTH(params->bfwIqWidth)) << xran_cp_radioapp_sec_ext11_bitfield_BFWIQWidth)
+                                      | (params->bfwCompMeth << xran_cp_radioapp_sec_ext11_bitfield_BFWCompMeth)
+                                      | params->numBundPrb;
 
     *(uint32_t *)ext11 = rte_cpu_to_be_32(*(uint32_t*)ext11);
 
@@ -2391,9 +2724,9 @@ int32_t xran_parse_section_ext10(void *ext, struct xran_sectionext10_info *extin
 
 int32_t
 xran_parse_section_ext11(void *ext,
-                         struct xran_sectionext11_recv_info *extinfo)
+                         struct xran_sectionext11_recv_info *extinfo, uint16_t numPrbc)
 {
-    int32_t len;
+    int32_t len, numBeamIds;
     int32_t total_len;
     union xran_cp_radioapp_section_ext11 *ext11;
     uint8_t *data;
@@ -2420,6 +2753,32 @@ xran_parse_section_ext11(void *ext,
     data    += sizeof(union xran_cp_radioapp_section_ext11);
 
     extinfo->numSetBFWs = 0;
+    if(extinfo->disableBFWs) {
+        /* beamIds only, the BFWs were received before for each of them.
+         * bfwCompHdr is not present */
+        len     -= 1;
+        data    -= 1;
+        extinfo->bfwCompMeth    = XRAN_BFWCOMPMETHOD_NONE;
+        extinfo->bfwIqWidth     = 0;
+
+        /* one beamId per PRB bundle, beamId 0 is valid so the zero pad is
+         * told by the count. Without numPrbc (all PRBs) the count is not
+         * known here and a zero in the last word is taken as the pad */
+        numBeamIds = (numPrbc && extinfo->numBundPrb) ?
+                        (numPrbc + extinfo->numBundPrb - 1) / extinfo->numBundPrb : XRAN_MAX_SET_BFWS;
+        while((len+2) <= total_len && extinfo->numSetBFWs < RTE_MIN(numBeamIds, XRAN_MAX_SET_BFWS)) {
+            if(numBeamIds == XRAN_MAX_SET_BFWS
+                && (total_len - len) < XRAN_SECTIONEXT_ALIGN && *((uint16_t *)data) == 0)
+                break;
+            extinfo->bundInfo[extinfo->numSetBFWs].beamId   = rte_be_to_cpu_16(*((int16_t *)data)) & 0x7fff;
+            extinfo->bundInfo[extinfo->numSetBFWs].BFWSize  = 0;
+            len     += sizeof(int16_t);
+            data    += sizeof(int16_t);
+            extinfo->numSetBFWs++;
+            }
+        return (total_len);
+        }
+
     while((len+4) < total_len) {    /* adding 4 is to consider zero pads */
         /* Get bfwCompParam */
         switch(ext11->all_bits.bfwCompMeth) {
@@ -2537,7 +2896,7 @@ xran_parse_section_extension(struct rte_mbuf *mbuf,
                 len = xran_parse_section_ext10(ptr, &section->exts[numext].u.ext10);
                 break;
             case XRAN_CP_SECTIONEXTCMD_11:
-                len = xran_parse_section_ext11(ptr, &section->exts[numext].u.ext11);
+                len = xran_parse_section_ext11(ptr, &section->exts[numext].u.ext11, section->info.numPrbc);
                 break;
 
             default:
@@ -2963,7 +3322,7 @@ xran_parse_cp_pkt(struct rte_mbuf *mbuf,
 #endif
                 } //numSections
 
-                pCnt = &p_xran_dev_ctx->fh_counters;
+                pCnt = xran_fh_counters(p_xran_dev_ctx);
                 /* SRS should not have extension */
                 if(pCnt && (result->sections[0].info.ef) && (result->sections[0].exts[0].type == 1) && (result->numSections != result->numSetBFW) && (result->ext1count != result->numSetBFW)){
                     print_dbg("extension 1 is not Valid! [%d:%d:%d]", result->numSections, result->numSetBFW, result->ext1count);
@@ -136,6 +136,7 @@ int32_t xran_init_seqid(void *pHandle)
 {
     int cell, dir, ant;
     int8_t xran_port = 0;
+    struct xran_device_ctx *p_dev = (struct xran_device_ctx *)pHandle;
 
     if((xran_port =  xran_dev_ctx_get_port_id(pHandle)) < 0 )
     {
@@ -143,6 +144,9 @@ int32_t xran_init_seqid(void *pHandle)
         return (0);
     }
 
+    p_dev->rx_seqid_window = xran_rx_seqid_window(p_dev->fh_cfg.rxSeqIdWindow);
+    memset(p_dev->rx_seqid_state, 0, sizeof(p_dev->rx_seqid_state));
+
     for(cell=0; cell < XRAN_MAX_CELLS_PER_PORT; cell++)
     {
         for(dir=0; dir < XRAN_DIR_MAX; dir++)
@@ -176,8 +180,8 @@ process_cplane(struct rte_mbuf *pkt, void* handle)
                     &parse_recv[p_xran_dev_ctx->xran_port_id], (void*)p_xran_dev_ctx, &mb_free);
         if(unlikely(ret != XRAN_STATUS_SUCCESS)){
             print_dbg("Invalid C-plane packet\n");
-            ++p_xran_dev_ctx->fh_counters.rx_err_cp;
-            ++p_xran_dev_ctx->fh_counters.rx_err_drop;
+            ++xran_fh_counters(p_xran_dev_ctx)->rx_err_cp;
+            ++xran_fh_counters(p_xran_dev_ctx)->rx_err_drop;
         }
     }
     return (mb_free);
@@ -549,8 +553,8 @@ int32_t xran_transmit_cpmsg_prach(void *pHandle, struct xran_cp_gen_params *para
             rte_pktmbuf_free(mbuf);
         } else {
             /* Increment the counters */
-            ++pxran_lib_ctx->fh_counters.tx_counter;
-            pxran_lib_ctx->fh_counters.tx_bytes_counter += rte_pktmbuf_pkt_len(mbuf);
+            ++xran_fh_counters(pxran_lib_ctx)->tx_counter;
+            xran_fh_counters(pxran_lib_ctx)->tx_bytes_counter += rte_pktmbuf_pkt_len(mbuf);
         }
     }
     else
@@ -1015,8 +1019,8 @@ xran_status_t xran_vMu_cp_create_and_send_ssb_pkt(uint8_t xranPortId, uint8_t ru
                 }
 
                 /* Increment the counters */
-                pDevCtx->fh_counters.tx_counter += 1;
-                pDevCtx->fh_counters.tx_bytes_counter += pkt_len;
+                xran_fh_counters(pDevCtx)->tx_counter += 1;
+                xran_fh_counters(pDevCtx)->tx_bytes_counter += pkt_len;
             }
         } //for elmIdx
     } //for ttiIdx
@@ -1033,7 +1037,7 @@ int32_t xran_cp_create_and_send_section(uint8_t xranPortId, uint8_t ruPortId, in
     if(pDevCtx==NULL)
         return -1;
 
-    struct xran_common_counters *pCnt = &pDevCtx->fh_counters;
+    struct xran_common_counters *pCnt = xran_fh_counters(pDevCtx);
     struct xran_cp_gen_params cpPktGenParams;
     struct xran_section_info *info;
     struct rte_mbuf *mbuf;
@@ -41,6 +41,7 @@
 #include "xran_dev.h"
 #include "xran_lib_mlog_tasks_id.h"
 #include "xran_ecpri_owd_measurements.h"
+#include "xran_owd_estimator.h"
 
 #include "xran_printf.h"
 #include "xran_mlog_lnx.h"
@@ -133,67 +134,82 @@ void xran_initialize_and_verify_owd_pl_length(void* handle)
 
 }
 
-void xran_adjust_timing_parameters(void* Handle)
+int32_t xran_adjust_timing_parameters(void* Handle)
 {
     struct xran_device_ctx* p_xran_dev_ctx = (struct xran_device_ctx*)Handle;
     int appMode = xran_get_syscfg_appmode();
+    struct xran_ecpri_del_meas_cmn* powdc = &p_xran_dev_ctx->eowd_cmn[appMode];
+    struct xran_ecpri_del_meas_port* powdp = &p_xran_dev_ctx->eowd_port[appMode][p_xran_dev_ctx->xran_port_id];
+    int32_t targetUs, adjUs;
+    uint32_t i;
+    uint8_t mu;
+
+    /* one step per measurement */
+    if (powdp->msState != XRAN_OWDM_DONE || powdp->numRuns == p_xran_dev_ctx->owdRunsSeen)
+        return 0;
+    p_xran_dev_ctx->owdRunsSeen = powdp->numRuns;
+
+    targetUs = xran_owd_window_target(powdc, powdp->delayAvg);
+    adjUs    = xran_owd_window_step(powdc, targetUs, powdp->windowAdjUs);
 #ifdef XRAN_OWD_TIMING_MODS
-    printf("delayAvg is %d and DELAY_THRESHOLD is %d \n", p_xran_dev_ctx->eowd_port[appMode][0].delayAvg, DELAY_THRESHOLD);
+    printf("delay %lu [ns] budget %u guard %u: windows target %d adjusted by %d -> %d [us]\n", powdp->delayAvg,
+        powdc->owdm_budgetNs, powdc->owdm_guardNs, targetUs, powdp->windowAdjUs, adjUs);
 #endif
-    if (p_xran_dev_ctx->eowd_port[appMode][0].delayAvg < DELAY_THRESHOLD )
-        {
-            uint8_t mu = p_xran_dev_ctx->fh_cfg.mu_number[0];
-            /* Modify the timing parameters */
-            if (p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_max_up >= ADJUSTMENT)
-                p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_max_up -= ADJUSTMENT;
-            if (p_xran_dev_ctx->fh_cfg.perMu[mu].T2a_max_up >= ADJUSTMENT)
-                p_xran_dev_ctx->fh_cfg.perMu[mu].T2a_max_up -= ADJUSTMENT;
-            if (p_xran_dev_ctx->fh_cfg.perMu[mu].Ta3_min >= ADJUSTMENT)
-                p_xran_dev_ctx->fh_cfg.perMu[mu].Ta3_min -= ADJUSTMENT;
-            if (p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_max_cp_dl >= ADJUSTMENT)
-                p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_max_cp_dl -= ADJUSTMENT;
-            if (p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_min_up >= ADJUSTMENT)
-                p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_min_up -= ADJUSTMENT;
-            if (p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_max_up >= ADJUSTMENT)
-                p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_max_up -= ADJUSTMENT;
-            if (p_xran_dev_ctx->fh_cfg.perMu[mu].Ta4_min >= ADJUSTMENT)
-                p_xran_dev_ctx->fh_cfg.perMu[mu].Ta4_min -= ADJUSTMENT;
-            if (p_xran_dev_ctx->fh_cfg.perMu[mu].Ta4_max >= ADJUSTMENT)
-                p_xran_dev_ctx->fh_cfg.perMu[mu].Ta4_max -= ADJUSTMENT;
-#ifdef XRAN_OWD_TIMING_MODS
-            printf("Mod T1a_max_up is %d\n",p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_max_up);
-            printf("Mod T2a_max_up is %d\n",p_xran_dev_ctx->fh_cfg.perMu[mu].T2a_max_up);
-            printf("Mod Ta3_min is %d\n",p_xran_dev_ctx->fh_cfg.perMu[mu].Ta3_min);
-            printf("Mod T1a_max_cp_dl is %d\n",p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_max_cp_dl);
-            printf("Mod T1a_min_up is %d\n",p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_min_up);
-            printf("Mod T1a_max_up is %d\n",p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_max_up);
-            printf("Mod Ta4_min is %d\n",p_xran_dev_ctx->fh_cfg.perMu[mu].Ta4_min);
-            printf("Mod Ta4_max is %d\n",p_xran_dev_ctx->fh_cfg.perMu[mu].Ta4_max);
-#endif
-        }
+    if (adjUs == powdp->windowAdjUs)
+        return 0;
 
+    for (i = 0; i < p_xran_dev_ctx->fh_cfg.numMUs; i++)
+    {
+        mu = p_xran_dev_ctx->fh_cfg.mu_number[i];
+        p_xran_dev_ctx->owdWindowAdjUs[mu] = (int16_t)xran_owd_window_apply(&p_xran_dev_ctx->fh_cfg.perMu[mu],
+                                                    p_xran_dev_ctx->owdWindowAdjUs[mu], adjUs);
+        printf("OWD port %d mu %d: timing windows %s by %d [us], T1a_max_up %d Ta4_max %d\n",
+            p_xran_dev_ctx->xran_port_id, mu, (p_xran_dev_ctx->owdWindowAdjUs[mu] >= 0) ? "tightened" : "widened",
+            abs(p_xran_dev_ctx->owdWindowAdjUs[mu]), p_xran_dev_ctx->fh_cfg.perMu[mu].T1a_max_up,
+            p_xran_dev_ctx->fh_cfg.perMu[mu].Ta4_max);
+    }
+    powdp->windowAdjUs = (int16_t)adjUs;
+
+    return 1;
 }
 
-void xran_compute_and_report_delay_estimate (struct xran_ecpri_del_meas_port *portData, uint16_t totalSamples, uint16_t id )
+void xran_restart_delay_measurement(void* Handle)
 {
-    uint16_t i;
-    uint64_t *samples= portData->delaySamples;
+    struct xran_device_ctx* p_xran_dev_ctx = (struct xran_device_ctx*)Handle;
+    int appMode = xran_get_syscfg_appmode();
+    struct xran_ecpri_del_meas_cmn* powdc = &p_xran_dev_ctx->eowd_cmn[appMode];
+    struct xran_ecpri_del_meas_port* powdp = &p_xran_dev_ctx->eowd_port[appMode][p_xran_dev_ctx->xran_port_id];
 
+    if (powdc->owdm_periodMs == 0 || powdp->msState != XRAN_OWDM_DONE || powdp->numRuns != p_xran_dev_ctx->owdRunsSeen)
+        return;
 
-    for (i=2 ; i < MX_NUM_SAMPLES; i++) //Ignore first 2 samples
-    {
-        portData->delayAvg += samples[i];
+    if (rte_rdtsc() - powdp->doneTsc < rte_get_tsc_hz() / 1000 * powdc->owdm_periodMs)
+        return;
 
-    }
+    // The transmitter of the IO core picks the port up again once its state leaves XRAN_OWDM_DONE
+    xran_initialize_ecpri_del_meas_port(powdc, powdp, 1);
+}
 
-    // Average the delay by the number of samples
-    if ((totalSamples != 0)&&(totalSamples > 2))
-    {
-        portData->delayAvg /= (totalSamples-2);
-    }
-    // Report Average with printf
+void xran_compute_and_report_delay_estimate (struct xran_ecpri_del_meas_cmn *pCmn, struct xran_ecpri_del_meas_port *portData, uint16_t id )
+{
+    struct xran_owd_estimate est;
+
+    est.ewma = portData->delayEwma;
+    if (xran_owd_estimate(portData->delaySamples, pCmn->numberOfSamples, pCmn->owdm_pctl, pCmn->owdm_ewmaShift, &est) != 0)
+        return;
+
+    portData->delayMin      = est.min;
+    portData->delayPctl     = est.pctl;
+    portData->delayEwma     = est.ewma;
+    portData->numOutliers   = (uint16_t)est.numOutliers;
+    portData->delayAvg      = xran_owd_select(&est, pCmn->filterType);
+    portData->doneTsc       = rte_rdtsc();
+    portData->numRuns++;
+
+    // Report the estimate with printf
     flockfile(stdout);
-    printf("OWD for port %i is %lu [ns] id %d \n", portData->portid, portData->delayAvg, id);
+    printf("OWD for port %i is %lu [ns] id %d (avg %lu min %lu p%u %lu ewma %lu, %u outliers)\n", portData->portid, portData->delayAvg, id,
+        est.avg, est.min, pCmn->owdm_pctl ? pCmn->owdm_pctl : XRAN_OWD_PCTL_DEFAULT, est.pctl, est.ewma, est.numOutliers);
     funlockfile(stdout);
 
 }
@@ -327,8 +343,9 @@ int32_t xran_ecpri_port_update_required (struct xran_io_cfg * cfg, uint16_t port
                 port_id++;
                 if (port[port_id] == 0xFF)
                 {
-                    // Done with all ports disable further execution
-                    eowdc->owdm_enable = 0;
+                    // Done with all ports disable further execution, unless the timing thread re-measures periodically
+                    if (eowdc->owdm_periodMs == 0)
+                        eowdc->owdm_enable = 0;
                 }
                 else
                 {
@@ -344,8 +361,9 @@ int32_t xran_ecpri_port_update_required (struct xran_io_cfg * cfg, uint16_t port
             }
             else
             {
-                // Disable the measurements
-                eowdc->owdm_enable = 0;
+                // Disable the measurements, unless the timing thread re-measures periodically
+                if (eowdc->owdm_periodMs == 0)
+                    eowdc->owdm_enable = 0;
                 ret_value = 1;
             }
         }
@@ -910,7 +928,7 @@ int xran_process_delmeas_request(struct rte_mbuf *pkt, void* handle, struct xran
 
     if (powdp->numMeas == powdc->numberOfSamples)
     {
-        xran_compute_and_report_delay_estimate(powdp, powdc->numberOfSamples, xran_get_syscfg_appmode());
+        xran_compute_and_report_delay_estimate(powdc, powdp, xran_get_syscfg_appmode());
         powdp->msState = XRAN_OWDM_DONE;
         xran_if_current_state = XRAN_RUNNING;
     }
@@ -1025,7 +1043,7 @@ int xran_process_delmeas_response(struct rte_mbuf *pkt, void* handle, struct xra
 
     if (powdp->numMeas == powdc->numberOfSamples)
     {
-        xran_compute_and_report_delay_estimate(powdp, powdc->numberOfSamples, appMode);
+        xran_compute_and_report_delay_estimate(powdc, powdp, appMode);
         powdp->msState = XRAN_OWDM_DONE;
         xran_if_current_state= XRAN_RUNNING;
     }
@@ -1315,7 +1333,7 @@ int xran_process_delmeas_follow_up(struct rte_mbuf *pkt, void* handle, struct xr
 
     if (powdp->numMeas == powdc->numberOfSamples)
     {
-        xran_compute_and_report_delay_estimate(powdp, powdc->numberOfSamples, appMode);
+        xran_compute_and_report_delay_estimate(powdc, powdp, appMode);
         powdp->msState = XRAN_OWDM_DONE;
         xran_if_current_state = XRAN_RUNNING;
     }
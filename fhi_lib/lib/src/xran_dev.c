@@ -33,6 +33,7 @@
 #include <time.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <string.h>
 #include <pthread.h>
 #include <malloc.h>
 #include <immintrin.h>
@@ -298,6 +299,188 @@ uint8_t xran_get_num_ant_elm(void *pHandle)
 }
 
 
+__thread int32_t xran_fh_counters_shard_id = -1;
+static uint32_t xran_fh_counters_shard_next = 0;
+
+/**
+ * @brief Assign a fh counter shard to the calling thread
+ *
+ * Threads get consecutive shards on their first counter update. Past
+ * XRAN_FH_COUNTERS_SHARDS threads the shards are reused, and threads sharing
+ * one are no longer race free.
+ *
+ * @return shard index of the calling thread
+ */
+int32_t xran_fh_counters_shard_bind(void)
+{
+    uint32_t shard_id = __atomic_fetch_add(&xran_fh_counters_shard_next, 1, __ATOMIC_RELAXED);
+
+    if(shard_id >= XRAN_FH_COUNTERS_SHARDS)
+    {
+        print_err("more than %d threads update fh counters, shard %d is shared\n",
+            XRAN_FH_COUNTERS_SHARDS, shard_id % XRAN_FH_COUNTERS_SHARDS);
+        shard_id %= XRAN_FH_COUNTERS_SHARDS;
+    }
+
+    xran_fh_counters_shard_id = (int32_t)shard_id;
+    return xran_fh_counters_shard_id;
+}
+
+/**
+ * @brief Sum the data path counters of all shards
+ *
+ * Shards are read while their owners keep counting, so the sum is a
+ * consistent value of each counter but not of the set. Per second fields of
+ * pSum are left at zero.
+ *
+ * @param p_dev_ctx device context
+ * @param pSum sum of all shards
+ */
+void xran_fh_counters_sum(struct xran_device_ctx *p_dev_ctx, struct xran_common_counters *pSum)
+{
+    const volatile struct xran_common_counters *pCnt;
+    int32_t i, ant;
+
+    memset(pSum, 0, sizeof(struct xran_common_counters));
+
+    for(i = 0; i < XRAN_FH_COUNTERS_SHARDS; i++)
+    {
+        pCnt = &p_dev_ctx->fh_counters_shard[i].cnt;
+
+        pSum->Rx_on_time        += pCnt->Rx_on_time;
+        pSum->Rx_early          += pCnt->Rx_early;
+        pSum->Rx_late           += pCnt->Rx_late;
+        pSum->Rx_corrupt        += pCnt->Rx_corrupt;
+        pSum->Rx_pkt_dupl       += pCnt->Rx_pkt_dupl;
+        pSum->Total_msgs_rcvd   += pCnt->Total_msgs_rcvd;
+        pSum->Rx_pkt_lost       += pCnt->Rx_pkt_lost;
+        pSum->Rx_pkt_reorder    += pCnt->Rx_pkt_reorder;
+        pSum->Rx_pkt_late       += pCnt->Rx_pkt_late;
+
+        pSum->rx_counter        += pCnt->rx_counter;
+        pSum->tx_counter        += pCnt->tx_counter;
+        pSum->tx_bytes_counter  += pCnt->tx_bytes_counter;
+        pSum->rx_bytes_counter  += pCnt->rx_bytes_counter;
+
+        for(ant = 0; ant < XRAN_MAX_ANTENNA_NR; ant++)
+        {
+            pSum->rx_pusch_packets[ant] += pCnt->rx_pusch_packets[ant];
+            pSum->rx_prach_packets[ant] += pCnt->rx_prach_packets[ant];
+        }
+        pSum->rx_srs_packets            += pCnt->rx_srs_packets;
+        pSum->rx_csirs_packets          += pCnt->rx_csirs_packets;
+        pSum->rx_invalid_ext1_packets   += pCnt->rx_invalid_ext1_packets;
+
+        pSum->rx_err_drop       += pCnt->rx_err_drop;
+        pSum->rx_err_up         += pCnt->rx_err_up;
+        pSum->rx_err_pusch      += pCnt->rx_err_pusch;
+        pSum->rx_err_csirs      += pCnt->rx_err_csirs;
+        pSum->rx_err_srs        += pCnt->rx_err_srs;
+        pSum->rx_err_prach      += pCnt->rx_err_prach;
+        pSum->rx_err_cp         += pCnt->rx_err_cp;
+        pSum->rx_err_ecpri      += pCnt->rx_err_ecpri;
+        pSum->rx_err_pkt_per_sym += pCnt->rx_err_pkt_per_sym;
+    }
+}
+
+/**
+ * @brief Total number of packets sent by all threads
+ *
+ * @param p_dev_ctx device context
+ * @return sum of tx_counter over all shards
+ */
+uint64_t xran_fh_counters_tx_total(struct xran_device_ctx *p_dev_ctx)
+{
+    uint64_t tx_counter = 0;
+    int32_t i;
+
+    for(i = 0; i < XRAN_FH_COUNTERS_SHARDS; i++)
+        tx_counter += *(const volatile uint64_t *)&p_dev_ctx->fh_counters_shard[i].cnt.tx_counter;
+
+    return tx_counter;
+}
+
+/**
+ * @brief Snapshot of the fh counters as reported to the application
+ *
+ * rx_bytes_counter and tx_bytes_counter count the bytes since the start of
+ * the current second, as they did before the counters were sharded.
+ *
+ * @param p_dev_ctx device context
+ * @param pStats snapshot of the counters
+ */
+void xran_fh_counters_snapshot(struct xran_device_ctx *p_dev_ctx, struct xran_common_counters *pStats)
+{
+    struct xran_common_counters *pRate = &p_dev_ctx->fh_counters;
+
+    xran_fh_counters_sum(p_dev_ctx, pStats);
+
+    pStats->gps_second              = pRate->gps_second;
+    pStats->old_rx_counter          = pRate->old_rx_counter;
+    pStats->rx_counter_pps          = pRate->rx_counter_pps;
+    pStats->old_tx_counter          = pRate->old_tx_counter;
+    pStats->tx_counter_pps          = pRate->tx_counter_pps;
+    pStats->old_tx_bytes_counter    = pRate->old_tx_bytes_counter;
+    pStats->old_rx_bytes_counter    = pRate->old_rx_bytes_counter;
+    pStats->tx_bytes_per_sec        = pRate->tx_bytes_per_sec;
+    pStats->tx_bits_per_sec         = pRate->tx_bits_per_sec;
+    pStats->rx_bytes_per_sec        = pRate->rx_bytes_per_sec;
+    pStats->rx_bits_per_sec         = pRate->rx_bits_per_sec;
+    pStats->tx_bytes_counter       -= pRate->old_tx_bytes_counter;
+    pStats->rx_bytes_counter       -= pRate->old_rx_bytes_counter;
+
+    pStats->timer_missed_sym        = pRate->timer_missed_sym;
+    pStats->timer_missed_slot       = pRate->timer_missed_slot;
+#ifdef POLL_EBBU_OFFLOAD
+    pStats->timer_missed_sym_window = pRate->timer_missed_sym_window;
+#endif
+}
+
+/**
+ * @brief Update the per second rates, called by the timing thread
+ *
+ * @param p_dev_ctx device context
+ * @param current_sec current second of the timing source
+ */
+void xran_fh_counters_update_rates(struct xran_device_ctx *p_dev_ctx, uint64_t current_sec)
+{
+    struct xran_common_counters *pRate = &p_dev_ctx->fh_counters;
+    struct xran_common_counters sum;
+
+    if(pRate->gps_second == current_sec)
+        return;
+
+    if((current_sec - pRate->gps_second) != 1)
+        print_dbg("second c %ld p %ld\n", current_sec, pRate->gps_second);
+
+    xran_fh_counters_sum(p_dev_ctx, &sum);
+
+    pRate->gps_second           = current_sec;
+
+    pRate->rx_counter_pps       = sum.rx_counter - pRate->old_rx_counter;
+    pRate->old_rx_counter       = sum.rx_counter;
+    pRate->tx_counter_pps       = sum.tx_counter - pRate->old_tx_counter;
+    pRate->old_tx_counter       = sum.tx_counter;
+    pRate->rx_bytes_per_sec     = sum.rx_bytes_counter - pRate->old_rx_bytes_counter;
+    pRate->old_rx_bytes_counter = sum.rx_bytes_counter;
+    pRate->tx_bytes_per_sec     = sum.tx_bytes_counter - pRate->old_tx_bytes_counter;
+    pRate->old_tx_bytes_counter = sum.tx_bytes_counter;
+    pRate->rx_bits_per_sec      = pRate->rx_bytes_per_sec * 8 / 1000L;
+    pRate->tx_bits_per_sec      = pRate->tx_bytes_per_sec * 8 / 1000L;
+    print_dbg("current_sec %lu\n", current_sec);
+}
+
+/**
+ * @brief Clear all fh counters of a device, only while it has no traffic
+ *
+ * @param p_dev_ctx device context
+ */
+void xran_fh_counters_reset(struct xran_device_ctx *p_dev_ctx)
+{
+    memset(&p_dev_ctx->fh_counters, 0, sizeof(struct xran_common_counters));
+    memset(p_dev_ctx->fh_counters_shard, 0, sizeof(p_dev_ctx->fh_counters_shard));
+}
+
 int32_t xran_get_common_counters(void *pXranLayerHandle, struct xran_common_counters *pStats)
 {
     struct xran_device_ctx* pDev = (struct xran_device_ctx*)pXranLayerHandle;
@@ -305,7 +488,7 @@ int32_t xran_get_common_counters(void *pXranLayerHandle, struct xran_common_coun
     uint16_t port, qi;
 
     if(pStats && pDev) {
-        *pStats = pDev->fh_counters;
+        xran_fh_counters_snapshot(pDev, pStats);
 
         if (ctx->io_cfg.num_rxq > 1) {
             for (port = 0; port < ctx->io_cfg.num_vfs; port++) {
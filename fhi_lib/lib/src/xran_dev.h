@@ -44,6 +44,10 @@ extern "C" {
 #include "xran_prach_cfg.h"
 #include "xran_up_api.h"
 #include "xran_cp_api.h"
+#include "xran_rx_seqid.h"
+#include "xran_ul_done.h"
+#include "xran_rx_pkt.h"
+#include "xran_occasion.h"
 
 #define DIV_ROUND_OFFSET(X,Y)       ( X/Y + ((X%Y)?1:0) )
 
@@ -60,6 +64,8 @@ extern "C" {
 
 #define XRAN_MAX_LIST_USEDCORE      (64)
 
+#define XRAN_FH_COUNTERS_SHARDS     (32)    /**< threads updating the fh counters of one device */
+
 enum xran_job_type_id {
     XRAN_JOB_TYPE_OTA_CB   = 0,
     XRAN_JOB_TYPE_CP_DL    = 1,
@@ -291,6 +297,15 @@ typedef struct xran_device_per_mu_fields
     uint8_t deadline_slot_advance[XRAN_SLOT_CB_TYPE_MAX];   /* if CB for deadline should be in next slot but reflect current slot */
 
     nbiot_prach_xmit_sfId_sym_pair sfSymToXmitPrach[NBIOT_PRACH_NUM_SYM_GROUPS];
+
+    /* early UL completion (see xran_reg_ul_done_cb) */
+    uint8_t ulDoneCbMode;
+    xran_ul_done_callback_fn ulDoneCb;
+    void *ulDoneCbParam;
+    struct xran_ul_done_slot ulDone[XRAN_N_FE_BUF_LEN][XRAN_MAX_SECTOR_NR];
+
+    /* PRACH, SRS and TDD pattern by slot (see xran_init_occasions) */
+    struct xran_occ_tbl occTbl;
 }xran_device_per_mu_fields;
 
 typedef struct slot_map
@@ -408,6 +423,15 @@ typedef struct xran_device_virtual_mu_fields_s {
     xran_ssb_info ssbInfo;
 } xran_device_virtual_mu_fields;
 
+/* fh counters of one thread. Only the owning thread writes them, so the
+ * increments stay plain. The device context is not cache aligned, so a full
+ * line of padding keeps the counters of two threads out of the same line */
+struct xran_fh_counters_shard
+{
+    uint8_t pad[RTE_CACHE_LINE_SIZE];
+    struct xran_common_counters cnt;
+};
+
 typedef struct /* TO DO __rte_cache_aligned*/ xran_device_ctx
 {
     uint8_t sector_id;
@@ -475,7 +499,13 @@ typedef struct /* TO DO __rte_cache_aligned*/ xran_device_ctx
     struct rte_mempool *direct_pool;
     struct rte_mempool *indirect_pool;
 
-    struct xran_common_counters fh_counters;
+    struct xran_common_counters fh_counters;    /**< per second rates and timer counters, owned by the timing thread */
+    struct xran_fh_counters_shard fh_counters_shard[XRAN_FH_COUNTERS_SHARDS]; /**< data path counters, one block per thread */
+
+    uint32_t rx_seqid_window;   /**< resolved depth of the U-plane RX seqId reorder window */
+    uint64_t rx_seqid_state[XRAN_MAX_CELLS_PER_PORT][XRAN_RX_SEQID_MAX_EAXC]; /**< U-plane RX seqId tracker per CC and eAxC */
+
+    struct xran_rx_pkt_arena rx_pkt_arena;  /**< storage of the RX packet controls of the PRB maps */
 
     xran_ethdi_mbuf_send_fn send_cpmbuf2ring;   /**< callback to send mbufs of C-Plane packets to the VF ring */
     xran_ethdi_mbuf_send_fn send_upmbuf2ring;   /**< callback to send mbufs of U-Plane packets to the VF ring */
@@ -489,6 +519,7 @@ typedef struct /* TO DO __rte_cache_aligned*/ xran_device_ctx
     int32_t ctx;
 
     bool use_tx_sym_gen_func; /*Used for RU */
+    bool ruLoadGen;           /* RU UL U-plane sent by the load generator workers */
 
     tx_sym_gen_fn tx_sym_gen_func;
     tx_sym_fn tx_sym_func;
@@ -525,6 +556,8 @@ typedef struct /* TO DO __rte_cache_aligned*/ xran_device_ctx
     int8_t *p_o_ru_addr;    /* TODO: need to revisit */
     struct xran_ecpri_del_meas_cmn eowd_cmn[2];
     struct xran_ecpri_del_meas_port eowd_port[2][XRAN_VF_MAX];
+    int16_t owdWindowAdjUs[XRAN_MAX_NUM_MU];    /* timing window adjustment applied per numerology, > 0 tightened */
+    uint32_t owdRunsSeen;                       /* measurements of the port the window controller has stepped on */
 
 #if 0 /* dynamic sectId <--> mu mapping */
     /* Structure to hold the sectionId to numerology mapping for a given {frameId, subframeId, slotId}
@@ -574,6 +607,8 @@ struct xran_system_config
     xran_callback_oam_notify_fn oam_notify_cb;
 
     uint32_t logLevel;  /**< configuration of log level */
+
+    struct xran_ru_loadgen_cfg ruLoadGen;   /* O-RU load generator */
 };
 
 extern struct xran_device_ctx *g_xran_dev_ctx[XRAN_PORTS_NUM];
@@ -621,6 +656,49 @@ int xran_dev_get_num_usedcores(void);
 uint32_t *xran_dev_get_list_usedcores(void);
 int xran_dev_init_num_usedcores(void);
 
+int32_t xran_fh_counters_shard_bind(void);
+void xran_fh_counters_sum(struct xran_device_ctx *p_dev_ctx, struct xran_common_counters *pSum);
+void xran_fh_counters_snapshot(struct xran_device_ctx *p_dev_ctx, struct xran_common_counters *pStats);
+void xran_fh_counters_update_rates(struct xran_device_ctx *p_dev_ctx, uint64_t current_sec);
+uint64_t xran_fh_counters_tx_total(struct xran_device_ctx *p_dev_ctx);
+void xran_fh_counters_reset(struct xran_device_ctx *p_dev_ctx);
+
+extern __thread int32_t xran_fh_counters_shard_id;
+
+/* data path counters of the calling thread */
+static inline struct xran_common_counters *xran_fh_counters(struct xran_device_ctx *p_dev_ctx)
+{
+    int32_t shard_id = xran_fh_counters_shard_id;
+
+    if(unlikely(shard_id < 0))
+        shard_id = xran_fh_counters_shard_bind();
+
+    return &p_dev_ctx->fh_counters_shard[shard_id].cnt;
+}
+
+/* accounts a received PUSCH section and reports the early UL completion it causes */
+static inline void xran_ul_done_on_rx(struct xran_device_ctx *p_dev_ctx, uint8_t mu, uint32_t tti,
+                uint8_t cc_id, uint8_t symb_id, uint16_t num_prbu)
+{
+    xran_device_per_mu_fields *pMu = &p_dev_ctx->perMu[mu];
+    struct xran_ul_done_slot *pSlot;
+    uint32_t done;
+
+    if(likely(pMu->ulDoneCbMode == XRAN_UL_DONE_CB_OFF))
+        return;
+
+    pSlot = &pMu->ulDone[tti % XRAN_N_FE_BUF_LEN][cc_id];
+    done = xran_ul_done_rx(pSlot, symb_id, num_prbu);
+    if(likely(done == 0))
+        return;
+
+    if(pMu->ulDoneCbMode == XRAN_UL_DONE_CB_SYM)
+        pMu->ulDoneCb(pMu->ulDoneCbParam, cc_id, pSlot->tti, symb_id, mu);
+    /* the full slot deadline may have reported the slot already */
+    if((done & XRAN_UL_DONE_ALL) && xran_ul_done_claim(pSlot))
+        pMu->ulDoneCb(pMu->ulDoneCbParam, cc_id, pSlot->tti, XRAN_UL_DONE_SLOT_SYM, mu);
+}
+
 static inline int8_t xran_dev_ctx_get_port_id(void * handle)
 {
     struct xran_device_ctx * p_dev_ctx  = (struct xran_device_ctx *)handle;
@@ -75,6 +75,7 @@
 #include "xran_rx_proc.h"
 #include "xran_cb_proc.h"
 #include "xran_ecpri_owd_measurements.h"
+#include "xran_ru_loadgen.h"
 
 #include "xran_mlog_lnx.h"
 
@@ -148,6 +149,9 @@ struct xran_common_counters* xran_fh_counters_ebbu_offload(void)
     struct xran_device_ctx * p_xran_dev_ctx = XRAN_GET_DEV_CTX ;
     struct xran_common_counters * pCnt = &p_xran_dev_ctx->fh_counters;
 
+    /* data path counters live in the shards, refresh the one checked by debug stop */
+    pCnt->tx_counter = xran_fh_counters_tx_total(p_xran_dev_ctx);
+
     return pCnt;
 }
 #endif
@@ -170,13 +174,18 @@ xran_get_if_state(void)
 
 int32_t xran_is_prach_slot(uint8_t PortId, uint32_t sfId, uint32_t slotId, uint8_t mu)
 {
-    int32_t is_prach_slot = 0;
     struct xran_device_ctx * pDevCtx = xran_dev_get_ctx_by_id(PortId);
     if (pDevCtx == NULL)
     {
         print_err("PortId %d not exist\n", PortId);
-        return is_prach_slot;
+        return 0;
     }
+    return xran_dev_is_prach_slot(pDevCtx, sfId, slotId, mu);
+}
+
+int32_t xran_dev_is_prach_slot(struct xran_device_ctx *pDevCtx, uint32_t sfId, uint32_t slotId, uint8_t mu)
+{
+    int32_t is_prach_slot = 0;
     struct xran_prach_cp_config *pPrachCPConfig = &(pDevCtx->perMu[mu].PrachCPConfig);
     if(mu == XRAN_DEFAULT_MU)
         mu = pDevCtx->fh_cfg.mu_number[0];
@@ -216,6 +225,147 @@ int32_t xran_is_prach_slot(uint8_t PortId, uint32_t sfId, uint32_t slotId, uint8
     return is_prach_slot;
 }
 
+/**
+ * @brief Compile the PRACH, SRS and TDD pattern of a port into per slot tables
+ *
+ * One table per numerology, see xran_occasion.h. Every entry is filled from
+ * xran_fs_get_slot_type(), xran_fs_get_symbol_type() and
+ * xran_dev_is_prach_slot(), so it has to be called once PRACH, SRS and the
+ * slot types of CC 0 are set up.
+ *
+ * @param pDevCtx device context
+ * @return XRAN_STATUS_SUCCESS, XRAN_STATUS_RESOURCE when out of memory
+ */
+int32_t
+xran_init_occasions(struct xran_device_ctx * pDevCtx)
+{
+    struct xran_fh_config *pFhCfg = &pDevCtx->fh_cfg;
+    struct xran_prach_cp_config *pPrachCfg[XRAN_OCC_PRACH_NUM];
+    struct xran_occ_tbl *pTbl;
+    struct xran_occ_slot *pSlot;
+    uint32_t PortId = pDevCtx->xran_port_id;
+    uint32_t tddPeriod, interval, slotsPerSf, slotsPerFrame, maxSlots, frameId, sfId, slotId;
+    uint32_t i, tti, type, sym, cfg, numPrach;
+    uint8_t x[XRAN_OCC_PRACH_NUM];
+    uint16_t prachSym;
+    uint8_t mu;
+
+    tddPeriod = (pFhCfg->frame_conf.nFrameDuplexType == XRAN_TDD) ? pFhCfg->frame_conf.nTddPeriod : 0;
+    prachSym  = xran_occ_sym_mask(pDevCtx->prach_start_symbol[0], pDevCtx->prach_last_symbol[0]);
+
+    for(i = 0; i < pFhCfg->numMUs; i++)
+    {
+        mu          = pFhCfg->mu_number[i];
+        pTbl        = &pDevCtx->perMu[mu].occTbl;
+        pTbl->pSlot = NULL;
+
+        interval        = xran_fs_get_tti_interval(mu);
+        slotsPerSf      = SLOTNUM_PER_SUBFRAME(interval);
+        slotsPerFrame   = SLOTS_PER_SYSTEMFRAME(interval);
+        maxSlots        = xran_fs_get_max_slot(mu);
+
+        /* the PRACH configurations xran_is_prach_slot() answers for */
+        numPrach = 0;
+        if(mu < 2 || mu == 3)
+        {
+            pPrachCfg[numPrach++] = &pDevCtx->perMu[mu].PrachCPConfig;
+            if(pDevCtx->dssEnable)
+                pPrachCfg[numPrach++] = &pDevCtx->perMu[mu].PrachCPConfigLTE;
+        }
+        for(cfg = 0; cfg < numPrach; cfg++)
+            x[cfg] = pPrachCfg[cfg]->x;
+
+        pTbl->slotsPerFrame = slotsPerFrame;
+        pTbl->numFrames     = xran_occ_num_frames(x, numPrach, tddPeriod, slotsPerFrame, maxSlots / slotsPerFrame);
+        pTbl->numSlots      = pTbl->numFrames * slotsPerFrame;
+
+        pTbl->pSlot = (struct xran_occ_slot *)xran_zmalloc("occasions", pTbl->numSlots * sizeof(struct xran_occ_slot),
+                                                            RTE_CACHE_LINE_SIZE);
+        if(pTbl->pSlot == NULL)
+        {
+            print_err("RU%d: failed to allocate the occasions of %u slots for mu %d\n", PortId, pTbl->numSlots, mu);
+            return XRAN_STATUS_RESOURCE;
+        }
+
+        for(tti = 0; tti < pTbl->numSlots; tti++)
+        {
+            pSlot   = &pTbl->pSlot[tti];
+            slotId  = XranGetSlotNum(tti, slotsPerSf);
+            sfId    = XranGetSubFrameNum(tti, slotsPerSf, SUBFRAMES_PER_SYSTEMFRAME);
+            frameId = tti / slotsPerFrame;
+
+            for(type = XRAN_SLOT_TYPE_DL; type < XRAN_SLOT_TYPE_LAST; type++)
+                if(xran_fs_get_slot_type(PortId, 0, tti, type, mu) == 1)
+                    pSlot->slotType |= XRAN_OCC_SLOT(type);
+
+            for(sym = 0; sym < XRAN_NUM_OF_SYMBOL_PER_SLOT; sym++)
+            {
+                switch(xran_fs_get_symbol_type(PortId, 0, tti, sym, mu))
+                {
+                    case XRAN_SYMBOL_TYPE_DL:
+                        pSlot->dlSym |= (1 << sym);
+                        break;
+                    case XRAN_SYMBOL_TYPE_UL:
+                        pSlot->ulSym |= (1 << sym);
+                        break;
+                    case XRAN_SYMBOL_TYPE_FDD:
+                        pSlot->dlSym |= (1 << sym);
+                        pSlot->ulSym |= (1 << sym);
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            if(tddPeriod && (tti % tddPeriod) == pDevCtx->srs_cfg.slot
+                && (pSlot->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL))))
+            {
+                pSlot->slotType |= XRAN_OCC_SLOT_SRS;
+                pSlot->srsSym    = pDevCtx->srs_cfg.symbMask;
+            }
+
+            /* x 0 is a configuration index not in the tables */
+            for(cfg = 0; cfg < numPrach; cfg++)
+                if(x[cfg] && (frameId % x[cfg]) == pPrachCfg[cfg]->y[0]
+                    && xran_dev_is_prach_slot(pDevCtx, sfId, slotId, mu))
+                    pSlot->prachSym[cfg] = prachSym;
+        }
+
+        /* a TDD period that does not divide the SFN cycle takes the whole cycle, 1.3 MB at mu 3 */
+        if(pFhCfg->log_level)
+            printf("RU%d: mu %d occasions over %u frames%s, %u slots, %lu bytes\n", PortId, mu, pTbl->numFrames,
+                (pTbl->numSlots == maxSlots) ? " (full SFN cycle)" : "", pTbl->numSlots,
+                (unsigned long)pTbl->numSlots * sizeof(struct xran_occ_slot));
+    }
+
+    return XRAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Release the tables of xran_init_occasions()
+ *
+ * @param pDevCtx device context
+ */
+void
+xran_free_occasions(struct xran_device_ctx * pDevCtx)
+{
+    struct xran_occ_tbl *pTbl;
+    uint32_t i;
+
+    if(pDevCtx->perMu == NULL)
+        return;
+
+    for(i = 0; i < pDevCtx->fh_cfg.numMUs; i++)
+    {
+        pTbl = &pDevCtx->perMu[pDevCtx->fh_cfg.mu_number[i]].occTbl;
+        if(pTbl->pSlot)
+        {
+            xran_free(pTbl->pSlot);
+            pTbl->pSlot = NULL;
+        }
+    }
+}
+
 int32_t
 xran_init_srs(struct xran_fh_config* pConf, struct xran_device_ctx * pDevCtx)
 {
@@ -1398,6 +1548,46 @@ void rx_ul_static_srs_cb(struct rte_timer *tim, void *arg)
 }
 
 
+/* counts the PRBs the UL C-plane of the slot asks the first num_eAxc eAxC of the CC for,
+ * num_eAxc 0 leaves the slot to the UL deadline callbacks */
+static void xran_ul_done_arm_slot(struct xran_device_ctx *pDevCtx, uint32_t tti, int32_t ccId, uint8_t num_eAxc, uint8_t mu)
+{
+    struct xran_ul_done_slot *pSlot = &pDevCtx->perMu[mu].ulDone[tti % XRAN_N_FE_BUF_LEN][ccId];
+    struct xran_buffer_list *pBufList;
+    int antId;
+
+    xran_ul_done_reset(pSlot, tti);
+    if(xran_fs_get_slot_type(pDevCtx->xran_port_id, ccId, tti, XRAN_SLOT_TYPE_UL, mu) != 1)
+        return;
+
+    /* num_eAxc 0 still reports the UL slot, at the deadline */
+    for(antId = 0; antId < num_eAxc; antId++)
+    {
+        pBufList = &(pDevCtx->perMu[mu].sFrontHaulRxPrbMapBbuIoBufCtrl[tti % XRAN_N_FE_BUF_LEN][ccId][antId].sBufferList);
+        if(pBufList->pBuffers && pBufList->pBuffers->pData)
+            xran_ul_done_expect(pSlot, (struct xran_prb_map *)pBufList->pBuffers->pData);
+    }
+    xran_ul_done_arm(pSlot);
+}
+
+/* reports the UL slot of every active CC the RX path did not report complete */
+static void xran_ul_done_deadline(struct xran_device_ctx *pDevCtx, uint32_t tti, uint8_t mu)
+{
+    xran_device_per_mu_fields *pMu = &pDevCtx->perMu[mu];
+    int32_t ccId;
+
+    if(pMu->ulDoneCbMode == XRAN_UL_DONE_CB_OFF)
+        return;
+
+    for(ccId = 0; ccId < xran_get_num_cc(pDevCtx); ccId++)
+    {
+        if(!xran_isactive_cc(pDevCtx, ccId))
+            continue;
+        if(xran_ul_done_claim_deadline(&pMu->ulDone[tti % XRAN_N_FE_BUF_LEN][ccId], tti))
+            pMu->ulDoneCb(pMu->ulDoneCbParam, ccId, tti, XRAN_UL_DONE_TIMEOUT_SYM, mu);
+    }
+}
+
 void rx_ul_deadline_one_fourths_cb(struct rte_timer *tim, void *arg)
 {
     long t1 = MLogXRANTick();
@@ -1600,6 +1790,9 @@ void rx_ul_deadline_full_cb(struct rte_timer *tim, void *arg)
 
     rx_tti = (rx_tti + xran_fs_get_max_slot(mu) - 1 - pDevCtx->perMu[mu].deadline_slot_advance[XRAN_SLOT_FULL_CB]) % xran_fs_get_max_slot(mu);
 
+    /* early UL completion of the CCs not reported by the RX path yet */
+    xran_ul_done_deadline(pDevCtx, rx_tti, mu);
+
     /* U-Plane */
     for(ccId = 0; ccId < xran_get_num_cc(pDevCtx); ccId++)
     {
@@ -1754,9 +1947,9 @@ xran_prepare_cp_ul_slot(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nCcS
     uint8_t ctxId;
     void *pHandle;
     uint32_t interval;
-    uint8_t PortId;
 
     struct xran_buffer_list *pBufList;
+    const struct xran_occ_slot *pOcc;
     struct xran_device_ctx * pDevCtx = xran_dev_get_ctx_by_id(xran_port_id);
     struct xran_system_config *sysCfg = xran_get_systemcfg();
     if(unlikely(!pDevCtx))
@@ -1778,7 +1971,6 @@ xran_prepare_cp_ul_slot(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nCcS
     {
         pHandle     = pDevCtx;
         interval    = xran_fs_get_tti_interval(mu);
-        PortId      = pDevCtx->xran_port_id;
 
         tti = nSlotIdx;
 
@@ -1790,6 +1982,7 @@ xran_prepare_cp_ul_slot(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nCcS
 
         // ORAN frameId, 8 bits, [0, 255]
         frameId = (frameId & 0xff);
+        pOcc    = xran_occ_get(&pDevCtx->perMu[mu].occTbl, tti);
 
         num_eAxc = xran_get_num_eAxcUl(pHandle);
         num_CCPorts = xran_get_num_cc(pHandle);
@@ -1798,6 +1991,17 @@ xran_prepare_cp_ul_slot(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nCcS
 
         bool useSectType3 = xran_use_sect_type_3(pDevCtx, bufId, XRAN_DIR_UL, mu);
 
+        if(pDevCtx->perMu[mu].ulDoneCbMode != XRAN_UL_DONE_CB_OFF)
+        {
+            /* the expected PRBs are only known when one call prepares every eAxC of the CC */
+            for(ccId = nCcStart; (ccId < (nCcStart + nCcNum) && ccId < num_CCPorts); ccId++)
+            {
+                if(xran_isactive_cc(pDevCtx, ccId))
+                    xran_ul_done_arm_slot(pDevCtx, tti, ccId,
+                                          (nAntStart == 0 && nAntNum >= num_eAxc) ? num_eAxc : 0, mu);
+            }
+        }
+
         /* General Uplink */
 #if defined(__INTEL_COMPILER)
 #pragma vector always
@@ -1811,7 +2015,7 @@ xran_prepare_cp_ul_slot(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nCcS
 
                 /* start new section information list */
                 xran_cp_reset_section_info(pHandle, XRAN_DIR_UL, ccId, ruPortId, ctxId, mu);
-                if(xran_fs_get_slot_type(PortId, ccId, tti, XRAN_SLOT_TYPE_UL, mu) == 1)
+                if(pOcc->slotType & XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL))
                 {
 
                     pBufList = &(pDevCtx->perMu[mu].sFrontHaulRxPrbMapBbuIoBufCtrl[bufId][ccId][antId].sBufferList); /* To shorten reference */
@@ -1830,23 +2034,13 @@ xran_prepare_cp_ul_slot(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nCcS
         {
             struct xran_prach_cp_config *pPrachCPConfig = NULL;
                 //check for dss enable and fill based on technology select the pDevCtx->perMu[mu].PrachCPConfig NR/LTE.
-                if(pDevCtx->dssEnable){
-                    int i = tti % pDevCtx->dssPeriod;
-                    if(pDevCtx->technology[i]==1) {
-                        pPrachCPConfig = &(pDevCtx->perMu[mu].PrachCPConfig);
-                    }
-                    else{
-                        pPrachCPConfig = &(pDevCtx->perMu[mu].PrachCPConfigLTE);
-                    }
-                }
-                else{
+                uint32_t prachCfg = xran_occ_prach_cfg(pDevCtx->dssEnable, pDevCtx->technology, pDevCtx->dssPeriod, tti);
+                if(prachCfg == XRAN_OCC_PRACH_CFG_LTE)
+                    pPrachCPConfig = &(pDevCtx->perMu[mu].PrachCPConfigLTE);
+                else
                     pPrachCPConfig = &(pDevCtx->perMu[mu].PrachCPConfig);
-                }
 
-                uint32_t is_prach_slot = xran_is_prach_slot(PortId, sfId, slotId, mu);
-
-                if(((frameId % pPrachCPConfig->x) == pPrachCPConfig->y[0])
-                    && (is_prach_slot==1))
+                if(xran_occ_get_frame(&pDevCtx->perMu[mu].occTbl, frameId, tti)->prachSym[prachCfg])
                 {
                     for(antId = nAntStart; (antId < nAntStart + nAntNum) && antId < num_eAxc; antId++)
                     {
@@ -1914,7 +2108,7 @@ xran_prepare_cp_ul_slot(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nCcS
 
                     /* start new section information list */
                     xran_cp_reset_section_info(pHandle, XRAN_DIR_UL, ccId, portId, ctxId, mu);
-                    if(xran_fs_get_slot_type(PortId, ccId, tti, XRAN_SLOT_TYPE_UL,mu) == 1)
+                    if(pOcc->slotType & XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL))
                     {
                         pBufList = &(pDevCtx->perMu[mu].sFHSrsRxPrbMapBbuIoBufCtrl[bufId][ccId][antId].sBufferList); /* To shorten reference */
                         if(pBufList->pBuffers && pBufList->pBuffers->pData)
@@ -1970,6 +2164,7 @@ void tx_cp_ul_cb(struct rte_timer *tim, void *arg)
     struct xran_device_ctx * pDevCtx = p_MuPerDev->p_dev_ctx;
     struct xran_system_config *sysCfg = xran_get_systemcfg();
     uint8_t mu = p_MuPerDev->mu;
+    const struct xran_occ_slot *pOcc;
 
     if(xran_get_syscfg_bbuoffload())
         return;
@@ -2039,6 +2234,7 @@ void tx_cp_ul_cb(struct rte_timer *tim, void *arg)
         /* Wrap around to next second */
         if(tti == 0)
             frameId = (frameId + NUM_OF_FRAMES_PER_SECOND) & 0x3ff;
+        pOcc    = xran_occ_get(&p_MuPerDev->occTbl, tti);
 
         num_eAxc = xran_get_num_eAxcUl(pHandle);
         num_CCPorts = xran_get_num_cc(pHandle);
@@ -2047,6 +2243,15 @@ void tx_cp_ul_cb(struct rte_timer *tim, void *arg)
 
         bool useSectType3 = xran_use_sect_type_3(pDevCtx, bufId, XRAN_DIR_UL, mu);
 
+        if(pDevCtx->perMu[mu].ulDoneCbMode != XRAN_UL_DONE_CB_OFF)
+        {
+            for(ccId = 0; ccId < num_CCPorts; ccId++)
+            {
+                if(xran_isactive_cc(pDevCtx, ccId))
+                    xran_ul_done_arm_slot(pDevCtx, tti, ccId, num_eAxc, mu);
+            }
+        }
+
         /* General Uplink */
         for(antId = 0; antId < num_eAxc; antId++)
         {
@@ -2058,7 +2263,7 @@ void tx_cp_ul_cb(struct rte_timer *tim, void *arg)
 
                 /* start new section information list */
                 xran_cp_reset_section_info(pHandle, XRAN_DIR_UL, ccId, ruPortId, ctxId, mu);
-                if(xran_fs_get_slot_type(PortId, ccId, tti, XRAN_SLOT_TYPE_UL, mu) == 1)
+                if(pOcc->slotType & XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL))
                 {
                     pBufList = &(pDevCtx->perMu[mu].sFrontHaulRxPrbMapBbuIoBufCtrl[bufId][ccId][antId].sBufferList); /* To shorten reference */
                     if(pBufList->pBuffers && pBufList->pBuffers->pData)
@@ -2077,23 +2282,13 @@ void tx_cp_ul_cb(struct rte_timer *tim, void *arg)
             struct xran_prach_cp_config *pPrachCPConfig = NULL;
 
             //check for dss enable and fill based on technology select the pDevCtx->perMu[mu].PrachCPConfig NR/LTE.
-            if(pDevCtx->dssEnable){
-                int i = tti % pDevCtx->dssPeriod;
-                if(pDevCtx->technology[i]==1) {
-                    pPrachCPConfig = &(pDevCtx->perMu[mu].PrachCPConfig);
-                }
-                else{
-                    pPrachCPConfig = &(pDevCtx->perMu[mu].PrachCPConfigLTE);
-                }
-            }
-            else{
+            uint32_t prachCfg = xran_occ_prach_cfg(pDevCtx->dssEnable, pDevCtx->technology, pDevCtx->dssPeriod, tti);
+            if(prachCfg == XRAN_OCC_PRACH_CFG_LTE)
+                pPrachCPConfig = &(pDevCtx->perMu[mu].PrachCPConfigLTE);
+            else
                 pPrachCPConfig = &(pDevCtx->perMu[mu].PrachCPConfig);
-            }
-
-            uint32_t is_prach_slot = xran_is_prach_slot(PortId, sfId, slotId, mu);
 
-            if(((frameId % pPrachCPConfig->x) == pPrachCPConfig->y[0])
-                    && (is_prach_slot==1))
+            if(xran_occ_get_frame(&p_MuPerDev->occTbl, frameId, tti)->prachSym[prachCfg])
             {
                 for(antId = 0; antId < num_eAxc; antId++)
                 {
@@ -2160,7 +2355,7 @@ void tx_cp_ul_cb(struct rte_timer *tim, void *arg)
 
                     /* start new section information list */
                     xran_cp_reset_section_info(pHandle, XRAN_DIR_UL, ccId, portId, ctxId, mu);
-                    if(xran_fs_get_slot_type(PortId, ccId, tti, XRAN_SLOT_TYPE_UL, mu) == 1)
+                    if(pOcc->slotType & XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL))
                     {
                         pBufList = &(pDevCtx->perMu[mu].sFHSrsRxPrbMapBbuIoBufCtrl[bufId][ccId][antId].sBufferList); /* To shorten reference */
                         if(pBufList->pBuffers && pBufList->pBuffers->pData)
@@ -2255,10 +2450,13 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
     struct rte_mbuf* pkt_data[MBUFS_CNT], * pkt_control[MBUFS_CNT], * pkt_meas[MBUFS_CNT], *pkt_adj[MBUFS_CNT], *pkt_cfm[MBUFS_CNT];
     static uint32_t owdm_rx_first_pass = 1;
     uint32_t expected_ecpri_payload;
+    struct xran_common_counters *pCnt;
 
     if (unlikely(p_dev_ctx == NULL))
         return ret;
 
+    pCnt = xran_fh_counters(p_dev_ctx);
+
     for (i = 0; i < num; ++i)
     {
         pkt = pkt_q[i];
@@ -2273,7 +2471,7 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
             ecpri_hdr = rte_pktmbuf_mtod(pkt, struct xran_ecpri_hdr*);
             expected_ecpri_payload = rte_be_to_cpu_16(ecpri_hdr->cmnhdr.bits.ecpri_payl_size);
 
-            p_dev_ctx->fh_counters.rx_bytes_counter += rte_pktmbuf_pkt_len(pkt);
+            pCnt->rx_bytes_counter += rte_pktmbuf_pkt_len(pkt);
 
             struct radio_app_common_hdr *radio_hdr =
             rte_pktmbuf_mtod_offset(pkt, struct radio_app_common_hdr *, sizeof(*ecpri_hdr));
@@ -2287,8 +2485,8 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
             if(unlikely(xran_get_syscfg_appmode() == O_DU
                 && radio_hdr->data_feature.data_direction == XRAN_DIR_DL))
             {
-                ++p_dev_ctx->fh_counters.rx_err_drop;
-                ++p_dev_ctx->fh_counters.rx_counter;
+                ++pCnt->rx_err_drop;
+                ++pCnt->rx_counter;
                 rte_pktmbuf_free(pkt);
                 continue;
             }
@@ -2297,8 +2495,8 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
                         && ecpri_hdr->cmnhdr.bits.ecpri_mesg_type==0
                         && radio_hdr->data_feature.data_direction == XRAN_DIR_UL))
             {
-                ++p_dev_ctx->fh_counters.rx_err_drop;
-                ++p_dev_ctx->fh_counters.rx_counter;
+                ++pCnt->rx_err_drop;
+                ++pCnt->rx_counter;
                 rte_pktmbuf_free(pkt);
                 continue;
             }
@@ -2311,9 +2509,9 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
                     {
                         if(unlikely(expected_ecpri_payload != (rte_pktmbuf_pkt_len(pkt) - sizeof(union xran_ecpri_cmn_hdr))))
                         {
-                            ++p_dev_ctx->fh_counters.rx_err_ecpri;
-                            ++p_dev_ctx->fh_counters.rx_err_drop;
-                            ++p_dev_ctx->fh_counters.rx_counter;
+                            ++pCnt->rx_err_ecpri;
+                            ++pCnt->rx_err_drop;
+                            ++pCnt->rx_counter;
                             rte_pktmbuf_free(pkt);
                             continue;
                         }
@@ -2328,9 +2526,9 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
                     // ECPRI payload validation
                     if(unlikely(expected_ecpri_payload != ((rte_pktmbuf_pkt_len(pkt) - sizeof(union xran_ecpri_cmn_hdr) - 4)))) //Subtracting 4 bytes for FCS
                     {
-                        ++p_dev_ctx->fh_counters.rx_err_ecpri;
-                        ++p_dev_ctx->fh_counters.rx_err_drop;
-                        ++p_dev_ctx->fh_counters.rx_counter;
+                        ++pCnt->rx_err_ecpri;
+                        ++pCnt->rx_err_drop;
+                        ++pCnt->rx_counter;
                         rte_pktmbuf_free(pkt);
                         continue;
                     }
@@ -2345,8 +2543,8 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
                 default:
                     if(xran_get_syscfg_appmode() == O_DU)
                     {
-                        ++p_dev_ctx->fh_counters.rx_err_ecpri;
-                        ++p_dev_ctx->fh_counters.rx_err_drop;
+                        ++pCnt->rx_err_ecpri;
+                        ++pCnt->rx_err_drop;
                         rte_pktmbuf_free(pkt);
                         print_dbg("Invalid eCPRI message type - %d", ecpri_hdr->cmnhdr.bits.ecpri_mesg_type);
                     }
@@ -2396,7 +2594,7 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
             {
                 t1 = MLogXRANTick();
                 ret = process_cplane(pkt_control[i], (void*)p_dev_ctx);
-                ++p_dev_ctx->fh_counters.rx_counter;
+                ++pCnt->rx_counter;
                 if (ret == MBUF_FREE)
                     rte_pktmbuf_free(pkt_control[i]);
                 MLogXRANTask(PID_PROC_CP_PKT, t1, MLogXRANTick());
@@ -2404,8 +2602,8 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
         }
         else
         {
-            p_dev_ctx->fh_counters.rx_err_ecpri += num_control;
-            p_dev_ctx->fh_counters.rx_err_drop += num_control;
+            pCnt->rx_err_ecpri += num_control;
+            pCnt->rx_err_drop += num_control;
             print_dbg("O-DU recevied C-Plane message!");
         }
 
@@ -2431,7 +2629,7 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
                 {
                     if(xran_process_cfm_message(pkt_cfm[i], vf_id) != XRAN_STATUS_SUCCESS){
                         print_err("xran_process_cfm_message failed");
-                        p_dev_ctx->fh_counters.rx_err_drop += 1;
+                        pCnt->rx_err_drop += 1;
                     }
                 }
                 else
@@ -2446,8 +2644,10 @@ int32_t xran_handle_rx_pkts(struct rte_mbuf* pkt_q[], uint16_t xport_id, struct
     return MBUF_FREE;
 }
 
-void xran_initialize_ecpri_owd_meas_cmn(struct xran_device_ctx *ptr, int appMode)
+void xran_initialize_ecpri_owd_meas_cmn(struct xran_device_ctx *ptr, struct xran_io_cfg *p_io_cfg, int appMode)
 {
+    struct xran_ecpri_del_meas_cmn *pCfg = &p_io_cfg->eowd_cmn[appMode];
+
 //    ptr->eowd_cmn.initiator_en = 0; // Initiator 1, Recipient 0
 //    ptr->eowd_cmn.filterType = 0;  // 0 Simple average based on number of measurements
     // Set default values if the Timeout and numberOfSamples are not set
@@ -2455,6 +2655,16 @@ void xran_initialize_ecpri_owd_meas_cmn(struct xran_device_ctx *ptr, int appMode
         ptr->eowd_cmn[appMode].responseTo = 10E6; // 10 ms timeout expressed in ns
     if(ptr->eowd_cmn[appMode].numberOfSamples == 0)
         ptr->eowd_cmn[appMode].numberOfSamples = 8; // Number of samples to be averaged
+    // Delay estimator and timing window tuning
+    ptr->eowd_cmn[appMode].filterType       = pCfg->filterType;
+    ptr->eowd_cmn[appMode].owdm_pctl        = pCfg->owdm_pctl;
+    ptr->eowd_cmn[appMode].owdm_ewmaShift   = pCfg->owdm_ewmaShift;
+    ptr->eowd_cmn[appMode].owdm_guardNs     = pCfg->owdm_guardNs;
+    ptr->eowd_cmn[appMode].owdm_budgetNs    = pCfg->owdm_budgetNs;
+    ptr->eowd_cmn[appMode].owdm_maxShrinkUs = pCfg->owdm_maxShrinkUs;
+    ptr->eowd_cmn[appMode].owdm_maxGrowUs   = pCfg->owdm_maxGrowUs;
+    ptr->eowd_cmn[appMode].owdm_stepUs      = pCfg->owdm_stepUs;
+    ptr->eowd_cmn[appMode].owdm_periodMs    = pCfg->owdm_periodMs;
 }
 void xran_initialize_ecpri_owd_meas_per_port (int i, struct xran_io_cfg *ptr )
 {
@@ -2552,6 +2762,7 @@ int32_t xran_init(int argc, char *argv[],
         sysCfg->bbdevDec        = p_xran_fh_init->bbdevDec;
         sysCfg->bbdevSrsFft     = p_xran_fh_init->bbdevSrsFft;
         sysCfg->bbdevPrachIfft     = p_xran_fh_init->bbdevPrachIfft;
+        sysCfg->ruLoadGen       = p_xran_fh_init->ruLoadGen;
     }
 
     pTmCtx  = xran_timingsource_get_ctx();
@@ -2580,6 +2791,9 @@ int32_t xran_init(int argc, char *argv[],
 
         pDevCtx->numRxq         = p_io_cfg->num_rxq;
 
+        /* storage is allocated at xran_open, once CCs and eAxCs are known */
+        pDevCtx->rx_pkt_arena.nPktPerSym = xran_rx_pkt_per_sym(p_xran_fh_init->rxPktPerSym[o_xu_id]);
+
         rte_spinlock_init(&pDevCtx->spinLock);
         pDevCtx->active_CC  = 0;
         pDevCtx->active_nCC = 0;
@@ -2595,7 +2809,7 @@ int32_t xran_init(int argc, char *argv[],
         // Ecpri initialization for One Way delay measurements common variables to default values
         pDevCtx->p_o_du_addr    = p_xran_fh_init->p_o_du_addr;  /* TODO: need to revisit */
         pDevCtx->p_o_ru_addr    = p_xran_fh_init->p_o_ru_addr;  /* TODO: need to revisit */
-        xran_initialize_ecpri_owd_meas_cmn(pDevCtx, p_io_cfg->id);
+        xran_initialize_ecpri_owd_meas_cmn(pDevCtx, p_io_cfg, p_io_cfg->id);
 
         for(i = 0; i < MAX_NUM_OF_DPDK_TIMERS; i++)
             rte_timer_init(&pDevCtx->dpdk_timer[i]);
@@ -3871,8 +4085,57 @@ int32_t xran_spawn_workers(void)
         arr_job2wrk_id[i][XRAN_JOB_TYPE_SYM_CB] = 0;
     }
 
+    /* O-RU load generator: UL U-plane is built by one worker per eAxC shard */
+    if(xran_get_syscfg_appmode() == O_RU && xran_get_systemcfg()->ruLoadGen.enable)
+    {
+        uint32_t nShards = total_num_cores - 2;
+
+        if(total_num_cores < 3 || xran_get_syscfg_bbuoffload() || !fh_cfg->enableCP)
+        {
+            print_err("O-RU load generator needs C-plane, no BBU offload and at least 3 cores (%d)\n", total_num_cores);
+            return XRAN_STATUS_FAIL;
+        }
+
+        if(xran_get_systemcfg()->ruLoadGen.numShards && xran_get_systemcfg()->ruLoadGen.numShards < nShards)
+            nShards = xran_get_systemcfg()->ruLoadGen.numShards;
+
+        if(xran_ru_loadgen_init(nShards) != XRAN_STATUS_SUCCESS)
+            return XRAN_STATUS_FAIL;
+
+        /* timing core */
+        XRAN_SET_WORKER_INFO(p_worker_info[0], -1, "timing", xran_eth_trx_tasks, NULL, 1);
+        /* workers */
+        /** 0 **/
+        XRAN_SET_WORKER_INFO(p_worker_info[1],  0, "fh_rx_bbdev", ring_processing_func, NULL, 1);
+        /** 1..nShards - UP GEN **/
+        for(i = 1; i < total_num_cores - 1; i++)
+        {
+            if(i <= nShards)
+            {
+                XRAN_SET_WORKER_INFO(p_worker_info[i + 1], i, "ru_loadgen", xran_ru_loadgen_worker, (void*)(uintptr_t)(i - 1), 1);
+            }
+            else
+            {
+                XRAN_SET_WORKER_INFO(p_worker_info[i + 1], i, "not used", NULL, NULL, 1);
+            }
+        }
+
+        for(i = 0; i < numRUs; i++)
+        {
+            arr_job2wrk_id[i][XRAN_JOB_TYPE_CP_DL] = 0;
+            arr_job2wrk_id[i][XRAN_JOB_TYPE_CP_UL] = 0;
+
+            p_dev = xran_dev_get_ctx_by_id(i);
+            if(p_dev == NULL)
+            {
+                print_err("Failed to get devCtx");
+                return XRAN_STATUS_FAIL;
+            }
+            p_dev->ruLoadGen = 1;
+        }
+    }
     /* For worker task allocation treat mixed cat case as cat-B */
-    if(fh_cfg->ru_conf.xranCat == XRAN_CATEGORY_A && is_mixed_cat == 0)
+    else if(fh_cfg->ru_conf.xranCat == XRAN_CATEGORY_A && is_mixed_cat == 0)
     {
         switch(total_num_cores)
         {
@@ -4834,6 +5097,9 @@ int32_t xran_open(void *pHandle, struct xran_fh_config *pConf)
     if((ret  = xran_init_seqid(pDevCtx)) < 0)
         return ret;
 
+    if((ret  = xran_init_rx_pkt(pDevCtx)) < 0)
+        return ret;
+
     (&(pDevCtx->csirs_cfg))->csirsEaxcOffset = pConf->csirs_conf.csirsEaxcOffset;
 
     if((uint16_t)eth_ctx->io_cfg.port[XRAN_UP_VF] != 0xFFFF)    /* TODO: REVIEW */
@@ -4873,6 +5139,9 @@ int32_t xran_open(void *pHandle, struct xran_fh_config *pConf)
             pConf->frame_conf.sSlotConfig);
     }
 
+    if((ret  = xran_init_occasions(pDevCtx)) < 0)
+        return ret;
+
     /* if send_xpmbuf2ring needs to be changed from default functions,
      * then those should be set between xran_init and xran_open */
     if(pDevCtx->send_cpmbuf2ring == NULL)
@@ -5146,7 +5415,7 @@ int32_t xran_deactivate_cc(int32_t port_id, int32_t cc_id)
 
     /* Reset statisitcs */
     if(xran_get_numactiveccs_ru(pDevCtx) == 0)
-        memset(&pDevCtx->fh_counters, 0, sizeof(struct xran_common_counters));
+        xran_fh_counters_reset(pDevCtx);
 
     printf("Disable RU%d CC%d [%016lX:%d]\n", pDevCtx->xran_port_id, cc_id, pDevCtx->active_CC, pDevCtx->active_nCC);
     return(0);
@@ -5234,12 +5503,17 @@ int32_t xran_close(void *pHandle)
     }
 
     ret = xran_cp_free_sectiondb(pDevCtx);
+    xran_free_rx_pkt(pDevCtx);
+    xran_free_occasions(pDevCtx);
 
     if(xran_get_syscfg_appmode() == O_RU)
         xran_ruemul_release(pDevCtx);
 
     xran_set_deactive_ru(pDevCtx->xran_port_id);
 
+    if(xran_get_syscfg_appmode() == O_RU && xran_get_systemcfg()->active_nRU == 0)
+        xran_ru_loadgen_release();
+
     printf("XRAN Close RU%d [%d:%08X]\n", pDevCtx->xran_port_id, xran_get_systemcfg()->active_nRU, xran_get_systemcfg()->active_RU);
 
     return ret;
@@ -5685,6 +5959,7 @@ void xran_print_error_stats(struct xran_common_counters* x_counters){
     PRINT_NON_ZERO_CNTR(x_counters->rx_err_prach,"rx_err_prach","\n%12s: %u");
     PRINT_NON_ZERO_CNTR(x_counters->rx_err_cp,"rx_err_cp","\n%12s: %u");
     PRINT_NON_ZERO_CNTR(x_counters->rx_err_ecpri,"rx_err_ecpri","\n%12s: %u");
+    PRINT_NON_ZERO_CNTR(x_counters->rx_err_pkt_per_sym,"rx_err_pkt_per_sym","\n%12s: %u");
     printf("\n\n");
 }
 
@@ -5820,7 +6095,6 @@ inline int32_t timing_adjust_gps_second_ebbu_offload(struct timespec* p_time)
 inline int32_t xran_sym_poll_callback_task_ebbu_offload(void)
 {
     struct xran_device_ctx* p_dev_ctx_run = NULL;
-    struct xran_common_counters* pCnt = NULL;
     int32_t xran_port_id, i, mu;
     uint64_t tUsed;
     PXRAN_TIMER_CTX pCtx = xran_timer_get_ctx_ebbu_offload();
@@ -5839,26 +6113,7 @@ inline int32_t xran_sym_poll_callback_task_ebbu_offload(void)
                     {
                         sym_ota_cb_ebbu_offload(p_dev_ctx_run, &tUsed, mu);
                     }
-                    pCnt = &p_dev_ctx_run->fh_counters;
-                    if (pCnt->gps_second != pCtx->current_second)
-                    {
-                        if ((pCtx->current_second - pCnt->gps_second) != 1)
-                            print_dbg("second c %ld p %ld\n", pCtx->current_second, pCnt->gps_second);
-
-                        pCnt->gps_second = (uint64_t)pCtx->current_second;
-
-                        pCnt->rx_counter_pps = pCnt->rx_counter - pCnt->old_rx_counter;
-                        pCnt->old_rx_counter = pCnt->rx_counter;
-                        pCnt->tx_counter_pps = pCnt->tx_counter - pCnt->old_tx_counter;
-                        pCnt->old_tx_counter = pCnt->tx_counter;
-                        pCnt->rx_bytes_per_sec = pCnt->rx_bytes_counter;
-                        pCnt->tx_bytes_per_sec = pCnt->tx_bytes_counter;
-                        pCnt->rx_bytes_counter = 0;
-                        pCnt->tx_bytes_counter = 0;
-                        pCnt->rx_bits_per_sec = pCnt->rx_bytes_per_sec * 8 / 1000L;
-                        pCnt->tx_bits_per_sec = pCnt->tx_bytes_per_sec * 8 / 1000L;
-                        print_dbg("current_second %d\n", pCtx->current_second);
-                    }
+                    xran_fh_counters_update_rates(p_dev_ctx_run, (uint64_t)pCtx->current_second);
                 }
             }
             else  {
@@ -16,6 +16,7 @@
 *
 *******************************************************************************/
 #include <stdio.h>
+#include <string.h>
 #include <immintrin.h>
 #include "xran_mod_compression.h"
 #include "xran_compression.h"
@@ -720,22 +721,100 @@ void mod_compression_256qam_snc(int16_t *pData, int8_t *pOut, int16_t unit, int3
     }
 }
 
+/* RE mask covering every RE of an RB. A zero mask is treated the same way, matching
+ * how xran_cp_proc.c defaults reMask when prbMap leaves it unset. */
+#define MOD_COMP_RE_MASK_ALL    (0xfff)
+#define MOD_COMP_RB_CHUNK       (64)
+
+typedef void (*mod_compression_kernel_fn)(int16_t *pData, int8_t *pOut, int16_t unit, int32_t nSc);
+
+static inline int32_t
+mod_comp_re_mask_full(int16_t re_mask)
+{
+    re_mask &= MOD_COMP_RE_MASK_ALL;
+    return (re_mask == 0 || re_mask == MOD_COMP_RE_MASK_ALL);
+}
+
+/* Build the per-byte bit mask of MOD_COMP_RB_CHUNK RBs for a given RE mask. Bit i of re_mask
+ * enables RE i of every RB, each RE occupies modulation bits MSB first. */
+static void
+mod_comp_build_byte_mask(uint8_t *pMask, int16_t re_mask, int32_t modulation)
+{
+    int32_t bytes_per_rb = (XRAN_NUM_OF_SC_PER_RB * modulation) >> 3;
+    uint8_t rb_mask[XRAN_NUM_OF_SC_PER_RB] = {0};
+
+    for (int32_t re = 0; re < XRAN_NUM_OF_SC_PER_RB; re++)
+    {
+        if ((re_mask >> re) & 0x1)
+        {
+            for (int32_t bit = re * modulation; bit < (re + 1) * modulation; bit++)
+                rb_mask[bit >> 3] |= (uint8_t)(0x80 >> (bit & 0x7));
+        }
+    }
+    for (int32_t rb = 0; rb < MOD_COMP_RB_CHUNK; rb++)
+        for (int32_t i = 0; i < bytes_per_rb; i++)
+            pMask[rb * bytes_per_rb + i] = rb_mask[i];
+}
+
+/* Encode only the REs enabled in re_mask. The bits of the disabled REs are cleared, whatever
+ * pOut held before. A payload shared by sections with different RE masks is encoded once with
+ * the union of the masks. */
+static void
+mod_compression_re_mask(mod_compression_kernel_fn kernel, int16_t *pData, int8_t *pOut,
+                        int16_t unit, int32_t nSc, int32_t modulation, int16_t re_mask)
+{
+    if (mod_comp_re_mask_full(re_mask))
+    {
+        kernel(pData, pOut, unit, nSc);
+        return;
+    }
+
+    const int32_t chunk_sc = MOD_COMP_RB_CHUNK * XRAN_NUM_OF_SC_PER_RB;
+    __attribute__((aligned(64))) uint8_t byte_mask[MOD_COMP_RB_CHUNK * XRAN_NUM_OF_SC_PER_RB];
+    __attribute__((aligned(64))) int8_t  tmp_out[MOD_COMP_RB_CHUNK * XRAN_NUM_OF_SC_PER_RB + 64];
+
+    mod_comp_build_byte_mask(byte_mask, re_mask, modulation);
+
+    for (int32_t iSc = 0; iSc < nSc; iSc += chunk_sc)
+    {
+        int32_t num_sc = (nSc - iSc) < chunk_sc ? (nSc - iSc) : chunk_sc;
+        int32_t num_bytes = (num_sc * modulation + 7) >> 3;
+
+        memset(tmp_out, 0, num_bytes);
+        kernel(pData + 2 * iSc, tmp_out, unit, num_sc);
+
+        for (int32_t i = 0; i < num_bytes; i += 64)
+        {
+            int32_t left = num_bytes - i;
+            __mmask64 k = (left >= 64) ? (__mmask64)-1 : (((__mmask64)1 << left) - 1);
+            __m512i enc  = _mm512_maskz_loadu_epi8(k, tmp_out + i);
+            __m512i sel  = _mm512_maskz_loadu_epi8(k, byte_mask + i);
+            _mm512_mask_storeu_epi8(pOut + i, k, _mm512_and_si512(enc, sel));
+        }
+        pOut += num_bytes;
+    }
+}
+
 int xranlib_5gnr_mod_compression_snc(const struct xranlib_5gnr_mod_compression_request* request,
         struct xranlib_5gnr_mod_compression_response* response){
 
     switch(request->modulation)
     {
       case XRAN_QPSK:
-          mod_compression_qpsk_avx512(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_qpsk_avx512, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QPSK, request->re_mask);
       break;
       case XRAN_QAM16:
-          mod_compression_16qam_snc(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_16qam_snc, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QAM16, request->re_mask);
       break;
       case XRAN_QAM64:
-          mod_compression_64qam_snc(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_64qam_snc, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QAM64, request->re_mask);
       break;
        case XRAN_QAM256:
-          mod_compression_256qam_snc(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_256qam_snc, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QAM256, request->re_mask);
       break;
       default:
           printf("Error invalid modulation compression request\n");
@@ -763,16 +842,20 @@ int xranlib_5gnr_mod_compression_c(const struct xranlib_5gnr_mod_compression_req
     switch(request->modulation)
     {
       case XRAN_QPSK:
-          mod_compression_qpsk_c(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_qpsk_c, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QPSK, request->re_mask);
       break;
       case XRAN_QAM16:
-          mod_compression_16qam_c(request->data_in, response->data_out, request->unit,request->num_symbols);
+          mod_compression_re_mask(mod_compression_16qam_c, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QAM16, request->re_mask);
       break;
       case XRAN_QAM64:
-          mod_compression_64qam_c(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_64qam_c, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QAM64, request->re_mask);
       break;
        case XRAN_QAM256:
-          mod_compression_256qam_c(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_256qam_c, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QAM256, request->re_mask);
       break;
       default:
           printf("Error invalid modulation compression request\n");
@@ -787,16 +870,20 @@ int xranlib_5gnr_mod_compression_avx512(const struct xranlib_5gnr_mod_compressio
     switch(request->modulation)
     {
       case XRAN_QPSK:
-          mod_compression_qpsk_avx512(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_qpsk_avx512, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QPSK, request->re_mask);
       break;
       case XRAN_QAM16:
-          mod_compression_16qam_avx512(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_16qam_avx512, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QAM16, request->re_mask);
       break;
       case XRAN_QAM64:
-          mod_compression_64qam_avx512(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_64qam_avx512, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QAM64, request->re_mask);
       break;
        case XRAN_QAM256:
-          mod_compression_256qam_avx512(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_compression_re_mask(mod_compression_256qam_avx512, request->data_in, response->data_out, request->unit,
+                  request->num_symbols, XRAN_QAM256, request->re_mask);
       break;
       default:
           printf("Error invalid modulation compression request\n");
@@ -811,10 +898,11 @@ mod_decompression_qpsk_c(int8_t *pData,int16_t *pOut,int16_t unit, int32_t nSc ,
     int16_t symbol_unit[2] = {0};
     symbol_unit[0] = (unit>>1);
     symbol_unit[1] = (unit>>1)*-1;
+    int32_t re_mask_full = mod_comp_re_mask_full(re_mask);
     for (int32_t iSc = 0 ; iSc<nSc ; iSc ++)
     {
         uint8_t mask_pos= iSc %12;
-        if (1 == ((re_mask >> mask_pos)&0x1))
+        if (re_mask_full || (1 == ((re_mask >> mask_pos)&0x1)))
         {
             uint8_t symbol_pos= iSc &0x3;
             uint32_t byte_pos= iSc >>2;
@@ -827,15 +915,18 @@ mod_decompression_qpsk_c(int8_t *pData,int16_t *pOut,int16_t unit, int32_t nSc ,
 }
 
 void
-mod_decompression_16qam_c(int8_t *pData,int16_t *pOut,int16_t unit, int32_t nSc)
+mod_decompression_16qam_c(int8_t *pData,int16_t *pOut,int16_t unit, int32_t nSc ,int16_t re_mask)
 {
     int16_t symbol_unit[4] = {0};
     symbol_unit[0] = (unit>>2);
     symbol_unit[1] = (unit>>2)*3;
     symbol_unit[3] = (unit>>2)*-1;
     symbol_unit[2] = (unit>>2)*-3;
+    int32_t re_mask_full = mod_comp_re_mask_full(re_mask);
     for (int32_t iSc = 0 ; iSc<nSc ; iSc ++)
     {
+        if (!re_mask_full && (0 == ((re_mask >> (iSc %12))&0x1)))
+            continue;
         uint8_t symbol_pos= iSc &0x1;
         uint32_t byte_pos= iSc >>1;
         uint8_t bit_i = (pData[byte_pos]>>(6-(symbol_pos*4)))&0x3;
@@ -846,7 +937,7 @@ mod_decompression_16qam_c(int8_t *pData,int16_t *pOut,int16_t unit, int32_t nSc)
 }
 
 void
-mod_decompression_64qam_c(int8_t *pData,int16_t *pOut,int16_t unit, int32_t nSc)
+mod_decompression_64qam_c(int8_t *pData,int16_t *pOut,int16_t unit, int32_t nSc ,int16_t re_mask)
 {
     int16_t symbol_unit[8] = {0};
     symbol_unit[0] = (unit>>3);
@@ -858,6 +949,7 @@ mod_decompression_64qam_c(int8_t *pData,int16_t *pOut,int16_t unit, int32_t nSc)
     symbol_unit[5] = (unit>>3)*-5;
     symbol_unit[4] = (unit>>3)*-7;
     uint8_t bit_i , bit_q ;
+    int32_t re_mask_full = mod_comp_re_mask_full(re_mask);
     for (int32_t iSc = 0 ; iSc<nSc ; iSc ++)
     {
         uint8_t symbol_pos= iSc %4;
@@ -882,13 +974,15 @@ mod_decompression_64qam_c(int8_t *pData,int16_t *pOut,int16_t unit, int32_t nSc)
             bit_q = pData[2]&0x7;
             pData +=3;
         }
+        if (!re_mask_full && (0 == ((re_mask >> (iSc %12))&0x1)))
+            continue;
         pOut[iSc*2] = symbol_unit[bit_i];
         pOut[iSc*2+1] = symbol_unit[bit_q];
     }
 }
 
 void
-mod_decompression_256qam_c(int8_t *pData,int16_t *pOut,int16_t unit,int32_t nSc)
+mod_decompression_256qam_c(int8_t *pData,int16_t *pOut,int16_t unit,int32_t nSc ,int16_t re_mask)
 {
     int16_t symbol_unit[16] = {0};
     symbol_unit[0] = (unit>>4);
@@ -907,8 +1001,11 @@ mod_decompression_256qam_c(int8_t *pData,int16_t *pOut,int16_t unit,int32_t nSc)
     symbol_unit[10] = (unit>>4)*-11;
     symbol_unit[9] = (unit>>4)*-13;
     symbol_unit[8] = (unit>>4)*-15;
+    int32_t re_mask_full = mod_comp_re_mask_full(re_mask);
     for (int32_t iSc = 0 ; iSc<nSc ; iSc ++)
     {
+        if (!re_mask_full && (0 == ((re_mask >> (iSc %12))&0x1)))
+            continue;
         uint8_t bit_i = (pData[iSc]>>4)&0xF;
         uint8_t bit_q = pData[iSc]&0xF;
         pOut[iSc*2] = symbol_unit[bit_i];
@@ -916,7 +1013,109 @@ mod_decompression_256qam_c(int8_t *pData,int16_t *pOut,int16_t unit,int32_t nSc)
     }
 }
 
-int xranlib_5gnr_mod_decompression(const struct xranlib_5gnr_mod_decompression_request* request,
+/* Byte permutation for the modulation decompression: 16-bit lane j receives the big endian
+ * word holding bit field j (bitWidth bits per I or Q component), so a per-lane left shift
+ * followed by an arithmetic right shift yields the sign extended constellation index. */
+template<int bitWidth>
+static inline __m512i
+mod_decomp_byte_permute()
+{
+    __attribute__((aligned(64))) int8_t idx[64];
+    for (int32_t j = 0; j < 32; j++)
+    {
+        int32_t byte_pos = (j * bitWidth) >> 3;
+        idx[2*j]     = (int8_t)(byte_pos + 1);
+        idx[2*j + 1] = (int8_t)byte_pos;
+    }
+    return _mm512_load_si512((const void *)idx);
+}
+
+template<int bitWidth>
+static inline __m512i
+mod_decomp_bit_shift()
+{
+    __attribute__((aligned(64))) int16_t shift[32];
+    for (int32_t j = 0; j < 32; j++)
+        shift[j] = (int16_t)((j * bitWidth) & 0x7);
+    return _mm512_load_si512((const void *)shift);
+}
+
+/* Decompress 16 REs per iteration. Each constellation index c (bitWidth bits, sign extended)
+ * maps to (2c+1)*unit/2^bitWidth, which matches the symbol_unit tables of the C reference.
+ * Only the REs enabled in re_mask are written, as in mod_decompression_qpsk_c. */
+template<int bitWidth>
+static void
+mod_decompression_avx512(int8_t *pData, int16_t *pOut, int16_t unit, int32_t nSc, int16_t re_mask)
+{
+    const int32_t in_bytes = 4 * bitWidth;
+    const __m512i byte_permute = mod_decomp_byte_permute<bitWidth>();
+    const __m512i bit_shift = mod_decomp_bit_shift<bitWidth>();
+    const int16_t step = (int16_t)(unit >> bitWidth);
+    const __m512i step1 = _mm512_set1_epi16(step);
+    const __m512i step2 = _mm512_set1_epi16((int16_t)(step * 2));
+    /* 48 RE pattern of the RB mask, so any 16 RE window starting at a multiple of 4 is a shift */
+    uint64_t re_pattern = 0xffffffffffffULL;
+    int32_t re_pos = 0;
+    int32_t iSc;
+
+    if (!mod_comp_re_mask_full(re_mask))
+    {
+        uint64_t m = (uint64_t)(re_mask & MOD_COMP_RE_MASK_ALL);
+        re_pattern = m | (m << 12) | (m << 24) | (m << 36);
+    }
+
+    for (iSc = 0; iSc + 16 <= nSc; iSc += 16)
+    {
+        __m512i in = _mm512_maskz_loadu_epi8(((__mmask64)1 << in_bytes) - 1, pData);
+        __m512i word = _mm512_permutexvar_epi8(byte_permute, in);
+        __m512i idx = _mm512_srai_epi16(_mm512_sllv_epi16(word, bit_shift), 16 - bitWidth);
+        __m512i out = _mm512_add_epi16(_mm512_mullo_epi16(idx, step2), step1);
+        _mm512_mask_storeu_epi32(pOut, (__mmask16)(re_pattern >> re_pos), out);
+        pData += in_bytes;
+        pOut += 32;
+        re_pos += 4;
+        if (re_pos == 12)
+            re_pos = 0;
+    }
+
+    if (iSc < nSc)
+    {
+        int32_t left_sc = nSc - iSc;
+        int32_t left_bytes = (left_sc * 2 * bitWidth + 7) >> 3;
+        __mmask16 k = (__mmask16)((re_pattern >> re_pos) & ((1u << left_sc) - 1));
+        __m512i in = _mm512_maskz_loadu_epi8(((__mmask64)1 << left_bytes) - 1, pData);
+        __m512i word = _mm512_permutexvar_epi8(byte_permute, in);
+        __m512i idx = _mm512_srai_epi16(_mm512_sllv_epi16(word, bit_shift), 16 - bitWidth);
+        __m512i out = _mm512_add_epi16(_mm512_mullo_epi16(idx, step2), step1);
+        _mm512_mask_storeu_epi32(pOut, k, out);
+    }
+}
+
+void
+mod_decompression_qpsk_avx512(int8_t *pData, int16_t *pOut, int16_t unit, int32_t nSc, int16_t re_mask)
+{
+    mod_decompression_avx512<1>(pData, pOut, unit, nSc, re_mask);
+}
+
+void
+mod_decompression_16qam_avx512(int8_t *pData, int16_t *pOut, int16_t unit, int32_t nSc, int16_t re_mask)
+{
+    mod_decompression_avx512<2>(pData, pOut, unit, nSc, re_mask);
+}
+
+void
+mod_decompression_64qam_avx512(int8_t *pData, int16_t *pOut, int16_t unit, int32_t nSc, int16_t re_mask)
+{
+    mod_decompression_avx512<3>(pData, pOut, unit, nSc, re_mask);
+}
+
+void
+mod_decompression_256qam_avx512(int8_t *pData, int16_t *pOut, int16_t unit, int32_t nSc, int16_t re_mask)
+{
+    mod_decompression_avx512<4>(pData, pOut, unit, nSc, re_mask);
+}
+
+int xranlib_5gnr_mod_decompression_c(const struct xranlib_5gnr_mod_decompression_request* request,
         struct xranlib_5gnr_mod_decompression_response* response){
 
     switch(request->modulation)
@@ -925,13 +1124,13 @@ int xranlib_5gnr_mod_decompression(const struct xranlib_5gnr_mod_decompression_r
           mod_decompression_qpsk_c(request->data_in, response->data_out, request->unit, request->num_symbols, request->re_mask);
       break;
       case XRAN_QAM16:
-          mod_decompression_16qam_c(request->data_in, response->data_out, request->unit,request->num_symbols);
+          mod_decompression_16qam_c(request->data_in, response->data_out, request->unit, request->num_symbols, request->re_mask);
       break;
       case XRAN_QAM64:
-          mod_decompression_64qam_c(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_decompression_64qam_c(request->data_in, response->data_out, request->unit, request->num_symbols, request->re_mask);
       break;
        case XRAN_QAM256:
-          mod_decompression_256qam_c(request->data_in, response->data_out, request->unit, request->num_symbols);
+          mod_decompression_256qam_c(request->data_in, response->data_out, request->unit, request->num_symbols, request->re_mask);
       break;
       default:
           printf("Error invalid modulation compression request\n");
@@ -940,4 +1139,35 @@ int xranlib_5gnr_mod_decompression(const struct xranlib_5gnr_mod_decompression_r
     return XRAN_STATUS_SUCCESS;
 }
 
+int xranlib_5gnr_mod_decompression_avx512(const struct xranlib_5gnr_mod_decompression_request* request,
+        struct xranlib_5gnr_mod_decompression_response* response){
 
+    switch(request->modulation)
+    {
+      case XRAN_QPSK:
+          mod_decompression_qpsk_avx512(request->data_in, response->data_out, request->unit, request->num_symbols, request->re_mask);
+      break;
+      case XRAN_QAM16:
+          mod_decompression_16qam_avx512(request->data_in, response->data_out, request->unit, request->num_symbols, request->re_mask);
+      break;
+      case XRAN_QAM64:
+          mod_decompression_64qam_avx512(request->data_in, response->data_out, request->unit, request->num_symbols, request->re_mask);
+      break;
+       case XRAN_QAM256:
+          mod_decompression_256qam_avx512(request->data_in, response->data_out, request->unit, request->num_symbols, request->re_mask);
+      break;
+      default:
+          printf("Error invalid modulation compression request\n");
+          return XRAN_STATUS_FAIL;
+    }
+    return XRAN_STATUS_SUCCESS;
+}
+
+int xranlib_5gnr_mod_decompression(const struct xranlib_5gnr_mod_decompression_request* request,
+        struct xranlib_5gnr_mod_decompression_response* response){
+#ifdef C_Module_Used
+    return (xranlib_5gnr_mod_decompression_c(request, response));
+#else
+    return (xranlib_5gnr_mod_decompression_avx512(request, response));
+#endif
+}
@@ -44,7 +44,7 @@ struct xranlib_5gnr_mod_compression_request
     /*! Supported modulation values are: 2 (QPSK), 4 (16QAM), 6 (64QAM), 8 (256QAM). */
     enum xran_modulation_order modulation;
     int32_t num_symbols;  /*!< Number of complex input symbols. */
-    int16_t re_mask;  /*!< RE mask in one RB. */
+    int16_t re_mask;  /*!< RE mask in one RB, bit i enables RE i. 0 or 0xfff selects all REs. */
 };
 
 /*!
@@ -67,7 +67,7 @@ struct xranlib_5gnr_mod_decompression_request
     /*! Supported modulation values are: 2 (QPSK), 4 (16QAM), 6 (64QAM), 8 (256QAM). */
     enum xran_modulation_order modulation;
     int32_t num_symbols;  /*!< Number of complex input symbols. */
-    int16_t re_mask;  /*!< RE mask in one RB. */
+    int16_t re_mask;  /*!< RE mask in one RB, bit i enables RE i. 0 or 0xfff selects all REs. */
 };
 
 /*!
@@ -94,4 +94,8 @@ int xranlib_5gnr_mod_compression_c(const struct xranlib_5gnr_mod_compression_req
         struct xranlib_5gnr_mod_compression_response* response);
 int xranlib_5gnr_mod_decompression(const struct xranlib_5gnr_mod_decompression_request* request,
     struct xranlib_5gnr_mod_decompression_response* response);
+int xranlib_5gnr_mod_decompression_avx512(const struct xranlib_5gnr_mod_decompression_request* request,
+    struct xranlib_5gnr_mod_decompression_response* response);
+int xranlib_5gnr_mod_decompression_c(const struct xranlib_5gnr_mod_decompression_request* request,
+    struct xranlib_5gnr_mod_decompression_response* response);
 
@@ -0,0 +1,187 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief XRAN per slot PRACH, SRS and TDD pattern table
+ * @file xran_occasion.h
+ * @ingroup group_source_xran
+ * @author Intel Corporation
+ *
+ * What the slot and symbol callbacks need to know about a slot, whether it
+ * is UL, DL or special, which symbols carry UL, DL, PRACH or SRS, repeats
+ * every numFrames frames. xran_open() compiles it per port and numerology
+ * into one entry per slot of that period:
+ *
+ *     pSlot[(frame % numFrames) * slots per frame + subframe * slots per subframe + slot]
+ *
+ * with a bit per symbol in the masks of the entry, so the decisions of a
+ * symbol are a lookup by tti instead of calls to xran_fs_get_slot_type(),
+ * xran_fs_get_symbol_type() and xran_is_prach_slot() with their frame
+ * checks. numFrames is the least common multiple of the PRACH frame periods
+ * x and of the frames the TDD period takes to realign on a frame. When that
+ * does not divide the SFN cycle the table covers the cycle, widened to a
+ * multiple of x, and a tti past the cycle still lands on the entry of its
+ * wrapped value.
+ *
+ * The callers take the PRACH frame condition on the frame id they send,
+ * the ORAN one or the SFN, which is not always the frame of the tti, so
+ * PRACH is looked up by frame id and slot with xran_occ_get_frame() and the
+ * rest by tti with xran_occ_get(). x divides numFrames, any frame id works.
+ *
+ * The TDD pattern is the one of CC 0, xran_open() configures every CC of a
+ * port with the same one.
+ **/
+
+#ifndef _XRAN_OCCASION_H_
+#define _XRAN_OCCASION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "xran_fh_o_du.h"
+
+/* slotType bits, XRAN_OCC_SLOT(XRAN_SLOT_TYPE_x) is set when xran_fs_get_slot_type(x) is 1 */
+#define XRAN_OCC_SLOT(type)         (1 << (type))
+#define XRAN_OCC_SLOT_SRS           (1 << XRAN_SLOT_TYPE_LAST)  /**< SRS slot of the TDD period, UL or special */
+
+#define XRAN_OCC_PRACH_CFG          (0)     /**< prachSym of PrachCPConfig */
+#define XRAN_OCC_PRACH_CFG_LTE      (1)     /**< prachSym of PrachCPConfigLTE, DSS only */
+#define XRAN_OCC_PRACH_NUM          (2)
+
+#define XRAN_OCC_SYM_ALL            ((1 << XRAN_NUM_OF_SYMBOL_PER_SLOT) - 1)
+
+/** a slot of the period */
+struct xran_occ_slot
+{
+    uint16_t prachSym[XRAN_OCC_PRACH_NUM];  /**< symbols of the PRACH occasions, 0 when not a PRACH slot of the frame */
+    uint16_t srsSym;        /**< SRS symbols of the SRS slot */
+    uint16_t ulSym;         /**< UL or FDD symbols */
+    uint16_t dlSym;         /**< DL or FDD symbols */
+    uint8_t  slotType;      /**< XRAN_OCC_SLOT_* */
+    uint8_t  rsvd[5];
+};
+
+/** table of a port and numerology */
+struct xran_occ_tbl
+{
+    struct xran_occ_slot *pSlot;
+    uint32_t numSlots;      /**< numFrames * slots per frame */
+    uint32_t numFrames;
+    uint32_t slotsPerFrame;
+};
+
+static inline uint32_t xran_occ_gcd(uint32_t a, uint32_t b)
+{
+    uint32_t t;
+
+    while(b)
+    {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static inline uint32_t xran_occ_lcm(uint32_t a, uint32_t b)
+{
+    if(a == 0 || b == 0)
+        return a ? a : b;
+    return a / xran_occ_gcd(a, b) * b;
+}
+
+/**
+ * @brief Frames of the period of the table
+ *
+ * @param pX PRACH frame periods, 0 for no PRACH
+ * @param numX number of periods
+ * @param tddPeriod TDD period in slots, 0 or 1 for FDD
+ * @param slotsPerFrame slots per frame of the numerology
+ * @param maxFrames frames of a full SFN cycle
+ * @return frames, maxFrames when the TDD period does not divide the SFN cycle
+ */
+static inline uint32_t xran_occ_num_frames(const uint8_t *pX, uint32_t numX, uint32_t tddPeriod,
+                uint32_t slotsPerFrame, uint32_t maxFrames)
+{
+    uint32_t prachFrames = 1, frames, i;
+
+    for(i = 0; i < numX; i++)
+        prachFrames = xran_occ_lcm(prachFrames, pX[i]);
+
+    frames = prachFrames;
+    if(tddPeriod > 1)
+        frames = xran_occ_lcm(frames, tddPeriod / xran_occ_gcd(tddPeriod, slotsPerFrame));
+
+    /* the pattern does not realign at the SFN wrap */
+    if(maxFrames % frames)
+        frames = xran_occ_lcm(maxFrames, prachFrames);
+
+    return frames;
+}
+
+/** symbols first to last of a slot */
+static inline uint16_t xran_occ_sym_mask(uint32_t first, uint32_t last)
+{
+    if(first > last || first >= XRAN_NUM_OF_SYMBOL_PER_SLOT)
+        return 0;
+    if(last >= XRAN_NUM_OF_SYMBOL_PER_SLOT)
+        last = XRAN_NUM_OF_SYMBOL_PER_SLOT - 1;
+    return (uint16_t)(((1 << (last + 1)) - 1) & ~((1 << first) - 1));
+}
+
+/**
+ * @brief Entry of a slot
+ *
+ * @param pTbl table of the port and numerology
+ * @param tti slot counted from frame 0 of the SFN cycle
+ * @return entry of the slot
+ */
+static inline const struct xran_occ_slot *xran_occ_get(const struct xran_occ_tbl *pTbl, uint32_t tti)
+{
+    return &pTbl->pSlot[tti % pTbl->numSlots];
+}
+
+/**
+ * @brief Entry of a slot of a frame, for prachSym
+ *
+ * @param pTbl table of the port and numerology
+ * @param frameId ORAN frame id or SFN
+ * @param tti slot, only the slot in the frame is used
+ * @return entry of the slot
+ */
+static inline const struct xran_occ_slot *xran_occ_get_frame(const struct xran_occ_tbl *pTbl, uint32_t frameId, uint32_t tti)
+{
+    return &pTbl->pSlot[(frameId % pTbl->numFrames) * pTbl->slotsPerFrame + tti % pTbl->slotsPerFrame];
+}
+
+/** PRACH configuration a tti uses, see PrachCPConfig and PrachCPConfigLTE */
+static inline uint32_t xran_occ_prach_cfg(int32_t dssEnable, const uint8_t *pTechnology, uint32_t dssPeriod, uint32_t tti)
+{
+    if(dssEnable && pTechnology[tti % dssPeriod] != 1)
+        return XRAN_OCC_PRACH_CFG_LTE;
+    return XRAN_OCC_PRACH_CFG;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _XRAN_OCCASION_H_ */
@@ -0,0 +1,275 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief XRAN one-way delay estimator and timing window controller
+ * @file xran_owd_estimator.h
+ * @ingroup group_source_xran
+ * @author Intel Corporation
+ *
+ * A measurement run gives numberOfSamples delays. The first samples are
+ * warm-up and dropped. Samples further than XRAN_OWD_OUTLIER_MADS median
+ * absolute deviations from the median are rejected (a timestamp taken late
+ * or a clock step), the rest give the mean, the minimum, a percentile and an
+ * EWMA carried over runs. filterType selects the one reported.
+ *
+ * The windows were dimensioned for a transport delay of owdm_budgetNs. The
+ * headroom left by the estimate plus owdm_guardNs is how far the transport
+ * dependent windows can be tightened, and a negative headroom is how far
+ * they must be widened, bounded by owdm_maxShrinkUs and owdm_maxGrowUs.
+ *
+ * Every measurement is a step of the controller. The windows only move when
+ * the target leaves a band of XRAN_OWD_WINDOW_HYST_US around the adjustment
+ * in place, so a jittery estimate does not make them flap, and a tightening
+ * is limited to owdm_stepUs per step. A widening is applied at once.
+ *
+ * The first step is taken after the start-up measurement, before
+ * xran_timing_create_cbs() derives the timer offsets from the windows. With
+ * owdm_periodMs set, the delay is measured again every period, and a step
+ * moving the windows re-creates the timing callbacks at the start of a slot,
+ * see xran_timing_update_cbs().
+ *
+ * The adjustment moves T1a_max_up, T1a_min_up, T1a_max_cp_dl, T1a_max_cp_ul,
+ * Ta4_min and Ta4_max of every numerology of the port. These are the O-DU
+ * windows that include the fronthaul transport delay.
+**/
+
+#ifndef _XRAN_OWD_ESTIMATOR_H_
+#define _XRAN_OWD_ESTIMATOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "xran_fh_o_du.h"
+
+#define XRAN_OWD_SKIP_SAMPLES       (2)     /**< warm-up samples of a run */
+#define XRAN_OWD_PCTL_DEFAULT       (90)
+#define XRAN_OWD_EWMA_SHIFT         (3)     /**< weight 1/8 */
+#define XRAN_OWD_OUTLIER_MADS       (5)     /**< about 3.4 sigma for normal jitter */
+#define XRAN_OWD_MAD_FLOOR_NS       (500)   /**< deviation always accepted, the MAD of a quiet link is ~0 */
+#define XRAN_OWD_WINDOW_HYST_US     (2)     /**< smallest move of the windows */
+
+/** statistics of a measurement run */
+struct xran_owd_estimate
+{
+    uint64_t avg;
+    uint64_t min;
+    uint64_t pctl;
+    uint64_t ewma;          /**< in: EWMA of the previous runs, 0 for none */
+    uint32_t numKept;
+    uint32_t numOutliers;
+};
+
+static inline uint64_t xran_owd_absdiff(uint64_t a, uint64_t b)
+{
+    return (a > b) ? a - b : b - a;
+}
+
+/** insertion sort, runs have MX_NUM_SAMPLES samples at most */
+static inline void xran_owd_sort(uint64_t *p, uint32_t num)
+{
+    uint32_t i, j;
+    uint64_t v;
+
+    for(i = 1; i < num; i++)
+    {
+        v = p[i];
+        for(j = i; j > 0 && p[j - 1] > v; j--)
+            p[j] = p[j - 1];
+        p[j] = v;
+    }
+}
+
+/**
+ * @brief Estimate the one-way delay of a measurement run
+ *
+ * @param pSamples delays of the run in ns, in the order measured
+ * @param num number of samples, up to MX_NUM_SAMPLES
+ * @param pctl percentile to report, 1 to 100, 0 for XRAN_OWD_PCTL_DEFAULT
+ * @param ewmaShift EWMA weight of a sample is 1/2^ewmaShift, 0 for XRAN_OWD_EWMA_SHIFT
+ * @param pEst statistics, ewma carries the EWMA of the previous runs
+ * @return 0 on success, -1 without samples
+ */
+static inline int32_t xran_owd_estimate(const uint64_t *pSamples, uint32_t num, uint32_t pctl, uint32_t ewmaShift,
+                struct xran_owd_estimate *pEst)
+{
+    uint64_t sorted[MX_NUM_SAMPLES], dev[MX_NUM_SAMPLES];
+    uint64_t median, limit, sum = 0;
+    uint32_t skip, n, i, lo, hi, idx;
+    int64_t ewma = (int64_t)pEst->ewma;
+
+    if(num > MX_NUM_SAMPLES)
+        num = MX_NUM_SAMPLES;
+    skip = (num > XRAN_OWD_SKIP_SAMPLES) ? XRAN_OWD_SKIP_SAMPLES : 0;
+    n    = num - skip;
+    if(n == 0)
+        return -1;
+
+    pctl      = (pctl == 0 || pctl > 100) ? XRAN_OWD_PCTL_DEFAULT : pctl;
+    ewmaShift = ewmaShift ? ewmaShift : XRAN_OWD_EWMA_SHIFT;
+
+    for(i = 0; i < n; i++)
+        sorted[i] = pSamples[skip + i];
+    xran_owd_sort(sorted, n);
+    median = (n & 1) ? sorted[n / 2] : sorted[n / 2 - 1] + (sorted[n / 2] - sorted[n / 2 - 1]) / 2;
+
+    for(i = 0; i < n; i++)
+        dev[i] = xran_owd_absdiff(sorted[i], median);
+    xran_owd_sort(dev, n);
+    limit = dev[n / 2] * XRAN_OWD_OUTLIER_MADS;
+    if(limit < XRAN_OWD_MAD_FLOOR_NS)
+        limit = XRAN_OWD_MAD_FLOOR_NS;
+
+    /* the samples kept are a contiguous range of the sorted ones */
+    for(lo = 0; lo < n && xran_owd_absdiff(sorted[lo], median) > limit; lo++)
+        ;
+    for(hi = n; hi > lo && xran_owd_absdiff(sorted[hi - 1], median) > limit; hi--)
+        ;
+
+    pEst->numKept     = hi - lo;
+    pEst->numOutliers = n - pEst->numKept;
+    for(i = lo; i < hi; i++)
+        sum += sorted[i];
+    pEst->avg  = sum / pEst->numKept;
+    pEst->min  = sorted[lo];
+    idx        = (pctl * pEst->numKept + 99) / 100;     /* nearest rank */
+    pEst->pctl = sorted[lo + (idx ? idx - 1 : 0)];
+
+    for(i = skip; i < num; i++)
+    {
+        if(xran_owd_absdiff(pSamples[i], median) > limit)
+            continue;
+        if(ewma == 0)
+            ewma = (int64_t)pSamples[i];
+        else
+            ewma += ((int64_t)pSamples[i] - ewma) / (1 << ewmaShift);
+    }
+    pEst->ewma = (uint64_t)ewma;
+
+    return 0;
+}
+
+/**
+ * @brief Delay reported for a filter type
+ *
+ * @param pEst statistics of the run
+ * @param filterType XRAN_OWD_FILTER_*
+ * @return delay in ns
+ */
+static inline uint64_t xran_owd_select(const struct xran_owd_estimate *pEst, uint32_t filterType)
+{
+    switch(filterType)
+    {
+        case XRAN_OWD_FILTER_MIN:
+            return pEst->min;
+        case XRAN_OWD_FILTER_PCTL:
+            return pEst->pctl;
+        case XRAN_OWD_FILTER_EWMA:
+            return pEst->ewma;
+        case XRAN_OWD_FILTER_AVG:
+        default:
+            return pEst->avg;
+    }
+}
+
+/**
+ * @brief Timing window adjustment for a delay estimate
+ *
+ * @param pCmn measurement configuration, owdm_budgetNs 0 leaves the windows as they are
+ * @param delayNs delay estimate
+ * @return adjustment in us, > 0 tightened and < 0 widened
+ */
+static inline int32_t xran_owd_window_target(const struct xran_ecpri_del_meas_cmn *pCmn, uint64_t delayNs)
+{
+    int64_t headroom, target;
+
+    if(pCmn->owdm_budgetNs == 0)
+        return 0;
+
+    /* whole us, rounded toward wider windows */
+    headroom = (int64_t)pCmn->owdm_budgetNs - (int64_t)(delayNs + pCmn->owdm_guardNs);
+    target   = (headroom >= 0) ? headroom / 1000 : -((-headroom + 999) / 1000);
+
+    if(target > (int64_t)pCmn->owdm_maxShrinkUs)
+        target = pCmn->owdm_maxShrinkUs;
+    if(target < -(int64_t)pCmn->owdm_maxGrowUs)
+        target = -(int64_t)pCmn->owdm_maxGrowUs;
+
+    return (int32_t)target;
+}
+
+/**
+ * @brief One step of the timing window controller
+ *
+ * @param pCmn measurement configuration
+ * @param targetUs adjustment for the last estimate, see xran_owd_window_target()
+ * @param curUs adjustment in place, > 0 tightened and < 0 widened
+ * @return new adjustment in us, curUs while the target stays in the band
+ */
+static inline int32_t xran_owd_window_step(const struct xran_ecpri_del_meas_cmn *pCmn, int32_t targetUs, int32_t curUs)
+{
+    if(targetUs - curUs < XRAN_OWD_WINDOW_HYST_US && curUs - targetUs < XRAN_OWD_WINDOW_HYST_US)
+        return curUs;
+
+    if(targetUs > curUs && pCmn->owdm_stepUs && targetUs - curUs > pCmn->owdm_stepUs)
+        targetUs = curUs + pCmn->owdm_stepUs;
+
+    return targetUs;
+}
+
+/**
+ * @brief Move the transport dependent windows of a numerology
+ *
+ * All the windows move together so the width of every one is kept. A
+ * tightening is limited to what the smallest window allows.
+ *
+ * @param pMu windows of the numerology
+ * @param appliedUs adjustment already applied to pMu
+ * @param adjUs adjustment wanted, > 0 tightened and < 0 widened
+ * @return adjustment applied
+ */
+static inline int32_t xran_owd_window_apply(xran_fh_per_mu_cfg *pMu, int32_t appliedUs, int32_t adjUs)
+{
+    uint16_t *pWin[] = { &pMu->T1a_max_up, &pMu->T1a_min_up, &pMu->T1a_max_cp_dl, &pMu->T1a_max_cp_ul,
+                         &pMu->Ta4_min, &pMu->Ta4_max };
+    int32_t room = INT16_MAX, delta;
+    uint32_t i;
+
+    /* windows as configured are the current ones plus what was taken off */
+    for(i = 0; i < sizeof(pWin) / sizeof(pWin[0]); i++)
+        if((int32_t)*pWin[i] + appliedUs < room)
+            room = (int32_t)*pWin[i] + appliedUs;
+
+    if(adjUs > room)
+        adjUs = room;
+
+    delta = adjUs - appliedUs;
+    for(i = 0; i < sizeof(pWin) / sizeof(pWin[0]); i++)
+        *pWin[i] = (uint16_t)((int32_t)*pWin[i] - delta);
+
+    return adjUs;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _XRAN_OWD_ESTIMATOR_H_ */
@@ -0,0 +1,482 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief XRAN O-RU load generator
+ * @file xran_ru_loadgen.c
+ * @ingroup group_source_xran
+ * @author Intel Corporation
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <err.h>
+#include <immintrin.h>
+
+#include <rte_common.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_ring.h>
+
+#include "xran_fh_o_du.h"
+#include "xran_ethdi.h"
+#include "xran_pkt.h"
+#include "xran_up_api.h"
+#include "xran_cp_api.h"
+#include "xran_common.h"
+#include "xran_dev.h"
+#include "xran_cp_proc.h"
+#include "xran_compression.h"
+#include "xran_printf.h"
+#include "xran_ru_loadgen.h"
+
+/* payloads: uncompressed, BFP and modulation compression of 1 to 16 bits */
+#define XRAN_RU_LOADGEN_TPL_NUM     (1 + 16 + 16)
+#define XRAN_RU_LOADGEN_TPL_LEN     (XRAN_MAX_PRBS * (3 * 16 + 1))
+#define XRAN_RU_LOADGEN_BURST       (16)
+
+/** one symbol of a port for the eAxCs of a shard */
+struct xran_ru_loadgen_job
+{
+    struct xran_device_ctx *pDev;
+    PSECTION_DB_TYPE pDb;
+    uint8_t  ctx_id;
+    uint8_t  mu;
+    uint8_t  frame_id;
+    uint8_t  subframe_id;
+    uint8_t  slot_id;
+    uint8_t  sym_id;
+    uint8_t  num_cc;
+    uint8_t  ant_start;
+    uint8_t  ant_num;
+};
+
+struct xran_ru_loadgen_stats
+{
+    uint64_t jobs;
+    uint64_t pkts;
+    uint64_t bytes;
+    uint64_t act[XRAN_RU_LOADGEN_ACT_MAX];
+    uint64_t noMbuf;
+    uint64_t noPayload;
+};
+
+struct xran_ru_loadgen_shard
+{
+    struct rte_ring *pWork;     /* jobs posted by the symbol timer */
+    struct rte_ring *pFree;     /* jobs returned by the worker */
+    struct xran_ru_loadgen_job *pJobs;
+    uint64_t rand;
+    struct xran_ru_loadgen_reorder reorder;
+    struct xran_ru_loadgen_stats stats;     /* written by the worker only */
+} __rte_cache_aligned;
+
+struct xran_ru_loadgen_ctx
+{
+    uint32_t nShards;
+    struct xran_ru_loadgen_cfg cfg;
+    uint8_t *pPayload[XRAN_RU_LOADGEN_TPL_NUM];
+    uint64_t jobDrop[XRAN_RU_LOADGEN_MAX_SHARDS];  /* written by the symbol timer only */
+    struct xran_ru_loadgen_shard shard[XRAN_RU_LOADGEN_MAX_SHARDS];
+};
+
+static struct xran_ru_loadgen_ctx gLoadGen;
+
+static int32_t xran_ru_loadgen_tpl(uint8_t compMeth, uint8_t iqWidth)
+{
+    if(iqWidth == 0 || iqWidth > 16)
+        return -1;
+
+    switch(compMeth)
+    {
+        case XRAN_COMPMETHOD_NONE:
+            return 0;
+        case XRAN_COMPMETHOD_BLKFLOAT:
+            return iqWidth;
+        case XRAN_COMPMETHOD_MODULATION:
+            return 16 + iqWidth;
+        default:
+            return -1;
+    }
+}
+
+/* compress random IQs once per method and width, sections send a prefix of them */
+static int32_t xran_ru_loadgen_build_payloads(uint64_t *pRand)
+{
+    struct xranlib_compress_request  req;
+    struct xranlib_compress_response rsp;
+    int16_t  *pIq;
+    uint16_t *pMod;
+    uint32_t i;
+    uint8_t  iqWidth;
+
+    for(i = 0; i < XRAN_RU_LOADGEN_TPL_NUM; i++)
+    {
+        gLoadGen.pPayload[i] = (uint8_t *)xran_zmalloc("ru_loadgen_payload", XRAN_RU_LOADGEN_TPL_LEN, 64);
+        if(gLoadGen.pPayload[i] == NULL)
+        {
+            print_err("payload allocation failed");
+            return XRAN_STATUS_FAIL;
+        }
+    }
+
+    /* uncompressed payload is the IQs themselves */
+    pIq = (int16_t *)gLoadGen.pPayload[0];
+    for(i = 0; i < XRAN_RU_LOADGEN_TPL_LEN / sizeof(int16_t); i++)
+        pIq[i] = (int16_t)(xran_ru_loadgen_rand(pRand) >> 19) - 4096;
+
+    for(iqWidth = 1; iqWidth <= 16; iqWidth++)
+    {
+        memset(&req, 0, sizeof(req));
+        memset(&rsp, 0, sizeof(rsp));
+        req.data_in         = pIq;
+        req.numRBs          = XRAN_MAX_PRBS;
+        req.numDataElements = 24;
+        req.compMethod      = XRAN_COMPMETHOD_BLKFLOAT;
+        req.iqWidth         = iqWidth;
+        req.len             = XRAN_MAX_PRBS * XRAN_NUM_OF_SC_PER_RB * 4;
+        rsp.data_out        = (int8_t *)gLoadGen.pPayload[xran_ru_loadgen_tpl(XRAN_COMPMETHOD_BLKFLOAT, iqWidth)];
+
+        if(xranlib_compress(&req, &rsp) != XRAN_STATUS_SUCCESS)
+        {
+            print_err("BFP compression of %u bits failed", iqWidth);
+            return XRAN_STATUS_FAIL;
+        }
+
+        /* any bit pattern is a valid constellation point */
+        pMod = (uint16_t *)gLoadGen.pPayload[xran_ru_loadgen_tpl(XRAN_COMPMETHOD_MODULATION, iqWidth)];
+        for(i = 0; i < XRAN_RU_LOADGEN_TPL_LEN / sizeof(uint16_t); i++)
+            pMod[i] = (uint16_t)xran_ru_loadgen_rand(pRand);
+    }
+
+    return XRAN_STATUS_SUCCESS;
+}
+
+int32_t xran_ru_loadgen_init(uint32_t nShards)
+{
+    struct xran_ru_loadgen_shard *pShard;
+    char name[RTE_RING_NAMESIZE];
+    uint64_t rand;
+    uint32_t i, j;
+
+    if(gLoadGen.nShards)
+    {
+        print_err("load generator already started");
+        return XRAN_STATUS_FAIL;
+    }
+
+    if(nShards == 0 || nShards > XRAN_RU_LOADGEN_MAX_SHARDS)
+    {
+        print_err("invalid number of shards %u", nShards);
+        return XRAN_STATUS_INVALID_PARAM;
+    }
+
+    memset(&gLoadGen, 0, sizeof(gLoadGen));
+    gLoadGen.cfg = xran_get_systemcfg()->ruLoadGen;
+
+    if(xran_ru_loadgen_check(&gLoadGen.cfg))
+    {
+        print_err("impairment rates exceed %u ppm", XRAN_RU_LOADGEN_PPM);
+        return XRAN_STATUS_INVALID_PARAM;
+    }
+
+    rand = xran_ru_loadgen_seed(gLoadGen.cfg.seed, XRAN_RU_LOADGEN_MAX_SHARDS);
+    if(xran_ru_loadgen_build_payloads(&rand) != XRAN_STATUS_SUCCESS)
+    {
+        xran_ru_loadgen_release();
+        return XRAN_STATUS_FAIL;
+    }
+
+    for(i = 0; i < nShards; i++)
+    {
+        pShard = &gLoadGen.shard[i];
+        pShard->rand = xran_ru_loadgen_seed(gLoadGen.cfg.seed, i);
+
+        snprintf(name, sizeof(name), "ru_loadgen_w%u", i);
+        pShard->pWork = rte_ring_create(name, XRAN_RU_LOADGEN_JOBS, rte_socket_id(), RING_F_SC_DEQ | RING_F_EXACT_SZ);
+        snprintf(name, sizeof(name), "ru_loadgen_f%u", i);
+        pShard->pFree = rte_ring_create(name, XRAN_RU_LOADGEN_JOBS, rte_socket_id(), RING_F_SP_ENQ | RING_F_EXACT_SZ);
+        pShard->pJobs = (struct xran_ru_loadgen_job *)xran_zmalloc("ru_loadgen_jobs",
+                                sizeof(struct xran_ru_loadgen_job) * XRAN_RU_LOADGEN_JOBS, 64);
+        gLoadGen.nShards = i + 1;
+
+        if(pShard->pWork == NULL || pShard->pFree == NULL || pShard->pJobs == NULL)
+        {
+            print_err("shard %u allocation failed", i);
+            xran_ru_loadgen_release();
+            return XRAN_STATUS_FAIL;
+        }
+
+        for(j = 0; j < XRAN_RU_LOADGEN_JOBS; j++)
+            rte_ring_enqueue(pShard->pFree, &pShard->pJobs[j]);
+    }
+
+    printf("O-RU load generator: %u shards, loss %u early %u (%u sym) late %u (%u sym) reorder %u ppm\n",
+        nShards, gLoadGen.cfg.lossPpm, gLoadGen.cfg.earlyPpm, gLoadGen.cfg.earlySym,
+        gLoadGen.cfg.latePpm, gLoadGen.cfg.lateSym, gLoadGen.cfg.reorderPpm);
+
+    return XRAN_STATUS_SUCCESS;
+}
+
+void xran_ru_loadgen_release(void)
+{
+    struct xran_ru_loadgen_shard *pShard;
+    struct xran_ru_loadgen_stats *pStats;
+    uint32_t i;
+
+    for(i = 0; i < gLoadGen.nShards; i++)
+    {
+        pShard = &gLoadGen.shard[i];
+        pStats = &pShard->stats;
+
+        printf("O-RU load generator shard %u: jobs %lu dropped %lu pkts %lu bytes %lu lost %lu early %lu late %lu reordered %lu no mbuf %lu no payload %lu\n",
+            i, pStats->jobs, gLoadGen.jobDrop[i], pStats->pkts, pStats->bytes,
+            pStats->act[XRAN_RU_LOADGEN_LOSS], pStats->act[XRAN_RU_LOADGEN_EARLY],
+            pStats->act[XRAN_RU_LOADGEN_LATE], pStats->act[XRAN_RU_LOADGEN_REORDER],
+            pStats->noMbuf, pStats->noPayload);
+
+        if(pShard->pWork)
+            rte_ring_free(pShard->pWork);
+        if(pShard->pFree)
+            rte_ring_free(pShard->pFree);
+        if(pShard->pJobs)
+            xran_free(pShard->pJobs);
+    }
+
+    for(i = 0; i < XRAN_RU_LOADGEN_TPL_NUM; i++)
+    {
+        if(gLoadGen.pPayload[i])
+            xran_free(gLoadGen.pPayload[i]);
+    }
+
+    memset(&gLoadGen, 0, sizeof(gLoadGen));
+}
+
+int32_t xran_ru_loadgen_dispatch(void* pHandle, uint8_t ctx_id, uint32_t tti, int32_t start_cc, int32_t num_cc, int32_t start_ant, int32_t num_ant,
+    uint32_t frame_id, uint32_t subframe_id, uint32_t slot_id, uint32_t sym_id, enum xran_comp_hdr_type compType, enum xran_pkt_dir direction,
+    uint16_t xran_port_id, PSECTION_DB_TYPE p_sec_db, uint8_t mu, uint32_t tti_for_ring, uint32_t sym_id_for_ring, bool isVmu)
+{
+    struct xran_ru_loadgen_shard *pShard;
+    struct xran_ru_loadgen_job *pJob;
+    uint32_t shard, start, num;
+
+    if(unlikely(direction != XRAN_DIR_UL || isVmu || start_cc != 0))
+        return 0;
+
+    for(shard = 0; shard < gLoadGen.nShards; shard++)
+    {
+        num = xran_ru_loadgen_shard(num_ant, gLoadGen.nShards, shard, &start);
+        if(num == 0)
+            continue;
+
+        pShard = &gLoadGen.shard[shard];
+        if(unlikely(rte_ring_dequeue(pShard->pFree, (void **)&pJob) != 0))
+        {
+            /* the worker is a full ring behind */
+            gLoadGen.jobDrop[shard]++;
+            continue;
+        }
+
+        pJob->pDev          = (struct xran_device_ctx *)pHandle;
+        pJob->pDb           = p_sec_db;
+        pJob->ctx_id        = ctx_id;
+        pJob->mu            = mu;
+        pJob->frame_id      = (uint8_t)frame_id;
+        pJob->subframe_id   = (uint8_t)subframe_id;
+        pJob->slot_id       = (uint8_t)slot_id;
+        pJob->sym_id        = (uint8_t)sym_id;
+        pJob->num_cc        = (uint8_t)num_cc;
+        pJob->ant_start     = (uint8_t)(start_ant + start);
+        pJob->ant_num       = (uint8_t)num;
+
+        rte_ring_enqueue(pShard->pWork, pJob);
+    }
+
+    return 1;
+}
+
+static inline void xran_ru_loadgen_send(struct xran_ru_loadgen_shard *pShard, struct xran_device_ctx *p_dev,
+                struct rte_mbuf *mb, uint16_t vf)
+{
+    struct xran_common_counters *pCnt = xran_fh_counters(p_dev);
+    uint32_t len = rte_pktmbuf_pkt_len(mb);
+
+    p_dev->send_upmbuf2ring(mb, ETHER_TYPE_ECPRI, vf);
+
+    pShard->stats.pkts++;
+    pShard->stats.bytes += len;
+    pCnt->tx_counter++;
+    pCnt->tx_bytes_counter += len;
+}
+
+static void xran_ru_loadgen_section(struct xran_ru_loadgen_shard *pShard, const struct xran_ru_loadgen_job *pJob,
+                uint8_t cc_id, uint8_t ant_id, const struct xran_section_info *sectinfo)
+{
+    struct xran_device_ctx *p_dev = pJob->pDev;
+    const struct xran_ru_loadgen_cfg *pCfg = &gLoadGen.cfg;
+    enum xran_comp_hdr_type staticEn = p_dev->fh_cfg.ru_conf.xranCompHdrType;
+    enum xran_ru_loadgen_act act;
+    struct rte_mbuf *mb;
+    struct rte_mbuf *out[2];
+    uint16_t outVf[2];
+    uint32_t hdr_len, maxPrb, nPrb, prb, n, i;
+    int32_t  n_bytes, tpl;
+    uint8_t  frame_id, subframe_id, slot_id, sym_id;
+    uint8_t  seq_id;
+    uint16_t vf;
+    char *pChar;
+
+    const uint8_t compMeth = sectinfo->compMeth;
+    const uint8_t iqWidth  = (sectinfo->iqWidth == 0) ? 16 : sectinfo->iqWidth;
+
+    tpl = xran_ru_loadgen_tpl(compMeth, iqWidth);
+    if(unlikely(tpl < 0))
+    {
+        pShard->stats.noPayload++;
+        return;
+    }
+
+    hdr_len = sizeof(struct xran_ecpri_hdr)
+                + sizeof(struct radio_app_common_hdr)
+                + sizeof(struct data_section_hdr);
+    if((compMeth != XRAN_COMPMETHOD_NONE) && (staticEn == XRAN_COMP_HDR_TYPE_DYNAMIC))
+        hdr_len += sizeof(struct data_section_compression_hdr);
+
+    maxPrb  = xran_ru_loadgen_max_prb(p_dev->mtu, hdr_len, xran_get_iqdata_len(1, iqWidth, compMeth));
+    vf      = xran_map_ecpriPcid_to_vf(p_dev, XRAN_DIR_UL, cc_id, ant_id);
+
+    for(prb = 0; prb < sectinfo->numPrbc; prb += nPrb)
+    {
+        nPrb = RTE_MIN(maxPrb, (uint32_t)(sectinfo->numPrbc - prb));
+
+        /* taken by every packet, lost ones leave a gap */
+        seq_id  = xran_get_upul_seqid(p_dev->xran_port_id, cc_id, ant_id);
+        act     = xran_ru_loadgen_pick(pCfg, xran_ru_loadgen_rand(&pShard->rand));
+        pShard->stats.act[act]++;
+        if(act == XRAN_RU_LOADGEN_LOSS)
+            continue;
+
+        frame_id    = pJob->frame_id;
+        subframe_id = pJob->subframe_id;
+        slot_id     = pJob->slot_id;
+        sym_id      = pJob->sym_id;
+        if(act == XRAN_RU_LOADGEN_EARLY)
+            xran_ru_loadgen_shift(pCfg->earlySym, SLOTNUM_PER_SUBFRAME_MU(pJob->mu), &frame_id, &subframe_id, &slot_id, &sym_id);
+        else if(act == XRAN_RU_LOADGEN_LATE)
+            xran_ru_loadgen_shift(-(int32_t)pCfg->lateSym, SLOTNUM_PER_SUBFRAME_MU(pJob->mu), &frame_id, &subframe_id, &slot_id, &sym_id);
+
+        n_bytes = xran_get_iqdata_len(nPrb, iqWidth, compMeth);
+
+        mb = xran_ethdi_mbuf_alloc();
+        if(unlikely(mb == NULL))
+        {
+            pShard->stats.noMbuf++;
+            continue;
+        }
+
+        if(unlikely(rte_pktmbuf_append(mb, hdr_len + n_bytes) == NULL
+                    || rte_pktmbuf_prepend(mb, sizeof(struct rte_ether_hdr)) == NULL))
+        {
+            rte_pktmbuf_free(mb);
+            pShard->stats.noMbuf++;
+            continue;
+        }
+
+        pChar = rte_pktmbuf_mtod(mb, char *);
+        memcpy(pChar + sizeof(struct rte_ether_hdr) + hdr_len, gLoadGen.pPayload[tpl], n_bytes);
+
+        prepare_symbol_ex(XRAN_DIR_UL, sectinfo->id, mb, gLoadGen.pPayload[tpl],
+                        compMeth, iqWidth, p_dev->fh_cfg.ru_conf.byteOrder,
+                        frame_id, subframe_id, slot_id, sym_id,
+                        sectinfo->startPrbc + prb, nPrb, cc_id, ant_id, seq_id,
+                        1, staticEn, 1, 0, pJob->mu, false, XRAN_GET_OXU_PORT_ID(p_dev));
+
+        n = xran_ru_loadgen_reorder(&pShard->reorder, mb, vf, act == XRAN_RU_LOADGEN_REORDER, (void **)out, outVf);
+        for(i = 0; i < n; i++)
+            xran_ru_loadgen_send(pShard, p_dev, out[i], outVf[i]);
+    }
+}
+
+static void xran_ru_loadgen_run(struct xran_ru_loadgen_shard *pShard, const struct xran_ru_loadgen_job *pJob)
+{
+    struct xran_sectioninfo_db *ptr_sect_elm;
+    struct xran_section_info *sectinfo;
+    struct rte_mbuf *mb;
+    uint32_t next;
+    uint16_t vf;
+    uint8_t cc_id, ant_id;
+
+    pShard->stats.jobs++;
+
+    for(cc_id = 0; cc_id < pJob->num_cc; cc_id++)
+    {
+        if(!xran_isactive_cc(pJob->pDev, cc_id))
+            continue;
+
+        for(ant_id = pJob->ant_start; ant_id < pJob->ant_start + pJob->ant_num; ant_id++)
+        {
+            ptr_sect_elm = xran_sectiondb_elm(pJob->pDb, pJob->ctx_id, XRAN_DIR_UL, cc_id, ant_id);
+            if(unlikely(ptr_sect_elm == NULL))
+                continue;
+
+            for(next = 0; next < ptr_sect_elm->cur_index; next++)
+            {
+                sectinfo = &ptr_sect_elm->list[next];
+
+                /* only supports type 1, 3 */
+                if(unlikely(sectinfo->type != XRAN_CP_SECTIONTYPE_1 && sectinfo->type != XRAN_CP_SECTIONTYPE_3))
+                    continue;
+                /* skip, if not scheduled */
+                if(pJob->sym_id < sectinfo->startSymId || pJob->sym_id >= sectinfo->startSymId + sectinfo->numSymbol)
+                    continue;
+
+                xran_ru_loadgen_section(pShard, pJob, cc_id, ant_id, sectinfo);
+            }
+
+            /* a packet is only reordered within its eAxC */
+            mb = (struct rte_mbuf *)xran_ru_loadgen_flush(&pShard->reorder, &vf);
+            if(mb)
+                xran_ru_loadgen_send(pShard, pJob->pDev, mb, vf);
+        }
+    }
+}
+
+/** worker task of a shard, arg is the shard index */
+int32_t xran_ru_loadgen_worker(void *arg)
+{
+    struct xran_ru_loadgen_job *jobs[XRAN_RU_LOADGEN_BURST];
+    struct xran_ru_loadgen_shard *pShard;
+    uint32_t shard = (uint32_t)(uintptr_t)arg;
+    uint32_t n, i;
+
+    if(unlikely(shard >= gLoadGen.nShards))
+        return 0;
+
+    pShard = &gLoadGen.shard[shard];
+    n = rte_ring_dequeue_burst(pShard->pWork, (void **)jobs, RTE_DIM(jobs), NULL);
+    for(i = 0; i < n; i++)
+        xran_ru_loadgen_run(pShard, jobs[i]);
+
+    if(n)
+        rte_ring_enqueue_burst(pShard->pFree, (void **)jobs, n, NULL);
+
+    if(XRAN_STOPPED == xran_if_current_state)
+        return -1;
+
+    return 0;
+}
@@ -0,0 +1,296 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief XRAN O-RU load generator
+ * @file xran_ru_loadgen.h
+ * @ingroup group_source_xran
+ * @author Intel Corporation
+ *
+ * In load generator mode the O-RU does not build UL U-plane packets on the
+ * symbol timer. The timer only posts a job per eAxC shard, and each shard is
+ * served by its own worker core. The worker walks the C-plane sections
+ * received for its eAxCs and sends them out of payloads compressed once at
+ * start up, so the packet rate scales with the number of worker cores.
+ *
+ * Every packet draws one impairment out of the configured rates:
+ *
+ *     [0, loss) [loss, +early) [+early, +late) [+late, +reorder) none
+ *
+ * A lost packet still takes its seqId, so the O-DU sees the gap. Early and
+ * late packets are sent on time with the timestamp of a later or earlier
+ * symbol, which is what the O-DU reception window sees of a packet sent
+ * ahead of or behind its symbol. A reordered packet is held back and sent
+ * after the next packet of its eAxC.
+ **/
+
+#ifndef _XRAN_RU_LOADGEN_H_
+#define _XRAN_RU_LOADGEN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "xran_fh_o_du.h"
+#include "xran_cp_api.h"
+
+#if !(defined(SUBFRAMES_PER_SYSTEMFRAME))
+#define  SUBFRAMES_PER_SYSTEMFRAME 10
+#endif
+
+#define XRAN_RU_LOADGEN_MAX_SHARDS  (XRAN_MAX_FH_CORES)
+#define XRAN_RU_LOADGEN_JOBS        (256)       /**< symbol jobs in flight per shard */
+#define XRAN_RU_LOADGEN_PPM         (1000000)
+#define XRAN_RU_LOADGEN_SEED        (0x9E3779B97F4A7C15ULL)
+
+/** impairment of one packet */
+enum xran_ru_loadgen_act
+{
+    XRAN_RU_LOADGEN_SEND = 0,
+    XRAN_RU_LOADGEN_LOSS,
+    XRAN_RU_LOADGEN_EARLY,
+    XRAN_RU_LOADGEN_LATE,
+    XRAN_RU_LOADGEN_REORDER,
+    XRAN_RU_LOADGEN_ACT_MAX
+};
+
+/** packet held back by a reorder */
+struct xran_ru_loadgen_reorder
+{
+    void     *held;
+    uint16_t heldVf;
+};
+
+/**
+ * @brief Check the impairment rates
+ *
+ * @param pCfg load generator configuration
+ * @return 0 if the rates add up to one million packets or less, -1 otherwise
+ */
+static inline int32_t xran_ru_loadgen_check(const struct xran_ru_loadgen_cfg *pCfg)
+{
+    uint64_t total = (uint64_t)pCfg->lossPpm + pCfg->earlyPpm + pCfg->latePpm + pCfg->reorderPpm;
+
+    return (total > XRAN_RU_LOADGEN_PPM) ? -1 : 0;
+}
+
+/**
+ * @brief Seed of the impairment pattern of a shard
+ *
+ * @param seed configured seed, 0 for the default
+ * @param shard shard index
+ * @return non zero generator state
+ */
+static inline uint64_t xran_ru_loadgen_seed(uint32_t seed, uint32_t shard)
+{
+    uint64_t state = (seed ? seed : XRAN_RU_LOADGEN_SEED) + (uint64_t)(shard + 1) * XRAN_RU_LOADGEN_SEED;
+
+    return state ? state : XRAN_RU_LOADGEN_SEED;
+}
+
+/** xorshift64*, one generator per shard */
+static inline uint32_t xran_ru_loadgen_rand(uint64_t *pState)
+{
+    uint64_t x = *pState;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *pState = x;
+
+    return (uint32_t)((x * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+/**
+ * @brief eAxCs of a shard, consecutive and balanced to one eAxC
+ *
+ * @param num number of eAxCs
+ * @param nShards number of shards
+ * @param shard shard index
+ * @param pStart first eAxC of the shard, relative to the first of the port
+ * @return number of eAxCs of the shard
+ */
+static inline uint32_t xran_ru_loadgen_shard(uint32_t num, uint32_t nShards, uint32_t shard, uint32_t *pStart)
+{
+    uint32_t base, extra;
+
+    if(nShards == 0 || shard >= nShards)
+    {
+        *pStart = num;
+        return 0;
+    }
+
+    base    = num / nShards;
+    extra   = num % nShards;
+    *pStart = shard * base + ((shard < extra) ? shard : extra);
+
+    return base + ((shard < extra) ? 1 : 0);
+}
+
+/**
+ * @brief Impairment of a packet
+ *
+ * @param pCfg load generator configuration
+ * @param r random draw
+ * @return impairment to apply
+ */
+static inline enum xran_ru_loadgen_act xran_ru_loadgen_pick(const struct xran_ru_loadgen_cfg *pCfg, uint32_t r)
+{
+    uint32_t ppm = r % XRAN_RU_LOADGEN_PPM;
+    uint32_t limit;
+
+    limit = pCfg->lossPpm;
+    if(ppm < limit)
+        return XRAN_RU_LOADGEN_LOSS;
+    limit += pCfg->earlyPpm;
+    if(ppm < limit)
+        return XRAN_RU_LOADGEN_EARLY;
+    limit += pCfg->latePpm;
+    if(ppm < limit)
+        return XRAN_RU_LOADGEN_LATE;
+    limit += pCfg->reorderPpm;
+    if(ppm < limit)
+        return XRAN_RU_LOADGEN_REORDER;
+
+    return XRAN_RU_LOADGEN_SEND;
+}
+
+/**
+ * @brief Move an O-RAN timestamp by a number of symbols
+ *
+ * The frame ID is 8 bits, so the time wraps every 256 frames.
+ *
+ * @param shift symbols to add, negative to go back
+ * @param slotsPerSf slots per subframe of the numerology
+ * @param pFrame frame ID
+ * @param pSubframe subframe ID
+ * @param pSlot slot ID
+ * @param pSym symbol ID
+ */
+static inline void xran_ru_loadgen_shift(int32_t shift, uint32_t slotsPerSf,
+                uint8_t *pFrame, uint8_t *pSubframe, uint8_t *pSlot, uint8_t *pSym)
+{
+    const int64_t symPerFrame = (int64_t)SUBFRAMES_PER_SYSTEMFRAME * slotsPerSf * XRAN_NUM_OF_SYMBOL_PER_SLOT;
+    const int64_t period      = 256 * symPerFrame;
+    int64_t idx;
+
+    idx = (((int64_t)*pFrame * SUBFRAMES_PER_SYSTEMFRAME + *pSubframe) * slotsPerSf + *pSlot) * XRAN_NUM_OF_SYMBOL_PER_SLOT + *pSym;
+    idx = (idx + shift % period + period) % period;
+
+    *pSym       = (uint8_t)(idx % XRAN_NUM_OF_SYMBOL_PER_SLOT);
+    idx        /= XRAN_NUM_OF_SYMBOL_PER_SLOT;
+    *pSlot      = (uint8_t)(idx % slotsPerSf);
+    idx        /= slotsPerSf;
+    *pSubframe  = (uint8_t)(idx % SUBFRAMES_PER_SYSTEMFRAME);
+    *pFrame     = (uint8_t)(idx / SUBFRAMES_PER_SYSTEMFRAME);
+}
+
+/**
+ * @brief PRBs of a section fitting in one packet
+ *
+ * @param mtu MTU of the port
+ * @param hdrLen eCPRI, radio application and section headers
+ * @param prbLen bytes of one PRB
+ * @return PRBs per packet, at least one
+ */
+static inline uint32_t xran_ru_loadgen_max_prb(uint32_t mtu, uint32_t hdrLen, uint32_t prbLen)
+{
+    uint32_t nPrb;
+
+    if(prbLen == 0 || mtu <= hdrLen)
+        return 1;
+
+    nPrb = (mtu - hdrLen) / prbLen;
+
+    return nPrb ? nPrb : 1;
+}
+
+/**
+ * @brief Queue a packet of an eAxC through the reorder slot
+ *
+ * A held packet goes out right after the packet that follows it. Only one
+ * packet is held at a time, a packet asking to be held while the slot is
+ * taken is sent in order.
+ *
+ * @param pReorder reorder slot of the eAxC being sent
+ * @param pkt packet
+ * @param vf VF of the packet
+ * @param hold hold the packet back
+ * @param out packets to send, in order
+ * @param outVf VFs of the packets to send
+ * @return number of packets to send, 0 if the packet was held
+ */
+static inline uint32_t xran_ru_loadgen_reorder(struct xran_ru_loadgen_reorder *pReorder, void *pkt, uint16_t vf,
+                bool hold, void *out[2], uint16_t outVf[2])
+{
+    uint32_t n = 0;
+
+    if(hold && pReorder->held == NULL)
+    {
+        pReorder->held   = pkt;
+        pReorder->heldVf = vf;
+        return 0;
+    }
+
+    out[n]   = pkt;
+    outVf[n] = vf;
+    n++;
+
+    if(pReorder->held)
+    {
+        out[n]   = pReorder->held;
+        outVf[n] = pReorder->heldVf;
+        n++;
+        pReorder->held = NULL;
+    }
+
+    return n;
+}
+
+/**
+ * @brief Release the held packet at the end of the eAxC
+ *
+ * @param pReorder reorder slot
+ * @param pVf VF of the packet
+ * @return held packet, NULL if none
+ */
+static inline void *xran_ru_loadgen_flush(struct xran_ru_loadgen_reorder *pReorder, uint16_t *pVf)
+{
+    void *pkt = pReorder->held;
+
+    *pVf = pReorder->heldVf;
+    pReorder->held = NULL;
+
+    return pkt;
+}
+
+int32_t xran_ru_loadgen_init(uint32_t nShards);
+void xran_ru_loadgen_release(void);
+int32_t xran_ru_loadgen_worker(void *arg);
+int32_t xran_ru_loadgen_dispatch(void* pHandle, uint8_t ctx_id, uint32_t tti, int32_t start_cc, int32_t num_cc, int32_t start_ant, int32_t num_ant,
+    uint32_t frame_id, uint32_t subframe_id, uint32_t slot_id, uint32_t sym_id, enum xran_comp_hdr_type compType, enum xran_pkt_dir direction,
+    uint16_t xran_port_id, PSECTION_DB_TYPE p_sec_db, uint8_t mu, uint32_t tti_for_ring, uint32_t sym_id_for_ring, bool isVmu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _XRAN_RU_LOADGEN_H_ */
@@ -0,0 +1,228 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief XRAN per symbol RX packet descriptors
+ * @file xran_rx_pkt.h
+ * @ingroup group_source_xran
+ * @author Intel Corporation
+ *
+ * The U-plane sections received on a symbol are handed to L1 through the
+ * xran_rx_packet_ctl of the PRB map. Its arrays live in a single arena per
+ * port, sized at xran_open from the packets per symbol set at xran_init and
+ * the configured CCs and eAxCs, with one cache line aligned block per
+ * (numerology, type, buffer, CC, eAxC, symbol). The block keeps the arrays
+ * of one symbol next to each other:
+ *
+ *     nRBStart[n] nRBSize[n] nSectid[n] | pData[n] | pCtrl[n]
+ *
+ * The arrays of a symbol are bound on its first packet, as L1 may copy a PRB
+ * map template over the map between slots. A block is only used by the PRB
+ * map of its buffer, CC and eAxC, so mbufs still referenced by pCtrl are
+ * found and released when the entry is reused.
+ **/
+
+#ifndef _XRAN_RX_PKT_H_
+#define _XRAN_RX_PKT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <rte_branch_prediction.h>
+
+#include "xran_fh_o_du.h"
+
+#define XRAN_RX_PKT_PER_SYM_MAX     (1024)  /**< upper bound of the configurable packets per symbol */
+#define XRAN_RX_PKT_BLOCK_ALIGN     (64)    /**< symbols of different eAxC do not share a cache line */
+
+/** PRB map families receiving U-plane packets */
+enum xran_rx_pkt_type
+{
+    XRAN_RX_PKT_PUSCH = 0,
+    XRAN_RX_PKT_PRACH,
+    XRAN_RX_PKT_SRS,
+    XRAN_RX_PKT_CSIRS,
+    XRAN_RX_PKT_TYPE_MAX
+};
+
+/** descriptor storage of one port */
+struct xran_rx_pkt_arena
+{
+    uint8_t  *pBase;                                        /**< single allocation, NULL before xran_open */
+    uint64_t size;                                          /**< bytes allocated */
+    uint32_t nPktPerSym;                                    /**< packets per symbol and eAxC */
+    uint32_t blockSize;                                     /**< bytes per symbol */
+    uint16_t nCc[XRAN_RX_PKT_TYPE_MAX];                     /**< CCs with storage */
+    uint16_t nAnt[XRAN_RX_PKT_TYPE_MAX];                    /**< eAxCs with storage */
+    uint32_t muMask;                                        /**< numerologies with storage, bit per mu */
+    uint64_t offset[XRAN_MAX_NUM_MU][XRAN_RX_PKT_TYPE_MAX]; /**< start of each numerology and type */
+};
+
+/**
+ * @brief Resolve the configured packets per symbol
+ *
+ * @param nPktPerSym configured value, 0 for XRAN_MAX_RX_PKT_PER_SYM
+ * @return packets per symbol in [1, XRAN_RX_PKT_PER_SYM_MAX]
+ */
+static inline uint32_t xran_rx_pkt_per_sym(uint32_t nPktPerSym)
+{
+    if(nPktPerSym == 0)
+        return XRAN_MAX_RX_PKT_PER_SYM;
+    return (nPktPerSym > XRAN_RX_PKT_PER_SYM_MAX) ? XRAN_RX_PKT_PER_SYM_MAX : nPktPerSym;
+}
+
+static inline uint32_t xran_rx_pkt_align(uint32_t size, uint32_t align)
+{
+    return (size + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief Lay out the arena of a port, no memory is allocated
+ *
+ * @param pArena arena to lay out
+ * @param nPktPerSym packets per symbol, from xran_rx_pkt_per_sym()
+ * @param pMu configured numerologies
+ * @param numMu number of configured numerologies
+ * @param nCc CCs per type
+ * @param nAnt eAxCs per type, 0 for a type not received
+ * @return bytes needed by the arena
+ */
+static inline uint64_t xran_rx_pkt_arena_layout(struct xran_rx_pkt_arena *pArena, uint32_t nPktPerSym,
+                const uint8_t *pMu, uint32_t numMu,
+                const uint16_t nCc[XRAN_RX_PKT_TYPE_MAX], const uint16_t nAnt[XRAN_RX_PKT_TYPE_MAX])
+{
+    uint64_t size = 0;
+    uint32_t i, type;
+
+    pArena->pBase       = NULL;
+    pArena->nPktPerSym  = nPktPerSym;
+    pArena->muMask      = 0;
+    pArena->blockSize   = xran_rx_pkt_align(xran_rx_pkt_align(3 * sizeof(uint16_t) * nPktPerSym, sizeof(void *))
+                                            + 2 * sizeof(void *) * nPktPerSym, XRAN_RX_PKT_BLOCK_ALIGN);
+
+    for(type = 0; type < XRAN_RX_PKT_TYPE_MAX; type++)
+    {
+        pArena->nCc[type]  = nCc[type];
+        pArena->nAnt[type] = nAnt[type];
+    }
+
+    for(i = 0; i < numMu; i++)
+    {
+        if(pMu[i] >= XRAN_MAX_NUM_MU || (pArena->muMask & (1U << pMu[i])))
+            continue;
+        pArena->muMask |= 1U << pMu[i];
+        for(type = 0; type < XRAN_RX_PKT_TYPE_MAX; type++)
+        {
+            pArena->offset[pMu[i]][type] = size;
+            size += (uint64_t)XRAN_N_FE_BUF_LEN * nCc[type] * nAnt[type]
+                        * XRAN_NUM_OF_SYMBOL_PER_SLOT * pArena->blockSize;
+        }
+    }
+
+    pArena->size = size;
+    return size;
+}
+
+/**
+ * @brief Packet control of a PRB map symbol, with its arrays bound to the arena
+ *
+ * @param pArena arena of the port
+ * @param pRbMap PRB map the packet belongs to
+ * @param type PRB map family
+ * @param mu numerology of the packet
+ * @param bufId buffer index of the slot
+ * @param cc CC of the packet
+ * @param ant eAxC of the packet, relative to the type
+ * @param sym symbol index in the PRB map
+ * @return packet control, NULL for a packet without storage, also of a numerology not laid out
+ */
+static inline struct xran_rx_packet_ctl *xran_rx_pkt_ctl(const struct xran_rx_pkt_arena *pArena,
+                struct xran_prb_map *pRbMap, uint32_t type, uint8_t mu,
+                uint32_t bufId, uint32_t cc, uint32_t ant, uint32_t sym)
+{
+    struct xran_rx_packet_ctl *pCtl;
+    uint32_t n = pArena->nPktPerSym;
+    uint8_t *pBlock;
+
+    if(unlikely(pArena->pBase == NULL || mu >= XRAN_MAX_NUM_MU || !(pArena->muMask & (1U << mu))
+                || cc >= pArena->nCc[type] || ant >= pArena->nAnt[type] || sym >= XRAN_NUM_OF_SYMBOL_PER_SLOT))
+        return NULL;
+
+    pCtl = &pRbMap->sFrontHaulRxPacketCtrl[sym];
+    if(pCtl->nRxPkt == 0)
+    {
+        pBlock = pArena->pBase + pArena->offset[mu][type]
+                    + ((((uint64_t)bufId * pArena->nCc[type] + cc) * pArena->nAnt[type] + ant)
+                        * XRAN_NUM_OF_SYMBOL_PER_SLOT + sym) * pArena->blockSize;
+
+        pCtl->nRBStart  = (uint16_t *)pBlock;
+        pCtl->nRBSize   = pCtl->nRBStart + n;
+        pCtl->nSectid   = pCtl->nRBSize + n;
+        pCtl->pData     = (uint8_t **)(pBlock + xran_rx_pkt_align(3 * sizeof(uint16_t) * n, sizeof(void *)));
+        pCtl->pCtrl     = (void **)(pCtl->pData + n);
+        pCtl->nRxPktMax = (int32_t)n;
+    }
+
+    return pCtl;
+}
+
+/**
+ * @brief Store one received U-plane section
+ *
+ * @param pCtl packet control from xran_rx_pkt_ctl()
+ * @param start_prbu first PRB of the section
+ * @param num_prbu PRBs of the section
+ * @param sect_id section id
+ * @param pData IQ samples of the section
+ * @param pCtrl mbuf holding the samples, NULL if released with another section
+ * @param ppStale mbuf left in the entry by an earlier slot, to be released by the caller
+ * @param pCnt counters of the calling thread, rx_err_pkt_per_sym is updated
+ * @return XRAN_STATUS_SUCCESS, or XRAN_STATUS_FAIL when the symbol is full
+ */
+static inline int32_t xran_rx_pkt_store(struct xran_rx_packet_ctl *pCtl,
+                uint16_t start_prbu, uint16_t num_prbu, uint16_t sect_id, void *pData, void *pCtrl,
+                void **ppStale, struct xran_common_counters *pCnt)
+{
+    int32_t npkts = pCtl->nRxPkt;
+
+    *ppStale = NULL;
+    if(unlikely(npkts >= pCtl->nRxPktMax))
+    {
+        ++pCnt->rx_err_pkt_per_sym;
+        return XRAN_STATUS_FAIL;
+    }
+
+    *ppStale = pCtl->pCtrl[npkts];
+    pCtl->nRBStart[npkts]   = start_prbu;
+    pCtl->nRBSize[npkts]    = num_prbu;
+    pCtl->nSectid[npkts]    = sect_id;
+    pCtl->pData[npkts]      = (uint8_t *)pData;
+    pCtl->pCtrl[npkts]      = pCtrl;
+    pCtl->nRxPkt            = npkts + 1;
+
+    return XRAN_STATUS_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _XRAN_RX_PKT_H_ */
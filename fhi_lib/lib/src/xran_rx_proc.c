@@ -125,27 +125,20 @@ int xran_process_prach_sym(void *arg,
         if(iq_data_start && size)
         {
             symb_id_offset = symb_id - p_xran_dev_ctx->prach_start_symbol[CC_ID];
-            struct xran_rx_packet_ctl *pFrontHaulRxPacketCtrl = &pRbMap->sFrontHaulRxPacketCtrl[symb_id_offset];
-            int32_t npkts = pFrontHaulRxPacketCtrl->nRxPkt;
-            if (unlikely(npkts >= XRAN_MAX_RX_PKT_PER_SYM))
-            {
-                print_err("(%d : %d : %d : %d)Received %d type-1 packets on symbol %d\n", frame_id, subframe_id, slot_id, Ant_ID, npkts, symb_id);
+            struct xran_rx_packet_ctl *pFrontHaulRxPacketCtrl = xran_rx_pkt_ctl(&p_xran_dev_ctx->rx_pkt_arena, pRbMap,
+                                            XRAN_RX_PKT_PRACH, mu, (tti + ttt_det) % XRAN_N_FE_BUF_LEN, CC_ID, Ant_ID, symb_id_offset);
+            if(unlikely(pFrontHaulRxPacketCtrl == NULL))
                 goto prach_counter_free_mbuf_return_size;
-            }
-            else
+            if (unlikely(xran_rx_pkt_store(pFrontHaulRxPacketCtrl, start_prbu, num_prbu, sect_id, iq_data_start, mbuf,
+                                           (void **)&mb, xran_fh_counters(p_xran_dev_ctx)) != XRAN_STATUS_SUCCESS))
             {
-                pFrontHaulRxPacketCtrl->nRxPkt = npkts + 1;
+                print_dbg("(%d : %d : %d : %d)Received %d type-1 packets on symbol %d\n", frame_id, subframe_id, slot_id, Ant_ID, pFrontHaulRxPacketCtrl->nRxPkt, symb_id);
+                goto prach_counter_free_mbuf_return_size;
             }
-            mb = pFrontHaulRxPacketCtrl->pCtrl[npkts];
             if(mb){
                rte_pktmbuf_free(mb);
             }
-            pFrontHaulRxPacketCtrl->nRBStart[npkts] = start_prbu;
-            pFrontHaulRxPacketCtrl->nRBSize[npkts] = num_prbu;
-            pFrontHaulRxPacketCtrl->nSectid[npkts] = sect_id;
-            pFrontHaulRxPacketCtrl->pData[npkts] = iq_data_start;
-            pFrontHaulRxPacketCtrl->pCtrl[npkts] = mbuf;
-            
+
             *mb_free = MBUF_KEEP;
             return size;
         }
@@ -156,9 +149,9 @@ int xran_process_prach_sym(void *arg,
     }
 
 prach_counter_free_mbuf_return_size:
-    ++p_xran_dev_ctx->fh_counters.rx_err_prach;
-    ++p_xran_dev_ctx->fh_counters.rx_err_up;
-    ++p_xran_dev_ctx->fh_counters.rx_err_drop;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_prach;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_up;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_drop;
     *mb_free = MBUF_FREE;
 
     return size;
@@ -190,7 +183,6 @@ int32_t xran_process_srs_sym(void *arg,
     struct rte_mbuf *mb = NULL;
     struct xran_prb_map * pRbMap    = NULL;
     uint32_t interval = xran_fs_get_tti_interval(mu);
-    static uint32_t firstprint = 0;
 
     if(p_xran_dev_ctx->xran2phy_mem_ready == 0)
         return 0;
@@ -246,28 +238,20 @@ int32_t xran_process_srs_sym(void *arg,
             }
             else if (likely(p_xran_dev_ctx->fh_cfg.ru_conf.byteOrder == XRAN_NE_BE_BYTE_ORDER))
             {
-                struct xran_rx_packet_ctl *pFrontHaulRxPacketCtrl = &pRbMap->sFrontHaulRxPacketCtrl[symb_id];
-                int32_t npkts = pFrontHaulRxPacketCtrl->nRxPkt;
-                if (unlikely(npkts >= XRAN_MAX_RX_PKT_PER_SYM))
-                {
-                    if (firstprint == 0) print_err("(%d : %d : %d : %d)Received %d SRS packets on symbol %d\n",frame_id, subframe_id, slot_id, Ant_ID, npkts, symb_id);
-                    firstprint = 1;
+                struct xran_rx_packet_ctl *pFrontHaulRxPacketCtrl = xran_rx_pkt_ctl(&p_xran_dev_ctx->rx_pkt_arena, pRbMap,
+                                                XRAN_RX_PKT_SRS, mu, tti % XRAN_N_FE_BUF_LEN, CC_ID, Ant_ID, symb_id);
+                if(unlikely(pFrontHaulRxPacketCtrl == NULL))
                     goto increment_counter_free_mbuf_return_size;
-                }
-                else
+                if (unlikely(xran_rx_pkt_store(pFrontHaulRxPacketCtrl, start_prbu, num_prbu, sect_id, iq_data_start, mbuf,
+                                               (void **)&mb, xran_fh_counters(p_xran_dev_ctx)) != XRAN_STATUS_SUCCESS))
                 {
-                    pFrontHaulRxPacketCtrl->nRxPkt = npkts + 1;
+                    print_dbg("(%d : %d : %d : %d)Received %d SRS packets on symbol %d\n",frame_id, subframe_id, slot_id, Ant_ID, pFrontHaulRxPacketCtrl->nRxPkt, symb_id);
+                    goto increment_counter_free_mbuf_return_size;
                 }
-                mb = pFrontHaulRxPacketCtrl->pCtrl[npkts];
                 if(mb)
                 {
                    rte_pktmbuf_free(mb);
                 }
-                pFrontHaulRxPacketCtrl->nRBStart[npkts] = start_prbu;
-                pFrontHaulRxPacketCtrl->nRBSize[npkts] = num_prbu;
-                pFrontHaulRxPacketCtrl->nSectid[npkts] = sect_id;
-                pFrontHaulRxPacketCtrl->pData[npkts] = iq_data_start;
-                pFrontHaulRxPacketCtrl->pCtrl[npkts] = mbuf;
                 *mb_free = MBUF_KEEP;
                 goto return_size;
             } /* else if (likely(p_xran_dev_ctx->fh_cfg.ru_conf.byteOrder == XRAN_NE_BE_BYTE_ORDER)) */
@@ -283,9 +267,9 @@ int32_t xran_process_srs_sym(void *arg,
     }
 
 increment_counter_free_mbuf_return_size:
-    ++p_xran_dev_ctx->fh_counters.rx_err_srs;
-    ++p_xran_dev_ctx->fh_counters.rx_err_up;
-    ++p_xran_dev_ctx->fh_counters.rx_err_drop;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_srs;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_up;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_drop;
     *mb_free = MBUF_FREE;
 
 return_size:
@@ -367,27 +351,20 @@ int32_t xran_process_csirs_sym(void *arg,
 
         if(iq_data_start && size)
         {
-            struct xran_rx_packet_ctl *pFrontHaulRxPacketCtrl = &pRbMap->sFrontHaulRxPacketCtrl[symb_id];
-            int32_t npkts = pFrontHaulRxPacketCtrl->nRxPkt;
-            if (unlikely(npkts >= XRAN_MAX_RX_PKT_PER_SYM))
-            {
-                print_err("Received %d type-1 CSI-RS packets on symbol %d\n", npkts, symb_id);
+            struct xran_rx_packet_ctl *pFrontHaulRxPacketCtrl = xran_rx_pkt_ctl(&p_xran_dev_ctx->rx_pkt_arena, pRbMap,
+                                            XRAN_RX_PKT_CSIRS, mu, tti % XRAN_N_FE_BUF_LEN, CC_ID, Ant_ID, symb_id);
+            if(unlikely(pFrontHaulRxPacketCtrl == NULL))
                 goto increment_counter_free_mbuf_return_size;
-            }
-            else
+            if (unlikely(xran_rx_pkt_store(pFrontHaulRxPacketCtrl, start_prbu, num_prbu, sect_id, iq_data_start, mbuf,
+                                           (void **)&mb, xran_fh_counters(p_xran_dev_ctx)) != XRAN_STATUS_SUCCESS))
             {
-                pFrontHaulRxPacketCtrl->nRxPkt = npkts + 1;
+                print_dbg("Received %d type-1 CSI-RS packets on symbol %d\n", pFrontHaulRxPacketCtrl->nRxPkt, symb_id);
+                goto increment_counter_free_mbuf_return_size;
             }
-            mb = pFrontHaulRxPacketCtrl->pCtrl[npkts];
             if(mb){
                rte_pktmbuf_free(mb);
             }
-            pFrontHaulRxPacketCtrl->nRBStart[npkts] = start_prbu;
-            pFrontHaulRxPacketCtrl->nRBSize[npkts] = num_prbu;
-            pFrontHaulRxPacketCtrl->nSectid[npkts] = sect_id;
-            pFrontHaulRxPacketCtrl->pData[npkts] = iq_data_start;
-            pFrontHaulRxPacketCtrl->pCtrl[npkts] = mbuf;
-            
+
             *mb_free = MBUF_KEEP;
             goto return_size;
         }
@@ -399,9 +376,9 @@ int32_t xran_process_csirs_sym(void *arg,
     }
 
 increment_counter_free_mbuf_return_size:
-    ++p_xran_dev_ctx->fh_counters.rx_err_csirs;
-    ++p_xran_dev_ctx->fh_counters.rx_err_up;
-    ++p_xran_dev_ctx->fh_counters.rx_err_drop;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_csirs;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_up;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_drop;
     *mb_free = MBUF_FREE;
 
 return_size:
@@ -410,82 +387,26 @@ return_size:
 
 int32_t xran_validate_seq_id(void *arg, uint8_t CC_ID, uint8_t Ant_ID, uint8_t slot_id, union ecpri_seq_id *seq_id)
 {
-#if 1
     struct xran_device_ctx *p_dev_ctx = (struct xran_device_ctx *)arg;
+    struct xran_common_counters *pCnt = xran_fh_counters(p_dev_ctx);
 
-    ++p_dev_ctx->fh_counters.rx_counter;
-    ++p_dev_ctx->fh_counters.Total_msgs_rcvd;
-
-    return XRAN_STATUS_SUCCESS;
-#else
-    /* Need to disable the check since current checking is to compare in-sequence order,
-    * but the packets could be arrived out-of-order sequence */
-
-    struct xran_device_ctx *p_dev_ctx = (struct xran_device_ctx *)arg;
-    struct xran_common_counters *pCnt;
-    int8_t xran_port = 0;
-    int appMode;
-    int ret = XRAN_STATUS_FAIL;
-
-    xran_port =  xran_dev_ctx_get_port_id(p_dev_ctx);
-    if(unlikely((xran_port < 0)
-                || (xran_port >= XRAN_PORTS_NUM)
-                || (CC_ID >= XRAN_MAX_CELLS_PER_PORT)))
+    /* packets of a flow may arrive out of order over multiple RX queues,
+     * the tracker accepts any order within its window */
+    if(unlikely((CC_ID >= XRAN_MAX_CELLS_PER_PORT) || (Ant_ID >= XRAN_RX_SEQID_MAX_EAXC)))
     {
-        print_dbg("Invalid parameter: pHandle=%p  port=%d  CC ID=%d", p_dev_ctx, xran_port, CC_ID);
+        print_dbg("Invalid parameter: pHandle=%p  CC ID=%d  Ant ID=%d", p_dev_ctx, CC_ID, Ant_ID);
     }
-    else
+    else if(likely(xran_rx_seqid_track(&p_dev_ctx->rx_seqid_state[CC_ID][Ant_ID], seq_id->bits.seq_id,
+                                        p_dev_ctx->rx_seqid_window, pCnt) == XRAN_STATUS_SUCCESS))
     {
-        pCnt = &p_dev_ctx->fh_counters;
-        appMode = xran_get_syscfg_appmode();
-        if(appMode == O_DU)
-        {
-            /* AntID allocation - PUSCH (neAxC) -> PRACH -> SRS (nAntElmTRx)
-            srsEaxcOffset calculation includes PUSCH + PRACH ant num */
-            if(unlikely(Ant_ID >= 2*XRAN_MAX_ANTENNA_NR + p_dev_ctx->fh_cfg.nAntElmTRx))
-            {
-                print_dbg("Invalid antenna ID - %d", Ant_ID);
-            }
-            else
-            {
-                ret = xran_check_upul_seqid(xran_port, CC_ID, Ant_ID, slot_id, seq_id->bits.seq_id);
-                if(unlikely(ret != XRAN_STATUS_SUCCESS))
-                {
-                    xran_set_upul_seqid(xran_port, CC_ID, Ant_ID, seq_id->bits.seq_id);  // for next
-                    ++p_dev_ctx->fh_counters.Rx_pkt_dupl;
-                }
-            }
-        }
-        else
-        {
-            /* AntID allocation - PDSCH -> CSI-RS */
-            if(unlikely(Ant_ID >= p_dev_ctx->fh_cfg.neAxc + XRAN_MAX_CSIRS_PORTS))
-            {
-                print_dbg("Invalid antenna ID - %d", Ant_ID);
-            }
-            else
-            {
-                ret = xran_check_updl_seqid(xran_port, CC_ID, Ant_ID, slot_id, seq_id->bits.seq_id);
-                if(unlikely(ret != XRAN_STATUS_SUCCESS))
-                {
-                    xran_set_updl_seqid(xran_port, CC_ID, Ant_ID, seq_id->bits.seq_id);
-                    ++p_dev_ctx->fh_counters.Rx_pkt_dupl;
-                }
-            }
-        }
-
-        if(ret == XRAN_STATUS_SUCCESS)
-        {
-            ++pCnt->rx_counter;
-            ++pCnt->Total_msgs_rcvd;
-            return(XRAN_STATUS_SUCCESS);
-        }
+        ++pCnt->rx_counter;
+        ++pCnt->Total_msgs_rcvd;
+        return(XRAN_STATUS_SUCCESS);
     }
 
-    ++p_dev_ctx->fh_counters.rx_err_drop;
-    ++p_dev_ctx->fh_counters.rx_err_up;
+    ++pCnt->rx_err_drop;
+    ++pCnt->rx_err_up;
     return(XRAN_STATUS_FAIL);
-#endif
 }
 
 int32_t xran_process_rx_sym(void *arg,
@@ -518,7 +439,6 @@ int32_t xran_process_rx_sym(void *arg,
     struct xran_prb_elm * prbMapElm = NULL;
     uint32_t interval = xran_fs_get_tti_interval(mu);
     uint16_t i=0, prb_elem_id = 0;
-    static uint32_t firstprint = 0;
     Ant_ID -= p_xran_dev_ctx->perMu[mu].eaxcOffset;
 
     tti = frame_id * SLOTS_PER_SYSTEMFRAME(interval) + subframe_id * SLOTNUM_PER_SUBFRAME(interval) + slot_id;
@@ -571,29 +491,21 @@ int32_t xran_process_rx_sym(void *arg,
             }
             else if (likely(p_xran_dev_ctx->fh_cfg.ru_conf.byteOrder == XRAN_NE_BE_BYTE_ORDER))
             {
-                struct xran_rx_packet_ctl *pFrontHaulRxPacketCtrl = &pRbMap->sFrontHaulRxPacketCtrl[symb_id];
-                int32_t npkts = pFrontHaulRxPacketCtrl->nRxPkt;
-                /*if (unlikely(npkts >= 20))
-                    printf("npkt %d (%d : %d : %d : %d) (start %d num %d sect %d)\n",npkts,frame_id, subframe_id, slot_id, Ant_ID,start_prbu,num_prbu,sect_id);*/
-                if (unlikely(npkts >= XRAN_MAX_RX_PKT_PER_SYM))
-                {
-                    if (firstprint == 0) print_err("(%d : %d : %d : %d)Received %d type-1 packets on symbol %d\n", frame_id, subframe_id, slot_id, Ant_ID, npkts, symb_id);
-                    firstprint = 1;
+                struct xran_rx_packet_ctl *pFrontHaulRxPacketCtrl = xran_rx_pkt_ctl(&p_xran_dev_ctx->rx_pkt_arena, pRbMap,
+                                                XRAN_RX_PKT_PUSCH, mu, tti % XRAN_N_FE_BUF_LEN, CC_ID, Ant_ID, symb_id);
+                if(unlikely(pFrontHaulRxPacketCtrl == NULL))
                     goto inc_counter_free_mbuf_return_size;
-                }
-                else
+                if (unlikely(xran_rx_pkt_store(pFrontHaulRxPacketCtrl, start_prbu, num_prbu, sect_id, iq_data_start,
+                                               (0 == nSectionIdx) ? mbuf : NULL, (void **)&mb,
+                                               xran_fh_counters(p_xran_dev_ctx)) != XRAN_STATUS_SUCCESS))
                 {
-                    pFrontHaulRxPacketCtrl->nRxPkt = npkts + 1;
+                    print_dbg("(%d : %d : %d : %d)Received %d type-1 packets on symbol %d\n", frame_id, subframe_id, slot_id, Ant_ID, pFrontHaulRxPacketCtrl->nRxPkt, symb_id);
+                    goto inc_counter_free_mbuf_return_size;
                 }
-                mb = pFrontHaulRxPacketCtrl->pCtrl[npkts];
                 if(mb){
                    rte_pktmbuf_free(mb);
                 }
-                pFrontHaulRxPacketCtrl->nRBStart[npkts] = start_prbu;
-                pFrontHaulRxPacketCtrl->nRBSize[npkts] = num_prbu;
-                pFrontHaulRxPacketCtrl->nSectid[npkts] = sect_id;
-                pFrontHaulRxPacketCtrl->pData[npkts] = iq_data_start;
-                pFrontHaulRxPacketCtrl->pCtrl[npkts] = (0 == nSectionIdx) ? mbuf : NULL;
+                xran_ul_done_on_rx(p_xran_dev_ctx, mu, tti, CC_ID, symb_id, num_prbu);
                 *mb_free = MBUF_KEEP;
                 return size;
             }
@@ -604,9 +516,68 @@ int32_t xran_process_rx_sym(void *arg,
     // }
 
 inc_counter_free_mbuf_return_size:
-    ++p_xran_dev_ctx->fh_counters.rx_err_drop;
-    ++p_xran_dev_ctx->fh_counters.rx_err_up;
-    ++p_xran_dev_ctx->fh_counters.rx_err_pusch;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_drop;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_up;
+    ++xran_fh_counters(p_xran_dev_ctx)->rx_err_pusch;
     *mb_free = MBUF_FREE;
     return size;
 }
+
+/**
+ * @brief Allocate the RX packet controls of the PRB maps of a port
+ *
+ * @param pHandle device context, fh_cfg set by xran_open
+ * @return XRAN_STATUS_SUCCESS, or XRAN_STATUS_RESOURCE if hugepages are exhausted
+ */
+int32_t xran_init_rx_pkt(void *pHandle)
+{
+    struct xran_device_ctx *p_dev = (struct xran_device_ctx *)pHandle;
+    struct xran_fh_config *pFhCfg = &p_dev->fh_cfg;
+    struct xran_rx_pkt_arena *pArena = &p_dev->rx_pkt_arena;
+    uint16_t nCc[XRAN_RX_PKT_TYPE_MAX], nAnt[XRAN_RX_PKT_TYPE_MAX];
+    uint32_t nCcCfg = RTE_MIN(pFhCfg->nCC, XRAN_MAX_SECTOR_NR);
+    uint64_t size;
+
+    xran_free_rx_pkt(pHandle);
+
+    nCc[XRAN_RX_PKT_PUSCH]  = nCcCfg;
+    nAnt[XRAN_RX_PKT_PUSCH] = RTE_MIN(RTE_MAX(pFhCfg->neAxc, pFhCfg->neAxcUl), XRAN_MAX_ANTENNA_NR);
+    nCc[XRAN_RX_PKT_PRACH]  = nCcCfg;
+    nAnt[XRAN_RX_PKT_PRACH] = nAnt[XRAN_RX_PKT_PUSCH];
+    nCc[XRAN_RX_PKT_SRS]    = nCcCfg;
+    nAnt[XRAN_RX_PKT_SRS]   = p_dev->enableSrs ? RTE_MIN(pFhCfg->nAntElmTRx, XRAN_MAX_ANT_ARRAY_ELM_NR) : 0;
+    nCc[XRAN_RX_PKT_CSIRS]  = nCcCfg;
+    nAnt[XRAN_RX_PKT_CSIRS] = p_dev->csirsEnable ? XRAN_MAX_CSIRS_PORTS : 0;
+
+    size = xran_rx_pkt_arena_layout(pArena, xran_rx_pkt_per_sym(pArena->nPktPerSym),
+                                    pFhCfg->mu_number, pFhCfg->numMUs, nCc, nAnt);
+    if(size == 0)
+        return XRAN_STATUS_SUCCESS;
+
+    pArena->pBase = (uint8_t *)xran_zmalloc("rx_pkt_arena", size, XRAN_RX_PKT_BLOCK_ALIGN);
+    if(pArena->pBase == NULL)
+    {
+        print_err("RU%d: failed to allocate %lu bytes for %u RX packets per symbol\n",
+                  p_dev->xran_port_id, size, pArena->nPktPerSym);
+        return XRAN_STATUS_RESOURCE;
+    }
+
+    printf("RU%d: %u RX packets per symbol, %lu bytes\n", p_dev->xran_port_id, pArena->nPktPerSym, size);
+    return XRAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Release the RX packet controls of a port
+ *
+ * @param pHandle device context
+ */
+void xran_free_rx_pkt(void *pHandle)
+{
+    struct xran_device_ctx *p_dev = (struct xran_device_ctx *)pHandle;
+
+    if(p_dev->rx_pkt_arena.pBase)
+    {
+        xran_free(p_dev->rx_pkt_arena.pBase);
+        p_dev->rx_pkt_arena.pBase = NULL;
+    }
+}
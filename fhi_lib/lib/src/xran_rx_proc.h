@@ -126,6 +126,8 @@ int32_t xran_process_csirs_sym(void *arg,
                         uint8_t iqWidth,
                         uint8_t mu);
 
+int32_t xran_init_rx_pkt(void *pHandle);
+void xran_free_rx_pkt(void *pHandle);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,142 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief XRAN RX eCPRI sequence ID tracking with a sliding window
+ * @file xran_rx_seqid.h
+ * @ingroup group_source_xran
+ * @author Intel Corporation
+ *
+ * Every (port, CC, eAxC) flow keeps the highest seqId received and a bitmap
+ * of the seqIds received just before it, as IPsec anti-replay does. Packets
+ * reordered within the window depth are accepted, duplicates are rejected and
+ * seqIds leaving the window without being received are counted as lost.
+ * Packets older than the window are counted as late and accepted: their seqId
+ * was already counted as lost when it left the window.
+ * The first packet of a flow opens the window as if the seqIds before it had
+ * been received, so a packet overtaken by the very first one is a duplicate.
+ *
+ * The state of a flow is a single 64-bit word (bitmap << 8 | highest seqId),
+ * updated with compare and swap so RX workers may share a flow.
+ **/
+
+#ifndef _XRAN_RX_SEQID_H_
+#define _XRAN_RX_SEQID_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <rte_branch_prediction.h>
+
+#include "xran_fh_o_du.h"
+
+#define XRAN_RX_SEQID_WINDOW_DEFAULT    (32)    /**< reorder window depth used when none is configured */
+#define XRAN_RX_SEQID_WINDOW_MAX        (56)    /**< bitmap bits left next to the 8-bit seqId */
+#define XRAN_RX_SEQID_MAX_EAXC          (XRAN_MAX_ANTENNA_NR * 2 + XRAN_MAX_ANT_ARRAY_ELM_NR)
+
+/**
+ * @brief Resolve the configured reorder window depth
+ *
+ * @param depth configured depth, 0 for the default
+ * @return depth in [1, XRAN_RX_SEQID_WINDOW_MAX]
+ */
+static inline uint32_t xran_rx_seqid_window(uint32_t depth)
+{
+    if(depth == 0)
+        return XRAN_RX_SEQID_WINDOW_DEFAULT;
+    return (depth > XRAN_RX_SEQID_WINDOW_MAX) ? XRAN_RX_SEQID_WINDOW_MAX : depth;
+}
+
+/**
+ * @brief Track one received seqId of a flow
+ *
+ * @param pState state of the flow, 0 before the first packet
+ * @param seq_id received eCPRI seqId
+ * @param depth reorder window depth, from xran_rx_seqid_window()
+ * @param pCnt counters of the calling thread, Rx_pkt_lost, Rx_pkt_reorder,
+ *        Rx_pkt_late and Rx_pkt_dupl are updated
+ * @return XRAN_STATUS_SUCCESS, or XRAN_STATUS_FAIL for a duplicate
+ */
+static inline int32_t xran_rx_seqid_track(uint64_t *pState, uint8_t seq_id, uint32_t depth,
+                struct xran_common_counters *pCnt)
+{
+    const uint64_t win_mask = (1ULL << depth) - 1;
+    uint64_t state = __atomic_load_n(pState, __ATOMIC_RELAXED);
+    uint64_t bitmap, new_state, lost;
+    int32_t dist;
+
+    do {
+        bitmap = state >> 8;
+        lost = 0;
+
+        if(unlikely(bitmap == 0))
+        {
+            /* first packet, earlier seqIds are not known to be missing */
+            new_state = (win_mask << 8) | seq_id;
+        }
+        else
+        {
+            dist = (int8_t)(seq_id - (uint8_t)state);
+            if(likely(dist > 0))
+            {
+                /* slide forward, seqIds leaving the window unreceived are lost */
+                if((uint32_t)dist >= depth)
+                {
+                    lost = depth - __builtin_popcountll(bitmap) + (dist - depth);
+                    bitmap = 1;
+                }
+                else
+                {
+                    lost = __builtin_popcountll(~bitmap & win_mask & ~(win_mask >> dist));
+                    bitmap = ((bitmap << dist) | 1) & win_mask;
+                }
+                new_state = (bitmap << 8) | seq_id;
+            }
+            else if((uint32_t)-dist >= depth)
+            {
+                ++pCnt->Rx_pkt_late;
+                return XRAN_STATUS_SUCCESS;
+            }
+            else if(bitmap & (1ULL << -dist))
+            {
+                ++pCnt->Rx_pkt_dupl;
+                return XRAN_STATUS_FAIL;
+            }
+            else
+            {
+                new_state = state | (1ULL << (8 - dist));
+            }
+        }
+    } while(unlikely(!__atomic_compare_exchange_n(pState, &state, new_state, 0,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)));
+
+    if(unlikely((new_state & 0xFF) != seq_id))
+        ++pCnt->Rx_pkt_reorder;
+    pCnt->Rx_pkt_lost += lost;
+
+    return XRAN_STATUS_SUCCESS;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _XRAN_RX_SEQID_H_ */
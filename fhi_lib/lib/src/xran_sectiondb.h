@@ -0,0 +1,125 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief XRAN C-plane section database layout
+ * @file xran_sectiondb.h
+ * @ingroup group_source_xran
+ * @author Intel Corporation
+ *
+ * The section database of a port is a single allocation. It starts with the
+ * descriptor of every numerology, each followed by its entries, one per
+ * (context, direction, eAxC, CC) at a computed offset, so the C-plane of a
+ * slot walks its entries in address order:
+ *
+ *     [SECTION_DB_TYPE mu0][entries mu0][SECTION_DB_TYPE mu1][entries mu1]...
+ **/
+
+#ifndef _XRAN_SECTIONDB_H_
+#define _XRAN_SECTIONDB_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <rte_branch_prediction.h>
+
+#include "xran_fh_o_du.h"
+#include "xran_cp_api.h"
+
+/**<  this is the configuration of M-plane */
+#define XRAN_MAX_NUM_SECTIONS       (32) //(N_SYM_PER_SLOT* (XRAN_MAX_ANTENNA_NR*2) + XRAN_MAX_ANT_ARRAY_ELM_NR)
+
+#define XRAN_SECTIONDB_MAX_ANT      (XRAN_MAX_ANTENNA_NR * 2 + XRAN_MAX_ANT_ARRAY_ELM_NR)
+#define XRAN_SECTIONDB_ALIGN        (64)
+
+struct xran_sectioninfo_db {
+    uint32_t    cur_index;  /**< Current index to store for this eAXC */
+    struct xran_section_info list[XRAN_MAX_NUM_SECTIONS]; /**< The array of section information */
+};
+
+static inline uint64_t xran_sectiondb_hdr_size(void)
+{
+    return (sizeof(SECTION_DB_TYPE) + XRAN_SECTIONDB_ALIGN - 1) & ~(uint64_t)(XRAN_SECTIONDB_ALIGN - 1);
+}
+
+/**
+ * @brief Bytes of the database of one numerology, descriptor included
+ *
+ * @param nCc CCs, limited to XRAN_COMPONENT_CARRIERS_MAX
+ * @param nAnt eAxCs, limited to XRAN_SECTIONDB_MAX_ANT
+ * @return size to reserve in the arena
+ */
+static inline uint64_t xran_sectiondb_size(uint32_t nCc, uint32_t nAnt)
+{
+    if(nCc > XRAN_COMPONENT_CARRIERS_MAX)
+        nCc = XRAN_COMPONENT_CARRIERS_MAX;
+    if(nAnt > XRAN_SECTIONDB_MAX_ANT)
+        nAnt = XRAN_SECTIONDB_MAX_ANT;
+
+    return xran_sectiondb_hdr_size()
+            + (uint64_t)XRAN_MAX_SECTIONDB_CTX * XRAN_DIR_MAX * nCc * nAnt * sizeof(struct xran_sectioninfo_db);
+}
+
+/**
+ * @brief Lay out the database of one numerology in zeroed memory
+ *
+ * @param pMem xran_sectiondb_size() bytes, zeroed and cache line aligned
+ * @param nCc CCs
+ * @param nAnt eAxCs
+ * @param pArena allocation released with this numerology, NULL if released with another one
+ * @return the database
+ */
+static inline PSECTION_DB_TYPE xran_sectiondb_layout(void *pMem, uint32_t nCc, uint32_t nAnt, void *pArena)
+{
+    PSECTION_DB_TYPE pDb = (PSECTION_DB_TYPE)pMem;
+
+    pDb->nCc    = (nCc > XRAN_COMPONENT_CARRIERS_MAX) ? XRAN_COMPONENT_CARRIERS_MAX : nCc;
+    pDb->nAnt   = (nAnt > XRAN_SECTIONDB_MAX_ANT) ? XRAN_SECTIONDB_MAX_ANT : nAnt;
+    pDb->pArena = pArena;
+    pDb->pElm   = (struct xran_sectioninfo_db *)((uint8_t *)pMem + xran_sectiondb_hdr_size());
+
+    return pDb;
+}
+
+/**
+ * @brief Section list of an eAxC
+ *
+ * @param pDb database of the numerology
+ * @param ctx_id context index, below XRAN_MAX_SECTIONDB_CTX
+ * @param dir direction, below XRAN_DIR_MAX
+ * @param cc_id CC ID
+ * @param ruport_id RU port ID
+ * @return the list, NULL for a CC or eAxC without storage
+ */
+static inline struct xran_sectioninfo_db *xran_sectiondb_elm(PSECTION_DB_TYPE pDb,
+                uint8_t ctx_id, uint8_t dir, uint8_t cc_id, uint8_t ruport_id)
+{
+    if(unlikely(cc_id >= pDb->nCc || ruport_id >= pDb->nAnt))
+        return (NULL);
+
+    return (&pDb->pElm[(((uint32_t)ctx_id * XRAN_DIR_MAX + dir) * pDb->nAnt + ruport_id) * pDb->nCc + cc_id]);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _XRAN_SECTIONDB_H_ */
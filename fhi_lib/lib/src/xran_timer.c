@@ -251,12 +251,12 @@ long xran_timingsource_poll_next_tick(long interval_ns, unsigned long *used_tick
         {
             /* Debug stop works only when RU0 IS ACTIVE */
             if(debugStop &&(debugStopCount > 0)
-                && (xran_dev_get_ctx_by_id(0)->fh_counters.tx_counter >= debugStopCount))
+                && (xran_fh_counters_tx_total(xran_dev_get_ctx_by_id(0)) >= debugStopCount))
             {
                 uint64_t t1;
                 printf("STOP:[%ld.%09ld], debugStopCount %d, tx_counter %ld\n",
                         p_cur_time->tv_sec, p_cur_time->tv_nsec, debugStopCount,
-                        xran_dev_get_ctx_by_id(0)->fh_counters.tx_counter);
+                        xran_fh_counters_tx_total(xran_dev_get_ctx_by_id(0)));
 
                 t1 = MLogTick();
                 rte_pause();
@@ -453,6 +453,7 @@ int32_t xran_timingsource_thread(__attribute__((unused)) void *args)
     uint8_t mu=0, i=0, j=0;
     uint32_t xran_port_id = 0;
     static int owdm_init_done = 0;
+    int slotStart = 0;
     uint64_t tWake = 0, tWakePrev = 0, tUsed = 0;
     int64_t delta;
     struct xran_device_ctx * p_dev_ctx_run = NULL;
@@ -524,8 +525,9 @@ int32_t xran_timingsource_thread(__attribute__((unused)) void *args)
         {
             /* TTI callback */
             mu = xran_timingsource_get_numerology();       /* Numerology for TTI interval */
-            if((XranGetSymNum(xran_lib_ota_sym_idx_mu[mu], XRAN_NUM_OF_SYMBOL_PER_SLOT) == xran_lib_ota_sym_mu[mu])
-                && (XranGetSymNum(xran_lib_ota_sym_idx_mu[mu], XRAN_NUM_OF_SYMBOL_PER_SLOT) == 0))
+            slotStart = (XranGetSymNum(xran_lib_ota_sym_idx_mu[mu], XRAN_NUM_OF_SYMBOL_PER_SLOT) == xran_lib_ota_sym_mu[mu])
+                && (XranGetSymNum(xran_lib_ota_sym_idx_mu[mu], XRAN_NUM_OF_SYMBOL_PER_SLOT) == 0);
+            if(slotStart)
             {
                 long t3 = xran_tick();
                 tti_ota_cb(NULL, mu);
@@ -547,7 +549,7 @@ int32_t xran_timingsource_thread(__attribute__((unused)) void *args)
                         /* Check if owdm finished to create the timing cbs based on measurement results */
                         if((ioCfg->eowd_cmn[appMode].owdm_enable) && (!owdm_init_done))
                         {
-                            // Adjust Windows based on Delay Measurement results
+                            // Adjust Windows based on Delay Measurement results before the timing cbs latch them
                             xran_adjust_timing_parameters(p_dev_ctx_run);
                             if((result = xran_timing_create_cbs((void *)p_dev_ctx_run)) < 0)
                             {
@@ -556,6 +558,17 @@ int32_t xran_timingsource_thread(__attribute__((unused)) void *args)
                             }
                             owdm_init_done = 1;
                         }
+                        else if(owdm_init_done && slotStart)
+                        {
+                            // Re-measure when due, step the windows on each new result and re-latch them at the slot start
+                            xran_restart_delay_measurement(p_dev_ctx_run);
+                            if(xran_adjust_timing_parameters(p_dev_ctx_run)
+                                && (result = xran_timing_update_cbs((void *)p_dev_ctx_run)) < 0)
+                            {
+                                print_err("Failed to update timing callbacks! (%d)", result);
+                                return (result);
+                            }
+                        }
 
                         for(j=0;j<p_dev_ctx_run->fh_cfg.numMUs;j++)
                         {
@@ -565,27 +578,7 @@ int32_t xran_timingsource_thread(__attribute__((unused)) void *args)
                                 sym_ota_cb(p_dev_ctx_run, &tUsed, mu);
                             }
 
-                            struct xran_common_counters *pCnt = &p_dev_ctx_run->fh_counters;
-                            uint64_t current_sec = xran_timingsource_get_current_second();
-                            if(pCnt->gps_second != current_sec)
-                            {
-                                if((current_sec - pCnt->gps_second) != 1)
-                                    print_dbg("second c %ld p %ld\n", current_sec, pCnt->gps_second);
-
-                                pCnt->gps_second = (uint64_t)current_sec;
-
-                                pCnt->rx_counter_pps    = pCnt->rx_counter - pCnt->old_rx_counter;
-                                pCnt->old_rx_counter    = pCnt->rx_counter;
-                                pCnt->tx_counter_pps    = pCnt->tx_counter - pCnt->old_tx_counter;
-                                pCnt->old_tx_counter    = pCnt->tx_counter;
-                                pCnt->rx_bytes_per_sec  = pCnt->rx_bytes_counter;
-                                pCnt->tx_bytes_per_sec  = pCnt->tx_bytes_counter;
-                                pCnt->rx_bytes_counter  = 0;
-                                pCnt->tx_bytes_counter  = 0;
-                                pCnt->rx_bits_per_sec   = pCnt->rx_bytes_per_sec * 8 / 1000L;
-                                pCnt->tx_bits_per_sec   = pCnt->tx_bytes_per_sec * 8 / 1000L;
-                                print_dbg("current_sec %lu\n", current_sec);
-                            }
+                            xran_fh_counters_update_rates(p_dev_ctx_run, xran_timingsource_get_current_second());
                         }
                     }
                     else
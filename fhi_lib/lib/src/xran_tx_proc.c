@@ -64,6 +64,8 @@
 #include "xran_printf.h"
 #include "xran_tx_proc.h"
 #include "xran_cp_proc.h"
+#include "xran_ru_loadgen.h"
+#include "xran_pcap.h"
 
 #include "xran_mlog_lnx.h"
 
@@ -154,7 +156,7 @@ int32_t xran_process_tx_sym_cp_off(void *pHandle, uint8_t ctx_id, uint32_t tti,
     struct xran_device_ctx * p_xran_dev_ctx = (struct xran_device_ctx *)pHandle;
     if (p_xran_dev_ctx == NULL)
         return retval;
-    struct xran_common_counters * pCnt = &p_xran_dev_ctx->fh_counters;
+    struct xran_common_counters * pCnt = xran_fh_counters(p_xran_dev_ctx);
     struct xran_ethdi_ctx* eth_ctx = xran_ethdi_get_ctx();
 
     enum xran_pkt_dir direction;
@@ -196,12 +198,12 @@ int32_t xran_process_tx_sym_cp_off(void *pHandle, uint8_t ctx_id, uint32_t tti,
     }
     uint16_t mtu = p_xran_dev_ctx->mtu;
 
-    if(xran_fs_get_slot_type(PortId, cc_id, tti, ((appMode == O_DU)? XRAN_SLOT_TYPE_DL : XRAN_SLOT_TYPE_UL), mu) ==  1
-            || xran_fs_get_slot_type(PortId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1
-            || xran_fs_get_slot_type(PortId, cc_id, tti, XRAN_SLOT_TYPE_FDD, mu) ==  1){
+    const struct xran_occ_slot *pOcc = xran_occ_get(&p_xran_dev_ctx->perMu[mu].occTbl, tti);
 
-        if(xran_fs_get_symbol_type(PortId, cc_id, tti, sym_id, mu) == ((appMode == O_DU)? XRAN_SYMBOL_TYPE_DL : XRAN_SYMBOL_TYPE_UL)
-           || xran_fs_get_symbol_type(PortId, cc_id, tti, sym_id, mu) == XRAN_SYMBOL_TYPE_FDD){
+    if(pOcc->slotType & (XRAN_OCC_SLOT((appMode == O_DU)? XRAN_SLOT_TYPE_DL : XRAN_SLOT_TYPE_UL)
+                        | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_FDD))){
+
+        if((((appMode == O_DU)? pOcc->dlSym : pOcc->ulSym) >> sym_id) & 1){
 
             vf_id = xran_map_ecpriPcid_to_vf(p_xran_dev_ctx, direction, cc_id, ru_port_id);
             p_id = eth_ctx->io_cfg.port[vf_id];
@@ -433,18 +435,12 @@ int32_t xran_process_tx_prach_cp_off(void *pHandle, uint8_t ctx_id, uint32_t tti
     if (p_xran_dev_ctx == NULL)
         return retval;
     struct xran_prach_cp_config *pPrachCPConfig;
-    if(p_xran_dev_ctx->dssEnable){
-        int i = tti % p_xran_dev_ctx->dssPeriod;
-        if(p_xran_dev_ctx->technology[i]==1) {
-            pPrachCPConfig = &(p_xran_dev_ctx->perMu[mu].PrachCPConfig);
-        }
-        else{
-            pPrachCPConfig = &(p_xran_dev_ctx->perMu[mu].PrachCPConfigLTE);
-        }
-    }
-    else{
+    const struct xran_occ_tbl *pOccTbl = &p_xran_dev_ctx->perMu[mu].occTbl;
+    uint32_t prachCfg = xran_occ_prach_cfg(p_xran_dev_ctx->dssEnable, p_xran_dev_ctx->technology, p_xran_dev_ctx->dssPeriod, tti);
+    if(prachCfg == XRAN_OCC_PRACH_CFG_LTE)
+        pPrachCPConfig = &(p_xran_dev_ctx->perMu[mu].PrachCPConfigLTE);
+    else
         pPrachCPConfig = &(p_xran_dev_ctx->perMu[mu].PrachCPConfig);
-    }
 
     enum xran_pkt_dir direction = XRAN_DIR_UL;
     uint8_t PortId = p_xran_dev_ctx->xran_port_id;
@@ -457,22 +453,12 @@ int32_t xran_process_tx_prach_cp_off(void *pHandle, uint8_t ctx_id, uint32_t tti
     if(p_xran_dev_ctx->perMu[mu].enablePrach
             && (xran_get_syscfg_appmode() == O_RU) && (ant_id < XRAN_MAX_PRACH_ANT_NUM)){
 
-        if(xran_fs_get_symbol_type(PortId, cc_id, tti, sym_id, mu) == XRAN_SYMBOL_TYPE_UL
-                || xran_fs_get_symbol_type(PortId, cc_id, tti, sym_id, mu) == XRAN_SYMBOL_TYPE_FDD) {   /* Only RU needs to send PRACH I/Q */
+        if((xran_occ_get(pOccTbl, tti)->ulSym >> sym_id) & 1) {   /* Only RU needs to send PRACH I/Q */
 
-            uint32_t is_prach_slot;
             if(mu != XRAN_NBIOT_MU)
             {
-                is_prach_slot = xran_is_prach_slot(PortId, subframe_id, slot_id, mu);
-                if(((frame_id % pPrachCPConfig->x) == pPrachCPConfig->y[0])
-                                    && (is_prach_slot == 1)
-                                    && (sym_id >= p_xran_dev_ctx->prach_start_symbol[cc_id])
-                                    && (sym_id <= p_xran_dev_ctx->prach_last_symbol[cc_id]))
-                {
-                    sendPrach = 1;
-                }
-                else
-                    sendPrach =0;
+                /* PRACH slot of the frame and symbol between prach_start_symbol and prach_last_symbol */
+                sendPrach = (xran_occ_get_frame(pOccTbl, frame_id, tti)->prachSym[prachCfg] >> sym_id) & 1;
             }
             else
             {
@@ -603,7 +589,7 @@ xran_process_tx_srs_cp_off(void *pHandle, uint8_t ctx_id, uint32_t tti, int32_t
     if(p_xran_dev_ctx->xran_port_id >= XRAN_PORTS_NUM)
         rte_panic("incorrect PORT ID\n");
 
-    pCnt            = &p_xran_dev_ctx->fh_counters;
+    pCnt            = xran_fh_counters(p_xran_dev_ctx);
     //pPrachCPConfig  = &(p_xran_dev_ctx->perMu[mu].PrachCPConfig);
     p_srs_cfg       = &(p_xran_dev_ctx->srs_cfg);
 
@@ -914,6 +900,7 @@ xran_prepare_up_dl_sym(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nCcSt
 {
     int32_t     retval = 0;
     uint32_t    tti=0, tti_for_ring=0, xranTti=0;
+    const struct xran_occ_slot *pOcc;
     uint32_t    numSlotMu1 = 5;
 #if XRAN_MLOG_VAR
     uint32_t    mlogVar[15];
@@ -987,6 +974,7 @@ xran_prepare_up_dl_sym(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nCcSt
             tti_for_ring = XranGetTtiNum(sym_idx_for_ring, XRAN_NUM_OF_SYMBOL_PER_SLOT);
             slot_id     = XranGetSlotNum(tti, SLOTNUM_PER_SUBFRAME(interval));
             subframe_id = XranGetSubFrameNum(tti,SLOTNUM_PER_SUBFRAME(interval),  SUBFRAMES_PER_SYSTEMFRAME);
+            pOcc        = xran_occ_get(&p_xran_dev_ctx->perMu[mu].occTbl, tti);
 
             frame_id    =  (nSlotIdx / SLOTS_PER_SYSTEMFRAME(interval)) & 0x3FF;
             // ORAN frameId, 8 bits, [0, 255]
@@ -1162,10 +1150,9 @@ xran_prepare_up_dl_sym(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nCcSt
                 for(cc_id = 0; cc_id < num_CCPorts; cc_id++)
                 {
                     /* check special frame */
-                    if((xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1)
-                        || (xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_UL, mu) ==  1))
+                    if(pOcc->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL)))
                     {
-                        if(((tti % p_xran_dev_ctx->fh_cfg.frame_conf.nTddPeriod) == pSrsCfg->slot)
+                        if((pOcc->slotType & XRAN_OCC_SLOT_SRS)
                             && (p_xran_dev_ctx->ndm_srs_scheduled == 0))
                         {
                             struct xran_prb_map *prb_map;
@@ -1244,7 +1231,7 @@ int32_t antStat[XRAN_PORTS_NUM][XRAN_MAX_CELLS_PER_PORT][XRAN_MAX_ANTENNA_NR * 2
 int32_t vfStat[XRAN_PORTS_NUM*2] = { 0 };
 #endif
 
-static inline uint16_t xran_tx_sym_from_ring(struct xran_device_ctx* p_xran_dev_ctx, struct rte_ring *r, uint16_t vf_id)
+static inline uint16_t xran_tx_sym_from_ring(struct xran_device_ctx* p_xran_dev_ctx, struct rte_ring *r, uint16_t port, uint16_t vf_id)
 {
     struct rte_mbuf *mbufs[XRAN_MAX_MEM_IF_RING_SIZE];
     uint16_t dequeued, sent = 0;
@@ -1324,9 +1311,13 @@ static inline uint16_t xran_tx_sym_from_ring(struct xran_device_ctx* p_xran_dev_
 }
 #endif
 
+    /* several workers may send on the VF, each has a capture ring of its own */
+    if (unlikely(xran_pcap_flags & XRAN_PCAP_TX))
+        xran_pcap_tap_worker(vf_id, mbufs, dequeued);
+
     while (1)
     {
-        sent += rte_eth_tx_burst(vf_id, 0, &mbufs[sent], dequeued - sent);
+        sent += rte_eth_tx_burst(port, 0, &mbufs[sent], dequeued - sent);
         if (sent == dequeued)
         {
             return remaining;
@@ -1343,6 +1334,7 @@ xran_process_tx_sym_cp_on_ring(void* pHandle, uint8_t ctx_id, uint32_t tti, int3
     long t1 = MLogXRANTick();
     struct rte_ring *ring = NULL;
     struct xran_device_ctx* p_xran_dev_ctx = (struct xran_device_ctx*)pHandle;
+    struct xran_ethdi_ctx* eth_ctx = xran_ethdi_get_ctx();
     int32_t cc_id  = 0;
     int32_t ant_id = 0;
     uint16_t vf_id = 0;
@@ -1375,7 +1367,7 @@ xran_process_tx_sym_cp_on_ring(void* pHandle, uint8_t ctx_id, uint32_t tti, int3
             ru_port_id = ant_id + p_xran_dev_ctx->perMu[mu].eaxcOffset;
             vf_id = p_xran_dev_ctx->map2vf[direction][cc_id][ru_port_id][XRAN_UP_VF];
             ring    = p_xran_dev_ctx->perMu[mu].sFrontHaulTxBbuIoBufCtrl[tti_for_ring % XRAN_N_FE_BUF_LEN][cc_id][ant_id].sBufferList.pBuffers[sym_id_for_ring].pRing;
-            xran_tx_sym_from_ring(p_xran_dev_ctx, ring, vf_id);
+            xran_tx_sym_from_ring(p_xran_dev_ctx, ring, eth_ctx->io_cfg.port[vf_id], vf_id);
         }
     }
     MLogXRANTask(PID_RADIO_ETH_TX_BURST, t1, MLogXRANTick());
@@ -1389,6 +1381,7 @@ xran_process_tx_sym_cp_on_ring_opt(void* pHandle, int32_t start_cc, int32_t num_
     long t1 = MLogXRANTick();
     struct rte_ring *ring = NULL;
     struct xran_device_ctx* p_xran_dev_ctx = (struct xran_device_ctx*)pHandle;
+    struct xran_ethdi_ctx* eth_ctx = xran_ethdi_get_ctx();
     int32_t cc_id  = 0;
     int32_t ant_id = 0;
     uint16_t vf_id = 0;
@@ -1414,7 +1407,7 @@ xran_process_tx_sym_cp_on_ring_opt(void* pHandle, int32_t start_cc, int32_t num_
             vf_id = p_xran_dev_ctx->map2vf[direction][cc_id][ru_port_id][XRAN_UP_VF];
 
             ring    = p_xran_dev_ctx->perMu[mu].sFrontHaulTxBbuIoBufCtrl[tti_for_ring % XRAN_N_FE_BUF_LEN][cc_id][ant_id].sBufferList.pBuffers[sym_id_for_ring].pRing;
-            xran_tx_sym_from_ring(p_xran_dev_ctx, ring, vf_id);
+            xran_tx_sym_from_ring(p_xran_dev_ctx, ring, eth_ctx->io_cfg.port[vf_id], vf_id);
         }
     }
     MLogXRANTask(PID_RADIO_ETH_TX_BURST, t1, MLogXRANTick());
@@ -1530,7 +1523,7 @@ int32_t xran_process_tx_sym_cp_on_opt(void* pHandle, uint8_t ctx_id, uint32_t tt
                     ant_index = ant_id - p_xran_dev_ctx->vMuInfo.ssbInfo.ruPortId_offset;
                 }
             }
-            ptr_sect_elm = p_sec_db->p_sectiondb_elm[ctx_id][direction][cc_id][ant_id];
+            ptr_sect_elm = xran_sectiondb_elm(p_sec_db, ctx_id, direction, cc_id, ant_id);
             if(unlikely(ptr_sect_elm == NULL))
             {
                 rte_panic("ptr_sect_elm == NULL\n");
@@ -1899,7 +1892,7 @@ int32_t xran_process_tx_sym_cp_on_opt(void* pHandle, uint8_t ctx_id, uint32_t tt
         } /* for(cc_id = 0; cc_id < num_CCPorts; cc_id++) */
     } /* for(ant_id = 0; ant_id < num_eAxc; ant_id++) */
 
-    struct xran_common_counters* pCnt = &p_xran_dev_ctx->fh_counters;
+    struct xran_common_counters* pCnt = xran_fh_counters(p_xran_dev_ctx);
     pCnt->tx_counter += total_sections;
     pCnt->tx_bytes_counter += elm_bytes;
 
@@ -1961,7 +1954,7 @@ xran_process_tx_srs_cp_on(void* pHandle, uint8_t ctx_id, uint32_t tti, int32_t s
         for (ant_id = start_ant; ant_id < (start_ant + num_ant); ant_id++)
         {
             antElm_eAxC_id  = ant_id + p_srs_cfg->srsEaxcOffset;
-            ptr_sect_elm = p_sec_db->p_sectiondb_elm[ctx_id][direction][cc_id][antElm_eAxC_id];
+            ptr_sect_elm = xran_sectiondb_elm(p_sec_db, ctx_id, direction, cc_id, antElm_eAxC_id);
 
             if (unlikely(ptr_sect_elm == NULL)){
                 printf("ant_id = %d ctx_id = %d,start_ant = %d, num_ant = %d, antElm_eAxC_id = %d\n",ant_id,ctx_id,start_ant,num_ant,antElm_eAxC_id);
@@ -2195,7 +2188,7 @@ xran_process_tx_srs_cp_on(void* pHandle, uint8_t ctx_id, uint32_t tti, int32_t s
         } /* for(cc_id = 0; cc_id < num_CCPorts; cc_id++) */
     } /* for(ant_id = 0; ant_id < num_eAxc; ant_id++) */
 
-    struct xran_common_counters* pCnt = &p_xran_dev_ctx->fh_counters;
+    struct xran_common_counters* pCnt = xran_fh_counters(p_xran_dev_ctx);
     pCnt->tx_counter += total_sections;
     pCnt->tx_bytes_counter += elm_bytes;
     return 1;
@@ -2265,7 +2258,7 @@ xran_process_tx_csirs_cp_on(void* pHandle, uint8_t ctx_id, uint32_t tti, int32_t
                 mb_base = p_xran_dev_ctx->perMu[mu].sFHCsirsTxBbuIoBufCtrl[tti % XRAN_N_FE_BUF_LEN][cc_id][ant_id].sBufferList.pBuffers[sym_id].pCtrl;
             else
                 continue;
-            ptr_sect_elm = p_sec_db->p_sectiondb_elm[ctx_id][direction][cc_id][antElm_eAxC_id];
+            ptr_sect_elm = xran_sectiondb_elm(p_sec_db, ctx_id, direction, cc_id, antElm_eAxC_id);
 
             if (unlikely(ptr_sect_elm == NULL)){
                 printf("ant_id = %d ctx_id = %d,start_ant = %d, num_ant = %d, antElm_eAxC_id = %d\n",ant_id,ctx_id,start_ant,num_ant,antElm_eAxC_id);
@@ -2523,7 +2516,7 @@ xran_process_tx_csirs_cp_on(void* pHandle, uint8_t ctx_id, uint32_t tti, int32_t
         } /* for(cc_id = 0; cc_id < num_CCPorts; cc_id++) */
     } /* for(ant_id = 0; ant_id < num_eAxc; ant_id++) */
 
-    struct xran_common_counters* pCnt = &p_xran_dev_ctx->fh_counters;
+    struct xran_common_counters* pCnt = xran_fh_counters(p_xran_dev_ctx);
     pCnt->tx_counter += total_sections;
     pCnt->tx_bytes_counter += elm_bytes;
     return 1;
@@ -2532,6 +2525,7 @@ int32_t xran_process_tx_sym_oru(void *arg, uint8_t mu)
 {
     int32_t     retval = 0;
     uint32_t    tti=0;
+    const struct xran_occ_slot *pOcc;
     uint32_t    numSlotMu1 = 5;
 #if XRAN_MLOG_VAR
     uint32_t    mlogVar[15];
@@ -2583,6 +2577,7 @@ int32_t xran_process_tx_sym_oru(void *arg, uint8_t mu)
     tti         = XranGetTtiNum(sym_idx, XRAN_NUM_OF_SYMBOL_PER_SLOT);
     slot_id     = XranGetSlotNum(tti, SLOTNUM_PER_SUBFRAME(interval));
     subframe_id = XranGetSubFrameNum(tti,SLOTNUM_PER_SUBFRAME(interval),  SUBFRAMES_PER_SYSTEMFRAME);
+    pOcc        = xran_occ_get(&p_xran_dev_ctx->perMu[mu].occTbl, tti);
 
     uint16_t sfnSecStart = xran_getSfnSecStart();
     if(unlikely(inPeriod == XRAN_IN_NEXT_PERIOD))
@@ -2675,13 +2670,10 @@ int32_t xran_process_tx_sym_oru(void *arg, uint8_t mu)
                 enum xran_comp_hdr_type compType;
                 PSECTION_DB_TYPE p_sec_db = NULL;
 
-                if(xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_UL, mu) ==  1
-                    || xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1
-                    || xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_FDD, mu) ==  1)
+                if(pOcc->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_FDD)))
                 {
 
-                    if(xran_fs_get_symbol_type(portId, cc_id, tti, sym_id, mu) == XRAN_SYMBOL_TYPE_UL
-                        || xran_fs_get_symbol_type(portId, cc_id, tti, sym_id, mu) == XRAN_SYMBOL_TYPE_FDD)
+                    if((pOcc->ulSym >> sym_id) & 1)
                     {
 
                         uint8_t loc_ret = 1;
@@ -2710,7 +2702,12 @@ int32_t xran_process_tx_sym_oru(void *arg, uint8_t mu)
 
                         if (loc_ret)
                         {
-                            xran_process_tx_sym_cp_on_opt(pHandle, ctx_id, tti,
+                            if(p_xran_dev_ctx->ruLoadGen)
+                                xran_ru_loadgen_dispatch(pHandle, ctx_id, tti,
+                                                0, num_CCPorts, eaxcOffset, num_eAxc, frame_id, subframe_id, slot_id, sym_id,
+                                                compType, XRAN_DIR_UL, portId, p_sec_db, mu, tti, sym_id, 0);
+                            else
+                                xran_process_tx_sym_cp_on_opt(pHandle, ctx_id, tti,
                                                 0, num_CCPorts, eaxcOffset, num_eAxc, frame_id, subframe_id, slot_id, sym_id,
                                                 compType, XRAN_DIR_UL, portId, p_sec_db, mu, tti, sym_id, 0);
                         }
@@ -2767,10 +2764,9 @@ int32_t xran_process_tx_sym_oru(void *arg, uint8_t mu)
                         }
                     }
                     /* check special frame or uplink frame*/
-                    else  if((xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1)
-                        || (xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_UL, mu) ==  1))
+                    else  if(pOcc->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL)))
                     {
-                        if(((tti % p_xran_dev_ctx->fh_cfg.frame_conf.nTddPeriod) == pSrsCfg->slot)
+                        if((pOcc->slotType & XRAN_OCC_SLOT_SRS)
                             && (p_xran_dev_ctx->ndm_srs_scheduled == 0))
                         {
 
@@ -2879,10 +2875,9 @@ int32_t xran_process_tx_sym_oru(void *arg, uint8_t mu)
                         }
                     }
                     /* check special frame or uplink frame */
-                    else if((xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1) ||
-                        (xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_UL, mu) ==  1))
+                    else if(pOcc->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL)))
                     {
-                        if(((tti % p_xran_dev_ctx->fh_cfg.frame_conf.nTddPeriod) == pSrsCfg->slot)
+                        if((pOcc->slotType & XRAN_OCC_SLOT_SRS)
                             && (p_xran_dev_ctx->ndm_srs_scheduled == 0))
                         {
                             struct xran_prb_map *prb_map;
@@ -2975,6 +2970,7 @@ int32_t xran_process_tx_sym(void *arg, uint8_t mu)
 {
     int32_t     retval = 0;
     uint32_t    tti=0;
+    const struct xran_occ_slot *pOcc;
     uint32_t    numSlotMu1 = 5;
 #if XRAN_MLOG_VAR
     uint32_t    mlogVar[15];
@@ -3052,6 +3048,7 @@ int32_t xran_process_tx_sym(void *arg, uint8_t mu)
     tti         = XranGetTtiNum(sym_idx, XRAN_NUM_OF_SYMBOL_PER_SLOT);
     slot_id     = XranGetSlotNum(tti, SLOTNUM_PER_SUBFRAME(interval));
     subframe_id = XranGetSubFrameNum(tti,SLOTNUM_PER_SUBFRAME(interval),  SUBFRAMES_PER_SYSTEMFRAME);
+    pOcc        = xran_occ_get(&p_xran_dev_ctx->perMu[mu].occTbl, tti);
 
     uint16_t sfnSecStart = xran_getSfnSecStart();
     if(unlikely(inPeriod == XRAN_IN_NEXT_PERIOD))
@@ -3239,13 +3236,10 @@ int32_t xran_process_tx_sym(void *arg, uint8_t mu)
                 enum xran_comp_hdr_type compType;
                 PSECTION_DB_TYPE p_sec_db = NULL;
 
-                if(xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_UL, mu) ==  1
-                    || xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1
-                    || xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_FDD, mu) ==  1)
+                if(pOcc->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_FDD)))
                 {
 
-                    if(xran_fs_get_symbol_type(portId, cc_id, tti, sym_id, mu) == XRAN_SYMBOL_TYPE_UL
-                        || xran_fs_get_symbol_type(portId, cc_id, tti, sym_id, mu) == XRAN_SYMBOL_TYPE_FDD)
+                    if((pOcc->ulSym >> sym_id) & 1)
                     {
 
                         uint8_t loc_ret = 1;
@@ -3273,7 +3267,12 @@ int32_t xran_process_tx_sym(void *arg, uint8_t mu)
 
                         if (loc_ret)
                         {
-                            xran_process_tx_sym_cp_on_opt(pHandle, ctx_id, tti,
+                            if(p_xran_dev_ctx->ruLoadGen)
+                                xran_ru_loadgen_dispatch(pHandle, ctx_id, tti,
+                                                0, num_CCPorts, eaxcOffset, num_eAxc, frame_id, subframe_id, slot_id, sym_id,
+                                                compType, XRAN_DIR_UL, portId, p_sec_db, mu, tti, sym_id, 0);
+                            else
+                                xran_process_tx_sym_cp_on_opt(pHandle, ctx_id, tti,
                                                 0, num_CCPorts, eaxcOffset, num_eAxc, frame_id, subframe_id, slot_id, sym_id,
                                                 compType, XRAN_DIR_UL, portId, p_sec_db, mu, tti, sym_id, 0);
                         }
@@ -3330,10 +3329,9 @@ int32_t xran_process_tx_sym(void *arg, uint8_t mu)
                         }
                     }
                     /* check special frame or uplink frame*/
-                    else  if((xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1)
-                        || (xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_UL, mu) ==  1))
+                    else  if(pOcc->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL)))
                     {
-                        if(((tti % p_xran_dev_ctx->fh_cfg.frame_conf.nTddPeriod) == pSrsCfg->slot)
+                        if((pOcc->slotType & XRAN_OCC_SLOT_SRS)
                             && (p_xran_dev_ctx->ndm_srs_scheduled == 0))
                         {
 
@@ -3446,10 +3444,9 @@ int32_t xran_process_tx_sym(void *arg, uint8_t mu)
                             }
                         }
                         /* check special frame or uplink frame */
-                        else if((xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1) ||
-                            (xran_fs_get_slot_type(portId, cc_id, tti, XRAN_SLOT_TYPE_UL, mu) ==  1))
+                        else if(pOcc->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL)))
                         {
-                            if(((tti % p_xran_dev_ctx->fh_cfg.frame_conf.nTddPeriod) == pSrsCfg->slot)
+                            if((pOcc->slotType & XRAN_OCC_SLOT_SRS)
                                 && (p_xran_dev_ctx->ndm_srs_scheduled == 0))
                             {
                                 struct xran_prb_map *prb_map;
@@ -3591,6 +3588,7 @@ xran_prepare_up_ul_tx_sym(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nC
     uint32_t subframe_id        = 0;
     uint32_t frame_id   = 0;
     uint32_t tti        = 0;
+    const struct xran_occ_slot *pOcc;
     uint32_t slot_id    = 0;
     uint32_t sym_id     = 0;
     uint32_t idxSym     = 0;
@@ -3634,6 +3632,7 @@ xran_prepare_up_ul_tx_sym(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nC
             tti_for_ring = XranGetTtiNum(sym_idx_for_ring, XRAN_NUM_OF_SYMBOL_PER_SLOT);
             slot_id     = XranGetSlotNum(tti, SLOTNUM_PER_SUBFRAME(interval));
             subframe_id = XranGetSubFrameNum(tti,SLOTNUM_PER_SUBFRAME(interval),  SUBFRAMES_PER_SYSTEMFRAME);
+            pOcc        = xran_occ_get(&p_xran_dev_ctx->perMu[mu].occTbl, tti);
 
             frame_id    =  (nSlotIdx / SLOTS_PER_SYSTEMFRAME(interval)) & 0x3FF;
             // ORAN frameId, 8 bits, [0, 255]
@@ -3701,12 +3700,9 @@ xran_prepare_up_ul_tx_sym(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nC
                     enum xran_comp_hdr_type compType;
                     PSECTION_DB_TYPE p_sec_db = NULL;
 
-                    if(xran_fs_get_slot_type(PortId, cc_id, tti, XRAN_SLOT_TYPE_UL, mu) ==  1
-                        || xran_fs_get_slot_type(PortId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1
-                        || xran_fs_get_slot_type(PortId, cc_id, tti, XRAN_SLOT_TYPE_FDD, mu) ==  1){
+                    if(pOcc->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_FDD))){
 
-                        if(xran_fs_get_symbol_type(PortId, cc_id, tti, sym_id, mu) == XRAN_SYMBOL_TYPE_UL
-                            || xran_fs_get_symbol_type(PortId, cc_id, tti, sym_id, mu) == XRAN_SYMBOL_TYPE_FDD){
+                        if((pOcc->ulSym >> sym_id) & 1){
 
                             uint8_t loc_ret = 1;
                             compType = p_xran_dev_ctx->fh_cfg.ru_conf.xranCompHdrType;
@@ -3790,10 +3786,9 @@ xran_prepare_up_ul_tx_sym(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nC
                             }
                         }
                         /* check special frame or uplink frame*/
-                        else  if((xran_fs_get_slot_type(PortId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1)
-                            || (xran_fs_get_slot_type(PortId, cc_id, tti, XRAN_SLOT_TYPE_UL, mu) ==  1))
+                        else  if(pOcc->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL)))
                         {
-                            if(((tti % p_xran_dev_ctx->fh_cfg.frame_conf.nTddPeriod) == pSrsCfg->slot)
+                            if((pOcc->slotType & XRAN_OCC_SLOT_SRS)
                                 && (p_xran_dev_ctx->ndm_srs_scheduled == 0))
                             {
 
@@ -3884,10 +3879,9 @@ xran_prepare_up_ul_tx_sym(uint16_t xran_port_id, uint32_t nSlotIdx,  uint32_t nC
                             }
 
                             /* check special frame or uplink frame */
-                            else if((xran_fs_get_slot_type(PortId, cc_id, tti, XRAN_SLOT_TYPE_SP, mu) ==  1) ||
-                                (xran_fs_get_slot_type(PortId, cc_id, tti, XRAN_SLOT_TYPE_UL, mu) ==  1))
+                            else if(pOcc->slotType & (XRAN_OCC_SLOT(XRAN_SLOT_TYPE_SP) | XRAN_OCC_SLOT(XRAN_SLOT_TYPE_UL)))
                             {
-                                if(((tti % p_xran_dev_ctx->fh_cfg.frame_conf.nTddPeriod) == pSrsCfg->slot)
+                                if((pOcc->slotType & XRAN_OCC_SLOT_SRS)
                                     && (p_xran_dev_ctx->ndm_srs_scheduled == 0))
                                 {
                                     struct xran_prb_map *prb_map;
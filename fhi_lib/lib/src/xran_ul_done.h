@@ -0,0 +1,213 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/**
+ * @brief XRAN early UL completion based on received PRB accounting
+ * @file xran_ul_done.h
+ * @ingroup group_source_xran
+ * @author Intel Corporation
+ *
+ * When the UL C-plane of a slot is sent, the PRBs every section of the RX
+ * PRB maps covers are added per symbol over all eAxC of the CC. Every U-plane
+ * section received for the slot adds its PRBs to the symbol, and the symbol
+ * is complete the moment the received count reaches the expected one. The
+ * slot is complete when its last expected symbol is. A lost or dropped
+ * section leaves the symbol incomplete and the UL deadline callbacks report
+ * the slot as before.
+ *
+ * The RX path completing a UL slot and the full slot deadline both claim
+ * the slot of the CC with a compare and swap, and only the winner reports
+ * it, so every UL slot of a CC is reported exactly once.
+ *
+ * The accounting is reset for every slot the C-plane is prepared for, so a
+ * buffer entry is never reused with the counts of a slot XRAN_N_FE_BUF_LEN
+ * earlier.
+ **/
+
+#ifndef _XRAN_UL_DONE_H_
+#define _XRAN_UL_DONE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include "xran_fh_o_du.h"
+
+#define XRAN_UL_DONE_SYM    (1 << 0)    /**< the symbol of the section is complete */
+#define XRAN_UL_DONE_ALL    (1 << 1)    /**< every expected symbol of the slot is complete */
+
+/** PRB accounting of one slot of a CC */
+struct xran_ul_done_slot {
+    uint32_t tti;                                       /**< slot the accounting is armed for */
+    uint32_t nSymExp;                                   /**< symbols with PRBs expected */
+    uint32_t nSymPending;                               /**< expected symbols not complete yet */
+    uint32_t isUl;                                      /**< UL slot, reported early or at the deadline */
+    uint32_t claimed;                                   /**< slot reported, set by the first reporter */
+    uint32_t nPrbExp[XRAN_NUM_OF_SYMBOL_PER_SLOT];      /**< PRBs expected over all eAxC */
+    uint32_t nPrbRx[XRAN_NUM_OF_SYMBOL_PER_SLOT];       /**< PRBs received over all eAxC */
+};
+
+/**
+ * @brief Start the accounting of a slot, nothing is expected
+ *
+ * @param pSlot accounting of the slot buffer entry
+ * @param tti slot reported to the callback
+ */
+static inline void xran_ul_done_reset(struct xran_ul_done_slot *pSlot, uint32_t tti)
+{
+    /* disarm first, RX of a late section of the previous slot sees nothing expected */
+    __atomic_store_n(&pSlot->nSymExp, 0, __ATOMIC_RELEASE);
+    memset(pSlot->nPrbExp, 0, sizeof(pSlot->nPrbExp));
+    memset(pSlot->nPrbRx, 0, sizeof(pSlot->nPrbRx));
+    pSlot->nSymPending = 0;
+    __atomic_store_n(&pSlot->isUl, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&pSlot->claimed, 0, __ATOMIC_RELAXED);
+    pSlot->tti = tti;
+}
+
+/**
+ * @brief Add the PRBs the sections of one eAxC are expected to carry
+ *
+ * @param pSlot accounting of the slot buffer entry
+ * @param pPrbMap RX PRB map the UL C-plane is generated from
+ */
+static inline void xran_ul_done_expect(struct xran_ul_done_slot *pSlot, const struct xran_prb_map *pPrbMap)
+{
+    const struct xran_prb_elm *pElm;
+    int32_t sym, symEnd;
+    uint32_t i;
+
+    for(i = 0; i < pPrbMap->nPrbElm; i++)
+    {
+        pElm = &pPrbMap->prbMap[i];
+        if(pElm->nRBSize <= 0 || pElm->nStartSymb < 0)
+            continue;
+
+        symEnd = pElm->nStartSymb + pElm->numSymb;
+        if(symEnd > XRAN_NUM_OF_SYMBOL_PER_SLOT)
+            symEnd = XRAN_NUM_OF_SYMBOL_PER_SLOT;
+        for(sym = pElm->nStartSymb; sym < symEnd; sym++)
+            pSlot->nPrbExp[sym] += pElm->nRBSize;
+    }
+}
+
+/**
+ * @brief Arm the slot once every eAxC has been added
+ *
+ * @param pSlot accounting of the slot buffer entry
+ * @return number of symbols with PRBs expected, 0 leaves the slot to the deadline
+ */
+static inline uint32_t xran_ul_done_arm(struct xran_ul_done_slot *pSlot)
+{
+    uint32_t sym, nSymExp = 0;
+
+    __atomic_store_n(&pSlot->isUl, 1, __ATOMIC_RELEASE);
+
+    for(sym = 0; sym < XRAN_NUM_OF_SYMBOL_PER_SLOT; sym++)
+        if(pSlot->nPrbExp[sym])
+            nSymExp++;
+
+    pSlot->nSymPending = nSymExp;
+    __atomic_store_n(&pSlot->nSymExp, nSymExp, __ATOMIC_RELEASE);
+
+    return nSymExp;
+}
+
+/**
+ * @brief Account one received U-plane section
+ *
+ * @param pSlot accounting of the slot buffer entry
+ * @param symb symbol of the section
+ * @param num_prbu PRBs carried by the section
+ * @return 0, or XRAN_UL_DONE_SYM and XRAN_UL_DONE_ALL for the section
+ *         completing its symbol and the slot, each reported once
+ */
+static inline uint32_t xran_ul_done_rx(struct xran_ul_done_slot *pSlot, uint8_t symb, uint16_t num_prbu)
+{
+    uint32_t nPrbExp, nPrbRx;
+
+    if(__atomic_load_n(&pSlot->nSymExp, __ATOMIC_ACQUIRE) == 0 || symb >= XRAN_NUM_OF_SYMBOL_PER_SLOT)
+        return 0;
+
+    nPrbExp = pSlot->nPrbExp[symb];
+    if(nPrbExp == 0)
+        return 0;
+
+    /* only the section crossing the expected count completes the symbol */
+    nPrbRx = __atomic_add_fetch(&pSlot->nPrbRx[symb], num_prbu, __ATOMIC_ACQ_REL);
+    if(nPrbRx < nPrbExp || nPrbRx - num_prbu >= nPrbExp)
+        return 0;
+
+    if(__atomic_sub_fetch(&pSlot->nSymPending, 1, __ATOMIC_ACQ_REL) == 0)
+        return (XRAN_UL_DONE_SYM | XRAN_UL_DONE_ALL);
+
+    return XRAN_UL_DONE_SYM;
+}
+
+/**
+ * @brief Check whether a slot was reported complete
+ *
+ * @param pSlot accounting of the slot buffer entry
+ * @param tti slot the deadline is reached for
+ * @return 1 if every expected PRB of tti was received, 0 otherwise
+ */
+static inline int32_t xran_ul_done_complete(struct xran_ul_done_slot *pSlot, uint32_t tti)
+{
+    return (__atomic_load_n(&pSlot->nSymExp, __ATOMIC_ACQUIRE) != 0
+            && pSlot->tti == tti
+            && __atomic_load_n(&pSlot->nSymPending, __ATOMIC_ACQUIRE) == 0);
+}
+
+/**
+ * @brief Claim the report of a slot
+ *
+ * @param pSlot accounting of the slot buffer entry
+ * @return 1 for the one caller that reports the slot, 0 if it was reported already
+ */
+static inline int32_t xran_ul_done_claim(struct xran_ul_done_slot *pSlot)
+{
+    uint32_t expected = 0;
+
+    return __atomic_compare_exchange_n(&pSlot->claimed, &expected, 1, 0,
+                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Claim the report of a UL slot at its deadline
+ *
+ * @param pSlot accounting of the slot buffer entry
+ * @param tti slot the deadline is reached for
+ * @return 1 if tti is a UL slot the RX path did not report complete, it is
+ *         reported by the caller, 0 otherwise
+ */
+static inline int32_t xran_ul_done_claim_deadline(struct xran_ul_done_slot *pSlot, uint32_t tti)
+{
+    if(!__atomic_load_n(&pSlot->isUl, __ATOMIC_ACQUIRE) || pSlot->tti != tti)
+        return 0;
+
+    return xran_ul_done_claim(pSlot);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _XRAN_UL_DONE_H_ */
@@ -1114,6 +1114,118 @@ TEST_P(C_plane, CPacketGen)
     verify_sections();
 }
 
+TEST_P(C_plane, Ext11BfwCache)
+{
+    struct xran_cp_bfw_cache *pCache;
+    struct xran_cp_bfw_cache_stats stats;
+    struct xran_sectionext11_info *ext11;
+    std::vector<uint8_t> ref(MAX_RX_LEN, 0), out(MAX_RX_LEN, 0);
+    uint32_t hdr_offset;
+    uint8_t disableBFWs;
+    int16_t saved;
+    int ref_len, len, i;
+
+    if(prepare_sections() < 0) {
+        FAIL() << "Invalid Section configuration\n";
+        }
+    if(prepare_extensions() < 0) {
+        FAIL() << "Invalid Section extension configuration\n";
+        }
+    if(m_nextcfgs == 0 || m_extcfgs[0].type != XRAN_CP_SECTIONEXTCMD_11)
+        return;
+
+    ext11 = &m_extcfgs[0].u.ext11;
+    ref_len = xran_cp_prepare_ext11_bfws(ext11->numSetBFWs, m_antElmTRx, ext11->bfwIqWidth, ext11->bfwCompMeth,
+                                ref.data(), XRAN_MAX_BUFLEN_EXT11, m_bfwInfo);
+    ASSERT_GT(ref_len, 0);
+
+    /* Cached sets are the same as compressed ones */
+    pCache = xran_cp_bfw_cache_create(XRAN_CP_BFW_CACHE_DEF_ENTRIES, m_antElmTRx, 0);
+    ASSERT_FALSE(pCache == nullptr);
+    for(i = 0; i < 2; i++) {
+        std::fill(out.begin(), out.end(), 0);
+        len = xran_cp_prepare_ext11_bfws_cached(pCache, m_antId, ext11->numSetBFWs, m_antElmTRx,
+                                ext11->bfwIqWidth, ext11->bfwCompMeth,
+                                out.data(), XRAN_MAX_BUFLEN_EXT11, m_bfwInfo, &disableBFWs);
+        ASSERT_EQ(len, ref_len);
+        EXPECT_EQ(disableBFWs, 0);
+        EXPECT_TRUE(out == ref);
+        }
+    xran_cp_bfw_cache_get_stats(pCache, &stats);
+    if(ext11->bfwCompMeth == XRAN_BFWCOMPMETHOD_BLKFLOAT) {
+        EXPECT_EQ(stats.lookups, 2 * (uint64_t)ext11->numSetBFWs);
+        EXPECT_EQ(stats.misses, (uint64_t)ext11->numSetBFWs);
+        EXPECT_EQ(stats.hits, (uint64_t)ext11->numSetBFWs);
+        }
+    else {  /* nothing to save without compression */
+        EXPECT_EQ(stats.bypass, 2u);
+        }
+    xran_cp_bfw_cache_free(pCache);
+
+    /* beamIds only once the O-RU has all the weights */
+    pCache = xran_cp_bfw_cache_create(XRAN_CP_BFW_CACHE_DEF_ENTRIES, m_antElmTRx, 1);
+    ASSERT_FALSE(pCache == nullptr);
+    len = xran_cp_prepare_ext11_bfws_cached(pCache, m_antId, ext11->numSetBFWs, m_antElmTRx,
+                            ext11->bfwIqWidth, ext11->bfwCompMeth,
+                            out.data(), XRAN_MAX_BUFLEN_EXT11, m_bfwInfo, &disableBFWs);
+    ASSERT_EQ(len, ref_len);
+    EXPECT_EQ(disableBFWs, 0);
+
+    len = xran_cp_prepare_ext11_bfws_cached(pCache, m_antId, ext11->numSetBFWs, m_antElmTRx,
+                            ext11->bfwIqWidth, ext11->bfwCompMeth,
+                            out.data(), XRAN_MAX_BUFLEN_EXT11, m_bfwInfo, &disableBFWs);
+    EXPECT_EQ(disableBFWs, 1);
+    /* bfwCompHdr is not present with disableBFWs=1 */
+    EXPECT_EQ((len + sizeof(union xran_cp_radioapp_section_ext11) - 1) % XRAN_SECTIONEXT_ALIGN, 0u);
+    EXPECT_GE(len, ext11->numSetBFWs * 2);
+    EXPECT_LT(len, ext11->numSetBFWs * 2 + XRAN_SECTIONEXT_ALIGN);
+    hdr_offset = RTE_PKTMBUF_HEADROOM + sizeof(struct xran_ecpri_hdr) + sizeof(struct xran_cp_radioapp_section1_header)
+                    + sizeof(struct xran_cp_radioapp_section1) + sizeof(union xran_cp_radioapp_section_ext11) - 1;
+    for(i = 0; i < ext11->numSetBFWs; i++) {
+#ifdef XRAN_CP_BF_WEIGHT_STRUCT_OPT
+        EXPECT_EQ(rte_be_to_cpu_16(*(uint16_t *)&out[hdr_offset + i*2]), m_bfwInfo[0].beamId[i] & 0x7fff);
+#else
+        EXPECT_EQ(rte_be_to_cpu_16(*(uint16_t *)&out[hdr_offset + i*2]), m_bfwInfo[i].beamId & 0x7fff);
+#endif
+        }
+
+    /* New weights for one beam have to be sent again */
+    saved = m_pBfw_src[0][0];
+    m_pBfw_src[0][0] = ~saved;
+    ref_len = xran_cp_prepare_ext11_bfws(ext11->numSetBFWs, m_antElmTRx, ext11->bfwIqWidth, ext11->bfwCompMeth,
+                                ref.data(), XRAN_MAX_BUFLEN_EXT11, m_bfwInfo);
+    std::fill(out.begin(), out.end(), 0);
+    len = xran_cp_prepare_ext11_bfws_cached(pCache, m_antId, ext11->numSetBFWs, m_antElmTRx,
+                            ext11->bfwIqWidth, ext11->bfwCompMeth,
+                            out.data(), XRAN_MAX_BUFLEN_EXT11, m_bfwInfo, &disableBFWs);
+    m_pBfw_src[0][0] = saved;
+    ASSERT_EQ(len, ref_len);
+    EXPECT_EQ(disableBFWs, 0);
+    EXPECT_TRUE(out == ref);
+
+    xran_cp_bfw_cache_get_stats(pCache, &stats);
+    EXPECT_EQ(stats.beamIdOnly, 1u);
+    EXPECT_EQ(stats.updates, 1u);
+    EXPECT_EQ(stats.misses, (uint64_t)ext11->numSetBFWs + 1);
+
+    /* Same hash with other weights, as after a collision: the weights are compared */
+    for(i = 0; i < (int)pCache->nEntries; i++)
+        if(pCache->pEntries[i].valid)
+            pCache->pEntries[i].pBFWs[0] ^= 1;
+    ref_len = xran_cp_prepare_ext11_bfws(ext11->numSetBFWs, m_antElmTRx, ext11->bfwIqWidth, ext11->bfwCompMeth,
+                                ref.data(), XRAN_MAX_BUFLEN_EXT11, m_bfwInfo);
+    std::fill(out.begin(), out.end(), 0);
+    len = xran_cp_prepare_ext11_bfws_cached(pCache, m_antId, ext11->numSetBFWs, m_antElmTRx,
+                            ext11->bfwIqWidth, ext11->bfwCompMeth,
+                            out.data(), XRAN_MAX_BUFLEN_EXT11, m_bfwInfo, &disableBFWs);
+    ASSERT_EQ(len, ref_len);
+    EXPECT_EQ(disableBFWs, 0);
+    EXPECT_TRUE(out == ref);
+    xran_cp_bfw_cache_get_stats(pCache, &stats);
+    EXPECT_EQ(stats.updates, 1u + ext11->numSetBFWs);
+    xran_cp_bfw_cache_free(pCache);
+}
+
 /***************************************************************************
  * Performance Test cases
  ***************************************************************************/
@@ -1134,6 +1246,35 @@ TEST_P(C_plane, Perf)
             &xran_ut_prepare_cp, &m_params, m_ccId, m_antId, m_seqId, 0, m_mu, XRAN_GET_OXU_PORT_ID(&m_xran_dev_ctx));
 }
 
+TEST_P(C_plane, Ext11BfwCachePerf)
+{
+    struct xran_cp_bfw_cache *pCache;
+    struct xran_sectionext11_info *ext11;
+    uint8_t disableBFWs;
+
+    if(prepare_sections() < 0) {
+        FAIL() << "Invalid Section configuration\n";
+        }
+    if(prepare_extensions() < 0) {
+        FAIL() << "Invalid Section extension configuration\n";
+        }
+    if(m_nextcfgs == 0 || m_extcfgs[0].type != XRAN_CP_SECTIONEXTCMD_11)
+        return;
+
+    ext11 = &m_extcfgs[0].u.ext11;
+    pCache = xran_cp_bfw_cache_create(XRAN_CP_BFW_CACHE_DEF_ENTRIES, m_antElmTRx, 0);
+    ASSERT_FALSE(pCache == nullptr);
+
+    performance("C", module_name, &xran_cp_prepare_ext11_bfws,
+            ext11->numSetBFWs, (uint8_t)m_antElmTRx, ext11->bfwIqWidth, ext11->bfwCompMeth,
+            m_pBfwIQ_ext, (int16_t)XRAN_MAX_BUFLEN_EXT11, m_bfwInfo);
+    performance("C", module_name, &xran_cp_prepare_ext11_bfws_cached, pCache, (uint16_t)m_antId,
+            ext11->numSetBFWs, (uint8_t)m_antElmTRx, ext11->bfwIqWidth, ext11->bfwCompMeth,
+            m_pBfwIQ_ext, (int16_t)XRAN_MAX_BUFLEN_EXT11, m_bfwInfo, &disableBFWs);
+
+    xran_cp_bfw_cache_free(pCache);
+}
+
 
 
 INSTANTIATE_TEST_CASE_P(UnitTest, C_plane,
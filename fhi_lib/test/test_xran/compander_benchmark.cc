@@ -0,0 +1,565 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/*
+ * Compander micro-benchmark suite.
+ *
+ * Sweeps compMethod x ISA x iqWidth x numRBs x antenna count for the U-plane
+ * kernels and iqWidth x antenna count for the C-plane BFW kernels. Every point
+ * is measured with hot cache (back to back calls on the same buffers) and cold
+ * cache (input and output lines flushed to memory before every call), and is
+ * reported as cycles per call, cycles per PRB (per beam for BFWs), GB/s of
+ * uncompressed IQ and the ratio to a memcpy of the same number of bytes run
+ * under the same cache conditions.
+ *
+ * Results are printed as a table and written to <output>.json and <output>.csv
+ * for post processing.
+ */
+
+#include "common.hpp"
+#include "xran_fh_o_du.h"
+#include "xran_compression.h"
+#include "xran_compression.hpp"
+#include "xran_mod_compression.h"
+
+#include <stdint.h>
+#include <random>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+
+const std::string module_name = "compander_benchmark";
+
+extern int _may_i_use_cpu_feature(unsigned __int64);
+
+namespace
+{
+    constexpr int k_numRePerRb = 12;
+    constexpr int k_bytesPerRe = 4;     /* 16 bit I + 16 bit Q */
+    constexpr int k_cacheLine = 64;
+
+    struct BenchPoint
+    {
+        std::string plane;      /* "UP" or "CP" */
+        std::string isa;
+        std::string direction;  /* "comp" or "decomp" */
+        std::string cache;      /* "hot" or "cold" */
+        int compMethod;
+        int iqWidth;
+        int numRBs;             /* RBs per antenna (UP) or number of beams (CP) */
+        int antElm;
+        double cycles;          /* per call */
+        double cyclesPerUnit;   /* per PRB (UP) or per beam (CP) */
+        double gbps;            /* uncompressed bytes per second */
+        double memcpyGbps;
+        double ratioToMemcpy;
+    };
+
+    inline int align_up(const int v)
+    {
+        return (v + k_cacheLine - 1) & ~(k_cacheLine - 1);
+    }
+
+    /* compressed size of numRBs RBs for one antenna */
+    inline int comp_bytes_per_ant(const int compMethod, const int iqWidth, const int numRBs)
+    {
+        if (compMethod == XRAN_COMPMETHOD_MODULATION)
+            return (numRBs * k_numRePerRb * 2 * iqWidth + 7) >> 3;
+        return ((3 * iqWidth) + 1) * numRBs;
+    }
+
+    /* modulation compression unit per modulation order, as used by the functional tests */
+    inline int16_t mod_unit(const int modulation)
+    {
+        switch (modulation) {
+            case XRAN_QPSK:   return 8192;
+            case XRAN_QAM16:  return 10360;
+            case XRAN_QAM64:  return 5064;
+            case XRAN_QAM256: return 7168;
+            default:          return 0;
+        }
+    }
+}
+
+class CompanderBenchmark : public KernelTests
+{
+protected:
+    std::vector<std::string> isas;
+    std::vector<std::string> caches;
+    std::vector<int16_t> compMethods;
+    std::vector<int16_t> iqWidths;
+    std::vector<int16_t> numRBs;
+    std::vector<int16_t> antElms;
+    std::vector<int16_t> bfwAntElms;
+    int numBeams;
+    std::string output;
+
+    /* expanded input, compressed data and expanded output/memcpy destination */
+    long bufBytes;
+    int16_t *bufExp = nullptr;
+    int8_t *bufComp = nullptr;
+    int16_t *bufCopy = nullptr;
+
+    /* TSC ticks per us, and cost of the timing code removed from cold measurements */
+    unsigned long ticksPerUs = 0;
+    double timerOverhead = 0.0;
+
+    std::vector<BenchPoint> results;
+
+    void SetUp() override {
+        init_test("compander_benchmark");
+        isas        = get_input_parameter<std::vector<std::string>>("isa");
+        caches      = get_input_parameter<std::vector<std::string>>("cache");
+        compMethods = get_input_parameter<std::vector<int16_t>>("compMethod");
+        iqWidths    = get_input_parameter<std::vector<int16_t>>("iqWidth");
+        numRBs      = get_input_parameter<std::vector<int16_t>>("nRBsize");
+        antElms     = get_input_parameter<std::vector<int16_t>>("AntElm");
+        bfwAntElms  = get_input_parameter<std::vector<int16_t>>("bfwAntElm");
+        numBeams    = get_input_parameter<int>("numBeams");
+        output      = get_input_parameter<std::string>("output");
+
+        /* largest point of the sweep, every antenna starts on a cache line */
+        const int maxRBs = *std::max_element(numRBs.begin(), numRBs.end());
+        const int maxAnt = *std::max_element(antElms.begin(), antElms.end());
+        const int maxBfwAnt = *std::max_element(bfwAntElms.begin(), bfwAntElms.end());
+        bufBytes = std::max((long)align_up(comp_bytes_per_ant(XRAN_COMPMETHOD_BLKFLOAT, 16, maxRBs)) * maxAnt,
+                            (long)align_up(3 + 4 * maxBfwAnt) * numBeams);
+
+        bufExp  = (int16_t *)_mm_malloc(bufBytes, k_cacheLine);
+        bufComp = (int8_t *)_mm_malloc(bufBytes, k_cacheLine);
+        bufCopy = (int16_t *)_mm_malloc(bufBytes, k_cacheLine);
+        ASSERT_TRUE(bufExp != nullptr && bufComp != nullptr && bufCopy != nullptr);
+
+        std::mt19937 gen(12345);
+        std::uniform_int_distribution<int16_t> randInt16(-32768, 32767);
+        std::uniform_int_distribution<int> randExpShift(0, 4);
+        const long numSamps = bufBytes / sizeof(int16_t);
+        for (long m = 0; m < numSamps; m += 24) {
+            const auto shiftVal = randExpShift(gen);
+            for (long n = m; n < std::min(numSamps, m + 24); ++n)
+                bufExp[n] = int16_t(randInt16(gen) >> shiftVal);
+        }
+        std::memset(bufComp, 0, bufBytes);
+        std::memset(bufCopy, 0, bufBytes);
+
+        ticksPerUs = tsc_recovery();
+        timerOverhead = measure(true, {}, [] {});
+    }
+
+    void TearDown() override {
+        _mm_free(bufExp);
+        _mm_free(bufComp);
+        _mm_free(bufCopy);
+    }
+
+    bool isa_available(const std::string &isa) const
+    {
+        if (isa == "SNC")
+            return _may_i_use_cpu_feature(_FEATURE_AVX512IFMA52) != 0;
+        return (isa == "C" || isa == "AVX512");
+    }
+
+    struct Range
+    {
+        const void *ptr;
+        long len;
+    };
+
+    static void flush(const std::vector<Range> &ranges)
+    {
+        for (const auto &r : ranges)
+            for (long off = 0; off < r.len; off += k_cacheLine)
+                _mm_clflush((const int8_t *)r.ptr + off);
+        _mm_mfence();
+    }
+
+    /*
+     * Mean TSC cycles per call of fn(). Hot: calls are timed back to back after
+     * a warm up call, as run_benchmark() does. Cold: the ranges are flushed
+     * before each call and every call is timed on its own.
+     */
+    template <typename F>
+    double measure(const bool cold, const std::vector<Range> &ranges, F fn)
+    {
+        const long numCalls = BenchmarkParameters::repetition * BenchmarkParameters::loop;
+        unsigned aux;
+        double total = 0;
+
+        if (!cold) {
+            fn();
+            for (long r = 0; r < BenchmarkParameters::repetition; ++r) {
+                const auto start_time = __rdtsc();
+                for (long l = 0; l < BenchmarkParameters::loop; ++l)
+                    fn();
+                total += __rdtsc() - start_time;
+            }
+            return total / numCalls;
+        }
+
+        for (long n = 0; n < numCalls; ++n) {
+            flush(ranges);
+            _mm_lfence();
+            const auto start_time = __rdtsc();
+            _mm_lfence();
+            fn();
+            const auto end_time = __rdtscp(&aux);
+            _mm_lfence();
+            total += end_time - start_time;
+        }
+        return std::max(0.0, total / numCalls - timerOverhead);
+    }
+
+    double to_gbps(const long bytes, const double cycles) const
+    {
+        return cycles > 0 ? (double)bytes * ticksPerUs / cycles / 1000.0 : 0.0;
+    }
+
+    void add_point(BenchPoint p, const long bytes, const double cycles, const double memcpyCycles, const int units)
+    {
+        p.cycles        = cycles;
+        p.cyclesPerUnit = cycles / units;
+        p.gbps          = to_gbps(bytes, cycles);
+        p.memcpyGbps    = to_gbps(bytes, memcpyCycles);
+        p.ratioToMemcpy = p.memcpyGbps > 0 ? p.gbps / p.memcpyGbps : 0.0;
+        results.push_back(p);
+
+        printf("%-3s %-7s %-6s %-5s %4d %4d %5d %4d %12.1f %10.2f %8.2f %8.2f %7.3f\n",
+               p.plane.c_str(), p.isa.c_str(), p.direction.c_str(), p.cache.c_str(),
+               p.compMethod, p.iqWidth, p.numRBs, p.antElm, p.cycles, p.cyclesPerUnit,
+               p.gbps, p.memcpyGbps, p.ratioToMemcpy);
+    }
+
+    /* BFP reference kernels are limited to k_maxNumBlocks per call */
+    static void bfp_compress_ref(int16_t *in, int8_t *out, const int iqWidth, const int nRBs)
+    {
+        BlockFloatCompander::ExpandedData expandedDataInput;
+        BlockFloatCompander::CompressedData compressedDataOut;
+        expandedDataInput.iqWidth = iqWidth;
+        expandedDataInput.numDataElements = 24;
+        compressedDataOut.iqWidth = iqWidth;
+        compressedDataOut.numDataElements = 24;
+        for (int rb = 0; rb < nRBs; rb += BlockFloatCompander::k_maxNumBlocks) {
+            expandedDataInput.numBlocks = std::min(nRBs - rb, BlockFloatCompander::k_maxNumBlocks);
+            expandedDataInput.dataExpanded = in + rb * 24;
+            compressedDataOut.dataCompressed = (uint8_t *)out + rb * ((3 * iqWidth) + 1);
+            BlockFloatCompander::BFPCompressRef(expandedDataInput, &compressedDataOut);
+        }
+    }
+
+    static void bfp_expand_ref(int8_t *in, int16_t *out, const int iqWidth, const int nRBs)
+    {
+        BlockFloatCompander::CompressedData compressedDataInput;
+        BlockFloatCompander::ExpandedData expandedDataOut;
+        compressedDataInput.iqWidth = iqWidth;
+        compressedDataInput.numDataElements = 24;
+        expandedDataOut.iqWidth = iqWidth;
+        expandedDataOut.numDataElements = 24;
+        for (int rb = 0; rb < nRBs; rb += BlockFloatCompander::k_maxNumBlocks) {
+            compressedDataInput.numBlocks = std::min(nRBs - rb, BlockFloatCompander::k_maxNumBlocks);
+            compressedDataInput.dataCompressed = (uint8_t *)in + rb * ((3 * iqWidth) + 1);
+            expandedDataOut.dataExpanded = out + rb * 24;
+            BlockFloatCompander::BFPExpandRef(compressedDataInput, &expandedDataOut);
+        }
+    }
+
+    /* compress or decompress one antenna worth of numRBs */
+    static void run_uplane(const std::string &isa, const bool comp, const int compMethod, const int iqWidth,
+                           const int nRBs, int16_t *exp, int8_t *cmp)
+    {
+        if (compMethod == XRAN_COMPMETHOD_MODULATION) {
+            const auto modulation = (enum xran_modulation_order)(iqWidth * 2);
+            if (comp) {
+                struct xranlib_5gnr_mod_compression_request req = {};
+                struct xranlib_5gnr_mod_compression_response rsp = {};
+                req.data_in = exp;
+                req.unit = mod_unit(modulation);
+                req.modulation = modulation;
+                req.num_symbols = nRBs * k_numRePerRb;
+                rsp.data_out = cmp;
+#ifdef C_Module_Used
+                if (isa == "C")
+                    xranlib_5gnr_mod_compression_c(&req, &rsp);
+                else
+#endif
+                if (isa == "SNC")
+                    xranlib_5gnr_mod_compression_snc(&req, &rsp);
+                else
+                    xranlib_5gnr_mod_compression_avx512(&req, &rsp);
+            } else {
+                struct xranlib_5gnr_mod_decompression_request req = {};
+                struct xranlib_5gnr_mod_decompression_response rsp = {};
+                req.data_in = cmp;
+                req.unit = mod_unit(modulation);
+                req.modulation = modulation;
+                req.num_symbols = nRBs * k_numRePerRb;
+                rsp.data_out = exp;
+                if (isa == "C")
+                    xranlib_5gnr_mod_decompression_c(&req, &rsp);
+                else
+                    xranlib_5gnr_mod_decompression_avx512(&req, &rsp);
+            }
+            return;
+        }
+
+        if (isa == "C") {
+            if (comp)
+                bfp_compress_ref(exp, cmp, iqWidth, nRBs);
+            else
+                bfp_expand_ref(cmp, exp, iqWidth, nRBs);
+            return;
+        }
+
+        if (comp) {
+            struct xranlib_compress_request req = {};
+            struct xranlib_compress_response rsp = {};
+            req.data_in = exp;
+            req.numRBs = nRBs;
+            req.numDataElements = 24;
+            req.len = nRBs * k_numRePerRb * k_bytesPerRe;
+            req.compMethod = XRAN_COMPMETHOD_BLKFLOAT;
+            req.iqWidth = iqWidth;
+            rsp.data_out = cmp;
+            if (isa == "SNC")
+                xranlib_compress_avxsnc(&req, &rsp);
+            else
+                xranlib_compress_avx512(&req, &rsp);
+        } else {
+            struct xranlib_decompress_request req = {};
+            struct xranlib_decompress_response rsp = {};
+            req.data_in = cmp;
+            req.numRBs = nRBs;
+            req.numDataElements = 24;
+            req.len = comp_bytes_per_ant(XRAN_COMPMETHOD_BLKFLOAT, iqWidth, nRBs);
+            req.compMethod = XRAN_COMPMETHOD_BLKFLOAT;
+            req.iqWidth = iqWidth;
+            rsp.data_out = exp;
+            if (isa == "SNC")
+                xranlib_decompress_avxsnc(&req, &rsp);
+            else
+                xranlib_decompress_avx512(&req, &rsp);
+        }
+    }
+
+    void sweep_uplane()
+    {
+        for (auto compMethod : compMethods) {
+            for (auto iqWidth : iqWidths) {
+                /* modulation compression carries 1..4 bits per I and Q (QPSK..256QAM) */
+                if (compMethod == XRAN_COMPMETHOD_MODULATION && (iqWidth < 1 || iqWidth > 4))
+                    continue;
+                if (compMethod != XRAN_COMPMETHOD_MODULATION && compMethod != XRAN_COMPMETHOD_BLKFLOAT)
+                    continue;
+
+                for (auto nRB : numRBs) {
+                    for (auto antElm : antElms) {
+                        const int expBytes = align_up(nRB * k_numRePerRb * k_bytesPerRe);
+                        const int cmpBytes = align_up(comp_bytes_per_ant(compMethod, iqWidth, nRB));
+                        const long uncompBytes = (long)nRB * k_numRePerRb * k_bytesPerRe * antElm;
+                        const std::vector<Range> expRange = { { bufExp, (long)expBytes * antElm } };
+                        const std::vector<Range> copyRange = { { bufCopy, (long)expBytes * antElm } };
+                        const std::vector<Range> cmpRange = { { bufComp, (long)cmpBytes * antElm } };
+
+                        /* valid compressed data for the decompression runs */
+                        for (int a = 0; a < antElm; ++a)
+                            run_uplane("AVX512", true, compMethod, iqWidth, nRB,
+                                       bufExp + a * expBytes / sizeof(int16_t), bufComp + a * cmpBytes);
+
+                        for (const auto &cache : caches) {
+                            const bool cold = (cache == "cold");
+                            const auto memcpyCycles = measure(cold, { expRange[0], copyRange[0] }, [&] {
+                                std::memcpy(bufCopy, bufExp, uncompBytes);
+                            });
+
+                            for (const auto &isa : isas) {
+                                if (!isa_available(isa))
+                                    continue;
+                                for (const bool comp : { true, false }) {
+                                    /* no SNC specific modulation decompression kernel, and the C
+                                       modulation compression is only built with C_Module_Used */
+                                    if (!comp && isa == "SNC" && compMethod == XRAN_COMPMETHOD_MODULATION)
+                                        continue;
+#ifndef C_Module_Used
+                                    if (comp && isa == "C" && compMethod == XRAN_COMPMETHOD_MODULATION)
+                                        continue;
+#endif
+                                    const auto cycles = measure(cold, { (comp ? expRange : copyRange)[0], cmpRange[0] }, [&] {
+                                        for (int a = 0; a < antElm; ++a)
+                                            run_uplane(isa, comp, compMethod, iqWidth, nRB,
+                                                       (comp ? bufExp : bufCopy) + a * expBytes / sizeof(int16_t),
+                                                       bufComp + a * cmpBytes);
+                                    });
+                                    BenchPoint p = { "UP", isa, comp ? "comp" : "decomp", cache,
+                                                     compMethod, iqWidth, nRB, antElm, 0, 0, 0, 0, 0 };
+                                    add_point(p, uncompBytes, cycles, memcpyCycles, nRB * antElm);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* compression of numBeams sets of BFWs of antElm antennas each */
+    void sweep_cplane()
+    {
+        if (std::find(compMethods.begin(), compMethods.end(), XRAN_COMPMETHOD_BLKFLOAT) == compMethods.end())
+            return;
+
+        for (auto iqWidth : iqWidths) {
+            for (auto antElm : bfwAntElms) {
+                const int numDataElements = 2 * antElm;
+                if (numDataElements > BlockFloatCompander::k_maxNumElements)
+                    continue;
+                const int setBytes = numDataElements * sizeof(int16_t);
+                /* each set starts on a cache line, as the fixed antenna count kernels expect */
+                const int setStride = align_up(setBytes) / sizeof(int16_t);
+                const long uncompBytes = (long)setBytes * numBeams;
+                const std::vector<Range> ranges = { { bufExp, (long)setStride * sizeof(int16_t) * numBeams },
+                                                    { bufComp, (3 + ((numDataElements * iqWidth + 7) >> 3)) * numBeams } };
+                const bool fixedKernel = (iqWidth == 8 || iqWidth == 9 || iqWidth == 10 || iqWidth == 12)
+                                      && (antElm == 8 || antElm == 16 || antElm == 32 || antElm == 64);
+                std::vector<int16_t *> pBfw(numBeams);
+                std::vector<uint16_t> beamId(numBeams);
+                for (int b = 0; b < numBeams; ++b)
+                    beamId[b] = (uint16_t)(b + 1);
+
+                for (const auto &cache : caches) {
+                    const bool cold = (cache == "cold");
+                    const auto memcpyCycles = measure(cold, { ranges[0], { bufCopy, uncompBytes } }, [&] {
+                        std::memcpy(bufCopy, bufExp, uncompBytes);
+                    });
+
+                    for (const auto &isa : isas) {
+                        if (!isa_available(isa))
+                            continue;
+
+                        /* per beam kernels: reference, and the fixed antenna count AVX512/SNC kernels */
+                        if (isa == "C" || fixedKernel) {
+                            const auto cycles = measure(cold, ranges, [&] {
+                                int16_t *in = bufExp;
+                                int8_t *out = bufComp;
+                                for (int b = 0; b < numBeams; ++b) {
+                                    if (isa == "C") {
+                                        BlockFloatCompander::ExpandedData expandedDataInput;
+                                        BlockFloatCompander::CompressedData compressedDataOut;
+                                        expandedDataInput.iqWidth = iqWidth;
+                                        expandedDataInput.numBlocks = 1;
+                                        expandedDataInput.numDataElements = numDataElements;
+                                        expandedDataInput.dataExpanded = in + b * setStride;
+                                        compressedDataOut.dataCompressed = (uint8_t *)out;
+                                        BlockFloatCompander::BFPCompressRef(expandedDataInput, &compressedDataOut);
+                                    } else {
+                                        struct xranlib_compress_request req = {};
+                                        struct xranlib_compress_response rsp = {};
+                                        req.data_in = in + b * setStride;
+                                        req.numRBs = 1;
+                                        req.numDataElements = numDataElements;
+                                        req.len = setBytes;
+                                        req.compMethod = XRAN_COMPMETHOD_BLKFLOAT;
+                                        req.iqWidth = iqWidth;
+                                        rsp.data_out = out;
+                                        if (isa == "SNC")
+                                            xranlib_compress_avxsnc_bfw(&req, &rsp);
+                                        else
+                                            xranlib_compress_avx512_bfw(&req, &rsp);
+                                    }
+                                    out += 3 + ((numDataElements * iqWidth + 7) >> 3);
+                                }
+                            });
+                            BenchPoint p = { "CP", isa, "comp", cache, XRAN_COMPMETHOD_BLKFLOAT, iqWidth, numBeams, antElm, 0, 0, 0, 0, 0 };
+                            add_point(p, uncompBytes, cycles, memcpyCycles, numBeams);
+                        }
+
+                        /* batch kernel, any antenna count and iqWidth */
+                        if (isa == "AVX512") {
+                            const auto cycles = measure(cold, ranges, [&] {
+                                struct xranlib_compress_bfw_batch_request req = {};
+                                struct xranlib_compress_response rsp = {};
+                                for (int b = 0; b < numBeams; ++b)
+                                    pBfw[b] = bufExp + b * setStride;
+                                req.data_in = pBfw.data();
+                                req.beamId = beamId.data();
+                                req.numBeams = numBeams;
+                                req.numDataElements = numDataElements;
+                                req.compMethod = XRAN_COMPMETHOD_BLKFLOAT;
+                                req.iqWidth = iqWidth;
+                                rsp.data_out = bufComp;
+                                xranlib_compress_bfw_batch(&req, &rsp);
+                            });
+                            BenchPoint p = { "CP", "AVX512B", "comp", cache, XRAN_COMPMETHOD_BLKFLOAT, iqWidth, numBeams, antElm, 0, 0, 0, 0, 0 };
+                            add_point(p, uncompBytes, cycles, memcpyCycles, numBeams);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void write_reports() const
+    {
+        json j = json::array();
+        for (const auto &p : results) {
+            j.push_back({ { "plane", p.plane }, { "isa", p.isa }, { "direction", p.direction },
+                          { "cache", p.cache }, { "compMethod", p.compMethod }, { "iqWidth", p.iqWidth },
+                          { "numRBs", p.numRBs }, { "AntElm", p.antElm }, { "cycles", p.cycles },
+                          { "cycles_per_unit", p.cyclesPerUnit }, { "unit", p.plane == "CP" ? "beam" : "PRB" },
+                          { "GBps", p.gbps }, { "memcpy_GBps", p.memcpyGbps },
+                          { "ratio_to_memcpy", p.ratioToMemcpy } });
+        }
+        json doc = { { "tsc_ticks_per_us", ticksPerUs },
+                     { "repetition", BenchmarkParameters::repetition },
+                     { "loop", BenchmarkParameters::loop },
+                     { "results", j } };
+
+        std::ofstream jsonFile(output + ".json");
+        jsonFile << doc.dump(2) << std::endl;
+
+        std::ofstream csvFile(output + ".csv");
+        csvFile << "plane,isa,direction,cache,compMethod,iqWidth,numRBs,AntElm,cycles,cycles_per_unit,unit,GBps,memcpy_GBps,ratio_to_memcpy\n";
+        for (const auto &p : results) {
+            csvFile << p.plane << ',' << p.isa << ',' << p.direction << ',' << p.cache << ','
+                    << p.compMethod << ',' << p.iqWidth << ',' << p.numRBs << ',' << p.antElm << ','
+                    << p.cycles << ',' << p.cyclesPerUnit << ',' << (p.plane == "CP" ? "beam" : "PRB") << ','
+                    << p.gbps << ',' << p.memcpyGbps << ',' << p.ratioToMemcpy << '\n';
+        }
+        std::cout << "[----------] " << results.size() << " results written to "
+                  << output << ".json and " << output << ".csv" << std::endl;
+    }
+};
+
+TEST_P(CompanderBenchmark, Sweep)
+{
+    ASSERT_EQ(0, bind_to_cpu(BenchmarkParameters::cpu_id)) << "Failed to bind to cpu!";
+
+    printf("%-3s %-7s %-6s %-5s %4s %4s %5s %4s %12s %10s %8s %8s %7s\n",
+           "pl", "isa", "dir", "cache", "meth", "iqW", "nRB", "ant", "cyc/call", "cyc/unit",
+           "GB/s", "cpyGB/s", "ratio");
+
+    sweep_uplane();
+    sweep_cplane();
+
+    ASSERT_FALSE(results.empty());
+    write_reports();
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, CompanderBenchmark,
+                        testing::ValuesIn(get_sequence(CompanderBenchmark::get_number_of_cases("compander_benchmark"))));
@@ -244,6 +244,37 @@ protected:
     }
 };
 
+class BfpPerfSweep : public KernelTests
+{
+protected:
+    std::vector<int16_t> iqWidths;
+    std::vector<int16_t> numRBs;
+
+    void SetUp() override {
+        init_test("bfp_performace_sweep");
+        iqWidths = get_input_parameter<std::vector<int16_t>>("iqWidth");
+        numRBs   = get_input_parameter<std::vector<int16_t>>("nRBsize");
+
+        // Create random number generator
+        std::random_device rd;
+        std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
+        std::uniform_int_distribution<int16_t> randInt16(-32768, 32767);
+        std::uniform_int_distribution<int> randExpShift(0, 4);
+
+        for (int m = 0; m < 18*BlockFloatCompander::k_maxNumBlocks; ++m) {
+            auto shiftVal = randExpShift(gen);
+            for (int n = 0; n < 24; ++n) {
+                loc_dataExpandedIn[m*24+n] = int16_t(randInt16(gen) >> shiftVal);
+            }
+        }
+    }
+
+    /* It's called after an execution of the each test case.*/
+    void TearDown() override {
+
+    }
+};
+
 struct ErrorData
 {
   int checkSum;
@@ -591,6 +622,87 @@ int runTest(const int runMode, const int iqWidth, const int numRB, const int num
   return resSum;
 }
 
+class BfpPerfBfwBatch : public KernelTests
+{
+protected:
+    struct xranlib_compress_bfw_batch_request bfw_com_req;
+    struct xranlib_compress_response bfw_com_rsp;
+    int16_t *bfw_ptrs[XRAN_MAX_SET_BFWS];
+    uint16_t bfw_beamIds[XRAN_MAX_SET_BFWS];
+
+    void SetUp() override {
+        init_test("bfp_performace_bfw_batch");
+        int16_t iqWidth  = get_input_parameter<int16_t>("iqWidth");
+        int16_t AntElm   = get_input_parameter<int16_t>("AntElm");
+        int16_t numBeams = get_input_parameter<int16_t>("numBeams");
+        int16_t numDataElements = 2*AntElm;
+        // Create random number generator
+        std::random_device rd;
+        std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
+        std::uniform_int_distribution<int16_t> randInt16(-32768, 32767);
+        std::uniform_int_distribution<int> randExpShift(0, 4);
+
+        for (int b = 0; b < numBeams; ++b)
+        {
+          auto shiftVal = randExpShift(gen);
+          for (int n = 0; n < numDataElements; ++n)
+            loc_dataExpandedIn[b * numDataElements + n] = int16_t(randInt16(gen) >> shiftVal);
+          bfw_ptrs[b]    = &loc_dataExpandedIn[b * numDataElements];
+          bfw_beamIds[b] = (uint16_t)(b + 1);
+        }
+
+        std::memset(&bfw_com_req, 0, sizeof(struct xranlib_compress_bfw_batch_request));
+        std::memset(&bfw_com_rsp, 0, sizeof(struct xranlib_compress_response));
+
+        bfw_com_req.data_in         = bfw_ptrs;
+        bfw_com_req.beamId          = bfw_beamIds;
+        bfw_com_req.numBeams        = numBeams;
+        bfw_com_req.numDataElements = numDataElements;
+        bfw_com_req.compMethod      = XRAN_COMPMETHOD_BLKFLOAT;
+        bfw_com_req.iqWidth         = iqWidth;
+
+        bfw_com_rsp.data_out        = (int8_t *)&loc_dataCompressedDataOut[0];
+        bfw_com_rsp.len             = 0;
+    }
+
+    /* It's called after an execution of the each test case.*/
+    void TearDown() override {
+
+    }
+};
+
+/* One xranlib_compress_avx512_bfw() call per beam, as xran_cp_prepare_ext11_bfws() used to do */
+static int32_t
+compress_bfw_per_beam(const struct xranlib_compress_bfw_batch_request *request,
+                      struct xranlib_compress_response *response)
+{
+    struct xranlib_compress_request  bfp_com_req;
+    struct xranlib_compress_response bfp_com_rsp;
+    int32_t iq_size = (request->numDataElements * request->iqWidth + 7) >> 3;
+    uint8_t *ptr = (uint8_t *)response->data_out;
+
+    std::memset(&bfp_com_req, 0, sizeof(struct xranlib_compress_request));
+    std::memset(&bfp_com_rsp, 0, sizeof(struct xranlib_compress_response));
+    for (int b = 0; b < request->numBeams; ++b)
+    {
+        bfp_com_req.numRBs          = 1;
+        bfp_com_req.numDataElements = request->numDataElements;
+        bfp_com_req.len             = request->numDataElements*2;
+        bfp_com_req.compMethod      = request->compMethod;
+        bfp_com_req.iqWidth         = request->iqWidth;
+        bfp_com_req.data_in         = request->data_in[b];
+        bfp_com_rsp.data_out        = (int8_t *)(ptr + 2);
+        if (xranlib_compress_avx512_bfw(&bfp_com_req, &bfp_com_rsp) != 0)
+            return -1;
+        *ptr = *(ptr + 2);
+        ptr[1] = (uint8_t)((request->beamId[b] >> 8) & 0x7f);
+        ptr[2] = (uint8_t)(request->beamId[b] & 0xff);
+        ptr += iq_size + 3;
+    }
+    response->len = ptr - (uint8_t *)response->data_out;
+    return 0;
+}
+
 TEST_P(BfpCheck, AVX512_bfp_main)
 {
   int resSum = 0;
@@ -767,6 +879,102 @@ TEST_P(BfpCheck, AVX512_sweep_xranlib)
     }
 }
 
+TEST_P(BfpCheck, AVX512_wide_sweep_xranlib)
+{
+    int32_t resSum  = 0;
+    int16_t compMethod = XRAN_COMPMETHOD_BLKFLOAT;
+    int16_t maxNumRBs  = 273;
+    int numDataElements = 24;
+
+    struct xranlib_decompress_request  bfp_decom_req;
+    struct xranlib_decompress_response bfp_decom_rsp;
+
+    struct xranlib_compress_request  bfp_com_req;
+    struct xranlib_compress_response bfp_com_rsp;
+
+    // Create random number generator
+    std::random_device rd;
+    std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
+    std::uniform_int_distribution<int16_t> randInt16(-32767, 32767);
+    std::uniform_int_distribution<int> randExpShift(0, 4);
+
+    BlockFloatCompander::ExpandedData expandedData;
+    expandedData.dataExpanded = &loc_dataExpandedIn[0];
+    BlockFloatCompander::ExpandedData expandedDataRes;
+    expandedDataRes.dataExpanded = &loc_dataExpandedRes[0];
+    BlockFloatCompander::CompressedData compressedData;
+    compressedData.dataCompressed = &loc_dataCompressedDataOut[0];
+
+    /* reference output buffers */
+    std::vector<uint8_t> compressedRef(2*288*numDataElements);
+    std::vector<int16_t> expandedRef(288*numDataElements);
+
+    for (int16_t iqWidth = 1; iqWidth <= 16; iqWidth++) {
+        for (int16_t numRBs = 1; numRBs <= maxNumRBs; numRBs++) {
+
+            for (int m = 0; m < numRBs; ++m) {
+                auto shiftVal = randExpShift(gen);
+                for (int n = 0; n < numDataElements; ++n) {
+                    expandedData.dataExpanded[m*numDataElements+n] = int16_t(randInt16(gen) >> shiftVal);
+                }
+            }
+
+            std::memset(&loc_dataCompressedDataOut[0], 0, 2*288*numDataElements);
+            std::memset(&loc_dataExpandedRes[0], 0, 288*numDataElements*sizeof(int16_t));
+            std::fill(compressedRef.begin(), compressedRef.end(), 0);
+            std::fill(expandedRef.begin(), expandedRef.end(), 0);
+
+            // Generate reference
+            expandedData.iqWidth         = iqWidth;
+            expandedData.numBlocks       = numRBs;
+            expandedData.numDataElements = numDataElements;
+            BlockFloatCompander::CompressedData compressedDataRef;
+            compressedDataRef.dataCompressed = compressedRef.data();
+            BlockFloatCompander::BFPCompressRef(expandedData, &compressedDataRef);
+            BlockFloatCompander::ExpandedData expandedDataRef;
+            expandedDataRef.dataExpanded = expandedRef.data();
+            BlockFloatCompander::BFPExpandRef(compressedDataRef, &expandedDataRef);
+
+            std::memset(&bfp_com_req, 0, sizeof(struct xranlib_compress_request));
+            std::memset(&bfp_com_rsp, 0, sizeof(struct xranlib_compress_response));
+            std::memset(&bfp_decom_req, 0, sizeof(struct xranlib_decompress_request));
+            std::memset(&bfp_decom_rsp, 0, sizeof(struct xranlib_decompress_response));
+
+            bfp_com_req.data_in    = (int16_t *)expandedData.dataExpanded;
+            bfp_com_req.numRBs     = numRBs;
+            bfp_com_req.numDataElements = numDataElements;
+            bfp_com_req.len        = numRBs*12*2*2;
+            bfp_com_req.compMethod = compMethod;
+            bfp_com_req.iqWidth    = iqWidth;
+
+            bfp_com_rsp.data_out   = (int8_t *)(compressedData.dataCompressed);
+            bfp_com_rsp.len        = 0;
+
+            xranlib_compress_avx512(&bfp_com_req, &bfp_com_rsp);
+
+            bfp_decom_req.data_in    = (int8_t *)(compressedData.dataCompressed);
+            bfp_decom_req.numRBs     = numRBs;
+            bfp_decom_req.len        = bfp_com_rsp.len;
+            bfp_decom_req.numDataElements = numDataElements;
+            bfp_decom_req.compMethod = compMethod;
+            bfp_decom_req.iqWidth    = iqWidth;
+
+            bfp_decom_rsp.data_out   = (int16_t *)expandedDataRes.dataExpanded;
+            bfp_decom_rsp.len        = 0;
+
+            xranlib_decompress_avx512(&bfp_decom_req, &bfp_decom_rsp);
+
+            /* bit exact against reference, including bytes past the end of the output */
+            resSum += checkData((int8_t *)compressedRef.data(), (int8_t *)compressedData.dataCompressed, 2*288*numDataElements);
+            resSum += checkData(expandedRef.data(), expandedDataRes.dataExpanded, 288*numDataElements);
+
+            ASSERT_EQ(((3 * iqWidth) + 1) * numRBs, bfp_com_rsp.len);
+            ASSERT_EQ(numRBs*12*2*2, bfp_decom_rsp.len);
+            ASSERT_EQ(0, resSum) << "iqWidth " << iqWidth << " numRBs " << numRBs;
+         }
+    }
+}
+
 TEST_P(BfpCheck, AVXSNC_sweep_xranlib)
 {
     int32_t resSum  = 0;
@@ -940,6 +1148,80 @@ TEST_P(BfpCheck, AVX512_cp_sweep_xranlib)
     }
 }
 
+TEST_P(BfpCheck, AVX512_bfw_batch_xranlib)
+{
+    int16_t antElm[] = {1, 4, 8, 12, 16, 32, 64, 128};
+    const int16_t numBeams = 7;
+
+    struct xranlib_compress_bfw_batch_request bfw_com_req;
+    struct xranlib_compress_response bfw_com_rsp;
+    int16_t *bfw_ptrs[numBeams];
+    uint16_t bfw_beamIds[numBeams];
+
+    // Create random number generator
+    std::random_device rd;
+    std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
+    std::uniform_int_distribution<int16_t> randInt16(-32768, 32767);
+    std::uniform_int_distribution<int> randExpShift(0, 15);
+    std::uniform_int_distribution<int> randBeamId(0, 0xffff);
+
+    BlockFloatCompander::ExpandedData expandedData;
+    BlockFloatCompander::CompressedData compressedRef;
+    std::vector<uint8_t> refOut(2*288*128);
+
+    for (int16_t iqWidth = 1; iqWidth <= 16; iqWidth++) {
+        for (unsigned int tc = 0; tc < sizeof(antElm)/sizeof(antElm[0]); tc ++) {
+            int32_t numDataElements = 2*antElm[tc];
+            int32_t iq_size = (numDataElements * iqWidth + 7) >> 3;
+            int32_t setSize = iq_size + 3;
+
+            // Beams are not contiguous, leave a gap between them
+            for (int b = 0; b < numBeams; ++b) {
+                auto shiftVal = randExpShift(gen);
+                bfw_ptrs[b] = &loc_dataExpandedIn[b * (numDataElements + 32)];
+                bfw_beamIds[b] = (uint16_t)randBeamId(gen);
+                for (int n = 0; n < numDataElements; ++n)
+                    bfw_ptrs[b][n] = int16_t(randInt16(gen) >> shiftVal);
+            }
+
+            std::memset(&loc_dataCompressedDataOut[0], 0xA5, numBeams * setSize + 64);
+            std::memset(&bfw_com_req, 0, sizeof(struct xranlib_compress_bfw_batch_request));
+            std::memset(&bfw_com_rsp, 0, sizeof(struct xranlib_compress_response));
+
+            bfw_com_req.data_in         = bfw_ptrs;
+            bfw_com_req.beamId          = bfw_beamIds;
+            bfw_com_req.numBeams        = numBeams;
+            bfw_com_req.numDataElements = numDataElements;
+            bfw_com_req.compMethod      = XRAN_COMPMETHOD_BLKFLOAT;
+            bfw_com_req.iqWidth         = iqWidth;
+            bfw_com_rsp.data_out        = (int8_t *)&loc_dataCompressedDataOut[0];
+
+            ASSERT_EQ(0, xranlib_compress_bfw_batch(&bfw_com_req, &bfw_com_rsp));
+            ASSERT_EQ(numBeams * setSize, bfw_com_rsp.len);
+
+            for (int b = 0; b < numBeams; ++b) {
+                uint8_t *set = &loc_dataCompressedDataOut[b * setSize];
+
+                expandedData.dataExpanded     = bfw_ptrs[b];
+                expandedData.iqWidth          = iqWidth;
+                expandedData.numBlocks        = 1;
+                expandedData.numDataElements  = numDataElements;
+                compressedRef.dataCompressed  = refOut.data();
+                BlockFloatCompander::BFPCompressRef(expandedData, &compressedRef);
+
+                ASSERT_EQ(refOut[0], set[0]) << "exponent, iqWidth " << iqWidth << " AntElm " << antElm[tc] << " beam " << b;
+                ASSERT_EQ((bfw_beamIds[b] >> 8) & 0x7f, set[1]);
+                ASSERT_EQ(bfw_beamIds[b] & 0xff, set[2]);
+                /* the reference drops the bits of an incomplete last byte */
+                ASSERT_EQ(0, checkData((int8_t *)&refOut[1], (int8_t *)&set[3], (numDataElements * iqWidth) >> 3))
+                    << "iqWidth " << iqWidth << " AntElm " << antElm[tc] << " beam " << b;
+            }
+            for (int n = numBeams * setSize; n < numBeams * setSize + 64; ++n)
+                ASSERT_EQ(0xA5, loc_dataCompressedDataOut[n]) << "write beyond the last set";
+        }
+    }
+}
+
 TEST_P(BfpCheck, AVXSNC_cp_sweep_xranlib)
 {
     int32_t resSum  = 0;
@@ -1053,6 +1335,68 @@ TEST_P(BfpPerfCp, AVX512_CpDeComp)
      performance("AVX512", module_name, xranlib_decompress_avx512_bfw, &bfp_decom_req, &bfp_decom_rsp);
 }
 
+TEST_P(BfpPerfSweep, AVX512_WideSweep)
+{
+    struct xranlib_decompress_request  bfp_decom_req;
+    struct xranlib_decompress_response bfp_decom_rsp;
+    struct xranlib_compress_request  bfp_com_req;
+    struct xranlib_compress_response bfp_com_rsp;
+
+    ASSERT_EQ(0, bind_to_cpu(BenchmarkParameters::cpu_id)) << "Failed to bind to cpu!";
+
+    printf("%-8s %-7s %12s %12s %14s %14s\n", "iqWidth", "numRBs", "comp[cyc]", "decomp[cyc]",
+           "comp[cyc/PRB]", "decomp[cyc/PRB]");
+
+    for (auto iqWidth : iqWidths) {
+        for (auto numRB : numRBs) {
+            std::memset(&bfp_com_req, 0, sizeof(struct xranlib_compress_request));
+            std::memset(&bfp_com_rsp, 0, sizeof(struct xranlib_compress_response));
+            std::memset(&bfp_decom_req, 0, sizeof(struct xranlib_decompress_request));
+            std::memset(&bfp_decom_rsp, 0, sizeof(struct xranlib_decompress_response));
+
+            bfp_com_req.data_in    = (int16_t *)&loc_dataExpandedIn[0];
+            bfp_com_req.numRBs     = numRB;
+            bfp_com_req.numDataElements = 24;
+            bfp_com_req.len        = numRB*12*2*2;
+            bfp_com_req.compMethod = XRAN_COMPMETHOD_BLKFLOAT;
+            bfp_com_req.iqWidth    = iqWidth;
+            bfp_com_rsp.data_out   = (int8_t *)&loc_dataCompressedDataOut[0];
+
+            bfp_decom_req.data_in    = (int8_t *)&loc_dataCompressedDataOut[0];
+            bfp_decom_req.numRBs     = numRB;
+            bfp_decom_req.numDataElements = 24;
+            bfp_decom_req.len        = ((3 * iqWidth) + 1) * numRB;
+            bfp_decom_req.compMethod = XRAN_COMPMETHOD_BLKFLOAT;
+            bfp_decom_req.iqWidth    = iqWidth;
+            bfp_decom_rsp.data_out   = (int16_t *)&loc_dataExpandedRes[0];
+
+            const auto comp   = run_benchmark(xranlib_compress_avx512, &bfp_com_req, &bfp_com_rsp);
+            const auto decomp = run_benchmark(xranlib_decompress_avx512, &bfp_decom_req, &bfp_decom_rsp);
+
+            printf("%-8d %-7d %12.1f %12.1f %14.2f %14.2f\n", iqWidth, numRB, comp.first, decomp.first,
+                   comp.first / numRB, decomp.first / numRB);
+        }
+    }
+}
+
+TEST_P(BfpPerfBfwBatch, AVX512_BfwBatch)
+{
+     performance("AVX512", module_name, xranlib_compress_bfw_batch, &bfw_com_req, &bfw_com_rsp);
+}
+
+TEST_P(BfpPerfBfwBatch, AVX512_BfwPerBeam)
+{
+    switch (bfw_com_req.numDataElements) {
+        case 16: case 32: case 64: case 128:
+            if (bfw_com_req.iqWidth == 8 || bfw_com_req.iqWidth == 9 || bfw_com_req.iqWidth == 10 || bfw_com_req.iqWidth == 12)
+                performance("AVX512", module_name, compress_bfw_per_beam, &bfw_com_req, &bfw_com_rsp);
+            break;
+        default:
+            /* no fixed kernel for this antenna count */
+            break;
+    }
+}
+
 TEST_P(BfpPerfEx,  AVXSNC_Comp)
 {
     if(_may_i_use_cpu_feature(_FEATURE_AVX512IFMA52))
@@ -1086,3 +1430,8 @@ INSTANTIATE_TEST_CASE_P(UnitTest, BfpPerfEx,
 INSTANTIATE_TEST_CASE_P(UnitTest, BfpPerfCp,
                         testing::ValuesIn(get_sequence(BfpPerfCp::get_number_of_cases("bfp_performace_cp"))));
 
+INSTANTIATE_TEST_CASE_P(UnitTest, BfpPerfSweep,
+                        testing::ValuesIn(get_sequence(BfpPerfSweep::get_number_of_cases("bfp_performace_sweep"))));
+
+INSTANTIATE_TEST_CASE_P(UnitTest, BfpPerfBfwBatch,
+                        testing::ValuesIn(get_sequence(BfpPerfBfwBatch::get_number_of_cases("bfp_performace_bfw_batch"))));
@@ -0,0 +1,151 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/*
+ * Fronthaul counter micro-benchmark.
+ *
+ * Every worker runs the counter updates done by the RX path for each U-plane
+ * packet (bytes, packets, messages, on time and per antenna PUSCH count) with
+ * 1 to N workers on separate cores. The "shared" mode updates a single
+ * xran_common_counters as all workers did before the counters were sharded,
+ * the "sharded" mode updates the calling thread's block of a device context
+ * through xran_fh_counters(). Aggregate throughput is reported in Mpkt/s
+ * together with the updates lost by the shared struct; the sharded totals
+ * must be exact.
+ */
+
+#include "common.hpp"
+#include "xran_fh_o_du.h"
+#include "xran_dev.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const std::string module_name = "fh_counters_benchmark";
+
+namespace
+{
+    constexpr uint32_t k_pktLen = 1500;
+
+    inline void rx_count(struct xran_common_counters *pCnt, const uint64_t pkt)
+    {
+        pCnt->rx_bytes_counter += k_pktLen;
+        ++pCnt->rx_counter;
+        ++pCnt->Total_msgs_rcvd;
+        ++pCnt->Rx_on_time;
+        ++pCnt->rx_pusch_packets[pkt % XRAN_MAX_ANTENNA_NR];
+        /* keep every update in memory, as the RX path does between packets */
+        __asm__ volatile ("" : : : "memory");
+    }
+}
+
+class FhCountersBenchmark : public KernelTests
+{
+protected:
+    std::vector<int> workers;
+    uint64_t numPkts;
+
+    struct xran_device_ctx *pDev = nullptr;
+    struct xran_common_counters *pShared = nullptr;
+
+    void SetUp() override {
+        init_test("fh_counters_benchmark");
+        workers = get_input_parameter<std::vector<int>>("workers");
+        numPkts = get_input_parameter<uint64_t>("packets");
+
+        pDev = (struct xran_device_ctx *)_mm_malloc(sizeof(struct xran_device_ctx), 64);
+        pShared = (struct xran_common_counters *)_mm_malloc(sizeof(struct xran_common_counters), 64);
+        ASSERT_TRUE(pDev != nullptr && pShared != nullptr);
+    }
+
+    void TearDown() override {
+        _mm_free(pDev);
+        _mm_free(pShared);
+    }
+
+    /* returns the aggregate throughput in Mpkt/s */
+    double run(const int numWorkers, const bool sharded)
+    {
+        std::atomic<int> ready(0);
+        std::atomic<bool> go(false);
+        std::vector<std::thread> threads;
+
+        xran_fh_counters_reset(pDev);
+        std::memset(pShared, 0, sizeof(struct xran_common_counters));
+
+        for (int w = 0; w < numWorkers; w++) {
+            threads.emplace_back([&, w]() {
+                bind_to_cpu(BenchmarkParameters::cpu_id + w);
+                xran_fh_counters_shard_id = w;
+                ready++;
+                while (!go.load(std::memory_order_acquire))
+                    ;
+                for (uint64_t pkt = 0; pkt < numPkts; pkt++)
+                    rx_count(sharded ? xran_fh_counters(pDev) : pShared, pkt);
+            });
+        }
+
+        while (ready.load() != numWorkers)
+            ;
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto &t : threads)
+            t.join();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        return (double)numPkts * numWorkers / elapsed.count() / 1e6;
+    }
+};
+
+TEST_P(FhCountersBenchmark, Workers)
+{
+    const int numCores = (int)std::thread::hardware_concurrency() - (int)BenchmarkParameters::cpu_id;
+    struct xran_common_counters sum;
+
+    printf("%-8s %14s %14s %16s\n", "workers", "shared Mpkt/s", "sharded Mpkt/s", "shared lost pkts");
+
+    for (const int numWorkers : workers) {
+        ASSERT_TRUE(numWorkers > 0 && numWorkers <= XRAN_FH_COUNTERS_SHARDS);
+        if (numWorkers > numCores) {
+            std::cout << "[----------] " << numWorkers << " workers skipped, only "
+                      << numCores << " cores available" << std::endl;
+            continue;
+        }
+
+        const double shared = run(numWorkers, false);
+        const uint64_t lost = numPkts * numWorkers - pShared->rx_counter;
+
+        const double sharded = run(numWorkers, true);
+        xran_fh_counters_sum(pDev, &sum);
+        ASSERT_EQ(sum.rx_counter, numPkts * numWorkers);
+        ASSERT_EQ(sum.Total_msgs_rcvd, numPkts * numWorkers);
+        ASSERT_EQ(sum.Rx_on_time, numPkts * numWorkers);
+        ASSERT_EQ(sum.rx_bytes_counter, numPkts * numWorkers * k_pktLen);
+
+        printf("%-8d %14.1f %14.1f %16lu\n", numWorkers, shared, sharded, lost);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, FhCountersBenchmark,
+                        testing::ValuesIn(get_sequence(FhCountersBenchmark::get_number_of_cases("fh_counters_benchmark"))));
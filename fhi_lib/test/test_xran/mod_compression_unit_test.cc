@@ -26,6 +26,7 @@
 #include <iterator>
 #include <iostream>
 #include <cstring>
+#include <vector>
 
 const std::string module_name = "mod_compression";
 
@@ -69,6 +70,163 @@ protected:
     }
 };
 
+class Mod_DecompressionPerf : public KernelTests
+{
+protected:
+    struct xranlib_5gnr_mod_decompression_request  mod_decom_req;
+    struct xranlib_5gnr_mod_decompression_response mod_decom_rsp;
+
+    void SetUp() override {
+        init_test("mod_compression_performace");
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<int> randInt8(-128, 127);
+
+        std::memset(&mod_decom_req, 0, sizeof(struct xranlib_5gnr_mod_decompression_request));
+        std::memset(&mod_decom_rsp, 0, sizeof(struct xranlib_5gnr_mod_decompression_response));
+        mod_decom_req.unit = get_input_parameter<int16_t>("unit");
+        mod_decom_req.modulation = get_input_parameter<xran_modulation_order>("modulation");
+        mod_decom_req.num_symbols = get_input_parameter<int32_t>("num_symbols");
+        mod_decom_req.re_mask = 0xfff;
+
+        for (int m = 0; m < (mod_decom_req.num_symbols * mod_decom_req.modulation + 7) / 8; ++m) {
+            loc_ModCompOut[m] = int8_t(randInt8(gen));
+        }
+
+        mod_decom_req.data_in  = (int8_t *)loc_ModCompOut;
+        mod_decom_rsp.data_out = (int16_t *)loc_ModCompIn;
+    }
+
+    void TearDown() override {
+
+    }
+};
+
+class Mod_CompressionCheck : public KernelTests
+{
+protected:
+    int16_t unit;
+    enum xran_modulation_order modulation;
+    int32_t num_symbols;
+    int16_t re_mask;
+
+    std::vector<int16_t> iq_in;
+
+    void SetUp() override {
+        init_test("mod_compression_functional");
+        unit = get_input_parameter<int16_t>("unit");
+        modulation = get_input_parameter<xran_modulation_order>("modulation");
+        num_symbols = get_input_parameter<int32_t>("num_symbols");
+        re_mask = get_input_parameter<int16_t>("re_mask");
+
+        /* Random constellation points: (2c+1)*unit/2^(modulation/2) */
+        const int bits = modulation / 2;
+        const int16_t step = unit >> bits;
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<int> randIdx(-(1 << (bits - 1)), (1 << (bits - 1)) - 1);
+
+        iq_in.resize(2 * num_symbols);
+        for (auto &v : iq_in)
+            v = int16_t((2 * randIdx(gen) + 1) * step);
+    }
+
+    void TearDown() override {
+
+    }
+
+    int32_t comp_bytes() const { return (num_symbols * modulation + 7) / 8; }
+
+    bool re_enabled(int32_t iSc) const {
+        int16_t m = re_mask & 0xfff;
+        return (m == 0 || m == 0xfff) || ((m >> (iSc % 12)) & 0x1);
+    }
+
+    void compress(int16_t mask, std::vector<int8_t> &out) {
+        struct xranlib_5gnr_mod_compression_request  req;
+        struct xranlib_5gnr_mod_compression_response rsp;
+        std::memset(&req, 0, sizeof(req));
+        std::memset(&rsp, 0, sizeof(rsp));
+        req.data_in = iq_in.data();
+        req.unit = unit;
+        req.modulation = modulation;
+        req.num_symbols = num_symbols;
+        req.re_mask = mask;
+        rsp.data_out = out.data();
+        ASSERT_EQ(xranlib_5gnr_mod_compression_avx512(&req, &rsp), XRAN_STATUS_SUCCESS);
+    }
+
+    template <typename F>
+    void decompress(F function, int16_t mask, std::vector<int8_t> &in, std::vector<int16_t> &out) {
+        struct xranlib_5gnr_mod_decompression_request  req;
+        struct xranlib_5gnr_mod_decompression_response rsp;
+        std::memset(&req, 0, sizeof(req));
+        std::memset(&rsp, 0, sizeof(rsp));
+        req.data_in = in.data();
+        req.unit = unit;
+        req.modulation = modulation;
+        req.num_symbols = num_symbols;
+        req.re_mask = mask;
+        rsp.data_out = out.data();
+        ASSERT_EQ(function(&req, &rsp), XRAN_STATUS_SUCCESS);
+    }
+};
+
+/* Compress and decompress valid constellation points, only REs enabled in re_mask are written */
+TEST_P(Mod_CompressionCheck, AVX512_Mod_RoundTrip)
+{
+    std::vector<int8_t> comp(comp_bytes() + 64, 0);
+    std::vector<int16_t> decomp_avx(2 * num_symbols + 32, 0x5a5a);
+    std::vector<int16_t> decomp_ref(2 * num_symbols + 32, 0x5a5a);
+
+    compress(0xfff, comp);
+    decompress(xranlib_5gnr_mod_decompression_avx512, re_mask, comp, decomp_avx);
+    decompress(xranlib_5gnr_mod_decompression_c, re_mask, comp, decomp_ref);
+
+    for (int32_t iSc = 0; iSc < num_symbols; iSc++) {
+        for (int32_t k = 0; k < 2; k++) {
+            int16_t expected = re_enabled(iSc) ? iq_in[2 * iSc + k] : int16_t(0x5a5a);
+            ASSERT_EQ(decomp_ref[2 * iSc + k], expected) << "C reference mismatch at RE " << iSc;
+            ASSERT_EQ(decomp_avx[2 * iSc + k], expected) << "AVX512 mismatch at RE " << iSc;
+        }
+    }
+    for (size_t i = 2 * num_symbols; i < decomp_avx.size(); i++)
+        ASSERT_EQ(decomp_avx[i], int16_t(0x5a5a)) << "AVX512 wrote past the output at " << i;
+}
+
+/* Encoding with an RE mask into a dirty buffer keeps the bits of the enabled REs and clears the
+ * others, two complementary masks give the full RB payload */
+TEST_P(Mod_CompressionCheck, AVX512_Mod_Comp_ReMask)
+{
+    const int16_t mask = re_mask & 0xfff;
+    const int16_t other = int16_t(~re_mask & 0xfff);
+    std::vector<int8_t> comp_full(comp_bytes() + 64, 0);
+    std::vector<int8_t> comp_mask(comp_bytes() + 64, int8_t(0xa5));
+    std::vector<int8_t> comp_other(comp_bytes() + 64, int8_t(0x5a));
+
+    compress(0xfff, comp_full);
+    compress(mask, comp_mask);
+
+    if (mask == 0 || mask == 0xfff) {
+        ASSERT_EQ(0, std::memcmp(comp_full.data(), comp_mask.data(), comp_bytes()));
+        return;
+    }
+
+    compress(other, comp_other);
+    for (int32_t iSc = 0; iSc < num_symbols; iSc++) {
+        for (int32_t b = iSc * modulation; b < (iSc + 1) * modulation; b++) {
+            const int32_t bit = 0x80 >> (b & 0x7);
+            const int32_t full = comp_full[b >> 3] & bit;
+            const bool enabled = (mask >> (iSc % 12)) & 0x1;
+
+            ASSERT_EQ(comp_mask[b >> 3] & bit, enabled ? full : 0) << "RE " << iSc;
+            ASSERT_EQ(comp_other[b >> 3] & bit, enabled ? 0 : full) << "RE " << iSc;
+        }
+    }
+    for (int32_t i = 0; i < comp_bytes(); i++)
+        ASSERT_EQ(int8_t(comp_mask[i] | comp_other[i]), comp_full[i]) << "byte " << i;
+}
+
 TEST_P(Mod_CompressionPerf, AVX512_Mod_Comp)
 {
      performance("AVX512", module_name, xranlib_5gnr_mod_compression_avx512, &mod_com_req, &mod_com_rsp);
@@ -81,5 +239,33 @@ TEST_P(Mod_CompressionPerf,  AVXSNC_Mod_Comp)
          performance("AVXSNC", module_name, xranlib_5gnr_mod_compression_snc, &mod_com_req, &mod_com_rsp);
 }
 
+TEST_P(Mod_CompressionPerf, AVX512_Mod_Comp_ReMask)
+{
+    mod_com_req.re_mask = 0x555;
+    performance("AVX512", module_name, xranlib_5gnr_mod_compression_avx512, &mod_com_req, &mod_com_rsp);
+}
+
+TEST_P(Mod_DecompressionPerf, C_Mod_Decomp)
+{
+    performance("C", module_name, xranlib_5gnr_mod_decompression_c, &mod_decom_req, &mod_decom_rsp);
+}
+
+TEST_P(Mod_DecompressionPerf, AVX512_Mod_Decomp)
+{
+    performance("AVX512", module_name, xranlib_5gnr_mod_decompression_avx512, &mod_decom_req, &mod_decom_rsp);
+}
+
+TEST_P(Mod_DecompressionPerf, AVX512_Mod_Decomp_ReMask)
+{
+    mod_decom_req.re_mask = 0x555;
+    performance("AVX512", module_name, xranlib_5gnr_mod_decompression_avx512, &mod_decom_req, &mod_decom_rsp);
+}
+
 INSTANTIATE_TEST_CASE_P(UnitTest, Mod_CompressionPerf,
                         testing::ValuesIn(get_sequence(Mod_CompressionPerf::get_number_of_cases("mod_compression_performace"))));
+
+INSTANTIATE_TEST_CASE_P(UnitTest, Mod_DecompressionPerf,
+                        testing::ValuesIn(get_sequence(Mod_DecompressionPerf::get_number_of_cases("mod_compression_performace"))));
+
+INSTANTIATE_TEST_CASE_P(UnitTest, Mod_CompressionCheck,
+                        testing::ValuesIn(get_sequence(Mod_CompressionCheck::get_number_of_cases("mod_compression_functional"))));
@@ -0,0 +1,302 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/*
+ * One-way delay estimator and timing window controller, driven by
+ * measurement runs drawn from a synthetic delay distribution.
+ */
+
+#include "common.hpp"
+#include "xran_fh_o_du.h"
+#include "xran_owd_estimator.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+const std::string module_name = "owd_estimator_functional";
+
+class OwdEstimatorFunctional : public KernelTests
+{
+protected:
+    uint32_t delayNs;
+    uint32_t jitterNs;
+    uint32_t outlierPct;
+    uint32_t numSamples;
+    uint32_t numRuns;
+    struct xran_ecpri_del_meas_cmn cmn;
+    std::mt19937_64 gen;
+
+    void SetUp() override {
+        init_test("owd_estimator_functional");
+        delayNs     = get_input_parameter<uint32_t>("delay_ns");
+        jitterNs    = get_input_parameter<uint32_t>("jitter_ns");
+        outlierPct  = get_input_parameter<uint32_t>("outlier_pct");
+        numSamples  = get_input_parameter<uint32_t>("samples");
+        numRuns     = get_input_parameter<uint32_t>("runs");
+
+        memset(&cmn, 0, sizeof(cmn));
+        cmn.numberOfSamples     = numSamples;
+        cmn.filterType          = XRAN_OWD_FILTER_PCTL;
+        cmn.owdm_budgetNs       = get_input_parameter<uint32_t>("budget_ns");
+        cmn.owdm_guardNs        = get_input_parameter<uint32_t>("guard_ns");
+        cmn.owdm_maxShrinkUs    = get_input_parameter<uint16_t>("max_shrink_us");
+        cmn.owdm_maxGrowUs      = get_input_parameter<uint16_t>("max_grow_us");
+        cmn.owdm_stepUs         = get_input_parameter<uint16_t>("step_us");
+        gen.seed(12345);
+    }
+
+    void TearDown() override {
+    }
+
+    /* one measurement run, returns the number of spikes after the warm-up samples */
+    uint32_t draw_run(uint64_t *pSamples, uint32_t delay)
+    {
+        std::normal_distribution<double> jitter(0.0, (double)jitterNs);
+        std::uniform_int_distribution<uint32_t> pct(0, 99);
+        /* late by 50 us or 30 sigma, whichever is further */
+        std::uniform_int_distribution<uint32_t> spike(std::max(50000U, 30 * jitterNs), 500000);
+        uint32_t numSpikes = 0;
+
+        for (uint32_t i = 0; i < numSamples; i++) {
+            pSamples[i] = (uint64_t)std::max(1.0, (double)delay + jitter(gen));
+            if (pct(gen) < outlierPct) {
+                pSamples[i] += spike(gen);
+                numSpikes += (i >= XRAN_OWD_SKIP_SAMPLES);
+            }
+        }
+        return numSpikes;
+    }
+
+    /* adjustment the controller should settle on for a delay */
+    int32_t expected_adj(double delay)
+    {
+        double us = std::floor(((double)cmn.owdm_budgetNs - delay - cmn.owdm_guardNs) / 1000.0);
+
+        return (int32_t)std::min((double)cmn.owdm_maxShrinkUs, std::max(-(double)cmn.owdm_maxGrowUs, us));
+    }
+};
+
+TEST_P(OwdEstimatorFunctional, Estimate)
+{
+    uint64_t samples[MX_NUM_SAMPLES];
+    struct xran_owd_estimate est;
+    const uint32_t numMeas = numSamples - XRAN_OWD_SKIP_SAMPLES;
+    uint32_t numRated = 0, numInliers = 0, numDropped = 0, lastBroken = 0;
+    bool broken = false;
+    double sumAvg = 0;
+
+    est.ewma = 0;
+    for (uint32_t run = 0; run < numRuns; run++) {
+        const uint32_t numSpikes = draw_run(samples, delayNs);
+
+        ASSERT_EQ(xran_owd_estimate(samples, numSamples, 0, 0, &est), 0);
+        ASSERT_EQ(est.numKept + est.numOutliers, numMeas);
+
+        /* past half of the samples the median is a spike, nothing to expect */
+        if (2 * numSpikes >= numMeas) {
+            broken      = true;
+            lastBroken  = run;
+            continue;
+        }
+
+        /* every spike is rejected */
+        ASSERT_GE(est.numOutliers, numSpikes) << "run " << run;
+        numRated++;
+        numInliers += numMeas - numSpikes;
+        numDropped += est.numOutliers - numSpikes;
+
+        ASSERT_LE(est.min, est.avg);
+        ASSERT_LE(est.min, est.pctl);
+        ASSERT_LE(std::fabs((double)est.avg - delayNs), 4.0 * jitterNs + 1.0) << "run " << run;
+        /* the EWMA takes a few runs to forget one of spikes */
+        if (!broken || run > lastBroken + 8)
+            ASSERT_LE(std::fabs((double)est.ewma - delayNs), 4.0 * jitterNs + 1.0) << "run " << run;
+        sumAvg += (double)est.avg;
+    }
+
+    /* few good samples lost, no bias left by the spikes */
+    ASSERT_GT(numRated, numRuns / 2);
+    ASSERT_LE(numDropped * 20, numInliers);
+    ASSERT_LE(std::fabs(sumAvg / numRated - delayNs), jitterNs / 2.0 + 1.0);
+
+    ASSERT_EQ(xran_owd_select(&est, XRAN_OWD_FILTER_AVG), est.avg);
+    ASSERT_EQ(xran_owd_select(&est, XRAN_OWD_FILTER_MIN), est.min);
+    ASSERT_EQ(xran_owd_select(&est, XRAN_OWD_FILTER_PCTL), est.pctl);
+    ASSERT_EQ(xran_owd_select(&est, XRAN_OWD_FILTER_EWMA), est.ewma);
+    ASSERT_EQ(xran_owd_estimate(samples, 0, 0, 0, &est), -1);
+}
+
+TEST_P(OwdEstimatorFunctional, Percentile)
+{
+    uint64_t samples[MX_NUM_SAMPLES];
+    struct xran_owd_estimate est;
+
+    /* 2 warm-up samples then 10 to 100 us, no outliers on a uniform spread */
+    samples[0] = 1;
+    samples[1] = 1000000;
+    for (uint32_t i = 0; i < 10; i++)
+        samples[2 + (i * 7) % 10] = 10000 * (i + 1);
+
+    est.ewma = 0;
+    ASSERT_EQ(xran_owd_estimate(samples, 12, 90, 1, &est), 0);
+    ASSERT_EQ(est.numOutliers, 0U);
+    ASSERT_EQ(est.min, 10000U);
+    ASSERT_EQ(est.pctl, 90000U);
+    ASSERT_EQ(est.avg, 55000U);
+
+    est.ewma = 0;
+    ASSERT_EQ(xran_owd_estimate(samples, 12, 100, 1, &est), 0);
+    ASSERT_EQ(est.pctl, 100000U);
+    est.ewma = 0;
+    ASSERT_EQ(xran_owd_estimate(samples, 12, 1, 1, &est), 0);
+    ASSERT_EQ(est.pctl, 10000U);
+}
+
+TEST_P(OwdEstimatorFunctional, Converge)
+{
+    uint64_t samples[MX_NUM_SAMPLES];
+    struct xran_owd_estimate est;
+    xran_fh_per_mu_cfg mu, ref;
+    int32_t adj = 0, applied = 0, prev;
+    uint32_t numSettled = 0, numMoves = 0, run;
+    /* the 90th percentile sits about 1.3 sigma above the mean */
+    const double pctlNs = delayNs + 1.3 * jitterNs;
+    const int32_t tol = XRAN_OWD_WINDOW_HYST_US + 1 + (int32_t)(2 * jitterNs / 1000);
+
+    memset(&mu, 0, sizeof(mu));
+    mu.T1a_max_up    = 196;
+    mu.T1a_min_up    = 50;
+    mu.T1a_max_cp_dl = 258;
+    mu.T1a_max_cp_ul = 336;
+    mu.Ta4_min       = 60;
+    mu.Ta4_max       = 150;
+    ref = mu;
+
+    /* one step per run, the EWMA carried over as by the port */
+    est.ewma = 0;
+    for (run = 0; run < numRuns; run++) {
+        draw_run(samples, delayNs);
+        ASSERT_EQ(xran_owd_estimate(samples, numSamples, cmn.owdm_pctl, cmn.owdm_ewmaShift, &est), 0);
+
+        prev = adj;
+        adj  = xran_owd_window_step(&cmn, xran_owd_window_target(&cmn, xran_owd_select(&est, cmn.filterType)), adj);
+
+        /* within the limits, tightening by steps */
+        ASSERT_LE(adj, (int32_t)cmn.owdm_maxShrinkUs);
+        ASSERT_GE(adj, -(int32_t)cmn.owdm_maxGrowUs);
+        if (cmn.owdm_stepUs)
+            ASSERT_LE(adj - prev, (int32_t)cmn.owdm_stepUs) << "run " << run;
+
+        if (adj != prev) {
+            applied = xran_owd_window_apply(&mu, applied, adj);
+            ASSERT_EQ(applied, adj);
+            ASSERT_EQ(mu.T1a_max_up, ref.T1a_max_up - adj);
+            ASSERT_EQ(mu.Ta4_max, ref.Ta4_max - adj);
+        }
+
+        if (run >= numRuns / 2) {
+            numSettled += (std::abs(adj - expected_adj(pctlNs)) <= tol);
+            numMoves   += (adj != prev);
+        }
+    }
+
+    /* settled over most of the second half, a run made of spikes widens
+     * at once and the windows come back by steps */
+    ASSERT_GE(numSettled * 4, (numRuns - numRuns / 2) * 3);
+    /* no flapping in steady state: a move is a spike or the way back from one */
+    ASSERT_LE(numMoves * 5, numRuns - numRuns / 2);
+
+    /* the delay steps up: widened on the next run */
+    draw_run(samples, delayNs + 20000);
+    est.ewma = 0;
+    ASSERT_EQ(xran_owd_estimate(samples, numSamples, cmn.owdm_pctl, cmn.owdm_ewmaShift, &est), 0);
+    adj = xran_owd_window_step(&cmn, xran_owd_window_target(&cmn, xran_owd_select(&est, cmn.filterType)), adj);
+    ASSERT_LE(adj, expected_adj(pctlNs + 20000) + tol);
+
+    /* and back down: tightened again by steps until settled */
+    est.ewma = 0;
+    for (run = 0; run < 40; run++) {
+        draw_run(samples, delayNs);
+        ASSERT_EQ(xran_owd_estimate(samples, numSamples, cmn.owdm_pctl, cmn.owdm_ewmaShift, &est), 0);
+        prev = adj;
+        adj  = xran_owd_window_step(&cmn, xran_owd_window_target(&cmn, xran_owd_select(&est, cmn.filterType)), adj);
+        if (cmn.owdm_stepUs)
+            ASSERT_LE(adj - prev, (int32_t)cmn.owdm_stepUs) << "run " << run;
+    }
+    ASSERT_LE(std::abs(adj - expected_adj(pctlNs)), tol);
+
+    /* no budget, no tuning */
+    cmn.owdm_budgetNs = 0;
+    ASSERT_EQ(xran_owd_window_step(&cmn, xran_owd_window_target(&cmn, delayNs), 0), 0);
+}
+
+TEST_P(OwdEstimatorFunctional, Windows)
+{
+    xran_fh_per_mu_cfg mu, ref;
+    int32_t applied = 0;
+
+    memset(&mu, 0, sizeof(mu));
+    mu.T1a_max_up    = 196;
+    mu.T1a_min_up    = 50;
+    mu.T1a_max_cp_dl = 258;
+    mu.T1a_max_cp_ul = 336;
+    mu.T2a_max_up    = 345;
+    mu.Ta3_min       = 20;
+    mu.Ta4_min       = 24;
+    mu.Ta4_max       = 75;
+    mu.T2a_min_up    = 71;
+    mu.Ta3_max       = 32;
+    ref = mu;
+
+    /* every transport dependent window moves once */
+    applied = xran_owd_window_apply(&mu, applied, 10);
+    ASSERT_EQ(applied, 10);
+    ASSERT_EQ(mu.T1a_max_up, ref.T1a_max_up - 10);
+    ASSERT_EQ(mu.T1a_min_up, ref.T1a_min_up - 10);
+    ASSERT_EQ(mu.T1a_max_cp_dl, ref.T1a_max_cp_dl - 10);
+    ASSERT_EQ(mu.T1a_max_cp_ul, ref.T1a_max_cp_ul - 10);
+    ASSERT_EQ(mu.Ta4_min, ref.Ta4_min - 10);
+    ASSERT_EQ(mu.Ta4_max, ref.Ta4_max - 10);
+
+    /* O-RU windows are left to the O-RU */
+    ASSERT_EQ(mu.T2a_max_up, ref.T2a_max_up);
+    ASSERT_EQ(mu.T2a_min_up, ref.T2a_min_up);
+    ASSERT_EQ(mu.Ta3_min, ref.Ta3_min);
+    ASSERT_EQ(mu.Ta3_max, ref.Ta3_max);
+
+    /* limited by the smallest window, Ta4_min */
+    applied = xran_owd_window_apply(&mu, applied, 40);
+    ASSERT_EQ(applied, (int32_t)ref.Ta4_min);
+    ASSERT_EQ(mu.Ta4_min, 0);
+    ASSERT_EQ(mu.T1a_max_up, ref.T1a_max_up - ref.Ta4_min);
+    ASSERT_EQ(mu.Ta3_min, ref.Ta3_min);
+
+    /* widened past the configuration, then back to it */
+    applied = xran_owd_window_apply(&mu, applied, -5);
+    ASSERT_EQ(applied, -5);
+    ASSERT_EQ(mu.T1a_max_cp_ul, ref.T1a_max_cp_ul + 5);
+    applied = xran_owd_window_apply(&mu, applied, 0);
+    ASSERT_EQ(applied, 0);
+    ASSERT_EQ(memcmp(&mu, &ref, sizeof(mu)), 0);
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, OwdEstimatorFunctional,
+                        testing::ValuesIn(get_sequence(OwdEstimatorFunctional::get_number_of_cases("owd_estimator_functional"))));
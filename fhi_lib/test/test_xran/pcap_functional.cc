@@ -0,0 +1,306 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/*
+ * Packet capture helpers: the capture ring between IO cores and the writer,
+ * and the PCAP-NG / pcap encoding read back by the replay.
+ */
+
+#include "common.hpp"
+#include "xran_pcap.h"
+
+#include <stdint.h>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+const std::string module_name = "pcap_functional";
+
+namespace
+{
+    /* packet n of a sequence, length and content depend on n */
+    inline uint32_t pkt_len(uint32_t n, uint32_t maxLen)
+    {
+        return 60 + (n * 97) % (maxLen - 59);
+    }
+
+    inline uint8_t pkt_byte(uint32_t n, uint32_t i)
+    {
+        return (uint8_t)(n * 31 + i);
+    }
+
+    /* bytes of numPackets packets with a per packet overhead */
+    inline size_t total_len(uint32_t numPackets, uint32_t maxLen, uint32_t overhead)
+    {
+        size_t len = 0;
+
+        for (uint32_t n = 0; n < numPackets; n++)
+            len += pkt_len(n, maxLen) + overhead;
+        return len;
+    }
+
+    bool check_pkt(const uint8_t *p, uint32_t len, uint32_t n)
+    {
+        for (uint32_t i = 0; i < len; i++)
+            if (p[i] != pkt_byte(n, i))
+                return false;
+        return true;
+    }
+}
+
+class PcapFunctional : public KernelTests
+{
+protected:
+    uint32_t ringSize;
+    uint32_t snapLen;
+    uint32_t numPackets;
+    struct xran_pcap_ring ring;
+
+    void SetUp() override {
+        init_test("pcap_functional");
+        ringSize    = get_input_parameter<uint32_t>("ring_size");
+        snapLen     = get_input_parameter<uint32_t>("snap_len");
+        numPackets  = get_input_parameter<uint32_t>("packets");
+
+        std::memset(&ring, 0, sizeof(ring));
+        ring.pBuf = aligned_malloc<uint8_t>((int)ringSize, 64);
+        ring.size = ringSize;
+    }
+
+    void TearDown() override {
+        aligned_free(ring.pBuf);
+    }
+
+    bool produce(uint32_t n)
+    {
+        const uint32_t len = pkt_len(n, snapLen);
+        struct xran_pcap_rec *pRec = xran_pcap_ring_reserve(&ring, len);
+        uint8_t *p;
+
+        if (pRec == NULL)
+            return false;
+
+        pRec->vf        = (uint16_t)(n % 4);
+        pRec->dir       = XRAN_PCAP_DIR_RX + n % 2;
+        pRec->origLen   = len;
+        pRec->ts        = n;
+        p = (uint8_t *)(pRec + 1);
+        for (uint32_t i = 0; i < len; i++)
+            p[i] = pkt_byte(n, i);
+        xran_pcap_ring_commit(&ring);
+
+        return true;
+    }
+
+    /* returns false on the first record out of order or corrupted */
+    bool consume(uint32_t n)
+    {
+        const struct xran_pcap_rec *pRec = xran_pcap_ring_peek(&ring);
+        bool ok;
+
+        if (pRec == NULL)
+            return false;
+
+        ok = pRec->ts == n && pRec->capLen == pkt_len(n, snapLen) && pRec->vf == n % 4
+            && pRec->dir == XRAN_PCAP_DIR_RX + n % 2 && (pRec->len & 7) == 0
+            && check_pkt((const uint8_t *)(pRec + 1), pRec->capLen, n);
+        xran_pcap_ring_release(&ring, pRec);
+
+        return ok;
+    }
+};
+
+TEST_P(PcapFunctional, Ring)
+{
+    uint32_t prod = 0, cons = 0;
+
+    ASSERT_TRUE(xran_pcap_ring_peek(&ring) == NULL);
+
+    /* fill up, then drain part of it, across many wraps */
+    while (cons < numPackets) {
+        while (prod < numPackets && produce(prod))
+            prod++;
+        ASSERT_GT(prod, cons);
+
+        for (uint32_t i = 0; i < (prod - cons + 1) / 2 && cons < prod; i++)
+            ASSERT_TRUE(consume(cons++)) << "record " << cons - 1;
+        if (prod == numPackets)
+            while (cons < prod)
+                ASSERT_TRUE(consume(cons++)) << "record " << cons - 1;
+    }
+
+    ASSERT_TRUE(xran_pcap_ring_peek(&ring) == NULL);
+    ASSERT_EQ((uint64_t)ring.prod, (uint64_t)ring.cons);
+
+    /* a record larger than the ring is refused */
+    ASSERT_TRUE(xran_pcap_ring_reserve(&ring, ring.size) == NULL);
+}
+
+TEST_P(PcapFunctional, RingThreads)
+{
+    std::thread producer([this]() {
+        for (uint32_t n = 0; n < numPackets; )
+            if (produce(n))
+                n++;
+    });
+
+    uint32_t bad = 0;
+    for (uint32_t n = 0; n < numPackets; )
+        if (xran_pcap_ring_peek(&ring) != NULL) {
+            bad += !consume(n);
+            n++;
+        }
+    producer.join();
+
+    ASSERT_EQ(bad, 0U);
+    ASSERT_EQ((uint64_t)ring.prod, (uint64_t)ring.cons);
+}
+
+TEST_P(PcapFunctional, PcapNg)
+{
+    std::vector<uint8_t> file(XRAN_PCAPNG_SHB_LEN + 2 * 64 + total_len(numPackets, snapLen, XRAN_PCAPNG_EPB_LEN + 3));
+    std::vector<uint8_t> data(snapLen);
+    struct xran_pcap_reader reader;
+    struct xran_pcap_pkt pkt;
+    uint64_t len = 0;
+    uint32_t n;
+
+    len += xran_pcapng_shb(&file[len]);
+    len += xran_pcapng_idb(&file[len], snapLen, "vf0");
+    len += xran_pcapng_idb(&file[len], snapLen, "vf1_long_name");
+    for (n = 0; n < numPackets; n++) {
+        const uint32_t capLen = pkt_len(n, snapLen);
+
+        for (uint32_t i = 0; i < capLen; i++)
+            data[i] = pkt_byte(n, i);
+        len += xran_pcapng_epb(&file[len], n % 2, 1600000000000000000ULL + n * 1000ULL + 7,
+                               data.data(), capLen, capLen + n % 3, XRAN_PCAP_DIR_RX + n % 2);
+        ASSERT_EQ(len % 4, 0U);
+    }
+
+    ASSERT_EQ(xran_pcap_reader_init(&reader, file.data(), len), 0);
+    for (n = 0; n < numPackets; n++) {
+        ASSERT_EQ(xran_pcap_reader_next(&reader, &pkt), 1) << "packet " << n;
+        ASSERT_EQ(pkt.ifId, n % 2);
+        ASSERT_EQ(pkt.ts, 1600000000000000000ULL + n * 1000ULL + 7);
+        ASSERT_EQ(pkt.capLen, pkt_len(n, snapLen));
+        ASSERT_EQ(pkt.origLen, pkt.capLen + n % 3);
+        ASSERT_EQ(pkt.dir, XRAN_PCAP_DIR_RX + n % 2);
+        ASSERT_TRUE(check_pkt(pkt.pData, pkt.capLen, n));
+    }
+    ASSERT_EQ(xran_pcap_reader_next(&reader, &pkt), 0);
+
+    /* a cut file is reported, not read past its end */
+    ASSERT_EQ(xran_pcap_reader_init(&reader, file.data(), len - 6), 0);
+    while ((n = xran_pcap_reader_next(&reader, &pkt)) == 1)
+        ;
+    ASSERT_EQ((int32_t)n, -1);
+
+    /* a packet of an interface not described */
+    len = xran_pcapng_shb(file.data());
+    len += xran_pcapng_epb(&file[len], 0, 0, data.data(), 60, 60, XRAN_PCAP_DIR_RX);
+    ASSERT_EQ(xran_pcap_reader_init(&reader, file.data(), len), 0);
+    ASSERT_EQ(xran_pcap_reader_next(&reader, &pkt), -1);
+}
+
+TEST_P(PcapFunctional, Pcap)
+{
+    std::vector<uint8_t> file(XRAN_PCAP_HDR_LEN + total_len(numPackets, snapLen, XRAN_PCAP_REC_HDR_LEN));
+    struct xran_pcap_reader reader;
+    struct xran_pcap_pkt pkt;
+    uint64_t len = 0;
+    uint32_t n;
+
+    /* classic pcap with microsecond timestamps */
+    std::memset(file.data(), 0, XRAN_PCAP_HDR_LEN);
+    xran_pcap_put32(&file[0], XRAN_PCAP_MAGIC_US);
+    xran_pcap_put16(&file[4], 2);
+    xran_pcap_put16(&file[6], 4);
+    xran_pcap_put32(&file[16], snapLen);
+    xran_pcap_put32(&file[20], XRAN_PCAP_LINKTYPE_ETH);
+    len = XRAN_PCAP_HDR_LEN;
+
+    for (n = 0; n < numPackets; n++) {
+        const uint32_t capLen = pkt_len(n, snapLen);
+
+        xran_pcap_put32(&file[len], 1000 + n / 1000);
+        xran_pcap_put32(&file[len + 4], (n % 1000) * 1000);
+        xran_pcap_put32(&file[len + 8], capLen);
+        xran_pcap_put32(&file[len + 12], capLen);
+        for (uint32_t i = 0; i < capLen; i++)
+            file[len + XRAN_PCAP_REC_HDR_LEN + i] = pkt_byte(n, i);
+        len += XRAN_PCAP_REC_HDR_LEN + capLen;
+    }
+
+    ASSERT_EQ(xran_pcap_reader_init(&reader, file.data(), len), 0);
+    for (n = 0; n < numPackets; n++) {
+        ASSERT_EQ(xran_pcap_reader_next(&reader, &pkt), 1) << "packet " << n;
+        ASSERT_EQ(pkt.ifId, 0U);
+        ASSERT_EQ(pkt.dir, XRAN_PCAP_DIR_NONE);
+        ASSERT_EQ(pkt.ts, (1000ULL + n / 1000) * 1000000000ULL + (n % 1000) * 1000000ULL);
+        ASSERT_EQ(pkt.capLen, pkt_len(n, snapLen));
+        ASSERT_TRUE(check_pkt(pkt.pData, pkt.capLen, n));
+    }
+    ASSERT_EQ(xran_pcap_reader_next(&reader, &pkt), 0);
+
+    /* other link types and byte orders are refused */
+    xran_pcap_put32(&file[20], 101);
+    ASSERT_EQ(xran_pcap_reader_init(&reader, file.data(), len), -1);
+    xran_pcap_put32(&file[0], 0xD4C3B2A1);
+    ASSERT_EQ(xran_pcap_reader_init(&reader, file.data(), len), -1);
+}
+
+TEST_P(PcapFunctional, TsResol)
+{
+    ASSERT_EQ(xran_pcap_ts_to_ns(5, 9), 5ULL);
+    ASSERT_EQ(xran_pcap_ts_to_ns(5, 6), 5000ULL);
+    ASSERT_EQ(xran_pcap_ts_to_ns(5, 0), 5000000000ULL);
+    ASSERT_EQ(xran_pcap_ts_to_ns(5000, 12), 5ULL);
+    ASSERT_EQ(xran_pcap_ts_to_ns(1ULL << 30, 0x80 | 30), 1000000000ULL);
+}
+
+TEST_P(PcapFunctional, NicClock)
+{
+    /* NIC clocks in ns, at 156.25 MHz and at 25 MHz, calibrated over 10 ms */
+    const double rates[] = { 1e9, 156.25e6, 25e6 };
+    const uint64_t nsAtClk1 = 1700000000ULL * 1000000000ULL;
+    struct xran_pcap_nic_clock clk;
+
+    for (const double rate : rates) {
+        const uint64_t clk0 = 123456789ULL;
+        const uint64_t clk1 = clk0 + (uint64_t)(rate / 100);
+
+        ASSERT_EQ(xran_pcap_nic_clock_set(&clk, clk0, clk1, 10e6, nsAtClk1), 0);
+        ASSERT_EQ(xran_pcap_nic_clock_ns(&clk, clk1), nsAtClk1);
+
+        /* packets received up to a second before and after the calibration */
+        for (int64_t ms = -1000; ms <= 1000; ms += 250) {
+            const uint64_t ts = clk1 + (int64_t)(rate / 1000) * ms;
+            const int64_t err = (int64_t)(xran_pcap_nic_clock_ns(&clk, ts) - (nsAtClk1 + ms * 1000000));
+
+            ASSERT_LE(std::abs(err), 1);
+        }
+    }
+
+    /* a clock which does not run is not used */
+    ASSERT_EQ(xran_pcap_nic_clock_set(&clk, 5, 5, 10e6, nsAtClk1), -1);
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, PcapFunctional,
+                        testing::ValuesIn(get_sequence(PcapFunctional::get_number_of_cases("pcap_functional"))));
@@ -0,0 +1,228 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/*
+ * PRACH, SRS and TDD occasion tables, checked slot by slot over the SFN
+ * cycle against xran_fs_get_slot_type(), xran_fs_get_symbol_type() and
+ * xran_dev_is_prach_slot() with the frame condition of the callers, for
+ * every PRACH configuration index.
+ */
+
+#include "common.hpp"
+#include "xran_common.h"
+#include "xran_fh_o_du.h"
+#include "xran_frame_struct.h"
+#include "xran_occasion.h"
+
+#include <stdint.h>
+#include <cstring>
+#include <string>
+
+const std::string module_name = "prach_occasion_functional";
+
+class PrachOccasionFunctional : public KernelTests
+{
+protected:
+    struct xran_device_ctx m_ctx;
+    struct xran_fh_config *m_pConf;
+    uint8_t m_mu;
+    uint32_t m_portId;
+    uint32_t m_tddPeriod;
+    bool m_dss;
+
+    void SetUp() override {
+        std::string pattern;
+        std::vector<int> spSym;
+
+        init_test("prach_occasion_functional");
+
+        memset(&m_ctx, 0, sizeof(m_ctx));
+        m_ctx.perMu = (xran_device_per_mu_fields *)calloc(XRAN_MAX_NUM_MU, sizeof(xran_device_per_mu_fields));
+        ASSERT_TRUE(m_ctx.perMu != NULL);
+        m_pConf = &m_ctx.fh_cfg;
+
+        m_mu        = get_input_parameter<uint8_t>("mu");
+        m_portId    = get_input_parameter<uint32_t>("port");
+        m_dss       = get_input_parameter<uint32_t>("dss") != 0;
+        pattern     = get_input_parameter<std::string>("slot_pattern");
+        spSym       = get_input_parameter<std::vector<int>>("sp_symbols");
+
+        m_ctx.xran_port_id      = m_portId;
+        m_ctx.dssEnable         = m_dss;
+        m_pConf->dssEnable      = m_dss;
+        m_pConf->numMUs         = 1;
+        m_pConf->mu_number[0]   = m_mu;
+        m_pConf->neAxc          = 4;
+        m_pConf->perMu[m_mu].nULRBs = 273;
+        m_pConf->perMu[m_mu].prach_conf.nPrachSubcSpacing = m_mu;
+        m_ctx.srs_cfg.slot      = get_input_parameter<uint32_t>("srs_slot");
+        m_ctx.srs_cfg.symbMask  = get_input_parameter<uint16_t>("srs_symb_mask");
+
+        /* D, U or S per slot, S takes sp_symbols */
+        m_pConf->frame_conf.nFrameDuplexType = pattern.empty() ? XRAN_FDD : XRAN_TDD;
+        m_pConf->frame_conf.nTddPeriod = m_tddPeriod = (uint32_t)pattern.size();
+        for (uint32_t slot = 0; slot < m_tddPeriod; slot++)
+            for (uint32_t sym = 0; sym < XRAN_NUM_OF_SYMBOL_PER_SLOT; sym++)
+                m_pConf->frame_conf.sSlotConfig[slot].nSymbolType[sym] =
+                    (pattern[slot] == 'D') ? XRAN_SYMBOL_TYPE_DL :
+                    (pattern[slot] == 'U') ? XRAN_SYMBOL_TYPE_UL : spSym[sym];
+
+        xran_fs_slot_limit_init(m_mu);
+        xran_fs_set_slot_type(m_portId, 0, m_pConf->frame_conf.nFrameDuplexType, m_tddPeriod,
+                              m_pConf->frame_conf.sSlotConfig);
+    }
+
+    void TearDown() override {
+        xran_free_occasions(&m_ctx);
+        xran_fs_clear_slot_type(m_portId, 0);
+        free(m_ctx.perMu);
+    }
+
+    /* PRACH symbols the callers would send on for a frame id */
+    uint16_t ref_prach(const struct xran_prach_cp_config *pCfg, uint32_t frameId, uint32_t sfId, uint32_t slotId)
+    {
+        uint16_t mask = 0;
+
+        if (m_mu == 2 || pCfg->x == 0 || (frameId % pCfg->x) != pCfg->y[0]
+            || xran_dev_is_prach_slot(&m_ctx, sfId, slotId, m_mu) != 1)
+            return 0;
+
+        for (int32_t sym = 0; sym < XRAN_NUM_OF_SYMBOL_PER_SLOT; sym++)
+            if (sym >= m_ctx.prach_start_symbol[0] && sym <= m_ctx.prach_last_symbol[0])
+                mask |= (1 << sym);
+        return mask;
+    }
+
+    /* every slot of the SFN cycle, returns the first mismatch or -1 */
+    int64_t check_table(uint32_t *pNumPrach)
+    {
+        const struct xran_occ_tbl *pTbl = &m_ctx.perMu[m_mu].occTbl;
+        const struct xran_prach_cp_config *pCfg[XRAN_OCC_PRACH_NUM] = {
+            &m_ctx.perMu[m_mu].PrachCPConfig, &m_ctx.perMu[m_mu].PrachCPConfigLTE };
+        const uint32_t interval = xran_fs_get_tti_interval(m_mu);
+        const uint32_t slotsPerSf = SLOTNUM_PER_SUBFRAME(interval);
+        const uint32_t slotsPerFrame = SLOTS_PER_SYSTEMFRAME(interval);
+        const uint32_t maxSlots = xran_fs_get_max_slot(m_mu);
+        const uint32_t numCfg = m_dss ? XRAN_OCC_PRACH_NUM : 1;
+
+        for (uint32_t tti = 0; tti < maxSlots; tti++) {
+            const struct xran_occ_slot *pOcc = xran_occ_get(pTbl, tti);
+            const uint32_t slotId = XranGetSlotNum(tti, slotsPerSf);
+            const uint32_t sfId = XranGetSubFrameNum(tti, slotsPerSf, SUBFRAMES_PER_SYSTEMFRAME);
+            const uint32_t sfn = tti / slotsPerFrame;
+            uint16_t ulSym = 0, dlSym = 0;
+            bool srs;
+
+            /* past the cycle the tti wraps */
+            if (xran_occ_get(pTbl, tti + maxSlots) != xran_occ_get(pTbl, tti) && pTbl->numSlots <= maxSlots)
+                return tti;
+
+            for (int32_t type = XRAN_SLOT_TYPE_DL; type < XRAN_SLOT_TYPE_LAST; type++)
+                if (((pOcc->slotType & XRAN_OCC_SLOT(type)) != 0) != (xran_fs_get_slot_type(m_portId, 0, tti, type, m_mu) == 1))
+                    return tti;
+
+            for (uint32_t sym = 0; sym < XRAN_NUM_OF_SYMBOL_PER_SLOT; sym++) {
+                const int32_t symType = xran_fs_get_symbol_type(m_portId, 0, tti, sym, m_mu);
+
+                if (symType == XRAN_SYMBOL_TYPE_UL || symType == XRAN_SYMBOL_TYPE_FDD)
+                    ulSym |= (1 << sym);
+                if (symType == XRAN_SYMBOL_TYPE_DL || symType == XRAN_SYMBOL_TYPE_FDD)
+                    dlSym |= (1 << sym);
+            }
+            if (pOcc->ulSym != ulSym || pOcc->dlSym != dlSym)
+                return tti;
+
+            srs = m_tddPeriod && (tti % m_tddPeriod) == m_ctx.srs_cfg.slot
+                && (xran_fs_get_slot_type(m_portId, 0, tti, XRAN_SLOT_TYPE_SP, m_mu) == 1
+                    || xran_fs_get_slot_type(m_portId, 0, tti, XRAN_SLOT_TYPE_UL, m_mu) == 1);
+            if (((pOcc->slotType & XRAN_OCC_SLOT_SRS) != 0) != srs || pOcc->srsSym != (srs ? m_ctx.srs_cfg.symbMask : 0))
+                return tti;
+
+            /* PRACH by ORAN frame id and by SFN */
+            for (uint32_t cfg = 0; cfg < numCfg; cfg++) {
+                const uint16_t oran = ref_prach(pCfg[cfg], sfn & 0xff, sfId, slotId);
+                const uint16_t full = ref_prach(pCfg[cfg], sfn & 0x3ff, sfId, slotId);
+
+                if (xran_occ_get_frame(pTbl, sfn & 0xff, tti)->prachSym[cfg] != oran
+                    || xran_occ_get_frame(pTbl, sfn & 0x3ff, tti)->prachSym[cfg] != full)
+                    return tti;
+                *pNumPrach += (full != 0);
+            }
+        }
+
+        return -1;
+    }
+};
+
+TEST_P(PrachOccasionFunctional, AllConfigIndex)
+{
+    struct xran_prach_config *pPrach = &m_pConf->perMu[m_mu].prach_conf;
+    const struct xran_occ_tbl *pTbl = &m_ctx.perMu[m_mu].occTbl;
+    const uint32_t slotsPerFrame = SLOTS_PER_SYSTEMFRAME(xran_fs_get_tti_interval(m_mu));
+    uint32_t numPrach = 0;
+
+    for (uint32_t idx = 0; idx < XRAN_PRACH_CONFIG_TABLE_SIZE; idx++) {
+        pPrach->nPrachConfIdx       = idx;
+        pPrach->nPrachConfIdxLTE    = (idx * 7 + 3) % XRAN_PRACH_CONFIG_TABLE_SIZE;
+        pPrach->prachEaxcOffset     = 0;
+
+        ASSERT_EQ(xran_init_prach(m_pConf, &m_ctx, XRAN_RAN_5GNR, m_mu), XRAN_STATUS_SUCCESS);
+        if (m_dss) {
+            ASSERT_EQ(xran_init_prach(m_pConf, &m_ctx, XRAN_RAN_LTE, m_mu), XRAN_STATUS_SUCCESS);
+        }
+
+        xran_free_occasions(&m_ctx);
+        ASSERT_EQ(xran_init_occasions(&m_ctx), XRAN_STATUS_SUCCESS);
+
+        ASSERT_EQ(pTbl->numSlots, pTbl->numFrames * slotsPerFrame);
+        if (m_ctx.perMu[m_mu].PrachCPConfig.x) {
+            ASSERT_EQ(pTbl->numFrames % m_ctx.perMu[m_mu].PrachCPConfig.x, 0U) << "index " << idx;
+        }
+
+        ASSERT_EQ(check_table(&numPrach), -1) << "index " << idx << ", " << pTbl->numFrames << " frames";
+    }
+
+    /* some of the indexes give PRACH occasions */
+    ASSERT_GT(numPrach, 0U);
+}
+
+TEST_P(PrachOccasionFunctional, NumFrames)
+{
+    const uint8_t x16[] = { 16 }, x2[] = { 2, 1 }, x0[] = { 0 };
+
+    /* FDD: the PRACH period */
+    ASSERT_EQ(xran_occ_num_frames(x16, 1, 0, 10, 1024), 16U);
+    ASSERT_EQ(xran_occ_num_frames(x2, 2, 1, 20, 1024), 2U);
+    ASSERT_EQ(xran_occ_num_frames(x0, 1, 0, 80, 1024), 1U);
+    /* 2.5 ms period at 30 kHz realigns every frame, 4 slots at 15 kHz every 2 */
+    ASSERT_EQ(xran_occ_num_frames(x16, 1, 5, 20, 1024), 16U);
+    ASSERT_EQ(xran_occ_num_frames(x0, 1, 4, 10, 1024), 2U);
+    /* 3 slots never realign at the SFN wrap, the whole cycle */
+    ASSERT_EQ(xran_occ_num_frames(x2, 2, 3, 20, 1024), 1024U);
+    /* 100 frames cycle, widened to the PRACH period */
+    ASSERT_EQ(xran_occ_num_frames(x16, 1, 3, 20, 100), 400U);
+    ASSERT_EQ(xran_occ_num_frames(x0, 1, 3, 20, 100), 100U);
+
+    ASSERT_EQ(xran_occ_sym_mask(0, 0), 0x0001);
+    ASSERT_EQ(xran_occ_sym_mask(2, 13), 0x3ffc);
+    ASSERT_EQ(xran_occ_sym_mask(8, 20), 0x3f00);
+    ASSERT_EQ(xran_occ_sym_mask(5, 4), 0);
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, PrachOccasionFunctional,
+                        testing::ValuesIn(get_sequence(PrachOccasionFunctional::get_number_of_cases("prach_occasion_functional"))));
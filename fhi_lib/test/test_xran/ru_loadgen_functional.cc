@@ -0,0 +1,215 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/*
+ * O-RU load generator helpers: eAxC sharding, impairment draws, timestamp
+ * shifts and the reorder slot.
+ */
+
+#include "common.hpp"
+#include "xran_fh_o_du.h"
+#include "xran_ru_loadgen.h"
+
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+
+const std::string module_name = "ru_loadgen_functional";
+
+class RuLoadGenFunctional : public KernelTests
+{
+protected:
+    uint32_t numAnt;
+    uint32_t numShards;
+    uint32_t numPackets;
+    struct xran_ru_loadgen_cfg cfg;
+
+    void SetUp() override {
+        init_test("ru_loadgen_functional");
+        numAnt          = get_input_parameter<uint32_t>("num_ant");
+        numShards       = get_input_parameter<uint32_t>("num_shards");
+        numPackets      = get_input_parameter<uint32_t>("packets");
+
+        memset(&cfg, 0, sizeof(cfg));
+        cfg.enable      = 1;
+        cfg.numShards   = numShards;
+        cfg.lossPpm     = get_input_parameter<uint32_t>("loss_ppm");
+        cfg.earlyPpm    = get_input_parameter<uint32_t>("early_ppm");
+        cfg.latePpm     = get_input_parameter<uint32_t>("late_ppm");
+        cfg.reorderPpm  = get_input_parameter<uint32_t>("reorder_ppm");
+    }
+
+    void TearDown() override {
+    }
+};
+
+TEST_P(RuLoadGenFunctional, Shards)
+{
+    std::vector<uint32_t> owner(numAnt, numShards);
+    uint32_t start, num, next = 0;
+
+    for (uint32_t shard = 0; shard < numShards; shard++) {
+        num = xran_ru_loadgen_shard(numAnt, numShards, shard, &start);
+
+        /* consecutive, balanced to one eAxC */
+        ASSERT_EQ(start, next);
+        ASSERT_TRUE(num == numAnt / numShards || num == numAnt / numShards + 1);
+        for (uint32_t ant = start; ant < start + num; ant++) {
+            ASSERT_EQ(owner[ant], numShards);
+            owner[ant] = shard;
+        }
+        next = start + num;
+    }
+
+    /* every eAxC belongs to one shard */
+    ASSERT_EQ(next, numAnt);
+    for (uint32_t ant = 0; ant < numAnt; ant++)
+        ASSERT_LT(owner[ant], numShards);
+
+    ASSERT_EQ(xran_ru_loadgen_shard(numAnt, numShards, numShards, &start), 0U);
+    ASSERT_EQ(xran_ru_loadgen_shard(numAnt, 0, 0, &start), 0U);
+}
+
+TEST_P(RuLoadGenFunctional, Rates)
+{
+    uint64_t count[XRAN_RU_LOADGEN_ACT_MAX] = {0};
+    uint64_t state = xran_ru_loadgen_seed(cfg.seed, 0);
+    const uint32_t ppm[XRAN_RU_LOADGEN_ACT_MAX] = {
+        XRAN_RU_LOADGEN_PPM - cfg.lossPpm - cfg.earlyPpm - cfg.latePpm - cfg.reorderPpm,
+        cfg.lossPpm, cfg.earlyPpm, cfg.latePpm, cfg.reorderPpm };
+
+    ASSERT_EQ(xran_ru_loadgen_check(&cfg), 0);
+
+    for (uint32_t i = 0; i < numPackets; i++)
+        count[xran_ru_loadgen_pick(&cfg, xran_ru_loadgen_rand(&state))]++;
+
+    /* within five standard deviations of the configured rates */
+    for (int act = 0; act < XRAN_RU_LOADGEN_ACT_MAX; act++) {
+        const double expect = (double)numPackets * ppm[act] / XRAN_RU_LOADGEN_PPM;
+
+        ASSERT_LE(std::fabs((double)count[act] - expect), 5.0 * std::sqrt(expect) + 1.0) << "act " << act;
+    }
+
+    /* the same seed gives the same pattern, another shard another one */
+    uint64_t a = xran_ru_loadgen_seed(cfg.seed, 0), b = xran_ru_loadgen_seed(cfg.seed, 0);
+    uint64_t c = xran_ru_loadgen_seed(cfg.seed, 1);
+    uint32_t same = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        const uint32_t r = xran_ru_loadgen_rand(&a);
+
+        ASSERT_EQ(r, xran_ru_loadgen_rand(&b));
+        same += (r == xran_ru_loadgen_rand(&c));
+    }
+    ASSERT_LT(same, 10U);
+}
+
+TEST_P(RuLoadGenFunctional, Check)
+{
+    struct xran_ru_loadgen_cfg over = cfg;
+
+    over.lossPpm    = XRAN_RU_LOADGEN_PPM / 2;
+    over.earlyPpm   = XRAN_RU_LOADGEN_PPM / 2;
+    over.latePpm    = 0;
+    over.reorderPpm = 0;
+    ASSERT_EQ(xran_ru_loadgen_check(&over), 0);
+
+    over.reorderPpm = 1;
+    ASSERT_EQ(xran_ru_loadgen_check(&over), -1);
+
+    /* no wrap around of the sum */
+    over.lossPpm    = 0xFFFFFFFF;
+    over.earlyPpm   = 1;
+    ASSERT_EQ(xran_ru_loadgen_check(&over), -1);
+}
+
+TEST_P(RuLoadGenFunctional, Shift)
+{
+    for (uint32_t mu = 0; mu <= 3; mu++) {
+        const uint32_t slotsPerSf = 1 << mu;
+        uint8_t frame = 255, sf = 9, slot = slotsPerSf - 1, sym = 13;
+
+        /* forward across frame 255 to 0 */
+        xran_ru_loadgen_shift(1, slotsPerSf, &frame, &sf, &slot, &sym);
+        ASSERT_EQ(frame, 0);
+        ASSERT_EQ(sf, 0);
+        ASSERT_EQ(slot, 0);
+        ASSERT_EQ(sym, 0);
+
+        /* and back */
+        xran_ru_loadgen_shift(-1, slotsPerSf, &frame, &sf, &slot, &sym);
+        ASSERT_EQ(frame, 255);
+        ASSERT_EQ(sf, 9);
+        ASSERT_EQ(slot, slotsPerSf - 1);
+        ASSERT_EQ(sym, 13);
+
+        /* shifts round trip */
+        for (int32_t shift = -200; shift <= 200; shift += 7) {
+            uint8_t f = 3, s = 4, sl = slotsPerSf / 2, sy = 5;
+
+            xran_ru_loadgen_shift(shift, slotsPerSf, &f, &s, &sl, &sy);
+            ASSERT_LT(s, 10);
+            ASSERT_LT(sl, slotsPerSf);
+            ASSERT_LT(sy, XRAN_NUM_OF_SYMBOL_PER_SLOT);
+            xran_ru_loadgen_shift(-shift, slotsPerSf, &f, &s, &sl, &sy);
+            ASSERT_EQ(f, 3);
+            ASSERT_EQ(s, 4);
+            ASSERT_EQ(sl, slotsPerSf / 2);
+            ASSERT_EQ(sy, 5);
+        }
+    }
+}
+
+TEST_P(RuLoadGenFunctional, MaxPrb)
+{
+    /* 9 bit BFP is 28 bytes per PRB */
+    ASSERT_EQ(xran_ru_loadgen_max_prb(1500, 36, 28), (1500U - 36U) / 28U);
+    ASSERT_EQ(xran_ru_loadgen_max_prb(9600, 36, 48), (9600U - 36U) / 48U);
+    ASSERT_EQ(xran_ru_loadgen_max_prb(40, 36, 48), 1U);
+    ASSERT_EQ(xran_ru_loadgen_max_prb(36, 36, 48), 1U);
+    ASSERT_EQ(xran_ru_loadgen_max_prb(1500, 36, 0), 1U);
+}
+
+TEST_P(RuLoadGenFunctional, Reorder)
+{
+    struct xran_ru_loadgen_reorder slot = { NULL, 0 };
+    int pkt[4];
+    void *out[2];
+    uint16_t outVf[2], vf;
+
+    /* in order */
+    ASSERT_EQ(xran_ru_loadgen_reorder(&slot, &pkt[0], 1, false, out, outVf), 1U);
+    ASSERT_EQ(out[0], (void *)&pkt[0]);
+
+    /* held, then sent after the next one */
+    ASSERT_EQ(xran_ru_loadgen_reorder(&slot, &pkt[1], 2, true, out, outVf), 0U);
+    ASSERT_EQ(xran_ru_loadgen_reorder(&slot, &pkt[2], 3, true, out, outVf), 2U);
+    ASSERT_EQ(out[0], (void *)&pkt[2]);
+    ASSERT_EQ(outVf[0], 3);
+    ASSERT_EQ(out[1], (void *)&pkt[1]);
+    ASSERT_EQ(outVf[1], 2);
+
+    /* a packet held at the end of the eAxC is flushed */
+    ASSERT_EQ(xran_ru_loadgen_reorder(&slot, &pkt[3], 4, true, out, outVf), 0U);
+    ASSERT_EQ(xran_ru_loadgen_flush(&slot, &vf), (void *)&pkt[3]);
+    ASSERT_EQ(vf, 4);
+    ASSERT_TRUE(xran_ru_loadgen_flush(&slot, &vf) == NULL);
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, RuLoadGenFunctional,
+                        testing::ValuesIn(get_sequence(RuLoadGenFunctional::get_number_of_cases("ru_loadgen_functional"))));
@@ -0,0 +1,230 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/*
+ * RX packets per symbol tests.
+ *
+ * An arena is laid out for the configured packets per symbol and a set of PRB
+ * maps, one per buffer, CC and eAxC, receives U-plane sections through
+ * xran_rx_pkt_ctl() and xran_rx_pkt_store() as the RX path does. Every symbol
+ * must hold exactly the configured number of sections, count the ones over it
+ * and keep the mbufs of the previous slot of its buffer entry.
+ */
+
+#include "common.hpp"
+#include "xran_fh_o_du.h"
+#include "xran_rx_pkt.h"
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+
+const std::string module_name = "rx_pkt";
+
+namespace
+{
+    constexpr uint8_t k_mu = 1;
+
+    /* distinct per buffer, CC, eAxC, symbol and section */
+    inline uint16_t tag(uint32_t buf, uint32_t cc, uint32_t ant, uint32_t sym, uint32_t i)
+    {
+        return (uint16_t)(((((buf * 7 + cc) * 31 + ant) * 17 + sym) * 1031 + i) & 0xFFFF);
+    }
+
+    inline void *ptr(uint32_t buf, uint32_t cc, uint32_t ant, uint32_t sym, uint32_t i)
+    {
+        return (void *)(((uintptr_t)tag(buf, cc, ant, sym, i) << 16) | 0x1000 | i);
+    }
+}
+
+class RxPktCheck : public KernelTests
+{
+protected:
+    uint32_t m_numCc;
+    uint32_t m_numAnt;
+    uint32_t m_pktPerSym;
+
+    struct xran_rx_pkt_arena m_arena;
+    struct xran_common_counters m_cnt;
+    std::vector<struct xran_prb_map *> m_maps;
+
+    void SetUp() override
+    {
+        init_test("rx_pkt_functional");
+        m_pktPerSym = xran_rx_pkt_per_sym(get_input_parameter<uint32_t>("pkt_per_sym"));
+        m_numCc     = get_input_parameter<uint32_t>("num_cc");
+        m_numAnt    = get_input_parameter<uint32_t>("num_ant");
+
+        const uint8_t mu[] = { k_mu };
+        uint16_t nCc[XRAN_RX_PKT_TYPE_MAX] = { 0 }, nAnt[XRAN_RX_PKT_TYPE_MAX] = { 0 };
+
+        nCc[XRAN_RX_PKT_PUSCH]  = m_numCc;
+        nAnt[XRAN_RX_PKT_PUSCH] = m_numAnt;
+        nCc[XRAN_RX_PKT_PRACH]  = m_numCc;
+        nAnt[XRAN_RX_PKT_PRACH] = m_numAnt;
+
+        const uint64_t size = xran_rx_pkt_arena_layout(&m_arena, m_pktPerSym, mu, 1, nCc, nAnt);
+        ASSERT_EQ(size, 2ULL * XRAN_N_FE_BUF_LEN * m_numCc * m_numAnt * XRAN_NUM_OF_SYMBOL_PER_SLOT * m_arena.blockSize);
+        ASSERT_EQ(m_arena.blockSize % XRAN_RX_PKT_BLOCK_ALIGN, 0U);
+
+        m_arena.pBase = (uint8_t *)_mm_malloc(size, XRAN_RX_PKT_BLOCK_ALIGN);
+        ASSERT_TRUE(m_arena.pBase != nullptr);
+        std::memset(m_arena.pBase, 0, size);
+        std::memset(&m_cnt, 0, sizeof(m_cnt));
+
+        for (uint32_t i = 0; i < XRAN_N_FE_BUF_LEN * m_numCc * m_numAnt; i++) {
+            struct xran_prb_map *pMap = (struct xran_prb_map *)_mm_malloc(sizeof(struct xran_prb_map), 64);
+            ASSERT_TRUE(pMap != nullptr);
+            std::memset(pMap, 0, sizeof(struct xran_prb_map));
+            m_maps.push_back(pMap);
+        }
+    }
+
+    void TearDown() override
+    {
+        for (auto pMap : m_maps)
+            _mm_free(pMap);
+        _mm_free(m_arena.pBase);
+    }
+
+    struct xran_prb_map *map(uint32_t buf, uint32_t cc, uint32_t ant)
+    {
+        return m_maps[(buf * m_numCc + cc) * m_numAnt + ant];
+    }
+
+    /* returns the number of sections stored */
+    uint32_t fill(uint32_t buf, uint32_t cc, uint32_t ant, uint32_t sym, uint32_t num)
+    {
+        uint32_t stored = 0;
+        void *pStale;
+
+        for (uint32_t i = 0; i < num; i++) {
+            struct xran_rx_packet_ctl *pCtl = xran_rx_pkt_ctl(&m_arena, map(buf, cc, ant), XRAN_RX_PKT_PUSCH,
+                                                              k_mu, buf, cc, ant, sym);
+            if (pCtl == nullptr)
+                break;
+            const uint16_t t = tag(buf, cc, ant, sym, i);
+            if (xran_rx_pkt_store(pCtl, t, (uint16_t)(t + 1), (uint16_t)(t + 2), ptr(buf, cc, ant, sym, i),
+                                  (i & 1) ? nullptr : ptr(buf, cc, ant, sym, i), &pStale, &m_cnt) == XRAN_STATUS_SUCCESS)
+                stored++;
+        }
+        return stored;
+    }
+
+    void check(uint32_t buf, uint32_t cc, uint32_t ant, uint32_t sym)
+    {
+        const struct xran_rx_packet_ctl *pCtl = &map(buf, cc, ant)->sFrontHaulRxPacketCtrl[sym];
+        const uint8_t *pEnd = m_arena.pBase + m_arena.size;
+
+        ASSERT_EQ(pCtl->nRxPkt, (int32_t)m_pktPerSym);
+        ASSERT_EQ(pCtl->nRxPktMax, (int32_t)m_pktPerSym);
+        ASSERT_TRUE((const uint8_t *)pCtl->nRBStart >= m_arena.pBase);
+        ASSERT_TRUE((const uint8_t *)(pCtl->pCtrl + m_pktPerSym) <= pEnd);
+
+        for (uint32_t i = 0; i < m_pktPerSym; i++) {
+            const uint16_t t = tag(buf, cc, ant, sym, i);
+            ASSERT_EQ(pCtl->nRBStart[i], t);
+            ASSERT_EQ(pCtl->nRBSize[i], (uint16_t)(t + 1));
+            ASSERT_EQ(pCtl->nSectid[i], (uint16_t)(t + 2));
+            ASSERT_EQ((void *)pCtl->pData[i], ptr(buf, cc, ant, sym, i));
+            ASSERT_EQ(pCtl->pCtrl[i], (i & 1) ? nullptr : ptr(buf, cc, ant, sym, i));
+        }
+    }
+};
+
+TEST_P(RxPktCheck, Capacity)
+{
+    const uint32_t buf = XRAN_N_FE_BUF_LEN - 1, cc = m_numCc - 1, ant = m_numAnt - 1;
+    const uint32_t sym = XRAN_NUM_OF_SYMBOL_PER_SLOT - 1;
+
+    /* the section over the capacity is counted, the ones stored are kept */
+    ASSERT_EQ(fill(buf, cc, ant, sym, m_pktPerSym + 1), m_pktPerSym);
+    ASSERT_EQ(m_cnt.rx_err_pkt_per_sym, 1U);
+    check(buf, cc, ant, sym);
+}
+
+TEST_P(RxPktCheck, AllSymbols)
+{
+    uint32_t buf, cc, ant, sym;
+
+    /* every symbol of every PRB map full, none overwrites another */
+    for (buf = 0; buf < XRAN_N_FE_BUF_LEN; buf++)
+        for (cc = 0; cc < m_numCc; cc++)
+            for (ant = 0; ant < m_numAnt; ant++)
+                for (sym = 0; sym < XRAN_NUM_OF_SYMBOL_PER_SLOT; sym++)
+                    ASSERT_EQ(fill(buf, cc, ant, sym, m_pktPerSym), m_pktPerSym);
+
+    ASSERT_EQ(m_cnt.rx_err_pkt_per_sym, 0U);
+
+    for (buf = 0; buf < XRAN_N_FE_BUF_LEN; buf++)
+        for (cc = 0; cc < m_numCc; cc++)
+            for (ant = 0; ant < m_numAnt; ant++)
+                for (sym = 0; sym < XRAN_NUM_OF_SYMBOL_PER_SLOT; sym++)
+                    check(buf, cc, ant, sym);
+}
+
+TEST_P(RxPktCheck, Reuse)
+{
+    const uint32_t buf = 2, cc = 0, ant = m_numAnt / 2, sym = 5;
+    struct xran_prb_map *pMap = map(buf, cc, ant);
+    struct xran_rx_packet_ctl *pCtl;
+    void *pStale;
+
+    ASSERT_EQ(fill(buf, cc, ant, sym, m_pktPerSym), m_pktPerSym);
+
+    /* L1 copies a template over the PRB map for the next slot of the buffer entry */
+    std::memset(pMap, 0, sizeof(struct xran_prb_map));
+
+    for (uint32_t i = 0; i < m_pktPerSym; i++) {
+        pCtl = xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_PUSCH, k_mu, buf, cc, ant, sym);
+        ASSERT_TRUE(pCtl != nullptr);
+        ASSERT_EQ(xran_rx_pkt_store(pCtl, 0, 1, 0, nullptr, nullptr, &pStale, &m_cnt), XRAN_STATUS_SUCCESS);
+        /* mbufs of the previous slot are handed back to be released */
+        ASSERT_EQ(pStale, (i & 1) ? nullptr : ptr(buf, cc, ant, sym, i));
+    }
+    ASSERT_EQ(pMap->sFrontHaulRxPacketCtrl[sym].nRxPkt, (int32_t)m_pktPerSym);
+
+    /* the consumer resets the count, the entries are still there */
+    pMap->sFrontHaulRxPacketCtrl[sym].nRxPkt = 0;
+    pCtl = xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_PUSCH, k_mu, buf, cc, ant, sym);
+    ASSERT_EQ(xran_rx_pkt_store(pCtl, 0, 1, 0, nullptr, ptr(0, 0, 0, 0, 0), &pStale, &m_cnt), XRAN_STATUS_SUCCESS);
+    ASSERT_EQ(pStale, nullptr);
+    ASSERT_EQ(m_cnt.rx_err_pkt_per_sym, 0U);
+}
+
+TEST_P(RxPktCheck, NoStorage)
+{
+    struct xran_prb_map *pMap = map(0, 0, 0);
+
+    ASSERT_TRUE(xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_PUSCH, k_mu, 0, m_numCc, 0, 0) == nullptr);
+    ASSERT_TRUE(xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_PUSCH, k_mu, 0, 0, m_numAnt, 0) == nullptr);
+    ASSERT_TRUE(xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_PUSCH, k_mu, 0, 0, 0, XRAN_NUM_OF_SYMBOL_PER_SLOT) == nullptr);
+    /* SRS and CSI-RS are not configured */
+    ASSERT_TRUE(xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_SRS, k_mu, 0, 0, 0, 0) == nullptr);
+    ASSERT_TRUE(xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_CSIRS, k_mu, 0, 0, 0, 0) == nullptr);
+    /* a numerology not laid out has no blocks, offset 0 belongs to k_mu */
+    ASSERT_TRUE(xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_PUSCH, 0, 0, 0, 0, 0) == nullptr);
+    ASSERT_TRUE(xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_PUSCH, k_mu + 1, 0, 0, 0, 0) == nullptr);
+    ASSERT_TRUE(xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_PUSCH, XRAN_MAX_NUM_MU, 0, 0, 0, 0) == nullptr);
+    /* PRACH has its own blocks */
+    ASSERT_TRUE(xran_rx_pkt_ctl(&m_arena, pMap, XRAN_RX_PKT_PRACH, k_mu, 0, 0, 0, 0)->nRBStart
+                >= (uint16_t *)(m_arena.pBase + m_arena.offset[k_mu][XRAN_RX_PKT_PRACH]));
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, RxPktCheck,
+                        testing::ValuesIn(get_sequence(RxPktCheck::get_number_of_cases("rx_pkt_functional"))));
@@ -0,0 +1,226 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/*
+ * C-plane section database benchmark.
+ *
+ * Runs the library functions on a device context configured with the given
+ * numerologies, CCs and eAxCs: xran_cp_init_sectiondb() and
+ * xran_cp_free_sectiondb() for the setup time, and for the time of a DL
+ * slot the per eAxC reset and add done by xran_prepare_cp_dl_slot(),
+ * followed by the lookup of every section as done when the U-plane of the
+ * slot is sent. The sections found must be the ones stored.
+ */
+
+#include "common.hpp"
+#include "xran_fh_o_du.h"
+#include "xran_cp_api.h"
+#include "xran_common.h"
+
+#include <stdint.h>
+#include <chrono>
+#include <cstring>
+
+const std::string module_name = "sectiondb_benchmark";
+
+namespace
+{
+    inline uint16_t start_prbc(uint32_t tti, uint32_t cc, uint32_t ant)
+    {
+        return (uint16_t)((tti + cc + ant) % 273);
+    }
+}
+
+class SectionDbBenchmark : public KernelTests
+{
+protected:
+    uint32_t numMu;
+    uint32_t numCc;
+    uint32_t numEaxc;
+    uint32_t numSections;
+    uint32_t numSlots;
+
+    struct xran_device_ctx *pDev = nullptr;
+
+    void SetUp() override {
+        init_test("sectiondb_benchmark");
+        numMu       = get_input_parameter<uint32_t>("num_mu");
+        numCc       = get_input_parameter<uint32_t>("num_cc");
+        numEaxc     = get_input_parameter<uint32_t>("num_eaxc");
+        numSections = get_input_parameter<uint32_t>("num_sections");
+        numSlots    = get_input_parameter<uint32_t>("slots");
+
+        ASSERT_TRUE(numMu <= XRAN_MAX_NUM_MU);
+        ASSERT_TRUE(numCc <= XRAN_COMPONENT_CARRIERS_MAX);
+        ASSERT_TRUE(numEaxc <= XRAN_MAX_ANTENNA_NR);
+        ASSERT_TRUE(numSections <= XRAN_MAX_NUM_SECTIONS);
+
+        pDev = (struct xran_device_ctx *)_mm_malloc(sizeof(struct xran_device_ctx), 64);
+        ASSERT_TRUE(pDev != nullptr);
+        std::memset(pDev, 0, sizeof(struct xran_device_ctx));
+
+        pDev->xran_port_id      = 0;
+        pDev->fh_cfg.numMUs     = numMu;
+        for (uint32_t i = 0; i < numMu; i++)
+            pDev->fh_cfg.mu_number[i] = i;
+        pDev->fh_cfg.nCC        = numCc;
+        pDev->fh_cfg.neAxc      = numEaxc;
+        pDev->fh_cfg.nAntElmTRx = get_input_parameter<uint32_t>("num_ant_elm");
+    }
+
+    void TearDown() override {
+        if (pDev) {
+            xran_cp_free_sectiondb(pDev);
+            _mm_free(pDev);
+        }
+        pDev = nullptr;
+    }
+
+    /* C-plane of a DL slot, as xran_prepare_cp_dl_slot() stores it */
+    void build_slot(const uint32_t tti)
+    {
+        const uint8_t ctx = tti % XRAN_MAX_SECTIONDB_CTX;
+        struct xran_section_info info;
+
+        std::memset(&info, 0, sizeof(info));
+        info.numPrbc    = 16;
+        info.numSymbol  = XRAN_NUM_OF_SYMBOL_PER_SLOT;
+
+        for (uint32_t ant = 0; ant < numEaxc; ant++)
+            for (uint32_t cc = 0; cc < numCc; cc++) {
+                xran_cp_reset_section_info(pDev, XRAN_DIR_DL, cc, ant, ctx, 0);
+                for (uint32_t s = 0; s < numSections; s++) {
+                    info.id         = s;
+                    info.startPrbc  = start_prbc(tti, cc, ant);
+                    xran_cp_add_section_info(pDev, XRAN_DIR_DL, cc, ant, ctx, &info, 0);
+                }
+            }
+    }
+
+    /* U-plane of the slot, returns a checksum of the sections found */
+    uint64_t send_slot(const uint32_t tti)
+    {
+        const uint8_t ctx = tti % XRAN_MAX_SECTIONDB_CTX;
+        uint64_t sum = 0;
+
+        for (uint32_t cc = 0; cc < numCc; cc++)
+            for (uint32_t ant = 0; ant < numEaxc; ant++)
+                for (uint32_t s = 0; s < numSections; s++) {
+                    const struct xran_section_info *info = xran_cp_find_section_info(pDev, XRAN_DIR_DL, cc, ant, ctx, s, 0);
+
+                    if (info != nullptr)
+                        sum += info->id + info->startPrbc;
+                }
+        return sum;
+    }
+
+    uint64_t expected_sum(const uint32_t tti)
+    {
+        uint64_t sum = 0;
+
+        for (uint32_t cc = 0; cc < numCc; cc++)
+            for (uint32_t ant = 0; ant < numEaxc; ant++)
+                for (uint32_t s = 0; s < numSections; s++)
+                    sum += s + start_prbc(tti, cc, ant);
+        return sum;
+    }
+};
+
+TEST_P(SectionDbBenchmark, Setup)
+{
+    double tInit = 0, tFree = 0;
+
+    /* first round warms up, the best of the others is reported */
+    for (int round = 0; round < 4; round++) {
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_EQ(xran_cp_init_sectiondb(pDev), XRAN_STATUS_SUCCESS);
+        const std::chrono::duration<double, std::micro> dInit = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        ASSERT_EQ(xran_cp_free_sectiondb(pDev), XRAN_STATUS_SUCCESS);
+        const std::chrono::duration<double, std::micro> dFree = std::chrono::steady_clock::now() - start;
+
+        if (round == 1 || (round > 1 && dInit.count() < tInit))
+            tInit = dInit.count();
+        if (round == 1 || (round > 1 && dFree.count() < tFree))
+            tFree = dFree.count();
+    }
+
+    printf("%12s %12s\n", "init us", "free us");
+    printf("%12.1f %12.1f\n", tInit, tFree);
+}
+
+TEST_P(SectionDbBenchmark, Slot)
+{
+    double tBuild = 0, tSend = 0;
+
+    ASSERT_EQ(xran_cp_init_sectiondb(pDev), XRAN_STATUS_SUCCESS);
+
+    for (int round = 0; round < 4; round++) {
+        double dBuild = 0, dSend = 0;
+
+        for (uint32_t tti = 0; tti < numSlots; tti++) {
+            auto start = std::chrono::steady_clock::now();
+            build_slot(tti);
+            auto mid = std::chrono::steady_clock::now();
+            const uint64_t sum = send_slot(tti);
+            const std::chrono::duration<double, std::nano> b = mid - start;
+            const std::chrono::duration<double, std::nano> s = std::chrono::steady_clock::now() - mid;
+
+            ASSERT_EQ(sum, expected_sum(tti));
+            dBuild += b.count();
+            dSend  += s.count();
+        }
+
+        if (round == 1 || (round > 1 && dBuild < tBuild))
+            tBuild = dBuild;
+        if (round == 1 || (round > 1 && dSend < tSend))
+            tSend = dSend;
+    }
+
+    printf("%16s %16s\n", "build ns/slot", "lookup ns/slot");
+    printf("%16.1f %16.1f\n", tBuild / numSlots, tSend / numSlots);
+}
+
+TEST_P(SectionDbBenchmark, Reset)
+{
+    struct xran_section_info info;
+
+    std::memset(&info, 0, sizeof(info));
+    ASSERT_EQ(xran_cp_init_sectiondb(pDev), XRAN_STATUS_SUCCESS);
+
+    for (uint32_t cc = 0; cc < numCc; cc++)
+        for (uint32_t ant = 0; ant < numEaxc; ant++)
+            ASSERT_EQ(xran_cp_add_section_info(pDev, XRAN_DIR_DL, cc, ant, 1, &info, 0), XRAN_STATUS_SUCCESS);
+
+    /* a reset empties its own CC, eAxC, context and direction only */
+    ASSERT_EQ(xran_cp_reset_section_info(pDev, XRAN_DIR_UL, 0, 0, 1, 0), XRAN_STATUS_SUCCESS);
+    ASSERT_EQ(xran_cp_reset_section_info(pDev, XRAN_DIR_DL, 0, 0, 0, 0), XRAN_STATUS_SUCCESS);
+    ASSERT_TRUE(xran_cp_check_db_entry(pDev, XRAN_DIR_DL, 0, 0, 1, 0, 0) != nullptr);
+
+    ASSERT_EQ(xran_cp_reset_section_info(pDev, XRAN_DIR_DL, 0, 0, 1, 0), XRAN_STATUS_SUCCESS);
+    ASSERT_TRUE(xran_cp_check_db_entry(pDev, XRAN_DIR_DL, 0, 0, 1, 0, 0) == nullptr);
+    if (numEaxc > 1)
+        ASSERT_TRUE(xran_cp_check_db_entry(pDev, XRAN_DIR_DL, 0, 1, 1, 0, 0) != nullptr);
+
+    /* no storage outside the configured CCs */
+    ASSERT_EQ(xran_cp_add_section_info(pDev, XRAN_DIR_DL, numCc, 0, 1, &info, 0), XRAN_STATUS_INVALID_PARAM);
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, SectionDbBenchmark,
+                        testing::ValuesIn(get_sequence(SectionDbBenchmark::get_number_of_cases("sectiondb_benchmark"))));
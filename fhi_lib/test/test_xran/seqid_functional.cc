@@ -0,0 +1,205 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/*
+ * U-plane RX seqId tracker tests.
+ *
+ * Synthetic flows are built from a wrapping 8-bit seqId stream with known
+ * drops, duplicates and bounded reordering, fed to xran_rx_seqid_track() and
+ * its totals compared with the injected events. Lost seqIds are only counted
+ * when they leave the window, so every flow ends with a window of in order
+ * packets.
+ */
+
+#include "common.hpp"
+#include "xran_fh_o_du.h"
+#include "xran_rx_seqid.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <set>
+#include <vector>
+
+const std::string module_name = "SeqId_test";
+
+class SeqIdCheck : public KernelTests
+{
+protected:
+    uint32_t m_depth;
+    uint32_t m_numPkts;
+    double m_dropRate;
+    double m_duplRate;
+    uint64_t m_state;
+    struct xran_common_counters m_cnt;
+
+    void SetUp() override
+    {
+        init_test("seqid_functional");
+        m_depth     = xran_rx_seqid_window(get_input_parameter<uint32_t>("window"));
+        m_numPkts   = get_input_parameter<uint32_t>("num_packets");
+        m_dropRate  = get_input_parameter<double>("drop_rate");
+        m_duplRate  = get_input_parameter<double>("dupl_rate");
+
+        m_state = 0;
+        std::memset(&m_cnt, 0, sizeof(m_cnt));
+    }
+
+    void TearDown() override
+    {
+    }
+
+    /* feeds unwrapped sequence numbers, returns the number of packets rejected */
+    uint64_t feed(const std::vector<uint64_t> &seqs)
+    {
+        uint64_t rejected = 0;
+
+        for (const auto seq : seqs)
+            if (xran_rx_seqid_track(&m_state, (uint8_t)seq, m_depth, &m_cnt) != XRAN_STATUS_SUCCESS)
+                rejected++;
+
+        return rejected;
+    }
+
+    /* in order packets after the last one, so every gap has left the window */
+    void flush(std::vector<uint64_t> &seqs, uint64_t next)
+    {
+        for (uint32_t i = 0; i < m_depth; i++)
+            seqs.push_back(next + i);
+    }
+};
+
+TEST_P(SeqIdCheck, InOrder)
+{
+    std::vector<uint64_t> seqs;
+
+    for (uint64_t seq = 200; seq < 200 + m_numPkts; seq++)
+        seqs.push_back(seq);
+
+    ASSERT_EQ(feed(seqs), 0U);
+    ASSERT_EQ(m_cnt.Rx_pkt_lost, 0U);
+    ASSERT_EQ(m_cnt.Rx_pkt_dupl, 0U);
+    ASSERT_EQ(m_cnt.Rx_pkt_reorder, 0U);
+    ASSERT_EQ(m_cnt.Rx_pkt_late, 0U);
+}
+
+TEST_P(SeqIdCheck, Late)
+{
+    std::vector<uint64_t> seqs;
+
+    /* seqId 10 arrives once the window has moved past it */
+    for (uint64_t seq = 0; seq < 10; seq++)
+        seqs.push_back(seq);
+    for (uint64_t seq = 11; seq <= 10 + m_depth; seq++)
+        seqs.push_back(seq);
+    seqs.push_back(10);
+    flush(seqs, 11 + m_depth);
+
+    ASSERT_EQ(feed(seqs), 0U);
+    ASSERT_EQ(m_cnt.Rx_pkt_lost, 1U);
+    ASSERT_EQ(m_cnt.Rx_pkt_late, 1U);
+    ASSERT_EQ(m_cnt.Rx_pkt_dupl, 0U);
+    ASSERT_EQ(m_cnt.Rx_pkt_reorder, 0U);
+
+    /* the oldest seqId still in the window is reordered, not late */
+    m_state = 0;
+    std::memset(&m_cnt, 0, sizeof(m_cnt));
+    seqs.clear();
+    seqs.push_back(1000);
+    seqs.push_back(1000 + m_depth);
+    seqs.push_back(1001);
+    flush(seqs, 1001 + m_depth);
+
+    feed(seqs);
+    ASSERT_EQ(m_cnt.Rx_pkt_late, 0U);
+    ASSERT_EQ(m_cnt.Rx_pkt_reorder, 1U);
+}
+
+TEST_P(SeqIdCheck, BurstLoss)
+{
+    std::vector<uint64_t> seqs;
+
+    /* bursts shorter and longer than the window, below half the seqId range */
+    for (uint64_t seq = 0; seq < 50; seq++)
+        seqs.push_back(seq);
+    for (uint64_t seq = 50 + 3; seq < 150; seq++)
+        seqs.push_back(seq);
+    for (uint64_t seq = 150 + 100; seq < 300; seq++)
+        seqs.push_back(seq);
+    flush(seqs, 300);
+
+    ASSERT_EQ(feed(seqs), 0U);
+    ASSERT_EQ(m_cnt.Rx_pkt_lost, 103U);
+    ASSERT_EQ(m_cnt.Rx_pkt_dupl, 0U);
+    ASSERT_EQ(m_cnt.Rx_pkt_late, 0U);
+}
+
+TEST_P(SeqIdCheck, ReorderDropDupl)
+{
+    std::mt19937 gen(GetParam() + 1);
+    std::uniform_real_distribution<double> rate(0.0, 1.0);
+    std::vector<uint64_t> sent, seqs;
+    uint64_t numDrop = 0, numDupl = 0, numReorder = 0;
+    uint64_t seq, top = 0;
+    std::set<uint64_t> received;
+
+    /* the first packet opens the window, it is never dropped */
+    for (seq = 0; seq < m_numPkts; seq++) {
+        if (seq && rate(gen) < m_dropRate)
+            numDrop++;
+        else
+            sent.push_back(seq);
+    }
+
+    /* shuffle the packets of each window sized seqId range, so none moves
+     * past the window. The first packet of the flow stays first. */
+    for (size_t i = 1, j; i < sent.size(); i = j) {
+        for (j = i; j < sent.size() && sent[j] / m_depth == sent[i] / m_depth; j++)
+            ;
+        std::shuffle(sent.begin() + i, sent.begin() + j, gen);
+    }
+
+    for (size_t i = 0; i < sent.size(); i++) {
+        seqs.push_back(sent[i]);
+        if (rate(gen) < m_duplRate) {
+            seqs.push_back(sent[i]);
+            numDupl++;
+        }
+    }
+
+    /* reference: a packet below the highest seqId seen is reordered */
+    for (size_t i = 0; i < sent.size(); i++) {
+        if (i && sent[i] < top)
+            numReorder++;
+        top = std::max(top, sent[i]);
+        received.insert(sent[i]);
+    }
+    ASSERT_EQ(received.size() + numDrop, m_numPkts);
+
+    flush(seqs, m_numPkts);
+
+    ASSERT_EQ(feed(seqs), numDupl);
+    ASSERT_EQ(m_cnt.Rx_pkt_dupl, numDupl);
+    ASSERT_EQ(m_cnt.Rx_pkt_lost, numDrop);
+    ASSERT_EQ(m_cnt.Rx_pkt_reorder, numReorder);
+    ASSERT_EQ(m_cnt.Rx_pkt_late, 0U);
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, SeqIdCheck,
+                        testing::ValuesIn(get_sequence(SeqIdCheck::get_number_of_cases("seqid_functional"))));
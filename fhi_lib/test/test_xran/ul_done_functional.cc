@@ -0,0 +1,272 @@
+/******************************************************************************
+*
+*   Copyright (c) 2020 Intel.
+*
+*   Licensed under the Apache License, Version 2.0 (the "License");
+*   you may not use this file except in compliance with the License.
+*   You may obtain a copy of the License at
+*
+*       http://www.apache.org/licenses/LICENSE-2.0
+*
+*   Unless required by applicable law or agreed to in writing, software
+*   distributed under the License is distributed on an "AS IS" BASIS,
+*   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*   See the License for the specific language governing permissions and
+*   limitations under the License.
+*
+*******************************************************************************/
+
+/*
+ * Early UL completion tests.
+ *
+ * A slot is armed from synthetic RX PRB maps, one per eAxC, and the U-plane
+ * sections they ask for are split in MTU sized fragments and received in
+ * random order, from one or several RX workers. Every expected symbol must be
+ * reported complete exactly once, by the fragment completing it, and the slot
+ * together with its last symbol. A lost fragment leaves the slot incomplete.
+ * The RX path and the full slot deadline claim the report of a UL slot, only
+ * one of them wins it.
+ */
+
+#include "common.hpp"
+#include "xran_fh_o_du.h"
+#include "xran_ul_done.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+const std::string module_name = "ul_done";
+
+namespace
+{
+    struct section
+    {
+        uint8_t symb;
+        uint16_t num_prbu;
+    };
+}
+
+class UlDoneCheck : public KernelTests
+{
+protected:
+    uint32_t m_numAnt;
+    uint32_t m_numElm;
+    uint32_t m_maxPrbu;
+    uint32_t m_numWorkers;
+
+    std::vector<struct xran_prb_map *> m_prbMaps;
+    std::vector<struct section> m_sections;
+    struct xran_ul_done_slot m_slot;
+    uint32_t m_prbExp[XRAN_NUM_OF_SYMBOL_PER_SLOT];
+
+    void SetUp() override
+    {
+        init_test("ul_done_functional");
+        m_numAnt     = get_input_parameter<uint32_t>("num_ant");
+        m_numElm     = get_input_parameter<uint32_t>("num_prb_elm");
+        m_maxPrbu    = get_input_parameter<uint32_t>("max_prbu");
+        m_numWorkers = get_input_parameter<uint32_t>("workers");
+
+        std::mt19937 gen(GetParam() + 1);
+        std::uniform_int_distribution<int> symb(0, XRAN_NUM_OF_SYMBOL_PER_SLOT - 1);
+        std::uniform_int_distribution<int> prb(1, 273);
+
+        std::fill(std::begin(m_prbExp), std::end(m_prbExp), 0);
+
+        /* random PRB maps, the U-plane of every section split by the MTU */
+        for (uint32_t ant = 0; ant < m_numAnt; ant++) {
+            struct xran_prb_map *pMap = (struct xran_prb_map *)calloc(1,
+                    sizeof(struct xran_prb_map) + (m_numElm - 1) * sizeof(struct xran_prb_elm));
+            ASSERT_TRUE(pMap != nullptr);
+            pMap->nPrbElm = m_numElm;
+
+            for (uint32_t i = 0; i < m_numElm; i++) {
+                struct xran_prb_elm *pElm = &pMap->prbMap[i];
+                int16_t start = symb(gen);
+
+                pElm->nRBSize    = prb(gen);
+                pElm->nStartSymb = start;
+                pElm->numSymb    = std::uniform_int_distribution<int>(1, XRAN_NUM_OF_SYMBOL_PER_SLOT - start)(gen);
+
+                for (int16_t sym = start; sym < start + pElm->numSymb; sym++) {
+                    m_prbExp[sym] += pElm->nRBSize;
+                    for (int16_t left = pElm->nRBSize; left > 0; left -= m_maxPrbu)
+                        m_sections.push_back({ (uint8_t)sym, (uint16_t)std::min<int16_t>(left, m_maxPrbu) });
+                }
+            }
+            m_prbMaps.push_back(pMap);
+        }
+        std::shuffle(m_sections.begin(), m_sections.end(), gen);
+    }
+
+    void TearDown() override
+    {
+        for (auto pMap : m_prbMaps)
+            free(pMap);
+    }
+
+    uint32_t arm(uint32_t tti)
+    {
+        xran_ul_done_reset(&m_slot, tti);
+        for (auto pMap : m_prbMaps)
+            xran_ul_done_expect(&m_slot, pMap);
+        return xran_ul_done_arm(&m_slot);
+    }
+
+    uint32_t num_sym_expected()
+    {
+        return (uint32_t)std::count_if(std::begin(m_prbExp), std::end(m_prbExp),
+                                       [](uint32_t n) { return n != 0; });
+    }
+};
+
+TEST_P(UlDoneCheck, AllReceived)
+{
+    uint32_t prbRx[XRAN_NUM_OF_SYMBOL_PER_SLOT] = { 0 };
+    uint32_t numSymDone = 0, numSlotDone = 0;
+
+    ASSERT_EQ(arm(100), num_sym_expected());
+
+    for (size_t i = 0; i < m_sections.size(); i++) {
+        const struct section &sec = m_sections[i];
+
+        ASSERT_FALSE(xran_ul_done_complete(&m_slot, 100));
+        const uint32_t done = xran_ul_done_rx(&m_slot, sec.symb, sec.num_prbu);
+
+        prbRx[sec.symb] += sec.num_prbu;
+        ASSERT_EQ((done & XRAN_UL_DONE_SYM) != 0, prbRx[sec.symb] == m_prbExp[sec.symb]);
+        ASSERT_EQ((done & XRAN_UL_DONE_ALL) != 0, i == m_sections.size() - 1);
+        numSymDone += (done & XRAN_UL_DONE_SYM) ? 1 : 0;
+        numSlotDone += (done & XRAN_UL_DONE_ALL) ? 1 : 0;
+    }
+
+    ASSERT_EQ(numSymDone, num_sym_expected());
+    ASSERT_EQ(numSlotDone, 1U);
+    ASSERT_TRUE(xran_ul_done_complete(&m_slot, 100));
+    /* the deadline of another slot sharing the buffer entry is not affected */
+    ASSERT_FALSE(xran_ul_done_complete(&m_slot, 100 + XRAN_N_FE_BUF_LEN));
+
+    /* sections received once the slot is complete report nothing */
+    ASSERT_EQ(xran_ul_done_rx(&m_slot, m_sections[0].symb, m_sections[0].num_prbu), 0U);
+
+    /* reported by RX, the deadline leaves it */
+    ASSERT_EQ(xran_ul_done_claim(&m_slot), 1);
+    ASSERT_EQ(xran_ul_done_claim_deadline(&m_slot, 100), 0);
+}
+
+TEST_P(UlDoneCheck, Loss)
+{
+    const size_t lost = m_sections.size() / 2;
+    uint32_t numSymDone = 0;
+
+    arm(7);
+
+    for (size_t i = 0; i < m_sections.size(); i++) {
+        if (i == lost)
+            continue;
+        const uint32_t done = xran_ul_done_rx(&m_slot, m_sections[i].symb, m_sections[i].num_prbu);
+
+        ASSERT_EQ(done & XRAN_UL_DONE_ALL, 0U);
+        numSymDone += (done & XRAN_UL_DONE_SYM) ? 1 : 0;
+    }
+
+    /* the symbol of the lost fragment is left to the deadline */
+    ASSERT_EQ(numSymDone, num_sym_expected() - 1);
+    ASSERT_FALSE(xran_ul_done_complete(&m_slot, 7));
+    ASSERT_EQ(xran_ul_done_claim_deadline(&m_slot, 7 + XRAN_N_FE_BUF_LEN), 0);
+    ASSERT_EQ(xran_ul_done_claim_deadline(&m_slot, 7), 1);
+    ASSERT_EQ(xran_ul_done_claim_deadline(&m_slot, 7), 0);
+
+    /* the slot reusing the buffer entry starts from nothing received */
+    arm(7 + XRAN_N_FE_BUF_LEN);
+    ASSERT_FALSE(xran_ul_done_complete(&m_slot, 7 + XRAN_N_FE_BUF_LEN));
+    for (size_t i = 0; i < m_sections.size(); i++)
+        xran_ul_done_rx(&m_slot, m_sections[i].symb, m_sections[i].num_prbu);
+    ASSERT_TRUE(xran_ul_done_complete(&m_slot, 7 + XRAN_N_FE_BUF_LEN));
+}
+
+TEST_P(UlDoneCheck, NotArmed)
+{
+    /* nothing expected, e.g. a DL slot or a disabled CC */
+    xran_ul_done_reset(&m_slot, 3);
+    ASSERT_EQ(xran_ul_done_arm(&m_slot), 0U);
+
+    for (const auto &sec : m_sections)
+        ASSERT_EQ(xran_ul_done_rx(&m_slot, sec.symb, sec.num_prbu), 0U);
+    ASSERT_FALSE(xran_ul_done_complete(&m_slot, 3));
+
+    /* a UL slot without expected PRBs is still reported by the deadline, a DL slot is not */
+    ASSERT_EQ(xran_ul_done_claim_deadline(&m_slot, 3), 1);
+    xran_ul_done_reset(&m_slot, 4);
+    ASSERT_EQ(xran_ul_done_claim_deadline(&m_slot, 4), 0);
+}
+
+TEST_P(UlDoneCheck, Workers)
+{
+    std::atomic<uint32_t> numSymDone(0), numSlotDone(0);
+    std::vector<std::thread> threads;
+
+    arm(42);
+
+    /* RX workers share the slot, each takes every numWorkers-th section */
+    for (uint32_t w = 0; w < m_numWorkers; w++) {
+        threads.emplace_back([&, w]() {
+            for (size_t i = w; i < m_sections.size(); i += m_numWorkers) {
+                const uint32_t done = xran_ul_done_rx(&m_slot, m_sections[i].symb, m_sections[i].num_prbu);
+                if (done & XRAN_UL_DONE_SYM)
+                    numSymDone++;
+                if (done & XRAN_UL_DONE_ALL)
+                    numSlotDone++;
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    ASSERT_EQ(numSymDone.load(), num_sym_expected());
+    ASSERT_EQ(numSlotDone.load(), 1U);
+    ASSERT_TRUE(xran_ul_done_complete(&m_slot, 42));
+}
+
+TEST_P(UlDoneCheck, DeadlineRace)
+{
+    std::atomic<uint32_t> numReported(0);
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+
+    arm(9);
+
+    /* the deadline fires while the RX workers complete the slot */
+    threads.emplace_back([&]() {
+        while (!start.load())
+            ;
+        for (size_t i = 0; i < m_sections.size() / 2; i++)
+            std::this_thread::yield();
+        numReported += xran_ul_done_claim_deadline(&m_slot, 9);
+    });
+    for (uint32_t w = 0; w < m_numWorkers; w++) {
+        threads.emplace_back([&, w]() {
+            while (!start.load())
+                ;
+            for (size_t i = w; i < m_sections.size(); i += m_numWorkers) {
+                const uint32_t done = xran_ul_done_rx(&m_slot, m_sections[i].symb, m_sections[i].num_prbu);
+                if (done & XRAN_UL_DONE_ALL)
+                    numReported += xran_ul_done_claim(&m_slot);
+            }
+        });
+    }
+    start = true;
+    for (auto &t : threads)
+        t.join();
+
+    ASSERT_EQ(numReported.load(), 1U);
+    ASSERT_EQ(xran_ul_done_claim_deadline(&m_slot, 9), 0);
+}
+
+INSTANTIATE_TEST_CASE_P(UnitTest, UlDoneCheck,
+                        testing::ValuesIn(get_sequence(UlDoneCheck::get_number_of_cases("ul_done_functional"))));